@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/channel-access-manager.h"
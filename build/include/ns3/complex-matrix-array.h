@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/complex-matrix-array.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/propagation/model/cost231-propagation-loss-model.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/traffic-control/model/dual-pi2-queue-disc.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/nix-vector-routing/helper/ipv4-nix-vector-helper.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/nix-vector-routing/model/ipv4-nix-vector-routing.h"
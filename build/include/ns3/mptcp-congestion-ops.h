@@ -0,0 +1 @@
+#include "/root/repo/src/internet/model/mptcp-congestion-ops.h"
@@ -0,0 +1 @@
+#include "/root/repo/src/wifi/model/qos-frame-exchange-manager.h"
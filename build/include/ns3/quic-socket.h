@@ -0,0 +1 @@
+#include "../../../src/internet/model/quic-socket.h"
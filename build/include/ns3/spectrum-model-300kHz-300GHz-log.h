@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/spectrum-model-300kHz-300GHz-log.h"
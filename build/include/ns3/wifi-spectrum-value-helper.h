@@ -0,0 +1 @@
+#include "/root/repo/src/spectrum/model/wifi-spectrum-value-helper.h"
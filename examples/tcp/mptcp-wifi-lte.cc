@@ -0,0 +1,213 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// A Multipath TCP upload from a device attached both to an LTE network and
+// to a Wi-Fi access point.
+//
+//                      LTE                 p2p
+//          +----- (7.0.0.0/8) ---- eNB/PGW ---- (1.0.0.0/8) -----+
+//          |                                                      |
+//         UE                                                remote host
+//          |                                                      |
+//          +--- (192.168.1.0/24) ----- AP ---- (10.2.0.0/24) -----+
+//                     Wi-Fi                 p2p
+//
+// The UE connects to the address of the remote host on the LTE side; the
+// remote host advertises its address on the Wi-Fi side with ADD_ADDR, and
+// the UE opens a second subflow through the access point. The UE routes
+// each subnet of the remote host through a single interface, so that
+// exactly one subflow is opened on each access network.
+//
+// The scheduler and the coupled congestion control can be chosen from the
+// command line, e.g.:
+//
+//   ./ns3 run "mptcp-wifi-lte --scheduler=ns3::MpTcpSchedulerRoundRobin
+//                             --congestionControl=ns3::TcpOlia"
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/lte-module.h"
+#include "ns3/mobility-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/wifi-module.h"
+
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("MpTcpWifiLte");
+
+/// Bytes sent by the UE, per IPv4 interface
+static std::map<uint32_t, uint64_t> g_ueTxBytes;
+
+/**
+ * Count the bytes sent by the UE on each interface
+ * \param packet the packet
+ * \param ipv4 the IPv4 protocol
+ * \param interface the interface
+ */
+static void
+UeTx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface)
+{
+    g_ueTxBytes[interface] += packet->GetSize();
+}
+
+int
+main(int argc, char* argv[])
+{
+    std::string scheduler = "ns3::MpTcpSchedulerMinRtt";
+    std::string congestionControl = "ns3::TcpLia";
+    Time simTime = Seconds(10);
+    double wifiDistance = 10.0;
+    double lteDistance = 100.0;
+
+    CommandLine cmd(__FILE__);
+    cmd.AddValue("scheduler", "Type of the Multipath TCP packet scheduler", scheduler);
+    cmd.AddValue("congestionControl",
+                 "Type of the congestion control of the subflows",
+                 congestionControl);
+    cmd.AddValue("simTime", "Total duration of the simulation", simTime);
+    cmd.AddValue("wifiDistance", "Distance between the UE and the access point [m]", wifiDistance);
+    cmd.AddValue("lteDistance", "Distance between the UE and the eNB [m]", lteDistance);
+    cmd.Parse(argc, argv);
+
+    Config::SetDefault("ns3::MpTcpSocket::Scheduler", TypeIdValue(TypeId::LookupByName(scheduler)));
+    Config::SetDefault("ns3::MpTcpSocket::CongestionControl",
+                       TypeIdValue(TypeId::LookupByName(congestionControl)));
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1400));
+
+    Ptr<LteHelper> lteHelper = CreateObject<LteHelper>();
+    Ptr<PointToPointEpcHelper> epcHelper = CreateObject<PointToPointEpcHelper>();
+    lteHelper->SetEpcHelper(epcHelper);
+    Ptr<Node> pgw = epcHelper->GetPgwNode();
+
+    NodeContainer enbNode;
+    enbNode.Create(1);
+    NodeContainer ueNode;
+    ueNode.Create(1);
+    NodeContainer apNode;
+    apNode.Create(1);
+    NodeContainer remoteHostNode;
+    remoteHostNode.Create(1);
+    Ptr<Node> ue = ueNode.Get(0);
+    Ptr<Node> remoteHost = remoteHostNode.Get(0);
+
+    InternetStackHelper internet;
+    internet.Install(ueNode);
+    internet.Install(apNode);
+    internet.Install(remoteHostNode);
+
+    // Wired links of the remote host
+    PointToPointHelper p2ph;
+    p2ph.SetDeviceAttribute("DataRate", DataRateValue(DataRate("1Gb/s")));
+    p2ph.SetChannelAttribute("Delay", TimeValue(MilliSeconds(10)));
+    NetDeviceContainer pgwDevices = p2ph.Install(pgw, remoteHost);
+    NetDeviceContainer apDevices = p2ph.Install(apNode.Get(0), remoteHost);
+
+    Ipv4AddressHelper ipv4h;
+    ipv4h.SetBase("1.0.0.0", "255.0.0.0");
+    Ipv4InterfaceContainer pgwIfaces = ipv4h.Assign(pgwDevices);
+    ipv4h.SetBase("10.2.0.0", "255.255.255.0");
+    Ipv4InterfaceContainer apIfaces = ipv4h.Assign(apDevices);
+    Ipv4Address remoteHostAddr = pgwIfaces.GetAddress(1);
+
+    // Mobility: the UE sits between the eNB and the access point
+    Ptr<ListPositionAllocator> positionAlloc = CreateObject<ListPositionAllocator>();
+    positionAlloc->Add(Vector(0, 0, 0));                          // eNB
+    positionAlloc->Add(Vector(lteDistance, 0, 0));                // UE
+    positionAlloc->Add(Vector(lteDistance + wifiDistance, 0, 0)); // AP
+    MobilityHelper mobility;
+    mobility.SetMobilityModel("ns3::ConstantPositionMobilityModel");
+    mobility.SetPositionAllocator(positionAlloc);
+    mobility.Install(enbNode);
+    mobility.Install(ueNode);
+    mobility.Install(apNode);
+
+    // LTE access
+    NetDeviceContainer enbLteDevs = lteHelper->InstallEnbDevice(enbNode);
+    NetDeviceContainer ueLteDevs = lteHelper->InstallUeDevice(ueNode);
+    Ipv4InterfaceContainer ueLteIface = epcHelper->AssignUeIpv4Address(ueLteDevs);
+    lteHelper->Attach(ueLteDevs.Get(0), enbLteDevs.Get(0));
+
+    // Wi-Fi access
+    YansWifiChannelHelper wifiChannel = YansWifiChannelHelper::Default();
+    YansWifiPhyHelper wifiPhy;
+    wifiPhy.SetChannel(wifiChannel.Create());
+    WifiHelper wifiHelper;
+    wifiHelper.SetStandard(WIFI_STANDARD_80211n);
+    WifiMacHelper wifiMac;
+    Ssid ssid = Ssid("mptcp");
+    wifiMac.SetType("ns3::ApWifiMac", "Ssid", SsidValue(ssid));
+    NetDeviceContainer apWifiDevs = wifiHelper.Install(wifiPhy, wifiMac, apNode);
+    wifiMac.SetType("ns3::StaWifiMac", "Ssid", SsidValue(ssid));
+    NetDeviceContainer ueWifiDevs = wifiHelper.Install(wifiPhy, wifiMac, ueNode);
+
+    ipv4h.SetBase("192.168.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer apWifiIface = ipv4h.Assign(apWifiDevs);
+    Ipv4InterfaceContainer ueWifiIface = ipv4h.Assign(ueWifiDevs);
+
+    // Routes: each subnet of the remote host is reached through one access network
+    Ipv4StaticRoutingHelper ipv4RoutingHelper;
+    Ptr<Ipv4> ueIpv4 = ue->GetObject<Ipv4>();
+    uint32_t ueLteInterface = ueIpv4->GetInterfaceForDevice(ueLteDevs.Get(0));
+    uint32_t ueWifiInterface = ueIpv4->GetInterfaceForDevice(ueWifiDevs.Get(0));
+    Ptr<Ipv4StaticRouting> ueRouting = ipv4RoutingHelper.GetStaticRouting(ueIpv4);
+    ueRouting->AddNetworkRouteTo(Ipv4Address("1.0.0.0"),
+                                 Ipv4Mask("255.0.0.0"),
+                                 epcHelper->GetUeDefaultGatewayAddress(),
+                                 ueLteInterface);
+    ueRouting->AddNetworkRouteTo(Ipv4Address("10.2.0.0"),
+                                 Ipv4Mask("255.255.255.0"),
+                                 apWifiIface.GetAddress(0),
+                                 ueWifiInterface);
+
+    Ptr<Ipv4> remoteHostIpv4 = remoteHost->GetObject<Ipv4>();
+    Ptr<Ipv4StaticRouting> remoteHostRouting = ipv4RoutingHelper.GetStaticRouting(remoteHostIpv4);
+    remoteHostRouting->AddNetworkRouteTo(Ipv4Address("7.0.0.0"),
+                                         Ipv4Mask("255.0.0.0"),
+                                         remoteHostIpv4->GetInterfaceForDevice(pgwDevices.Get(1)));
+    remoteHostRouting->AddNetworkRouteTo(Ipv4Address("192.168.1.0"),
+                                         Ipv4Mask("255.255.255.0"),
+                                         apIfaces.GetAddress(0),
+                                         remoteHostIpv4->GetInterfaceForDevice(apDevices.Get(1)));
+
+    // Multipath TCP upload from the UE to the remote host
+    uint16_t port = 5000;
+    PacketSinkHelper sinkHelper("ns3::MpTcpSocketFactory",
+                                InetSocketAddress(Ipv4Address::GetAny(), port));
+    ApplicationContainer sinkApp = sinkHelper.Install(remoteHost);
+    sinkApp.Start(Seconds(0.5));
+
+    BulkSendHelper sourceHelper("ns3::MpTcpSocketFactory", InetSocketAddress(remoteHostAddr, port));
+    ApplicationContainer sourceApp = sourceHelper.Install(ue);
+    sourceApp.Start(Seconds(1));
+
+    ue->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext("Tx", MakeCallback(&UeTx));
+
+    Simulator::Stop(simTime);
+    Simulator::Run();
+
+    uint64_t received = DynamicCast<PacketSink>(sinkApp.Get(0))->GetTotalRx();
+    double duration = (simTime - Seconds(1)).GetSeconds();
+    std::cout << "UE LTE address:   " << ueLteIface.GetAddress(0) << std::endl
+              << "UE Wi-Fi address: " << ueWifiIface.GetAddress(0) << std::endl
+              << "Bytes sent over LTE:   " << g_ueTxBytes[ueLteInterface] << std::endl
+              << "Bytes sent over Wi-Fi: " << g_ueTxBytes[ueWifiInterface] << std::endl
+              << "Goodput: " << received * 8 / duration / 1e6 << " Mbps" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -94,14 +94,42 @@ ClientEmbeddedObjectReceived(Ptr<const ThreeGppHttpClient>, Ptr<const Packet> pa
     }
 }
 
+/// Sum of the times taken to retrieve the objects
+Time g_objectRtt;
+/// Number of objects retrieved
+uint32_t g_objects = 0;
+
+void
+ClientObjectRtt(const Time& rtt, const Address& /* address */)
+{
+    g_objectRtt += rtt;
+    g_objects++;
+}
+
 int
 main(int argc, char* argv[])
 {
     double simTimeSec = 300;
+    std::string protocol = "Tcp";
     CommandLine cmd(__FILE__);
     cmd.AddValue("SimulationTime", "Length of simulation in seconds.", simTimeSec);
+    cmd.AddValue("protocol", "Transport protocol to use: Tcp, Quic", protocol);
     cmd.Parse(argc, argv);
 
+    TypeId protocolTid;
+    if (protocol == "Tcp")
+    {
+        protocolTid = TcpSocketFactory::GetTypeId();
+    }
+    else if (protocol == "Quic")
+    {
+        protocolTid = QuicSocketFactory::GetTypeId();
+    }
+    else
+    {
+        NS_FATAL_ERROR("Unknown protocol " << protocol);
+    }
+
     Time::SetResolution(Time::NS);
     LogComponentEnableAll(LOG_PREFIX_TIME);
     // LogComponentEnableAll (LOG_PREFIX_FUNC);
@@ -132,6 +160,7 @@ main(int argc, char* argv[])
 
     // Create HTTP server helper
     ThreeGppHttpServerHelper serverHelper(serverAddress);
+    serverHelper.SetAttribute("Protocol", TypeIdValue(protocolTid));
 
     // Install HTTP server
     ApplicationContainer serverApps = serverHelper.Install(nodes.Get(1));
@@ -154,6 +183,7 @@ main(int argc, char* argv[])
 
     // Create HTTP client helper
     ThreeGppHttpClientHelper clientHelper(serverAddress);
+    clientHelper.SetAttribute("Protocol", TypeIdValue(protocolTid));
 
     // Install HTTP client
     ApplicationContainer clientApps = clientHelper.Install(nodes.Get(0));
@@ -164,11 +194,20 @@ main(int argc, char* argv[])
     httpClient->TraceConnectWithoutContext("RxEmbeddedObject",
                                            MakeCallback(&ClientEmbeddedObjectReceived));
     httpClient->TraceConnectWithoutContext("Rx", MakeCallback(&ClientRx));
+    httpClient->TraceConnectWithoutContext("RxRtt", MakeCallback(&ClientObjectRtt));
 
     // Stop browsing after 30 minutes
     clientApps.Stop(Seconds(simTimeSec));
 
     Simulator::Run();
+
+    if (g_objects > 0)
+    {
+        std::cout << "Average object retrieval time over " << protocol << ": "
+                  << (g_objectRtt / g_objects).As(Time::MS) << " (" << g_objects << " objects)"
+                  << std::endl;
+    }
+
     Simulator::Destroy();
     return 0;
 }
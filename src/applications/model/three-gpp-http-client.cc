@@ -77,6 +77,13 @@ ThreeGppHttpClient::GetTypeId()
                           UintegerValue(80), // the default HTTP port
                           MakeUintegerAccessor(&ThreeGppHttpClient::m_remoteServerPort),
                           MakeUintegerChecker<uint16_t>())
+            .AddAttribute("Protocol",
+                          "The type of the socket factory used to connect to the server, "
+                          "e.g., ns3::TcpSocketFactory or ns3::QuicSocketFactory. The "
+                          "server must use the same protocol.",
+                          TypeIdValue(TcpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&ThreeGppHttpClient::m_protocol),
+                          MakeTypeIdChecker())
             .AddTraceSource(
                 "ConnectionEstablished",
                 "Connection to the destination web server has been established.",
@@ -362,7 +369,7 @@ ThreeGppHttpClient::OpenConnection()
     if (m_state == NOT_STARTED || m_state == EXPECTING_EMBEDDED_OBJECT ||
         m_state == PARSING_MAIN_OBJECT || m_state == READING)
     {
-        m_socket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
+        m_socket = Socket::CreateSocket(GetNode(), m_protocol);
 
         [[maybe_unused]] int ret;
 
@@ -405,7 +412,8 @@ ThreeGppHttpClient::OpenConnection()
         m_socket->SetCloseCallbacks(MakeCallback(&ThreeGppHttpClient::NormalCloseCallback, this),
                                     MakeCallback(&ThreeGppHttpClient::ErrorCloseCallback, this));
         m_socket->SetRecvCallback(MakeCallback(&ThreeGppHttpClient::ReceivedDataCallback, this));
-        m_socket->SetAttribute("MaxSegLifetime", DoubleValue(0.02)); // 20 ms.
+        // Not all the transports have this attribute (e.g., QUIC).
+        m_socket->SetAttributeFailSafe("MaxSegLifetime", DoubleValue(0.02)); // 20 ms.
 
     } // end of `if (m_state == {NOT_STARTED, EXPECTING_EMBEDDED_OBJECT, PARSING_MAIN_OBJECT,
       // READING})`
@@ -367,6 +367,8 @@ class ThreeGppHttpClient : public Application
     Address m_remoteServerAddress;
     /// The `RemoteServerPort` attribute.
     uint16_t m_remoteServerPort;
+    /// The `Protocol` attribute. Type of the socket factory of the transport.
+    TypeId m_protocol;
 
     // TRACE SOURCES
 
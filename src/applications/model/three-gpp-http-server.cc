@@ -91,6 +91,12 @@ ThreeGppHttpServer::GetTypeId()
                           UintegerValue(),
                           MakeUintegerAccessor(&ThreeGppHttpServer::m_mtuSize),
                           MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Protocol",
+                          "The type of the socket factory on which the server listens, "
+                          "e.g., ns3::TcpSocketFactory or ns3::QuicSocketFactory.",
+                          TypeIdValue(TcpSocketFactory::GetTypeId()),
+                          MakeTypeIdAccessor(&ThreeGppHttpServer::m_protocol),
+                          MakeTypeIdChecker())
             .AddTraceSource(
                 "ConnectionEstablished",
                 "Connection to a remote web client has been established.",
@@ -206,8 +212,9 @@ ThreeGppHttpServer::StartApplication()
             }
 
             // Creating a TCP socket to connect to the server.
-            m_initialSocket = Socket::CreateSocket(GetNode(), TcpSocketFactory::GetTypeId());
-            m_initialSocket->SetAttribute("SegmentSize", UintegerValue(m_mtuSize));
+            m_initialSocket = Socket::CreateSocket(GetNode(), m_protocol);
+            // Not all the transports have this attribute (e.g., QUIC).
+            m_initialSocket->SetAttributeFailSafe("SegmentSize", UintegerValue(m_mtuSize));
 
             [[maybe_unused]] int ret;
 
@@ -274,6 +274,8 @@ class ThreeGppHttpServer : public Application
     uint16_t m_localPort;
     /// The `Mtu` attribute.
     uint32_t m_mtuSize;
+    /// The `Protocol` attribute. Type of the socket factory of the transport.
+    TypeId m_protocol;
 
     // TRACE SOURCES
 
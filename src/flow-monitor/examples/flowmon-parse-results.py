@@ -110,8 +110,10 @@ class Flow(object):
             self.hopCount = float(flow_el.get('timesForwarded')) / rxPackets + 1
         else:
             self.hopCount = -1000
-        if rxPackets:
-            self.delayMean = float(flow_el.get('delaySum')[:-2]) / rxPackets * 1e-9
+        # with packet sampling, the delay is measured on delaySamples packets only
+        delaySamples = float(flow_el.get('delaySamples', rxPackets))
+        if rxPackets and delaySamples:
+            self.delayMean = float(flow_el.get('delaySum')[:-2]) / delaySamples * 1e-9
             self.packetSizeMean = float(flow_el.get('rxBytes')) / rxPackets
         else:
             self.delayMean = None
@@ -181,8 +183,9 @@ class Simulation(object):
                 s.packets = int(stats.get('packets'))
                 s.bytes = float(stats.get('bytes'))
                 s.probeId = probeId
-                if s.packets > 0:
-                    s.delayFromFirstProbe =  parse_time_ns(stats.get('delayFromFirstProbeSum')) / float(s.packets)
+                delaySamples = int(stats.get('delaySamples', s.packets))
+                if delaySamples > 0:
+                    s.delayFromFirstProbe =  parse_time_ns(stats.get('delayFromFirstProbeSum')) / float(delaySamples)
                 else:
                     s.delayFromFirstProbe = 0
                 flow_map[flowId].probe_stats_unsorted.append(s)
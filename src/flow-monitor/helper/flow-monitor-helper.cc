@@ -29,6 +29,7 @@
 #include "ns3/ipv6-l3-protocol.h"
 #include "ns3/node-list.h"
 #include "ns3/node.h"
+#include "ns3/uinteger.h"
 
 namespace ns3
 {
@@ -61,9 +62,15 @@ FlowMonitorHelper::GetMonitor()
     if (!m_flowMonitor)
     {
         m_flowMonitor = m_monitorFactory.Create<FlowMonitor>();
-        m_flowClassifier4 = Create<Ipv4FlowClassifier>();
+        UintegerValue expectedFlows;
+        m_flowMonitor->GetAttribute("ExpectedFlows", expectedFlows);
+        Ptr<Ipv4FlowClassifier> classifier4 = Create<Ipv4FlowClassifier>();
+        classifier4->Reserve(expectedFlows.Get());
+        m_flowClassifier4 = classifier4;
         m_flowMonitor->AddFlowClassifier(m_flowClassifier4);
-        m_flowClassifier6 = Create<Ipv6FlowClassifier>();
+        Ptr<Ipv6FlowClassifier> classifier6 = Create<Ipv6FlowClassifier>();
+        classifier6->Reserve(expectedFlows.Get());
+        m_flowClassifier6 = classifier6;
         m_flowMonitor->AddFlowClassifier(m_flowClassifier6);
     }
     return m_flowMonitor;
@@ -20,10 +20,13 @@
 
 #include "flow-monitor.h"
 
+#include "ns3/boolean.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/simulator.h"
+#include "ns3/uinteger.h"
 
+#include <chrono>
 #include <fstream>
 #include <sstream>
 
@@ -36,6 +39,43 @@ NS_LOG_COMPONENT_DEFINE("FlowMonitor");
 
 NS_OBJECT_ENSURE_REGISTERED(FlowMonitor);
 
+/**
+ * \ingroup flow-monitor
+ * Adds the wall-clock time elapsed during its lifetime to a total, if enabled
+ */
+class FlowMonitorOverheadTimer
+{
+  public:
+    /**
+     * Constructor
+     * \param enabled whether the time is measured
+     * \param total the total to add the time to, in seconds
+     */
+    FlowMonitorOverheadTimer(bool enabled, double& total)
+        : m_enabled(enabled),
+          m_total(total)
+    {
+        if (m_enabled)
+        {
+            m_start = std::chrono::steady_clock::now();
+        }
+    }
+
+    ~FlowMonitorOverheadTimer()
+    {
+        if (m_enabled)
+        {
+            std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - m_start;
+            m_total += elapsed.count();
+        }
+    }
+
+  private:
+    bool m_enabled;                                //!< Whether the time is measured
+    double& m_total;                               //!< The total processing time
+    std::chrono::steady_clock::time_point m_start; //!< The start of the measurement
+};
+
 TypeId
 FlowMonitor::GetTypeId()
 {
@@ -81,7 +121,27 @@ FlowMonitor::GetTypeId()
                 ("The minimum inter-arrival time that is considered a flow interruption."),
                 TimeValue(Seconds(0.5)),
                 MakeTimeAccessor(&FlowMonitor::m_flowInterruptionsMinTime),
-                MakeTimeChecker());
+                MakeTimeChecker())
+            .AddAttribute("ExpectedFlows",
+                          "The number of flows expected in the simulation. The flow tables are "
+                          "sized for them up front, so that they are not rehashed while the "
+                          "simulation runs.",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FlowMonitor::m_expectedFlows),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("PacketSamplingInterval",
+                          "Track only one packet out of this number in each flow to measure "
+                          "the delay, the jitter and the number of hops. The packet and byte "
+                          "counters are not sampled.",
+                          UintegerValue(1),
+                          MakeUintegerAccessor(&FlowMonitor::m_packetSamplingInterval),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("MeasureOverhead",
+                          "Measure the wall-clock time spent by the FlowMonitor in processing "
+                          "the events reported by the probes (see GetOverheadStats).",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&FlowMonitor::m_measureOverhead),
+                          MakeBooleanChecker());
     return tid;
 }
 
@@ -92,7 +152,10 @@ FlowMonitor::GetInstanceTypeId() const
 }
 
 FlowMonitor::FlowMonitor()
-    : m_enabled(false)
+    : m_reports(0),
+      m_processingTime(0),
+      m_maxTrackedPackets(0),
+      m_enabled(false)
 {
     NS_LOG_FUNCTION(this);
 }
@@ -121,30 +184,39 @@ inline FlowMonitor::FlowStats&
 FlowMonitor::GetStatsForFlow(FlowId flowId)
 {
     NS_LOG_FUNCTION(this);
-    FlowStatsContainerI iter;
-    iter = m_flowStats.find(flowId);
-    if (iter == m_flowStats.end())
+    if (flowId < m_flowStatsIndex.size() && m_flowStatsIndex[flowId])
     {
-        FlowMonitor::FlowStats& ref = m_flowStats[flowId];
-        ref.delaySum = Seconds(0);
-        ref.jitterSum = Seconds(0);
-        ref.lastDelay = Seconds(0);
-        ref.txBytes = 0;
-        ref.rxBytes = 0;
-        ref.txPackets = 0;
-        ref.rxPackets = 0;
-        ref.lostPackets = 0;
-        ref.timesForwarded = 0;
-        ref.delayHistogram.SetDefaultBinWidth(m_delayBinWidth);
-        ref.jitterHistogram.SetDefaultBinWidth(m_jitterBinWidth);
-        ref.packetSizeHistogram.SetDefaultBinWidth(m_packetSizeBinWidth);
-        ref.flowInterruptionsHistogram.SetDefaultBinWidth(m_flowInterruptionsBinWidth);
-        return ref;
+        return *m_flowStatsIndex[flowId];
     }
-    else
+
+    FlowMonitor::FlowStats& ref = m_flowStats[flowId];
+    ref.delaySum = Seconds(0);
+    ref.jitterSum = Seconds(0);
+    ref.lastDelay = Seconds(0);
+    ref.txBytes = 0;
+    ref.rxBytes = 0;
+    ref.txPackets = 0;
+    ref.rxPackets = 0;
+    ref.delaySamples = 0;
+    ref.lostPackets = 0;
+    ref.timesForwarded = 0;
+    ref.delayHistogram.SetDefaultBinWidth(m_delayBinWidth);
+    ref.jitterHistogram.SetDefaultBinWidth(m_jitterBinWidth);
+    ref.packetSizeHistogram.SetDefaultBinWidth(m_packetSizeBinWidth);
+    ref.flowInterruptionsHistogram.SetDefaultBinWidth(m_flowInterruptionsBinWidth);
+    // the FlowIds are usually assigned in sequence by the classifiers
+    if (flowId >= m_flowStatsIndex.size())
     {
-        return iter->second;
+        m_flowStatsIndex.resize(flowId + 1, nullptr);
     }
+    m_flowStatsIndex[flowId] = &ref;
+    return ref;
+}
+
+uint64_t
+FlowMonitor::GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId)
+{
+    return (static_cast<uint64_t>(flowId) << 32) | packetId;
 }
 
 void
@@ -159,15 +231,25 @@ FlowMonitor::ReportFirstTx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
+    FlowMonitorOverheadTimer timer(m_measureOverhead, m_processingTime);
+    m_reports++;
     Time now = Simulator::Now();
-    TrackedPacket& tracked = m_trackedPackets[std::make_pair(flowId, packetId)];
-    tracked.firstSeenTime = now;
-    tracked.lastSeenTime = tracked.firstSeenTime;
-    tracked.timesForwarded = 0;
-    NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
-                                                                 << packetId << ").");
-
-    probe->AddPacketStats(flowId, packetSize, Seconds(0));
+    if (packetId % m_packetSamplingInterval == 0)
+    {
+        TrackedPacket& tracked = m_trackedPackets[GetTrackedPacketKey(flowId, packetId)];
+        tracked.firstSeenTime = now;
+        tracked.lastSeenTime = tracked.firstSeenTime;
+        tracked.timesForwarded = 0;
+        NS_LOG_DEBUG("ReportFirstTx: adding tracked packet (flowId=" << flowId << ", packetId="
+                                                                     << packetId << ").");
+        m_maxTrackedPackets = std::max(m_maxTrackedPackets, m_trackedPackets.size());
+
+        probe->AddPacketStats(flowId, packetSize, Seconds(0));
+    }
+    else
+    {
+        probe->AddPacketStats(flowId, packetSize);
+    }
 
     FlowStats& stats = GetStatsForFlow(flowId);
     stats.txBytes += packetSize;
@@ -191,8 +273,15 @@ FlowMonitor::ReportForwarding(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    std::pair<FlowId, FlowPacketId> key(flowId, packetId);
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(key);
+    FlowMonitorOverheadTimer timer(m_measureOverhead, m_processingTime);
+    m_reports++;
+    if (packetId % m_packetSamplingInterval != 0)
+    {
+        probe->AddPacketStats(flowId, packetSize);
+        return;
+    }
+    TrackedPacketMap::iterator tracked =
+        m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked == m_trackedPackets.end())
     {
         NS_LOG_WARN("Received packet forward report (flowId="
@@ -219,36 +308,53 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         NS_LOG_DEBUG("FlowMonitor not enabled; returning");
         return;
     }
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
-    if (tracked == m_trackedPackets.end())
+    FlowMonitorOverheadTimer timer(m_measureOverhead, m_processingTime);
+    m_reports++;
+    bool sampled = (packetId % m_packetSamplingInterval == 0);
+    TrackedPacketMap::iterator tracked = m_trackedPackets.end();
+    if (sampled)
     {
-        NS_LOG_WARN("Received packet last-tx report (flowId="
-                    << flowId << ", packetId=" << packetId << ") but not known to be transmitted.");
-        return;
+        tracked = m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
+        if (tracked == m_trackedPackets.end())
+        {
+            NS_LOG_WARN("Received packet last-tx report (flowId="
+                        << flowId << ", packetId=" << packetId
+                        << ") but not known to be transmitted.");
+            return;
+        }
     }
 
     Time now = Simulator::Now();
-    Time delay = (now - tracked->second.firstSeenTime);
-    probe->AddPacketStats(flowId, packetSize, delay);
-
     FlowStats& stats = GetStatsForFlow(flowId);
-    stats.delaySum += delay;
-    stats.delayHistogram.AddValue(delay.GetSeconds());
-    if (stats.rxPackets > 0)
+    if (sampled)
     {
-        Time jitter = stats.lastDelay - delay;
-        if (jitter > Seconds(0))
-        {
-            stats.jitterSum += jitter;
-            stats.jitterHistogram.AddValue(jitter.GetSeconds());
-        }
-        else
+        Time delay = (now - tracked->second.firstSeenTime);
+        probe->AddPacketStats(flowId, packetSize, delay);
+
+        stats.delaySum += delay;
+        stats.delayHistogram.AddValue(delay.GetSeconds());
+        if (stats.delaySamples > 0)
         {
-            stats.jitterSum -= jitter;
-            stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            Time jitter = stats.lastDelay - delay;
+            if (jitter > Seconds(0))
+            {
+                stats.jitterSum += jitter;
+                stats.jitterHistogram.AddValue(jitter.GetSeconds());
+            }
+            else
+            {
+                stats.jitterSum -= jitter;
+                stats.jitterHistogram.AddValue(-jitter.GetSeconds());
+            }
         }
+        stats.lastDelay = delay;
+        stats.delaySamples++;
+        stats.timesForwarded += tracked->second.timesForwarded;
+    }
+    else
+    {
+        probe->AddPacketStats(flowId, packetSize);
     }
-    stats.lastDelay = delay;
 
     stats.rxBytes += packetSize;
     stats.packetSizeHistogram.AddValue((double)packetSize);
@@ -267,12 +373,14 @@ FlowMonitor::ReportLastRx(Ptr<FlowProbe> probe,
         }
     }
     stats.timeLastRxPacket = now;
-    stats.timesForwarded += tracked->second.timesForwarded;
 
-    NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
-                                                                  << packetId << ").");
+    if (sampled)
+    {
+        NS_LOG_DEBUG("ReportLastTx: removing tracked packet (flowId=" << flowId << ", packetId="
+                                                                      << packetId << ").");
 
-    m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+        m_trackedPackets.erase(tracked); // we don't need to track this packet anymore
+    }
 }
 
 void
@@ -289,6 +397,8 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
         return;
     }
 
+    FlowMonitorOverheadTimer timer(m_measureOverhead, m_processingTime);
+    m_reports++;
     probe->AddPacketDropStats(flowId, packetSize, reasonCode);
 
     FlowStats& stats = GetStatsForFlow(flowId);
@@ -303,7 +413,8 @@ FlowMonitor::ReportDrop(Ptr<FlowProbe> probe,
     NS_LOG_DEBUG("++stats.packetsDropped["
                  << reasonCode << "]; // becomes: " << stats.packetsDropped[reasonCode]);
 
-    TrackedPacketMap::iterator tracked = m_trackedPackets.find(std::make_pair(flowId, packetId));
+    TrackedPacketMap::iterator tracked =
+        m_trackedPackets.find(GetTrackedPacketKey(flowId, packetId));
     if (tracked != m_trackedPackets.end())
     {
         // we don't need to track this packet anymore
@@ -324,6 +435,7 @@ void
 FlowMonitor::CheckForLostPackets(Time maxDelay)
 {
     NS_LOG_FUNCTION(this << maxDelay.As(Time::S));
+    FlowMonitorOverheadTimer timer(m_measureOverhead, m_processingTime);
     Time now = Simulator::Now();
 
     for (TrackedPacketMap::iterator iter = m_trackedPackets.begin();
@@ -331,10 +443,11 @@ FlowMonitor::CheckForLostPackets(Time maxDelay)
     {
         if (now - iter->second.lastSeenTime >= maxDelay)
         {
-            // packet is considered lost, add it to the loss statistics
-            FlowStatsContainerI flow = m_flowStats.find(iter->first.first);
-            NS_ASSERT(flow != m_flowStats.end());
-            flow->second.lostPackets++;
+            // packet is considered lost, add it to the loss statistics; a
+            // sampled packet stands for the packets that were not tracked
+            FlowId flowId = iter->first >> 32;
+            NS_ASSERT(flowId < m_flowStatsIndex.size() && m_flowStatsIndex[flowId]);
+            m_flowStatsIndex[flowId]->lostPackets += m_packetSamplingInterval;
 
             // we won't track it anymore
             m_trackedPackets.erase(iter++);
@@ -363,6 +476,8 @@ void
 FlowMonitor::NotifyConstructionCompleted()
 {
     Object::NotifyConstructionCompleted();
+    m_flowStatsIndex.reserve(m_expectedFlows + 1);
+    m_trackedPackets.reserve(m_expectedFlows);
     Simulator::Schedule(PERIODIC_CHECK_INTERVAL, &FlowMonitor::PeriodicCheckForLostPackets, this);
 }
 
@@ -378,6 +493,18 @@ FlowMonitor::GetAllProbes() const
     return m_flowProbes;
 }
 
+FlowMonitor::OverheadStats
+FlowMonitor::GetOverheadStats() const
+{
+    OverheadStats overhead;
+    overhead.reports = m_reports;
+    overhead.processingTime = m_processingTime;
+    overhead.flows = m_flowStats.size();
+    overhead.trackedPackets = m_trackedPackets.size();
+    overhead.maxTrackedPackets = m_maxTrackedPackets;
+    return overhead;
+}
+
 void
 FlowMonitor::Start(const Time& time)
 {
@@ -455,8 +582,12 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
                   ATTRIB_TIME(timeLastTxPacket) ATTRIB_TIME(timeLastRxPacket) ATTRIB_TIME(delaySum)
                       ATTRIB_TIME(jitterSum) ATTRIB_TIME(lastDelay) ATTRIB(txBytes) ATTRIB(rxBytes)
                           ATTRIB(txPackets) ATTRIB(rxPackets) ATTRIB(lostPackets)
-                              ATTRIB(timesForwarded)
-           << ">\n";
+                              ATTRIB(timesForwarded);
+        if (m_packetSamplingInterval > 1)
+        {
+            os ATTRIB(delaySamples);
+        }
+        os << ">\n";
 #undef ATTRIB_TIME
 #undef ATTRIB
 
@@ -512,6 +643,16 @@ FlowMonitor::SerializeToXmlStream(std::ostream& os,
         os << std::string(indent, ' ') << "</FlowProbes>\n";
     }
 
+    if (m_measureOverhead)
+    {
+        OverheadStats overhead = GetOverheadStats();
+        os << std::string(indent, ' ') << "<Overhead reports=\"" << overhead.reports << "\""
+           << " processingTime=\"" << overhead.processingTime << "s\""
+           << " flows=\"" << overhead.flows << "\""
+           << " trackedPackets=\"" << overhead.trackedPackets << "\""
+           << " maxTrackedPackets=\"" << overhead.maxTrackedPackets << "\" />\n";
+    }
+
     indent -= 2;
     os << std::string(indent, ' ') << "</FlowMonitor>\n";
 }
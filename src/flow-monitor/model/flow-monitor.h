@@ -30,6 +30,7 @@
 #include "ns3/ptr.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -75,7 +76,7 @@ class FlowMonitor : public Object
 
         /// Contains the sum of all end-to-end delays for all received
         /// packets of the flow.
-        Time delaySum; // delayCount == rxPackets
+        Time delaySum; // delayCount == delaySamples
 
         /// Contains the sum of all end-to-end delay jitter (delay
         /// variation) values for all received packets of the flow.  Here
@@ -84,7 +85,7 @@ class FlowMonitor : public Object
         /// i.e. \f$Jitter\left\{P_N\right\} = \left|Delay\left\{P_N\right\} -
         /// Delay\left\{P_{N-1}\right\}\right|\f$. This definition is in accordance with the
         /// Type-P-One-way-ipdv as defined in IETF \RFC{3393}.
-        Time jitterSum; // jitterCount == rxPackets - 1
+        Time jitterSum; // jitterCount == delaySamples - 1
 
         /// Contains the last measured delay of a packet
         /// It is stored to measure the packet's Jitter
@@ -98,12 +99,20 @@ class FlowMonitor : public Object
         uint32_t txPackets;
         /// Total number of received packets for the flow
         uint32_t rxPackets;
+        /// Number of received packets whose delay was measured, i.e.,
+        /// rxPackets unless the packets are sampled (see the
+        /// PacketSamplingInterval attribute).  The delay and jitter sums
+        /// and histograms, and timesForwarded, only account for these
+        /// packets.
+        uint32_t delaySamples;
 
         /// Total number of packets that are assumed to be lost,
         /// i.e. those that were transmitted but have not been reportedly
         /// received or forwarded for a long time.  By default, packets
         /// missing for a period of over 10 seconds are assumed to be
-        /// lost, although this value can be easily configured in runtime
+        /// lost, although this value can be easily configured in runtime.
+        /// When the packets are sampled, each sampled packet assumed to
+        /// be lost accounts for PacketSamplingInterval packets
         uint32_t lostPackets;
 
         /// Contains the number of times a packet has been reportedly
@@ -138,6 +147,23 @@ class FlowMonitor : public Object
         Histogram flowInterruptionsHistogram; //!< histogram of durations of flow interruptions
     };
 
+    /// \brief Structure that represents the cost of the monitoring itself
+    struct OverheadStats
+    {
+        /// Number of events reported by the probes
+        uint64_t reports;
+        /// Wall-clock time, in seconds, spent by the FlowMonitor in
+        /// processing the reports of the probes and in checking for lost
+        /// packets.  Only measured if the MeasureOverhead attribute is true
+        double processingTime;
+        /// Number of flows
+        uint32_t flows;
+        /// Number of packets currently tracked
+        uint32_t trackedPackets;
+        /// Largest number of packets tracked at the same time
+        uint32_t maxTrackedPackets;
+    };
+
     // --- basic methods ---
     /**
      * \brief Get the type ID.
@@ -251,6 +277,10 @@ class FlowMonitor : public Object
     /// \returns a list of all the probes
     const FlowProbeContainer& GetAllProbes() const;
 
+    /// Retrieve the statistics of the cost of the monitoring itself
+    /// \returns the overhead statistics
+    OverheadStats GetOverheadStats() const;
+
     /// Serializes the results to an std::ostream in XML format
     /// \param os the output stream
     /// \param indent number of spaces to use as base indentation level
@@ -289,12 +319,20 @@ class FlowMonitor : public Object
 
     /// FlowId --> FlowStats
     FlowStatsContainer m_flowStats;
+    /// FlowId --> FlowStats in m_flowStats, for constant-time lookups
+    std::vector<FlowStats*> m_flowStatsIndex;
 
-    /// (FlowId,PacketId) --> TrackedPacket
-    typedef std::map<std::pair<FlowId, FlowPacketId>, TrackedPacket> TrackedPacketMap;
+    /// (FlowId,PacketId) --> TrackedPacket, see GetTrackedPacketKey()
+    typedef std::unordered_map<uint64_t, TrackedPacket> TrackedPacketMap;
     TrackedPacketMap m_trackedPackets; //!< Tracked packets
     Time m_maxPerHopDelay;             //!< Minimum per-hop delay
     FlowProbeContainer m_flowProbes;   //!< all the FlowProbes
+    uint32_t m_expectedFlows;          //!< Number of flows to reserve room for
+    uint32_t m_packetSamplingInterval; //!< One packet out of this number is tracked
+    bool m_measureOverhead;            //!< Whether the processing time is measured
+    uint64_t m_reports;                //!< Number of reports received from the probes
+    double m_processingTime;           //!< Wall-clock processing time (seconds)
+    std::size_t m_maxTrackedPackets;   //!< Largest number of packets tracked at once
 
     // note: this is needed only for serialization
     std::list<Ptr<FlowClassifier>> m_classifiers; //!< the FlowClassifiers
@@ -313,6 +351,12 @@ class FlowMonitor : public Object
     /// \returns the stats of the flow
     FlowStats& GetStatsForFlow(FlowId flowId);
 
+    /// Get the key of a packet in the tracked packets
+    /// \param flowId the Flow identification
+    /// \param packetId the Packet ID
+    /// \returns the key of the packet
+    static uint64_t GetTrackedPacketKey(FlowId flowId, FlowPacketId packetId);
+
     /// Periodic function to check for lost packets and prune statistics
     void PeriodicCheckForLostPackets();
 };
@@ -60,6 +60,15 @@ FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirs
     flow.delayFromFirstProbeSum += delayFromFirstProbe;
     flow.bytes += packetSize;
     ++flow.packets;
+    ++flow.delaySamples;
+}
+
+void
+FlowProbe::AddPacketStats(FlowId flowId, uint32_t packetSize)
+{
+    FlowStats& flow = m_stats[flowId];
+    flow.bytes += packetSize;
+    ++flow.packets;
 }
 
 void
@@ -79,7 +88,7 @@ FlowProbe::AddPacketDropStats(FlowId flowId, uint32_t packetSize, uint32_t reaso
 FlowProbe::Stats
 FlowProbe::GetStats() const
 {
-    return m_stats;
+    return Stats(m_stats.begin(), m_stats.end());
 }
 
 void
@@ -89,15 +98,20 @@ FlowProbe::SerializeToXmlStream(std::ostream& os, uint16_t indent, uint32_t inde
 
     indent += 2;
 
-    for (Stats::const_iterator iter = m_stats.begin(); iter != m_stats.end(); iter++)
+    Stats stats = GetStats(); // sorted by FlowId
+    for (Stats::const_iterator iter = stats.begin(); iter != stats.end(); iter++)
     {
         os << std::string(indent, ' ');
         os << "<FlowStats "
            << " flowId=\"" << iter->first << "\""
            << " packets=\"" << iter->second.packets << "\""
            << " bytes=\"" << iter->second.bytes << "\""
-           << " delayFromFirstProbeSum=\"" << iter->second.delayFromFirstProbeSum << "\""
-           << " >\n";
+           << " delayFromFirstProbeSum=\"" << iter->second.delayFromFirstProbeSum << "\"";
+        if (iter->second.delaySamples != iter->second.packets)
+        {
+            os << " delaySamples=\"" << iter->second.delaySamples << "\"";
+        }
+        os << " >\n";
         indent += 2;
         for (uint32_t reasonCode = 0; reasonCode < iter->second.packetsDropped.size(); reasonCode++)
         {
@@ -26,6 +26,7 @@
 #include "ns3/object.h"
 
 #include <map>
+#include <unordered_map>
 #include <vector>
 
 namespace ns3
@@ -62,7 +63,8 @@ class FlowProbe : public Object
         FlowStats()
             : delayFromFirstProbeSum(Seconds(0)),
               bytes(0),
-              packets(0)
+              packets(0),
+              delaySamples(0)
         {
         }
 
@@ -70,13 +72,18 @@ class FlowProbe : public Object
         std::vector<uint32_t> packetsDropped;
         /// bytesDropped[reasonCode] => number of dropped bytes
         std::vector<uint64_t> bytesDropped;
-        /// divide by 'packets' to get the average delay from the
+        /// divide by 'delaySamples' to get the average delay from the
         /// first (entry) probe up to this one (partial delay)
         Time delayFromFirstProbeSum;
         /// Number of bytes seen of this flow
         uint64_t bytes;
         /// Number of packets seen of this flow
         uint32_t packets;
+        /// Number of packets whose delay is included in
+        /// delayFromFirstProbeSum.  This is equal to 'packets', unless the
+        /// FlowMonitor samples the packets (see the FlowMonitor
+        /// PacketSamplingInterval attribute)
+        uint32_t delaySamples;
     };
 
     /// Container to map FlowId -> FlowStats
@@ -87,6 +94,10 @@ class FlowProbe : public Object
     /// \param packetSize the packet size
     /// \param delayFromFirstProbe packet delay
     void AddPacketStats(FlowId flowId, uint32_t packetSize, Time delayFromFirstProbe);
+    /// Add a packet whose delay is not measured to the flow stats
+    /// \param flowId the flow Identifier
+    /// \param packetSize the packet size
+    void AddPacketStats(FlowId flowId, uint32_t packetSize);
     /// Add a packet drop data to the flow stats
     /// \param flowId the flow Identifier
     /// \param packetSize the packet size
@@ -106,8 +117,8 @@ class FlowProbe : public Object
     void SerializeToXmlStream(std::ostream& os, uint16_t indent, uint32_t index) const;
 
   protected:
-    Ptr<FlowMonitor> m_flowMonitor; //!< the FlowMonitor instance
-    Stats m_stats;                  //!< The flow stats
+    Ptr<FlowMonitor> m_flowMonitor;                //!< the FlowMonitor instance
+    std::unordered_map<FlowId, FlowStats> m_stats; //!< The flow stats
 };
 
 } // namespace ns3
@@ -26,6 +26,8 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -49,8 +51,22 @@ class Ipv4FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of the five-tuples
+    class FiveTupleHash
+    {
+      public:
+        /// \param tuple the five-tuple
+        /// \return the hash of the five-tuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
     Ipv4FlowClassifier();
 
+    /// Reserve room for the given number of flows, so that the flow
+    /// table is not rehashed while the simulation runs.
+    /// \param flows the expected number of flows
+    void Reserve(uint32_t flows);
+
     /// \brief try to classify the packet into flow-id and packet-id
     ///
     /// \warning: it must be called only once per packet, from SendOutgoingLogger.
@@ -93,12 +109,19 @@ class Ipv4FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
-    /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv4Header::DscpType, uint32_t>> m_flowDscpMap;
+    /// State of a flow
+    struct FlowInfo
+    {
+        FiveTuple tuple;           //!< Five-tuple of the flow
+        FlowPacketId lastPacketId; //!< Identifier of the last packet of the flow
+        /// Number of packets of the flow per DSCP value
+        std::map<Ipv4Header::DscpType, uint32_t> dscpCounts;
+    };
+
+    /// Map the flow five-tuples to their FlowIds
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// State of the flows, indexed by FlowId - 1 (the FlowIds are assigned in sequence)
+    std::vector<FlowInfo> m_flows;
 };
 
 /**
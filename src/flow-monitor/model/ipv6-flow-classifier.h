@@ -27,6 +27,8 @@
 
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
+#include <vector>
 
 namespace ns3
 {
@@ -50,8 +52,22 @@ class Ipv6FlowClassifier : public FlowClassifier
         uint16_t destinationPort;       //!< Destination port
     };
 
+    /// Hash function of the five-tuples
+    class FiveTupleHash
+    {
+      public:
+        /// \param tuple the five-tuple
+        /// \return the hash of the five-tuple
+        std::size_t operator()(const FiveTuple& tuple) const;
+    };
+
     Ipv6FlowClassifier();
 
+    /// Reserve room for the given number of flows, so that the flow
+    /// table is not rehashed while the simulation runs.
+    /// \param flows the expected number of flows
+    void Reserve(uint32_t flows);
+
     /// \brief try to classify the packet into flow-id and packet-id
     ///
     /// \warning: it must be called only once per packet, from SendOutgoingLogger.
@@ -94,12 +110,19 @@ class Ipv6FlowClassifier : public FlowClassifier
     void SerializeToXmlStream(std::ostream& os, uint16_t indent) const override;
 
   private:
-    /// Map to Flows Identifiers to FlowIds
-    std::map<FiveTuple, FlowId> m_flowMap;
-    /// Map to FlowIds to FlowPacketId
-    std::map<FlowId, FlowPacketId> m_flowPktIdMap;
-    /// Map FlowIds to (DSCP value, packet count) pairs
-    std::map<FlowId, std::map<Ipv6Header::DscpType, uint32_t>> m_flowDscpMap;
+    /// State of a flow
+    struct FlowInfo
+    {
+        FiveTuple tuple;           //!< Five-tuple of the flow
+        FlowPacketId lastPacketId; //!< Identifier of the last packet of the flow
+        /// Number of packets of the flow per DSCP value
+        std::map<Ipv6Header::DscpType, uint32_t> dscpCounts;
+    };
+
+    /// Map the flow five-tuples to their FlowIds
+    std::unordered_map<FiveTuple, FlowId, FiveTupleHash> m_flowMap;
+    /// State of the flows, indexed by FlowId - 1 (the FlowIds are assigned in sequence)
+    std::vector<FlowInfo> m_flows;
 };
 
 /**
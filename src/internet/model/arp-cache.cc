@@ -201,9 +201,12 @@ ArpCache::HandleWaitReplyTimeout()
     NS_LOG_FUNCTION(this);
     ArpCache::Entry* entry;
     bool restartWaitReplyTimer = false;
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // Only the entries in WAIT_REPLY state are visited.  The iterator is advanced
+    // before handling the entry, as entries marked dead are removed from the container.
+    for (auto i = m_waitReplyEntries.begin(); i != m_waitReplyEntries.end();)
     {
         entry = (*i).second;
+        i++;
         if (entry != nullptr && entry->IsWaitReply())
         {
             if (entry->GetRetries() < m_maxRetries)
@@ -252,6 +255,7 @@ ArpCache::Flush()
         delete (*i).second;
     }
     m_arpCache.erase(m_arpCache.begin(), m_arpCache.end());
+    m_waitReplyEntries.clear();
     if (m_waitReplyTimer.IsRunning())
     {
         NS_LOG_LOGIC("Stopping WaitReplyTimer at " << Simulator::Now().GetSeconds()
@@ -266,7 +270,9 @@ ArpCache::PrintArpCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    // Print the entries sorted by address
+    std::map<Ipv4Address, ArpCache::Entry*> sortedCache(m_arpCache.begin(), m_arpCache.end());
+    for (auto i = sortedCache.begin(); i != sortedCache.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -314,7 +320,7 @@ ArpCache::RemoveAutoGeneratedEntries()
         {
             i->second->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
             delete i->second;
-            m_arpCache.erase(i++);
+            i = m_arpCache.erase(i);
             continue;
         }
         i++;
@@ -335,6 +341,10 @@ ArpCache::LookupInverse(Address to)
             entryList.push_back(entry);
         }
     }
+    // Keep the entries sorted by address, regardless of the container
+    entryList.sort([](ArpCache::Entry* a, ArpCache::Entry* b) {
+        return a->GetIpv4Address() < b->GetIpv4Address();
+    });
     return entryList;
 }
 
@@ -367,15 +377,14 @@ ArpCache::Remove(ArpCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (CacheI i = m_arpCache.begin(); i != m_arpCache.end(); i++)
+    CacheI i = m_arpCache.find(entry->GetIpv4Address());
+    if (i != m_arpCache.end() && (*i).second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_arpCache.erase(i);
-            entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
-            delete entry;
-            return;
-        }
+        m_arpCache.erase(i);
+        m_waitReplyEntries.erase(entry->GetIpv4Address());
+        entry->ClearPendingPacket(); // clear the pending packets for entry's ipaddress
+        delete entry;
+        return;
     }
     NS_LOG_WARN("Entry not found in this ARP Cache");
 }
@@ -428,6 +437,10 @@ ArpCache::Entry::MarkDead()
 {
     NS_LOG_FUNCTION(this);
     NS_ASSERT(m_state == ALIVE || m_state == WAIT_REPLY || m_state == DEAD);
+    if (m_state == WAIT_REPLY)
+    {
+        m_arp->m_waitReplyEntries.erase(m_ipv4Address);
+    }
     m_state = DEAD;
     ClearRetries();
     UpdateSeen();
@@ -438,6 +451,7 @@ ArpCache::Entry::MarkAlive(Address macAddress)
 {
     NS_LOG_FUNCTION(this << macAddress);
     NS_ASSERT(m_state == WAIT_REPLY);
+    m_arp->m_waitReplyEntries.erase(m_ipv4Address);
     m_macAddress = macAddress;
     m_state = ALIVE;
     ClearRetries();
@@ -450,6 +464,10 @@ ArpCache::Entry::MarkPermanent()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
+    if (m_state == WAIT_REPLY)
+    {
+        m_arp->m_waitReplyEntries.erase(m_ipv4Address);
+    }
     m_state = PERMANENT;
     ClearRetries();
     UpdateSeen();
@@ -461,6 +479,10 @@ ArpCache::Entry::MarkAutoGenerated()
     NS_LOG_FUNCTION(this << m_macAddress);
     NS_ASSERT(!m_macAddress.IsInvalid());
 
+    if (m_state == WAIT_REPLY)
+    {
+        m_arp->m_waitReplyEntries.erase(m_ipv4Address);
+    }
     m_state = STATIC_AUTOGENERATED;
     ClearRetries();
     UpdateSeen();
@@ -492,6 +514,7 @@ ArpCache::Entry::MarkWaitReply(Ipv4PayloadHeaderPair waiting)
     NS_ASSERT_MSG(waiting.first, "Can not add a null packet to the ARP queue");
 
     m_state = WAIT_REPLY;
+    m_arp->m_waitReplyEntries[m_ipv4Address] = this;
     m_pending.push_back(waiting);
     UpdateSeen();
     m_arp->StartWaitReplyTimer();
@@ -35,6 +35,7 @@
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -322,11 +323,15 @@ class ArpCache : public Object
     /**
      * \brief ARP Cache container
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash> Cache;
     /**
      * \brief ARP Cache container iterator
      */
-    typedef std::map<Ipv4Address, ArpCache::Entry*>::iterator CacheI;
+    typedef std::unordered_map<Ipv4Address, ArpCache::Entry*, Ipv4AddressHash>::iterator CacheI;
+    /**
+     * \brief Container of the entries in WAIT_REPLY state, sorted by address
+     */
+    typedef std::map<Ipv4Address, ArpCache::Entry*> WaitReplyEntries;
 
     void DoDispose() override;
 
@@ -348,6 +353,11 @@ class ArpCache : public Object
     void HandleWaitReplyTimeout();
     uint32_t m_pendingQueueSize; //!< number of packets waiting for a resolution
     Cache m_arpCache;            //!< the ARP cache
+    /**
+     * Entries in WAIT_REPLY state, so that the retries are handled without
+     * scanning the whole cache.
+     */
+    WaitReplyEntries m_waitReplyEntries;
     TracedCallback<Ptr<const Packet>>
         m_dropTrace; //!< trace for packets dropped by the ARP cache queue
 };
@@ -0,0 +1,382 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-congestion-ops.h"
+
+#include "mptcp-socket.h"
+#include "mptcp-subflow.h"
+#include "tcp-socket-state.h"
+
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpCongestionOps");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpCongestionOps);
+
+TypeId
+MpTcpCongestionOps::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MpTcpCongestionOps").SetParent<TcpNewReno>().SetGroupName("Internet");
+    return tid;
+}
+
+MpTcpCongestionOps::MpTcpCongestionOps()
+    : TcpNewReno()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpCongestionOps::MpTcpCongestionOps(const MpTcpCongestionOps& sock)
+    : TcpNewReno(sock)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpCongestionOps::~MpTcpCongestionOps()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MpTcpCongestionOps::SetMeta(Ptr<MpTcpSocket> meta)
+{
+    NS_LOG_FUNCTION(this << meta);
+    m_meta = meta;
+}
+
+std::vector<MpTcpCongestionOps::SubflowWindow>
+MpTcpCongestionOps::GetSubflowWindows(Ptr<const TcpSocketState> tcb) const
+{
+    std::vector<SubflowWindow> subflows;
+    if (!m_meta || tcb->m_lastRtt.Get().IsZero())
+    {
+        return subflows;
+    }
+
+    for (uint32_t i = 0; i < m_meta->GetNSubflows(); i++)
+    {
+        Ptr<MpTcpSubflow> subflow = m_meta->GetSubflow(i);
+        Ptr<TcpSocketState> state = subflow->GetTcb();
+        if (state->m_lastRtt.Get().IsZero() || state->m_segmentSize == 0)
+        {
+            continue;
+        }
+        SubflowWindow window;
+        window.cWnd = static_cast<double>(state->m_cWnd) / state->m_segmentSize;
+        window.rtt = subflow->GetRttEstimate().GetSeconds();
+        window.cong = DynamicCast<MpTcpCongestionOps>(subflow->GetCongestionControl());
+        window.own = (state == tcb);
+        subflows.push_back(window);
+    }
+    return subflows;
+}
+
+void
+MpTcpCongestionOps::CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+    NS_LOG_FUNCTION(this << tcb << segmentsAcked);
+
+    std::vector<SubflowWindow> subflows = GetSubflowWindows(tcb);
+    auto own = std::find_if(subflows.begin(), subflows.end(), [](const SubflowWindow& s) {
+        return s.own;
+    });
+    if (subflows.size() < 2 || own == subflows.end())
+    {
+        TcpNewReno::CongestionAvoidance(tcb, segmentsAcked);
+        return;
+    }
+
+    m_increase +=
+        segmentsAcked * GetIncrease(subflows, own - subflows.begin()) * tcb->m_segmentSize;
+    if (m_increase >= 1)
+    {
+        auto delta = static_cast<uint32_t>(m_increase);
+        m_increase -= delta;
+        tcb->m_cWnd += delta;
+    }
+    else if (m_increase <= -1)
+    {
+        auto delta = static_cast<uint32_t>(-m_increase);
+        m_increase += delta;
+        tcb->m_cWnd = std::max(tcb->m_cWnd.Get() - std::min(delta, tcb->m_cWnd.Get()),
+                               2 * tcb->m_segmentSize);
+    }
+    NS_LOG_INFO("In CongAvoid, updated to cwnd " << tcb->m_cWnd << " ssthresh "
+                                                 << tcb->m_ssThresh);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpLia);
+
+TypeId
+TcpLia::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpLia")
+                            .SetParent<MpTcpCongestionOps>()
+                            .AddConstructor<TcpLia>()
+                            .SetGroupName("Internet");
+    return tid;
+}
+
+TcpLia::TcpLia()
+    : MpTcpCongestionOps()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpLia::TcpLia(const TcpLia& sock)
+    : MpTcpCongestionOps(sock)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpLia::~TcpLia()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+TcpLia::GetName() const
+{
+    return "TcpLia";
+}
+
+Ptr<TcpCongestionOps>
+TcpLia::Fork()
+{
+    return CopyObject<TcpLia>(this);
+}
+
+double
+TcpLia::GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own)
+{
+    double total = 0;
+    double best = 0;
+    double rates = 0;
+    for (const auto& s : subflows)
+    {
+        total += s.cWnd;
+        best = std::max(best, s.cWnd / (s.rtt * s.rtt));
+        rates += s.cWnd / s.rtt;
+    }
+    double alpha = total * best / (rates * rates);
+    return std::min(alpha / total, 1 / subflows[own].cWnd);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOlia);
+
+TypeId
+TcpOlia::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOlia")
+                            .SetParent<MpTcpCongestionOps>()
+                            .AddConstructor<TcpOlia>()
+                            .SetGroupName("Internet");
+    return tid;
+}
+
+TcpOlia::TcpOlia()
+    : MpTcpCongestionOps()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpOlia::TcpOlia(const TcpOlia& sock)
+    : MpTcpCongestionOps(sock)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpOlia::~TcpOlia()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+TcpOlia::GetName() const
+{
+    return "TcpOlia";
+}
+
+Ptr<TcpCongestionOps>
+TcpOlia::Fork()
+{
+    return CopyObject<TcpOlia>(this);
+}
+
+void
+TcpOlia::PktsAcked(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked, const Time& rtt)
+{
+    NS_LOG_FUNCTION(this << tcb << segmentsAcked << rtt);
+    m_sinceLoss += segmentsAcked;
+}
+
+uint32_t
+TcpOlia::GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+{
+    NS_LOG_FUNCTION(this << tcb << bytesInFlight);
+    m_betweenLosses = m_sinceLoss;
+    m_sinceLoss = 0;
+    return TcpNewReno::GetSsThresh(tcb, bytesInFlight);
+}
+
+uint32_t
+TcpOlia::GetInterLossSegments() const
+{
+    return std::max(m_sinceLoss, m_betweenLosses);
+}
+
+double
+TcpOlia::GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own)
+{
+    double rates = 0;
+    double maxWnd = 0;
+    double maxQuality = 0;
+    std::vector<double> quality;
+    for (const auto& s : subflows)
+    {
+        rates += s.cWnd / s.rtt;
+        maxWnd = std::max(maxWnd, s.cWnd);
+        Ptr<TcpOlia> olia = DynamicCast<TcpOlia>(s.cong);
+        double l = olia ? olia->GetInterLossSegments() : 0;
+        quality.push_back(l * l / s.rtt);
+        maxQuality = std::max(maxQuality, quality.back());
+    }
+
+    // Best paths which do not have the largest window, and paths with the
+    // largest window
+    uint32_t nBestNotMax = 0;
+    uint32_t nMax = 0;
+    bool ownBestNotMax = false;
+    bool ownMax = false;
+    for (uint32_t i = 0; i < subflows.size(); i++)
+    {
+        bool isMax = subflows[i].cWnd >= maxWnd;
+        bool isBest = quality[i] >= maxQuality;
+        nMax += isMax;
+        if (isBest && !isMax)
+        {
+            nBestNotMax++;
+            ownBestNotMax |= (i == own);
+        }
+        ownMax |= (isMax && i == own);
+    }
+
+    double n = subflows.size();
+    double alpha = 0;
+    if (nBestNotMax > 0)
+    {
+        if (ownBestNotMax)
+        {
+            alpha = 1 / (n * nBestNotMax);
+        }
+        else if (ownMax)
+        {
+            alpha = -1 / (n * nMax);
+        }
+    }
+
+    const SubflowWindow& s = subflows[own];
+    return (s.cWnd / (s.rtt * s.rtt)) / (rates * rates) + alpha / s.cWnd;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpBalia);
+
+TypeId
+TcpBalia::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpBalia")
+                            .SetParent<MpTcpCongestionOps>()
+                            .AddConstructor<TcpBalia>()
+                            .SetGroupName("Internet");
+    return tid;
+}
+
+TcpBalia::TcpBalia()
+    : MpTcpCongestionOps()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpBalia::TcpBalia(const TcpBalia& sock)
+    : MpTcpCongestionOps(sock)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpBalia::~TcpBalia()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+std::string
+TcpBalia::GetName() const
+{
+    return "TcpBalia";
+}
+
+Ptr<TcpCongestionOps>
+TcpBalia::Fork()
+{
+    return CopyObject<TcpBalia>(this);
+}
+
+uint32_t
+TcpBalia::GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight)
+{
+    NS_LOG_FUNCTION(this << tcb << bytesInFlight);
+
+    std::vector<SubflowWindow> subflows = GetSubflowWindows(tcb);
+    auto own = std::find_if(subflows.begin(), subflows.end(), [](const SubflowWindow& s) {
+        return s.own;
+    });
+    if (subflows.size() < 2 || own == subflows.end())
+    {
+        return TcpNewReno::GetSsThresh(tcb, bytesInFlight);
+    }
+
+    double maxRate = 0;
+    for (const auto& s : subflows)
+    {
+        maxRate = std::max(maxRate, s.cWnd / s.rtt);
+    }
+    double alpha = maxRate / (own->cWnd / own->rtt);
+    auto decrease = static_cast<uint32_t>(bytesInFlight / 2.0 * std::min(alpha, 1.5));
+    return std::max(2 * tcb->m_segmentSize, bytesInFlight - std::min(decrease, bytesInFlight));
+}
+
+double
+TcpBalia::GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own)
+{
+    double rates = 0;
+    double maxRate = 0;
+    for (const auto& s : subflows)
+    {
+        rates += s.cWnd / s.rtt;
+        maxRate = std::max(maxRate, s.cWnd / s.rtt);
+    }
+    const SubflowWindow& s = subflows[own];
+    double rate = s.cWnd / s.rtt;
+    double alpha = maxRate / rate;
+    return (rate / s.rtt) / (rates * rates) * (1 + alpha) / 2 * (4 + alpha) / 5;
+}
+
+} // namespace ns3
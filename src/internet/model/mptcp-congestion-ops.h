@@ -0,0 +1,235 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPTCP_CONGESTION_OPS_H
+#define MPTCP_CONGESTION_OPS_H
+
+#include "tcp-congestion-ops.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class MpTcpSocket;
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief Base class of the coupled congestion controls of Multipath TCP
+ *
+ * Each subflow of a Multipath TCP connection runs its own instance of the
+ * congestion control, which is coupled to the instances of the other
+ * subflows through the MpTcpSocket they belong to. The slow start and the
+ * loss recovery are those of NewReno; the congestion avoidance increases
+ * the window by the amount computed by GetIncrease() for each segment
+ * acknowledged, with the fractional part carried over to the next ACKs.
+ *
+ * Only the subflows for which an RTT sample is available are coupled. A
+ * subflow that is alone, or whose congestion control is not attached to
+ * a connection, behaves as NewReno.
+ */
+class MpTcpCongestionOps : public TcpNewReno
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpCongestionOps();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    MpTcpCongestionOps(const MpTcpCongestionOps& sock);
+
+    ~MpTcpCongestionOps() override;
+
+    /**
+     * \brief Set the connection whose subflows are coupled
+     * \param meta the connection, or nullptr to decouple the subflow
+     */
+    void SetMeta(Ptr<MpTcpSocket> meta);
+
+  protected:
+    /// The window and the RTT of a subflow
+    struct SubflowWindow
+    {
+        double cWnd;                  //!< Congestion window, in segments
+        double rtt;                   //!< Smoothed RTT, in seconds
+        Ptr<MpTcpCongestionOps> cong; //!< Congestion control of the subflow
+        bool own;                     //!< Whether this is the subflow being updated
+    };
+
+    /**
+     * \brief Get the windows of the subflows of the connection
+     * \param tcb the congestion state of the subflow being updated
+     * \return the windows, or an empty vector if the subflow is not coupled
+     */
+    std::vector<SubflowWindow> GetSubflowWindows(Ptr<const TcpSocketState> tcb) const;
+
+    /**
+     * \brief Compute the increase of the window per segment acknowledged
+     * \param subflows the windows of the subflows of the connection
+     * \param own the index of the subflow being updated
+     * \return the increase, in segments
+     */
+    virtual double GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own) = 0;
+
+    void CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked) override;
+
+  private:
+    Ptr<MpTcpSocket> m_meta; //!< The connection whose subflows are coupled
+    double m_increase{0};    //!< Increase of the window not applied yet, in bytes
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief The Linked Increases Algorithm (LIA), \RFC{6356}
+ *
+ * The window of subflow i is increased, for each segment acknowledged, by
+ * min (alpha / w_total, 1 / w_i), where
+ *
+ *     alpha = w_total * max_i (w_i / rtt_i^2) / (sum_i w_i / rtt_i)^2
+ *
+ * so that the connection is no more aggressive than a single TCP flow on
+ * the best of its paths.
+ */
+class TcpLia : public MpTcpCongestionOps
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpLia();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    TcpLia(const TcpLia& sock);
+
+    ~TcpLia() override;
+
+    std::string GetName() const override;
+    Ptr<TcpCongestionOps> Fork() override;
+
+  protected:
+    double GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own) override;
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief The Opportunistic Linked Increases Algorithm (OLIA)
+ *
+ * The window of subflow r is increased, for each segment acknowledged, by
+ *
+ *     (w_r / rtt_r^2) / (sum_p w_p / rtt_p)^2 + alpha_r / w_r
+ *
+ * where alpha_r moves window from the paths with the largest windows to the
+ * best paths, i.e., those with the largest l_p^2 / rtt_p, l_p being the
+ * number of segments acknowledged between the last two losses of the path,
+ * when these paths do not have the largest windows [Khalili et al., 2013].
+ */
+class TcpOlia : public MpTcpCongestionOps
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpOlia();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    TcpOlia(const TcpOlia& sock);
+
+    ~TcpOlia() override;
+
+    std::string GetName() const override;
+    Ptr<TcpCongestionOps> Fork() override;
+    void PktsAcked(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked, const Time& rtt) override;
+    uint32_t GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) override;
+
+    /**
+     * \brief Get the number of segments acknowledged between the last two
+     *        losses, or since the last loss if larger
+     * \return the number of segments
+     */
+    uint32_t GetInterLossSegments() const;
+
+  protected:
+    double GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own) override;
+
+  private:
+    uint32_t m_sinceLoss{0};     //!< Segments acknowledged since the last loss
+    uint32_t m_betweenLosses{0}; //!< Segments acknowledged between the last two losses
+};
+
+/**
+ * \ingroup congestionOps
+ *
+ * \brief The Balanced Linked Adaptation algorithm (BALIA)
+ *
+ * With x_r = w_r / rtt_r and alpha_r = max_k x_k / x_r, the window of
+ * subflow r is increased, for each segment acknowledged, by
+ *
+ *     (x_r / rtt_r) / (sum_k x_k)^2 * (1 + alpha_r) / 2 * (4 + alpha_r) / 5
+ *
+ * and decreased upon loss by w_r / 2 * min (alpha_r, 1.5)
+ * [Peng et al., 2016].
+ */
+class TcpBalia : public MpTcpCongestionOps
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    TcpBalia();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    TcpBalia(const TcpBalia& sock);
+
+    ~TcpBalia() override;
+
+    std::string GetName() const override;
+    Ptr<TcpCongestionOps> Fork() override;
+    uint32_t GetSsThresh(Ptr<const TcpSocketState> tcb, uint32_t bytesInFlight) override;
+
+  protected:
+    double GetIncrease(const std::vector<SubflowWindow>& subflows, uint32_t own) override;
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_CONGESTION_OPS_H */
@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-scheduler.h"
+
+#include "mptcp-socket.h"
+#include "mptcp-subflow.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpScheduler");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpScheduler);
+
+TypeId
+MpTcpScheduler::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MpTcpScheduler").SetParent<Object>().SetGroupName("Internet");
+    return tid;
+}
+
+MpTcpScheduler::MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpScheduler::~MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSchedulerMinRtt);
+
+TypeId
+MpTcpSchedulerMinRtt::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSchedulerMinRtt")
+                            .SetParent<MpTcpScheduler>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSchedulerMinRtt>();
+    return tid;
+}
+
+MpTcpSchedulerMinRtt::MpTcpSchedulerMinRtt()
+    : MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerMinRtt::~MpTcpSchedulerMinRtt()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSchedulerMinRtt::SelectSubflow(Ptr<const MpTcpSocket> meta)
+{
+    NS_LOG_FUNCTION(this << meta);
+
+    Ptr<MpTcpSubflow> best;
+    for (uint32_t i = 0; i < meta->GetNSubflows(); i++)
+    {
+        Ptr<MpTcpSubflow> subflow = meta->GetSubflow(i);
+        if (subflow->HasSendSpace() &&
+            (!best || subflow->GetRttEstimate() < best->GetRttEstimate()))
+        {
+            best = subflow;
+        }
+    }
+    return best;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSchedulerRoundRobin);
+
+TypeId
+MpTcpSchedulerRoundRobin::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSchedulerRoundRobin")
+                            .SetParent<MpTcpScheduler>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSchedulerRoundRobin>();
+    return tid;
+}
+
+MpTcpSchedulerRoundRobin::MpTcpSchedulerRoundRobin()
+    : MpTcpScheduler()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSchedulerRoundRobin::~MpTcpSchedulerRoundRobin()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSchedulerRoundRobin::SelectSubflow(Ptr<const MpTcpSocket> meta)
+{
+    NS_LOG_FUNCTION(this << meta);
+
+    uint32_t n = meta->GetNSubflows();
+    for (uint32_t k = 0; k < n; k++)
+    {
+        uint32_t i = (m_next + k) % n;
+        Ptr<MpTcpSubflow> subflow = meta->GetSubflow(i);
+        if (subflow->HasSendSpace())
+        {
+            m_next = (i + 1) % n;
+            return subflow;
+        }
+    }
+    return nullptr;
+}
+
+} // namespace ns3
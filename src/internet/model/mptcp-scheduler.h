@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPTCP_SCHEDULER_H
+#define MPTCP_SCHEDULER_H
+
+#include "ns3/object.h"
+
+namespace ns3
+{
+
+class MpTcpSocket;
+class MpTcpSubflow;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The packet scheduler of a Multipath TCP connection
+ *
+ * The scheduler chooses the subflow on which the next chunk of data is
+ * sent, among the subflows that can take more data.
+ */
+class MpTcpScheduler : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpScheduler();
+    ~MpTcpScheduler() override;
+
+    /**
+     * \brief Choose the subflow on which to send the next chunk of data
+     * \param meta the Multipath TCP connection
+     * \return the subflow, or nullptr if no subflow can take more data
+     */
+    virtual Ptr<MpTcpSubflow> SelectSubflow(Ptr<const MpTcpSocket> meta) = 0;
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The default scheduler, which sends the data on the subflow with
+ *        the lowest smoothed RTT among those that can take more data
+ */
+class MpTcpSchedulerMinRtt : public MpTcpScheduler
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSchedulerMinRtt();
+    ~MpTcpSchedulerMinRtt() override;
+
+    Ptr<MpTcpSubflow> SelectSubflow(Ptr<const MpTcpSocket> meta) override;
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A scheduler sending the data on the subflows in turn, skipping
+ *        those that cannot take more data
+ */
+class MpTcpSchedulerRoundRobin : public MpTcpScheduler
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSchedulerRoundRobin();
+    ~MpTcpSchedulerRoundRobin() override;
+
+    Ptr<MpTcpSubflow> SelectSubflow(Ptr<const MpTcpSocket> meta) override;
+
+  private:
+    uint32_t m_next{0}; //!< Index of the next subflow to consider
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SCHEDULER_H */
@@ -0,0 +1,66 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef MPTCP_SOCKET_FACTORY_H
+#define MPTCP_SOCKET_FACTORY_H
+
+#include "ns3/ptr.h"
+#include "ns3/socket-factory.h"
+
+namespace ns3
+{
+
+class Socket;
+class TcpL4Protocol;
+
+/**
+ * \ingroup socket
+ * \ingroup tcp
+ *
+ * \brief Socket factory creating Multipath TCP sockets
+ *
+ * A factory is aggregated to each node along with the TCP L4 protocol, so
+ * that applications can open Multipath TCP connections by setting their
+ * "Protocol" attribute to "ns3::MpTcpSocketFactory".
+ */
+class MpTcpSocketFactory : public SocketFactory
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSocketFactory();
+    ~MpTcpSocketFactory() override;
+
+    /**
+     * \brief Set the associated TCP L4 protocol.
+     * \param tcp the TCP L4 protocol
+     */
+    void SetTcp(Ptr<TcpL4Protocol> tcp);
+
+    Ptr<Socket> CreateSocket() override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Ptr<TcpL4Protocol> m_tcp; //!< the associated TCP L4 protocol
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SOCKET_FACTORY_H */
@@ -0,0 +1,880 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-socket.h"
+
+#include "ipv4-routing-protocol.h"
+#include "ipv4.h"
+#include "mptcp-congestion-ops.h"
+#include "mptcp-scheduler.h"
+#include "mptcp-subflow.h"
+#include "rtt-estimator.h"
+#include "tcp-l4-protocol.h"
+#include "tcp-recovery-ops.h"
+
+#include "ns3/hash.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSocket");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSocket);
+
+TypeId
+MpTcpSocket::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::MpTcpSocket")
+            .SetParent<Socket>()
+            .SetGroupName("Internet")
+            .AddConstructor<MpTcpSocket>()
+            .AddAttribute("Scheduler",
+                          "The type of the packet scheduler",
+                          TypeIdValue(MpTcpSchedulerMinRtt::GetTypeId()),
+                          MakeTypeIdAccessor(&MpTcpSocket::m_schedulerTypeId),
+                          MakeTypeIdChecker())
+            .AddAttribute("CongestionControl",
+                          "The type of the congestion control of the subflows",
+                          TypeIdValue(TcpLia::GetTypeId()),
+                          MakeTypeIdAccessor(&MpTcpSocket::m_congestionTypeId),
+                          MakeTypeIdChecker())
+            .AddAttribute("SndBufSize",
+                          "Size of the send buffer of the connection, in bytes",
+                          UintegerValue(131072),
+                          MakeUintegerAccessor(&MpTcpSocket::m_sndBufSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("MaxSubflows",
+                          "Maximum number of subflows of a connection",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&MpTcpSocket::m_maxSubflows),
+                          MakeUintegerChecker<uint32_t>(1));
+    return tid;
+}
+
+MpTcpSocket::MpTcpSocket()
+    : m_sndBufSize(0),
+      m_maxSubflows(0),
+      m_errno(ERROR_NOTERROR),
+      m_bindAddress(Ipv4Address::GetAny(), 0),
+      m_peerPort(0),
+      m_shutdownSend(false),
+      m_shutdownRecv(false),
+      m_closeOnEmpty(false),
+      m_closeNotified(false),
+      m_fallback(false),
+      m_subflowError(false),
+      m_mpCapable(false),
+      m_localKey(0),
+      m_remoteKey(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_keyRng = CreateObject<UniformRandomVariable>();
+    m_txPending = Create<Packet>();
+    m_rxReady = Create<Packet>();
+}
+
+MpTcpSocket::~MpTcpSocket()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+MpTcpSocket::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& subflow : m_subflows)
+    {
+        Ptr<MpTcpCongestionOps> cong =
+            DynamicCast<MpTcpCongestionOps>(subflow->GetCongestionControl());
+        if (cong)
+        {
+            cong->SetMeta(nullptr);
+        }
+        subflow->SetMeta(nullptr);
+    }
+    if (m_listener)
+    {
+        m_listener->SetMeta(nullptr);
+        m_listener = nullptr;
+    }
+    m_subflows.clear();
+    m_closedSubflows.clear();
+    m_connections.clear();
+    m_scheduler = nullptr;
+    m_node = nullptr;
+    m_tcp = nullptr;
+    Socket::DoDispose();
+}
+
+void
+MpTcpSocket::SetNode(Ptr<Node> node)
+{
+    m_node = node;
+}
+
+void
+MpTcpSocket::SetTcp(Ptr<TcpL4Protocol> tcp)
+{
+    m_tcp = tcp;
+}
+
+int64_t
+MpTcpSocket::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_keyRng->SetStream(stream);
+    return 1;
+}
+
+uint64_t
+MpTcpSocket::GenerateKey()
+{
+    uint64_t high = m_keyRng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    uint64_t low = m_keyRng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    return (high << 32) | low;
+}
+
+uint32_t
+MpTcpSocket::KeyToToken(uint64_t key)
+{
+    return Hash32(reinterpret_cast<const char*>(&key), sizeof(key));
+}
+
+SequenceNumber32
+MpTcpSocket::KeyToIdsn(uint64_t key)
+{
+    return SequenceNumber32(
+        static_cast<uint32_t>(Hash64(reinterpret_cast<const char*>(&key), sizeof(key))));
+}
+
+uint32_t
+MpTcpSocket::GetNSubflows() const
+{
+    return m_subflows.size();
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::GetSubflow(uint32_t i) const
+{
+    NS_ASSERT(i < m_subflows.size());
+    return m_subflows[i];
+}
+
+bool
+MpTcpSocket::IsMpCapable() const
+{
+    return m_mpCapable;
+}
+
+SequenceNumber32
+MpTcpSocket::GetDataAck() const
+{
+    return m_nextRxDataSeq;
+}
+
+Ptr<MpTcpSubflow>
+MpTcpSocket::CreateSubflow()
+{
+    NS_LOG_FUNCTION(this);
+    NS_ASSERT_MSG(m_tcp, "MpTcpSocket not associated with a TCP L4 protocol");
+
+    TypeIdValue rttTypeId;
+    TypeIdValue recoveryTypeId;
+    m_tcp->GetAttribute("RttEstimatorType", rttTypeId);
+    m_tcp->GetAttribute("RecoveryType", recoveryTypeId);
+
+    ObjectFactory rttFactory;
+    ObjectFactory congestionAlgorithmFactory;
+    ObjectFactory recoveryAlgorithmFactory;
+    rttFactory.SetTypeId(rttTypeId.Get());
+    congestionAlgorithmFactory.SetTypeId(m_congestionTypeId);
+    recoveryAlgorithmFactory.SetTypeId(recoveryTypeId.Get());
+
+    Ptr<MpTcpSubflow> subflow = CreateObject<MpTcpSubflow>();
+    subflow->SetNode(m_node);
+    subflow->SetTcp(m_tcp);
+    subflow->SetRtt(rttFactory.Create<RttEstimator>());
+    subflow->SetCongestionControlAlgorithm(congestionAlgorithmFactory.Create<TcpCongestionOps>());
+    subflow->SetRecoveryAlgorithm(recoveryAlgorithmFactory.Create<TcpRecoveryOps>());
+    return subflow;
+}
+
+Ptr<MpTcpSocket>
+MpTcpSocket::ForkConnection()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<MpTcpSocket> connection = CreateObject<MpTcpSocket>();
+    connection->SetNode(m_node);
+    connection->SetTcp(m_tcp);
+    connection->m_schedulerTypeId = m_schedulerTypeId;
+    connection->m_congestionTypeId = m_congestionTypeId;
+    connection->m_sndBufSize = m_sndBufSize;
+    connection->m_maxSubflows = m_maxSubflows;
+    connection->m_bindAddress = m_bindAddress;
+    return connection;
+}
+
+void
+MpTcpSocket::AttachSubflow(Ptr<MpTcpSubflow> subflow)
+{
+    NS_LOG_FUNCTION(this << subflow);
+    subflow->SetMeta(this);
+    Ptr<MpTcpCongestionOps> cong = DynamicCast<MpTcpCongestionOps>(subflow->GetCongestionControl());
+    if (cong)
+    {
+        cong->SetMeta(this);
+    }
+    subflow->SetRecvCallback(MakeCallback(&MpTcpSocket::SubflowRecv, this));
+    subflow->SetSendCallback(MakeCallback(&MpTcpSocket::SubflowSend, this));
+    subflow->SetCloseCallbacks(MakeCallback(&MpTcpSocket::SubflowClosed, this),
+                               MakeCallback(&MpTcpSocket::SubflowError, this));
+    m_subflows.push_back(subflow);
+}
+
+void
+MpTcpSocket::SetKeys(uint64_t localKey, uint64_t remoteKey)
+{
+    NS_LOG_FUNCTION(this << localKey << remoteKey);
+    m_localKey = localKey;
+    m_remoteKey = remoteKey;
+    m_mpCapable = true;
+    m_nextTxDataSeq = KeyToIdsn(localKey);
+    m_dataAcked = m_nextTxDataSeq;
+    m_nextRxDataSeq = KeyToIdsn(remoteKey);
+}
+
+Socket::SocketErrno
+MpTcpSocket::GetErrno() const
+{
+    return m_errno;
+}
+
+Socket::SocketType
+MpTcpSocket::GetSocketType() const
+{
+    return NS3_SOCK_STREAM;
+}
+
+Ptr<Node>
+MpTcpSocket::GetNode() const
+{
+    return m_node;
+}
+
+int
+MpTcpSocket::Bind()
+{
+    NS_LOG_FUNCTION(this);
+    m_bindAddress = InetSocketAddress(Ipv4Address::GetAny(), 0);
+    return 0;
+}
+
+int
+MpTcpSocket::Bind6()
+{
+    NS_LOG_FUNCTION(this);
+    m_errno = ERROR_AFNOSUPPORT;
+    return -1;
+}
+
+int
+MpTcpSocket::Bind(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (!InetSocketAddress::IsMatchingType(address))
+    {
+        m_errno = ERROR_AFNOSUPPORT;
+        return -1;
+    }
+    m_bindAddress = InetSocketAddress::ConvertFrom(address);
+    return 0;
+}
+
+int
+MpTcpSocket::Connect(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (!InetSocketAddress::IsMatchingType(address))
+    {
+        m_errno = ERROR_AFNOSUPPORT;
+        return -1;
+    }
+    if (!m_subflows.empty() || m_listener)
+    {
+        m_errno = ERROR_ISCONN;
+        return -1;
+    }
+
+    InetSocketAddress peer = InetSocketAddress::ConvertFrom(address);
+    m_remoteAddresses.push_back(peer.GetIpv4());
+    m_peerPort = peer.GetPort();
+    m_localKey = GenerateKey();
+
+    Ptr<MpTcpSubflow> subflow = CreateSubflow();
+    subflow->SetLocalKey(m_localKey);
+    AttachSubflow(subflow);
+    subflow->SetConnectCallback(MakeCallback(&MpTcpSocket::SubflowConnected, this),
+                                MakeCallback(&MpTcpSocket::SubflowConnectionFailed, this));
+    if (subflow->Bind(m_bindAddress) == -1 || subflow->Connect(address) == -1)
+    {
+        m_errno = subflow->GetErrno();
+        return -1;
+    }
+    return 0;
+}
+
+int
+MpTcpSocket::Listen()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_subflows.empty() || m_listener)
+    {
+        m_errno = ERROR_INVAL;
+        return -1;
+    }
+
+    m_listener = CreateSubflow();
+    m_listener->SetMeta(this);
+    m_listener->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                                  MakeCallback(&MpTcpSocket::SubflowAccepted, this));
+    if (m_listener->Bind(m_bindAddress) == -1 || m_listener->Listen() == -1)
+    {
+        m_errno = m_listener->GetErrno();
+        return -1;
+    }
+    return 0;
+}
+
+int
+MpTcpSocket::Close()
+{
+    NS_LOG_FUNCTION(this);
+    m_shutdownSend = true;
+    if (m_listener)
+    {
+        m_listener->Close();
+    }
+    if (m_fallback)
+    {
+        return m_subflows.front()->Close();
+    }
+    m_closeOnEmpty = true;
+    Push();
+    return 0;
+}
+
+int
+MpTcpSocket::ShutdownSend()
+{
+    NS_LOG_FUNCTION(this);
+    m_shutdownSend = true;
+    if (m_fallback)
+    {
+        return m_subflows.front()->ShutdownSend();
+    }
+    if (!m_subflows.empty())
+    {
+        m_closeOnEmpty = true;
+        Push();
+    }
+    return 0;
+}
+
+int
+MpTcpSocket::ShutdownRecv()
+{
+    NS_LOG_FUNCTION(this);
+    m_shutdownRecv = true;
+    return 0;
+}
+
+uint32_t
+MpTcpSocket::GetTxAvailable() const
+{
+    if (m_fallback)
+    {
+        return m_subflows.front()->GetTxAvailable();
+    }
+    uint32_t used = (m_nextTxDataSeq - m_dataAcked) + m_txPending->GetSize();
+    return m_sndBufSize > used ? m_sndBufSize - used : 0;
+}
+
+int
+MpTcpSocket::Send(Ptr<Packet> p, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << p << flags);
+    if (m_shutdownSend)
+    {
+        m_errno = ERROR_SHUTDOWN;
+        return -1;
+    }
+    if (m_fallback)
+    {
+        return m_subflows.front()->Send(p, flags);
+    }
+    if (m_subflows.empty())
+    {
+        m_errno = ERROR_NOTCONN;
+        return -1;
+    }
+    if (p->GetSize() > GetTxAvailable())
+    {
+        m_errno = ERROR_MSGSIZE;
+        return -1;
+    }
+    m_txPending->AddAtEnd(p);
+    Push();
+    return p->GetSize();
+}
+
+int
+MpTcpSocket::SendTo(Ptr<Packet> p, uint32_t flags, const Address& /* toAddress */)
+{
+    return Send(p, flags);
+}
+
+void
+MpTcpSocket::Push()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_mpCapable)
+    {
+        return;
+    }
+    if (!m_scheduler)
+    {
+        ObjectFactory schedulerFactory;
+        schedulerFactory.SetTypeId(m_schedulerTypeId);
+        m_scheduler = schedulerFactory.Create<MpTcpScheduler>();
+    }
+
+    while (m_txPending->GetSize() > 0)
+    {
+        Ptr<MpTcpSubflow> subflow = m_scheduler->SelectSubflow(this);
+        if (!subflow)
+        {
+            break;
+        }
+        uint32_t size = std::min(m_txPending->GetSize(), subflow->GetTcb()->m_segmentSize);
+        if (subflow->SendMapped(m_txPending->CreateFragment(0, size), m_nextTxDataSeq) == -1)
+        {
+            break;
+        }
+        NS_LOG_LOGIC("Mapped data sequence " << m_nextTxDataSeq << " (" << size
+                                             << " bytes) to subflow " << subflow);
+        m_txPending->RemoveAtStart(size);
+        m_nextTxDataSeq += size;
+    }
+
+    if (m_closeOnEmpty && m_txPending->GetSize() == 0)
+    {
+        m_closeOnEmpty = false;
+        CloseSubflows();
+    }
+}
+
+void
+MpTcpSocket::CloseSubflows()
+{
+    NS_LOG_FUNCTION(this);
+    for (const auto& subflow : m_subflows)
+    {
+        if (subflow->GetState() != TcpSocket::CLOSED)
+        {
+            subflow->Close();
+        }
+    }
+}
+
+void
+MpTcpSocket::ReceivedDataAck(SequenceNumber32 dataAck)
+{
+    NS_LOG_FUNCTION(this << dataAck);
+    if (!m_mpCapable || dataAck <= m_dataAcked || dataAck > m_nextTxDataSeq)
+    {
+        return;
+    }
+    m_dataAcked = dataAck;
+    if (!m_shutdownSend && GetTxAvailable() > 0)
+    {
+        NotifySend(GetTxAvailable());
+    }
+}
+
+void
+MpTcpSocket::AddRemoteAddress(Ipv4Address address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (std::find(m_remoteAddresses.begin(), m_remoteAddresses.end(), address) ==
+        m_remoteAddresses.end())
+    {
+        m_remoteAddresses.push_back(address);
+        OpenSubflows();
+    }
+}
+
+void
+MpTcpSocket::OpenSubflows()
+{
+    NS_LOG_FUNCTION(this);
+    // Only the end which opened the connection opens the additional subflows
+    if (!m_mpCapable || m_peerPort == 0 || m_shutdownSend)
+    {
+        return;
+    }
+
+    Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+    for (const auto& remote : m_remoteAddresses)
+    {
+        for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+        {
+            if (!ipv4->IsUp(i))
+            {
+                continue;
+            }
+            for (uint32_t j = 0; j < ipv4->GetNAddresses(i); j++)
+            {
+                Ipv4Address local = ipv4->GetAddress(i, j).GetLocal();
+                if (local == Ipv4Address::GetLoopback() ||
+                    m_paths.count({local.Get(), remote.Get()}) > 0)
+                {
+                    continue;
+                }
+                if (m_subflows.size() >= m_maxSubflows)
+                {
+                    return;
+                }
+
+                // Use the pair only if the peer can be reached from this interface
+                Ipv4Header header;
+                header.SetSource(local);
+                header.SetDestination(remote);
+                Socket::SocketErrno err;
+                Ptr<Ipv4Route> route = ipv4->GetRoutingProtocol()->RouteOutput(Create<Packet>(),
+                                                                              header,
+                                                                              ipv4->GetNetDevice(i),
+                                                                              err);
+                if (!route)
+                {
+                    continue;
+                }
+
+                NS_LOG_INFO("Opening a subflow from " << local << " to " << remote);
+                m_paths.insert({local.Get(), remote.Get()});
+                Ptr<MpTcpSubflow> subflow = CreateSubflow();
+                subflow->SetJoin(KeyToToken(m_remoteKey), static_cast<uint8_t>(i));
+                AttachSubflow(subflow);
+                subflow->SetConnectCallback(
+                    MakeCallback(&MpTcpSocket::SubflowConnected, this),
+                    MakeCallback(&MpTcpSocket::SubflowConnectionFailed, this));
+                subflow->Bind(InetSocketAddress(local, 0));
+                subflow->BindToNetDevice(ipv4->GetNetDevice(i));
+                subflow->Connect(InetSocketAddress(remote, m_peerPort));
+            }
+        }
+    }
+}
+
+void
+MpTcpSocket::SubflowConnected(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<MpTcpSubflow> subflow = DynamicCast<MpTcpSubflow>(socket);
+
+    if (subflow != m_subflows.front())
+    {
+        if (!subflow->IsMpCapable())
+        {
+            NS_LOG_WARN("The peer refused the subflow " << subflow);
+            subflow->Close();
+            return;
+        }
+        Push();
+        return;
+    }
+
+    Address local;
+    Address remote;
+    subflow->GetSockName(local);
+    subflow->GetPeerName(remote);
+    m_paths.insert({InetSocketAddress::ConvertFrom(local).GetIpv4().Get(),
+                    InetSocketAddress::ConvertFrom(remote).GetIpv4().Get()});
+
+    if (subflow->IsMpCapable())
+    {
+        SetKeys(m_localKey, subflow->GetRemoteKey());
+    }
+    else
+    {
+        NS_LOG_INFO("The peer does not support Multipath TCP, falling back to TCP");
+        m_fallback = true;
+        if (m_txPending->GetSize() > 0)
+        {
+            subflow->Send(m_txPending, 0);
+            m_txPending = Create<Packet>();
+        }
+        if (m_closeOnEmpty)
+        {
+            subflow->Close();
+        }
+    }
+
+    NotifyConnectionSucceeded();
+    OpenSubflows();
+    Push();
+    if (GetTxAvailable() > 0)
+    {
+        NotifySend(GetTxAvailable());
+    }
+}
+
+void
+MpTcpSocket::SubflowConnectionFailed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    if (socket == m_subflows.front())
+    {
+        NotifyConnectionFailed();
+    }
+}
+
+void
+MpTcpSocket::SubflowAccepted(Ptr<Socket> socket, const Address& from)
+{
+    NS_LOG_FUNCTION(this << socket << from);
+    Ptr<MpTcpSubflow> subflow = DynamicCast<MpTcpSubflow>(socket);
+
+    if (subflow->IsJoin())
+    {
+        auto it = m_connections.find(subflow->GetJoinToken());
+        if (it == m_connections.end() || it->second->m_closeNotified)
+        {
+            NS_LOG_WARN("No connection with token " << subflow->GetJoinToken());
+            subflow->Close();
+            return;
+        }
+        NS_LOG_INFO("Subflow from " << from << " joins connection " << it->second);
+        it->second->AttachSubflow(subflow);
+        it->second->Push();
+        return;
+    }
+
+    Ptr<MpTcpSocket> connection = ForkConnection();
+    connection->AttachSubflow(subflow);
+    if (subflow->IsMpCapable())
+    {
+        connection->SetKeys(subflow->GetLocalKey(), subflow->GetRemoteKey());
+        m_connections[KeyToToken(subflow->GetLocalKey())] = connection;
+
+        // Advertise the other addresses of the node
+        Address local;
+        subflow->GetSockName(local);
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+        uint8_t addressId = 1;
+        for (uint32_t i = 0; i < ipv4->GetNInterfaces(); i++)
+        {
+            for (uint32_t j = 0; j < ipv4->GetNAddresses(i); j++)
+            {
+                Ipv4Address address = ipv4->GetAddress(i, j).GetLocal();
+                if (ipv4->IsUp(i) && address != Ipv4Address::GetLoopback() &&
+                    address != InetSocketAddress::ConvertFrom(local).GetIpv4())
+                {
+                    subflow->AdvertiseAddress(addressId++, address);
+                }
+            }
+        }
+    }
+    else
+    {
+        NS_LOG_INFO("The peer does not support Multipath TCP, falling back to TCP");
+        connection->m_fallback = true;
+    }
+    NotifyNewConnectionCreated(connection, from);
+}
+
+void
+MpTcpSocket::SubflowRecv(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    if (m_fallback)
+    {
+        NotifyDataRecv();
+        return;
+    }
+
+    Ptr<MpTcpSubflow> subflow = DynamicCast<MpTcpSubflow>(socket);
+    for (const auto& fragment : subflow->RecvMapped())
+    {
+        if (fragment.first + fragment.second->GetSize() > m_nextRxDataSeq)
+        {
+            m_rxOutOfOrder.insert(fragment);
+        }
+    }
+
+    bool delivered = false;
+    while (!m_rxOutOfOrder.empty() && m_rxOutOfOrder.begin()->first <= m_nextRxDataSeq)
+    {
+        SequenceNumber32 seq = m_rxOutOfOrder.begin()->first;
+        Ptr<Packet> p = m_rxOutOfOrder.begin()->second;
+        m_rxOutOfOrder.erase(m_rxOutOfOrder.begin());
+
+        uint32_t skip = m_nextRxDataSeq - seq;
+        if (skip < p->GetSize())
+        {
+            m_rxReady->AddAtEnd(p->CreateFragment(skip, p->GetSize() - skip));
+            m_nextRxDataSeq += p->GetSize() - skip;
+            delivered = true;
+        }
+    }
+
+    if (delivered && !m_shutdownRecv)
+    {
+        NotifyDataRecv();
+    }
+}
+
+void
+MpTcpSocket::SubflowSend(Ptr<Socket> socket, uint32_t available)
+{
+    NS_LOG_FUNCTION(this << socket << available);
+    if (m_fallback)
+    {
+        NotifySend(available);
+        return;
+    }
+    Push();
+}
+
+void
+MpTcpSocket::SubflowClosed(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    m_closedSubflows.insert(socket);
+    if (m_closedSubflows.size() == m_subflows.size() && !m_closeNotified)
+    {
+        m_closeNotified = true;
+        if (m_subflowError)
+        {
+            NotifyErrorClose();
+        }
+        else
+        {
+            NotifyNormalClose();
+        }
+    }
+}
+
+void
+MpTcpSocket::SubflowError(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    NS_LOG_WARN("Subflow " << socket << " closed on error");
+    if (socket == m_subflows.front())
+    {
+        m_subflowError = true;
+    }
+    SubflowClosed(socket);
+}
+
+uint32_t
+MpTcpSocket::GetRxAvailable() const
+{
+    if (m_fallback)
+    {
+        return m_subflows.front()->GetRxAvailable();
+    }
+    return m_rxReady->GetSize();
+}
+
+Ptr<Packet>
+MpTcpSocket::Recv(uint32_t maxSize, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << maxSize << flags);
+    if (m_fallback)
+    {
+        return m_subflows.front()->Recv(maxSize, flags);
+    }
+    if (m_rxReady->GetSize() == 0)
+    {
+        return nullptr;
+    }
+    uint32_t size = std::min(maxSize, m_rxReady->GetSize());
+    Ptr<Packet> p = m_rxReady->CreateFragment(0, size);
+    m_rxReady->RemoveAtStart(size);
+    return p;
+}
+
+Ptr<Packet>
+MpTcpSocket::RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress)
+{
+    NS_LOG_FUNCTION(this << maxSize << flags);
+    Ptr<Packet> p = Recv(maxSize, flags);
+    if (p && p->GetSize() > 0)
+    {
+        GetPeerName(fromAddress);
+    }
+    return p;
+}
+
+int
+MpTcpSocket::GetSockName(Address& address) const
+{
+    if (!m_subflows.empty())
+    {
+        return m_subflows.front()->GetSockName(address);
+    }
+    if (m_listener)
+    {
+        return m_listener->GetSockName(address);
+    }
+    address = m_bindAddress;
+    return 0;
+}
+
+int
+MpTcpSocket::GetPeerName(Address& address) const
+{
+    if (m_subflows.empty())
+    {
+        m_errno = ERROR_NOTCONN;
+        return -1;
+    }
+    return m_subflows.front()->GetPeerName(address);
+}
+
+bool
+MpTcpSocket::SetAllowBroadcast(bool allowBroadcast)
+{
+    // Broadcast is not implemented. Return true only if allowBroadcast==false
+    return (!allowBroadcast);
+}
+
+bool
+MpTcpSocket::GetAllowBroadcast() const
+{
+    return false;
+}
+
+} // namespace ns3
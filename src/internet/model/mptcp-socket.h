@@ -0,0 +1,316 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPTCP_SOCKET_H
+#define MPTCP_SOCKET_H
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/ipv4-address.h"
+#include "ns3/sequence-number.h"
+#include "ns3/socket.h"
+#include "ns3/type-id.h"
+
+#include <map>
+#include <set>
+#include <vector>
+
+namespace ns3
+{
+
+class MpTcpScheduler;
+class MpTcpSubflow;
+class Node;
+class Packet;
+class TcpL4Protocol;
+class UniformRandomVariable;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A Multipath TCP socket, \RFC{8684}
+ *
+ * A Multipath TCP connection spreads the data of the application over
+ * several TCP subflows (MpTcpSubflow), possibly using different paths
+ * between the two hosts. The data is numbered in a data sequence space,
+ * common to all the subflows, which is used to reorder the data received
+ * on the different subflows and to acknowledge it at the connection level.
+ *
+ * The first subflow is opened towards the address passed to Connect() and
+ * negotiates the use of Multipath TCP through the MP_CAPABLE option. Once
+ * it is established, the client opens an additional subflow (MP_JOIN) from
+ * each of its IPv4 addresses towards each of the addresses of the server,
+ * i.e., the one the first subflow connected to and the ones advertised by
+ * the server with ADD_ADDR, as long as a route exists from that address to
+ * the server. Each additional subflow is bound to the address and to the
+ * device of its local interface.
+ *
+ * The data sent by the application is split into chunks of one segment,
+ * each of which is handed over to the subflow chosen by the packet
+ * scheduler (MpTcpScheduler) among the subflows whose congestion window
+ * is not full. The congestion control of the subflows is typically a
+ * coupled congestion control (MpTcpCongestionOps).
+ *
+ * This model does not reinject data at the connection level: the data
+ * handed over to a subflow is only retransmitted on that subflow. Only
+ * IPv4 is supported. If the peer does not support Multipath TCP, the
+ * socket falls back to a regular TCP connection.
+ */
+class MpTcpSocket : public Socket
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSocket();
+    ~MpTcpSocket() override;
+
+    /**
+     * \brief Set the associated node
+     * \param node the node
+     */
+    void SetNode(Ptr<Node> node);
+
+    /**
+     * \brief Set the associated TCP L4 protocol
+     * \param tcp the TCP L4 protocol
+     */
+    void SetTcp(Ptr<TcpL4Protocol> tcp);
+
+    /**
+     * \brief Get the number of subflows of the connection
+     * \return the number of subflows
+     */
+    uint32_t GetNSubflows() const;
+
+    /**
+     * \brief Get a subflow of the connection
+     * \param i the index of the subflow
+     * \return the subflow
+     */
+    Ptr<MpTcpSubflow> GetSubflow(uint32_t i) const;
+
+    /**
+     * \brief Check whether the connection uses Multipath TCP
+     * \return true if the keys have been exchanged with the peer
+     */
+    bool IsMpCapable() const;
+
+    /**
+     * \brief Get the data-level acknowledgment to send to the peer
+     * \return the data sequence number of the next byte expected
+     */
+    SequenceNumber32 GetDataAck() const;
+
+    /**
+     * \brief Process a data-level acknowledgment received on a subflow
+     * \param dataAck the data sequence number of the next byte expected by the peer
+     */
+    void ReceivedDataAck(SequenceNumber32 dataAck);
+
+    /**
+     * \brief Add an address advertised by the peer
+     * \param address the address
+     */
+    void AddRemoteAddress(Ipv4Address address);
+
+    /**
+     * \brief Generate a key for a new connection
+     * \return the key
+     */
+    uint64_t GenerateKey();
+
+    /**
+     * \brief Derive the token of a connection from its key
+     * \param key the key
+     * \return the token identifying the connection
+     */
+    static uint32_t KeyToToken(uint64_t key);
+
+    /**
+     * \brief Derive the initial data sequence number from a key
+     * \param key the key
+     * \return the data sequence number of the first byte sent
+     */
+    static SequenceNumber32 KeyToIdsn(uint64_t key);
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    // Documented in base class
+    Socket::SocketErrno GetErrno() const override;
+    Socket::SocketType GetSocketType() const override;
+    Ptr<Node> GetNode() const override;
+    int Bind() override;
+    int Bind6() override;
+    int Bind(const Address& address) override;
+    int Close() override;
+    int ShutdownSend() override;
+    int ShutdownRecv() override;
+    int Connect(const Address& address) override;
+    int Listen() override;
+    uint32_t GetTxAvailable() const override;
+    int Send(Ptr<Packet> p, uint32_t flags) override;
+    int SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress) override;
+    uint32_t GetRxAvailable() const override;
+    Ptr<Packet> Recv(uint32_t maxSize, uint32_t flags) override;
+    Ptr<Packet> RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress) override;
+    int GetSockName(Address& address) const override;
+    int GetPeerName(Address& address) const override;
+    bool SetAllowBroadcast(bool allowBroadcast) override;
+    bool GetAllowBroadcast() const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Create a subflow with the attributes of the TCP L4 protocol
+     * \return the subflow
+     */
+    Ptr<MpTcpSubflow> CreateSubflow();
+
+    /**
+     * \brief Create a connection inheriting the configuration of this
+     *        listening socket
+     * \return the connection
+     */
+    Ptr<MpTcpSocket> ForkConnection();
+
+    /**
+     * \brief Add a subflow to the connection
+     * \param subflow the subflow
+     */
+    void AttachSubflow(Ptr<MpTcpSubflow> subflow);
+
+    /**
+     * \brief Initialize the data sequence spaces from the keys of the two ends
+     * \param localKey the local key
+     * \param remoteKey the remote key
+     */
+    void SetKeys(uint64_t localKey, uint64_t remoteKey);
+
+    /**
+     * \brief Open the subflows not opened yet towards the addresses of the peer
+     */
+    void OpenSubflows();
+
+    /**
+     * \brief Hand over the pending data to the subflows chosen by the scheduler
+     */
+    void Push();
+
+    /**
+     * \brief Close all the subflows
+     */
+    void CloseSubflows();
+
+    /**
+     * \brief Callback invoked when a subflow opened by this socket is established
+     * \param socket the subflow
+     */
+    void SubflowConnected(Ptr<Socket> socket);
+
+    /**
+     * \brief Callback invoked when a subflow opened by this socket fails
+     * \param socket the subflow
+     */
+    void SubflowConnectionFailed(Ptr<Socket> socket);
+
+    /**
+     * \brief Callback invoked when a listening subflow accepts a subflow
+     * \param socket the subflow
+     * \param from the address of the peer
+     */
+    void SubflowAccepted(Ptr<Socket> socket, const Address& from);
+
+    /**
+     * \brief Callback invoked when a subflow received data
+     * \param socket the subflow
+     */
+    void SubflowRecv(Ptr<Socket> socket);
+
+    /**
+     * \brief Callback invoked when a subflow can take more data
+     * \param socket the subflow
+     * \param available the space available in the buffer of the subflow
+     */
+    void SubflowSend(Ptr<Socket> socket, uint32_t available);
+
+    /**
+     * \brief Callback invoked when a subflow is closed
+     * \param socket the subflow
+     */
+    void SubflowClosed(Ptr<Socket> socket);
+
+    /**
+     * \brief Callback invoked when a subflow is closed on error
+     * \param socket the subflow
+     */
+    void SubflowError(Ptr<Socket> socket);
+
+    // Configuration
+    Ptr<Node> m_node;                    //!< The associated node
+    Ptr<TcpL4Protocol> m_tcp;            //!< The associated TCP L4 protocol
+    TypeId m_schedulerTypeId;            //!< The type of the packet scheduler
+    TypeId m_congestionTypeId;           //!< The type of the congestion control of the subflows
+    uint32_t m_sndBufSize;               //!< Size of the send buffer of the connection
+    uint32_t m_maxSubflows;              //!< Maximum number of subflows
+    Ptr<MpTcpScheduler> m_scheduler;     //!< The packet scheduler
+    Ptr<UniformRandomVariable> m_keyRng; //!< Random variable generating the keys
+    mutable Socket::SocketErrno m_errno; //!< The error code
+    InetSocketAddress m_bindAddress;     //!< The address the socket is bound to
+    uint16_t m_peerPort;                 //!< The port of the peer (0 on the passive side)
+    bool m_shutdownSend;                 //!< Whether sending is disallowed
+    bool m_shutdownRecv;                 //!< Whether receiving is disallowed
+    bool m_closeOnEmpty;                 //!< Close the subflows once the data is handed over
+    bool m_closeNotified;                //!< Whether the close was notified
+    bool m_fallback;                     //!< Whether the connection fell back to regular TCP
+    bool m_subflowError;                 //!< Whether a subflow was closed on error
+
+    // Subflows
+    Ptr<MpTcpSubflow> m_listener;                       //!< The listening subflow
+    std::vector<Ptr<MpTcpSubflow>> m_subflows;          //!< The subflows of the connection
+    std::set<Ptr<Socket>> m_closedSubflows;             //!< The subflows closed
+    std::set<std::pair<uint32_t, uint32_t>> m_paths;    //!< The (local, remote) address pairs used
+    std::vector<Ipv4Address> m_remoteAddresses;         //!< The addresses of the peer
+    std::map<uint32_t, Ptr<MpTcpSocket>> m_connections; //!< Connections accepted, by token
+
+    // Data sequence space
+    bool m_mpCapable;                 //!< Whether Multipath TCP is used
+    uint64_t m_localKey;              //!< The local key
+    uint64_t m_remoteKey;             //!< The remote key
+    SequenceNumber32 m_nextTxDataSeq; //!< Data sequence number of the next byte to send
+    SequenceNumber32 m_dataAcked;     //!< Highest data-level acknowledgment received
+    SequenceNumber32 m_nextRxDataSeq; //!< Data sequence number of the next byte expected
+
+    // Buffers
+    Ptr<Packet> m_txPending;                                //!< Data not handed over yet
+    Ptr<Packet> m_rxReady;                                  //!< In-order data not read yet
+    std::map<SequenceNumber32, Ptr<Packet>> m_rxOutOfOrder; //!< Data received out of order
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SOCKET_H */
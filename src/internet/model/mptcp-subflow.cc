@@ -0,0 +1,444 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "mptcp-subflow.h"
+
+#include "mptcp-socket.h"
+#include "rtt-estimator.h"
+#include "tcp-congestion-ops.h"
+#include "tcp-option-mptcp.h"
+#include "tcp-rx-buffer.h"
+#include "tcp-tx-buffer.h"
+
+#include "ns3/log.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("MpTcpSubflow");
+
+NS_OBJECT_ENSURE_REGISTERED(MpTcpSubflow);
+
+TypeId
+MpTcpSubflow::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::MpTcpSubflow")
+                            .SetParent<TcpSocketBase>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<MpTcpSubflow>();
+    return tid;
+}
+
+MpTcpSubflow::MpTcpSubflow()
+    : TcpSocketBase()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSubflow::MpTcpSubflow(const MpTcpSubflow& sock)
+    : TcpSocketBase(sock),
+      m_meta(sock.m_meta),
+      m_localKey(sock.m_localKey),
+      m_remoteKey(sock.m_remoteKey),
+      m_mpCapable(sock.m_mpCapable),
+      m_join(sock.m_join),
+      m_joinToken(sock.m_joinToken),
+      m_joinAddressId(sock.m_joinAddressId)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+MpTcpSubflow::~MpTcpSubflow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<TcpSocketBase>
+MpTcpSubflow::Fork()
+{
+    return CopyObject<MpTcpSubflow>(this);
+}
+
+void
+MpTcpSubflow::SetMeta(Ptr<MpTcpSocket> meta)
+{
+    NS_LOG_FUNCTION(this << meta);
+    m_meta = meta;
+}
+
+Ptr<MpTcpSocket>
+MpTcpSubflow::GetMeta() const
+{
+    return m_meta;
+}
+
+void
+MpTcpSubflow::SetLocalKey(uint64_t key)
+{
+    NS_LOG_FUNCTION(this << key);
+    m_localKey = key;
+}
+
+uint64_t
+MpTcpSubflow::GetLocalKey() const
+{
+    return m_localKey;
+}
+
+uint64_t
+MpTcpSubflow::GetRemoteKey() const
+{
+    return m_remoteKey;
+}
+
+bool
+MpTcpSubflow::IsMpCapable() const
+{
+    return m_mpCapable;
+}
+
+void
+MpTcpSubflow::SetJoin(uint32_t token, uint8_t addressId)
+{
+    NS_LOG_FUNCTION(this << token << static_cast<uint32_t>(addressId));
+    m_join = true;
+    m_joinToken = token;
+    m_joinAddressId = addressId;
+}
+
+bool
+MpTcpSubflow::IsJoin() const
+{
+    return m_join;
+}
+
+uint32_t
+MpTcpSubflow::GetJoinToken() const
+{
+    return m_joinToken;
+}
+
+TcpSocket::TcpStates_t
+MpTcpSubflow::GetState() const
+{
+    return m_state.Get();
+}
+
+Ptr<TcpSocketState>
+MpTcpSubflow::GetTcb() const
+{
+    return m_tcb;
+}
+
+Ptr<TcpCongestionOps>
+MpTcpSubflow::GetCongestionControl() const
+{
+    return m_congestionControl;
+}
+
+Time
+MpTcpSubflow::GetRttEstimate() const
+{
+    return m_rtt->GetEstimate();
+}
+
+bool
+MpTcpSubflow::HasSendSpace() const
+{
+    if ((m_state != ESTABLISHED && m_state != CLOSE_WAIT) || m_closeOnEmpty || m_shutdownSend)
+    {
+        return false;
+    }
+    uint32_t unsent = m_txBuffer->SizeFromSequence(m_tcb->m_nextTxSequence);
+    return AvailableWindow() > unsent && m_txBuffer->Available() >= m_tcb->m_segmentSize;
+}
+
+MpTcpSubflow::MappingMap::const_iterator
+MpTcpSubflow::FindMapping(const MappingMap& mappings, SequenceNumber32 seq)
+{
+    auto it = mappings.upper_bound(seq);
+    if (it == mappings.begin())
+    {
+        return mappings.end();
+    }
+    --it;
+    if (seq < it->first + it->second.length)
+    {
+        return it;
+    }
+    return mappings.end();
+}
+
+int
+MpTcpSubflow::SendMapped(Ptr<Packet> p, SequenceNumber32 dataSeq)
+{
+    NS_LOG_FUNCTION(this << p << dataSeq);
+    NS_ASSERT(p->GetSize() <= std::numeric_limits<uint16_t>::max());
+
+    // Forget the mappings of the data acknowledged
+    while (!m_txMappings.empty() &&
+           m_txMappings.begin()->first + m_txMappings.begin()->second.length <=
+               m_txBuffer->HeadSequence())
+    {
+        m_txMappings.erase(m_txMappings.begin());
+    }
+
+    SequenceNumber32 seq = m_txBuffer->TailSequence();
+    int sent = Send(p, 0);
+    if (sent > 0 && m_mpCapable)
+    {
+        m_txMappings[seq] = {dataSeq, static_cast<uint16_t>(sent)};
+    }
+    return sent;
+}
+
+std::vector<std::pair<SequenceNumber32, Ptr<Packet>>>
+MpTcpSubflow::RecvMapped()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<std::pair<SequenceNumber32, Ptr<Packet>>> fragments;
+
+    while (GetRxAvailable() > 0)
+    {
+        Ptr<Packet> p = Recv(std::numeric_limits<uint32_t>::max(), 0);
+        uint32_t offset = 0;
+        while (offset < p->GetSize())
+        {
+            auto it = FindMapping(m_rxMappings, m_rxHeadSeq);
+            if (it == m_rxMappings.end())
+            {
+                NS_LOG_WARN("No mapping for subflow sequence " << m_rxHeadSeq << ", discarding "
+                                                               << p->GetSize() - offset
+                                                               << " bytes");
+                m_rxHeadSeq += p->GetSize() - offset;
+                break;
+            }
+            uint32_t length = std::min<uint32_t>(p->GetSize() - offset,
+                                                 it->first + it->second.length - m_rxHeadSeq);
+            fragments.emplace_back(it->second.dataSeq + (m_rxHeadSeq - it->first),
+                                   p->CreateFragment(offset, length));
+            offset += length;
+            m_rxHeadSeq += length;
+        }
+
+        // Forget the mappings of the data extracted
+        while (!m_rxMappings.empty() &&
+               m_rxMappings.begin()->first + m_rxMappings.begin()->second.length <= m_rxHeadSeq)
+        {
+            m_rxMappings.erase(m_rxMappings.begin());
+        }
+    }
+    return fragments;
+}
+
+void
+MpTcpSubflow::AdvertiseAddress(uint8_t addressId, Ipv4Address address)
+{
+    NS_LOG_FUNCTION(this << static_cast<uint32_t>(addressId) << address);
+    m_addrToAdvertise.emplace_back(addressId, address);
+}
+
+void
+MpTcpSubflow::AddOptions(TcpHeader& tcpHeader)
+{
+    NS_LOG_FUNCTION(this << tcpHeader);
+    TcpSocketBase::AddOptions(tcpHeader);
+
+    uint8_t flags = tcpHeader.GetFlags();
+    if (flags & TcpHeader::RST)
+    {
+        return;
+    }
+
+    if (flags & TcpHeader::SYN)
+    {
+        // A SYN+ACK only confirms the option carried by the SYN
+        if ((flags & TcpHeader::ACK) && !m_mpCapable)
+        {
+            return;
+        }
+        if (m_join)
+        {
+            Ptr<TcpOptionMpTcpJoin> option = CreateObject<TcpOptionMpTcpJoin>();
+            option->SetToken(m_joinToken);
+            option->SetAddressId(m_joinAddressId);
+            tcpHeader.AppendOption(option);
+        }
+        else
+        {
+            Ptr<TcpOptionMpTcpCapable> option = CreateObject<TcpOptionMpTcpCapable>();
+            option->SetSenderKey(m_localKey);
+            tcpHeader.AppendOption(option);
+        }
+        return;
+    }
+
+    if (!m_mpCapable)
+    {
+        return;
+    }
+
+    Ptr<TcpOptionMpTcpDss> dss = CreateObject<TcpOptionMpTcpDss>();
+    if (m_meta && m_meta->IsMpCapable())
+    {
+        dss->SetDataAck(m_meta->GetDataAck());
+    }
+    auto it = FindMapping(m_txMappings, tcpHeader.GetSequenceNumber());
+    if (it != m_txMappings.end())
+    {
+        dss->SetMapping(it->second.dataSeq, it->first, it->second.length);
+    }
+    if (dss->HasDataAck() || dss->HasMapping())
+    {
+        tcpHeader.AppendOption(dss);
+    }
+
+    while (!m_addrToAdvertise.empty())
+    {
+        Ptr<TcpOptionMpTcpAddAddr> option = CreateObject<TcpOptionMpTcpAddAddr>();
+        option->SetAddress(m_addrToAdvertise.front().first, m_addrToAdvertise.front().second);
+        if (!tcpHeader.AppendOption(option))
+        {
+            break;
+        }
+        m_addrToAdvertise.pop_front();
+    }
+}
+
+void
+MpTcpSubflow::ReadSynOptions(const TcpHeader& tcpHeader)
+{
+    NS_LOG_FUNCTION(this << tcpHeader);
+
+    for (const auto& option : tcpHeader.GetOptionList())
+    {
+        if (option->GetKind() != TcpOption::MPTCP)
+        {
+            continue;
+        }
+        Ptr<const TcpOptionMpTcp> mptcp = DynamicCast<const TcpOptionMpTcp>(option);
+        if (mptcp->GetSubType() == TcpOptionMpTcp::MP_CAPABLE && !m_join)
+        {
+            m_remoteKey = DynamicCast<const TcpOptionMpTcpCapable>(mptcp)->GetSenderKey();
+            m_mpCapable = true;
+        }
+        else if (mptcp->GetSubType() == TcpOptionMpTcp::MP_JOIN)
+        {
+            if (tcpHeader.GetFlags() & TcpHeader::ACK)
+            {
+                // The peer confirms the subflow we asked to join
+                m_mpCapable = m_join;
+            }
+            else
+            {
+                Ptr<const TcpOptionMpTcpJoin> join = DynamicCast<const TcpOptionMpTcpJoin>(mptcp);
+                m_join = true;
+                m_joinToken = join->GetToken();
+                m_mpCapable = true;
+            }
+        }
+    }
+    m_rxHeadSeq = tcpHeader.GetSequenceNumber() + SequenceNumber32(1);
+    NS_LOG_INFO("Multipath TCP " << (m_mpCapable ? "enabled" : "disabled")
+                                 << (m_join ? " on a joining subflow" : ""));
+}
+
+void
+MpTcpSubflow::CompleteFork(Ptr<Packet> p,
+                           const TcpHeader& tcpHeader,
+                           const Address& fromAddress,
+                           const Address& toAddress)
+{
+    NS_LOG_FUNCTION(this << p << tcpHeader << fromAddress << toAddress);
+
+    // The clone inherits the state of the listening subflow
+    m_mpCapable = false;
+    m_join = false;
+    ReadSynOptions(tcpHeader);
+    if (m_mpCapable && !m_join && m_meta)
+    {
+        m_localKey = m_meta->GenerateKey();
+    }
+    // The subflow is attached to its connection once established
+    m_meta = nullptr;
+
+    TcpSocketBase::CompleteFork(p, tcpHeader, fromAddress, toAddress);
+}
+
+void
+MpTcpSubflow::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const Address& toAddress)
+{
+    NS_LOG_FUNCTION(this << packet << fromAddress << toAddress);
+
+    TcpHeader tcpHeader;
+    packet->PeekHeader(tcpHeader);
+    uint8_t flags = tcpHeader.GetFlags();
+
+    if (m_state == SYN_SENT && (flags & TcpHeader::SYN) && (flags & TcpHeader::ACK))
+    {
+        ReadSynOptions(tcpHeader);
+    }
+    else if (m_mpCapable && !(flags & (TcpHeader::SYN | TcpHeader::RST)))
+    {
+        for (const auto& option : tcpHeader.GetOptionList())
+        {
+            if (option->GetKind() != TcpOption::MPTCP)
+            {
+                continue;
+            }
+            Ptr<const TcpOptionMpTcp> mptcp = DynamicCast<const TcpOptionMpTcp>(option);
+            if (mptcp->GetSubType() == TcpOptionMpTcp::DSS)
+            {
+                Ptr<const TcpOptionMpTcpDss> dss = DynamicCast<const TcpOptionMpTcpDss>(mptcp);
+                if (dss->HasMapping() && dss->GetSubflowSequence() + dss->GetMappingLength() >
+                                             m_rxHeadSeq)
+                {
+                    m_rxMappings[dss->GetSubflowSequence()] = {dss->GetDataSequence(),
+                                                               dss->GetMappingLength()};
+                }
+                if (dss->HasDataAck() && m_meta)
+                {
+                    m_meta->ReceivedDataAck(dss->GetDataAck());
+                }
+            }
+            else if (mptcp->GetSubType() == TcpOptionMpTcp::ADD_ADDR && m_meta)
+            {
+                Ptr<const TcpOptionMpTcpAddAddr> addAddr =
+                    DynamicCast<const TcpOptionMpTcpAddAddr>(mptcp);
+                m_meta->AddRemoteAddress(addAddr->GetAddress());
+            }
+        }
+    }
+
+    TcpSocketBase::DoForwardUp(packet, fromAddress, toAddress);
+}
+
+uint32_t
+MpTcpSubflow::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withAck)
+{
+    NS_LOG_FUNCTION(this << seq << maxSize << withAck);
+
+    // A segment carries a single mapping, hence it must not span two of them
+    auto it = FindMapping(m_txMappings, seq);
+    if (it != m_txMappings.end())
+    {
+        maxSize = std::min<uint32_t>(maxSize, it->first + it->second.length - seq);
+    }
+    return TcpSocketBase::SendDataPacket(seq, maxSize, withAck);
+}
+
+} // namespace ns3
@@ -0,0 +1,248 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef MPTCP_SUBFLOW_H
+#define MPTCP_SUBFLOW_H
+
+#include "tcp-socket-base.h"
+
+#include "ns3/ipv4-address.h"
+
+#include <deque>
+#include <map>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+class MpTcpSocket;
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A subflow of a Multipath TCP connection
+ *
+ * A subflow is a regular TcpSocketBase, with its own sequence space,
+ * congestion control and loss recovery, which additionally carries the
+ * Multipath TCP options of \RFC{8684}:
+ *
+ * - the SYN and SYN+ACK of the first subflow carry MP_CAPABLE, and the SYN
+ *   of the additional subflows carries MP_JOIN;
+ * - the segments carrying data carry a DSS mapping from their subflow
+ *   sequence numbers to the data sequence numbers of the connection;
+ * - all the segments of an established connection carry the data-level
+ *   acknowledgment in a DSS option;
+ * - the addresses to be advertised are carried in ADD_ADDR options.
+ *
+ * The data to be sent is handed over by the MpTcpSocket together with its
+ * data sequence number, and each segment is kept within a single mapping.
+ * The in-order data received is drained by the MpTcpSocket together with
+ * the data sequence numbers derived from the mappings received.
+ *
+ * If the peer does not answer with MP_CAPABLE, the subflow falls back to
+ * regular TCP and the options are not sent anymore.
+ */
+class MpTcpSubflow : public TcpSocketBase
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    MpTcpSubflow();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    MpTcpSubflow(const MpTcpSubflow& sock);
+
+    ~MpTcpSubflow() override;
+
+    /**
+     * \brief Set the connection this subflow belongs to
+     * \param meta the connection, or nullptr to detach the subflow
+     */
+    void SetMeta(Ptr<MpTcpSocket> meta);
+
+    /**
+     * \brief Get the connection this subflow belongs to
+     * \return the connection, or nullptr if not attached yet
+     */
+    Ptr<MpTcpSocket> GetMeta() const;
+
+    /**
+     * \brief Set the key sent in MP_CAPABLE
+     * \param key the key of the local end of the connection
+     */
+    void SetLocalKey(uint64_t key);
+
+    /**
+     * \brief Get the key sent in MP_CAPABLE
+     * \return the key of the local end of the connection
+     */
+    uint64_t GetLocalKey() const;
+
+    /**
+     * \brief Get the key received in MP_CAPABLE
+     * \return the key of the remote end of the connection
+     */
+    uint64_t GetRemoteKey() const;
+
+    /**
+     * \brief Check whether the peer agreed to use Multipath TCP
+     * \return true if MP_CAPABLE was received
+     */
+    bool IsMpCapable() const;
+
+    /**
+     * \brief Make this subflow join an existing connection
+     *
+     * The SYN of the subflow carries MP_JOIN instead of MP_CAPABLE.
+     *
+     * \param token the token of the connection of the peer
+     * \param addressId the identifier of the local address
+     */
+    void SetJoin(uint32_t token, uint8_t addressId);
+
+    /**
+     * \brief Check whether this subflow joins an existing connection
+     * \return true if MP_JOIN was sent or received in the SYN
+     */
+    bool IsJoin() const;
+
+    /**
+     * \brief Get the token carried by MP_JOIN
+     * \return the token of the connection joined
+     */
+    uint32_t GetJoinToken() const;
+
+    /**
+     * \brief Send data mapped to the given data sequence number
+     * \param p the data
+     * \param dataSeq the data sequence number of the first byte
+     * \return the number of bytes accepted, or -1 on error
+     */
+    int SendMapped(Ptr<Packet> p, SequenceNumber32 dataSeq);
+
+    /**
+     * \brief Extract the in-order data received on the subflow
+     *
+     * The data is split at the boundaries of the mappings received. Bytes
+     * received without a mapping are discarded.
+     *
+     * \return the fragments of data, along with their data sequence numbers
+     */
+    std::vector<std::pair<SequenceNumber32, Ptr<Packet>>> RecvMapped();
+
+    /**
+     * \brief Advertise an address in the next segments
+     * \param addressId the identifier of the address
+     * \param address the address
+     */
+    void AdvertiseAddress(uint8_t addressId, Ipv4Address address);
+
+    /**
+     * \brief Check whether the subflow can take more data
+     *
+     * The subflow can take more data if it is established and its window
+     * is larger than the data already waiting in its buffer.
+     *
+     * \return true if data can be handed to the subflow
+     */
+    bool HasSendSpace() const;
+
+    /**
+     * \brief Get the TCP state of the subflow
+     * \return the state
+     */
+    TcpStates_t GetState() const;
+
+    /**
+     * \brief Get the congestion state of the subflow
+     * \return the transmission control block
+     */
+    Ptr<TcpSocketState> GetTcb() const;
+
+    /**
+     * \brief Get the congestion control of the subflow
+     * \return the congestion control
+     */
+    Ptr<TcpCongestionOps> GetCongestionControl() const;
+
+    /**
+     * \brief Get the smoothed RTT of the subflow
+     * \return the RTT estimate
+     */
+    Time GetRttEstimate() const;
+
+  protected:
+    // Documented in base class
+    Ptr<TcpSocketBase> Fork() override;
+    void AddOptions(TcpHeader& tcpHeader) override;
+    void DoForwardUp(Ptr<Packet> packet,
+                     const Address& fromAddress,
+                     const Address& toAddress) override;
+    void CompleteFork(Ptr<Packet> p,
+                      const TcpHeader& tcpHeader,
+                      const Address& fromAddress,
+                      const Address& toAddress) override;
+    uint32_t SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withAck) override;
+
+  private:
+    /// A mapping of subflow sequence numbers to data sequence numbers
+    struct Mapping
+    {
+        SequenceNumber32 dataSeq; //!< Data sequence number of the first byte
+        uint16_t length;          //!< Number of bytes mapped
+    };
+
+    /// Mappings, indexed by the subflow sequence number of their first byte
+    typedef std::map<SequenceNumber32, Mapping> MappingMap;
+
+    /**
+     * \brief Find the mapping covering a subflow sequence number
+     * \param mappings the mappings
+     * \param seq the subflow sequence number
+     * \return the mapping, or the end of the map if none covers the sequence
+     */
+    static MappingMap::const_iterator FindMapping(const MappingMap& mappings,
+                                                  SequenceNumber32 seq);
+
+    /**
+     * \brief Read the Multipath TCP options of a SYN
+     * \param tcpHeader the header of the SYN
+     */
+    void ReadSynOptions(const TcpHeader& tcpHeader);
+
+    Ptr<MpTcpSocket> m_meta;         //!< The connection the subflow belongs to
+    uint64_t m_localKey{0};          //!< The key of the local end
+    uint64_t m_remoteKey{0};         //!< The key of the remote end
+    bool m_mpCapable{false};         //!< Whether the peer agreed to use Multipath TCP
+    bool m_join{false};              //!< Whether the subflow joins an existing connection
+    uint32_t m_joinToken{0};         //!< The token carried by MP_JOIN
+    uint8_t m_joinAddressId{0};      //!< The address identifier carried by MP_JOIN
+    MappingMap m_txMappings;         //!< The mappings of the data sent
+    MappingMap m_rxMappings;         //!< The mappings of the data received
+    SequenceNumber32 m_rxHeadSeq{0}; //!< Subflow sequence number of the next byte to extract
+    std::deque<std::pair<uint8_t, Ipv4Address>> m_addrToAdvertise; //!< Addresses to advertise
+};
+
+} // namespace ns3
+
+#endif /* MPTCP_SUBFLOW_H */
@@ -102,9 +102,10 @@ NdiscCache::Lookup(Ipv6Address dst)
 {
     NS_LOG_FUNCTION(this << dst);
 
-    if (m_ndCache.find(dst) != m_ndCache.end())
+    CacheI it = m_ndCache.find(dst);
+    if (it != m_ndCache.end())
     {
-        NdiscCache::Entry* entry = m_ndCache[dst];
+        NdiscCache::Entry* entry = it->second;
         NS_LOG_LOGIC("Found an entry: " << *entry);
 
         return entry;
@@ -128,6 +129,10 @@ NdiscCache::LookupInverse(Address dst)
             entryList.push_back(entry);
         }
     }
+    // Keep the entries sorted by address, regardless of the container
+    entryList.sort([](NdiscCache::Entry* a, NdiscCache::Entry* b) {
+        return a->GetIpv6Address() < b->GetIpv6Address();
+    });
     return entryList;
 }
 
@@ -148,15 +153,12 @@ NdiscCache::Remove(NdiscCache::Entry* entry)
 {
     NS_LOG_FUNCTION(this << entry);
 
-    for (CacheI i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    CacheI i = m_ndCache.find(entry->GetIpv6Address());
+    if (i != m_ndCache.end() && (*i).second == entry)
     {
-        if ((*i).second == entry)
-        {
-            m_ndCache.erase(i);
-            entry->ClearWaitingPacket();
-            delete entry;
-            return;
-        }
+        m_ndCache.erase(i);
+        entry->ClearWaitingPacket();
+        delete entry;
     }
 }
 
@@ -171,6 +173,7 @@ NdiscCache::Flush()
     }
 
     m_ndCache.erase(m_ndCache.begin(), m_ndCache.end());
+    m_nudEvent.Cancel();
 }
 
 void
@@ -193,7 +196,9 @@ NdiscCache::PrintNdiscCache(Ptr<OutputStreamWrapper> stream)
     NS_LOG_FUNCTION(this << stream);
     std::ostream* os = stream->GetStream();
 
-    for (CacheI i = m_ndCache.begin(); i != m_ndCache.end(); i++)
+    // Print the entries sorted by address
+    std::map<Ipv6Address, NdiscCache::Entry*> sortedCache(m_ndCache.begin(), m_ndCache.end());
+    for (auto i = sortedCache.begin(); i != sortedCache.end(); i++)
     {
         *os << i->first << " dev ";
         std::string found = Names::FindName(m_device);
@@ -248,13 +253,97 @@ NdiscCache::Entry::Entry(NdiscCache* nd)
     : m_ndCache(nd),
       m_waiting(),
       m_router(false),
-      m_nudTimer(Timer::CANCEL_ON_DESTROY),
+      m_nudFunction(nullptr),
+      m_nudTimerRunning(false),
       m_lastReachabilityConfirmation(Seconds(0.0)),
       m_nsRetransmit(0)
 {
     NS_LOG_FUNCTION(this);
 }
 
+NdiscCache::Entry::~Entry()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimerRunning)
+    {
+        m_ndCache->CancelNudTimer(this);
+    }
+}
+
+void
+NdiscCache::ScheduleNudTimer(NdiscCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry << entry->m_nudExpiration);
+    NS_ASSERT(!entry->m_nudTimerRunning);
+    NS_ASSERT_MSG(entry->m_nudFunction, "NUD timer function not set");
+
+    entry->m_nudTimerIt = m_nudTimers.insert({entry->m_nudExpiration, entry});
+    entry->m_nudTimerRunning = true;
+
+    // Touch the simulator only if this is now the earliest timer
+    if (entry->m_nudTimerIt == m_nudTimers.begin() &&
+        (!m_nudEvent.IsRunning() || entry->m_nudExpiration < TimeStep(m_nudEvent.GetTs())))
+    {
+        m_nudEvent.Cancel();
+        m_nudEvent = Simulator::Schedule(entry->m_nudExpiration - Simulator::Now(),
+                                         &NdiscCache::HandleNudTimeout,
+                                         this);
+    }
+}
+
+void
+NdiscCache::CancelNudTimer(NdiscCache::Entry* entry)
+{
+    NS_LOG_FUNCTION(this << entry);
+    NS_ASSERT(entry->m_nudTimerRunning);
+
+    // The cache event is left as it is, it will be rearmed when it expires
+    m_nudTimers.erase(entry->m_nudTimerIt);
+    entry->m_nudTimerRunning = false;
+}
+
+void
+NdiscCache::HandleNudTimeout()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    while (!m_nudTimers.empty() && m_nudTimers.begin()->first <= now)
+    {
+        NdiscCache::Entry* entry = m_nudTimers.begin()->second;
+        m_nudTimers.erase(m_nudTimers.begin());
+        entry->m_nudTimerRunning = false;
+
+        if (entry->m_nudExpiration > now)
+        {
+            // The timer has been refreshed in the meantime
+            ScheduleNudTimer(entry);
+            continue;
+        }
+        // The entry can be removed by its timeout function
+        (entry->*(entry->m_nudFunction))();
+    }
+
+    if (!m_nudTimers.empty() && !m_nudEvent.IsRunning())
+    {
+        m_nudEvent = Simulator::Schedule(m_nudTimers.begin()->first - now,
+                                         &NdiscCache::HandleNudTimeout,
+                                         this);
+    }
+}
+
+void
+NdiscCache::Entry::ScheduleNudTimer()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_nudTimerRunning)
+    {
+        m_ndCache->CancelNudTimer(this);
+    }
+    m_nudExpiration = Simulator::Now() + m_nudDelay;
+    m_ndCache->ScheduleNudTimer(this);
+}
+
 void
 NdiscCache::Entry::SetRouter(bool router)
 {
@@ -470,15 +559,10 @@ void
 NdiscCache::Entry::StartReachableTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
     m_lastReachabilityConfirmation = Simulator::Now();
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionReachableTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetReachableTime());
-    m_nudTimer.Schedule();
+    m_nudFunction = &NdiscCache::Entry::FunctionReachableTimeout;
+    m_nudDelay = m_ndCache->m_icmpv6->GetReachableTime();
+    ScheduleNudTimer();
 }
 
 void
@@ -489,11 +573,15 @@ NdiscCache::Entry::UpdateReachableTimer()
     if (m_state == REACHABLE)
     {
         m_lastReachabilityConfirmation = Simulator::Now();
-        if (m_nudTimer.IsRunning())
+        if (m_nudTimerRunning && m_nudTimerIt->first <= Simulator::Now() + m_nudDelay)
+        {
+            // Lazy refresh: the timer is rearmed by the cache when it expires
+            m_nudExpiration = Simulator::Now() + m_nudDelay;
+        }
+        else
         {
-            m_nudTimer.Cancel();
+            ScheduleNudTimer();
         }
-        m_nudTimer.Schedule();
     }
 }
 
@@ -501,49 +589,37 @@ void
 NdiscCache::Entry::StartProbeTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionProbeTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    m_nudFunction = &NdiscCache::Entry::FunctionProbeTimeout;
+    m_nudDelay = m_ndCache->m_icmpv6->GetRetransmissionTime();
+    ScheduleNudTimer();
 }
 
 void
 NdiscCache::Entry::StartDelayTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionDelayTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetDelayFirstProbe());
-    m_nudTimer.Schedule();
+    m_nudFunction = &NdiscCache::Entry::FunctionDelayTimeout;
+    m_nudDelay = m_ndCache->m_icmpv6->GetDelayFirstProbe();
+    ScheduleNudTimer();
 }
 
 void
 NdiscCache::Entry::StartRetransmitTimer()
 {
     NS_LOG_FUNCTION(this);
-    if (m_nudTimer.IsRunning())
-    {
-        m_nudTimer.Cancel();
-    }
-
-    m_nudTimer.SetFunction(&NdiscCache::Entry::FunctionRetransmitTimeout, this);
-    m_nudTimer.SetDelay(m_ndCache->m_icmpv6->GetRetransmissionTime());
-    m_nudTimer.Schedule();
+    m_nudFunction = &NdiscCache::Entry::FunctionRetransmitTimeout;
+    m_nudDelay = m_ndCache->m_icmpv6->GetRetransmissionTime();
+    ScheduleNudTimer();
 }
 
 void
 NdiscCache::Entry::StopNudTimer()
 {
     NS_LOG_FUNCTION(this);
-    m_nudTimer.Cancel();
+    if (m_nudTimerRunning)
+    {
+        m_ndCache->CancelNudTimer(this);
+    }
     m_nsRetransmit = 0;
 }
 
@@ -724,7 +800,7 @@ NdiscCache::RemoveAutoGeneratedEntries()
         {
             i->second->ClearWaitingPacket();
             delete i->second;
-            m_ndCache.erase(i++);
+            i = m_ndCache.erase(i);
             continue;
         }
         i++;
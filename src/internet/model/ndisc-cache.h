@@ -27,11 +27,12 @@
 #include "ns3/output-stream-wrapper.h"
 #include "ns3/packet.h"
 #include "ns3/ptr.h"
-#include "ns3/timer.h"
+#include "ns3/simulator.h"
 
 #include <list>
 #include <map>
 #include <stdint.h>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -159,6 +160,11 @@ class NdiscCache : public Object
      */
     typedef std::pair<Ptr<Packet>, Ipv6Header> Ipv6PayloadHeaderPair;
 
+    /**
+     * \brief NUD timers of the entries, sorted by expiration time.
+     */
+    typedef std::multimap<Time, NdiscCache::Entry*> NudTimers;
+
     /**
      * \ingroup ipv6
      *
@@ -173,7 +179,10 @@ class NdiscCache : public Object
          */
         Entry(NdiscCache* nd);
 
-        virtual ~Entry() = default;
+        /**
+         * \brief Destructor. The NUD timer, if running, is cancelled.
+         */
+        virtual ~Entry();
 
         /**
          * \brief The Entry state enumeration.
@@ -434,9 +443,39 @@ class NdiscCache : public Object
         bool m_router;
 
         /**
-         * \brief Timer (used for NUD).
+         * \brief (Re)schedule the NUD timer, m_nudDelay from now.
+         */
+        void ScheduleNudTimer();
+
+        /**
+         * \brief Function called when the NUD timer expires.
+         */
+        void (NdiscCache::Entry::*m_nudFunction)();
+
+        /**
+         * \brief Delay of the NUD timer.
+         */
+        Time m_nudDelay;
+
+        /**
+         * \brief Expiration time of the NUD timer.
+         *
+         * It can be later than the position of the timer in the cache
+         * NudTimers, as refreshing the reachable timer does not move it.
+         */
+        Time m_nudExpiration;
+
+        /**
+         * \brief Position of the NUD timer in the cache NudTimers.
+         */
+        NudTimers::iterator m_nudTimerIt;
+
+        /**
+         * \brief True if the NUD timer is running.
          */
-        Timer m_nudTimer;
+        bool m_nudTimerRunning;
+
+        friend class NdiscCache;
 
         /**
          * \brief Last time we see a reachability confirmation.
@@ -458,11 +497,11 @@ class NdiscCache : public Object
     /**
      * \brief Neighbor Discovery Cache container
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*> Cache;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash> Cache;
     /**
      * \brief Neighbor Discovery Cache container iterator
      */
-    typedef std::map<Ipv6Address, NdiscCache::Entry*>::iterator CacheI;
+    typedef std::unordered_map<Ipv6Address, NdiscCache::Entry*, Ipv6AddressHash>::iterator CacheI;
 
     /**
      * \brief A list of Entry.
@@ -470,6 +509,26 @@ class NdiscCache : public Object
     Cache m_ndCache;
 
   private:
+    /**
+     * \brief Insert the NUD timer of an entry, expiring at its m_nudExpiration.
+     *
+     * The cache event is rescheduled only if the timer is the earliest one.
+     *
+     * \param entry the entry
+     */
+    void ScheduleNudTimer(NdiscCache::Entry* entry);
+
+    /**
+     * \brief Remove the NUD timer of an entry.
+     * \param entry the entry
+     */
+    void CancelNudTimer(NdiscCache::Entry* entry);
+
+    /**
+     * \brief Handle all the NUD timers expired so far, and rearm the cache event.
+     */
+    void HandleNudTimeout();
+
     /**
      * \brief The NetDevice.
      */
@@ -489,6 +548,18 @@ class NdiscCache : public Object
      * \brief Max number of packet stored in m_waiting.
      */
     uint32_t m_unresQlen;
+
+    /**
+     * \brief NUD timers of all the entries.
+     *
+     * A single simulator event per cache is used for all the NUD timers.
+     */
+    NudTimers m_nudTimers;
+
+    /**
+     * \brief Event for the earliest NUD timer.
+     */
+    EventId m_nudEvent;
 };
 
 /**
@@ -0,0 +1,310 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quic-congestion-control.h"
+
+#include "tcp-congestion-ops.h"
+#include "tcp-rate-ops.h"
+#include "tcp-tx-item.h"
+
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuicCongestionControl");
+
+NS_OBJECT_ENSURE_REGISTERED(QuicCongestionControl);
+
+/// Minimum congestion window, in packets, \RFC{9002} section 7.2
+static const uint32_t QUIC_MINIMUM_WINDOW = 2;
+
+TypeId
+QuicCongestionControl::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QuicCongestionControl")
+                            .SetParent<Object>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<QuicCongestionControl>();
+    return tid;
+}
+
+QuicCongestionControl::QuicCongestionControl()
+    : m_recoveryStart(Seconds(0)),
+      m_inRecovery(false),
+      m_ackedBytes(0),
+      m_ackedOutsideRecovery(0),
+      m_ackedRemainder(0),
+      m_lostBytes(0),
+      m_largestAckedSentTime(Seconds(0))
+{
+    NS_LOG_FUNCTION(this);
+    m_tcb = CreateObject<TcpSocketState>();
+    m_rateOps = CreateObject<TcpRateLinux>();
+}
+
+QuicCongestionControl::~QuicCongestionControl()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QuicCongestionControl::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_algo = nullptr;
+    m_rateOps = nullptr;
+    m_tcb = nullptr;
+    Object::DoDispose();
+}
+
+void
+QuicCongestionControl::SetCongestionControlAlgorithm(Ptr<TcpCongestionOps> algo)
+{
+    NS_LOG_FUNCTION(this << algo);
+    m_algo = algo;
+}
+
+Ptr<TcpCongestionOps>
+QuicCongestionControl::GetCongestionControlAlgorithm() const
+{
+    return m_algo;
+}
+
+Ptr<TcpSocketState>
+QuicCongestionControl::GetTcb() const
+{
+    return m_tcb;
+}
+
+void
+QuicCongestionControl::Init(uint32_t maxDatagramSize, uint32_t initialWindow)
+{
+    NS_LOG_FUNCTION(this << maxDatagramSize << initialWindow);
+    NS_ASSERT_MSG(m_algo, "No congestion control algorithm");
+    m_tcb->m_segmentSize = maxDatagramSize;
+    m_tcb->m_initialCWnd = initialWindow;
+    m_tcb->m_initialSsThresh = std::numeric_limits<uint32_t>::max();
+    m_tcb->m_cWnd = initialWindow * maxDatagramSize;
+    m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+    m_tcb->m_ssThresh = m_tcb->m_initialSsThresh;
+    m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
+    m_algo->Init(m_tcb);
+}
+
+bool
+QuicCongestionControl::CanSend() const
+{
+    return m_tcb->m_bytesInFlight < m_tcb->m_cWnd;
+}
+
+Time
+QuicCongestionControl::GetPacingDelay(uint32_t size) const
+{
+    if (!m_tcb->m_pacing || m_tcb->m_pacingRate.Get().GetBitRate() == 0)
+    {
+        return Seconds(0);
+    }
+    return m_tcb->m_pacingRate.Get().CalculateBytesTxTime(size);
+}
+
+uint32_t
+QuicCongestionControl::GetCongestionWindow() const
+{
+    return m_tcb->m_cWnd;
+}
+
+uint32_t
+QuicCongestionControl::GetBytesInFlight() const
+{
+    return m_tcb->m_bytesInFlight;
+}
+
+bool
+QuicCongestionControl::InRecovery(Time timeSent) const
+{
+    return m_inRecovery && timeSent <= m_recoveryStart;
+}
+
+void
+QuicCongestionControl::OnPacketSent(TcpTxItem* item, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << item << size);
+    if (m_tcb->m_bytesInFlight.Get() == 0)
+    {
+        m_algo->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_TX_START);
+    }
+    item->m_packet = Create<Packet>(size);
+    item->m_lastSent = Simulator::Now();
+    m_rateOps->SkbSent(item, m_tcb->m_bytesInFlight.Get() == 0);
+    m_tcb->m_bytesInFlight += size;
+    m_tcb->m_highTxMark += size;
+    m_tcb->m_nextTxSequence = m_tcb->m_highTxMark;
+}
+
+void
+QuicCongestionControl::OnAppLimited()
+{
+    NS_LOG_FUNCTION(this);
+    m_rateOps->CalculateAppLimited(m_tcb->m_cWnd,
+                                   m_tcb->m_bytesInFlight,
+                                   m_tcb->m_segmentSize,
+                                   m_tcb->m_highTxMark,
+                                   m_tcb->m_nextTxSequence,
+                                   0,
+                                   0);
+}
+
+void
+QuicCongestionControl::OnPacketAcked(TcpTxItem* item, Time timeSent)
+{
+    NS_LOG_FUNCTION(this << item << timeSent);
+    uint32_t size = item->GetSeqSize();
+    m_rateOps->SkbDelivered(item);
+    m_tcb->m_bytesInFlight -= std::min<uint32_t>(size, m_tcb->m_bytesInFlight);
+    m_ackedBytes += size;
+    if (!InRecovery(timeSent))
+    {
+        m_ackedOutsideRecovery += size;
+    }
+    m_largestAckedSentTime = std::max(m_largestAckedSentTime, timeSent);
+}
+
+void
+QuicCongestionControl::OnAckProcessed(uint32_t priorInFlight, Time latestRtt, Time minRtt)
+{
+    NS_LOG_FUNCTION(this << priorInFlight << latestRtt << minRtt);
+
+    m_tcb->m_lastAckedSackedBytes = m_ackedBytes;
+    m_tcb->m_lastAckedSeq += m_ackedBytes;
+    if (latestRtt.IsStrictlyPositive())
+    {
+        m_tcb->m_lastRtt = latestRtt;
+        m_tcb->m_minRtt = minRtt;
+    }
+
+    if (m_inRecovery && !InRecovery(m_largestAckedSentTime))
+    {
+        // A packet sent after the start of the recovery period was acknowledged
+        NS_LOG_DEBUG(TcpSocketState::TcpCongStateName[m_tcb->m_congState] << " -> CA_OPEN");
+        m_inRecovery = false;
+        m_algo->CongestionStateSet(m_tcb, TcpSocketState::CA_OPEN);
+        m_tcb->m_congState = TcpSocketState::CA_OPEN;
+    }
+
+    if (m_algo->HasCongControl())
+    {
+        const TcpRateOps::TcpRateSample& rateSample =
+            m_rateOps->GenerateSample(m_ackedBytes, m_lostBytes, false, priorInFlight, minRtt);
+        m_algo->CongControl(m_tcb, m_rateOps->GetConnectionRate(), rateSample);
+    }
+    else
+    {
+        // The algorithms count the acknowledged data in segments
+        m_ackedRemainder += m_ackedOutsideRecovery;
+        uint32_t segmentsAcked = m_ackedRemainder / m_tcb->m_segmentSize;
+        m_ackedRemainder %= m_tcb->m_segmentSize;
+        if (segmentsAcked > 0 && latestRtt.IsStrictlyPositive())
+        {
+            m_algo->PktsAcked(m_tcb, segmentsAcked, latestRtt);
+        }
+        if (segmentsAcked > 0 && m_tcb->m_congState == TcpSocketState::CA_OPEN)
+        {
+            m_algo->IncreaseWindow(m_tcb, segmentsAcked);
+        }
+        m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+        UpdatePacingRate();
+    }
+
+    m_ackedBytes = 0;
+    m_ackedOutsideRecovery = 0;
+    m_lostBytes = 0;
+}
+
+void
+QuicCongestionControl::OnPacketsLost(uint32_t bytes, Time largestLostSentTime)
+{
+    NS_LOG_FUNCTION(this << bytes << largestLostSentTime);
+    uint32_t bytesInFlight = m_tcb->m_bytesInFlight;
+    m_tcb->m_bytesInFlight -= std::min(bytes, bytesInFlight);
+    m_lostBytes += bytes;
+
+    if (InRecovery(largestLostSentTime))
+    {
+        // A single reduction per round trip
+        return;
+    }
+
+    NS_LOG_DEBUG(TcpSocketState::TcpCongStateName[m_tcb->m_congState] << " -> CA_RECOVERY");
+    m_inRecovery = true;
+    m_recoveryStart = Simulator::Now();
+    m_algo->CongestionStateSet(m_tcb, TcpSocketState::CA_RECOVERY);
+    m_tcb->m_congState = TcpSocketState::CA_RECOVERY;
+    m_tcb->m_ssThresh = m_algo->GetSsThresh(m_tcb, bytesInFlight);
+    if (!m_algo->HasCongControl())
+    {
+        m_tcb->m_cWnd = std::max(m_tcb->m_ssThresh.Get(), QUIC_MINIMUM_WINDOW * m_tcb->m_segmentSize);
+        m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+        UpdatePacingRate();
+    }
+    NS_LOG_INFO("Enter recovery; set cwnd to " << m_tcb->m_cWnd << ", ssthresh to "
+                                               << m_tcb->m_ssThresh);
+}
+
+void
+QuicCongestionControl::OnPersistentCongestion()
+{
+    NS_LOG_FUNCTION(this);
+    m_algo->CongestionStateSet(m_tcb, TcpSocketState::CA_LOSS);
+    m_tcb->m_congState = TcpSocketState::CA_LOSS;
+    m_tcb->m_cWnd = QUIC_MINIMUM_WINDOW * m_tcb->m_segmentSize;
+    m_tcb->m_cWndInfl = m_tcb->m_cWnd;
+    m_algo->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_LOSS);
+    // The recovery period ends with the next acknowledgment of a new packet
+    m_inRecovery = true;
+    m_recoveryStart = Simulator::Now();
+    UpdatePacingRate();
+}
+
+void
+QuicCongestionControl::OnPacketDiscarded(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_tcb->m_bytesInFlight -= std::min<uint32_t>(size, m_tcb->m_bytesInFlight);
+}
+
+void
+QuicCongestionControl::UpdatePacingRate()
+{
+    // As in TcpSocketBase, do not update the pacing rate if the algorithm
+    // implements CongControl ()
+    if (m_algo->HasCongControl() || !m_tcb->m_pacing || !m_tcb->m_lastRtt.Get().IsStrictlyPositive())
+    {
+        return;
+    }
+    double factor = (m_tcb->m_cWnd < m_tcb->m_ssThresh / 2)
+                        ? static_cast<double>(m_tcb->m_pacingSsRatio) / 100
+                        : static_cast<double>(m_tcb->m_pacingCaRatio) / 100;
+    DataRate pacingRate((std::max(m_tcb->m_cWnd, m_tcb->m_bytesInFlight) * 8 * factor) /
+                        m_tcb->m_lastRtt.Get().GetSeconds());
+    m_tcb->m_pacingRate = std::min(pacingRate, m_tcb->m_maxPacingRate);
+}
+
+} // namespace ns3
@@ -0,0 +1,203 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUIC_CONGESTION_CONTROL_H
+#define QUIC_CONGESTION_CONTROL_H
+
+#include "tcp-socket-state.h"
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+namespace ns3
+{
+
+class TcpCongestionOps;
+class TcpRateOps;
+class TcpTxItem;
+
+/**
+ * \ingroup quic
+ * \brief Congestion controller of a QUIC connection, \RFC{9002} section 7
+ *
+ * This class drives a TCP congestion control algorithm (TcpCongestionOps)
+ * from the events of the QUIC loss detection, so that the algorithms
+ * available for TCP (NewReno, Cubic, BBR, ...) can be used unchanged by
+ * QUIC. It keeps a TcpSocketState whose fields are updated as TCP would:
+ *
+ * - the bytes in flight count the ack-eliciting packets not yet
+ *   acknowledged nor declared lost;
+ * - the acknowledged bytes are reported to PktsAcked() and IncreaseWindow()
+ *   in units of the maximum datagram size, outside of a recovery period;
+ * - a loss, or a congestion signal, starts a recovery period unless the
+ *   lost packet was sent during the current one: the window is set to
+ *   GetSsThresh() and the state moves to CA_RECOVERY until a packet sent
+ *   after the start of the period is acknowledged;
+ * - persistent congestion collapses the window to the minimum window and
+ *   moves the state to CA_LOSS.
+ *
+ * Each packet is tracked by a TcpTxItem, passed to a TcpRateLinux
+ * estimator, so that the algorithms implementing CongControl() (e.g.,
+ * TcpBbr) receive the same delivery rate samples as with TCP. When the
+ * algorithm does not set the pacing rate itself, and pacing is enabled
+ * through the TcpSocketState attributes, the pacing rate is derived from
+ * the window and the RTT as in TcpSocketBase.
+ */
+class QuicCongestionControl : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QuicCongestionControl();
+    ~QuicCongestionControl() override;
+
+    /**
+     * \brief Set the congestion control algorithm
+     * \param algo the algorithm
+     */
+    void SetCongestionControlAlgorithm(Ptr<TcpCongestionOps> algo);
+
+    /**
+     * \brief Get the congestion control algorithm
+     * \return the algorithm
+     */
+    Ptr<TcpCongestionOps> GetCongestionControlAlgorithm() const;
+
+    /**
+     * \brief Get the congestion state shared with the algorithm
+     * \return the congestion state
+     */
+    Ptr<TcpSocketState> GetTcb() const;
+
+    /**
+     * \brief Initialize the window and the algorithm
+     * \param maxDatagramSize the maximum size of the packets, in bytes
+     * \param initialWindow the initial window, in packets
+     */
+    void Init(uint32_t maxDatagramSize, uint32_t initialWindow);
+
+    /**
+     * \brief Check whether the window allows sending an ack-eliciting packet
+     * \return true if the bytes in flight are below the congestion window
+     */
+    bool CanSend() const;
+
+    /**
+     * \brief Get the time to wait after sending a packet, when pacing
+     * \param size the size of the packet, in bytes
+     * \return the transmission time of the packet at the pacing rate, or
+     *         zero if pacing is disabled
+     */
+    Time GetPacingDelay(uint32_t size) const;
+
+    /**
+     * \brief Get the congestion window
+     * \return the congestion window, in bytes
+     */
+    uint32_t GetCongestionWindow() const;
+
+    /**
+     * \brief Get the bytes in flight
+     * \return the bytes in flight
+     */
+    uint32_t GetBytesInFlight() const;
+
+    /**
+     * \brief Record the transmission of an ack-eliciting packet
+     * \param item the item tracking the packet until it is acknowledged or lost
+     * \param size the size of the packet, in bytes
+     */
+    void OnPacketSent(TcpTxItem* item, uint32_t size);
+
+    /**
+     * \brief Record that the sender has no more data to send
+     */
+    void OnAppLimited();
+
+    /**
+     * \brief Record the acknowledgment of a packet
+     *
+     * OnAckProcessed() must be called once all the packets newly acknowledged
+     * by an ACK frame have been reported.
+     *
+     * \param item the item tracking the packet
+     * \param timeSent the time the packet was sent
+     */
+    void OnPacketAcked(TcpTxItem* item, Time timeSent);
+
+    /**
+     * \brief Update the window after processing an ACK frame
+     * \param priorInFlight the bytes in flight before the ACK frame
+     * \param latestRtt the latest RTT sample, or zero if the ACK frame did
+     *        not provide one
+     * \param minRtt the minimum RTT
+     */
+    void OnAckProcessed(uint32_t priorInFlight, Time latestRtt, Time minRtt);
+
+    /**
+     * \brief Record the loss of packets
+     * \param bytes the size of the packets declared lost, in bytes
+     * \param largestLostSentTime the time the last of the lost packets was sent
+     */
+    void OnPacketsLost(uint32_t bytes, Time largestLostSentTime);
+
+    /**
+     * \brief Collapse the window after persistent congestion, \RFC{9002} section 7.6
+     */
+    void OnPersistentCongestion();
+
+    /**
+     * \brief Remove a packet from the bytes in flight without considering it
+     *        acknowledged or lost, e.g. when its packet number space is discarded
+     * \param size the size of the packet, in bytes
+     */
+    void OnPacketDiscarded(uint32_t size);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Check whether a packet was sent during the current recovery period
+     * \param timeSent the time the packet was sent
+     * \return true if the packet was sent before the end of the recovery period
+     */
+    bool InRecovery(Time timeSent) const;
+
+    /**
+     * \brief Update the pacing rate from the window and the RTT, when the
+     *        algorithm does not control the pacing rate itself
+     */
+    void UpdatePacingRate();
+
+    Ptr<TcpSocketState> m_tcb;             //!< Congestion state shared with the algorithm
+    Ptr<TcpCongestionOps> m_algo;          //!< Congestion control algorithm
+    Ptr<TcpRateOps> m_rateOps;             //!< Delivery rate estimator
+    Time m_recoveryStart;                  //!< Start time of the current recovery period
+    bool m_inRecovery;                     //!< Whether a recovery period is ongoing
+    uint32_t m_ackedBytes;                 //!< Bytes newly acknowledged by the current ACK
+    uint32_t m_ackedOutsideRecovery;       //!< Of which sent after the recovery period
+    uint32_t m_ackedRemainder;             //!< Acknowledged bytes not reported yet (partial packet)
+    uint32_t m_lostBytes;                  //!< Bytes declared lost since the last ACK
+    Time m_largestAckedSentTime;           //!< Time the largest packet newly acked was sent
+};
+
+} // namespace ns3
+
+#endif /* QUIC_CONGESTION_CONTROL_H */
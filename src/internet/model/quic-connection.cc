@@ -0,0 +1,1711 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quic-connection.h"
+
+#include "quic-congestion-control.h"
+#include "quic-socket-factory.h"
+#include "quic-socket.h"
+#include "tcp-congestion-ops.h"
+#include "tcp-cubic.h"
+#include "udp-socket-factory.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/object-factory.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/trace-source-accessor.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuicConnection");
+
+NS_OBJECT_ENSURE_REGISTERED(QuicConnection);
+
+/// QUIC version 1, \RFC{9000}
+static const uint32_t QUIC_VERSION = 1;
+/// Minimum size of a datagram carrying an ack-eliciting Initial packet, \RFC{9000} section 14.1
+static const uint32_t QUIC_MIN_INITIAL_SIZE = 1200;
+/// Size of the ServerHello message
+static const uint32_t QUIC_SERVER_HELLO_SIZE = 90;
+/// Size of the Finished message of the client
+static const uint32_t QUIC_CLIENT_FINISHED_SIZE = 52;
+/// Packet reordering threshold, \RFC{9002} section 6.1.1
+static const uint64_t QUIC_PACKET_THRESHOLD = 3;
+/// Timer granularity, in milliseconds, \RFC{9002} section 6.1.2
+static const uint32_t QUIC_GRANULARITY_MS = 1;
+/// Persistent congestion threshold, \RFC{9002} section 7.6.1
+static const uint32_t QUIC_PERSISTENT_CONGESTION_THRESHOLD = 3;
+/// Number of ack-eliciting packets received before sending an ACK, \RFC{9000} section 13.2.2
+static const uint32_t QUIC_ACK_FREQUENCY = 2;
+/// Maximum number of ranges of an ACK frame, and of received ranges tracked
+static const std::size_t QUIC_MAX_ACK_RANGES = 32;
+/// Maximum exponent of the PTO backoff
+static const uint32_t QUIC_MAX_PTO_BACKOFF = 16;
+
+/**
+ * \brief Add a range to a map of ranges, merging the overlapping ranges
+ * \param ranges the ranges
+ * \param start the start of the range
+ * \param end the end of the range (excluded)
+ */
+static void
+AddRange(std::map<uint64_t, uint64_t>& ranges, uint64_t start, uint64_t end)
+{
+    if (start >= end)
+    {
+        return;
+    }
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin())
+    {
+        auto prev = std::prev(it);
+        if (prev->second >= start)
+        {
+            start = prev->first;
+            end = std::max(end, prev->second);
+            ranges.erase(prev);
+        }
+    }
+    while (it != ranges.end() && it->first <= end)
+    {
+        end = std::max(end, it->second);
+        it = ranges.erase(it);
+    }
+    ranges[start] = end;
+}
+
+/**
+ * \brief Remove a range from a map of ranges
+ * \param ranges the ranges
+ * \param start the start of the range
+ * \param end the end of the range (excluded)
+ */
+static void
+RemoveRange(std::map<uint64_t, uint64_t>& ranges, uint64_t start, uint64_t end)
+{
+    if (start >= end)
+    {
+        return;
+    }
+    auto it = ranges.upper_bound(start);
+    if (it != ranges.begin())
+    {
+        --it;
+    }
+    while (it != ranges.end() && it->first < end)
+    {
+        uint64_t rangeStart = it->first;
+        uint64_t rangeEnd = it->second;
+        if (rangeEnd <= start)
+        {
+            ++it;
+            continue;
+        }
+        it = ranges.erase(it);
+        if (rangeStart < start)
+        {
+            ranges[rangeStart] = start;
+        }
+        if (rangeEnd > end)
+        {
+            ranges[end] = rangeEnd;
+        }
+    }
+}
+
+/**
+ * \brief Check whether a map of ranges contains a value
+ * \param ranges the ranges
+ * \param value the value
+ * \return true if a range contains the value
+ */
+static bool
+InRanges(const std::map<uint64_t, uint64_t>& ranges, uint64_t value)
+{
+    auto it = ranges.upper_bound(value);
+    return it != ranges.begin() && std::prev(it)->second > value;
+}
+
+/**
+ * \brief Append a frame to the payload of a packet
+ * \param payload the payload
+ * \param frame the frame header
+ * \param data the data of the frame, if any
+ */
+static void
+AddFrame(Ptr<Packet> payload, const QuicFrameHeader& frame, Ptr<const Packet> data)
+{
+    Ptr<Packet> p = data ? data->Copy() : Create<Packet>();
+    p->AddHeader(frame);
+    payload->AddAtEnd(p);
+}
+
+void
+QuicConnection::SendBuffer::Write(Ptr<Packet> packet)
+{
+    if (!m_data)
+    {
+        m_data = Create<Packet>();
+    }
+    m_data->AddAtEnd(packet);
+}
+
+uint64_t
+QuicConnection::SendBuffer::GetEnd() const
+{
+    return m_ackedOffset + (m_data ? m_data->GetSize() : 0);
+}
+
+bool
+QuicConnection::SendBuffer::HasPending() const
+{
+    return !m_lost.empty() || m_sentOffset < GetEnd() || (m_fin && !m_finSent);
+}
+
+uint64_t
+QuicConnection::SendBuffer::GetNextOffset() const
+{
+    return m_lost.empty() ? m_sentOffset : m_lost.begin()->first;
+}
+
+Ptr<Packet>
+QuicConnection::SendBuffer::Next(uint32_t maxLength, uint64_t& offset, bool& fin)
+{
+    uint64_t end = GetEnd();
+    if (!m_lost.empty())
+    {
+        // Retransmissions first
+        offset = m_lost.begin()->first;
+        uint64_t length = std::min<uint64_t>(maxLength, m_lost.begin()->second - offset);
+        RemoveRange(m_lost, offset, offset + length);
+        fin = m_fin && offset + length == end;
+        m_finSent = m_finSent || fin;
+        return m_data->CreateFragment(offset - m_ackedOffset, length);
+    }
+    if (m_sentOffset < end)
+    {
+        offset = m_sentOffset;
+        uint64_t length = std::min<uint64_t>(maxLength, end - m_sentOffset);
+        m_sentOffset += length;
+        fin = m_fin && m_sentOffset == end;
+        m_finSent = m_finSent || fin;
+        return m_data->CreateFragment(offset - m_ackedOffset, length);
+    }
+    if (m_fin && !m_finSent)
+    {
+        offset = end;
+        fin = true;
+        m_finSent = true;
+        return Create<Packet>();
+    }
+    return nullptr;
+}
+
+void
+QuicConnection::SendBuffer::Acked(uint64_t offset, uint64_t length, bool fin)
+{
+    m_finAcked = m_finAcked || fin;
+    if (offset + length <= m_ackedOffset)
+    {
+        return;
+    }
+    AddRange(m_acked, std::max(offset, m_ackedOffset), offset + length);
+    RemoveRange(m_lost, offset, offset + length);
+    auto it = m_acked.begin();
+    if (it->first <= m_ackedOffset)
+    {
+        // Release the data acknowledged in order
+        m_data->RemoveAtStart(it->second - m_ackedOffset);
+        m_ackedOffset = it->second;
+        m_acked.erase(it);
+    }
+}
+
+void
+QuicConnection::SendBuffer::Lost(uint64_t offset, uint64_t length, bool fin)
+{
+    if (fin && !m_finAcked)
+    {
+        m_finSent = false;
+    }
+    uint64_t start = std::max(offset, m_ackedOffset);
+    uint64_t end = offset + length;
+    if (start >= end)
+    {
+        return;
+    }
+    AddRange(m_lost, start, end);
+    // Do not retransmit the data acknowledged by another packet
+    for (auto it = m_acked.upper_bound(start); it != m_acked.begin();)
+    {
+        --it;
+        if (it->second > start)
+        {
+            RemoveRange(m_lost, it->first, it->second);
+        }
+        break;
+    }
+    for (auto it = m_acked.upper_bound(start); it != m_acked.end() && it->first < end; ++it)
+    {
+        RemoveRange(m_lost, it->first, it->second);
+    }
+}
+
+bool
+QuicConnection::SendBuffer::IsComplete() const
+{
+    return m_fin && m_finAcked && m_ackedOffset == GetEnd();
+}
+
+Ptr<Packet>
+QuicConnection::RecvBuffer::Receive(uint64_t offset, Ptr<Packet> packet)
+{
+    Ptr<Packet> ready = Create<Packet>();
+    if (offset + packet->GetSize() <= m_offset)
+    {
+        return ready;
+    }
+    auto it = m_outOfOrder.find(offset);
+    if (it == m_outOfOrder.end() || it->second->GetSize() < packet->GetSize())
+    {
+        m_outOfOrder[offset] = packet;
+    }
+    while (!m_outOfOrder.empty() && m_outOfOrder.begin()->first <= m_offset)
+    {
+        uint64_t start = m_outOfOrder.begin()->first;
+        Ptr<Packet> data = m_outOfOrder.begin()->second;
+        m_outOfOrder.erase(m_outOfOrder.begin());
+        uint64_t skip = m_offset - start;
+        if (skip < data->GetSize())
+        {
+            ready->AddAtEnd(data->CreateFragment(skip, data->GetSize() - skip));
+            m_offset = start + data->GetSize();
+        }
+    }
+    return ready;
+}
+
+bool
+QuicConnection::RecvBuffer::IsComplete() const
+{
+    return m_finReceived && m_offset >= m_finalSize;
+}
+
+TypeId
+QuicConnection::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::QuicConnection")
+            .SetParent<Object>()
+            .SetGroupName("Internet")
+            .AddConstructor<QuicConnection>()
+            .AddAttribute("CongestionControl",
+                          "Type of the TCP congestion control algorithm used by the connection",
+                          TypeIdValue(TcpCubic::GetTypeId()),
+                          MakeTypeIdAccessor(&QuicConnection::m_congestionTypeId),
+                          MakeTypeIdChecker())
+            .AddAttribute("MaxPacketSize",
+                          "Maximum size of the UDP payload of the packets, in bytes",
+                          UintegerValue(1350),
+                          MakeUintegerAccessor(&QuicConnection::m_maxPacketSize),
+                          MakeUintegerChecker<uint32_t>(QUIC_MIN_INITIAL_SIZE))
+            .AddAttribute("InitialWindow",
+                          "Initial congestion window, in packets",
+                          UintegerValue(10),
+                          MakeUintegerAccessor(&QuicConnection::m_initialWindow),
+                          MakeUintegerChecker<uint32_t>(2))
+            .AddAttribute("InitialRtt",
+                          "RTT assumed before the first RTT sample",
+                          TimeValue(MilliSeconds(333)),
+                          MakeTimeAccessor(&QuicConnection::m_initialRtt),
+                          MakeTimeChecker(MilliSeconds(1)))
+            .AddAttribute("MaxAckDelay",
+                          "Maximum delay before acknowledging an ack-eliciting packet",
+                          TimeValue(MilliSeconds(25)),
+                          MakeTimeAccessor(&QuicConnection::m_maxAckDelay),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("IdleTimeout",
+                          "Close the connection after this time without receiving a packet "
+                          "(zero disables the idle timeout)",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&QuicConnection::m_idleTimeout),
+                          MakeTimeChecker(Seconds(0)))
+            .AddAttribute("ClientHelloSize",
+                          "Size of the ClientHello message, in bytes",
+                          UintegerValue(300),
+                          MakeUintegerAccessor(&QuicConnection::m_clientHelloSize),
+                          MakeUintegerChecker<uint32_t>(4))
+            .AddAttribute("ServerFlightSize",
+                          "Size of the handshake messages sent by the server after its "
+                          "ServerHello (certificate chain included), in bytes",
+                          UintegerValue(2500),
+                          MakeUintegerAccessor(&QuicConnection::m_serverFlightSize),
+                          MakeUintegerChecker<uint32_t>(4))
+            .AddTraceSource("Tx",
+                            "A packet was sent on the UDP socket",
+                            MakeTraceSourceAccessor(&QuicConnection::m_txTrace),
+                            "ns3::Packet::TracedCallback")
+            .AddTraceSource("Rx",
+                            "A packet was received from the UDP socket",
+                            MakeTraceSourceAccessor(&QuicConnection::m_rxTrace),
+                            "ns3::Packet::TracedCallback");
+    return tid;
+}
+
+QuicConnection::QuicConnection()
+    : m_isClient(false),
+      m_state(IDLE),
+      m_handshakeConfirmed(false),
+      m_handshakeDonePending(false),
+      m_scid(0),
+      m_dcid(0),
+      m_dcidKnown(false),
+      m_processing(false),
+      m_nextSendTime(Seconds(0)),
+      m_lostPackets(0),
+      m_hasRttSample(false),
+      m_latestRtt(Seconds(0)),
+      m_smoothedRtt(Seconds(0)),
+      m_rttVar(Seconds(0)),
+      m_minRtt(Seconds(0)),
+      m_ptoCount(0),
+      m_firstRttSampleTime(Seconds(0)),
+      m_nextLocalStreamId(0),
+      m_nextPeerStreamId(1),
+      m_nextStream(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_rng = CreateObject<UniformRandomVariable>();
+    m_congestion = CreateObject<QuicCongestionControl>();
+}
+
+QuicConnection::~QuicConnection()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QuicConnection::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_lossDetectionTimer.Cancel();
+    m_ackTimer.Cancel();
+    m_sendEvent.Cancel();
+    m_idleTimer.Cancel();
+    m_streams.clear();
+    if (m_isClient && m_udp)
+    {
+        m_udp->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+    }
+    m_udp = nullptr;
+    m_listener = nullptr;
+    m_factory = nullptr;
+    m_node = nullptr;
+    m_congestion = nullptr;
+    m_rng = nullptr;
+    Object::DoDispose();
+}
+
+void
+QuicConnection::SetNode(Ptr<Node> node)
+{
+    m_node = node;
+}
+
+void
+QuicConnection::SetFactory(Ptr<QuicSocketFactory> factory)
+{
+    m_factory = factory;
+}
+
+void
+QuicConnection::Setup()
+{
+    NS_LOG_FUNCTION(this);
+    uint64_t high = m_rng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    uint64_t low = m_rng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    m_scid = (high << 32) | low;
+
+    ObjectFactory algoFactory;
+    algoFactory.SetTypeId(m_congestionTypeId);
+    m_congestion->SetCongestionControlAlgorithm(algoFactory.Create<TcpCongestionOps>());
+    m_congestion->Init(m_maxPacketSize, m_initialWindow);
+
+    m_smoothedRtt = m_initialRtt;
+    m_rttVar = m_initialRtt / 2;
+    m_state = HANDSHAKING;
+    if (m_factory)
+    {
+        m_factory->AddConnection(this);
+    }
+    RestartIdleTimer();
+}
+
+int
+QuicConnection::Connect(const Address& local, const Address& peer)
+{
+    NS_LOG_FUNCTION(this << local << peer);
+    NS_ASSERT_MSG(m_state == IDLE, "Connection already opened");
+    m_isClient = true;
+    m_peer = peer;
+    m_udp = Socket::CreateSocket(m_node, UdpSocketFactory::GetTypeId());
+    if (m_udp->Bind(local) == -1 || m_udp->Connect(peer) == -1)
+    {
+        return -1;
+    }
+    m_udp->SetRecvCallback(MakeCallback(&QuicConnection::ReceivedData, this));
+    Setup();
+
+    // The client chooses the connection ID of the server until the server
+    // chooses its own
+    uint64_t high = m_rng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    uint64_t low = m_rng->GetInteger(0, std::numeric_limits<uint32_t>::max());
+    m_dcid = (high << 32) | low;
+
+    QueueCryptoMessage(INITIAL_SPACE, m_clientHelloSize);
+    SendPendingData();
+    return 0;
+}
+
+void
+QuicConnection::Accept(Ptr<QuicSocket> listener, Ptr<Socket> udp, const Address& peer)
+{
+    NS_LOG_FUNCTION(this << listener << udp << peer);
+    NS_ASSERT_MSG(m_state == IDLE, "Connection already opened");
+    m_isClient = false;
+    m_listener = listener;
+    m_udp = udp;
+    m_peer = peer;
+    m_nextLocalStreamId = 1;
+    m_nextPeerStreamId = 0;
+    Setup();
+}
+
+void
+QuicConnection::ReceivedData(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        Receive(packet, from);
+    }
+}
+
+void
+QuicConnection::Receive(Ptr<Packet> packet, const Address& from)
+{
+    NS_LOG_FUNCTION(this << packet << from);
+    if (m_state == CLOSED)
+    {
+        return;
+    }
+    m_rxTrace(packet);
+
+    QuicHeader header;
+    packet->RemoveHeader(header);
+    PacketNumberSpace_t space = APPLICATION_SPACE;
+    if (header.GetPacketType() == QuicHeader::INITIAL)
+    {
+        space = INITIAL_SPACE;
+    }
+    else if (header.GetPacketType() == QuicHeader::HANDSHAKE)
+    {
+        space = HANDSHAKE_SPACE;
+    }
+    Space& s = m_spaces[space];
+    if (s.m_discarded || (space == APPLICATION_SPACE && m_state == HANDSHAKING && m_isClient))
+    {
+        NS_LOG_LOGIC("No keys for " << header << ", drop");
+        return;
+    }
+    if (header.IsLongHeader() && !m_dcidKnown)
+    {
+        m_dcid = header.GetSourceConnectionId();
+        m_dcidKnown = true;
+    }
+
+    uint64_t packetNumber = header.GetPacketNumber();
+    if (packetNumber < s.m_ignoreBelow || InRanges(s.m_received, packetNumber))
+    {
+        NS_LOG_LOGIC("Duplicate " << header << ", drop");
+        return;
+    }
+    NS_LOG_DEBUG("Received " << header << " size " << packet->GetSize());
+
+    m_processing = true;
+    bool ackEliciting = false;
+    while (packet->GetSize() > 0 && m_state != CLOSED)
+    {
+        QuicFrameHeader frame;
+        packet->RemoveHeader(frame);
+        NS_LOG_LOGIC("Frame " << frame);
+        switch (frame.GetFrameType())
+        {
+        case QuicFrameHeader::PADDING:
+            break;
+        case QuicFrameHeader::PING:
+            ackEliciting = true;
+            break;
+        case QuicFrameHeader::ACK:
+            ReceivedAck(space, frame);
+            break;
+        case QuicFrameHeader::CRYPTO: {
+            ackEliciting = true;
+            Ptr<Packet> data = packet->CreateFragment(0, frame.GetLength());
+            packet->RemoveAtStart(frame.GetLength());
+            Ptr<Packet> ready = s.m_cryptoRx.Receive(frame.GetOffset(), data);
+            if (ready->GetSize() > 0)
+            {
+                if (!s.m_cryptoMessage)
+                {
+                    s.m_cryptoMessage = Create<Packet>();
+                }
+                s.m_cryptoMessage->AddAtEnd(ready);
+                ProcessCryptoMessage(space);
+            }
+            break;
+        }
+        case QuicFrameHeader::STREAM: {
+            ackEliciting = true;
+            Ptr<Packet> data = packet->CreateFragment(0, frame.GetLength());
+            packet->RemoveAtStart(frame.GetLength());
+            if (space == APPLICATION_SPACE)
+            {
+                ReceivedStreamData(frame, data);
+            }
+            break;
+        }
+        case QuicFrameHeader::CONNECTION_CLOSE:
+            NS_LOG_INFO("Connection closed by the peer, error code " << frame.GetErrorCode());
+            CloseConnection(frame.GetErrorCode() != 0);
+            break;
+        case QuicFrameHeader::HANDSHAKE_DONE:
+            ackEliciting = true;
+            if (m_isClient && !m_handshakeConfirmed)
+            {
+                NS_LOG_INFO("Handshake confirmed");
+                m_handshakeConfirmed = true;
+                DiscardSpace(HANDSHAKE_SPACE);
+            }
+            break;
+        default:
+            NS_LOG_WARN("Unexpected frame " << frame);
+            break;
+        }
+    }
+    if (m_state == CLOSED)
+    {
+        m_processing = false;
+        return;
+    }
+
+    if (!s.m_discarded)
+    {
+        RecordReceived(space, packetNumber, ackEliciting);
+    }
+    if (!m_isClient && space == HANDSHAKE_SPACE)
+    {
+        // The client has the Handshake keys: the server no longer needs to
+        // send Initial packets, \RFC{9001} section 4.9.1
+        DiscardSpace(INITIAL_SPACE);
+    }
+    RestartIdleTimer();
+
+    std::vector<uint64_t> newStreams;
+    newStreams.swap(m_newStreams);
+    for (uint64_t id : newStreams)
+    {
+        if (m_listener)
+        {
+            m_listener->AcceptStream(this, id);
+        }
+        auto it = m_streams.find(id);
+        if (it != m_streams.end())
+        {
+            // Notify a FIN received before the stream was accepted
+            Deliver(id, it->second, Create<Packet>());
+        }
+    }
+    RemoveCompletedStreams();
+    m_processing = false;
+    SendPendingData();
+}
+
+void
+QuicConnection::QueueCryptoMessage(PacketNumberSpace_t space, uint32_t size)
+{
+    NS_LOG_FUNCTION(this << space << size);
+    NS_ASSERT(size >= 4);
+    // A TLS message: the length of the message, then its (random) content
+    std::vector<uint8_t> buffer(size, 0);
+    uint32_t length = size - 4;
+    buffer[0] = (length >> 24) & 0xff;
+    buffer[1] = (length >> 16) & 0xff;
+    buffer[2] = (length >> 8) & 0xff;
+    buffer[3] = length & 0xff;
+    m_spaces[space].m_cryptoTx.Write(Create<Packet>(buffer.data(), size));
+}
+
+void
+QuicConnection::ProcessCryptoMessage(PacketNumberSpace_t space)
+{
+    NS_LOG_FUNCTION(this << space);
+    Space& s = m_spaces[space];
+    while (s.m_cryptoMessage->GetSize() >= 4)
+    {
+        uint8_t buffer[4];
+        s.m_cryptoMessage->CopyData(buffer, 4);
+        uint32_t length = (static_cast<uint32_t>(buffer[0]) << 24) |
+                          (static_cast<uint32_t>(buffer[1]) << 16) |
+                          (static_cast<uint32_t>(buffer[2]) << 8) | buffer[3];
+        if (s.m_cryptoMessage->GetSize() < 4 + length)
+        {
+            return;
+        }
+        s.m_cryptoMessage->RemoveAtStart(4 + length);
+
+        if (m_isClient && space == HANDSHAKE_SPACE)
+        {
+            // Server flight complete: send Finished, the streams can be used
+            NS_LOG_INFO("Server handshake messages received");
+            QueueCryptoMessage(HANDSHAKE_SPACE, QUIC_CLIENT_FINISHED_SIZE);
+            DiscardSpace(INITIAL_SPACE);
+            HandshakeComplete();
+        }
+        else if (!m_isClient && space == INITIAL_SPACE)
+        {
+            NS_LOG_INFO("ClientHello received");
+            QueueCryptoMessage(INITIAL_SPACE, QUIC_SERVER_HELLO_SIZE);
+            QueueCryptoMessage(HANDSHAKE_SPACE, m_serverFlightSize);
+        }
+        else if (!m_isClient && space == HANDSHAKE_SPACE)
+        {
+            NS_LOG_INFO("Client Finished received, handshake confirmed");
+            HandshakeComplete();
+            m_handshakeConfirmed = true;
+            m_handshakeDonePending = true;
+            DiscardSpace(HANDSHAKE_SPACE);
+            return;
+        }
+    }
+}
+
+void
+QuicConnection::HandshakeComplete()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_state != HANDSHAKING)
+    {
+        return;
+    }
+    m_state = ESTABLISHED;
+    for (auto& [id, stream] : m_streams)
+    {
+        if (stream.m_socket)
+        {
+            stream.m_socket->ConnectionEstablished();
+        }
+    }
+}
+
+void
+QuicConnection::DiscardSpace(PacketNumberSpace_t space)
+{
+    NS_LOG_FUNCTION(this << space);
+    Space& s = m_spaces[space];
+    if (s.m_discarded)
+    {
+        return;
+    }
+    for (const auto& [packetNumber, packet] : s.m_sent)
+    {
+        if (packet.m_ackEliciting)
+        {
+            m_congestion->OnPacketDiscarded(packet.m_size);
+        }
+    }
+    s.m_sent.clear();
+    s.m_ackElicitingInFlight = 0;
+    s.m_lossTime = Seconds(0);
+    s.m_probes = 0;
+    s.m_ackNeeded = false;
+    s.m_ackImmediate = false;
+    s.m_discarded = true;
+    m_ptoCount = 0;
+    SetLossDetectionTimer();
+}
+
+void
+QuicConnection::ReceivedAck(PacketNumberSpace_t space, const QuicFrameHeader& frame)
+{
+    NS_LOG_FUNCTION(this << space << frame);
+    Space& s = m_spaces[space];
+    uint64_t largest = frame.GetLargestAcked();
+    if (largest >= s.m_nextPacketNumber)
+    {
+        NS_LOG_WARN("ACK of packet " << largest << " not sent yet");
+        return;
+    }
+    s.m_largestAcked = s.m_hasLargestAcked ? std::max(s.m_largestAcked, largest) : largest;
+    s.m_hasLargestAcked = true;
+
+    uint32_t priorInFlight = m_congestion->GetBytesInFlight();
+    std::vector<std::pair<uint64_t, SentPacket>> acked;
+    for (const auto& range : frame.GetAckRanges())
+    {
+        auto it = s.m_sent.lower_bound(range.first);
+        while (it != s.m_sent.end() && it->first <= range.second)
+        {
+            acked.emplace_back(it->first, std::move(it->second));
+            it = s.m_sent.erase(it);
+        }
+    }
+    if (acked.empty())
+    {
+        return;
+    }
+
+    // RTT sample, if the largest acknowledged packet is newly acknowledged,
+    // \RFC{9002} section 5.1
+    Time latestRtt = Seconds(0);
+    bool ackElicitingAcked = false;
+    for (const auto& [packetNumber, packet] : acked)
+    {
+        ackElicitingAcked = ackElicitingAcked || packet.m_ackEliciting;
+    }
+    if (acked.front().first <= largest && ackElicitingAcked)
+    {
+        for (const auto& [packetNumber, packet] : acked)
+        {
+            if (packetNumber == largest)
+            {
+                latestRtt = Simulator::Now() - packet.m_timeSent;
+                Time ackDelay = (space == APPLICATION_SPACE) ? MicroSeconds(frame.GetAckDelay())
+                                                             : Seconds(0);
+                UpdateRtt(latestRtt, ackDelay);
+                break;
+            }
+        }
+    }
+
+    for (auto& [packetNumber, packet] : acked)
+    {
+        if (packet.m_ackEliciting)
+        {
+            s.m_ackElicitingInFlight--;
+            m_congestion->OnPacketAcked(&packet.m_item, packet.m_timeSent);
+        }
+        OnFramesAcked(space, packet.m_frames);
+    }
+    m_congestion->OnAckProcessed(priorInFlight, latestRtt, m_minRtt);
+    DetectLostPackets(space);
+
+    m_ptoCount = 0;
+    SetLossDetectionTimer();
+}
+
+void
+QuicConnection::UpdateRtt(Time latestRtt, Time ackDelay)
+{
+    NS_LOG_FUNCTION(this << latestRtt << ackDelay);
+    m_latestRtt = latestRtt;
+    if (!m_hasRttSample)
+    {
+        m_hasRttSample = true;
+        m_firstRttSampleTime = Simulator::Now();
+        m_minRtt = latestRtt;
+        m_smoothedRtt = latestRtt;
+        m_rttVar = latestRtt / 2;
+        return;
+    }
+    m_minRtt = std::min(m_minRtt, latestRtt);
+    if (m_handshakeConfirmed)
+    {
+        ackDelay = std::min(ackDelay, m_maxAckDelay);
+    }
+    Time adjustedRtt = latestRtt;
+    if (latestRtt >= m_minRtt + ackDelay)
+    {
+        adjustedRtt = latestRtt - ackDelay;
+    }
+    m_rttVar = (m_rttVar * 3 + Abs(m_smoothedRtt - adjustedRtt)) / 4;
+    m_smoothedRtt = (m_smoothedRtt * 7 + adjustedRtt) / 8;
+}
+
+void
+QuicConnection::DetectLostPackets(PacketNumberSpace_t space)
+{
+    NS_LOG_FUNCTION(this << space);
+    Space& s = m_spaces[space];
+    s.m_lossTime = Seconds(0);
+    if (!s.m_hasLargestAcked)
+    {
+        return;
+    }
+
+    // \RFC{9002} section 6.1
+    Time lossDelay =
+        std::max(std::max(m_latestRtt, m_smoothedRtt) * 9 / 8, MilliSeconds(QUIC_GRANULARITY_MS));
+    Time lostSendTime = Simulator::Now() - lossDelay;
+    std::vector<std::pair<uint64_t, SentPacket>> lost;
+    for (auto it = s.m_sent.begin(); it != s.m_sent.end() && it->first <= s.m_largestAcked;)
+    {
+        if (it->second.m_timeSent <= lostSendTime ||
+            s.m_largestAcked >= it->first + QUIC_PACKET_THRESHOLD)
+        {
+            lost.emplace_back(it->first, std::move(it->second));
+            it = s.m_sent.erase(it);
+        }
+        else
+        {
+            Time lossTime = it->second.m_timeSent + lossDelay;
+            if (s.m_lossTime.IsZero() || lossTime < s.m_lossTime)
+            {
+                s.m_lossTime = lossTime;
+            }
+            ++it;
+        }
+    }
+    if (lost.empty())
+    {
+        return;
+    }
+
+    uint32_t lostBytes = 0;
+    Time largestLostSentTime = Seconds(0);
+    for (const auto& [packetNumber, packet] : lost)
+    {
+        if (packet.m_ackEliciting)
+        {
+            NS_LOG_INFO("Packet " << packetNumber << " of space " << space << " lost");
+            m_lostPackets++;
+            s.m_ackElicitingInFlight--;
+            lostBytes += packet.m_size;
+            largestLostSentTime = std::max(largestLostSentTime, packet.m_timeSent);
+        }
+        OnFramesLost(space, packet.m_frames);
+    }
+    if (lostBytes == 0)
+    {
+        return;
+    }
+    m_congestion->OnPacketsLost(lostBytes, largestLostSentTime);
+
+    // Persistent congestion: consecutive ack-eliciting packets, all lost,
+    // spanning more than the persistent congestion duration, \RFC{9002}
+    // section 7.6
+    if (!m_hasRttSample)
+    {
+        return;
+    }
+    Time duration =
+        (m_smoothedRtt + std::max(m_rttVar * 4, MilliSeconds(QUIC_GRANULARITY_MS)) +
+         m_maxAckDelay) *
+        QUIC_PERSISTENT_CONGESTION_THRESHOLD;
+    bool started = false;
+    Time start = Seconds(0);
+    uint64_t previous = 0;
+    for (const auto& [packetNumber, packet] : lost)
+    {
+        if (started && packetNumber != previous + 1)
+        {
+            started = false;
+        }
+        previous = packetNumber;
+        if (!packet.m_ackEliciting || packet.m_timeSent <= m_firstRttSampleTime)
+        {
+            continue;
+        }
+        if (!started)
+        {
+            started = true;
+            start = packet.m_timeSent;
+        }
+        else if (packet.m_timeSent - start >= duration)
+        {
+            NS_LOG_INFO("Persistent congestion");
+            m_congestion->OnPersistentCongestion();
+            return;
+        }
+    }
+}
+
+Time
+QuicConnection::GetPto() const
+{
+    return m_smoothedRtt + std::max(m_rttVar * 4, MilliSeconds(QUIC_GRANULARITY_MS));
+}
+
+bool
+QuicConnection::GetPtoTimeAndSpace(Time& time, PacketNumberSpace_t& space) const
+{
+    int64_t backoff = static_cast<int64_t>(1) << std::min(m_ptoCount, QUIC_MAX_PTO_BACKOFF);
+    bool found = false;
+    for (uint8_t i = INITIAL_SPACE; i < N_SPACES; i++)
+    {
+        const Space& s = m_spaces[i];
+        if (s.m_discarded || s.m_ackElicitingInFlight == 0)
+        {
+            continue;
+        }
+        Time duration = GetPto() * backoff;
+        if (i == APPLICATION_SPACE)
+        {
+            // \RFC{9002} section 6.2.1: wait for the handshake confirmation
+            if (!m_handshakeConfirmed)
+            {
+                continue;
+            }
+            duration += m_maxAckDelay * backoff;
+        }
+        Time t = s.m_timeOfLastAckEliciting + duration;
+        if (!found || t < time)
+        {
+            found = true;
+            time = t;
+            space = static_cast<PacketNumberSpace_t>(i);
+        }
+    }
+    return found;
+}
+
+void
+QuicConnection::SetLossDetectionTimer()
+{
+    m_lossDetectionTimer.Cancel();
+    if (m_state == CLOSED)
+    {
+        return;
+    }
+    Time earliest = Seconds(0);
+    for (const auto& s : m_spaces)
+    {
+        if (!s.m_lossTime.IsZero() && (earliest.IsZero() || s.m_lossTime < earliest))
+        {
+            earliest = s.m_lossTime;
+        }
+    }
+    if (earliest.IsZero())
+    {
+        PacketNumberSpace_t space;
+        if (!GetPtoTimeAndSpace(earliest, space))
+        {
+            return;
+        }
+    }
+    Time delay = std::max(earliest - Simulator::Now(), Seconds(0));
+    m_lossDetectionTimer =
+        Simulator::Schedule(delay, &QuicConnection::OnLossDetectionTimeout, this);
+}
+
+void
+QuicConnection::OnLossDetectionTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    for (uint8_t i = INITIAL_SPACE; i < N_SPACES; i++)
+    {
+        if (!m_spaces[i].m_lossTime.IsZero() && m_spaces[i].m_lossTime <= Simulator::Now())
+        {
+            DetectLostPackets(static_cast<PacketNumberSpace_t>(i));
+            SendPendingData();
+            SetLossDetectionTimer();
+            return;
+        }
+    }
+
+    Time time;
+    PacketNumberSpace_t space;
+    if (!GetPtoTimeAndSpace(time, space))
+    {
+        return;
+    }
+    NS_LOG_INFO("Probe timeout in space " << space << ", count " << m_ptoCount + 1);
+    m_ptoCount++;
+    Space& s = m_spaces[space];
+    s.m_probes = 2;
+    // Send the data of the oldest packet in flight again, \RFC{9002} section 6.2.4
+    for (const auto& [packetNumber, packet] : s.m_sent)
+    {
+        if (packet.m_ackEliciting)
+        {
+            OnFramesLost(space, packet.m_frames);
+            break;
+        }
+    }
+    SendPendingData();
+    SetLossDetectionTimer();
+}
+
+void
+QuicConnection::RecordReceived(PacketNumberSpace_t space, uint64_t packetNumber, bool ackEliciting)
+{
+    NS_LOG_FUNCTION(this << space << packetNumber << ackEliciting);
+    Space& s = m_spaces[space];
+    bool inOrder = s.m_received.empty() || packetNumber == std::prev(s.m_received.end())->second;
+    if (s.m_received.empty() || packetNumber >= std::prev(s.m_received.end())->second)
+    {
+        s.m_largestReceivedTime = Simulator::Now();
+    }
+    AddRange(s.m_received, packetNumber, packetNumber + 1);
+    while (s.m_received.size() > QUIC_MAX_ACK_RANGES)
+    {
+        s.m_ignoreBelow = s.m_received.begin()->second;
+        s.m_received.erase(s.m_received.begin());
+    }
+
+    if (!ackEliciting)
+    {
+        return;
+    }
+    s.m_ackNeeded = true;
+    s.m_ackElicitingReceived++;
+    // \RFC{9000} section 13.2.1: acknowledge the handshake packets, the
+    // packets received out of order and every other packet immediately
+    if (space != APPLICATION_SPACE || !inOrder || s.m_ackElicitingReceived >= QUIC_ACK_FREQUENCY)
+    {
+        s.m_ackImmediate = true;
+        if (space == APPLICATION_SPACE)
+        {
+            m_ackTimer.Cancel();
+        }
+    }
+    else if (!m_ackTimer.IsRunning())
+    {
+        m_ackTimer = Simulator::Schedule(m_maxAckDelay, &QuicConnection::AckTimeout, this);
+    }
+}
+
+void
+QuicConnection::AckTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    Space& s = m_spaces[APPLICATION_SPACE];
+    if (s.m_ackNeeded)
+    {
+        s.m_ackImmediate = true;
+        SendPendingData();
+    }
+}
+
+void
+QuicConnection::ReceivedStreamData(const QuicFrameHeader& frame, Ptr<Packet> data)
+{
+    NS_LOG_FUNCTION(this << frame << data);
+    uint64_t id = frame.GetStreamId();
+    auto it = m_streams.find(id);
+    if (it == m_streams.end())
+    {
+        if (!IsPeerStream(id) || id < m_nextPeerStreamId)
+        {
+            NS_LOG_LOGIC("Data of closed or invalid stream " << id << ", drop");
+            return;
+        }
+        // Opening a stream opens the streams with lower IDs, \RFC{9000} section 3.2
+        for (uint64_t newId = m_nextPeerStreamId; newId <= id; newId += 4)
+        {
+            NS_LOG_INFO("Stream " << newId << " opened by the peer");
+            m_streams[newId];
+            m_newStreams.push_back(newId);
+        }
+        m_nextPeerStreamId = id + 4;
+        it = m_streams.find(id);
+    }
+    Stream& stream = it->second;
+    if (frame.IsFin())
+    {
+        stream.m_rx.m_finReceived = true;
+        stream.m_rx.m_finalSize = frame.GetOffset() + frame.GetLength();
+    }
+    Deliver(id, stream, stream.m_rx.Receive(frame.GetOffset(), data));
+}
+
+void
+QuicConnection::Deliver(uint64_t id, Stream& stream, Ptr<Packet> data)
+{
+    NS_LOG_FUNCTION(this << id << data);
+    if (data->GetSize() > 0)
+    {
+        if (stream.m_socket)
+        {
+            stream.m_socket->StreamDataReceived(data);
+        }
+        else if (!stream.m_detached)
+        {
+            if (!stream.m_rxPending)
+            {
+                stream.m_rxPending = Create<Packet>();
+            }
+            stream.m_rxPending->AddAtEnd(data);
+        }
+    }
+    if (stream.m_rx.IsComplete() && !stream.m_finNotified && stream.m_socket)
+    {
+        stream.m_finNotified = true;
+        stream.m_socket->StreamFinReceived();
+    }
+}
+
+uint64_t
+QuicConnection::OpenStream(Ptr<QuicSocket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    uint64_t id = m_nextLocalStreamId;
+    m_nextLocalStreamId += 4;
+    m_streams[id].m_socket = socket;
+    NS_LOG_INFO("Stream " << id << " opened");
+    return id;
+}
+
+void
+QuicConnection::AttachStream(uint64_t id, Ptr<QuicSocket> socket)
+{
+    NS_LOG_FUNCTION(this << id << socket);
+    auto it = m_streams.find(id);
+    NS_ASSERT_MSG(it != m_streams.end(), "Unknown stream " << id);
+    it->second.m_socket = socket;
+    if (it->second.m_rxPending)
+    {
+        Ptr<Packet> pending = it->second.m_rxPending;
+        it->second.m_rxPending = nullptr;
+        socket->StreamDataReceived(pending);
+    }
+}
+
+void
+QuicConnection::DetachStream(uint64_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto it = m_streams.find(id);
+    if (it != m_streams.end())
+    {
+        it->second.m_socket = nullptr;
+        it->second.m_rxPending = nullptr;
+        it->second.m_detached = true;
+    }
+}
+
+void
+QuicConnection::Send(uint64_t id, Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << id << packet);
+    auto it = m_streams.find(id);
+    if (it == m_streams.end())
+    {
+        NS_LOG_WARN("Send on closed stream " << id);
+        return;
+    }
+    it->second.m_tx.Write(packet);
+    SendPendingData();
+}
+
+void
+QuicConnection::ShutdownSend(uint64_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto it = m_streams.find(id);
+    if (it == m_streams.end() || it->second.m_tx.m_fin)
+    {
+        return;
+    }
+    it->second.m_tx.m_fin = true;
+    SendPendingData();
+}
+
+uint32_t
+QuicConnection::GetTxBuffered(uint64_t id) const
+{
+    auto it = m_streams.find(id);
+    if (it == m_streams.end())
+    {
+        return 0;
+    }
+    return it->second.m_tx.GetEnd() - it->second.m_tx.m_ackedOffset;
+}
+
+bool
+QuicConnection::HasStreamData() const
+{
+    for (const auto& [id, stream] : m_streams)
+    {
+        if (stream.m_tx.HasPending())
+        {
+            return true;
+        }
+    }
+    return false;
+}
+
+void
+QuicConnection::SendPendingData()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_processing || m_state == IDLE || m_state == CLOSED)
+    {
+        return;
+    }
+    for (uint8_t i = INITIAL_SPACE; i < N_SPACES; i++)
+    {
+        while (SendPacket(static_cast<PacketNumberSpace_t>(i)))
+        {
+        }
+    }
+    if (m_state == ESTABLISHED && !HasStreamData())
+    {
+        m_congestion->OnAppLimited();
+    }
+    SetLossDetectionTimer();
+}
+
+bool
+QuicConnection::SendPacket(PacketNumberSpace_t space)
+{
+    Space& s = m_spaces[space];
+    if (s.m_discarded || (space == APPLICATION_SPACE && m_state != ESTABLISHED))
+    {
+        return false;
+    }
+    Time now = Simulator::Now();
+    bool probe = s.m_probes > 0;
+    bool hasData = s.m_cryptoTx.HasPending() ||
+                   (space == APPLICATION_SPACE && (m_handshakeDonePending || HasStreamData()));
+    bool sendData = hasData && (probe || m_congestion->CanSend());
+    if (sendData && !probe && m_nextSendTime > now)
+    {
+        // Paced: come back later, an ACK can still be sent now
+        if (!m_sendEvent.IsRunning())
+        {
+            m_sendEvent = Simulator::Schedule(m_nextSendTime - now,
+                                              &QuicConnection::SendPendingData,
+                                              this);
+        }
+        sendData = false;
+    }
+    if (!sendData && !probe && !s.m_ackImmediate)
+    {
+        return false;
+    }
+
+    QuicHeader header;
+    header.SetPacketType(space == INITIAL_SPACE     ? QuicHeader::INITIAL
+                         : space == HANDSHAKE_SPACE ? QuicHeader::HANDSHAKE
+                                                    : QuicHeader::ONE_RTT);
+    header.SetVersion(QUIC_VERSION);
+    header.SetDestinationConnectionId(m_dcid);
+    header.SetSourceConnectionId(m_scid);
+    header.SetPacketNumber(s.m_nextPacketNumber);
+    uint32_t remaining = m_maxPacketSize - header.GetSerializedSize();
+
+    Ptr<Packet> payload = Create<Packet>();
+    SentPacket sent;
+    bool ackEliciting = false;
+
+    if (s.m_ackNeeded && !s.m_received.empty())
+    {
+        std::vector<QuicFrameHeader::AckRange> ranges;
+        for (auto it = s.m_received.rbegin(); it != s.m_received.rend(); ++it)
+        {
+            ranges.emplace_back(it->first, it->second - 1);
+        }
+        QuicFrameHeader ack;
+        ack.SetFrameType(QuicFrameHeader::ACK);
+        ack.SetAckRanges(ranges);
+        if (space == APPLICATION_SPACE)
+        {
+            ack.SetAckDelay((now - s.m_largestReceivedTime).GetMicroSeconds());
+            m_ackTimer.Cancel();
+        }
+        AddFrame(payload, ack, nullptr);
+        remaining -= ack.GetSerializedSize();
+        sent.m_frames.push_back({QuicFrameHeader::ACK, 0, 0, ack.GetLargestAcked(), false});
+        s.m_ackNeeded = false;
+        s.m_ackImmediate = false;
+        s.m_ackElicitingReceived = 0;
+    }
+
+    if (sendData || probe)
+    {
+        if (space == APPLICATION_SPACE && m_handshakeDonePending)
+        {
+            QuicFrameHeader done;
+            done.SetFrameType(QuicFrameHeader::HANDSHAKE_DONE);
+            AddFrame(payload, done, nullptr);
+            remaining -= done.GetSerializedSize();
+            sent.m_frames.push_back({QuicFrameHeader::HANDSHAKE_DONE, 0, 0, 0, false});
+            m_handshakeDonePending = false;
+            ackEliciting = true;
+        }
+
+        while (s.m_cryptoTx.HasPending())
+        {
+            uint32_t overhead = 1 + QuicHeader::GetVarIntSize(s.m_cryptoTx.GetNextOffset()) + 2;
+            if (remaining <= overhead)
+            {
+                break;
+            }
+            uint64_t offset = 0;
+            bool fin = false;
+            Ptr<Packet> data = s.m_cryptoTx.Next(remaining - overhead, offset, fin);
+            QuicFrameHeader crypto;
+            crypto.SetFrameType(QuicFrameHeader::CRYPTO);
+            crypto.SetOffset(offset);
+            crypto.SetLength(data->GetSize());
+            AddFrame(payload, crypto, data);
+            remaining -= crypto.GetSerializedSize() + data->GetSize();
+            sent.m_frames.push_back(
+                {QuicFrameHeader::CRYPTO, 0, offset, data->GetSize(), false});
+            ackEliciting = true;
+        }
+
+        if (space == APPLICATION_SPACE && !m_streams.empty())
+        {
+            // Round-robin over the streams, starting after the last one served
+            std::vector<uint64_t> order;
+            for (auto it = m_streams.lower_bound(m_nextStream); it != m_streams.end(); ++it)
+            {
+                order.push_back(it->first);
+            }
+            for (auto it = m_streams.begin(); it != m_streams.lower_bound(m_nextStream); ++it)
+            {
+                order.push_back(it->first);
+            }
+            for (uint64_t id : order)
+            {
+                SendBuffer& tx = m_streams[id].m_tx;
+                if (!tx.HasPending())
+                {
+                    continue;
+                }
+                uint32_t overhead = 1 + QuicHeader::GetVarIntSize(id) +
+                                    QuicHeader::GetVarIntSize(tx.GetNextOffset()) + 2;
+                if (remaining <= overhead)
+                {
+                    break;
+                }
+                uint64_t offset = 0;
+                bool fin = false;
+                Ptr<Packet> data = tx.Next(remaining - overhead, offset, fin);
+                QuicFrameHeader stream;
+                stream.SetFrameType(QuicFrameHeader::STREAM);
+                stream.SetStreamId(id);
+                stream.SetOffset(offset);
+                stream.SetLength(data->GetSize());
+                stream.SetFin(fin);
+                AddFrame(payload, stream, data);
+                remaining -= stream.GetSerializedSize() + data->GetSize();
+                sent.m_frames.push_back({QuicFrameHeader::STREAM, id, offset, data->GetSize(), fin});
+                ackEliciting = true;
+                m_nextStream = id + 1;
+            }
+        }
+
+        if (probe && !ackEliciting)
+        {
+            QuicFrameHeader ping;
+            ping.SetFrameType(QuicFrameHeader::PING);
+            AddFrame(payload, ping, nullptr);
+            sent.m_frames.push_back({QuicFrameHeader::PING, 0, 0, 0, false});
+            ackEliciting = true;
+        }
+    }
+    if (payload->GetSize() == 0)
+    {
+        return false;
+    }
+
+    if (space == INITIAL_SPACE && ackEliciting &&
+        header.GetSerializedSize() + payload->GetSize() < QUIC_MIN_INITIAL_SIZE)
+    {
+        QuicFrameHeader padding;
+        padding.SetFrameType(QuicFrameHeader::PADDING);
+        padding.SetLength(QUIC_MIN_INITIAL_SIZE - header.GetSerializedSize() - payload->GetSize());
+        AddFrame(payload, padding, nullptr);
+    }
+
+    uint64_t packetNumber = s.m_nextPacketNumber++;
+    payload->AddHeader(header);
+    uint32_t size = payload->GetSize();
+    sent.m_timeSent = now;
+    sent.m_size = size;
+    sent.m_ackEliciting = ackEliciting;
+    SentPacket& stored = s.m_sent[packetNumber];
+    stored = std::move(sent);
+    if (ackEliciting)
+    {
+        s.m_ackElicitingInFlight++;
+        s.m_timeOfLastAckEliciting = now;
+        m_congestion->OnPacketSent(&stored.m_item, size);
+        m_nextSendTime = now + m_congestion->GetPacingDelay(size);
+        if (probe)
+        {
+            s.m_probes--;
+        }
+    }
+    NS_LOG_DEBUG("Send " << header << " size " << size << " cwnd "
+                         << m_congestion->GetCongestionWindow() << " inflight "
+                         << m_congestion->GetBytesInFlight());
+    m_txTrace(payload);
+    m_udp->SendTo(payload, 0, m_peer);
+    return true;
+}
+
+void
+QuicConnection::OnFramesAcked(PacketNumberSpace_t space, const std::vector<SentFrame>& frames)
+{
+    Space& s = m_spaces[space];
+    for (const auto& frame : frames)
+    {
+        switch (frame.m_type)
+        {
+        case QuicFrameHeader::CRYPTO:
+            s.m_cryptoTx.Acked(frame.m_offset, frame.m_length, false);
+            break;
+        case QuicFrameHeader::STREAM: {
+            auto it = m_streams.find(frame.m_streamId);
+            if (it != m_streams.end())
+            {
+                it->second.m_tx.Acked(frame.m_offset, frame.m_length, frame.m_fin);
+                if (it->second.m_socket)
+                {
+                    it->second.m_socket->StreamDataAcked();
+                }
+            }
+            break;
+        }
+        case QuicFrameHeader::ACK:
+            // The peer knows that the packets up to the largest acknowledged
+            // one were received: stop acknowledging them, \RFC{9000} section 13.2.4
+            while (!s.m_received.empty() && s.m_received.begin()->second <= frame.m_length)
+            {
+                s.m_ignoreBelow = std::max(s.m_ignoreBelow, s.m_received.begin()->second);
+                s.m_received.erase(s.m_received.begin());
+            }
+            break;
+        default:
+            break;
+        }
+    }
+}
+
+void
+QuicConnection::OnFramesLost(PacketNumberSpace_t space, const std::vector<SentFrame>& frames)
+{
+    Space& s = m_spaces[space];
+    for (const auto& frame : frames)
+    {
+        switch (frame.m_type)
+        {
+        case QuicFrameHeader::CRYPTO:
+            s.m_cryptoTx.Lost(frame.m_offset, frame.m_length, false);
+            break;
+        case QuicFrameHeader::STREAM: {
+            auto it = m_streams.find(frame.m_streamId);
+            if (it != m_streams.end())
+            {
+                it->second.m_tx.Lost(frame.m_offset, frame.m_length, frame.m_fin);
+            }
+            break;
+        }
+        case QuicFrameHeader::HANDSHAKE_DONE:
+            m_handshakeDonePending = true;
+            break;
+        default:
+            // ACK and PING frames are not retransmitted
+            break;
+        }
+    }
+}
+
+void
+QuicConnection::RemoveCompletedStreams()
+{
+    for (auto it = m_streams.begin(); it != m_streams.end();)
+    {
+        const Stream& stream = it->second;
+        if (stream.m_tx.IsComplete() && stream.m_rx.IsComplete() &&
+            (stream.m_finNotified || stream.m_detached))
+        {
+            NS_LOG_INFO("Stream " << it->first << " complete");
+            it = m_streams.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void
+QuicConnection::RestartIdleTimer()
+{
+    if (!m_idleTimeout.IsStrictlyPositive())
+    {
+        return;
+    }
+    m_idleTimer.Cancel();
+    m_idleTimer = Simulator::Schedule(std::max(m_idleTimeout, GetPto() * 3),
+                                      &QuicConnection::IdleTimeout,
+                                      this);
+}
+
+void
+QuicConnection::IdleTimeout()
+{
+    NS_LOG_FUNCTION(this);
+    NS_LOG_INFO("Idle timeout");
+    CloseConnection(!m_streams.empty());
+}
+
+void
+QuicConnection::CloseConnection(bool error)
+{
+    NS_LOG_FUNCTION(this << error);
+    if (m_state == CLOSED)
+    {
+        return;
+    }
+    Ptr<QuicConnection> self = this;
+    m_state = CLOSED;
+    m_lossDetectionTimer.Cancel();
+    m_ackTimer.Cancel();
+    m_sendEvent.Cancel();
+    m_idleTimer.Cancel();
+    std::map<uint64_t, Stream> streams;
+    streams.swap(m_streams);
+    for (auto& [id, stream] : streams)
+    {
+        if (stream.m_socket)
+        {
+            stream.m_socket->ConnectionClosed(error);
+        }
+    }
+    if (m_listener)
+    {
+        m_listener->RemoveConnection(this);
+    }
+    if (m_factory)
+    {
+        m_factory->RemoveConnection(this);
+    }
+    if (m_isClient && m_udp)
+    {
+        m_udp->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        m_udp->Close();
+    }
+}
+
+bool
+QuicConnection::IsPeerStream(uint64_t id) const
+{
+    // Bidirectional streams: the client opens the IDs 0 mod 4, the server
+    // the IDs 1 mod 4, \RFC{9000} section 2.1
+    return (id % 4) == (m_isClient ? 1 : 0);
+}
+
+QuicConnection::State_t
+QuicConnection::GetState() const
+{
+    return m_state;
+}
+
+bool
+QuicConnection::IsClient() const
+{
+    return m_isClient;
+}
+
+bool
+QuicConnection::IsHandshakeConfirmed() const
+{
+    return m_handshakeConfirmed;
+}
+
+const Address&
+QuicConnection::GetPeerAddress() const
+{
+    return m_peer;
+}
+
+int
+QuicConnection::GetSockName(Address& address) const
+{
+    if (!m_udp)
+    {
+        return -1;
+    }
+    return m_udp->GetSockName(address);
+}
+
+uint64_t
+QuicConnection::GetSourceConnectionId() const
+{
+    return m_scid;
+}
+
+uint64_t
+QuicConnection::GetDestinationConnectionId() const
+{
+    return m_dcid;
+}
+
+Ptr<QuicCongestionControl>
+QuicConnection::GetCongestionControl() const
+{
+    return m_congestion;
+}
+
+Time
+QuicConnection::GetSmoothedRtt() const
+{
+    return m_smoothedRtt;
+}
+
+Time
+QuicConnection::GetMinRtt() const
+{
+    return m_minRtt;
+}
+
+uint64_t
+QuicConnection::GetLostPackets() const
+{
+    return m_lostPackets;
+}
+
+uint32_t
+QuicConnection::GetNStreams() const
+{
+    return m_streams.size();
+}
+
+int64_t
+QuicConnection::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_rng->SetStream(stream);
+    return 1;
+}
+
+} // namespace ns3
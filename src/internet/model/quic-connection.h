@@ -0,0 +1,619 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUIC_CONNECTION_H
+#define QUIC_CONNECTION_H
+
+#include "quic-header.h"
+#include "tcp-tx-item.h"
+
+#include "ns3/address.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+#include "ns3/traced-callback.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+class Node;
+class Packet;
+class QuicCongestionControl;
+class QuicSocket;
+class QuicSocketFactory;
+class Socket;
+class UniformRandomVariable;
+
+/**
+ * \ingroup quic
+ * \brief A QUIC connection, \RFC{9000}
+ *
+ * A connection carries the streams of an application between two hosts
+ * over a single UDP socket. It performs the handshake, numbers the packets
+ * in three packet number spaces (Initial, Handshake and application data),
+ * acknowledges the received packets with ACK frames, and detects the lost
+ * packets as specified in \RFC{9002}: a packet is declared lost when a
+ * packet sent three packet numbers later has been acknowledged, or when it
+ * was sent more than 9/8 RTT before the largest acknowledged packet; a
+ * probe timeout (PTO), backed off exponentially, triggers the
+ * retransmission of the oldest data when acknowledgments stop coming. The
+ * frames of a lost packet are sent again in new packets. The congestion
+ * window and the pacing rate are managed by a QuicCongestionControl driving
+ * a TCP congestion control algorithm.
+ *
+ * The streams are bidirectional and opened by the client. Each stream is
+ * exposed to the application as a QuicSocket. The data of the streams with
+ * pending data are multiplexed in the packets in a round-robin fashion, and
+ * the data received on a stream is delivered as soon as it is in order,
+ * regardless of the losses affecting the other streams.
+ *
+ * The packets are not encrypted. The TLS handshake is modeled by the
+ * exchange of CRYPTO frames of realistic sizes: the client sends its
+ * ClientHello in an Initial packet, padded to 1200 bytes; the server
+ * answers with its ServerHello in an Initial packet and with the rest of
+ * its first flight in Handshake packets; the client then sends its Finished
+ * message in a Handshake packet and may start sending on its streams. The
+ * server confirms the handshake with a HANDSHAKE_DONE frame. Flow control,
+ * connection migration, 0-RTT and the anti-amplification limit are not
+ * modeled.
+ */
+class QuicConnection : public Object
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QuicConnection();
+    ~QuicConnection() override;
+
+    /// Packet number spaces, \RFC{9000} section 12.3
+    enum PacketNumberSpace_t
+    {
+        INITIAL_SPACE = 0, //!< Initial packets
+        HANDSHAKE_SPACE,   //!< Handshake packets
+        APPLICATION_SPACE, //!< 1-RTT packets
+        N_SPACES           //!< Number of packet number spaces
+    };
+
+    /// State of a connection
+    enum State_t
+    {
+        IDLE,        //!< Not opened yet
+        HANDSHAKING, //!< Handshake in progress
+        ESTABLISHED, //!< Handshake complete, the streams can be used
+        CLOSED       //!< Connection closed
+    };
+
+    /**
+     * \brief Set the associated node
+     * \param node the node
+     */
+    void SetNode(Ptr<Node> node);
+
+    /**
+     * \brief Set the factory keeping track of the connections of the node
+     * \param factory the factory
+     */
+    void SetFactory(Ptr<QuicSocketFactory> factory);
+
+    /**
+     * \brief Open the connection as a client
+     * \param local the local address to bind to
+     * \param peer the address of the server
+     * \return 0 on success, -1 on failure
+     */
+    int Connect(const Address& local, const Address& peer);
+
+    /**
+     * \brief Open the connection as a server, upon reception of the first
+     *        Initial packet of a client
+     * \param listener the listening socket, which accepts the streams
+     * \param udp the UDP socket of the listening socket
+     * \param peer the address of the client
+     */
+    void Accept(Ptr<QuicSocket> listener, Ptr<Socket> udp, const Address& peer);
+
+    /**
+     * \brief Process a packet received from the peer
+     * \param packet the UDP payload
+     * \param from the address of the peer
+     */
+    void Receive(Ptr<Packet> packet, const Address& from);
+
+    /**
+     * \brief Open a new stream, initiated by this end
+     * \param socket the socket of the stream
+     * \return the stream ID
+     */
+    uint64_t OpenStream(Ptr<QuicSocket> socket);
+
+    /**
+     * \brief Attach the socket of a stream opened by the peer
+     * \param id the stream ID
+     * \param socket the socket
+     */
+    void AttachStream(uint64_t id, Ptr<QuicSocket> socket);
+
+    /**
+     * \brief Detach the socket of a stream, discarding the data received later
+     * \param id the stream ID
+     */
+    void DetachStream(uint64_t id);
+
+    /**
+     * \brief Queue data on a stream
+     * \param id the stream ID
+     * \param packet the data
+     */
+    void Send(uint64_t id, Ptr<Packet> packet);
+
+    /**
+     * \brief Close the sending direction of a stream
+     * \param id the stream ID
+     */
+    void ShutdownSend(uint64_t id);
+
+    /**
+     * \brief Get the data of a stream not acknowledged yet
+     * \param id the stream ID
+     * \return the number of bytes queued on the stream and not acknowledged
+     */
+    uint32_t GetTxBuffered(uint64_t id) const;
+
+    /**
+     * \return the state of the connection
+     */
+    State_t GetState() const;
+
+    /**
+     * \return true if this end opened the connection
+     */
+    bool IsClient() const;
+
+    /**
+     * \return true if the handshake is confirmed, \RFC{9001} section 4.1.2
+     */
+    bool IsHandshakeConfirmed() const;
+
+    /**
+     * \return the address of the peer
+     */
+    const Address& GetPeerAddress() const;
+
+    /**
+     * \brief Get the local address of the connection
+     * \param address the address
+     * \return 0 on success, -1 on failure
+     */
+    int GetSockName(Address& address) const;
+
+    /**
+     * \return the connection ID chosen by this end
+     */
+    uint64_t GetSourceConnectionId() const;
+
+    /**
+     * \return the connection ID chosen by the peer
+     */
+    uint64_t GetDestinationConnectionId() const;
+
+    /**
+     * \return the congestion controller of the connection
+     */
+    Ptr<QuicCongestionControl> GetCongestionControl() const;
+
+    /**
+     * \return the smoothed RTT
+     */
+    Time GetSmoothedRtt() const;
+
+    /**
+     * \return the minimum RTT
+     */
+    Time GetMinRtt() const;
+
+    /**
+     * \return the number of packets declared lost
+     */
+    uint64_t GetLostPackets() const;
+
+    /**
+     * \return the number of streams in use
+     */
+    uint32_t GetNStreams() const;
+
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// Map of byte ranges, from the start offset to the end offset
+    typedef std::map<uint64_t, uint64_t> RangeMap;
+
+    /// Send side of a stream, or of the CRYPTO data of a packet number space
+    struct SendBuffer
+    {
+        /**
+         * \brief Queue data
+         * \param packet the data
+         */
+        void Write(Ptr<Packet> packet);
+        /**
+         * \return the offset following the last byte queued
+         */
+        uint64_t GetEnd() const;
+        /**
+         * \return true if there is data, or a FIN, to send or to retransmit
+         */
+        bool HasPending() const;
+        /**
+         * \return the offset of the next data to send
+         */
+        uint64_t GetNextOffset() const;
+        /**
+         * \brief Take the next data to send, retransmissions first
+         * \param maxLength the maximum length of the data
+         * \param offset the offset of the data
+         * \param fin whether the data reaches the end of the stream
+         * \return the data, or nullptr if there is nothing to send
+         */
+        Ptr<Packet> Next(uint32_t maxLength, uint64_t& offset, bool& fin);
+        /**
+         * \brief Record the acknowledgment of data
+         * \param offset the offset of the data
+         * \param length the length of the data
+         * \param fin whether the data reached the end of the stream
+         */
+        void Acked(uint64_t offset, uint64_t length, bool fin);
+        /**
+         * \brief Queue data for retransmission
+         * \param offset the offset of the data
+         * \param length the length of the data
+         * \param fin whether the data reached the end of the stream
+         */
+        void Lost(uint64_t offset, uint64_t length, bool fin);
+        /**
+         * \return true if the end of the stream has been acknowledged
+         */
+        bool IsComplete() const;
+
+        Ptr<Packet> m_data;      //!< Data from m_ackedOffset to the end
+        uint64_t m_ackedOffset{0}; //!< Offset below which all data is acknowledged
+        uint64_t m_sentOffset{0};  //!< Offset following the last byte sent
+        RangeMap m_acked;        //!< Ranges acknowledged above m_ackedOffset
+        RangeMap m_lost;         //!< Ranges to retransmit
+        bool m_fin{false};       //!< Whether the end of the stream is known
+        bool m_finSent{false};   //!< Whether the FIN is in flight or acknowledged
+        bool m_finAcked{false};  //!< Whether the FIN is acknowledged
+    };
+
+    /// Receive side of a stream, or of the CRYPTO data of a packet number space
+    struct RecvBuffer
+    {
+        /**
+         * \brief Store received data
+         * \param offset the offset of the data
+         * \param packet the data
+         * \return the data that became in order, possibly empty
+         */
+        Ptr<Packet> Receive(uint64_t offset, Ptr<Packet> packet);
+        /**
+         * \return true if all the data up to the end of the stream was received
+         */
+        bool IsComplete() const;
+
+        uint64_t m_offset{0};                         //!< Offset of the next byte in order
+        std::map<uint64_t, Ptr<Packet>> m_outOfOrder; //!< Data received out of order
+        bool m_finReceived{false};                    //!< Whether the final size is known
+        uint64_t m_finalSize{0};                      //!< Final size of the stream
+    };
+
+    /// A stream
+    struct Stream
+    {
+        SendBuffer m_tx;          //!< Send side
+        RecvBuffer m_rx;          //!< Receive side
+        Ptr<QuicSocket> m_socket; //!< Socket of the stream
+        Ptr<Packet> m_rxPending;  //!< Data received before the socket is attached
+        bool m_detached{false};   //!< Whether the socket was detached
+        bool m_finNotified{false}; //!< Whether the end of the stream was notified
+    };
+
+    /// A frame sent, kept until acknowledged or lost
+    struct SentFrame
+    {
+        QuicFrameHeader::FrameType_t m_type; //!< Type of the frame
+        uint64_t m_streamId;                 //!< Stream ID (STREAM)
+        uint64_t m_offset;                   //!< Offset of the data (STREAM, CRYPTO)
+        uint64_t m_length;                   //!< Length of the data, or largest acknowledged (ACK)
+        bool m_fin;                          //!< FIN bit (STREAM)
+    };
+
+    /// A packet sent, kept until acknowledged or lost
+    struct SentPacket
+    {
+        Time m_timeSent;                 //!< Time the packet was sent
+        uint32_t m_size{0};              //!< Size of the UDP payload
+        bool m_ackEliciting{false};      //!< Whether the packet is ack-eliciting (and in flight)
+        std::vector<SentFrame> m_frames; //!< Frames of the packet
+        TcpTxItem m_item;                //!< Item for the delivery rate estimation
+    };
+
+    /// State of a packet number space
+    struct Space
+    {
+        uint64_t m_nextPacketNumber{0};           //!< Next packet number to send
+        std::map<uint64_t, SentPacket> m_sent;    //!< Packets sent, not acked nor lost
+        bool m_hasLargestAcked{false};            //!< Whether a packet was acknowledged
+        uint64_t m_largestAcked{0};               //!< Largest acknowledged packet number
+        Time m_lossTime;                          //!< Time to declare the next packet lost
+        Time m_timeOfLastAckEliciting;            //!< Time of the last ack-eliciting packet
+        uint32_t m_ackElicitingInFlight{0};       //!< Number of ack-eliciting packets in flight
+        uint32_t m_probes{0};                     //!< Number of probes to send
+        RangeMap m_received;                      //!< Packet numbers received, as ranges
+        uint64_t m_ignoreBelow{0};                //!< Packet numbers no longer tracked
+        Time m_largestReceivedTime;               //!< Time the largest packet was received
+        bool m_ackNeeded{false};                  //!< Whether an ACK frame should be sent
+        bool m_ackImmediate{false};               //!< Whether the ACK frame must be sent now
+        uint32_t m_ackElicitingReceived{0};       //!< Ack-eliciting packets not acked yet
+        SendBuffer m_cryptoTx;                    //!< CRYPTO data to send
+        RecvBuffer m_cryptoRx;                    //!< CRYPTO data received
+        Ptr<Packet> m_cryptoMessage;              //!< CRYPTO data in order, not processed
+        bool m_discarded{false};                  //!< Whether the keys were discarded
+    };
+
+    /**
+     * \brief Finish the configuration of a connection and generate its ID
+     */
+    void Setup();
+
+    /**
+     * \brief Callback of the UDP socket of a client connection
+     * \param socket the UDP socket
+     */
+    void ReceivedData(Ptr<Socket> socket);
+
+    /**
+     * \brief Queue a handshake message in the CRYPTO data of a space
+     * \param space the packet number space
+     * \param size the size of the message, including its 4 bytes length
+     */
+    void QueueCryptoMessage(PacketNumberSpace_t space, uint32_t size);
+
+    /**
+     * \brief Process the handshake message received in a space
+     * \param space the packet number space
+     */
+    void ProcessCryptoMessage(PacketNumberSpace_t space);
+
+    /**
+     * \brief Move to the ESTABLISHED state and notify the sockets
+     */
+    void HandshakeComplete();
+
+    /**
+     * \brief Discard the keys and the packets of a packet number space
+     * \param space the packet number space
+     */
+    void DiscardSpace(PacketNumberSpace_t space);
+
+    /**
+     * \brief Process an ACK frame, \RFC{9002} section A.7
+     * \param space the packet number space
+     * \param frame the ACK frame
+     */
+    void ReceivedAck(PacketNumberSpace_t space, const QuicFrameHeader& frame);
+
+    /**
+     * \brief Process the data of a STREAM frame
+     * \param frame the frame
+     * \param data the data
+     */
+    void ReceivedStreamData(const QuicFrameHeader& frame, Ptr<Packet> data);
+
+    /**
+     * \brief Deliver the data in order of a stream to its socket
+     * \param id the stream ID
+     * \param stream the stream
+     * \param data the data in order
+     */
+    void Deliver(uint64_t id, Stream& stream, Ptr<Packet> data);
+
+    /**
+     * \brief Record the reception of a packet number
+     * \param space the packet number space
+     * \param packetNumber the packet number
+     * \param ackEliciting whether the packet is ack-eliciting
+     */
+    void RecordReceived(PacketNumberSpace_t space, uint64_t packetNumber, bool ackEliciting);
+
+    /**
+     * \brief Send the ACK frame of the application data space, upon
+     *        expiration of the delayed ACK timer
+     */
+    void AckTimeout();
+
+    /**
+     * \brief Send as many packets as allowed by the congestion window and
+     *        the pacing rate
+     */
+    void SendPendingData();
+
+    /**
+     * \brief Build and send a packet
+     * \param space the packet number space
+     * \return true if a packet was sent
+     */
+    bool SendPacket(PacketNumberSpace_t space);
+
+    /**
+     * \brief Get the frames of a packet acknowledged by the peer
+     * \param space the packet number space
+     * \param frames the frames
+     */
+    void OnFramesAcked(PacketNumberSpace_t space, const std::vector<SentFrame>& frames);
+
+    /**
+     * \brief Queue the frames of a packet for retransmission
+     * \param space the packet number space
+     * \param frames the frames
+     */
+    void OnFramesLost(PacketNumberSpace_t space, const std::vector<SentFrame>& frames);
+
+    /**
+     * \brief Update the RTT estimation, \RFC{9002} section 5
+     * \param latestRtt the latest RTT sample
+     * \param ackDelay the ACK delay reported by the peer
+     */
+    void UpdateRtt(Time latestRtt, Time ackDelay);
+
+    /**
+     * \brief Declare lost the packets meeting the packet or the time
+     *        threshold, \RFC{9002} section A.10
+     * \param space the packet number space
+     */
+    void DetectLostPackets(PacketNumberSpace_t space);
+
+    /**
+     * \brief Get the duration of a probe timeout, without backoff
+     * \return the probe timeout
+     */
+    Time GetPto() const;
+
+    /**
+     * \brief Get the earliest probe timeout of the packet number spaces
+     * \param time the time of the probe timeout
+     * \param space the packet number space
+     * \return false if no probe timeout is armed
+     */
+    bool GetPtoTimeAndSpace(Time& time, PacketNumberSpace_t& space) const;
+
+    /**
+     * \brief Arm the loss detection timer, \RFC{9002} section A.8
+     */
+    void SetLossDetectionTimer();
+
+    /**
+     * \brief Handle the expiration of the loss detection timer, \RFC{9002} section A.9
+     */
+    void OnLossDetectionTimeout();
+
+    /**
+     * \brief Restart the idle timer
+     */
+    void RestartIdleTimer();
+
+    /**
+     * \brief Close the connection after the idle timeout
+     */
+    void IdleTimeout();
+
+    /**
+     * \brief Close the connection and notify the sockets of the streams
+     * \param error whether the connection is closed on error
+     */
+    void CloseConnection(bool error);
+
+    /**
+     * \brief Remove the streams whose both directions are complete
+     */
+    void RemoveCompletedStreams();
+
+    /**
+     * \return true if a stream has data, or a FIN, to send
+     */
+    bool HasStreamData() const;
+
+    /**
+     * \param id a stream ID
+     * \return true if the stream was opened by the peer
+     */
+    bool IsPeerStream(uint64_t id) const;
+
+    // Configuration
+    TypeId m_congestionTypeId;  //!< Type of the congestion control algorithm
+    uint32_t m_maxPacketSize;   //!< Maximum size of the UDP payload
+    uint32_t m_initialWindow;   //!< Initial congestion window, in packets
+    Time m_initialRtt;          //!< RTT assumed before the first sample
+    Time m_maxAckDelay;         //!< Maximum delay before acknowledging a packet
+    Time m_idleTimeout;         //!< Idle timeout (zero to disable)
+    uint32_t m_clientHelloSize; //!< Size of the ClientHello message
+    uint32_t m_serverFlightSize; //!< Size of the handshake messages of the server
+    Ptr<UniformRandomVariable> m_rng; //!< Random variable generating the connection IDs
+
+    // Connection
+    Ptr<Node> m_node;                  //!< The associated node
+    Ptr<QuicSocketFactory> m_factory;  //!< The factory tracking the connection
+    Ptr<QuicSocket> m_listener;        //!< The listening socket (server)
+    Ptr<Socket> m_udp;                 //!< The UDP socket
+    Address m_peer;                    //!< The address of the peer
+    bool m_isClient;                   //!< Whether this end opened the connection
+    State_t m_state;                   //!< State of the connection
+    bool m_handshakeConfirmed;         //!< Whether the handshake is confirmed
+    bool m_handshakeDonePending;       //!< Whether a HANDSHAKE_DONE frame must be sent
+    uint64_t m_scid;                   //!< Connection ID chosen by this end
+    uint64_t m_dcid;                   //!< Connection ID chosen by the peer
+    bool m_dcidKnown;                  //!< Whether the peer chose its connection ID
+    Ptr<QuicCongestionControl> m_congestion; //!< Congestion controller
+    std::array<Space, N_SPACES> m_spaces;    //!< Packet number spaces
+    bool m_processing;                 //!< Whether a received packet is being processed
+    Time m_nextSendTime;               //!< Earliest time of the next paced packet
+    uint64_t m_lostPackets;            //!< Number of packets declared lost
+
+    // Loss detection, RFC 9002 section 5 and 6
+    bool m_hasRttSample;  //!< Whether an RTT sample was taken
+    Time m_latestRtt;     //!< Latest RTT sample
+    Time m_smoothedRtt;   //!< Smoothed RTT
+    Time m_rttVar;        //!< RTT variation
+    Time m_minRtt;        //!< Minimum RTT
+    uint32_t m_ptoCount;  //!< Number of consecutive probe timeouts
+    Time m_firstRttSampleTime; //!< Time of the first RTT sample
+
+    // Streams
+    std::map<uint64_t, Stream> m_streams; //!< Streams in use
+    uint64_t m_nextLocalStreamId;         //!< ID of the next stream opened by this end
+    uint64_t m_nextPeerStreamId;          //!< Lowest ID of a stream not opened yet by the peer
+    std::vector<uint64_t> m_newStreams;   //!< Streams opened by the peer, not accepted yet
+    uint64_t m_nextStream;                //!< Stream to serve first in the next packet
+
+    // Timers
+    EventId m_lossDetectionTimer; //!< Loss detection timer
+    EventId m_ackTimer;           //!< Delayed ACK timer
+    EventId m_sendEvent;          //!< Pacing timer
+    EventId m_idleTimer;          //!< Idle timer
+
+    TracedCallback<Ptr<const Packet>> m_txTrace; //!< Trace of the packets sent
+    TracedCallback<Ptr<const Packet>> m_rxTrace; //!< Trace of the packets received
+};
+
+} // namespace ns3
+
+#endif /* QUIC_CONNECTION_H */
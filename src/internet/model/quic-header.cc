@@ -0,0 +1,582 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quic-header.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuicHeader");
+
+NS_OBJECT_ENSURE_REGISTERED(QuicHeader);
+NS_OBJECT_ENSURE_REGISTERED(QuicFrameHeader);
+
+/// Length of the connection IDs, in bytes
+static const uint8_t QUIC_CID_LENGTH = 8;
+
+/// Flag of the STREAM frame type: the frame carries the end of the stream
+static const uint8_t QUIC_STREAM_FIN = 0x01;
+/// Flag of the STREAM frame type: the frame has a Length field
+static const uint8_t QUIC_STREAM_LEN = 0x02;
+/// Flag of the STREAM frame type: the frame has an Offset field
+static const uint8_t QUIC_STREAM_OFF = 0x04;
+
+uint32_t
+QuicHeader::GetVarIntSize(uint64_t value)
+{
+    if (value < (1ULL << 6))
+    {
+        return 1;
+    }
+    if (value < (1ULL << 14))
+    {
+        return 2;
+    }
+    if (value < (1ULL << 30))
+    {
+        return 4;
+    }
+    NS_ABORT_MSG_IF(value >= (1ULL << 62), "Value too large for a variable-length integer");
+    return 8;
+}
+
+void
+QuicHeader::WriteVarInt(Buffer::Iterator& i, uint64_t value)
+{
+    switch (GetVarIntSize(value))
+    {
+    case 1:
+        i.WriteU8(static_cast<uint8_t>(value));
+        break;
+    case 2:
+        i.WriteHtonU16(static_cast<uint16_t>(value | 0x4000));
+        break;
+    case 4:
+        i.WriteHtonU32(static_cast<uint32_t>(value | 0x80000000));
+        break;
+    default:
+        i.WriteHtonU64(value | 0xc000000000000000ULL);
+        break;
+    }
+}
+
+uint64_t
+QuicHeader::ReadVarInt(Buffer::Iterator& i)
+{
+    uint8_t first = i.PeekU8();
+    switch (first >> 6)
+    {
+    case 0:
+        return i.ReadU8();
+    case 1:
+        return i.ReadNtohU16() & 0x3fff;
+    case 2:
+        return i.ReadNtohU32() & 0x3fffffff;
+    default:
+        return i.ReadNtohU64() & 0x3fffffffffffffffULL;
+    }
+}
+
+QuicHeader::QuicHeader()
+    : m_type(ONE_RTT),
+      m_version(1),
+      m_dcid(0),
+      m_scid(0),
+      m_packetNumber(0)
+{
+}
+
+TypeId
+QuicHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QuicHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<QuicHeader>();
+    return tid;
+}
+
+TypeId
+QuicHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+QuicHeader::Print(std::ostream& os) const
+{
+    switch (m_type)
+    {
+    case INITIAL:
+        os << "Initial";
+        break;
+    case HANDSHAKE:
+        os << "Handshake";
+        break;
+    default:
+        os << "1-RTT";
+        break;
+    }
+    os << " DCID=" << m_dcid;
+    if (IsLongHeader())
+    {
+        os << " SCID=" << m_scid << " Version=" << m_version;
+    }
+    os << " PN=" << m_packetNumber;
+}
+
+uint32_t
+QuicHeader::GetSerializedSize() const
+{
+    uint32_t size = 1 + QUIC_CID_LENGTH + GetVarIntSize(m_packetNumber);
+    if (IsLongHeader())
+    {
+        // Version, lengths of the connection IDs and source connection ID
+        size += 4 + 2 + QUIC_CID_LENGTH;
+        if (m_type == INITIAL)
+        {
+            // Empty token
+            size += 1;
+        }
+    }
+    return size;
+}
+
+void
+QuicHeader::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    if (IsLongHeader())
+    {
+        i.WriteU8(0xc0 | (m_type << 4));
+        i.WriteHtonU32(m_version);
+        i.WriteU8(QUIC_CID_LENGTH);
+        i.WriteHtonU64(m_dcid);
+        i.WriteU8(QUIC_CID_LENGTH);
+        i.WriteHtonU64(m_scid);
+        if (m_type == INITIAL)
+        {
+            WriteVarInt(i, 0);
+        }
+    }
+    else
+    {
+        i.WriteU8(0x40);
+        i.WriteHtonU64(m_dcid);
+    }
+    WriteVarInt(i, m_packetNumber);
+}
+
+uint32_t
+QuicHeader::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t first = i.ReadU8();
+    if (first & 0x80)
+    {
+        m_type = ((first >> 4) & 0x03) == 0 ? INITIAL : HANDSHAKE;
+        m_version = i.ReadNtohU32();
+        NS_ABORT_MSG_IF(i.ReadU8() != QUIC_CID_LENGTH, "Unsupported connection ID length");
+        m_dcid = i.ReadNtohU64();
+        NS_ABORT_MSG_IF(i.ReadU8() != QUIC_CID_LENGTH, "Unsupported connection ID length");
+        m_scid = i.ReadNtohU64();
+        if (m_type == INITIAL)
+        {
+            i.Next(ReadVarInt(i));
+        }
+    }
+    else
+    {
+        m_type = ONE_RTT;
+        m_dcid = i.ReadNtohU64();
+    }
+    m_packetNumber = ReadVarInt(i);
+    return i.GetDistanceFrom(start);
+}
+
+void
+QuicHeader::SetPacketType(PacketType_t type)
+{
+    m_type = type;
+}
+
+QuicHeader::PacketType_t
+QuicHeader::GetPacketType() const
+{
+    return m_type;
+}
+
+bool
+QuicHeader::IsLongHeader() const
+{
+    return m_type != ONE_RTT;
+}
+
+void
+QuicHeader::SetVersion(uint32_t version)
+{
+    m_version = version;
+}
+
+uint32_t
+QuicHeader::GetVersion() const
+{
+    return m_version;
+}
+
+void
+QuicHeader::SetDestinationConnectionId(uint64_t cid)
+{
+    m_dcid = cid;
+}
+
+uint64_t
+QuicHeader::GetDestinationConnectionId() const
+{
+    return m_dcid;
+}
+
+void
+QuicHeader::SetSourceConnectionId(uint64_t cid)
+{
+    m_scid = cid;
+}
+
+uint64_t
+QuicHeader::GetSourceConnectionId() const
+{
+    return m_scid;
+}
+
+void
+QuicHeader::SetPacketNumber(uint64_t packetNumber)
+{
+    m_packetNumber = packetNumber;
+}
+
+uint64_t
+QuicHeader::GetPacketNumber() const
+{
+    return m_packetNumber;
+}
+
+QuicFrameHeader::QuicFrameHeader()
+    : m_type(PADDING),
+      m_streamId(0),
+      m_offset(0),
+      m_length(1),
+      m_fin(false),
+      m_ackDelay(0),
+      m_errorCode(0)
+{
+}
+
+TypeId
+QuicFrameHeader::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QuicFrameHeader")
+                            .SetParent<Header>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<QuicFrameHeader>();
+    return tid;
+}
+
+TypeId
+QuicFrameHeader::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+QuicFrameHeader::Print(std::ostream& os) const
+{
+    switch (m_type)
+    {
+    case PADDING:
+        os << "PADDING(" << m_length << ")";
+        break;
+    case PING:
+        os << "PING";
+        break;
+    case ACK:
+        os << "ACK Delay=" << m_ackDelay;
+        for (const auto& range : m_ranges)
+        {
+            os << " [" << range.first << "-" << range.second << "]";
+        }
+        break;
+    case CRYPTO:
+        os << "CRYPTO Offset=" << m_offset << " Length=" << m_length;
+        break;
+    case STREAM:
+        os << "STREAM Id=" << m_streamId << " Offset=" << m_offset << " Length=" << m_length;
+        if (m_fin)
+        {
+            os << " FIN";
+        }
+        break;
+    case CONNECTION_CLOSE:
+        os << "CONNECTION_CLOSE Error=" << m_errorCode;
+        break;
+    case HANDSHAKE_DONE:
+        os << "HANDSHAKE_DONE";
+        break;
+    }
+}
+
+uint32_t
+QuicFrameHeader::GetSerializedSize() const
+{
+    switch (m_type)
+    {
+    case PADDING:
+        return m_length;
+    case ACK: {
+        NS_ASSERT(!m_ranges.empty());
+        uint32_t size = 1 + QuicHeader::GetVarIntSize(GetLargestAcked()) +
+                        QuicHeader::GetVarIntSize(m_ackDelay) +
+                        QuicHeader::GetVarIntSize(m_ranges.size() - 1) +
+                        QuicHeader::GetVarIntSize(m_ranges[0].second - m_ranges[0].first);
+        for (std::size_t j = 1; j < m_ranges.size(); j++)
+        {
+            size += QuicHeader::GetVarIntSize(m_ranges[j - 1].first - m_ranges[j].second - 2) +
+                    QuicHeader::GetVarIntSize(m_ranges[j].second - m_ranges[j].first);
+        }
+        return size;
+    }
+    case CRYPTO:
+        return 1 + QuicHeader::GetVarIntSize(m_offset) + QuicHeader::GetVarIntSize(m_length);
+    case STREAM:
+        return 1 + QuicHeader::GetVarIntSize(m_streamId) + QuicHeader::GetVarIntSize(m_offset) +
+               QuicHeader::GetVarIntSize(m_length);
+    case CONNECTION_CLOSE:
+        // Error code, frame type and empty reason phrase
+        return 1 + QuicHeader::GetVarIntSize(m_errorCode) + 2;
+    default:
+        return 1;
+    }
+}
+
+void
+QuicFrameHeader::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    switch (m_type)
+    {
+    case PADDING:
+        i.WriteU8(0, m_length);
+        break;
+    case ACK:
+        i.WriteU8(ACK);
+        QuicHeader::WriteVarInt(i, GetLargestAcked());
+        QuicHeader::WriteVarInt(i, m_ackDelay);
+        QuicHeader::WriteVarInt(i, m_ranges.size() - 1);
+        QuicHeader::WriteVarInt(i, m_ranges[0].second - m_ranges[0].first);
+        for (std::size_t j = 1; j < m_ranges.size(); j++)
+        {
+            QuicHeader::WriteVarInt(i, m_ranges[j - 1].first - m_ranges[j].second - 2);
+            QuicHeader::WriteVarInt(i, m_ranges[j].second - m_ranges[j].first);
+        }
+        break;
+    case CRYPTO:
+        i.WriteU8(CRYPTO);
+        QuicHeader::WriteVarInt(i, m_offset);
+        QuicHeader::WriteVarInt(i, m_length);
+        break;
+    case STREAM:
+        i.WriteU8(STREAM | QUIC_STREAM_OFF | QUIC_STREAM_LEN | (m_fin ? QUIC_STREAM_FIN : 0));
+        QuicHeader::WriteVarInt(i, m_streamId);
+        QuicHeader::WriteVarInt(i, m_offset);
+        QuicHeader::WriteVarInt(i, m_length);
+        break;
+    case CONNECTION_CLOSE:
+        i.WriteU8(CONNECTION_CLOSE);
+        QuicHeader::WriteVarInt(i, m_errorCode);
+        QuicHeader::WriteVarInt(i, 0);
+        QuicHeader::WriteVarInt(i, 0);
+        break;
+    default:
+        i.WriteU8(m_type);
+        break;
+    }
+}
+
+uint32_t
+QuicFrameHeader::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t type = i.ReadU8();
+    if (type >= STREAM && type <= (STREAM | 0x07))
+    {
+        m_type = STREAM;
+        m_fin = type & QUIC_STREAM_FIN;
+        m_streamId = QuicHeader::ReadVarInt(i);
+        m_offset = (type & QUIC_STREAM_OFF) ? QuicHeader::ReadVarInt(i) : 0;
+        NS_ABORT_MSG_IF(!(type & QUIC_STREAM_LEN), "STREAM frames without Length are not supported");
+        m_length = QuicHeader::ReadVarInt(i);
+        return i.GetDistanceFrom(start);
+    }
+
+    m_type = static_cast<FrameType_t>(type);
+    switch (m_type)
+    {
+    case PADDING:
+        m_length = 1;
+        while (!i.IsEnd() && i.PeekU8() == 0)
+        {
+            i.ReadU8();
+            m_length++;
+        }
+        break;
+    case ACK: {
+        uint64_t largest = QuicHeader::ReadVarInt(i);
+        m_ackDelay = QuicHeader::ReadVarInt(i);
+        uint64_t count = QuicHeader::ReadVarInt(i);
+        uint64_t smallest = largest - QuicHeader::ReadVarInt(i);
+        m_ranges.clear();
+        m_ranges.emplace_back(smallest, largest);
+        for (uint64_t j = 0; j < count; j++)
+        {
+            largest = smallest - QuicHeader::ReadVarInt(i) - 2;
+            smallest = largest - QuicHeader::ReadVarInt(i);
+            m_ranges.emplace_back(smallest, largest);
+        }
+        break;
+    }
+    case CRYPTO:
+        m_offset = QuicHeader::ReadVarInt(i);
+        m_length = QuicHeader::ReadVarInt(i);
+        break;
+    case CONNECTION_CLOSE:
+        m_errorCode = QuicHeader::ReadVarInt(i);
+        QuicHeader::ReadVarInt(i);
+        i.Next(QuicHeader::ReadVarInt(i));
+        break;
+    case PING:
+    case HANDSHAKE_DONE:
+        break;
+    default:
+        NS_ABORT_MSG("Unsupported QUIC frame type " << +type);
+    }
+    return i.GetDistanceFrom(start);
+}
+
+void
+QuicFrameHeader::SetFrameType(FrameType_t type)
+{
+    m_type = type;
+}
+
+QuicFrameHeader::FrameType_t
+QuicFrameHeader::GetFrameType() const
+{
+    return m_type;
+}
+
+void
+QuicFrameHeader::SetStreamId(uint64_t id)
+{
+    m_streamId = id;
+}
+
+uint64_t
+QuicFrameHeader::GetStreamId() const
+{
+    return m_streamId;
+}
+
+void
+QuicFrameHeader::SetOffset(uint64_t offset)
+{
+    m_offset = offset;
+}
+
+uint64_t
+QuicFrameHeader::GetOffset() const
+{
+    return m_offset;
+}
+
+void
+QuicFrameHeader::SetLength(uint64_t length)
+{
+    m_length = length;
+}
+
+uint64_t
+QuicFrameHeader::GetLength() const
+{
+    return m_length;
+}
+
+void
+QuicFrameHeader::SetFin(bool fin)
+{
+    m_fin = fin;
+}
+
+bool
+QuicFrameHeader::IsFin() const
+{
+    return m_fin;
+}
+
+void
+QuicFrameHeader::SetAckDelay(uint64_t delay)
+{
+    m_ackDelay = delay;
+}
+
+uint64_t
+QuicFrameHeader::GetAckDelay() const
+{
+    return m_ackDelay;
+}
+
+void
+QuicFrameHeader::SetAckRanges(const std::vector<AckRange>& ranges)
+{
+    m_ranges = ranges;
+}
+
+const std::vector<QuicFrameHeader::AckRange>&
+QuicFrameHeader::GetAckRanges() const
+{
+    return m_ranges;
+}
+
+uint64_t
+QuicFrameHeader::GetLargestAcked() const
+{
+    NS_ASSERT(!m_ranges.empty());
+    return m_ranges.front().second;
+}
+
+void
+QuicFrameHeader::SetErrorCode(uint64_t code)
+{
+    m_errorCode = code;
+}
+
+uint64_t
+QuicFrameHeader::GetErrorCode() const
+{
+    return m_errorCode;
+}
+
+} // namespace ns3
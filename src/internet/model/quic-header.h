@@ -0,0 +1,263 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUIC_HEADER_H
+#define QUIC_HEADER_H
+
+#include "ns3/buffer.h"
+#include "ns3/header.h"
+
+#include <stdint.h>
+#include <utility>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup quic
+ * \brief Header of a QUIC packet, \RFC{9000}
+ *
+ * The packets of the Initial and Handshake packet number spaces carry a
+ * long header, with the version and both connection IDs; the packets of the
+ * application data space carry a short header, with the destination
+ * connection ID only. Connection IDs are 8 bytes long.
+ *
+ * The packets are not protected, hence the packet number is encoded in
+ * full as a variable-length integer instead of being truncated, and the
+ * long header has no Length field since packets are never coalesced.
+ */
+class QuicHeader : public Header
+{
+  public:
+    /// Type of a QUIC packet, which also determines its packet number space
+    enum PacketType_t : uint8_t
+    {
+        INITIAL = 0,   //!< Initial packet (long header)
+        HANDSHAKE = 2, //!< Handshake packet (long header)
+        ONE_RTT = 4    //!< 1-RTT packet (short header)
+    };
+
+    QuicHeader();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    /**
+     * \param type the type of the packet
+     */
+    void SetPacketType(PacketType_t type);
+    /**
+     * \return the type of the packet
+     */
+    PacketType_t GetPacketType() const;
+    /**
+     * \return true if the packet carries a long header
+     */
+    bool IsLongHeader() const;
+    /**
+     * \param version the QUIC version (long header only)
+     */
+    void SetVersion(uint32_t version);
+    /**
+     * \return the QUIC version (long header only)
+     */
+    uint32_t GetVersion() const;
+    /**
+     * \param cid the destination connection ID
+     */
+    void SetDestinationConnectionId(uint64_t cid);
+    /**
+     * \return the destination connection ID
+     */
+    uint64_t GetDestinationConnectionId() const;
+    /**
+     * \param cid the source connection ID (long header only)
+     */
+    void SetSourceConnectionId(uint64_t cid);
+    /**
+     * \return the source connection ID (long header only)
+     */
+    uint64_t GetSourceConnectionId() const;
+    /**
+     * \param packetNumber the packet number
+     */
+    void SetPacketNumber(uint64_t packetNumber);
+    /**
+     * \return the packet number
+     */
+    uint64_t GetPacketNumber() const;
+
+    /**
+     * \brief Get the size of a variable-length integer, \RFC{9000} section 16
+     * \param value the value to encode
+     * \return the number of bytes (1, 2, 4 or 8) needed to encode the value
+     */
+    static uint32_t GetVarIntSize(uint64_t value);
+    /**
+     * \brief Write a variable-length integer
+     * \param i the buffer iterator, moved past the integer
+     * \param value the value to encode, lower than 2^62
+     */
+    static void WriteVarInt(Buffer::Iterator& i, uint64_t value);
+    /**
+     * \brief Read a variable-length integer
+     * \param i the buffer iterator, moved past the integer
+     * \return the decoded value
+     */
+    static uint64_t ReadVarInt(Buffer::Iterator& i);
+
+  private:
+    PacketType_t m_type;    //!< Type of the packet
+    uint32_t m_version;     //!< QUIC version
+    uint64_t m_dcid;        //!< Destination connection ID
+    uint64_t m_scid;        //!< Source connection ID
+    uint64_t m_packetNumber; //!< Packet number
+};
+
+/**
+ * \ingroup quic
+ * \brief A frame carried in the payload of a QUIC packet, \RFC{9000} section 19
+ *
+ * The payload of a packet is a sequence of frames, each serialized as a
+ * separate header. The data of the STREAM and CRYPTO frames is not part
+ * of the header: it follows it in the packet, and its length is given by
+ * the Length field of the frame.
+ */
+class QuicFrameHeader : public Header
+{
+  public:
+    /// Type of a QUIC frame
+    enum FrameType_t : uint8_t
+    {
+        PADDING = 0x00,          //!< Padding bytes
+        PING = 0x01,             //!< Ack-eliciting empty frame
+        ACK = 0x02,              //!< Acknowledgment of packet number ranges
+        CRYPTO = 0x06,           //!< Handshake data
+        STREAM = 0x08,           //!< Stream data
+        CONNECTION_CLOSE = 0x1c, //!< Connection termination
+        HANDSHAKE_DONE = 0x1e    //!< Handshake confirmation sent by the server
+    };
+
+    /// A range of acknowledged packet numbers, as (smallest, largest)
+    typedef std::pair<uint64_t, uint64_t> AckRange;
+
+    QuicFrameHeader();
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+    void Print(std::ostream& os) const override;
+    uint32_t GetSerializedSize() const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+
+    /**
+     * \param type the type of the frame
+     */
+    void SetFrameType(FrameType_t type);
+    /**
+     * \return the type of the frame
+     */
+    FrameType_t GetFrameType() const;
+    /**
+     * \param id the stream ID (STREAM)
+     */
+    void SetStreamId(uint64_t id);
+    /**
+     * \return the stream ID (STREAM)
+     */
+    uint64_t GetStreamId() const;
+    /**
+     * \param offset the offset of the data in the stream (STREAM, CRYPTO)
+     */
+    void SetOffset(uint64_t offset);
+    /**
+     * \return the offset of the data in the stream (STREAM, CRYPTO)
+     */
+    uint64_t GetOffset() const;
+    /**
+     * \param length the length of the data following the frame (STREAM,
+     *        CRYPTO), or the number of padding bytes (PADDING)
+     */
+    void SetLength(uint64_t length);
+    /**
+     * \return the length of the data following the frame (STREAM, CRYPTO),
+     *         or the number of padding bytes (PADDING)
+     */
+    uint64_t GetLength() const;
+    /**
+     * \param fin whether the frame carries the end of the stream (STREAM)
+     */
+    void SetFin(bool fin);
+    /**
+     * \return whether the frame carries the end of the stream (STREAM)
+     */
+    bool IsFin() const;
+    /**
+     * \param delay the ACK delay, in microseconds (ACK)
+     */
+    void SetAckDelay(uint64_t delay);
+    /**
+     * \return the ACK delay, in microseconds (ACK)
+     */
+    uint64_t GetAckDelay() const;
+    /**
+     * \param ranges the acknowledged ranges, ordered by decreasing packet
+     *        numbers and separated by at least one packet number (ACK)
+     */
+    void SetAckRanges(const std::vector<AckRange>& ranges);
+    /**
+     * \return the acknowledged ranges, ordered by decreasing packet numbers (ACK)
+     */
+    const std::vector<AckRange>& GetAckRanges() const;
+    /**
+     * \return the largest acknowledged packet number (ACK)
+     */
+    uint64_t GetLargestAcked() const;
+    /**
+     * \param code the error code (CONNECTION_CLOSE)
+     */
+    void SetErrorCode(uint64_t code);
+    /**
+     * \return the error code (CONNECTION_CLOSE)
+     */
+    uint64_t GetErrorCode() const;
+
+  private:
+    FrameType_t m_type;              //!< Type of the frame
+    uint64_t m_streamId;             //!< Stream ID
+    uint64_t m_offset;               //!< Offset of the data
+    uint64_t m_length;               //!< Length of the data or of the padding
+    bool m_fin;                      //!< FIN bit of a STREAM frame
+    uint64_t m_ackDelay;             //!< ACK delay, in microseconds
+    std::vector<AckRange> m_ranges;  //!< Acknowledged ranges
+    uint64_t m_errorCode;            //!< Error code
+};
+
+} // namespace ns3
+
+#endif /* QUIC_HEADER_H */
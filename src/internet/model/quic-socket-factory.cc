@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quic-socket-factory.h"
+
+#include "quic-connection.h"
+#include "quic-socket.h"
+#include "udp-l4-protocol.h"
+
+#include "ns3/log.h"
+#include "ns3/node.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuicSocketFactory");
+
+NS_OBJECT_ENSURE_REGISTERED(QuicSocketFactory);
+
+TypeId
+QuicSocketFactory::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::QuicSocketFactory")
+                            .SetParent<SocketFactory>()
+                            .SetGroupName("Internet");
+    return tid;
+}
+
+QuicSocketFactory::QuicSocketFactory()
+    : m_udp(nullptr)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+QuicSocketFactory::~QuicSocketFactory()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QuicSocketFactory::SetUdp(Ptr<UdpL4Protocol> udp)
+{
+    m_udp = udp;
+}
+
+Ptr<Socket>
+QuicSocketFactory::CreateSocket()
+{
+    NS_LOG_FUNCTION(this);
+    Ptr<QuicSocket> socket = CreateObject<QuicSocket>();
+    socket->SetNode(m_udp->GetObject<Node>());
+    socket->SetFactory(this);
+    return socket;
+}
+
+void
+QuicSocketFactory::AddConnection(Ptr<QuicConnection> connection)
+{
+    NS_LOG_FUNCTION(this << connection);
+    m_connections.push_back(connection);
+}
+
+void
+QuicSocketFactory::RemoveConnection(Ptr<QuicConnection> connection)
+{
+    NS_LOG_FUNCTION(this << connection);
+    auto it = std::find(m_connections.begin(), m_connections.end(), connection);
+    if (it != m_connections.end())
+    {
+        m_connections.erase(it);
+    }
+}
+
+Ptr<QuicConnection>
+QuicSocketFactory::FindClientConnection(const Address& peer) const
+{
+    for (const auto& connection : m_connections)
+    {
+        if (connection->IsClient() && connection->GetState() != QuicConnection::CLOSED &&
+            connection->GetPeerAddress() == peer)
+        {
+            return connection;
+        }
+    }
+    return nullptr;
+}
+
+void
+QuicSocketFactory::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    std::vector<Ptr<QuicConnection>> connections;
+    connections.swap(m_connections);
+    for (auto& connection : connections)
+    {
+        connection->Dispose();
+    }
+    m_udp = nullptr;
+    SocketFactory::DoDispose();
+}
+
+} // namespace ns3
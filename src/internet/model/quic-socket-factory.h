@@ -0,0 +1,89 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUIC_SOCKET_FACTORY_H
+#define QUIC_SOCKET_FACTORY_H
+
+#include "ns3/address.h"
+#include "ns3/ptr.h"
+#include "ns3/socket-factory.h"
+
+#include <vector>
+
+namespace ns3
+{
+
+class QuicConnection;
+class Socket;
+class UdpL4Protocol;
+
+/**
+ * \ingroup quic
+ * \brief API to create QUIC socket instances
+ *
+ * The factory is aggregated to the nodes by UdpL4Protocol. It also keeps
+ * track of the QUIC connections of the node, so that the sockets connecting
+ * to the same server can share a connection.
+ */
+class QuicSocketFactory : public SocketFactory
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QuicSocketFactory();
+    ~QuicSocketFactory() override;
+
+    /**
+     * \brief Set the associated UDP L4 protocol.
+     * \param udp the UDP L4 protocol
+     */
+    void SetUdp(Ptr<UdpL4Protocol> udp);
+
+    Ptr<Socket> CreateSocket() override;
+
+    /**
+     * \brief Record a connection of the node
+     * \param connection the connection
+     */
+    void AddConnection(Ptr<QuicConnection> connection);
+
+    /**
+     * \brief Forget a connection closed
+     * \param connection the connection
+     */
+    void RemoveConnection(Ptr<QuicConnection> connection);
+
+    /**
+     * \brief Find a connection opened by the node to a server
+     * \param peer the address of the server
+     * \return the connection, or nullptr if there is none
+     */
+    Ptr<QuicConnection> FindClientConnection(const Address& peer) const;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    Ptr<UdpL4Protocol> m_udp;                       //!< the associated UDP L4 protocol
+    std::vector<Ptr<QuicConnection>> m_connections; //!< the connections of the node
+};
+
+} // namespace ns3
+
+#endif /* QUIC_SOCKET_FACTORY_H */
@@ -0,0 +1,549 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "quic-socket.h"
+
+#include "quic-connection.h"
+#include "quic-header.h"
+#include "quic-socket-factory.h"
+#include "udp-socket-factory.h"
+
+#include "ns3/boolean.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/inet6-socket-address.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QuicSocket");
+
+NS_OBJECT_ENSURE_REGISTERED(QuicSocket);
+
+TypeId
+QuicSocket::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::QuicSocket")
+            .SetParent<Socket>()
+            .SetGroupName("Internet")
+            .AddConstructor<QuicSocket>()
+            .AddAttribute("SndBufSize",
+                          "Maximum amount of data of the stream buffered for transmission",
+                          UintegerValue(131072),
+                          MakeUintegerAccessor(&QuicSocket::m_sndBufSize),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("ReuseConnection",
+                          "Open the streams to a server on the existing connection to it, "
+                          "if any",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&QuicSocket::m_reuseConnection),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+QuicSocket::QuicSocket()
+    : m_sndBufSize(0),
+      m_reuseConnection(true),
+      m_errno(ERROR_NOTERROR),
+      m_bound(false),
+      m_streamId(0),
+      m_connected(false),
+      m_shutdownSend(false),
+      m_shutdownRecv(false),
+      m_closeNotified(false),
+      m_listening(false)
+{
+    NS_LOG_FUNCTION(this);
+    m_rxReady = Create<Packet>();
+}
+
+QuicSocket::~QuicSocket()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QuicSocket::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_connection)
+    {
+        m_connection->DetachStream(m_streamId);
+        m_connection = nullptr;
+    }
+    m_accepted.clear();
+    if (m_udp)
+    {
+        m_udp->SetRecvCallback(MakeNullCallback<void, Ptr<Socket>>());
+        m_udp = nullptr;
+    }
+    m_node = nullptr;
+    m_factory = nullptr;
+    Socket::DoDispose();
+}
+
+void
+QuicSocket::SetNode(Ptr<Node> node)
+{
+    m_node = node;
+}
+
+void
+QuicSocket::SetFactory(Ptr<QuicSocketFactory> factory)
+{
+    m_factory = factory;
+}
+
+Ptr<QuicConnection>
+QuicSocket::GetConnection() const
+{
+    return m_connection;
+}
+
+uint64_t
+QuicSocket::GetStreamId() const
+{
+    return m_streamId;
+}
+
+void
+QuicSocket::ConnectionEstablished()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_connected || m_closeNotified)
+    {
+        return;
+    }
+    m_connected = true;
+    NotifyConnectionSucceeded();
+    if (GetTxAvailable() > 0)
+    {
+        NotifySend(GetTxAvailable());
+    }
+}
+
+void
+QuicSocket::ConnectionClosed(bool error)
+{
+    NS_LOG_FUNCTION(this << error);
+    if (m_closeNotified)
+    {
+        return;
+    }
+    m_closeNotified = true;
+    if (!m_connected)
+    {
+        m_errno = ERROR_NOTCONN;
+        NotifyConnectionFailed();
+    }
+    else if (error)
+    {
+        m_errno = ERROR_SHUTDOWN;
+        NotifyErrorClose();
+    }
+    else
+    {
+        NotifyNormalClose();
+    }
+}
+
+void
+QuicSocket::StreamDataReceived(Ptr<Packet> packet)
+{
+    NS_LOG_FUNCTION(this << packet);
+    if (m_shutdownRecv)
+    {
+        return;
+    }
+    m_rxReady->AddAtEnd(packet);
+    NotifyDataRecv();
+}
+
+void
+QuicSocket::StreamFinReceived()
+{
+    NS_LOG_FUNCTION(this);
+    if (!m_closeNotified)
+    {
+        m_closeNotified = true;
+        NotifyNormalClose();
+    }
+}
+
+void
+QuicSocket::StreamDataAcked()
+{
+    if (!m_shutdownSend && GetTxAvailable() > 0)
+    {
+        NotifySend(GetTxAvailable());
+    }
+}
+
+void
+QuicSocket::AcceptStream(Ptr<QuicConnection> connection, uint64_t id)
+{
+    NS_LOG_FUNCTION(this << connection << id);
+    const Address& from = connection->GetPeerAddress();
+    if (!NotifyConnectionRequest(from))
+    {
+        connection->DetachStream(id);
+        return;
+    }
+    Ptr<QuicSocket> socket = CreateObject<QuicSocket>();
+    socket->SetNode(m_node);
+    socket->SetFactory(m_factory);
+    socket->m_sndBufSize = m_sndBufSize;
+    socket->m_connection = connection;
+    socket->m_streamId = id;
+    socket->m_connected = true;
+    connection->AttachStream(id, socket);
+    NotifyNewConnectionCreated(socket, from);
+}
+
+void
+QuicSocket::RemoveConnection(Ptr<QuicConnection> connection)
+{
+    NS_LOG_FUNCTION(this << connection);
+    for (auto it = m_accepted.begin(); it != m_accepted.end();)
+    {
+        if (it->second == connection)
+        {
+            it = m_accepted.erase(it);
+        }
+        else
+        {
+            ++it;
+        }
+    }
+}
+
+void
+QuicSocket::ListenerRecv(Ptr<Socket> socket)
+{
+    NS_LOG_FUNCTION(this << socket);
+    Ptr<Packet> packet;
+    Address from;
+    while ((packet = socket->RecvFrom(from)))
+    {
+        if (packet->GetSize() == 0)
+        {
+            continue;
+        }
+        QuicHeader header;
+        packet->PeekHeader(header);
+        Ptr<QuicConnection> connection;
+        auto it = m_accepted.find(header.GetDestinationConnectionId());
+        if (it != m_accepted.end())
+        {
+            connection = it->second;
+        }
+        else if (m_listening && header.GetPacketType() == QuicHeader::INITIAL)
+        {
+            connection = CreateObject<QuicConnection>();
+            connection->SetNode(m_node);
+            connection->SetFactory(m_factory);
+            connection->Accept(this, m_udp, from);
+            // The client uses the connection ID it chose until it learns the
+            // one chosen by the server
+            m_accepted[header.GetDestinationConnectionId()] = connection;
+            m_accepted[connection->GetSourceConnectionId()] = connection;
+            NS_LOG_INFO("New connection from " << from);
+        }
+        else
+        {
+            NS_LOG_LOGIC("Packet of unknown connection " << header << ", drop");
+            continue;
+        }
+        connection->Receive(packet, from);
+    }
+}
+
+Socket::SocketErrno
+QuicSocket::GetErrno() const
+{
+    return m_errno;
+}
+
+Socket::SocketType
+QuicSocket::GetSocketType() const
+{
+    return NS3_SOCK_STREAM;
+}
+
+Ptr<Node>
+QuicSocket::GetNode() const
+{
+    return m_node;
+}
+
+int
+QuicSocket::Bind()
+{
+    NS_LOG_FUNCTION(this);
+    m_bindAddress = InetSocketAddress(Ipv4Address::GetAny(), 0);
+    m_bound = true;
+    return 0;
+}
+
+int
+QuicSocket::Bind6()
+{
+    NS_LOG_FUNCTION(this);
+    m_bindAddress = Inet6SocketAddress(Ipv6Address::GetAny(), 0);
+    m_bound = true;
+    return 0;
+}
+
+int
+QuicSocket::Bind(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (!InetSocketAddress::IsMatchingType(address) &&
+        !Inet6SocketAddress::IsMatchingType(address))
+    {
+        m_errno = ERROR_AFNOSUPPORT;
+        return -1;
+    }
+    m_bindAddress = address;
+    m_bound = true;
+    return 0;
+}
+
+int
+QuicSocket::Connect(const Address& address)
+{
+    NS_LOG_FUNCTION(this << address);
+    if (!InetSocketAddress::IsMatchingType(address) &&
+        !Inet6SocketAddress::IsMatchingType(address))
+    {
+        m_errno = ERROR_AFNOSUPPORT;
+        return -1;
+    }
+    if (m_connection || m_listening)
+    {
+        m_errno = ERROR_ISCONN;
+        return -1;
+    }
+
+    Ptr<QuicConnection> connection =
+        m_reuseConnection ? m_factory->FindClientConnection(address) : nullptr;
+    if (connection)
+    {
+        NS_LOG_INFO("New stream on the connection to " << address);
+        m_connection = connection;
+        m_streamId = connection->OpenStream(this);
+        if (connection->GetState() == QuicConnection::ESTABLISHED)
+        {
+            Simulator::ScheduleNow(&QuicSocket::ConnectionEstablished, Ptr<QuicSocket>(this));
+        }
+        return 0;
+    }
+
+    Address local = m_bindAddress;
+    if (!m_bound)
+    {
+        local = Inet6SocketAddress::IsMatchingType(address)
+                    ? Address(Inet6SocketAddress(Ipv6Address::GetAny(), 0))
+                    : Address(InetSocketAddress(Ipv4Address::GetAny(), 0));
+    }
+    connection = CreateObject<QuicConnection>();
+    connection->SetNode(m_node);
+    connection->SetFactory(m_factory);
+    m_connection = connection;
+    m_streamId = connection->OpenStream(this);
+    if (connection->Connect(local, address) == -1)
+    {
+        m_errno = ERROR_INVAL;
+        m_connection = nullptr;
+        return -1;
+    }
+    return 0;
+}
+
+int
+QuicSocket::Listen()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_connection || m_listening)
+    {
+        m_errno = ERROR_INVAL;
+        return -1;
+    }
+    m_udp = Socket::CreateSocket(m_node, UdpSocketFactory::GetTypeId());
+    int ret = m_bound ? m_udp->Bind(m_bindAddress) : m_udp->Bind();
+    if (ret == -1)
+    {
+        m_errno = m_udp->GetErrno();
+        return -1;
+    }
+    m_udp->SetRecvCallback(MakeCallback(&QuicSocket::ListenerRecv, this));
+    m_listening = true;
+    return 0;
+}
+
+int
+QuicSocket::Close()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_udp)
+    {
+        // Stop accepting connections, but keep serving the accepted ones
+        m_listening = false;
+        return 0;
+    }
+    m_shutdownRecv = true;
+    return ShutdownSend();
+}
+
+int
+QuicSocket::ShutdownSend()
+{
+    NS_LOG_FUNCTION(this);
+    if (m_shutdownSend)
+    {
+        return 0;
+    }
+    m_shutdownSend = true;
+    if (m_connection)
+    {
+        m_connection->ShutdownSend(m_streamId);
+    }
+    return 0;
+}
+
+int
+QuicSocket::ShutdownRecv()
+{
+    NS_LOG_FUNCTION(this);
+    m_shutdownRecv = true;
+    return 0;
+}
+
+uint32_t
+QuicSocket::GetTxAvailable() const
+{
+    uint32_t buffered = m_connection ? m_connection->GetTxBuffered(m_streamId) : 0;
+    return (m_sndBufSize > buffered) ? m_sndBufSize - buffered : 0;
+}
+
+int
+QuicSocket::Send(Ptr<Packet> p, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << p << flags);
+    if (!m_connection || m_connection->GetState() == QuicConnection::CLOSED)
+    {
+        m_errno = ERROR_NOTCONN;
+        return -1;
+    }
+    if (m_shutdownSend)
+    {
+        m_errno = ERROR_SHUTDOWN;
+        return -1;
+    }
+    if (p->GetSize() > GetTxAvailable())
+    {
+        m_errno = ERROR_MSGSIZE;
+        return -1;
+    }
+    m_connection->Send(m_streamId, p);
+    return p->GetSize();
+}
+
+int
+QuicSocket::SendTo(Ptr<Packet> p, uint32_t flags, const Address& /* toAddress */)
+{
+    return Send(p, flags);
+}
+
+uint32_t
+QuicSocket::GetRxAvailable() const
+{
+    return m_rxReady->GetSize();
+}
+
+Ptr<Packet>
+QuicSocket::Recv(uint32_t maxSize, uint32_t flags)
+{
+    NS_LOG_FUNCTION(this << maxSize << flags);
+    if (m_rxReady->GetSize() == 0)
+    {
+        return nullptr;
+    }
+    uint32_t size = std::min(maxSize, m_rxReady->GetSize());
+    Ptr<Packet> p = m_rxReady->CreateFragment(0, size);
+    m_rxReady->RemoveAtStart(size);
+    return p;
+}
+
+Ptr<Packet>
+QuicSocket::RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress)
+{
+    NS_LOG_FUNCTION(this << maxSize << flags);
+    Ptr<Packet> p = Recv(maxSize, flags);
+    if (p && p->GetSize() > 0)
+    {
+        GetPeerName(fromAddress);
+    }
+    return p;
+}
+
+int
+QuicSocket::GetSockName(Address& address) const
+{
+    if (m_connection)
+    {
+        return m_connection->GetSockName(address);
+    }
+    if (m_udp)
+    {
+        return m_udp->GetSockName(address);
+    }
+    address = m_bindAddress;
+    return 0;
+}
+
+int
+QuicSocket::GetPeerName(Address& address) const
+{
+    if (!m_connection)
+    {
+        m_errno = ERROR_NOTCONN;
+        return -1;
+    }
+    address = m_connection->GetPeerAddress();
+    return 0;
+}
+
+bool
+QuicSocket::SetAllowBroadcast(bool allowBroadcast)
+{
+    // Broadcast is not implemented. Return true only if allowBroadcast==false
+    return (!allowBroadcast);
+}
+
+bool
+QuicSocket::GetAllowBroadcast() const
+{
+    return false;
+}
+
+} // namespace ns3
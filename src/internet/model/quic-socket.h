@@ -0,0 +1,196 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUIC_SOCKET_H
+#define QUIC_SOCKET_H
+
+#include "ns3/address.h"
+#include "ns3/socket.h"
+
+#include <map>
+
+namespace ns3
+{
+
+class Node;
+class Packet;
+class QuicConnection;
+class QuicSocketFactory;
+
+/**
+ * \ingroup internet
+ * \defgroup quic QUIC
+ *
+ * This is a model of the QUIC transport protocol (\RFC{9000} and
+ * \RFC{9002}) running over UDP, with the congestion control algorithms of
+ * the TCP model.
+ */
+
+/**
+ * \ingroup quic
+ * \brief A stream of a QUIC connection, or a socket listening for QUIC
+ *        connections
+ *
+ * The socket offers the stream semantics of a TCP socket, so that the
+ * applications written for TCP can run over QUIC unchanged: Connect() opens
+ * a new stream, which is notified as connected once the handshake of its
+ * connection is complete, and Listen() accepts the streams opened by the
+ * clients, each being notified as a new connection through the accept
+ * callback. Closing a socket closes its stream only.
+ *
+ * With the ReuseConnection attribute set, the sockets of a node connecting
+ * to the same server share a single connection, as an HTTP/3 client does:
+ * the streams opened after the first one do not need a new handshake, and
+ * a loss on one stream does not delay the delivery of the data of the
+ * others.
+ *
+ * \see QuicConnection
+ */
+class QuicSocket : public Socket
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    QuicSocket();
+    ~QuicSocket() override;
+
+    /**
+     * \brief Set the associated node
+     * \param node the node
+     */
+    void SetNode(Ptr<Node> node);
+
+    /**
+     * \brief Set the factory keeping track of the connections of the node
+     * \param factory the factory
+     */
+    void SetFactory(Ptr<QuicSocketFactory> factory);
+
+    /**
+     * \brief Get the connection carrying the stream of this socket
+     * \return the connection, or nullptr for a listening socket
+     */
+    Ptr<QuicConnection> GetConnection() const;
+
+    /**
+     * \brief Get the ID of the stream of this socket
+     * \return the stream ID
+     */
+    uint64_t GetStreamId() const;
+
+    /**
+     * \brief Notify the socket that the handshake of its connection is complete
+     */
+    void ConnectionEstablished();
+
+    /**
+     * \brief Notify the socket that its connection was closed
+     * \param error whether the connection was closed on error
+     */
+    void ConnectionClosed(bool error);
+
+    /**
+     * \brief Deliver data received in order on the stream
+     * \param packet the data
+     */
+    void StreamDataReceived(Ptr<Packet> packet);
+
+    /**
+     * \brief Notify the socket that the peer closed the stream
+     */
+    void StreamFinReceived();
+
+    /**
+     * \brief Notify the socket that data of the stream was acknowledged
+     */
+    void StreamDataAcked();
+
+    /**
+     * \brief Accept a stream opened by a client (listening socket)
+     * \param connection the connection carrying the stream
+     * \param id the stream ID
+     */
+    void AcceptStream(Ptr<QuicConnection> connection, uint64_t id);
+
+    /**
+     * \brief Forget a connection closed (listening socket)
+     * \param connection the connection
+     */
+    void RemoveConnection(Ptr<QuicConnection> connection);
+
+    // Documented in base class
+    Socket::SocketErrno GetErrno() const override;
+    Socket::SocketType GetSocketType() const override;
+    Ptr<Node> GetNode() const override;
+    int Bind() override;
+    int Bind6() override;
+    int Bind(const Address& address) override;
+    int Close() override;
+    int ShutdownSend() override;
+    int ShutdownRecv() override;
+    int Connect(const Address& address) override;
+    int Listen() override;
+    uint32_t GetTxAvailable() const override;
+    int Send(Ptr<Packet> p, uint32_t flags) override;
+    int SendTo(Ptr<Packet> p, uint32_t flags, const Address& toAddress) override;
+    uint32_t GetRxAvailable() const override;
+    Ptr<Packet> Recv(uint32_t maxSize, uint32_t flags) override;
+    Ptr<Packet> RecvFrom(uint32_t maxSize, uint32_t flags, Address& fromAddress) override;
+    int GetSockName(Address& address) const override;
+    int GetPeerName(Address& address) const override;
+    bool SetAllowBroadcast(bool allowBroadcast) override;
+    bool GetAllowBroadcast() const override;
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /**
+     * \brief Callback of the UDP socket of a listening socket
+     * \param socket the UDP socket
+     */
+    void ListenerRecv(Ptr<Socket> socket);
+
+    // Configuration
+    Ptr<Node> m_node;                    //!< The associated node
+    Ptr<QuicSocketFactory> m_factory;    //!< The factory tracking the connections
+    uint32_t m_sndBufSize;               //!< Size of the send buffer of the stream
+    bool m_reuseConnection;              //!< Share the connections to the same server
+    mutable Socket::SocketErrno m_errno; //!< The error code
+    Address m_bindAddress;               //!< The address the socket is bound to
+    bool m_bound;                        //!< Whether Bind() was called
+
+    // Stream
+    Ptr<QuicConnection> m_connection; //!< The connection carrying the stream
+    uint64_t m_streamId;              //!< The stream ID
+    bool m_connected;                 //!< Whether the connection was notified
+    bool m_shutdownSend;              //!< Whether sending is disallowed
+    bool m_shutdownRecv;              //!< Whether receiving is disallowed
+    bool m_closeNotified;             //!< Whether the close was notified
+    Ptr<Packet> m_rxReady;            //!< Data in order not read yet
+
+    // Listener
+    Ptr<Socket> m_udp;                                    //!< The UDP socket of the listener
+    bool m_listening;                                     //!< Whether new connections are accepted
+    std::map<uint64_t, Ptr<QuicConnection>> m_accepted; //!< Connections accepted, by connection ID
+};
+
+} // namespace ns3
+
+#endif /* QUIC_SOCKET_H */
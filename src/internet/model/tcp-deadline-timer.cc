@@ -0,0 +1,131 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-deadline-timer.h"
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpDeadlineTimer");
+
+TcpDeadlineTimer::TcpDeadlineTimer()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpDeadlineTimer::~TcpDeadlineTimer()
+{
+    NS_LOG_FUNCTION(this);
+    // The pending event refers to this object, remove it for real
+    m_event.Cancel();
+}
+
+void
+TcpDeadlineTimer::SetLazy(bool lazy)
+{
+    NS_LOG_FUNCTION(this << lazy);
+    m_lazy = lazy;
+}
+
+bool
+TcpDeadlineTimer::IsLazy() const
+{
+    return m_lazy;
+}
+
+void
+TcpDeadlineTimer::DoSchedule(const Time& delay, Ptr<EventImpl> impl)
+{
+    NS_LOG_FUNCTION(this << delay);
+
+    m_impl = impl;
+    m_deadline = Simulator::Now() + delay;
+
+    if (m_lazy && m_event.IsRunning() && TimeStep(m_event.GetTs()) <= m_deadline)
+    {
+        NS_LOG_LOGIC("Deadline moved to " << m_deadline.As(Time::S) << ", event at "
+                                          << TimeStep(m_event.GetTs()).As(Time::S)
+                                          << " left in place");
+        return;
+    }
+
+    m_event.Cancel();
+    m_event = Simulator::Schedule(delay, &TcpDeadlineTimer::Expire, this);
+}
+
+void
+TcpDeadlineTimer::Cancel()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_impl = nullptr;
+    if (!m_lazy)
+    {
+        m_event.Cancel();
+    }
+}
+
+bool
+TcpDeadlineTimer::IsRunning() const
+{
+    return m_impl != nullptr;
+}
+
+bool
+TcpDeadlineTimer::IsExpired() const
+{
+    return m_impl == nullptr;
+}
+
+Time
+TcpDeadlineTimer::GetDelayLeft() const
+{
+    if (m_impl == nullptr)
+    {
+        return Time(0);
+    }
+    return m_deadline - Simulator::Now();
+}
+
+void
+TcpDeadlineTimer::Expire()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_impl == nullptr)
+    {
+        NS_LOG_LOGIC("Timer cancelled");
+        return;
+    }
+
+    if (Simulator::Now() < m_deadline)
+    {
+        NS_LOG_LOGIC("Deadline moved, re-arming at " << m_deadline.As(Time::S));
+        m_event =
+            Simulator::Schedule(m_deadline - Simulator::Now(), &TcpDeadlineTimer::Expire, this);
+        return;
+    }
+
+    // The function may arm the timer again
+    Ptr<EventImpl> impl = m_impl;
+    m_impl = nullptr;
+    impl->Invoke();
+}
+
+} // namespace ns3
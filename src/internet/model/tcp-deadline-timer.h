@@ -0,0 +1,135 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+#ifndef TCP_DEADLINE_TIMER_H
+#define TCP_DEADLINE_TIMER_H
+
+#include "ns3/event-id.h"
+#include "ns3/event-impl.h"
+#include "ns3/make-event.h"
+#include "ns3/nstime.h"
+#include "ns3/ptr.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A timer whose deadline can be moved forward without touching the scheduler
+ *
+ * Some TCP timers, most notably the retransmission timer, are restarted on
+ * nearly every ACK. With a plain EventId, each restart cancels an event
+ * and inserts a new one in the simulator, so the scheduler churn is
+ * proportional to the number of packets.
+ *
+ * This timer keeps at most one event in the simulator. When the deadline
+ * moves later, only the deadline is updated: when the event fires before
+ * the deadline, it is simply scheduled again at the deadline. The simulator
+ * is involved only when the deadline moves earlier than the pending event.
+ * In the same way, cancelling the timer leaves the event in the simulator,
+ * where it expires without effects.
+ *
+ * The lazy behavior can be disabled, so that each Schedule and Cancel is
+ * forwarded to the simulator, as it would be done with an EventId.
+ */
+class TcpDeadlineTimer
+{
+  public:
+    TcpDeadlineTimer();
+    ~TcpDeadlineTimer();
+
+    // Delete copy constructor and assignment operator: the pending event
+    // refers to this object
+    TcpDeadlineTimer(const TcpDeadlineTimer&) = delete;
+    TcpDeadlineTimer& operator=(const TcpDeadlineTimer&) = delete;
+
+    /**
+     * \brief Enable or disable the lazy re-arming of the timer
+     * \param lazy true to move the deadline without rescheduling the event
+     */
+    void SetLazy(bool lazy);
+
+    /**
+     * \brief Check if the timer is re-armed lazily
+     * \return true if the lazy re-arming is enabled
+     */
+    bool IsLazy() const;
+
+    /**
+     * \brief Arm the timer, replacing the function and the deadline of a running timer
+     *
+     * \tparam FUNC \deduced Type of the function or member function pointer
+     * \tparam Ts \deduced Argument types
+     * \param delay the delay after which the function is invoked
+     * \param f the function (or member function) to invoke
+     * \param args the object (for member functions) and the arguments to pass to f
+     */
+    template <typename FUNC, typename... Ts>
+    void Schedule(const Time& delay, FUNC f, Ts&&... args);
+
+    /**
+     * \brief Stop the timer: the function will not be invoked
+     */
+    void Cancel();
+
+    /**
+     * \brief Check if the timer is armed
+     * \return true if the function will be invoked at the deadline
+     */
+    bool IsRunning() const;
+
+    /**
+     * \brief Check if the timer is not armed (expired or cancelled)
+     * \return true if the timer is not running
+     */
+    bool IsExpired() const;
+
+    /**
+     * \brief Get the time left before the deadline
+     * \return the time left, or zero if the timer is not running
+     */
+    Time GetDelayLeft() const;
+
+  private:
+    /**
+     * \brief Arm the timer with the given function
+     * \param delay the delay after which the function is invoked
+     * \param impl the function to invoke
+     */
+    void DoSchedule(const Time& delay, Ptr<EventImpl> impl);
+
+    /**
+     * \brief Expiration of the simulator event: re-arm it if the deadline
+     * has moved later, otherwise invoke the function
+     */
+    void Expire();
+
+    Ptr<EventImpl> m_impl; //!< Function to invoke at the deadline, null if not running
+    Time m_deadline;       //!< Absolute time of the deadline
+    EventId m_event;       //!< Simulator event, expiring not later than the deadline
+    bool m_lazy{true};     //!< Whether the deadline is moved lazily
+};
+
+template <typename FUNC, typename... Ts>
+void
+TcpDeadlineTimer::Schedule(const Time& delay, FUNC f, Ts&&... args)
+{
+    DoSchedule(delay, Ptr<EventImpl>(MakeEvent(f, std::forward<Ts>(args)...), false));
+}
+
+} // namespace ns3
+
+#endif /* TCP_DEADLINE_TIMER_H */
@@ -20,6 +20,7 @@
 
 #include "tcp-header.h"
 
+#include "tcp-option-mptcp.h"
 #include "tcp-option.h"
 
 #include "ns3/address-utils.h"
@@ -377,7 +378,18 @@ TcpHeader::Deserialize(Buffer::Iterator start)
         uint8_t kind = i.PeekU8();
         Ptr<TcpOption> op;
         uint32_t optionSize;
-        if (TcpOption::IsKindKnown(kind))
+        if (kind == TcpOption::MPTCP)
+        {
+            // The Multipath TCP options are told apart by their subtype
+            Buffer::Iterator j = i;
+            j.Next(2);
+            op = TcpOptionMpTcp::CreateMpTcpOption(j.ReadU8() >> 4);
+            if (!op)
+            {
+                op = TcpOption::CreateOption(TcpOption::UNKNOWN);
+            }
+        }
+        else if (TcpOption::IsKindKnown(kind))
         {
             op = TcpOption::CreateOption(kind);
         }
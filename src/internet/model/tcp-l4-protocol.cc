@@ -27,6 +27,7 @@
 #include "ipv6-end-point.h"
 #include "ipv6-l3-protocol.h"
 #include "ipv6-routing-protocol.h"
+#include "mptcp-socket-factory.h"
 #include "rtt-estimator.h"
 #include "tcp-congestion-ops.h"
 #include "tcp-cubic.h"
@@ -47,6 +48,7 @@
 #include "ns3/packet.h"
 #include "ns3/simulator.h"
 
+#include <algorithm>
 #include <iomanip>
 #include <sstream>
 #include <vector>
@@ -135,6 +137,9 @@ TcpL4Protocol::NotifyNewAggregate()
             Ptr<TcpSocketFactoryImpl> tcpFactory = CreateObject<TcpSocketFactoryImpl>();
             tcpFactory->SetTcp(this);
             node->AggregateObject(tcpFactory);
+            Ptr<MpTcpSocketFactory> mptcpFactory = CreateObject<MpTcpSocketFactory>();
+            mptcpFactory->SetTcp(this);
+            node->AggregateObject(mptcpFactory);
         }
     }
 
@@ -695,9 +700,35 @@ TcpL4Protocol::SendPacket(Ptr<Packet> pkt,
                           const TcpHeader& outgoing,
                           const Address& saddr,
                           const Address& daddr,
-                          Ptr<NetDevice> oif) const
+                          Ptr<NetDevice> oif,
+                          uint32_t segmentSize) const
 {
-    NS_LOG_FUNCTION(this << pkt << outgoing << saddr << daddr << oif);
+    NS_LOG_FUNCTION(this << pkt << outgoing << saddr << daddr << oif << segmentSize);
+    if (segmentSize > 0 && pkt->GetSize() > segmentSize)
+    {
+        // Segment the TSO super-segment: CWR goes only on the first segment,
+        // FIN and PSH only on the last one
+        uint32_t size = pkt->GetSize();
+        for (uint32_t offset = 0; offset < size; offset += segmentSize)
+        {
+            uint32_t length = std::min(segmentSize, size - offset);
+            TcpHeader header = outgoing;
+            header.SetSequenceNumber(outgoing.GetSequenceNumber() + offset);
+            uint8_t flags = outgoing.GetFlags();
+            if (offset > 0)
+            {
+                flags &= ~TcpHeader::CWR;
+            }
+            if (offset + length < size)
+            {
+                flags &= ~(TcpHeader::FIN | TcpHeader::PSH);
+            }
+            header.SetFlags(flags);
+            SendPacket(pkt->CreateFragment(offset, length), header, saddr, daddr, oif);
+        }
+        return;
+    }
+
     if (Ipv4Address::IsMatchingType(saddr))
     {
         NS_ASSERT(Ipv4Address::IsMatchingType(daddr));
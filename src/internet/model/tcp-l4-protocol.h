@@ -222,12 +222,16 @@ class TcpL4Protocol : public IpL4Protocol
      * \param saddr The source Ipv4Address
      * \param daddr The destination Ipv4Address
      * \param oif The output interface bound. Defaults to null (unspecified).
+     * \param segmentSize If not zero, a packet larger than segmentSize is a
+     *        super-segment handed down by TSO: it is split in segments of this
+     *        size, each sent with its own header (GSO).
      */
     void SendPacket(Ptr<Packet> pkt,
                     const TcpHeader& outgoing,
                     const Address& saddr,
                     const Address& daddr,
-                    Ptr<NetDevice> oif = nullptr) const;
+                    Ptr<NetDevice> oif = nullptr,
+                    uint32_t segmentSize = 0) const;
 
     /**
      * \brief Make a socket fully operational
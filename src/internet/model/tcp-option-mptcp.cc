@@ -0,0 +1,538 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-option-mptcp.h"
+
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpOptionMpTcp");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionMpTcp);
+
+TypeId
+TcpOptionMpTcp::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpOptionMpTcp").SetParent<TcpOption>().SetGroupName("Internet");
+    return tid;
+}
+
+TcpOptionMpTcp::TcpOptionMpTcp()
+    : TcpOption()
+{
+}
+
+TcpOptionMpTcp::~TcpOptionMpTcp()
+{
+}
+
+uint8_t
+TcpOptionMpTcp::GetKind() const
+{
+    return TcpOption::MPTCP;
+}
+
+Ptr<TcpOptionMpTcp>
+TcpOptionMpTcp::CreateMpTcpOption(uint8_t subtype)
+{
+    switch (subtype)
+    {
+    case MP_CAPABLE:
+        return CreateObject<TcpOptionMpTcpCapable>();
+    case MP_JOIN:
+        return CreateObject<TcpOptionMpTcpJoin>();
+    case DSS:
+        return CreateObject<TcpOptionMpTcpDss>();
+    case ADD_ADDR:
+        return CreateObject<TcpOptionMpTcpAddAddr>();
+    }
+
+    NS_LOG_WARN("Multipath TCP option subtype " << static_cast<int>(subtype) << " unknown");
+    return nullptr;
+}
+
+void
+TcpOptionMpTcp::SerializeRef(Buffer::Iterator& i, uint8_t low) const
+{
+    i.WriteU8(GetKind());                          // Kind
+    i.WriteU8(GetSerializedSize());                // Length
+    i.WriteU8((GetSubType() << 4) | (low & 0x0f)); // Subtype
+}
+
+bool
+TcpOptionMpTcp::DeserializeRef(Buffer::Iterator& i, uint8_t& length, uint8_t& low) const
+{
+    uint8_t readKind = i.ReadU8();
+    if (readKind != GetKind())
+    {
+        NS_LOG_WARN("Malformed Multipath TCP option");
+        return false;
+    }
+    length = i.ReadU8();
+    uint8_t subtype = i.ReadU8();
+    if ((subtype >> 4) != GetSubType())
+    {
+        NS_LOG_WARN("Malformed Multipath TCP option, wrong subtype " << (subtype >> 4));
+        return false;
+    }
+    low = subtype & 0x0f;
+    return true;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionMpTcpCapable);
+
+TcpOptionMpTcpCapable::TcpOptionMpTcpCapable()
+    : TcpOptionMpTcp(),
+      m_senderKey(0)
+{
+}
+
+TcpOptionMpTcpCapable::~TcpOptionMpTcpCapable()
+{
+}
+
+TypeId
+TcpOptionMpTcpCapable::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOptionMpTcpCapable")
+                            .SetParent<TcpOptionMpTcp>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpOptionMpTcpCapable>();
+    return tid;
+}
+
+TypeId
+TcpOptionMpTcpCapable::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+TcpOptionMpTcpCapable::Print(std::ostream& os) const
+{
+    os << "MP_CAPABLE key=" << m_senderKey;
+}
+
+uint32_t
+TcpOptionMpTcpCapable::GetSerializedSize() const
+{
+    return 12;
+}
+
+void
+TcpOptionMpTcpCapable::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    SerializeRef(i, 1); // Version 1
+    i.WriteU8(0);       // Flags
+    i.WriteHtonU64(m_senderKey);
+}
+
+uint32_t
+TcpOptionMpTcpCapable::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t length;
+    uint8_t version;
+    if (!DeserializeRef(i, length, version) || length != GetSerializedSize())
+    {
+        NS_LOG_WARN("Malformed MP_CAPABLE option");
+        return 0;
+    }
+    i.ReadU8(); // Flags
+    m_senderKey = i.ReadNtohU64();
+    return GetSerializedSize();
+}
+
+TcpOptionMpTcp::SubType
+TcpOptionMpTcpCapable::GetSubType() const
+{
+    return MP_CAPABLE;
+}
+
+void
+TcpOptionMpTcpCapable::SetSenderKey(uint64_t key)
+{
+    m_senderKey = key;
+}
+
+uint64_t
+TcpOptionMpTcpCapable::GetSenderKey() const
+{
+    return m_senderKey;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionMpTcpJoin);
+
+TcpOptionMpTcpJoin::TcpOptionMpTcpJoin()
+    : TcpOptionMpTcp(),
+      m_token(0),
+      m_addressId(0)
+{
+}
+
+TcpOptionMpTcpJoin::~TcpOptionMpTcpJoin()
+{
+}
+
+TypeId
+TcpOptionMpTcpJoin::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOptionMpTcpJoin")
+                            .SetParent<TcpOptionMpTcp>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpOptionMpTcpJoin>();
+    return tid;
+}
+
+TypeId
+TcpOptionMpTcpJoin::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+TcpOptionMpTcpJoin::Print(std::ostream& os) const
+{
+    os << "MP_JOIN token=" << m_token << " id=" << static_cast<int>(m_addressId);
+}
+
+uint32_t
+TcpOptionMpTcpJoin::GetSerializedSize() const
+{
+    return 12;
+}
+
+void
+TcpOptionMpTcpJoin::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    SerializeRef(i, 0);
+    i.WriteU8(m_addressId);
+    i.WriteHtonU32(m_token);
+    i.WriteHtonU32(0); // Sender random number, unused without HMAC
+}
+
+uint32_t
+TcpOptionMpTcpJoin::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t length;
+    uint8_t flags;
+    if (!DeserializeRef(i, length, flags) || length != GetSerializedSize())
+    {
+        NS_LOG_WARN("Malformed MP_JOIN option");
+        return 0;
+    }
+    m_addressId = i.ReadU8();
+    m_token = i.ReadNtohU32();
+    i.ReadNtohU32();
+    return GetSerializedSize();
+}
+
+TcpOptionMpTcp::SubType
+TcpOptionMpTcpJoin::GetSubType() const
+{
+    return MP_JOIN;
+}
+
+void
+TcpOptionMpTcpJoin::SetToken(uint32_t token)
+{
+    m_token = token;
+}
+
+uint32_t
+TcpOptionMpTcpJoin::GetToken() const
+{
+    return m_token;
+}
+
+void
+TcpOptionMpTcpJoin::SetAddressId(uint8_t addressId)
+{
+    m_addressId = addressId;
+}
+
+uint8_t
+TcpOptionMpTcpJoin::GetAddressId() const
+{
+    return m_addressId;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionMpTcpDss);
+
+TcpOptionMpTcpDss::TcpOptionMpTcpDss()
+    : TcpOptionMpTcp(),
+      m_flags(0),
+      m_length(0)
+{
+}
+
+TcpOptionMpTcpDss::~TcpOptionMpTcpDss()
+{
+}
+
+TypeId
+TcpOptionMpTcpDss::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOptionMpTcpDss")
+                            .SetParent<TcpOptionMpTcp>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpOptionMpTcpDss>();
+    return tid;
+}
+
+TypeId
+TcpOptionMpTcpDss::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+TcpOptionMpTcpDss::Print(std::ostream& os) const
+{
+    os << "DSS";
+    if (HasDataAck())
+    {
+        os << " dack=" << m_dataAck;
+    }
+    if (HasMapping())
+    {
+        os << " dsn=" << m_dataSeq << " ssn=" << m_subflowSeq << " len=" << m_length;
+    }
+}
+
+uint32_t
+TcpOptionMpTcpDss::GetSerializedSize() const
+{
+    uint32_t size = 4;
+    if (HasDataAck())
+    {
+        size += 4;
+    }
+    if (HasMapping())
+    {
+        size += 10;
+    }
+    return size;
+}
+
+void
+TcpOptionMpTcpDss::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    SerializeRef(i, 0);
+    i.WriteU8(m_flags);
+    if (HasDataAck())
+    {
+        i.WriteHtonU32(m_dataAck.GetValue());
+    }
+    if (HasMapping())
+    {
+        i.WriteHtonU32(m_dataSeq.GetValue());
+        i.WriteHtonU32(m_subflowSeq.GetValue());
+        i.WriteHtonU16(m_length);
+    }
+}
+
+uint32_t
+TcpOptionMpTcpDss::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t length;
+    uint8_t reserved;
+    if (!DeserializeRef(i, length, reserved))
+    {
+        NS_LOG_WARN("Malformed DSS option");
+        return 0;
+    }
+    m_flags = i.ReadU8();
+    if (length != GetSerializedSize())
+    {
+        NS_LOG_WARN("Malformed DSS option, length " << static_cast<int>(length));
+        return 0;
+    }
+    if (HasDataAck())
+    {
+        m_dataAck = SequenceNumber32(i.ReadNtohU32());
+    }
+    if (HasMapping())
+    {
+        m_dataSeq = SequenceNumber32(i.ReadNtohU32());
+        m_subflowSeq = SequenceNumber32(i.ReadNtohU32());
+        m_length = i.ReadNtohU16();
+    }
+    return GetSerializedSize();
+}
+
+TcpOptionMpTcp::SubType
+TcpOptionMpTcpDss::GetSubType() const
+{
+    return DSS;
+}
+
+void
+TcpOptionMpTcpDss::SetDataAck(SequenceNumber32 dataAck)
+{
+    m_flags |= DATA_ACK;
+    m_dataAck = dataAck;
+}
+
+bool
+TcpOptionMpTcpDss::HasDataAck() const
+{
+    return m_flags & DATA_ACK;
+}
+
+SequenceNumber32
+TcpOptionMpTcpDss::GetDataAck() const
+{
+    NS_ASSERT(HasDataAck());
+    return m_dataAck;
+}
+
+void
+TcpOptionMpTcpDss::SetMapping(SequenceNumber32 dataSeq,
+                              SequenceNumber32 subflowSeq,
+                              uint16_t length)
+{
+    m_flags |= MAPPING;
+    m_dataSeq = dataSeq;
+    m_subflowSeq = subflowSeq;
+    m_length = length;
+}
+
+bool
+TcpOptionMpTcpDss::HasMapping() const
+{
+    return m_flags & MAPPING;
+}
+
+SequenceNumber32
+TcpOptionMpTcpDss::GetDataSequence() const
+{
+    NS_ASSERT(HasMapping());
+    return m_dataSeq;
+}
+
+SequenceNumber32
+TcpOptionMpTcpDss::GetSubflowSequence() const
+{
+    NS_ASSERT(HasMapping());
+    return m_subflowSeq;
+}
+
+uint16_t
+TcpOptionMpTcpDss::GetMappingLength() const
+{
+    NS_ASSERT(HasMapping());
+    return m_length;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(TcpOptionMpTcpAddAddr);
+
+TcpOptionMpTcpAddAddr::TcpOptionMpTcpAddAddr()
+    : TcpOptionMpTcp(),
+      m_addressId(0)
+{
+}
+
+TcpOptionMpTcpAddAddr::~TcpOptionMpTcpAddAddr()
+{
+}
+
+TypeId
+TcpOptionMpTcpAddAddr::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpOptionMpTcpAddAddr")
+                            .SetParent<TcpOptionMpTcp>()
+                            .SetGroupName("Internet")
+                            .AddConstructor<TcpOptionMpTcpAddAddr>();
+    return tid;
+}
+
+TypeId
+TcpOptionMpTcpAddAddr::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+void
+TcpOptionMpTcpAddAddr::Print(std::ostream& os) const
+{
+    os << "ADD_ADDR id=" << static_cast<int>(m_addressId) << " addr=" << m_address;
+}
+
+uint32_t
+TcpOptionMpTcpAddAddr::GetSerializedSize() const
+{
+    return 8;
+}
+
+void
+TcpOptionMpTcpAddAddr::Serialize(Buffer::Iterator start) const
+{
+    Buffer::Iterator i = start;
+    SerializeRef(i, 0);
+    i.WriteU8(m_addressId);
+    i.WriteHtonU32(m_address.Get());
+}
+
+uint32_t
+TcpOptionMpTcpAddAddr::Deserialize(Buffer::Iterator start)
+{
+    Buffer::Iterator i = start;
+    uint8_t length;
+    uint8_t flags;
+    if (!DeserializeRef(i, length, flags) || length != GetSerializedSize())
+    {
+        NS_LOG_WARN("Malformed ADD_ADDR option");
+        return 0;
+    }
+    m_addressId = i.ReadU8();
+    m_address = Ipv4Address(i.ReadNtohU32());
+    return GetSerializedSize();
+}
+
+TcpOptionMpTcp::SubType
+TcpOptionMpTcpAddAddr::GetSubType() const
+{
+    return ADD_ADDR;
+}
+
+void
+TcpOptionMpTcpAddAddr::SetAddress(uint8_t addressId, Ipv4Address address)
+{
+    m_addressId = addressId;
+    m_address = address;
+}
+
+uint8_t
+TcpOptionMpTcpAddAddr::GetAddressId() const
+{
+    return m_addressId;
+}
+
+Ipv4Address
+TcpOptionMpTcpAddAddr::GetAddress() const
+{
+    return m_address;
+}
+
+} // namespace ns3
@@ -0,0 +1,318 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_OPTION_MPTCP_H
+#define TCP_OPTION_MPTCP_H
+
+#include "ns3/ipv4-address.h"
+#include "ns3/sequence-number.h"
+#include "ns3/tcp-option.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * \brief Base class of the TCP options of kind 30 (Multipath TCP), \RFC{8684}
+ *
+ * All the Multipath TCP options share the same kind and are distinguished by
+ * the subtype carried in the upper 4 bits of their third byte. Sequence
+ * numbers are carried in their 4-byte form and no checksum is used.
+ */
+class TcpOptionMpTcp : public TcpOption
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief The Multipath TCP option subtypes
+     */
+    enum SubType
+    {
+        MP_CAPABLE = 0, //!< Multipath capable
+        MP_JOIN = 1,    //!< Join a connection
+        DSS = 2,        //!< Data sequence signal
+        ADD_ADDR = 3    //!< Add address
+    };
+
+    TcpOptionMpTcp();
+    ~TcpOptionMpTcp() override;
+
+    uint8_t GetKind() const override;
+
+    /**
+     * \brief Get the subtype of the option
+     * \return the subtype
+     */
+    virtual SubType GetSubType() const = 0;
+
+    /**
+     * \brief Create a Multipath TCP option of the given subtype
+     * \param subtype the subtype
+     * \return the option, or nullptr if the subtype is not supported
+     */
+    static Ptr<TcpOptionMpTcp> CreateMpTcpOption(uint8_t subtype);
+
+  protected:
+    /**
+     * \brief Write the kind, the length and the subtype of the option
+     * \param i the iterator to write to
+     * \param low the lower 4 bits of the subtype byte
+     */
+    void SerializeRef(Buffer::Iterator& i, uint8_t low) const;
+
+    /**
+     * \brief Read and check the kind, the length and the subtype of the option
+     * \param i the iterator to read from
+     * \param [out] length the length of the option
+     * \param [out] low the lower 4 bits of the subtype byte
+     * \return true if the kind and the subtype match this option
+     */
+    bool DeserializeRef(Buffer::Iterator& i, uint8_t& length, uint8_t& low) const;
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The MP_CAPABLE option, carrying the key of the sender in the SYN
+ *        and in the SYN+ACK of the first subflow of a connection
+ */
+class TcpOptionMpTcpCapable : public TcpOptionMpTcp
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    TcpOptionMpTcpCapable();
+    ~TcpOptionMpTcpCapable() override;
+
+    void Print(std::ostream& os) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    uint32_t GetSerializedSize() const override;
+    SubType GetSubType() const override;
+
+    /**
+     * \brief Set the key of the sender
+     * \param key the key
+     */
+    void SetSenderKey(uint64_t key);
+    /**
+     * \brief Get the key of the sender
+     * \return the key
+     */
+    uint64_t GetSenderKey() const;
+
+  private:
+    uint64_t m_senderKey; //!< The key of the sender
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The MP_JOIN option, carrying the token of the connection that the
+ *        SYN of an additional subflow joins
+ */
+class TcpOptionMpTcpJoin : public TcpOptionMpTcp
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    TcpOptionMpTcpJoin();
+    ~TcpOptionMpTcpJoin() override;
+
+    void Print(std::ostream& os) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    uint32_t GetSerializedSize() const override;
+    SubType GetSubType() const override;
+
+    /**
+     * \brief Set the token of the connection of the receiver
+     * \param token the token
+     */
+    void SetToken(uint32_t token);
+    /**
+     * \brief Get the token of the connection of the receiver
+     * \return the token
+     */
+    uint32_t GetToken() const;
+    /**
+     * \brief Set the identifier of the address of the sender
+     * \param addressId the address identifier
+     */
+    void SetAddressId(uint8_t addressId);
+    /**
+     * \brief Get the identifier of the address of the sender
+     * \return the address identifier
+     */
+    uint8_t GetAddressId() const;
+
+  private:
+    uint32_t m_token;    //!< The token of the connection of the receiver
+    uint8_t m_addressId; //!< The identifier of the address of the sender
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The DSS option, carrying a data-level acknowledgment and/or the
+ *        mapping of a range of subflow sequence numbers to data sequence
+ *        numbers
+ *
+ * A mapping may cover more bytes than the segment carrying it.
+ */
+class TcpOptionMpTcpDss : public TcpOptionMpTcp
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    TcpOptionMpTcpDss();
+    ~TcpOptionMpTcpDss() override;
+
+    void Print(std::ostream& os) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    uint32_t GetSerializedSize() const override;
+    SubType GetSubType() const override;
+
+    /**
+     * \brief Set the data-level acknowledgment
+     * \param dataAck the next data sequence number expected
+     */
+    void SetDataAck(SequenceNumber32 dataAck);
+    /**
+     * \brief Check whether the option carries a data-level acknowledgment
+     * \return true if a data-level acknowledgment is present
+     */
+    bool HasDataAck() const;
+    /**
+     * \brief Get the data-level acknowledgment
+     * \return the next data sequence number expected
+     */
+    SequenceNumber32 GetDataAck() const;
+
+    /**
+     * \brief Set the mapping carried by the option
+     * \param dataSeq the data sequence number of the first byte
+     * \param subflowSeq the subflow sequence number of the first byte
+     * \param length the number of bytes mapped
+     */
+    void SetMapping(SequenceNumber32 dataSeq, SequenceNumber32 subflowSeq, uint16_t length);
+    /**
+     * \brief Check whether the option carries a mapping
+     * \return true if a mapping is present
+     */
+    bool HasMapping() const;
+    /**
+     * \brief Get the data sequence number of the first byte mapped
+     * \return the data sequence number
+     */
+    SequenceNumber32 GetDataSequence() const;
+    /**
+     * \brief Get the subflow sequence number of the first byte mapped
+     * \return the subflow sequence number
+     */
+    SequenceNumber32 GetSubflowSequence() const;
+    /**
+     * \brief Get the number of bytes mapped
+     * \return the length of the mapping
+     */
+    uint16_t GetMappingLength() const;
+
+  private:
+    /// Flags of the DSS option
+    enum Flags
+    {
+        DATA_ACK = 0x01, //!< A data-level acknowledgment is present
+        MAPPING = 0x04   //!< A mapping is present
+    };
+
+    uint8_t m_flags;               //!< The flags of the option
+    SequenceNumber32 m_dataAck;    //!< The data-level acknowledgment
+    SequenceNumber32 m_dataSeq;    //!< The data sequence number of the mapping
+    SequenceNumber32 m_subflowSeq; //!< The subflow sequence number of the mapping
+    uint16_t m_length;             //!< The length of the mapping
+};
+
+/**
+ * \ingroup tcp
+ *
+ * \brief The ADD_ADDR option, advertising an additional IPv4 address of
+ *        the sender, to which the peer can open subflows
+ */
+class TcpOptionMpTcpAddAddr : public TcpOptionMpTcp
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    TypeId GetInstanceTypeId() const override;
+
+    TcpOptionMpTcpAddAddr();
+    ~TcpOptionMpTcpAddAddr() override;
+
+    void Print(std::ostream& os) const override;
+    void Serialize(Buffer::Iterator start) const override;
+    uint32_t Deserialize(Buffer::Iterator start) override;
+    uint32_t GetSerializedSize() const override;
+    SubType GetSubType() const override;
+
+    /**
+     * \brief Set the address advertised
+     * \param addressId the identifier of the address
+     * \param address the address
+     */
+    void SetAddress(uint8_t addressId, Ipv4Address address);
+    /**
+     * \brief Get the identifier of the address advertised
+     * \return the address identifier
+     */
+    uint8_t GetAddressId() const;
+    /**
+     * \brief Get the address advertised
+     * \return the address
+     */
+    Ipv4Address GetAddress() const;
+
+  private:
+    uint8_t m_addressId;   //!< The identifier of the address
+    Ipv4Address m_address; //!< The address advertised
+};
+
+} // namespace ns3
+
+#endif /* TCP_OPTION_MPTCP_H */
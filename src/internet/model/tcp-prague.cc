@@ -0,0 +1,121 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "tcp-prague.h"
+
+#include "ns3/boolean.h"
+#include "ns3/log.h"
+#include "ns3/tcp-socket-state.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("TcpPrague");
+
+NS_OBJECT_ENSURE_REGISTERED(TcpPrague);
+
+TypeId
+TcpPrague::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::TcpPrague")
+            .SetParent<TcpDctcp>()
+            .AddConstructor<TcpPrague>()
+            .SetGroupName("Internet")
+            .AddAttribute("RttTarget",
+                          "RTT below which the additive increase is scaled",
+                          TimeValue(MilliSeconds(25)),
+                          MakeTimeAccessor(&TcpPrague::m_rttTarget),
+                          MakeTimeChecker())
+            .AddAttribute("RttScaling",
+                          "Scale the additive increase of the flows whose RTT is below the target",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&TcpPrague::m_rttScaling),
+                          MakeBooleanChecker());
+    return tid;
+}
+
+std::string
+TcpPrague::GetName() const
+{
+    return "TcpPrague";
+}
+
+TcpPrague::TcpPrague()
+    : TcpDctcp()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpPrague::TcpPrague(const TcpPrague& sock)
+    : TcpDctcp(sock),
+      m_rttTarget(sock.m_rttTarget),
+      m_rttScaling(sock.m_rttScaling),
+      m_aiAcked(sock.m_aiAcked)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+TcpPrague::~TcpPrague()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+Ptr<TcpCongestionOps>
+TcpPrague::Fork()
+{
+    NS_LOG_FUNCTION(this);
+    return CopyObject<TcpPrague>(this);
+}
+
+void
+TcpPrague::Init(Ptr<TcpSocketState> tcb)
+{
+    NS_LOG_FUNCTION(this << tcb);
+    TcpDctcp::Init(tcb);
+    NS_LOG_INFO(this << "Using ECT(1) for TCP Prague");
+    tcb->m_ectCodePoint = TcpSocketState::Ect1;
+}
+
+void
+TcpPrague::CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked)
+{
+    NS_LOG_FUNCTION(this << tcb << segmentsAcked);
+
+    double scale = 1;
+    Time rtt = tcb->m_lastRtt;
+    if (m_rttScaling && rtt.IsStrictlyPositive() && rtt < m_rttTarget)
+    {
+        double ratio = rtt.GetDouble() / m_rttTarget.GetDouble();
+        scale = ratio * ratio;
+    }
+
+    // Floor w to 1 if w == 0
+    uint32_t w = std::max<uint32_t>(tcb->m_cWnd / tcb->m_segmentSize, 1);
+
+    m_aiAcked += segmentsAcked * scale;
+    if (m_aiAcked >= w)
+    {
+        auto delta = static_cast<uint32_t>(m_aiAcked / w);
+        m_aiAcked -= delta * w;
+        tcb->m_cWnd += delta * tcb->m_segmentSize;
+    }
+    NS_LOG_DEBUG("At end of CongestionAvoidance(), m_cWnd: " << tcb->m_cWnd << " scale: " << scale
+                                                             << " acked: " << m_aiAcked);
+}
+
+} // namespace ns3
@@ -0,0 +1,94 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef TCP_PRAGUE_H
+#define TCP_PRAGUE_H
+
+#include "ns3/nstime.h"
+#include "ns3/tcp-dctcp.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup tcp
+ *
+ * \brief A TCP Prague congestion control for L4S
+ *
+ * TCP Prague reacts to ECN marks as DCTCP, i.e., in proportion to the
+ * fraction of marked bytes, and always sends ECT(1) packets, so that they
+ * are classified as L4S by a dual-queue AQM such as DualPI2. Besides, the
+ * additive increase of flows whose RTT is below a target RTT is scaled by
+ * the square of the ratio between their RTT and the target RTT, so that
+ * these flows do not gain rate faster than a flow with the target RTT.
+ */
+class TcpPrague : public TcpDctcp
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * Create an unbound tcp socket.
+     */
+    TcpPrague();
+
+    /**
+     * \brief Copy constructor
+     * \param sock the object to copy
+     */
+    TcpPrague(const TcpPrague& sock);
+
+    /**
+     * \brief Destructor
+     */
+    ~TcpPrague() override;
+
+    // Documented in base class
+    std::string GetName() const override;
+    Ptr<TcpCongestionOps> Fork() override;
+
+    /**
+     * \brief Set configuration required by congestion control algorithm,
+     *        This method will force DctcpEcn mode and will force usage of
+     *        ECT(1), despite any other configuration in the base classes.
+     *
+     * \param tcb internal congestion state
+     */
+    void Init(Ptr<TcpSocketState> tcb) override;
+
+  protected:
+    /**
+     * \brief Increase the congestion window by one segment per RTT, scaled by
+     *        the square of the ratio between the RTT and the target RTT if the
+     *        former is lower
+     *
+     * \param tcb internal congestion state
+     * \param segmentsAcked count of segments acked
+     */
+    void CongestionAvoidance(Ptr<TcpSocketState> tcb, uint32_t segmentsAcked) override;
+
+  private:
+    Time m_rttTarget;    //!< RTT below which the additive increase is scaled
+    bool m_rttScaling;   //!< Whether the additive increase is scaled
+    double m_aiAcked{0}; //!< Scaled number of segments acked since the last increase
+};
+
+} // namespace ns3
+
+#endif /* TCP_PRAGUE_H */
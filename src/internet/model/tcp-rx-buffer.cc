@@ -172,8 +172,13 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
             headSeq = tailSeq;
         }
     }
-    // Remove overlapped bytes from packet
-    BufIterator i = m_data.begin();
+    // Remove overlapped bytes from packet. Buffered packets do not overlap each
+    // other, so only the one before headSeq can cover the head of the new packet.
+    BufIterator i = m_data.lower_bound(headSeq);
+    if (i != m_data.begin())
+    {
+        --i;
+    }
     while (i != m_data.end() && i->first <= tailSeq)
     {
         SequenceNumber32 lastByteSeq = i->first + SequenceNumber32(i->second->GetSize());
@@ -212,28 +217,24 @@ TcpRxBuffer::Add(Ptr<Packet> p, const TcpHeader& tcph)
     // Insert packet into buffer
     NS_ASSERT(m_data.find(headSeq) == m_data.end()); // Shouldn't be there yet
     m_data[headSeq] = p;
+    RangeIterator range = InsertRange(headSeq, tailSeq);
 
     if (headSeq > m_nextRxSeq)
     {
-        // Generate a new SACK block
-        UpdateSackList(headSeq, tailSeq);
+        // Generate a new SACK block, reporting the whole contiguous block
+        // that contains this segment
+        UpdateSackList(range->first, range->second);
     }
 
     NS_LOG_LOGIC("Buffered packet of seqno=" << headSeq << " len=" << p->GetSize());
     // Update variables
     m_size += p->GetSize(); // Occupancy
-    for (i = m_data.begin(); i != m_data.end(); ++i)
+    range = m_ranges.begin();
+    if (range->first == m_nextRxSeq)
     {
-        if (i->first < m_nextRxSeq)
-        {
-            continue;
-        }
-        else if (i->first > m_nextRxSeq)
-        {
-            break;
-        };
-        m_nextRxSeq = i->first + SequenceNumber32(i->second->GetSize());
-        m_availBytes += i->second->GetSize();
+        m_nextRxSeq = range->second;
+        m_availBytes += range->second - range->first;
+        m_ranges.erase(range);
         ClearSackList(m_nextRxSeq);
     }
     NS_LOG_LOGIC("Updated buffer occupancy=" << m_size << " nextRxSeq=" << m_nextRxSeq);
@@ -252,6 +253,43 @@ TcpRxBuffer::GetSackListSize() const
     return static_cast<uint32_t>(m_sackList.size());
 }
 
+TcpRxBuffer::RangeIterator
+TcpRxBuffer::InsertRange(const SequenceNumber32& head, const SequenceNumber32& tail)
+{
+    NS_LOG_FUNCTION(this << head << tail);
+
+    SequenceNumber32 first = head;
+    SequenceNumber32 second = tail;
+
+    // Merge with the block on the left, if it overlaps or touches the head
+    RangeIterator it = m_ranges.upper_bound(first);
+    if (it != m_ranges.begin())
+    {
+        RangeIterator prev = std::prev(it);
+        if (prev->second >= first)
+        {
+            first = prev->first;
+            if (prev->second > second)
+            {
+                second = prev->second;
+            }
+            m_ranges.erase(prev);
+        }
+    }
+
+    // Merge with the blocks on the right, covered or touched by the tail
+    while (it != m_ranges.end() && it->first <= second)
+    {
+        if (it->second > second)
+        {
+            second = it->second;
+        }
+        it = m_ranges.erase(it);
+    }
+
+    return m_ranges.emplace_hint(it, first, second);
+}
+
 void
 TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32& tail)
 {
@@ -288,65 +326,30 @@ TcpRxBuffer::UpdateSackList(const SequenceNumber32& head, const SequenceNumber32
     //     following SACK blocks in the SACK option may be listed in
     //     arbitrary order.
 
-    m_sackList.push_front(current);
-
-    // We have inserted the block at the beginning of the list. Now, we should
-    // check if any existing blocks overlap with that.
-    bool updated = false;
+    // The block is already the whole contiguous block containing the segment,
+    // as kept in m_ranges: any previously reported block touching it is a
+    // subset, and it is removed before inserting the block at the beginning.
     TcpOptionSack::SackList::iterator it = m_sackList.begin();
-    TcpOptionSack::SackBlock begin = *it;
-    TcpOptionSack::SackBlock merged;
-    ++it;
-
-    // Iterates until we examined all blocks in the list (maximum 4)
     while (it != m_sackList.end())
     {
-        current = *it;
-
-        // This is a left merge:
-        // [current_first; current_second] [beg_first; beg_second]
-        if (begin.first == current.second)
-        {
-            NS_ASSERT(current.first < begin.second);
-            merged = TcpOptionSack::SackBlock(current.first, begin.second);
-            updated = true;
-        }
-        // while this is a right merge
-        // [begin_first; begin_second] [current_first; current_second]
-        else if (begin.second == current.first)
+        if (it->first >= current.first && it->second <= current.second)
         {
-            NS_ASSERT(begin.first < current.second);
-            merged = TcpOptionSack::SackBlock(begin.first, current.second);
-            updated = true;
+            it = m_sackList.erase(it);
         }
-
-        // If we have merged the blocks (and the result is in merged) we should
-        // delete the current block (it), the first block, and insert the merged
-        // one at the beginning.
-        if (updated)
+        else
         {
-            m_sackList.erase(it);
-            m_sackList.pop_front();
-            m_sackList.push_front(merged);
-            it = m_sackList.begin();
-            begin = *it;
-            updated = false;
+            ++it;
         }
-
-        ++it;
     }
 
+    m_sackList.push_front(current);
+
     // Since the maximum blocks that fits into a TCP header are 4, there's no
     // point on maintaining the others.
     if (m_sackList.size() > 4)
     {
         m_sackList.pop_back();
     }
-
-    // Please note that, if a block b is discarded and then a block contiguous
-    // to b is received, only that new block (without the b part) is reported.
-    // This is perfectly fine for the RFC point (a), given that we do not report any
-    // overlapping blocks shortly after.
 }
 
 void
@@ -389,8 +392,8 @@ TcpRxBuffer::Extract(uint32_t maxSize)
     {
         return nullptr; // No contiguous block to return
     }
-    NS_ASSERT(m_data.size());              // At least we have something to extract
-    Ptr<Packet> outPkt = Create<Packet>(); // The packet that contains all the data to return
+    NS_ASSERT(m_data.size()); // At least we have something to extract
+    Ptr<Packet> outPkt;       // The packet that contains all the data to return
     BufIterator i;
     while (extractSize)
     { // Check the buffered data for delivery
@@ -400,7 +403,16 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         uint32_t pktSize = i->second->GetSize();
         if (pktSize <= extractSize)
         { // Whole packet is extracted
-            outPkt->AddAtEnd(i->second);
+            if (!outPkt)
+            {
+                // Buffered packets are owned only by the buffer (see Add), so
+                // the first one can be returned without copying it
+                outPkt = i->second;
+            }
+            else
+            {
+                outPkt->AddAtEnd(i->second);
+            }
             m_data.erase(i);
             m_size -= pktSize;
             m_availBytes -= pktSize;
@@ -408,7 +420,14 @@ TcpRxBuffer::Extract(uint32_t maxSize)
         }
         else
         { // Partial is extracted and done
-            outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
+            if (!outPkt)
+            {
+                outPkt = i->second->CreateFragment(0, extractSize);
+            }
+            else
+            {
+                outPkt->AddAtEnd(i->second->CreateFragment(0, extractSize));
+            }
             m_data[i->first + SequenceNumber32(extractSize)] =
                 i->second->CreateFragment(extractSize, pktSize - extractSize);
             m_data.erase(i);
@@ -417,7 +436,7 @@ TcpRxBuffer::Extract(uint32_t maxSize)
             extractSize = 0;
         }
     }
-    if (outPkt->GetSize() == 0)
+    if (!outPkt || outPkt->GetSize() == 0)
     {
         NS_LOG_LOGIC("Nothing extracted.");
         return nullptr;
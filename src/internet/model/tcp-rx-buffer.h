@@ -69,6 +69,18 @@ class Packet;
  * For more information about the SACK list, please check the documentation of
  * the method GetSackList.
  *
+ * Reassembly
+ * ----------
+ *
+ * Segments are stored as received (after trimming the bytes already buffered),
+ * indexed by their first sequence number. Besides them, the buffer keeps the
+ * contiguous blocks of data above RCV.NXT in m_ranges, merging adjacent
+ * blocks when a segment fills the gap between them. In this way, an
+ * out-of-order segment only touches its neighbours: the SACK block to report
+ * is the block containing the segment, and when a hole at RCV.NXT is filled,
+ * RCV.NXT jumps at the end of the following block without walking the
+ * buffered segments.
+ *
  * \see GetSackList
  * \see UpdateSackList
  */
@@ -220,6 +232,21 @@ class TcpRxBuffer : public Object
      */
     void ClearSackList(const SequenceNumber32& seq);
 
+    /// Contiguous blocks of data, from the first sequence to the sequence after the last byte
+    typedef std::map<SequenceNumber32, SequenceNumber32> RangeMap;
+    typedef RangeMap::iterator RangeIterator; //!< Iterator over the contiguous blocks
+
+    /**
+     * \brief Add a block of data to the contiguous blocks
+     *
+     * The block is merged with the blocks it overlaps or touches.
+     *
+     * \param head sequence number of the first byte of the block
+     * \param tail sequence number after the last byte of the block
+     * \return the contiguous block containing the added data
+     */
+    RangeIterator InsertRange(const SequenceNumber32& head, const SequenceNumber32& tail);
+
     TcpOptionSack::SackList m_sackList; //!< Sack list (updated constantly)
 
     /// container for data stored in the buffer
@@ -232,6 +259,7 @@ class TcpRxBuffer : public Object
     uint32_t m_maxBuffer;  //!< Upper bound of the number of data bytes in buffer (RCV.WND)
     uint32_t m_availBytes; //!< Number of bytes available to read, i.e. contiguous block at head
     std::map<SequenceNumber32, Ptr<Packet>> m_data; //!< Corresponding data (may be null)
+    RangeMap m_ranges; //!< Contiguous blocks of data above RCV.NXT
 };
 
 } // namespace ns3
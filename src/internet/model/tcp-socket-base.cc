@@ -45,6 +45,8 @@
 #include "ns3/abort.h"
 #include "ns3/data-rate.h"
 #include "ns3/double.h"
+#include "ns3/edt-tag.h"
+#include "ns3/fq-queue-disc.h"
 #include "ns3/inet-socket-address.h"
 #include "ns3/inet6-socket-address.h"
 #include "ns3/ipv4-interface-address.h"
@@ -63,6 +65,7 @@
 #include "ns3/simulator.h"
 #include "ns3/tcp-rate-ops.h"
 #include "ns3/trace-source-accessor.h"
+#include "ns3/traffic-control-layer.h"
 #include "ns3/uinteger.h"
 
 #include <algorithm>
@@ -138,6 +141,13 @@ TcpSocketBase::GetTypeId()
                 MakeTimeAccessor(&TcpSocketBase::SetClockGranularity,
                                  &TcpSocketBase::GetClockGranularity),
                 MakeTimeChecker())
+            .AddAttribute("LazyTimers",
+                          "Move the deadline of the retransmission and delayed ACK timers "
+                          "without rescheduling their simulator events",
+                          BooleanValue(true),
+                          MakeBooleanAccessor(&TcpSocketBase::SetLazyTimers,
+                                              &TcpSocketBase::GetLazyTimers),
+                          MakeBooleanChecker())
             .AddAttribute("TxBuffer",
                           "TCP Tx buffer",
                           PointerValue(),
@@ -164,6 +174,24 @@ TcpSocketBase::GetTypeId()
                           BooleanValue(true),
                           MakeBooleanAccessor(&TcpSocketBase::m_limitedTx),
                           MakeBooleanChecker())
+            .AddAttribute("TsoMaxSize",
+                          "Maximum size of the super-segments handed to TcpL4Protocol when "
+                          "new data is sent (TCP segmentation offload). Values not larger "
+                          "than the segment size disable TSO",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&TcpSocketBase::m_tsoMaxSize),
+                          MakeUintegerChecker<uint32_t>(0, 65535))
+            .AddAttribute("GroTimeout",
+                          "Time an in-order segment is held to coalesce it with the following "
+                          "ones before processing (generic receive offload). Zero disables GRO",
+                          TimeValue(Seconds(0)),
+                          MakeTimeAccessor(&TcpSocketBase::m_groTimeout),
+                          MakeTimeChecker())
+            .AddAttribute("GroMaxSize",
+                          "Maximum payload size of a segment coalesced by GRO",
+                          UintegerValue(65535),
+                          MakeUintegerAccessor(&TcpSocketBase::m_groMaxSize),
+                          MakeUintegerChecker<uint32_t>())
             .AddAttribute("UseEcn",
                           "Parameter to set ECN functionality",
                           EnumValue(TcpSocketState::Off),
@@ -371,6 +399,9 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
       m_recoverActive(sock.m_recoverActive),
       m_retxThresh(sock.m_retxThresh),
       m_limitedTx(sock.m_limitedTx),
+      m_tsoMaxSize(sock.m_tsoMaxSize),
+      m_groTimeout(sock.m_groTimeout),
+      m_groMaxSize(sock.m_groMaxSize),
       m_isFirstPartialAck(sock.m_isFirstPartialAck),
       m_txTrace(sock.m_txTrace),
       m_rxTrace(sock.m_rxTrace),
@@ -402,6 +433,7 @@ TcpSocketBase::TcpSocketBase(const TcpSocketBase& sock)
 
     m_tcb->m_pacingRate = m_tcb->m_maxPacingRate;
     m_pacingTimer.SetFunction(&TcpSocketBase::NotifyPacingPerformed, this);
+    SetLazyTimers(sock.GetLazyTimers());
 
     if (sock.m_congestionControl)
     {
@@ -774,6 +806,8 @@ int
 TcpSocketBase::Close()
 {
     NS_LOG_FUNCTION(this);
+    // Deliver the data held by GRO, as if it had not been held
+    GroFlush();
     /// \internal
     /// First we check to see if there is any unread rx data.
     /// \bugid{426} claims we should send reset in this case.
@@ -1196,20 +1230,14 @@ TcpSocketBase::ForwardUp(Ptr<Packet> packet,
         return;
     }
 
-    if (header.GetEcn() == Ipv4Header::ECN_CE && m_ecnCESeq < tcpHeader.GetSequenceNumber())
-    {
-        NS_LOG_INFO("Received CE flag is valid");
-        NS_LOG_DEBUG(TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_CE_RCVD");
-        m_ecnCESeq = tcpHeader.GetSequenceNumber();
-        m_tcb->m_ecnState = TcpSocketState::ECN_CE_RCVD;
-        m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_IS_CE);
-    }
-    else if (header.GetEcn() != Ipv4Header::ECN_NotECT &&
-             m_tcb->m_ecnState != TcpSocketState::ECN_DISABLED)
+    // GRO flushes the held segment, if needed, before returning false; the
+    // ECN state is then updated for this segment only
+    if (m_groTimeout.IsStrictlyPositive() &&
+        GroReceive(packet, header.GetEcn(), fromAddress, toAddress))
     {
-        m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_NO_CE);
+        return;
     }
-
+    ProcessEcnCodepoint(header.GetEcn(), tcpHeader.GetSequenceNumber());
     DoForwardUp(packet, fromAddress, toAddress);
 }
 
@@ -1236,20 +1264,119 @@ TcpSocketBase::ForwardUp6(Ptr<Packet> packet,
         return;
     }
 
-    if (header.GetEcn() == Ipv6Header::ECN_CE && m_ecnCESeq < tcpHeader.GetSequenceNumber())
+    auto ecn = static_cast<Ipv4Header::EcnType>(header.GetEcn());
+    if (m_groTimeout.IsStrictlyPositive() && GroReceive(packet, ecn, fromAddress, toAddress))
+    {
+        return;
+    }
+    ProcessEcnCodepoint(ecn, tcpHeader.GetSequenceNumber());
+    DoForwardUp(packet, fromAddress, toAddress);
+}
+
+void
+TcpSocketBase::ProcessEcnCodepoint(Ipv4Header::EcnType ecn, SequenceNumber32 seq)
+{
+    NS_LOG_FUNCTION(this << ecn << seq);
+
+    if (ecn == Ipv4Header::ECN_CE && m_ecnCESeq < seq)
     {
         NS_LOG_INFO("Received CE flag is valid");
         NS_LOG_DEBUG(TcpSocketState::EcnStateName[m_tcb->m_ecnState] << " -> ECN_CE_RCVD");
-        m_ecnCESeq = tcpHeader.GetSequenceNumber();
+        m_ecnCESeq = seq;
         m_tcb->m_ecnState = TcpSocketState::ECN_CE_RCVD;
         m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_IS_CE);
     }
-    else if (header.GetEcn() != Ipv6Header::ECN_NotECT)
+    else if (ecn != Ipv4Header::ECN_NotECT && m_tcb->m_ecnState != TcpSocketState::ECN_DISABLED)
     {
         m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_ECN_NO_CE);
     }
+}
 
-    DoForwardUp(packet, fromAddress, toAddress);
+bool
+TcpSocketBase::GroReceive(Ptr<Packet> packet,
+                          Ipv4Header::EcnType ecn,
+                          const Address& fromAddress,
+                          const Address& toAddress)
+{
+    NS_LOG_FUNCTION(this << packet);
+
+    TcpHeader tcpHeader;
+    uint32_t headerSize = packet->PeekHeader(tcpHeader);
+    uint32_t payloadSize = packet->GetSize() - headerSize;
+
+    // Only pure, in-sequence data segments are coalesced: anything carrying
+    // information that must be processed on its own flushes the held segment
+    if (m_state != ESTABLISHED || payloadSize == 0 ||
+        (tcpHeader.GetFlags() & ~TcpHeader::PSH) != TcpHeader::ACK ||
+        tcpHeader.HasOption(TcpOption::SACKPERMITTED) || tcpHeader.HasOption(TcpOption::SACK))
+    {
+        GroFlush();
+        return false;
+    }
+
+    if (m_groPacket)
+    {
+        Ptr<const TcpOptionTS> ts =
+            DynamicCast<const TcpOptionTS>(tcpHeader.GetOption(TcpOption::TS));
+        Ptr<const TcpOptionTS> heldTs =
+            DynamicCast<const TcpOptionTS>(m_groHeader.GetOption(TcpOption::TS));
+        bool sameTs = !ts && !heldTs;
+        if (ts && heldTs)
+        {
+            sameTs = ts->GetTimestamp() == heldTs->GetTimestamp() &&
+                     ts->GetEcho() == heldTs->GetEcho();
+        }
+
+        // A change of the ECN codepoint (e.g., the first CE mark) flushes the
+        // held segment, so that the marks are reported for the right bytes
+        if (sameTs && ecn == m_groEcn && tcpHeader.GetSequenceNumber() == m_groNextSeq &&
+            tcpHeader.GetAckNumber() == m_groHeader.GetAckNumber() &&
+            tcpHeader.GetWindowSize() == m_groHeader.GetWindowSize() &&
+            m_groPacket->GetSize() + payloadSize <= m_groMaxSize)
+        {
+            NS_LOG_LOGIC("Coalescing segment " << tcpHeader.GetSequenceNumber() << " into "
+                                               << m_groHeader.GetSequenceNumber());
+            packet->RemoveHeader(tcpHeader);
+            m_groPacket->AddAtEnd(packet);
+            m_groNextSeq += payloadSize;
+            return true;
+        }
+        GroFlush();
+    }
+
+    if (tcpHeader.GetSequenceNumber() != m_tcb->m_rxBuffer->NextRxSequence() ||
+        payloadSize >= m_groMaxSize)
+    {
+        // Out of order segments are processed (and SACKed) immediately
+        return false;
+    }
+
+    m_groPacket = packet->Copy();
+    m_groPacket->RemoveHeader(m_groHeader);
+    m_groNextSeq = m_groHeader.GetSequenceNumber() + payloadSize;
+    m_groFrom = fromAddress;
+    m_groTo = toAddress;
+    m_groEcn = ecn;
+    m_groFlushEvent = Simulator::Schedule(m_groTimeout, &TcpSocketBase::GroFlush, this);
+    return true;
+}
+
+void
+TcpSocketBase::GroFlush()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_groFlushEvent.Cancel();
+    if (!m_groPacket)
+    {
+        return;
+    }
+
+    Ptr<Packet> packet = m_groPacket;
+    m_groPacket = nullptr;
+    packet->AddHeader(m_groHeader);
+    ProcessEcnCodepoint(m_groEcn, m_groHeader.GetSequenceNumber());
+    DoForwardUp(packet, m_groFrom, m_groTo);
 }
 
 void
@@ -1417,7 +1544,7 @@ TcpSocketBase::DoForwardUp(Ptr<Packet> packet, const Address& fromAddress, const
         NS_LOG_LOGIC(this << " Enter zerowindow persist state");
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         NS_LOG_LOGIC("Schedule persist timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
@@ -2714,7 +2841,7 @@ TcpSocketBase::Destroy()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2730,7 +2857,7 @@ TcpSocketBase::Destroy6()
         m_tcp->RemoveSocket(this);
     }
     NS_LOG_LOGIC(this << " Cancelled ReTxTimeout event which was set to expire at "
-                      << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                      << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
     CancelAllTimers();
 }
 
@@ -2864,7 +2991,7 @@ TcpSocketBase::SendEmptyPacket(uint8_t flags)
         NS_LOG_LOGIC("Schedule retransmission timeout at time "
                      << Simulator::Now().GetSeconds() << " to expire at time "
                      << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
+        m_retxEvent.Schedule(m_rto, &TcpSocketBase::SendEmptyPacket, this, flags);
     }
 }
 
@@ -3122,12 +3249,27 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     NS_LOG_FUNCTION(this << seq << maxSize << withAck);
 
     bool isStartOfTransmission = BytesInFlight() == 0U;
-    TcpTxItem* outItem = m_txBuffer->CopyFromSequence(maxSize, seq);
+    TcpTxItem* outItem =
+        m_txBuffer->CopyFromSequence(std::min(maxSize, m_tcb->m_segmentSize), seq);
 
     m_rateOps->SkbSent(outItem, isStartOfTransmission);
 
     bool isRetransmission = outItem->IsRetrans();
     Ptr<Packet> p = outItem->GetPacketCopy();
+
+    // With TSO, the super-segment is built from MSS-sized items, so that the
+    // scoreboard still tracks (and eventually retransmits) single segments
+    while (p->GetSize() + m_tcb->m_segmentSize <= maxSize)
+    {
+        TcpTxItem* item =
+            m_txBuffer->CopyFromSequence(m_tcb->m_segmentSize, seq + p->GetSize());
+        if (item == nullptr)
+        {
+            break;
+        }
+        m_rateOps->SkbSent(item, false);
+        p->AddAtEnd(item->GetPacketCopy());
+    }
     uint32_t sz = p->GetSize(); // Size of packet
     uint8_t flags = withAck ? TcpHeader::ACK : 0;
     uint32_t remainingData = m_txBuffer->SizeFromSequence(seq + SequenceNumber32(sz));
@@ -3140,7 +3282,16 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
     if (IsPacingEnabled())
     {
         NS_LOG_INFO("Pacing is enabled");
-        if (m_pacingTimer.IsExpired())
+        if (IsEdtPacingUsed())
+        {
+            // Leave the enforcement of the pacing rate to the queue disc
+            Time departure = std::max(Simulator::Now(), m_edtNextDeparture);
+            NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
+            NS_LOG_DEBUG("Earliest departure time " << departure.As(Time::S));
+            p->AddPacketTag(EdtTag(departure));
+            m_edtNextDeparture = departure + m_tcb->m_pacingRate.Get().CalculateBytesTxTime(sz);
+        }
+        else if (m_pacingTimer.IsExpired())
         {
             NS_LOG_DEBUG("Current Pacing Rate " << m_tcb->m_pacingRate);
             NS_LOG_DEBUG("Timer is in expired state, activate it "
@@ -3213,7 +3364,7 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent.Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     m_txTrace(p, header, this);
@@ -3224,7 +3375,8 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
                           header,
                           m_endPoint->GetLocalAddress(),
                           m_endPoint->GetPeerAddress(),
-                          m_boundnetdevice);
+                          m_boundnetdevice,
+                          sz > m_tcb->m_segmentSize ? m_tcb->m_segmentSize : 0);
         NS_LOG_DEBUG("Send segment of size "
                      << sz << " with remaining data " << remainingData << " via TcpL4Protocol to "
                      << m_endPoint->GetPeerAddress() << ". Header " << header);
@@ -3235,13 +3387,19 @@ TcpSocketBase::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize, bool withA
                           header,
                           m_endPoint6->GetLocalAddress(),
                           m_endPoint6->GetPeerAddress(),
-                          m_boundnetdevice);
+                          m_boundnetdevice,
+                          sz > m_tcb->m_segmentSize ? m_tcb->m_segmentSize : 0);
         NS_LOG_DEBUG("Send segment of size "
                      << sz << " with remaining data " << remainingData << " via TcpL4Protocol to "
                      << m_endPoint6->GetPeerAddress() << ". Header " << header);
     }
 
-    UpdateRttHistory(seq, sz, isRetransmission);
+    for (uint32_t offset = 0; offset < sz; offset += m_tcb->m_segmentSize)
+    {
+        UpdateRttHistory(seq + offset,
+                         std::min(sz - offset, m_tcb->m_segmentSize),
+                         isRetransmission);
+    }
 
     // Update bytes sent during recovery phase
     if (m_tcb->m_congState == TcpSocketState::CA_RECOVERY ||
@@ -3375,6 +3533,20 @@ TcpSocketBase::SendPendingData(bool withAck)
             uint32_t maxSizeToSend = static_cast<uint32_t>(nextHigh - next);
             s = std::min(s, maxSizeToSend);
 
+            // TSO: new data is handed down as a single super-segment, which
+            // TcpL4Protocol splits again in MSS-sized segments
+            if (m_tsoMaxSize > m_tcb->m_segmentSize && s == m_tcb->m_segmentSize &&
+                next == m_tcb->m_highTxMark)
+            {
+                uint32_t rWndLeft = 0;
+                if (m_highRxAckMark.Get() + SequenceNumber32(m_rWnd.Get()) > next)
+                {
+                    rWndLeft = (m_highRxAckMark.Get() + SequenceNumber32(m_rWnd.Get())) - next;
+                }
+                uint32_t tso = std::min({m_tsoMaxSize, availableWindow, availableData, rWndLeft});
+                s = std::max(s, tso - tso % m_tcb->m_segmentSize);
+            }
+
             // (C.2) If any of the data octets sent in (C.1) are below HighData,
             //       HighRxt MUST be set to the highest sequence number of the
             //       retransmitted segment unless NextSeg () rule (4) was
@@ -3403,7 +3575,7 @@ TcpSocketBase::SendPendingData(bool withAck)
                                   << " sent seq " << m_tcb->m_nextTxSequence << " size " << sz);
             m_tcb->m_nextTxSequence += sz;
             ++nPacketsSent;
-            if (IsPacingEnabled())
+            if (IsPacingEnabled() && !IsEdtPacingUsed())
             {
                 NS_LOG_INFO("Pacing is enabled");
                 if (m_pacingTimer.IsExpired())
@@ -3584,7 +3756,14 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
     }
     else
     { // In-sequence packet: ACK if delayed ack count allows
-        if (++m_delAckCount >= m_delAckMaxCount)
+        // A segment coalesced by GRO counts as the segments it is made of
+        uint32_t segments = 1;
+        if (m_groTimeout.IsStrictlyPositive() && p->GetSize() > m_tcb->m_segmentSize)
+        {
+            segments = p->GetSize() / m_tcb->m_segmentSize;
+        }
+        m_delAckCount += segments;
+        if (m_delAckCount >= m_delAckMaxCount)
         {
             m_delAckEvent.Cancel();
             m_delAckCount = 0;
@@ -3610,11 +3789,10 @@ TcpSocketBase::ReceivedData(Ptr<Packet> p, const TcpHeader& tcpHeader)
         else if (m_delAckEvent.IsExpired())
         {
             m_congestionControl->CwndEvent(m_tcb, TcpSocketState::CA_EVENT_DELAYED_ACK);
-            m_delAckEvent =
-                Simulator::Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
+            m_delAckEvent.Schedule(m_delAckTimeout, &TcpSocketBase::DelAckTimeout, this);
             NS_LOG_LOGIC(
                 this << " scheduled delayed ACK at "
-                     << (Simulator::Now() + Simulator::GetDelayLeft(m_delAckEvent)).GetSeconds());
+                     << (Simulator::Now() + m_delAckEvent.GetDelayLeft()).GetSeconds());
         }
     }
 }
@@ -3690,7 +3868,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // Set RTO unless the ACK is received in SYN_RCVD state
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
         // On receiving a "New" ack we restart retransmission timer .. RFC 6298
         // RFC 6298, clause 2.4
@@ -3700,7 +3878,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
         NS_LOG_LOGIC(this << " Schedule ReTxTimeout at time " << Simulator::Now().GetSeconds()
                           << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
+        m_retxEvent.Schedule(m_rto, &TcpSocketBase::ReTxTimeout, this);
     }
 
     // Note the highest ACK and tell app to send more
@@ -3719,7 +3897,7 @@ TcpSocketBase::NewAck(const SequenceNumber32& ack, bool resetRTO)
     { // No retransmit timer if no data to retransmit
         NS_LOG_LOGIC(
             this << " Cancelled ReTxTimeout event which was set to expire at "
-                 << (Simulator::Now() + Simulator::GetDelayLeft(m_retxEvent)).GetSeconds());
+                 << (Simulator::Now() + m_retxEvent.GetDelayLeft()).GetSeconds());
         m_retxEvent.Cancel();
     }
 }
@@ -4002,6 +4180,13 @@ TcpSocketBase::CancelAllTimers()
     m_timewaitEvent.Cancel();
     m_sendPendingDataEvent.Cancel();
     m_pacingTimer.Cancel();
+    // The segment held by GRO is discarded without being acknowledged, as the
+    // peer will retransmit it: this is reached only when the endpoint is being
+    // deallocated (after a RST, or by the destruction of the socket), since
+    // any segment that can move the connection out of ESTABLISHED flushes the
+    // held one first, and Close() flushes it before checking for unread data
+    m_groFlushEvent.Cancel();
+    m_groPacket = nullptr;
 }
 
 /* Move TCP to Time_Wait state and schedule a transition to Closed state */
@@ -4444,6 +4629,20 @@ TcpSocketBase::GetClockGranularity() const
     return m_clockGranularity;
 }
 
+void
+TcpSocketBase::SetLazyTimers(bool lazy)
+{
+    NS_LOG_FUNCTION(this << lazy);
+    m_retxEvent.SetLazy(lazy);
+    m_delAckEvent.SetLazy(lazy);
+}
+
+bool
+TcpSocketBase::GetLazyTimers() const
+{
+    return m_retxEvent.IsLazy();
+}
+
 Ptr<TcpTxBuffer>
 TcpSocketBase::GetTxBuffer() const
 {
@@ -4588,6 +4787,64 @@ TcpSocketBase::IsPacingEnabled() const
     return false;
 }
 
+bool
+TcpSocketBase::IsEdtPacingUsed()
+{
+    if (!m_tcb->m_edtPacing)
+    {
+        return false;
+    }
+    if (m_edtChecked)
+    {
+        return m_edtUsable;
+    }
+    m_edtChecked = true;
+
+    Ptr<NetDevice> device = m_boundnetdevice;
+    if (!device && m_endPoint != nullptr)
+    {
+        Ptr<Ipv4> ipv4 = m_node->GetObject<Ipv4>();
+        int32_t interface = ipv4->GetInterfaceForAddress(m_endPoint->GetLocalAddress());
+        if (interface >= 0)
+        {
+            device = ipv4->GetNetDevice(interface);
+        }
+    }
+    else if (!device && m_endPoint6 != nullptr)
+    {
+        Ptr<Ipv6> ipv6 = m_node->GetObject<Ipv6>();
+        int32_t interface = ipv6->GetInterfaceForAddress(m_endPoint6->GetLocalAddress());
+        if (interface >= 0)
+        {
+            device = ipv6->GetNetDevice(interface);
+        }
+    }
+
+    Ptr<TrafficControlLayer> tc = m_node->GetObject<TrafficControlLayer>();
+    Ptr<QueueDisc> root = (device && tc) ? tc->GetRootQueueDiscOnDevice(device) : nullptr;
+    if (DynamicCast<FqQueueDisc>(root))
+    {
+        m_edtUsable = true;
+    }
+    else if (root && root->GetNQueueDiscClasses() > 0)
+    {
+        // e.g., an mq queue disc with a child queue disc per device queue
+        m_edtUsable = true;
+        for (std::size_t i = 0; i < root->GetNQueueDiscClasses(); i++)
+        {
+            Ptr<QueueDisc> child = root->GetQueueDiscClass(i)->GetQueueDisc();
+            m_edtUsable = m_edtUsable && DynamicCast<FqQueueDisc>(child);
+        }
+    }
+
+    if (!m_edtUsable)
+    {
+        NS_LOG_WARN("EdtPacing is set, but no FqQueueDisc is installed on the egress device of "
+                    << this << ": pacing with the pacing timer");
+    }
+    return m_edtUsable;
+}
+
 void
 TcpSocketBase::UpdatePacingRate()
 {
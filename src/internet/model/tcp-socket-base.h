@@ -26,6 +26,8 @@
 #include "ns3/ipv6-header.h"
 #include "ns3/node.h"
 #include "ns3/sequence-number.h"
+#include "ns3/tcp-deadline-timer.h"
+#include "ns3/tcp-header.h"
 #include "ns3/tcp-socket-state.h"
 #include "ns3/tcp-socket.h"
 #include "ns3/timer.h"
@@ -42,7 +44,6 @@ class Ipv6EndPoint;
 class Node;
 class Packet;
 class TcpL4Protocol;
-class TcpHeader;
 class TcpCongestionOps;
 class TcpRecoveryOps;
 class RttEstimator;
@@ -295,6 +296,20 @@ class TcpSocketBase : public TcpSocket
      */
     Time GetClockGranularity() const;
 
+    /**
+     * \brief Enable or disable the lazy re-arming of the retransmission and
+     * delayed ACK timers.
+     * \param lazy true to move the timer deadlines without rescheduling events
+     * \see TcpDeadlineTimer
+     */
+    void SetLazyTimers(bool lazy);
+
+    /**
+     * \brief Check if the retransmission and delayed ACK timers are re-armed lazily.
+     * \return true if the lazy re-arming is enabled
+     */
+    bool GetLazyTimers() const;
+
     /**
      * \brief Get a pointer to the Tx buffer
      * \return a pointer to the tx buffer
@@ -758,6 +773,44 @@ class TcpSocketBase : public TcpSocket
                              const Address& fromAddress,
                              const Address& toAddress);
 
+    /**
+     * \brief Coalesce an incoming segment with the held one (GRO).
+     *
+     * In-sequence data segments that carry nothing but data and the same
+     * acknowledgment, window, timestamps and ECN codepoint as the held segment
+     * are appended to it, up to GroMaxSize bytes. The first of them is held for
+     * at most GroTimeout; any other segment flushes the held one before being
+     * processed.
+     *
+     * \param packet the incoming packet, with its TCP header
+     * \param ecn the ECN codepoint of the IP header carrying packet
+     * \param fromAddress the address of the sender of packet
+     * \param toAddress the address of the receiver of packet
+     * \return true if the packet has been held or coalesced, false if it must be
+     * processed by the caller
+     */
+    bool GroReceive(Ptr<Packet> packet,
+                    Ipv4Header::EcnType ecn,
+                    const Address& fromAddress,
+                    const Address& toAddress);
+
+    /**
+     * \brief Process the segment held by GRO, if any
+     */
+    void GroFlush();
+
+    /**
+     * \brief Update the ECN state with the codepoint of a received segment
+     *
+     * Called right before the segment is processed by DoForwardUp, so that
+     * segments held by GRO update the state in arrival order.
+     *
+     * \param ecn the ECN codepoint of the IP header (the IPv6 codepoints
+     * have the same values)
+     * \param seq the sequence number of the segment
+     */
+    void ProcessEcnCodepoint(Ipv4Header::EcnType ecn, SequenceNumber32 seq);
+
     /**
      * \brief Called by the L3 protocol when it received an ICMP packet to pass on to TCP.
      *
@@ -1125,7 +1178,7 @@ class TcpSocketBase : public TcpSocket
      *
      * \param tcpHeader TcpHeader to add options to
      */
-    void AddOptions(TcpHeader& tcpHeader);
+    virtual void AddOptions(TcpHeader& tcpHeader);
 
     /**
      * \brief Read TCP options before Ack processing
@@ -1248,6 +1301,20 @@ class TcpSocketBase : public TcpSocket
      */
     bool IsPacingEnabled() const;
 
+    /**
+     * \brief Return true if the pacing rate is enforced by tagging the packets
+     * with their earliest departure time (EDT)
+     *
+     * EDT pacing is used when requested by the EdtPacing attribute and an
+     * FqQueueDisc is installed on the egress device (or on all the child
+     * queue discs of its root queue disc); otherwise, the pacing timer is
+     * used. The egress device is looked up once, when the first segment is
+     * sent.
+     *
+     * \return true if EDT pacing is used
+     */
+    bool IsEdtPacingUsed();
+
     /**
      * \brief Dynamically update the pacing rate
      */
@@ -1275,9 +1342,10 @@ class TcpSocketBase : public TcpSocket
 
   protected:
     // Counters and events
-    EventId m_retxEvent{};     //!< Retransmission event
+    TcpDeadlineTimer m_retxEvent;   //!< Retransmission event
+    TcpDeadlineTimer m_delAckEvent; //!< Delayed ACK timeout event
+
     EventId m_lastAckEvent{};  //!< Last ACK timeout event
-    EventId m_delAckEvent{};   //!< Delayed ACK timeout event
     EventId m_persistEvent{};  //!< Persist event: Send 1 byte to probe for a non-zero Rx window
     EventId m_timewaitEvent{}; //!< TIME_WAIT expiration event: Move this socket to CLOSED state
 
@@ -1364,6 +1432,18 @@ class TcpSocketBase : public TcpSocket
     uint32_t m_retxThresh{3};    //!< Fast Retransmit threshold
     bool m_limitedTx{true};      //!< perform limited transmit
 
+    // Segmentation and receive offload
+    uint32_t m_tsoMaxSize{0};         //!< Maximum size of a TSO super-segment (0: TSO disabled)
+    Time m_groTimeout{Seconds(0.0)};  //!< Maximum time a segment is held by GRO (0: disabled)
+    uint32_t m_groMaxSize{65535};     //!< Maximum payload size of a GRO segment
+    Ptr<Packet> m_groPacket;          //!< Payload of the segment held by GRO
+    TcpHeader m_groHeader;            //!< Header of the segment held by GRO
+    SequenceNumber32 m_groNextSeq{0}; //!< Sequence number following the held segment
+    Address m_groFrom;                //!< Source address of the held segment
+    Address m_groTo;                  //!< Destination address of the held segment
+    Ipv4Header::EcnType m_groEcn{Ipv4Header::ECN_NotECT}; //!< ECN codepoint of the held segment
+    EventId m_groFlushEvent{};        //!< Event processing the held segment
+
     // Transmission Control Block
     Ptr<TcpSocketState> m_tcb;                 //!< Congestion control information
     Ptr<TcpCongestionOps> m_congestionControl; //!< Congestion control
@@ -1384,8 +1464,11 @@ class TcpSocketBase : public TcpSocket
                    Ptr<const TcpSocketBase>>
         m_rxTrace; //!< Trace of received packets
 
-    // Pacing related variable
+    // Pacing related variables
     Timer m_pacingTimer{Timer::CANCEL_ON_DESTROY}; //!< Pacing Event
+    Time m_edtNextDeparture{Seconds(0.0)};         //!< Departure time of the next packet (EDT)
+    bool m_edtChecked{false}; //!< Whether the egress device has been checked for EDT pacing
+    bool m_edtUsable{false};  //!< Whether the egress device enforces the EDT of the packets
 
     // Parameters related to Explicit Congestion Notification
     TracedValue<SequenceNumber32> m_ecnEchoSeq{
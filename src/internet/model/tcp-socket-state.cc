@@ -55,6 +55,14 @@ TcpSocketState::GetTypeId()
                           BooleanValue(false),
                           MakeBooleanAccessor(&TcpSocketState::m_paceInitialWindow),
                           MakeBooleanChecker())
+            .AddAttribute("EdtPacing",
+                          "Pace by tagging packets with their earliest departure time, "
+                          "to be enforced by a queue disc such as FqQueueDisc, instead of "
+                          "holding them back with a per-socket timer. The timer is still "
+                          "used if no FqQueueDisc is installed on the egress device",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&TcpSocketState::m_edtPacing),
+                          MakeBooleanChecker())
             .AddTraceSource("PacingRate",
                             "The current TCP pacing rate",
                             MakeTraceSourceAccessor(&TcpSocketState::m_pacingRate),
@@ -118,6 +126,7 @@ TcpSocketState::TcpSocketState(const TcpSocketState& other)
       m_pacingSsRatio(other.m_pacingSsRatio),
       m_pacingCaRatio(other.m_pacingCaRatio),
       m_paceInitialWindow(other.m_paceInitialWindow),
+      m_edtPacing(other.m_edtPacing),
       m_minRtt(other.m_minRtt),
       m_bytesInFlight(other.m_bytesInFlight),
       m_lastRtt(other.m_lastRtt),
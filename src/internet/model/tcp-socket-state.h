@@ -204,6 +204,7 @@ class TcpSocketState : public Object
     uint16_t m_pacingSsRatio{0};           //!< SS pacing ratio
     uint16_t m_pacingCaRatio{0};           //!< CA pacing ratio
     bool m_paceInitialWindow{false};       //!< Enable/Disable pacing for the initial window
+    bool m_edtPacing{false};               //!< Pace with earliest departure time tags
 
     Time m_minRtt{Time::Max()}; //!< Minimum RTT observed throughout the connection
 
@@ -62,7 +62,9 @@ TcpTxBuffer::TcpTxBuffer(uint32_t n)
     : m_maxBuffer(32768),
       m_size(0),
       m_sentSize(0),
-      m_firstByteSeq(n)
+      m_firstByteSeq(n),
+      m_lostMarkHigh(n),
+      m_nextSegHint(n)
 {
     m_rWndCallback = MakeNullCallback<uint32_t>();
 }
@@ -178,6 +180,8 @@ TcpTxBuffer::SetHeadSequence(const SequenceNumber32& seq)
     // if you change the head with data already sent, something bad will happen
     NS_ASSERT(m_sentList.size() == 0);
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostMarkHigh = seq;
+    m_nextSegHint = seq;
 }
 
 bool
@@ -298,7 +302,7 @@ TcpTxBuffer::GetNewSegment(uint32_t numBytes)
     NS_ASSERT(it != m_appList.end());
 
     m_appList.erase(it);
-    m_sentList.insert(m_sentList.end(), item);
+    m_sentIndex[item->m_startSeq] = m_sentList.insert(m_sentList.end(), item);
     m_sentSize += item->m_packet->GetSize();
 
     return item;
@@ -312,37 +316,34 @@ TcpTxBuffer::GetTransmittedSegment(uint32_t numBytes, const SequenceNumber32& se
     NS_ASSERT(numBytes <= m_sentSize);
     NS_ASSERT(m_sentList.size() >= 1);
 
-    auto it = m_sentList.begin();
     bool listEdited = false;
     uint32_t s = numBytes;
 
     // Avoid to merge different packet for this retransmission if flags are
     // different.
-    for (; it != m_sentList.end(); ++it)
+    auto indexIt = m_sentIndex.find(seq);
+    if (indexIt != m_sentIndex.end())
     {
-        if ((*it)->m_startSeq == seq)
+        auto it = indexIt->second;
+        auto next = it;
+        next++;
+        if (next != m_sentList.end())
         {
-            auto next = it;
-            next++;
-            if (next != m_sentList.end())
+            // Next is not sacked and have the same value for m_lost ... there is the
+            // possibility to merge
+            if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
             {
-                // Next is not sacked and have the same value for m_lost ... there is the
-                // possibility to merge
-                if ((!(*next)->m_sacked) && ((*it)->m_lost == (*next)->m_lost))
-                {
-                    s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
-                }
-                else
-                {
-                    // Next is sacked... better to retransmit only the first segment
-                    s = std::min(s, (*it)->m_packet->GetSize());
-                }
+                s = std::min(s, (*it)->m_packet->GetSize() + (*next)->m_packet->GetSize());
             }
             else
             {
+                // Next is sacked... better to retransmit only the first segment
                 s = std::min(s, (*it)->m_packet->GetSize());
             }
-            break;
+        }
+        else
+        {
+            s = std::min(s, (*it)->m_packet->GetSize());
         }
     }
 
@@ -379,6 +380,25 @@ TcpTxBuffer::FindHighestSacked() const
     return ret;
 }
 
+TcpTxBuffer::SentIndex::const_iterator
+TcpTxBuffer::FindSentItem(const SequenceNumber32& seq) const
+{
+    NS_LOG_FUNCTION(this << seq);
+
+    auto it = m_sentIndex.upper_bound(seq);
+    if (it == m_sentIndex.begin())
+    {
+        return m_sentIndex.end();
+    }
+    --it;
+
+    if (seq >= it->first + (*it->second)->m_packet->GetSize())
+    {
+        return m_sentIndex.end();
+    }
+    return it;
+}
+
 void
 TcpTxBuffer::SplitItems(TcpTxItem* t1, TcpTxItem* t2, uint32_t size) const
 {
@@ -441,11 +461,25 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
     PacketList::iterator it = list.begin();
     SequenceNumber32 beginOfCurrentPacket = listStartFrom;
 
+    // Items of the sent list are indexed: skip directly to the one containing seq,
+    // and keep the index in sync with every fragment or merge done below.
+    const bool isSentList = (&list == &m_sentList);
+    TcpTxBuffer* self = const_cast<TcpTxBuffer*>(this);
+    if (isSentList)
+    {
+        auto indexIt = FindSentItem(seq);
+        if (indexIt != m_sentIndex.end())
+        {
+            it = indexIt->second;
+            beginOfCurrentPacket = indexIt->first;
+        }
+    }
+
     while (it != list.end())
     {
         currentItem = *it;
         currentPacket = currentItem->m_packet;
-        NS_ASSERT_MSG(list != m_sentList || currentItem->m_startSeq >= m_firstByteSeq,
+        NS_ASSERT_MSG(!isSentList || currentItem->m_startSeq >= m_firstByteSeq,
                       "start: " << m_firstByteSeq
                                 << " currentItem start: " << currentItem->m_startSeq);
 
@@ -474,7 +508,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, seq - beginOfCurrentPacket);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    self->m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+                    self->m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -520,6 +559,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                     NS_ASSERT(it != list.begin());
                     TcpTxItem* previous = *(--it);
 
+                    if (isSentList)
+                    {
+                        self->m_sentIndex.erase(currentItem->m_startSeq);
+                    }
                     list.erase(it);
 
                     MergeItems(previous, currentItem);
@@ -540,7 +583,12 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                 SplitItems(firstPart, currentItem, numBytes);
 
                 // insert firstPart before currentItem
-                list.insert(it, firstPart);
+                auto firstPartIt = list.insert(it, firstPart);
+                if (isSentList)
+                {
+                    self->m_sentIndex[firstPart->m_startSeq] = firstPartIt;
+                    self->m_sentIndex[currentItem->m_startSeq] = it;
+                }
                 if (listEdited)
                 {
                     *listEdited = true;
@@ -569,6 +617,10 @@ TcpTxBuffer::GetPacketFromList(PacketList& list,
                                      // in the previous if
 
             MergeItems(currentItem, next);
+            if (isSentList)
+            {
+                self->m_sentIndex.erase(next->m_startSeq);
+            }
             list.erase(it);
 
             delete next;
@@ -615,6 +667,7 @@ TcpTxBuffer::MergeItems(TcpTxItem* t1, TcpTxItem* t2) const
             self->m_retrans -= t2->m_packet->GetSize();
             t2->m_retrans = false;
         }
+        m_nextSegHint = m_firstByteSeq;
     }
 
     if (t1->m_lastSent < t2->m_lastSent)
@@ -653,16 +706,18 @@ bool
 TcpTxBuffer::IsRetransmittedDataAcked(const SequenceNumber32& ack) const
 {
     NS_LOG_FUNCTION(this);
-    for (const auto& it : m_sentList)
+
+    // Only the item that ends exactly at ack can be the one
+    auto it = m_sentIndex.lower_bound(ack);
+    if (it == m_sentIndex.begin())
     {
-        TcpTxItem* item = it;
-        Ptr<Packet> p = item->m_packet;
-        if (item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans)
-        {
-            return true;
-        }
+        return false;
     }
-    return false;
+    --it;
+
+    TcpTxItem* item = *it->second;
+    Ptr<Packet> p = item->m_packet;
+    return item->m_startSeq + p->GetSize() == ack && !item->m_sacked && item->m_retrans;
 }
 
 void
@@ -710,6 +765,7 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
 
             RemoveFromCounts(item, pktSize);
 
+            m_sentIndex.erase(item->m_startSeq);
             i = m_sentList.erase(i);
             NS_LOG_INFO("Removed " << *item << " lost: " << m_lostOut << " retrans: " << m_retrans
                                    << " sacked: " << m_sackedOut << ". Remaining data " << m_size);
@@ -728,7 +784,9 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
             NS_LOG_INFO(*item);
             // PacketTags are preserved when fragmenting
             item->m_packet = item->m_packet->CreateFragment(offset, pktSize);
+            m_sentIndex.erase(item->m_startSeq);
             item->m_startSeq += offset;
+            m_sentIndex[item->m_startSeq] = i;
             m_size -= offset;
             m_sentSize -= offset;
             m_firstByteSeq += offset;
@@ -773,6 +831,16 @@ TcpTxBuffer::DiscardUpTo(const SequenceNumber32& seq, const Callback<void, TcpTx
         m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
     }
 
+    // Keep the boundaries inside the window, to not be fooled by wrapping
+    if (m_lostMarkHigh < m_firstByteSeq)
+    {
+        m_lostMarkHigh = m_firstByteSeq;
+    }
+    if (m_nextSegHint < m_firstByteSeq)
+    {
+        m_nextSegHint = m_firstByteSeq;
+    }
+
     NS_LOG_DEBUG("Discarded up to " << seq << " lost: " << m_lostOut << " retrans: " << m_retrans
                                     << " sacked: " << m_sackedOut);
     NS_LOG_LOGIC("Buffer status after discarding data " << *this);
@@ -791,17 +859,19 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
 
     for (auto option_it = list.begin(); option_it != list.end(); ++option_it)
     {
-        PacketList::iterator item_it = m_sentList.begin();
-        SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-
         if (m_firstByteSeq + m_sentSize < (*option_it).first)
         {
             NS_LOG_INFO("Not updating scoreboard, the option block is outside the sent list");
             return bytesSacked;
         }
 
-        while (item_it != m_sentList.end())
+        // Start from the first item beginning inside the block
+        auto index_it = m_sentIndex.lower_bound((*option_it).first);
+
+        while (index_it != m_sentIndex.end())
         {
+            PacketList::iterator item_it = index_it->second;
+            SequenceNumber32 beginOfCurrentPacket = index_it->first;
             uint32_t pktSize = (*item_it)->m_packet->GetSize();
 
             // Check the boundary of this packet ... only mark as sacked if
@@ -809,8 +879,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
             // is reporting as sacked single range bytes that are not mapped 1:1
             // in what we have, the option is discarded. There's room for improvement
             // here.
-            if (beginOfCurrentPacket >= (*option_it).first &&
-                beginOfCurrentPacket + pktSize <= (*option_it).second)
+            if (beginOfCurrentPacket + pktSize <= (*option_it).second)
             {
                 if ((*item_it)->m_sacked)
                 {
@@ -848,7 +917,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                     }
                 }
             }
-            else if (beginOfCurrentPacket + pktSize > (*option_it).second)
+            else
             {
                 // We already passed the received block end. Exit from the loop
                 NS_LOG_INFO("Received block [" << *option_it << ", checking sentList for block "
@@ -856,8 +925,7 @@ TcpTxBuffer::Update(const TcpOptionSack::SackList& list, const Callback<void, Tc
                 break;
             }
 
-            beginOfCurrentPacket += pktSize;
-            ++item_it;
+            ++index_it;
         }
     }
 
@@ -880,46 +948,56 @@ TcpTxBuffer::UpdateLostCount()
 {
     NS_LOG_FUNCTION(this);
     uint32_t sacked = 0;
-    SequenceNumber32 beginOfCurrentPacket = m_highestSack.second;
     if (m_highestSack.first == m_sentList.end())
     {
-        NS_LOG_INFO("Status before the update: " << *this
-                                                 << ", will start from the latest sent item");
-    }
-    else
-    {
-        NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
-                                                 << *(*m_highestSack.first));
+        NS_LOG_INFO("Status before the update: " << *this << ", no sacked item");
+        return;
     }
+    NS_LOG_INFO("Status before the update: " << *this << ", will start from item "
+                                             << *(*m_highestSack.first));
 
-    for (auto it = m_highestSack.first; it != m_sentList.begin(); --it)
+    // Walk down from the highest sacked item, until dupAckThresh sacked items
+    // are found: every unsacked item below that point is lost.
+    auto it = m_highestSack.first;
+    while (it != m_sentList.begin())
     {
-        TcpTxItem* item = *it;
-        if (item->m_sacked)
+        if ((*it)->m_sacked && ++sacked >= m_dupAckThresh)
         {
-            sacked++;
+            break;
         }
+        --it;
+    }
 
-        if (sacked >= m_dupAckThresh)
-        {
-            if (!item->m_sacked && !item->m_lost)
-            {
-                item->m_lost = true;
-                m_lostOut += item->m_packet->GetSize();
-            }
-        }
-        beginOfCurrentPacket -= item->m_packet->GetSize();
+    if (sacked < m_dupAckThresh)
+    {
+        NS_LOG_INFO("Status after the update: " << *this);
+        return;
     }
 
-    if (sacked >= m_dupAckThresh)
+    SequenceNumber32 lostMarkHigh = (*it)->m_startSeq;
+
+    // Unsacked items below m_lostMarkHigh have been marked by a previous call
+    for (; it != m_sentList.begin() && (*it)->m_startSeq >= m_lostMarkHigh; --it)
     {
-        TcpTxItem* item = *m_sentList.begin();
-        if (!item->m_lost)
+        TcpTxItem* item = *it;
+        if (!item->m_sacked && !item->m_lost)
         {
             item->m_lost = true;
             m_lostOut += item->m_packet->GetSize();
         }
     }
+
+    TcpTxItem* item = *m_sentList.begin();
+    if (!item->m_lost)
+    {
+        item->m_lost = true;
+        m_lostOut += item->m_packet->GetSize();
+    }
+
+    if (lostMarkHigh > m_lostMarkHigh)
+    {
+        m_lostMarkHigh = lostMarkHigh;
+    }
     NS_LOG_INFO("Status after the update: " << *this);
     ConsistencyCheck();
 }
@@ -929,35 +1007,31 @@ TcpTxBuffer::IsLost(const SequenceNumber32& seq) const
 {
     NS_LOG_FUNCTION(this << seq);
 
-    SequenceNumber32 beginOfCurrentPacket = m_firstByteSeq;
-    PacketList::const_iterator it;
-
     if (seq >= m_highestSack.second)
     {
         return false;
     }
 
-    // In theory, using a map and hints when inserting elements can improve
-    // performance
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // Search for the first item starting at (or after) seq through the index
+    auto index_it = m_sentIndex.lower_bound(seq);
+    if (index_it == m_sentIndex.end())
     {
-        // Search for the right iterator before calling IsLost()
-        if (beginOfCurrentPacket >= seq)
-        {
-            if ((*it)->m_lost == true)
-            {
-                NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
-                return true;
-            }
+        return false;
+    }
 
-            if ((*it)->m_sacked == true)
-            {
-                NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
-                return false;
-            }
+    for (PacketList::const_iterator it = index_it->second; it != m_sentList.end(); ++it)
+    {
+        if ((*it)->m_lost == true)
+        {
+            NS_LOG_INFO("seq=" << seq << " is lost because of lost flag");
+            return true;
         }
 
-        beginOfCurrentPacket += (*it)->m_packet->GetSize();
+        if ((*it)->m_sacked == true)
+        {
+            NS_LOG_INFO("seq=" << seq << " is not lost because of sacked flag");
+            return false;
+        }
     }
 
     return false;
@@ -981,19 +1055,27 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
      *
      *     (1.c) IsLost (S2) returns true.
      */
-    PacketList::const_iterator it;
     TcpTxItem* item;
     SequenceNumber32 seqPerRule3;
     bool isSeqPerRule3Valid = false;
-    SequenceNumber32 beginOfCurrentPkt = m_firstByteSeq;
+    bool isHintUpdated = false;
 
-    for (it = m_sentList.begin(); it != m_sentList.end(); ++it)
+    // All the items before m_nextSegHint are sacked or retransmitted already
+    for (auto index_it = m_sentIndex.lower_bound(m_nextSegHint); index_it != m_sentIndex.end();
+         ++index_it)
     {
-        item = *it;
+        item = *index_it->second;
+        SequenceNumber32 beginOfCurrentPkt = index_it->first;
 
         // Condition 1.a , 1.b , and 1.c
         if (item->m_retrans == false && item->m_sacked == false)
         {
+            if (!isHintUpdated)
+            {
+                m_nextSegHint = beginOfCurrentPkt;
+                isHintUpdated = true;
+            }
+
             if (item->m_lost)
             {
                 NS_LOG_INFO("IsLost, returning" << beginOfCurrentPkt);
@@ -1001,16 +1083,19 @@ TcpTxBuffer::NextSeg(SequenceNumber32* seq, SequenceNumber32* seqHigh, bool isRe
                 *seqHigh = *seq + m_segmentSize;
                 return true;
             }
-            else if (seqPerRule3.GetValue() == 0 && isRecovery)
+            else if (!isSeqPerRule3Valid && isRecovery)
             {
                 NS_LOG_INFO("Saving for rule 3 the seq " << beginOfCurrentPkt);
                 isSeqPerRule3Valid = true;
                 seqPerRule3 = beginOfCurrentPkt;
             }
-        }
 
-        // Nothing found, iterate
-        beginOfCurrentPkt += item->m_packet->GetSize();
+            if (m_lostOut == 0 && (isSeqPerRule3Valid || !isRecovery))
+            {
+                // No lost item to look for
+                break;
+            }
+        }
     }
 
     /* (2) If no sequence number 'S2' per rule (1) exists but there
@@ -1227,6 +1312,8 @@ TcpTxBuffer::ResetRenoSack()
     }
 
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostMarkHigh = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1251,11 +1338,14 @@ TcpTxBuffer::ResetSentList()
         m_sentList.pop_back();
     }
 
+    m_sentIndex.clear();
     m_sentSize = 0;
     m_lostOut = 0;
     m_retrans = 0;
     m_sackedOut = 0;
     m_highestSack = std::make_pair(m_sentList.end(), SequenceNumber32(0));
+    m_lostMarkHigh = m_firstByteSeq;
+    m_nextSegHint = m_firstByteSeq;
 }
 
 void
@@ -1266,6 +1356,7 @@ TcpTxBuffer::ResetLastSegmentSent()
     {
         TcpTxItem* item = m_sentList.back();
 
+        m_sentIndex.erase(item->m_startSeq);
         m_sentList.pop_back();
         m_sentSize -= item->m_packet->GetSize();
         if (item->m_retrans)
@@ -1282,6 +1373,7 @@ TcpTxBuffer::SetSentListLost(bool resetSack)
 {
     NS_LOG_FUNCTION(this);
     m_retrans = 0;
+    m_nextSegHint = m_firstByteSeq;
 
     if (resetSack)
     {
@@ -1351,6 +1443,7 @@ TcpTxBuffer::DeleteRetransmittedFlagFromHead()
     {
         m_sentList.front()->m_retrans = false;
         m_retrans -= m_sentList.front()->m_packet->GetSize();
+        m_nextSegHint = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1380,6 +1473,7 @@ TcpTxBuffer::MarkHeadAsLost()
             m_sentList.front()->m_lost = true;
             m_lostOut += m_sentList.front()->m_packet->GetSize();
         }
+        m_nextSegHint = m_firstByteSeq;
     }
     ConsistencyCheck();
 }
@@ -1461,6 +1555,14 @@ TcpTxBuffer::ConsistencyCheck() const
     NS_ASSERT_MSG(lost == m_lostOut, " Counted lost: " << lost << " stored lost: " << m_lostOut);
     NS_ASSERT_MSG(retrans == m_retrans,
                   " Counted retrans: " << retrans << " stored retrans: " << m_retrans);
+
+    NS_ASSERT_MSG(m_sentIndex.size() == m_sentList.size(),
+                  "Index size: " << m_sentIndex.size() << " sent list size: " << m_sentList.size());
+    for (auto it = m_sentIndex.begin(); it != m_sentIndex.end(); ++it)
+    {
+        NS_ASSERT_MSG(it->first == (*it->second)->m_startSeq,
+                      "Index key " << it->first << " for item " << *(*it->second));
+    }
 }
 
 std::ostream&
@@ -28,6 +28,8 @@
 #include "ns3/tcp-tx-item.h"
 #include "ns3/traced-value.h"
 
+#include <map>
+
 namespace ns3
 {
 class Packet;
@@ -91,6 +93,24 @@ class Packet;
  * segments that can be lost (\see UpdateLostCount), and we set the flags
  * accordingly.
  *
+ * Scoreboard index
+ * ----------------
+ *
+ * With large bandwidth-delay products the SentList holds tens of thousands of
+ * items, and walking it for every incoming ACK quickly dominates the
+ * simulation time. Therefore, every item of the SentList is also indexed by
+ * its starting sequence number (m_sentIndex), so that the item covering a
+ * given sequence is found in logarithmic time. SACK blocks, IsLost,
+ * retransmissions and the check on retransmitted data being ACKed start from
+ * the item found through the index instead of from the head of the list.
+ *
+ * Two more boundaries avoid walking again over the parts of the scoreboard
+ * that cannot change: every unsacked item below m_lostMarkHigh is already
+ * marked as lost (so UpdateLostCount only marks the items that were not
+ * considered before), and every item below m_nextSegHint is either sacked or
+ * retransmitted (so NextSeg starts its search from there). Both boundaries
+ * are moved back to SND.UNA whenever a flag is cleared.
+ *
  * Management of bytes in flight
  * -----------------------------
  *
@@ -412,6 +432,15 @@ class TcpTxBuffer : public Object
     friend std::ostream& operator<<(std::ostream& os, const TcpTxBuffer& tcpTxBuf);
 
     typedef std::list<TcpTxItem*> PacketList; //!< container for data stored in the buffer
+    /// Index of the SentList items, keyed by their starting sequence number
+    typedef std::map<SequenceNumber32, PacketList::iterator> SentIndex;
+
+    /**
+     * \brief Find the index entry of the sent item that contains a sequence
+     * \param seq the sequence to look for
+     * \return the index entry, or m_sentIndex.end () if seq is not in the SentList
+     */
+    SentIndex::const_iterator FindSentItem(const SequenceNumber32& seq) const;
 
     /**
      * \brief Update the lost count
@@ -428,9 +457,9 @@ class TcpTxBuffer : public Object
      * The {New}Reno cases, for now, are managed in TcpSocketBase through the
      * call to MarkHeadAsLost.
      * This function is, therefore, called after a SACK option has been received,
-     * and updates the lost count. It can be probably optimized by not walking
-     * the entire list, but a subset.
-     *
+     * and updates the lost count. The walk starts from the highest sacked item
+     * and stops at m_lostMarkHigh, below which all the unsacked items are
+     * already marked as lost.
      */
     void UpdateLostCount();
 
@@ -613,6 +642,10 @@ class TcpTxBuffer : public Object
         m_firstByteSeq; //!< Sequence number of the first byte in data (SND.UNA)
     std::pair<PacketList::const_iterator, SequenceNumber32> m_highestSack; //!< Highest SACK byte
 
+    SentIndex m_sentIndex;                  //!< Index of m_sentList by starting sequence
+    SequenceNumber32 m_lostMarkHigh;        //!< Unsacked items below are all marked lost
+    mutable SequenceNumber32 m_nextSegHint; //!< Items below are sacked or retransmitted
+
     uint32_t m_lostOut{0};   //!< Number of lost bytes
     uint32_t m_sackedOut{0}; //!< Number of sacked bytes
     uint32_t m_retrans{0};   //!< Number of retransmitted bytes
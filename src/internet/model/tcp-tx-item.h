@@ -108,6 +108,8 @@ class TcpTxItem
     // Only TcpTxBuffer is allowed to touch this part of the TcpTxItem, to manage
     // its internal lists and counters
     friend class TcpTxBuffer;
+    // QuicCongestionControl tracks the QUIC packets in flight with TcpTxItem
+    friend class QuicCongestionControl;
 
     SequenceNumber32 m_startSeq{0}; //!< Sequence number of the item (if transmitted)
     Ptr<Packet> m_packet{nullptr};  //!< Application packet (can be null)
@@ -26,6 +26,7 @@
 #include "ipv6-end-point-demux.h"
 #include "ipv6-end-point.h"
 #include "ipv6-l3-protocol.h"
+#include "quic-socket-factory.h"
 #include "udp-header.h"
 #include "udp-socket-factory-impl.h"
 #include "udp-socket-impl.h"
@@ -105,6 +106,9 @@ UdpL4Protocol::NotifyNewAggregate()
             Ptr<UdpSocketFactoryImpl> udpFactory = CreateObject<UdpSocketFactoryImpl>();
             udpFactory->SetUdp(this);
             node->AggregateObject(udpFactory);
+            Ptr<QuicSocketFactory> quicFactory = CreateObject<QuicSocketFactory>();
+            quicFactory->SetUdp(this);
+            node->AggregateObject(quicFactory);
         }
     }
 
@@ -0,0 +1,408 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-l3-protocol.h"
+#include "ns3/log.h"
+#include "ns3/mptcp-congestion-ops.h"
+#include "ns3/mptcp-scheduler.h"
+#include "ns3/mptcp-socket-factory.h"
+#include "ns3/mptcp-socket.h"
+#include "ns3/mptcp-subflow.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-header.h"
+#include "ns3/tcp-option-mptcp.h"
+#include "ns3/tcp-socket-factory.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("MpTcpTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the Multipath TCP options survive a round trip through a TcpHeader
+ */
+class MpTcpOptionTestCase : public TestCase
+{
+  public:
+    MpTcpOptionTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Serialize a header and deserialize it into a new one
+     * \param header the header to serialize
+     * \return the deserialized header
+     */
+    TcpHeader RoundTrip(const TcpHeader& header);
+};
+
+MpTcpOptionTestCase::MpTcpOptionTestCase()
+    : TestCase("Multipath TCP options round trip")
+{
+}
+
+TcpHeader
+MpTcpOptionTestCase::RoundTrip(const TcpHeader& header)
+{
+    Buffer buffer;
+    buffer.AddAtStart(header.GetSerializedSize());
+    header.Serialize(buffer.Begin());
+    TcpHeader copy;
+    NS_TEST_EXPECT_MSG_EQ(copy.Deserialize(buffer.Begin()),
+                          header.GetSerializedSize(),
+                          "Deserialized length differs");
+    return copy;
+}
+
+void
+MpTcpOptionTestCase::DoRun()
+{
+    TcpHeader syn;
+    syn.SetFlags(TcpHeader::SYN);
+    Ptr<TcpOptionMpTcpCapable> capable = CreateObject<TcpOptionMpTcpCapable>();
+    capable->SetSenderKey(0x0123456789abcdefULL);
+    syn.AppendOption(capable);
+
+    TcpHeader synCopy = RoundTrip(syn);
+    Ptr<const TcpOptionMpTcpCapable> capableCopy =
+        DynamicCast<const TcpOptionMpTcpCapable>(synCopy.GetOption(TcpOption::MPTCP));
+    NS_TEST_ASSERT_MSG_NE(capableCopy, nullptr, "MP_CAPABLE not deserialized");
+    NS_TEST_EXPECT_MSG_EQ(capableCopy->GetSenderKey(), 0x0123456789abcdefULL, "Wrong key");
+
+    TcpHeader join;
+    join.SetFlags(TcpHeader::SYN);
+    Ptr<TcpOptionMpTcpJoin> joinOption = CreateObject<TcpOptionMpTcpJoin>();
+    joinOption->SetToken(0xdeadbeef);
+    joinOption->SetAddressId(3);
+    join.AppendOption(joinOption);
+
+    TcpHeader joinCopy = RoundTrip(join);
+    Ptr<const TcpOptionMpTcpJoin> joinOptionCopy =
+        DynamicCast<const TcpOptionMpTcpJoin>(joinCopy.GetOption(TcpOption::MPTCP));
+    NS_TEST_ASSERT_MSG_NE(joinOptionCopy, nullptr, "MP_JOIN not deserialized");
+    NS_TEST_EXPECT_MSG_EQ(joinOptionCopy->GetToken(), 0xdeadbeef, "Wrong token");
+    NS_TEST_EXPECT_MSG_EQ(+joinOptionCopy->GetAddressId(), 3, "Wrong address identifier");
+
+    TcpHeader data;
+    data.SetFlags(TcpHeader::ACK);
+    Ptr<TcpOptionMpTcpDss> dss = CreateObject<TcpOptionMpTcpDss>();
+    dss->SetDataAck(SequenceNumber32(1000));
+    dss->SetMapping(SequenceNumber32(5000), SequenceNumber32(42), 1400);
+    data.AppendOption(dss);
+    Ptr<TcpOptionMpTcpAddAddr> addAddr = CreateObject<TcpOptionMpTcpAddAddr>();
+    addAddr->SetAddress(2, Ipv4Address("10.1.2.1"));
+    data.AppendOption(addAddr);
+
+    TcpHeader dataCopy = RoundTrip(data);
+    std::map<TcpOptionMpTcp::SubType, Ptr<const TcpOptionMpTcp>> options;
+    for (const auto& option : dataCopy.GetOptionList())
+    {
+        if (option->GetKind() == TcpOption::END || option->GetKind() == TcpOption::NOP)
+        {
+            // padding of the option space
+            continue;
+        }
+        Ptr<const TcpOptionMpTcp> mptcp = DynamicCast<const TcpOptionMpTcp>(option);
+        NS_TEST_ASSERT_MSG_NE(mptcp, nullptr, "Unexpected option of kind " << +option->GetKind());
+        if (mptcp)
+        {
+            options[mptcp->GetSubType()] = mptcp;
+        }
+    }
+
+    Ptr<const TcpOptionMpTcpDss> dssCopy =
+        DynamicCast<const TcpOptionMpTcpDss>(options[TcpOptionMpTcp::DSS]);
+    NS_TEST_ASSERT_MSG_NE(dssCopy, nullptr, "DSS not deserialized");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->HasDataAck(), true, "Data ack lost");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->GetDataAck(), SequenceNumber32(1000), "Wrong data ack");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->HasMapping(), true, "Mapping lost");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->GetDataSequence(), SequenceNumber32(5000), "Wrong DSN");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->GetSubflowSequence(), SequenceNumber32(42), "Wrong SSN");
+    NS_TEST_EXPECT_MSG_EQ(dssCopy->GetMappingLength(), 1400, "Wrong mapping length");
+
+    Ptr<const TcpOptionMpTcpAddAddr> addAddrCopy =
+        DynamicCast<const TcpOptionMpTcpAddAddr>(options[TcpOptionMpTcp::ADD_ADDR]);
+    NS_TEST_ASSERT_MSG_NE(addAddrCopy, nullptr, "ADD_ADDR not deserialized");
+    NS_TEST_EXPECT_MSG_EQ(+addAddrCopy->GetAddressId(), 2, "Wrong address identifier");
+    NS_TEST_EXPECT_MSG_EQ(addAddrCopy->GetAddress(), Ipv4Address("10.1.2.1"), "Wrong address");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Transfer data between two hosts connected by two paths
+ *
+ * The server listens on the address of its first interface and advertises
+ * the address of the second one, so that the client opens a second subflow.
+ * The test checks that the data is received in order and intact, and, if
+ * the server supports Multipath TCP, that both paths carried data.
+ */
+class MpTcpTransferTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param scheduler the type of the packet scheduler
+     * \param congestion the type of the congestion control of the subflows
+     * \param mptcpServer whether the server supports Multipath TCP
+     */
+    MpTcpTransferTestCase(TypeId scheduler, TypeId congestion, bool mptcpServer);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Start writing data once the client is connected
+     * \param socket the client socket
+     */
+    void Connected(Ptr<Socket> socket);
+
+    /**
+     * \brief Write data into the client socket
+     * \param socket the client socket
+     * \param available the space available in the send buffer
+     */
+    void SendData(Ptr<Socket> socket, uint32_t available);
+
+    /**
+     * \brief Accept a connection on the server
+     * \param socket the connection
+     * \param from the address of the client
+     */
+    void Accept(Ptr<Socket> socket, const Address& from);
+
+    /**
+     * \brief Read and check the data received by the server
+     * \param socket the connection
+     */
+    void ReceiveData(Ptr<Socket> socket);
+
+    /**
+     * \brief Count the bytes sent by the client on each interface
+     * \param packet the packet
+     * \param ipv4 the IPv4 protocol
+     * \param interface the interface
+     */
+    void ClientTx(Ptr<const Packet> packet, Ptr<Ipv4> ipv4, uint32_t interface);
+
+    static const uint32_t m_totalBytes = 300000; //!< Bytes to transfer
+
+    TypeId m_scheduler;                     //!< Type of the packet scheduler
+    TypeId m_congestion;                    //!< Type of the congestion control
+    bool m_mptcpServer;                     //!< Whether the server supports Multipath TCP
+    uint32_t m_sent{0};                     //!< Bytes written by the client
+    uint32_t m_received{0};                 //!< Bytes read by the server
+    bool m_intact{true};                    //!< Whether the data read was as expected
+    std::map<uint32_t, uint64_t> m_txBytes; //!< Bytes sent by the client, per interface
+};
+
+MpTcpTransferTestCase::MpTcpTransferTestCase(TypeId scheduler, TypeId congestion, bool mptcpServer)
+    : TestCase("Multipath TCP transfer with " + scheduler.GetName() + " and " +
+               congestion.GetName() + (mptcpServer ? "" : " to a regular TCP server")),
+      m_scheduler(scheduler),
+      m_congestion(congestion),
+      m_mptcpServer(mptcpServer)
+{
+}
+
+void
+MpTcpTransferTestCase::Connected(Ptr<Socket> socket)
+{
+    SendData(socket, socket->GetTxAvailable());
+}
+
+void
+MpTcpTransferTestCase::SendData(Ptr<Socket> socket, uint32_t /* available */)
+{
+    while (m_sent < m_totalBytes && socket->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min({socket->GetTxAvailable(), m_totalBytes - m_sent, 1000U});
+        std::vector<uint8_t> buffer(size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            buffer[i] = static_cast<uint8_t>((m_sent + i) % 251);
+        }
+        int sent = socket->Send(Create<Packet>(buffer.data(), size), 0);
+        if (sent <= 0)
+        {
+            return;
+        }
+        m_sent += sent;
+    }
+    if (m_sent == m_totalBytes)
+    {
+        socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        socket->Close();
+    }
+}
+
+void
+MpTcpTransferTestCase::Accept(Ptr<Socket> socket, const Address& /* from */)
+{
+    socket->SetRecvCallback(MakeCallback(&MpTcpTransferTestCase::ReceiveData, this));
+}
+
+void
+MpTcpTransferTestCase::ReceiveData(Ptr<Socket> socket)
+{
+    while (Ptr<Packet> p = socket->Recv())
+    {
+        if (p->GetSize() == 0)
+        {
+            break;
+        }
+        std::vector<uint8_t> buffer(p->GetSize());
+        p->CopyData(buffer.data(), buffer.size());
+        for (uint32_t i = 0; i < buffer.size(); i++)
+        {
+            m_intact &= (buffer[i] == static_cast<uint8_t>((m_received + i) % 251));
+        }
+        m_received += buffer.size();
+    }
+}
+
+void
+MpTcpTransferTestCase::ClientTx(Ptr<const Packet> packet, Ptr<Ipv4> /* ipv4 */, uint32_t interface)
+{
+    m_txBytes[interface] += packet->GetSize();
+}
+
+void
+MpTcpTransferTestCase::DoRun()
+{
+    Ptr<Node> client = CreateObject<Node>();
+    Ptr<Node> server = CreateObject<Node>();
+    NodeContainer nodes(client, server);
+
+    // Two paths with different delays
+    SimpleNetDeviceHelper path1;
+    path1.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    path1.SetChannelAttribute("Delay", StringValue("5ms"));
+    path1.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices1 = path1.Install(nodes);
+
+    SimpleNetDeviceHelper path2;
+    path2.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    path2.SetChannelAttribute("Delay", StringValue("15ms"));
+    path2.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices2 = path2.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+
+    const char* addresses[2][2] = {{"10.1.1.2", "10.1.1.1"}, {"10.1.2.2", "10.1.2.1"}};
+    NetDeviceContainer devices[2] = {devices1, devices2};
+    for (uint32_t path = 0; path < 2; path++)
+    {
+        for (uint32_t n = 0; n < 2; n++)
+        {
+            Ptr<Ipv4> ipv4 = nodes.Get(n)->GetObject<Ipv4>();
+            uint32_t interface = ipv4->AddInterface(devices[path].Get(n));
+            ipv4->AddAddress(interface,
+                             Ipv4InterfaceAddress(Ipv4Address(addresses[path][n]), "/24"));
+            ipv4->SetUp(interface);
+        }
+    }
+
+    client->GetObject<Ipv4L3Protocol>()->TraceConnectWithoutContext(
+        "Tx",
+        MakeCallback(&MpTcpTransferTestCase::ClientTx, this));
+
+    Ptr<Socket> sink = Socket::CreateSocket(server,
+                                            m_mptcpServer ? MpTcpSocketFactory::GetTypeId()
+                                                          : TcpSocketFactory::GetTypeId());
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 5000));
+    sink->Listen();
+    sink->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                            MakeCallback(&MpTcpTransferTestCase::Accept, this));
+
+    Ptr<MpTcpSocket> source =
+        DynamicCast<MpTcpSocket>(Socket::CreateSocket(client, MpTcpSocketFactory::GetTypeId()));
+    source->SetAttribute("Scheduler", TypeIdValue(m_scheduler));
+    source->SetAttribute("CongestionControl", TypeIdValue(m_congestion));
+    source->AssignStreams(0);
+    source->SetConnectCallback(MakeCallback(&MpTcpTransferTestCase::Connected, this),
+                               MakeNullCallback<void, Ptr<Socket>>());
+    source->SetSendCallback(MakeCallback(&MpTcpTransferTestCase::SendData, this));
+    source->Bind();
+    source->Connect(InetSocketAddress(Ipv4Address("10.1.1.1"), 5000));
+
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_sent, m_totalBytes, "Not all the data was written");
+    NS_TEST_EXPECT_MSG_EQ(m_received, m_totalBytes, "Not all the data was received");
+    NS_TEST_EXPECT_MSG_EQ(m_intact, true, "The data received is corrupted or out of order");
+    NS_TEST_EXPECT_MSG_EQ(source->IsMpCapable(), m_mptcpServer, "Wrong Multipath TCP state");
+    if (m_mptcpServer)
+    {
+        NS_TEST_EXPECT_MSG_EQ(source->GetNSubflows(), 2, "Wrong number of subflows");
+        // Interface 0 is the loopback
+        NS_TEST_EXPECT_MSG_GT(m_txBytes[1], m_totalBytes / 10, "The first path is unused");
+        NS_TEST_EXPECT_MSG_GT(m_txBytes[2], m_totalBytes / 10, "The second path is unused");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(source->GetNSubflows(), 1, "Wrong number of subflows");
+        NS_TEST_EXPECT_MSG_EQ(m_txBytes[2], 0, "A regular TCP connection used two paths");
+    }
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Multipath TCP TestSuite
+ */
+class MpTcpTestSuite : public TestSuite
+{
+  public:
+    MpTcpTestSuite()
+        : TestSuite("mptcp", UNIT)
+    {
+        AddTestCase(new MpTcpOptionTestCase(), TestCase::QUICK);
+        AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                              TcpLia::GetTypeId(),
+                                              true),
+                    TestCase::QUICK);
+        AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerRoundRobin::GetTypeId(),
+                                              TcpOlia::GetTypeId(),
+                                              true),
+                    TestCase::QUICK);
+        AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                              TcpBalia::GetTypeId(),
+                                              true),
+                    TestCase::QUICK);
+        AddTestCase(new MpTcpTransferTestCase(MpTcpSchedulerMinRtt::GetTypeId(),
+                                              TcpLia::GetTypeId(),
+                                              false),
+                    TestCase::QUICK);
+    }
+};
+
+static MpTcpTestSuite g_mpTcpTestSuite; //!< Static variable for test initialization
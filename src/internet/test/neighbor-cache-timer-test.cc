@@ -0,0 +1,527 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/arp-cache.h"
+#include "ns3/boolean.h"
+#include "ns3/icmpv6-header.h"
+#include "ns3/icmpv6-l4-protocol.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-interface.h"
+#include "ns3/ipv6-header.h"
+#include "ns3/ipv6-interface.h"
+#include "ns3/ipv6-l3-protocol.h"
+#include "ns3/ndisc-cache.h"
+#include "ns3/node.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Base class of the tests of the NUD timers of the NDISC cache
+ *
+ * Two nodes are connected by a SimpleChannel. The tests drive the entries
+ * of the cache of the first node directly, for addresses which the second
+ * node does not own, and count the Neighbor Solicitations it receives.
+ */
+class NdiscNudTimerTestBase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param name the name of the test
+     */
+    NdiscNudTimerTestBase(std::string name);
+
+  protected:
+    /**
+     * \brief Build the topology
+     */
+    void Setup();
+
+    /**
+     * \brief Add a cache entry on the first node
+     * \param address the IPv6 address of the entry
+     * \return the entry
+     */
+    NdiscCache::Entry* AddEntry(Ipv6Address address);
+
+    /**
+     * \brief Count the Neighbor Solicitations received by the second node
+     * \param device the receiving device
+     * \param packet the packet
+     * \param protocol the protocol number
+     * \param from the sender address
+     * \param to the destination address
+     * \param packetType the packet type
+     */
+    void Receive(Ptr<NetDevice> device,
+                 Ptr<const Packet> packet,
+                 uint16_t protocol,
+                 const Address& from,
+                 const Address& to,
+                 NetDevice::PacketType packetType);
+
+    Ptr<NdiscCache> m_cache;                   //!< The cache of the first node
+    Address m_peerMac;                         //!< The MAC address of the second node
+    std::map<Ipv6Address, uint32_t> m_nsCount; //!< Neighbor Solicitations received, per target
+};
+
+NdiscNudTimerTestBase::NdiscNudTimerTestBase(std::string name)
+    : TestCase(name)
+{
+}
+
+void
+NdiscNudTimerTestBase::Setup()
+{
+    NodeContainer nodes;
+    nodes.Create(2);
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer devices = simpleHelper.Install(nodes);
+
+    InternetStackHelper internet;
+    internet.SetIpv4StackInstall(false);
+    internet.Install(nodes);
+
+    for (uint32_t n = 0; n < 2; n++)
+    {
+        nodes.Get(n)->GetObject<Icmpv6L4Protocol>()->SetAttribute("DAD", BooleanValue(false));
+        Ptr<Ipv6> ipv6 = nodes.Get(n)->GetObject<Ipv6>();
+        uint32_t interface = ipv6->AddInterface(devices.Get(n));
+        ipv6->AddAddress(interface,
+                         Ipv6InterfaceAddress(Ipv6Address(n == 0 ? "2001:db8::1" : "2001:db8::2"),
+                                              Ipv6Prefix(64)));
+        ipv6->SetUp(interface);
+    }
+
+    m_cache = nodes.Get(0)->GetObject<Ipv6L3Protocol>()->GetInterface(1)->GetNdiscCache();
+    m_peerMac = devices.Get(1)->GetAddress();
+    nodes.Get(1)->RegisterProtocolHandler(MakeCallback(&NdiscNudTimerTestBase::Receive, this),
+                                          Ipv6L3Protocol::PROT_NUMBER,
+                                          devices.Get(1));
+}
+
+NdiscCache::Entry*
+NdiscNudTimerTestBase::AddEntry(Ipv6Address address)
+{
+    return m_cache->Add(address);
+}
+
+void
+NdiscNudTimerTestBase::Receive(Ptr<NetDevice> device,
+                               Ptr<const Packet> packet,
+                               uint16_t protocol,
+                               const Address& from,
+                               const Address& to,
+                               NetDevice::PacketType packetType)
+{
+    Ptr<Packet> p = packet->Copy();
+    Ipv6Header ipHeader;
+    p->RemoveHeader(ipHeader);
+    if (ipHeader.GetNextHeader() != Icmpv6L4Protocol::PROT_NUMBER)
+    {
+        return;
+    }
+    Icmpv6Header icmpHeader;
+    p->PeekHeader(icmpHeader);
+    if (icmpHeader.GetType() != Icmpv6Header::ICMPV6_ND_NEIGHBOR_SOLICITATION)
+    {
+        return;
+    }
+    Icmpv6NS ns;
+    p->RemoveHeader(ns);
+    m_nsCount[ns.GetIpv6Target()]++;
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief REACHABLE to STALE transition, with a lazy refresh of the timer
+ *
+ * The entry is confirmed at 0 s and again at 20 s: it must become STALE
+ * ReachableTime (30 s) after the last confirmation, i.e. at 50 s, and not
+ * when the first timer would have expired.
+ */
+class NdiscReachableRefreshTest : public NdiscNudTimerTestBase
+{
+  public:
+    NdiscReachableRefreshTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the state of the entry
+     * \param reachable whether the entry should be REACHABLE (otherwise STALE)
+     */
+    void Check(bool reachable);
+
+    NdiscCache::Entry* m_entry{nullptr}; //!< The entry
+};
+
+NdiscReachableRefreshTest::NdiscReachableRefreshTest()
+    : NdiscNudTimerTestBase("NDISC REACHABLE timer refreshed by a confirmation")
+{
+}
+
+void
+NdiscReachableRefreshTest::Check(bool reachable)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_entry->IsReachable(),
+                          reachable,
+                          "Wrong REACHABLE state at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_entry->IsStale(),
+                          !reachable,
+                          "Wrong STALE state at " << Simulator::Now().As(Time::S));
+}
+
+void
+NdiscReachableRefreshTest::DoRun()
+{
+    Setup();
+    m_entry = AddEntry(Ipv6Address("2001:db8::a"));
+    m_entry->SetMacAddress(m_peerMac);
+    m_entry->MarkReachable();
+    m_entry->StartReachableTimer();
+
+    Simulator::Schedule(Seconds(20), &NdiscCache::Entry::UpdateReachableTimer, m_entry);
+    Simulator::Schedule(Seconds(31), &NdiscReachableRefreshTest::Check, this, true);
+    Simulator::Schedule(Seconds(49), &NdiscReachableRefreshTest::Check, this, true);
+    Simulator::Schedule(Seconds(51), &NdiscReachableRefreshTest::Check, this, false);
+    Simulator::Stop(Seconds(60));
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Cancelling the earliest NUD timer of the cache
+ *
+ * Two entries become REACHABLE at 0 s and 2 s. The timer of the first one,
+ * which is the earliest of the cache, is cancelled at 10 s: the second
+ * entry must still become STALE at 32 s, and the first one must stay
+ * REACHABLE.
+ */
+class NdiscCancelEarliestTest : public NdiscNudTimerTestBase
+{
+  public:
+    NdiscCancelEarliestTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Start the REACHABLE timer of an entry
+     * \param entry the entry
+     */
+    void MakeReachable(NdiscCache::Entry* entry);
+
+    /**
+     * \brief Check the state of the entries
+     * \param secondReachable whether the second entry should be REACHABLE
+     */
+    void Check(bool secondReachable);
+
+    NdiscCache::Entry* m_first{nullptr};  //!< The entry whose timer is cancelled
+    NdiscCache::Entry* m_second{nullptr}; //!< The entry whose timer expires
+};
+
+NdiscCancelEarliestTest::NdiscCancelEarliestTest()
+    : NdiscNudTimerTestBase("NDISC earliest NUD timer cancelled")
+{
+}
+
+void
+NdiscCancelEarliestTest::MakeReachable(NdiscCache::Entry* entry)
+{
+    entry->SetMacAddress(m_peerMac);
+    entry->MarkReachable();
+    entry->StartReachableTimer();
+}
+
+void
+NdiscCancelEarliestTest::Check(bool secondReachable)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_first->IsReachable(),
+                          true,
+                          "Cancelled timer expired at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_second->IsReachable(),
+                          secondReachable,
+                          "Wrong state of the second entry at " << Simulator::Now().As(Time::S));
+}
+
+void
+NdiscCancelEarliestTest::DoRun()
+{
+    Setup();
+    m_first = AddEntry(Ipv6Address("2001:db8::a"));
+    m_second = AddEntry(Ipv6Address("2001:db8::b"));
+
+    MakeReachable(m_first);
+    Simulator::Schedule(Seconds(2), &NdiscCancelEarliestTest::MakeReachable, this, m_second);
+    Simulator::Schedule(Seconds(10), &NdiscCache::Entry::StopNudTimer, m_first);
+    Simulator::Schedule(Seconds(31), &NdiscCancelEarliestTest::Check, this, true);
+    Simulator::Schedule(Seconds(33), &NdiscCancelEarliestTest::Check, this, false);
+    Simulator::Stop(Seconds(40));
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Retransmission limits of the DELAY/PROBE and INCOMPLETE states
+ *
+ * An entry in DELAY sends its first unicast probe after DelayFirstProbe
+ * (5 s), then a probe every RetransmissionTime (1 s) up to MaxUnicastSolicit
+ * (3) probes, and is removed 1 s after the last one, at 8 s. An INCOMPLETE
+ * entry retransmits its multicast solicitation every RetransmissionTime up to
+ * MaxMulticastSolicit (3) times and is removed at 4 s. Both run on the
+ * shared timer of the cache at the same time.
+ */
+class NdiscRetransmitLimitTest : public NdiscNudTimerTestBase
+{
+  public:
+    NdiscRetransmitLimitTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Check the entries and the solicitations received
+     * \param probeExists whether the DELAY/PROBE entry should exist
+     * \param probes the number of unicast probes received
+     * \param incompleteExists whether the INCOMPLETE entry should exist
+     * \param solicitations the number of multicast solicitations received
+     */
+    void Check(bool probeExists, uint32_t probes, bool incompleteExists, uint32_t solicitations);
+
+    const Ipv6Address m_probeTarget{"2001:db8::a"};      //!< Target of the DELAY/PROBE entry
+    const Ipv6Address m_incompleteTarget{"2001:db8::b"}; //!< Target of the INCOMPLETE entry
+};
+
+NdiscRetransmitLimitTest::NdiscRetransmitLimitTest()
+    : NdiscNudTimerTestBase("NDISC DELAY, PROBE and INCOMPLETE retransmit limits")
+{
+}
+
+void
+NdiscRetransmitLimitTest::Check(bool probeExists,
+                                uint32_t probes,
+                                bool incompleteExists,
+                                uint32_t solicitations)
+{
+    NdiscCache::Entry* probe = m_cache->Lookup(m_probeTarget);
+    NS_TEST_EXPECT_MSG_EQ((probe != nullptr),
+                          probeExists,
+                          "Wrong DELAY/PROBE entry at " << Simulator::Now().As(Time::S));
+    if (probe && probes > 0)
+    {
+        NS_TEST_EXPECT_MSG_EQ(probe->IsProbe(), true, "Entry not in PROBE state");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_nsCount[m_probeTarget],
+                          probes,
+                          "Wrong number of probes at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ((m_cache->Lookup(m_incompleteTarget) != nullptr),
+                          incompleteExists,
+                          "Wrong INCOMPLETE entry at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_nsCount[m_incompleteTarget],
+                          solicitations,
+                          "Wrong number of solicitations at " << Simulator::Now().As(Time::S));
+}
+
+void
+NdiscRetransmitLimitTest::DoRun()
+{
+    Setup();
+
+    NdiscCache::Entry* probe = AddEntry(m_probeTarget);
+    probe->MarkStale(m_peerMac);
+    probe->MarkDelay();
+    probe->StartDelayTimer();
+
+    NdiscCache::Entry* incomplete = AddEntry(m_incompleteTarget);
+    Ipv6Header header;
+    header.SetSource(Ipv6Address("2001:db8::1"));
+    header.SetDestination(m_incompleteTarget);
+    incomplete->MarkIncomplete(NdiscCache::Ipv6PayloadHeaderPair(Create<Packet>(100), header));
+    incomplete->StartRetransmitTimer();
+
+    Simulator::Schedule(Seconds(0.5), &NdiscRetransmitLimitTest::Check, this, true, 0, true, 0);
+    Simulator::Schedule(Seconds(3.5), &NdiscRetransmitLimitTest::Check, this, true, 0, true, 3);
+    Simulator::Schedule(Seconds(4.5), &NdiscRetransmitLimitTest::Check, this, true, 0, false, 3);
+    Simulator::Schedule(Seconds(5.5), &NdiscRetransmitLimitTest::Check, this, true, 1, false, 3);
+    Simulator::Schedule(Seconds(7.5), &NdiscRetransmitLimitTest::Check, this, true, 3, false, 3);
+    Simulator::Schedule(Seconds(8.5), &NdiscRetransmitLimitTest::Check, this, false, 3, false, 3);
+    Simulator::Stop(Seconds(10));
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Retries and expiry of the ARP entries in WAIT_REPLY state
+ *
+ * Two entries wait for a reply. The first one is retried every
+ * WaitReplyTimeout (1 s) up to MaxRetries (3) times and is marked dead at
+ * 4 s, dropping its pending packet. The second one is answered at 1.5 s and
+ * must not be retried afterwards.
+ */
+class ArpWaitReplyTest : public TestCase
+{
+  public:
+    ArpWaitReplyTest();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Count the ARP requests sent by the cache
+     * \param cache the cache
+     * \param address the address requested
+     */
+    void Request(Ptr<const ArpCache> cache, Ipv4Address address);
+
+    /**
+     * \brief Count the packets dropped by the cache
+     * \param packet the packet
+     */
+    void Drop(Ptr<const Packet> packet);
+
+    /**
+     * \brief Check the entries and the requests sent
+     * \param firstDead whether the first entry should be dead
+     * \param firstRequests the number of requests for the first entry
+     * \param secondAlive whether the second entry should be alive
+     * \param secondRequests the number of requests for the second entry
+     * \param drops the number of packets dropped
+     */
+    void Check(bool firstDead,
+               uint32_t firstRequests,
+               bool secondAlive,
+               uint32_t secondRequests,
+               uint32_t drops);
+
+    ArpCache::Entry* m_first{nullptr};            //!< The entry never answered
+    ArpCache::Entry* m_second{nullptr};           //!< The entry answered
+    std::map<Ipv4Address, uint32_t> m_requests{}; //!< Requests sent, per address
+    uint32_t m_drops{0};                          //!< Packets dropped
+};
+
+ArpWaitReplyTest::ArpWaitReplyTest()
+    : TestCase("ARP WAIT_REPLY retries and expiry")
+{
+}
+
+void
+ArpWaitReplyTest::Request(Ptr<const ArpCache> cache, Ipv4Address address)
+{
+    m_requests[address]++;
+}
+
+void
+ArpWaitReplyTest::Drop(Ptr<const Packet> packet)
+{
+    m_drops++;
+}
+
+void
+ArpWaitReplyTest::Check(bool firstDead,
+                        uint32_t firstRequests,
+                        bool secondAlive,
+                        uint32_t secondRequests,
+                        uint32_t drops)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_first->IsDead(),
+                          firstDead,
+                          "Wrong state of the first entry at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_first->IsWaitReply(),
+                          !firstDead,
+                          "Wrong state of the first entry at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_requests[m_first->GetIpv4Address()],
+                          firstRequests,
+                          "Wrong number of retries at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_second->IsAlive(),
+                          secondAlive,
+                          "Wrong state of the second entry at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_requests[m_second->GetIpv4Address()],
+                          secondRequests,
+                          "Answered entry retried at " << Simulator::Now().As(Time::S));
+    NS_TEST_EXPECT_MSG_EQ(m_drops, drops, "Wrong number of drops");
+}
+
+void
+ArpWaitReplyTest::DoRun()
+{
+    Ptr<Node> node = CreateObject<Node>();
+    SimpleNetDeviceHelper simpleHelper;
+    NetDeviceContainer devices = simpleHelper.Install(node);
+
+    Ptr<ArpCache> cache = CreateObject<ArpCache>();
+    cache->SetDevice(devices.Get(0), nullptr);
+    cache->SetArpRequestCallback(MakeCallback(&ArpWaitReplyTest::Request, this));
+    cache->TraceConnectWithoutContext("Drop", MakeCallback(&ArpWaitReplyTest::Drop, this));
+
+    Ipv4Header header;
+    header.SetDestination(Ipv4Address("10.0.0.10"));
+    m_first = cache->Add(Ipv4Address("10.0.0.10"));
+    m_first->MarkWaitReply(ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(100), header));
+    header.SetDestination(Ipv4Address("10.0.0.11"));
+    m_second = cache->Add(Ipv4Address("10.0.0.11"));
+    m_second->MarkWaitReply(ArpCache::Ipv4PayloadHeaderPair(Create<Packet>(100), header));
+
+    Simulator::Schedule(Seconds(1.5), [this]() {
+        m_second->MarkAlive(Mac48Address("00:00:00:00:00:0b"));
+        m_second->DequeuePending();
+    });
+
+    Simulator::Schedule(Seconds(0.5), &ArpWaitReplyTest::Check, this, false, 0, false, 0, 0);
+    Simulator::Schedule(Seconds(1.7), &ArpWaitReplyTest::Check, this, false, 1, true, 1, 0);
+    Simulator::Schedule(Seconds(3.5), &ArpWaitReplyTest::Check, this, false, 3, true, 1, 0);
+    Simulator::Schedule(Seconds(4.5), &ArpWaitReplyTest::Check, this, true, 3, true, 1, 1);
+    Simulator::Stop(Seconds(6));
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Neighbor cache timers TestSuite
+ */
+class NeighborCacheTimerTestSuite : public TestSuite
+{
+  public:
+    NeighborCacheTimerTestSuite()
+        : TestSuite("neighbor-cache-timers", UNIT)
+    {
+        AddTestCase(new NdiscReachableRefreshTest(), TestCase::QUICK);
+        AddTestCase(new NdiscCancelEarliestTest(), TestCase::QUICK);
+        AddTestCase(new NdiscRetransmitLimitTest(), TestCase::QUICK);
+        AddTestCase(new ArpWaitReplyTest(), TestCase::QUICK);
+    }
+};
+
+static NeighborCacheTimerTestSuite
+    g_neighborCacheTimerTestSuite; //!< Static variable for test initialization
@@ -0,0 +1,416 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/config.h"
+#include "ns3/error-model.h"
+#include "ns3/inet-socket-address.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-address-helper.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/quic-congestion-control.h"
+#include "ns3/quic-connection.h"
+#include "ns3/quic-header.h"
+#include "ns3/quic-socket-factory.h"
+#include "ns3/quic-socket.h"
+#include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/socket.h"
+#include "ns3/string.h"
+#include "ns3/tcp-bbr.h"
+#include "ns3/tcp-cubic.h"
+#include "ns3/tcp-linux-reno.h"
+#include "ns3/test.h"
+
+#include <map>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("QuicTestSuite");
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Check that the QUIC packet and frame headers survive a round trip
+ */
+class QuicHeaderTestCase : public TestCase
+{
+  public:
+    QuicHeaderTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+QuicHeaderTestCase::QuicHeaderTestCase()
+    : TestCase("QUIC packet and frame headers")
+{
+}
+
+void
+QuicHeaderTestCase::DoRun()
+{
+    for (uint64_t value : {0ULL, 63ULL, 64ULL, 16383ULL, 16384ULL, 1073741823ULL, 1073741824ULL})
+    {
+        Buffer buffer;
+        buffer.AddAtStart(8);
+        Buffer::Iterator i = buffer.Begin();
+        QuicHeader::WriteVarInt(i, value);
+        NS_TEST_EXPECT_MSG_EQ(i.GetDistanceFrom(buffer.Begin()),
+                              QuicHeader::GetVarIntSize(value),
+                              "Wrong size of the variable-length integer " << value);
+        i = buffer.Begin();
+        NS_TEST_EXPECT_MSG_EQ(QuicHeader::ReadVarInt(i), value, "Wrong variable-length integer");
+    }
+
+    Ptr<Packet> packet = Create<Packet>(10);
+
+    QuicFrameHeader ack;
+    ack.SetFrameType(QuicFrameHeader::ACK);
+    ack.SetAckDelay(1234);
+    ack.SetAckRanges({{20, 25}, {10, 15}, {0, 3}});
+    QuicFrameHeader stream;
+    stream.SetFrameType(QuicFrameHeader::STREAM);
+    stream.SetStreamId(8);
+    stream.SetOffset(70000);
+    stream.SetLength(10);
+    stream.SetFin(true);
+    packet->AddHeader(stream);
+    packet->AddHeader(ack);
+
+    QuicHeader header;
+    header.SetPacketType(QuicHeader::HANDSHAKE);
+    header.SetVersion(1);
+    header.SetDestinationConnectionId(0x0123456789abcdefULL);
+    header.SetSourceConnectionId(42);
+    header.SetPacketNumber(300);
+    packet->AddHeader(header);
+
+    QuicHeader rxHeader;
+    packet->RemoveHeader(rxHeader);
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.IsLongHeader(), true, "Wrong header form");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetPacketType(), QuicHeader::HANDSHAKE, "Wrong packet type");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetDestinationConnectionId(),
+                          0x0123456789abcdefULL,
+                          "Wrong destination connection ID");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetSourceConnectionId(), 42, "Wrong source connection ID");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetPacketNumber(), 300, "Wrong packet number");
+
+    QuicFrameHeader rxAck;
+    packet->RemoveHeader(rxAck);
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetFrameType(), QuicFrameHeader::ACK, "Wrong frame type");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetAckDelay(), 1234, "Wrong ACK delay");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetLargestAcked(), 25, "Wrong largest acknowledged");
+    NS_TEST_ASSERT_MSG_EQ(rxAck.GetAckRanges().size(), 3, "Wrong number of ACK ranges");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetAckRanges()[1].first, 10, "Wrong ACK range");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetAckRanges()[1].second, 15, "Wrong ACK range");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetAckRanges()[2].first, 0, "Wrong ACK range");
+    NS_TEST_EXPECT_MSG_EQ(rxAck.GetAckRanges()[2].second, 3, "Wrong ACK range");
+
+    QuicFrameHeader rxStream;
+    packet->RemoveHeader(rxStream);
+    NS_TEST_EXPECT_MSG_EQ(rxStream.GetFrameType(), QuicFrameHeader::STREAM, "Wrong frame type");
+    NS_TEST_EXPECT_MSG_EQ(rxStream.GetStreamId(), 8, "Wrong stream ID");
+    NS_TEST_EXPECT_MSG_EQ(rxStream.GetOffset(), 70000, "Wrong offset");
+    NS_TEST_EXPECT_MSG_EQ(rxStream.GetLength(), 10, "Wrong length");
+    NS_TEST_EXPECT_MSG_EQ(rxStream.IsFin(), true, "Wrong FIN bit");
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), 10, "Wrong size of the data");
+
+    // Short header, and padding up to the end of the packet
+    packet = Create<Packet>(50);
+    header.SetPacketType(QuicHeader::ONE_RTT);
+    packet->AddHeader(header);
+    packet->RemoveHeader(rxHeader);
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.IsLongHeader(), false, "Wrong header form");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetDestinationConnectionId(),
+                          0x0123456789abcdefULL,
+                          "Wrong destination connection ID");
+    NS_TEST_EXPECT_MSG_EQ(rxHeader.GetPacketNumber(), 300, "Wrong packet number");
+    QuicFrameHeader padding;
+    packet->RemoveHeader(padding);
+    NS_TEST_EXPECT_MSG_EQ(padding.GetFrameType(), QuicFrameHeader::PADDING, "Wrong frame type");
+    NS_TEST_EXPECT_MSG_EQ(padding.GetLength(), 50, "Wrong padding length");
+    NS_TEST_EXPECT_MSG_EQ(packet->GetSize(), 0, "The padding was not consumed");
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief Transfer data on several streams of a QUIC connection
+ *
+ * The client opens several sockets to the server, which share a single
+ * connection, and writes a different pattern of data on each of them. Some
+ * packets to the server can be dropped. The test checks that the data of
+ * every stream is received in order and intact, that a single connection
+ * was used, and that the lost packets were detected.
+ */
+class QuicTransferTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param congestion the type of the congestion control algorithm
+     * \param losses whether packets are dropped
+     */
+    QuicTransferTestCase(TypeId congestion, bool losses);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Start writing data once a stream is connected
+     * \param socket the client socket
+     */
+    void Connected(Ptr<Socket> socket);
+
+    /**
+     * \brief Write data into a client socket
+     * \param socket the client socket
+     * \param available the space available in the send buffer
+     */
+    void SendData(Ptr<Socket> socket, uint32_t available);
+
+    /**
+     * \brief Accept a stream on the server
+     * \param socket the stream
+     * \param from the address of the client
+     */
+    void Accept(Ptr<Socket> socket, const Address& from);
+
+    /**
+     * \brief Read and check the data received by the server
+     * \param socket the stream
+     */
+    void ReceiveData(Ptr<Socket> socket);
+
+    /**
+     * \brief Record the end of a stream received by the server
+     * \param socket the stream
+     */
+    void NormalClose(Ptr<Socket> socket);
+
+    /**
+     * \brief Get the index of the stream of a socket
+     * \param socket the socket
+     * \return the index of the stream
+     */
+    static uint32_t GetIndex(Ptr<Socket> socket);
+
+    static const uint32_t m_nStreams = 3;          //!< Number of streams
+    static const uint32_t m_totalBytes = 200000;   //!< Bytes to transfer per stream
+
+    TypeId m_congestion;                           //!< Type of the congestion control
+    bool m_losses;                                 //!< Whether packets are dropped
+    std::map<uint32_t, uint32_t> m_sent;           //!< Bytes written, per stream
+    std::map<uint32_t, uint32_t> m_received;       //!< Bytes read, per stream
+    std::map<uint32_t, bool> m_closed;             //!< Whether the end was received
+    bool m_intact{true};                           //!< Whether the data read was as expected
+};
+
+QuicTransferTestCase::QuicTransferTestCase(TypeId congestion, bool losses)
+    : TestCase("QUIC transfer with " + congestion.GetName() + (losses ? " and losses" : "")),
+      m_congestion(congestion),
+      m_losses(losses)
+{
+}
+
+uint32_t
+QuicTransferTestCase::GetIndex(Ptr<Socket> socket)
+{
+    // Streams opened by the client: 0, 4, 8...
+    return DynamicCast<QuicSocket>(socket)->GetStreamId() / 4;
+}
+
+void
+QuicTransferTestCase::Connected(Ptr<Socket> socket)
+{
+    SendData(socket, socket->GetTxAvailable());
+}
+
+void
+QuicTransferTestCase::SendData(Ptr<Socket> socket, uint32_t /* available */)
+{
+    uint32_t index = GetIndex(socket);
+    uint32_t& sent = m_sent[index];
+    while (sent < m_totalBytes && socket->GetTxAvailable() > 0)
+    {
+        uint32_t size = std::min({socket->GetTxAvailable(), m_totalBytes - sent, 1000U});
+        std::vector<uint8_t> buffer(size);
+        for (uint32_t i = 0; i < size; i++)
+        {
+            buffer[i] = static_cast<uint8_t>((sent + i + index * 7) % 251);
+        }
+        int written = socket->Send(Create<Packet>(buffer.data(), size), 0);
+        if (written <= 0)
+        {
+            return;
+        }
+        sent += written;
+    }
+    if (sent == m_totalBytes)
+    {
+        socket->SetSendCallback(MakeNullCallback<void, Ptr<Socket>, uint32_t>());
+        socket->Close();
+    }
+}
+
+void
+QuicTransferTestCase::Accept(Ptr<Socket> socket, const Address& /* from */)
+{
+    socket->SetRecvCallback(MakeCallback(&QuicTransferTestCase::ReceiveData, this));
+    socket->SetCloseCallbacks(MakeCallback(&QuicTransferTestCase::NormalClose, this),
+                              MakeNullCallback<void, Ptr<Socket>>());
+    ReceiveData(socket);
+}
+
+void
+QuicTransferTestCase::ReceiveData(Ptr<Socket> socket)
+{
+    uint32_t index = GetIndex(socket);
+    uint32_t& received = m_received[index];
+    while (Ptr<Packet> p = socket->Recv())
+    {
+        if (p->GetSize() == 0)
+        {
+            break;
+        }
+        std::vector<uint8_t> buffer(p->GetSize());
+        p->CopyData(buffer.data(), buffer.size());
+        for (uint32_t i = 0; i < buffer.size(); i++)
+        {
+            m_intact &= (buffer[i] == static_cast<uint8_t>((received + i + index * 7) % 251));
+        }
+        received += buffer.size();
+    }
+}
+
+void
+QuicTransferTestCase::NormalClose(Ptr<Socket> socket)
+{
+    m_closed[GetIndex(socket)] = true;
+    // end the stream in the other direction as well
+    socket->Close();
+}
+
+void
+QuicTransferTestCase::DoRun()
+{
+    Ptr<Node> client = CreateObject<Node>();
+    Ptr<Node> server = CreateObject<Node>();
+    NodeContainer nodes(client, server);
+
+    SimpleNetDeviceHelper link;
+    link.SetDeviceAttribute("DataRate", StringValue("10Mbps"));
+    link.SetChannelAttribute("Delay", StringValue("10ms"));
+    link.SetNetDevicePointToPointMode(true);
+    NetDeviceContainer devices = link.Install(nodes);
+
+    if (m_losses)
+    {
+        // Drop a packet of the handshake and data packets, some of them in a row
+        Ptr<ReceiveListErrorModel> errorModel = CreateObject<ReceiveListErrorModel>();
+        errorModel->SetList({1, 12, 30, 31, 32, 60, 100, 101});
+        devices.Get(1)->SetAttribute("ReceiveErrorModel", PointerValue(errorModel));
+    }
+
+    InternetStackHelper internet;
+    internet.Install(nodes);
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    address.Assign(devices);
+    // the client sends its first packet before the simulation starts
+    client->Initialize();
+    server->Initialize();
+
+    Ptr<Socket> sink = Socket::CreateSocket(server, QuicSocketFactory::GetTypeId());
+    sink->Bind(InetSocketAddress(Ipv4Address::GetAny(), 443));
+    sink->Listen();
+    sink->SetAcceptCallback(MakeNullCallback<bool, Ptr<Socket>, const Address&>(),
+                            MakeCallback(&QuicTransferTestCase::Accept, this));
+
+    Config::SetDefault("ns3::QuicConnection::CongestionControl", TypeIdValue(m_congestion));
+    std::vector<Ptr<QuicSocket>> sources;
+    for (uint32_t i = 0; i < m_nStreams; i++)
+    {
+        Ptr<QuicSocket> source =
+            DynamicCast<QuicSocket>(Socket::CreateSocket(client, QuicSocketFactory::GetTypeId()));
+        source->SetConnectCallback(MakeCallback(&QuicTransferTestCase::Connected, this),
+                                   MakeNullCallback<void, Ptr<Socket>>());
+        source->SetSendCallback(MakeCallback(&QuicTransferTestCase::SendData, this));
+        source->Connect(InetSocketAddress(Ipv4Address("10.1.1.2"), 443));
+        sources.push_back(source);
+    }
+    Ptr<QuicConnection> connection = sources.front()->GetConnection();
+    connection->AssignStreams(0);
+    Config::SetDefault("ns3::QuicConnection::CongestionControl",
+                       TypeIdValue(TcpCubic::GetTypeId()));
+
+    Simulator::Stop(Seconds(30));
+    Simulator::Run();
+
+    for (uint32_t i = 0; i < m_nStreams; i++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(sources[i]->GetConnection(),
+                              connection,
+                              "The streams do not share the connection");
+        NS_TEST_EXPECT_MSG_EQ(m_sent[i], m_totalBytes, "Not all the data was written");
+        NS_TEST_EXPECT_MSG_EQ(m_received[i],
+                              m_totalBytes,
+                              "Not all the data of stream " << i << " was received");
+        NS_TEST_EXPECT_MSG_EQ(m_closed[i], true, "The end of stream " << i << " was not received");
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_intact, true, "The data received is corrupted or out of order");
+    NS_TEST_EXPECT_MSG_EQ(connection->IsHandshakeConfirmed(), true, "Handshake not confirmed");
+    NS_TEST_EXPECT_MSG_EQ(connection->GetCongestionControl()
+                              ->GetCongestionControlAlgorithm()
+                              ->GetInstanceTypeId(),
+                          m_congestion,
+                          "Wrong congestion control algorithm");
+    if (m_losses)
+    {
+        NS_TEST_EXPECT_MSG_GT(connection->GetLostPackets(), 0, "The losses were not detected");
+    }
+    else
+    {
+        NS_TEST_EXPECT_MSG_EQ(connection->GetLostPackets(), 0, "Spurious losses");
+    }
+    NS_TEST_EXPECT_MSG_EQ(connection->GetNStreams(), 0, "The completed streams were not removed");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup internet-test
+ *
+ * \brief QUIC TestSuite
+ */
+class QuicTestSuite : public TestSuite
+{
+  public:
+    QuicTestSuite()
+        : TestSuite("quic", UNIT)
+    {
+        AddTestCase(new QuicHeaderTestCase(), TestCase::QUICK);
+        AddTestCase(new QuicTransferTestCase(TcpCubic::GetTypeId(), false), TestCase::QUICK);
+        AddTestCase(new QuicTransferTestCase(TcpCubic::GetTypeId(), true), TestCase::QUICK);
+        AddTestCase(new QuicTransferTestCase(TcpBbr::GetTypeId(), true), TestCase::QUICK);
+        AddTestCase(new QuicTransferTestCase(TcpLinuxReno::GetTypeId(), true), TestCase::QUICK);
+    }
+};
+
+static QuicTestSuite g_quicTestSuite; //!< Static variable for test initialization
@@ -468,7 +468,7 @@ TcpDctcpCongestedRouter::SendDataPacket(SequenceNumber32 seq, uint32_t maxSize,
         NS_LOG_LOGIC(this << " SendDataPacket Schedule ReTxTimeout at time "
                           << Simulator::Now().GetSeconds() << " to expire at time "
                           << (Simulator::Now() + m_rto.Get()).GetSeconds());
-        m_retxEvent = Simulator::Schedule(m_rto, &TcpDctcpCongestedRouter::ReTxTimeout, this);
+        m_retxEvent.Schedule(m_rto, &TcpDctcpCongestedRouter::ReTxTimeout, this);
     }
 
     m_txTrace(p, header, this);
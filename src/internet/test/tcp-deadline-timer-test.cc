@@ -0,0 +1,176 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+#include "ns3/tcp-deadline-timer.h"
+#include "ns3/test.h"
+
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpDeadlineTimerTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the expirations of a TcpDeadlineTimer
+ *
+ * The deadline of the timer is moved later and earlier, the timer is
+ * cancelled and re-armed from its own function; the function must be
+ * invoked exactly at the last deadline set, both with and without the
+ * lazy re-arming.
+ */
+class TcpDeadlineTimerTestCase : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor
+     * \param lazy whether the timer is re-armed lazily
+     */
+    TcpDeadlineTimerTestCase(bool lazy);
+
+  private:
+    void DoRun() override;
+
+    /**
+     * \brief Arm the timer
+     * \param delay the delay of the timer
+     * \param id the identifier passed to Expired
+     */
+    void Arm(Time delay, uint32_t id);
+
+    /**
+     * \brief Cancel the timer
+     */
+    void Cancel();
+
+    /**
+     * \brief Check the state of the timer
+     * \param running whether the timer should be running
+     * \param delayLeft the expected delay left
+     */
+    void Check(bool running, Time delayLeft);
+
+    /**
+     * \brief Function invoked by the timer
+     * \param id the identifier given when the timer was armed
+     */
+    void Expired(uint32_t id);
+
+    bool m_lazy;                                      //!< Lazy re-arming
+    TcpDeadlineTimer m_timer;                         //!< The timer under test
+    std::vector<std::pair<Time, uint32_t>> m_expired; //!< Times and identifiers of expirations
+};
+
+TcpDeadlineTimerTestCase::TcpDeadlineTimerTestCase(bool lazy)
+    : TestCase(std::string("Check TcpDeadlineTimer expirations with ") +
+               (lazy ? "lazy" : "eager") + " re-arming"),
+      m_lazy(lazy)
+{
+}
+
+void
+TcpDeadlineTimerTestCase::Arm(Time delay, uint32_t id)
+{
+    m_timer.Schedule(delay, &TcpDeadlineTimerTestCase::Expired, this, id);
+}
+
+void
+TcpDeadlineTimerTestCase::Cancel()
+{
+    m_timer.Cancel();
+}
+
+void
+TcpDeadlineTimerTestCase::Check(bool running, Time delayLeft)
+{
+    NS_TEST_EXPECT_MSG_EQ(m_timer.IsRunning(), running, "Unexpected timer state");
+    NS_TEST_EXPECT_MSG_EQ(m_timer.IsExpired(), !running, "Unexpected timer state");
+    NS_TEST_EXPECT_MSG_EQ(m_timer.GetDelayLeft(), delayLeft, "Unexpected delay left");
+}
+
+void
+TcpDeadlineTimerTestCase::Expired(uint32_t id)
+{
+    m_expired.emplace_back(Simulator::Now(), id);
+    if (id == 6)
+    {
+        Arm(Seconds(2), 7);
+    }
+}
+
+void
+TcpDeadlineTimerTestCase::DoRun()
+{
+    m_timer.SetLazy(m_lazy);
+
+    // Move the deadline later, then earlier
+    Simulator::Schedule(Seconds(0), &TcpDeadlineTimerTestCase::Arm, this, Seconds(10), 1);
+    Simulator::Schedule(Seconds(1), &TcpDeadlineTimerTestCase::Arm, this, Seconds(20), 2);
+    Simulator::Schedule(Seconds(2), &TcpDeadlineTimerTestCase::Check, this, true, Seconds(19));
+    Simulator::Schedule(Seconds(3), &TcpDeadlineTimerTestCase::Arm, this, Seconds(1), 3);
+
+    // Cancel, then arm again later than the cancelled deadline
+    Simulator::Schedule(Seconds(5), &TcpDeadlineTimerTestCase::Arm, this, Seconds(1), 4);
+    Simulator::Schedule(Seconds(5.5), &TcpDeadlineTimerTestCase::Cancel, this);
+    Simulator::Schedule(Seconds(5.5), &TcpDeadlineTimerTestCase::Check, this, false, Seconds(0));
+    Simulator::Schedule(Seconds(5.5), &TcpDeadlineTimerTestCase::Arm, this, Seconds(2.5), 5);
+
+    // Arm again from the expiration
+    Simulator::Schedule(Seconds(9), &TcpDeadlineTimerTestCase::Arm, this, Seconds(1), 6);
+
+    // Cancel and never arm again
+    Simulator::Schedule(Seconds(20), &TcpDeadlineTimerTestCase::Arm, this, Seconds(1), 8);
+    Simulator::Schedule(Seconds(20), &TcpDeadlineTimerTestCase::Cancel, this);
+
+    Simulator::Run();
+    Simulator::Destroy();
+
+    std::vector<std::pair<Time, uint32_t>> expected{{Seconds(4), 3},
+                                                    {Seconds(8), 5},
+                                                    {Seconds(10), 6},
+                                                    {Seconds(12), 7}};
+    NS_TEST_ASSERT_MSG_EQ(m_expired.size(), expected.size(), "Unexpected number of expirations");
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].first, expected[i].first, "Unexpected expiration time");
+        NS_TEST_EXPECT_MSG_EQ(m_expired[i].second, expected[i].second, "Unexpected function");
+    }
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TcpDeadlineTimer TestSuite
+ */
+class TcpDeadlineTimerTestSuite : public TestSuite
+{
+  public:
+    TcpDeadlineTimerTestSuite()
+        : TestSuite("tcp-deadline-timer", UNIT)
+    {
+        AddTestCase(new TcpDeadlineTimerTestCase(true), TestCase::QUICK);
+        AddTestCase(new TcpDeadlineTimerTestCase(false), TestCase::QUICK);
+    }
+};
+
+static TcpDeadlineTimerTestSuite
+    g_tcpDeadlineTimerTestSuite; //!< Static variable for test initialization
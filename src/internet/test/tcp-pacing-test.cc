@@ -20,6 +20,7 @@
  */
 #include "tcp-general-test.h"
 
+#include "ns3/boolean.h"
 #include "ns3/config.h"
 #include "ns3/log.h"
 #include "ns3/simple-channel.h"
@@ -372,6 +373,40 @@ TcpPacingTest::NormalClose(SocketWho who)
     }
 }
 
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that EDT pacing falls back to the pacing timer
+ *
+ * The sender sets EdtPacing, but no FqQueueDisc is installed on its device:
+ * the segments must be paced by the socket timer, as checked by TcpPacingTest.
+ */
+class TcpEdtPacingFallbackTest : public TcpPacingTest
+{
+  public:
+    using TcpPacingTest::TcpPacingTest;
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+};
+
+void
+TcpEdtPacingFallbackTest::ConfigureEnvironment()
+{
+    TcpPacingTest::ConfigureEnvironment();
+    Config::SetDefault("ns3::TcpSocketState::EdtPacing", BooleanValue(true));
+}
+
+void
+TcpEdtPacingFallbackTest::ConfigureProperties()
+{
+    TcpPacingTest::ConfigureProperties();
+    // The sockets have been created: restore the default for the other tests
+    Config::SetDefault("ns3::TcpSocketState::EdtPacing", BooleanValue(false));
+}
+
 /**
  * \ingroup internet-test
  * \ingroup tests
@@ -490,6 +525,20 @@ class TcpPacingTestSuite : public TestSuite
                                       tid,
                                       description),
                     TestCase::QUICK);
+
+        description = std::string("Pacing case 7: EDT pacing without FQ queue disc, falling back "
+                                  "to the pacing timer");
+        AddTestCase(new TcpEdtPacingFallbackTest(segmentSize,
+                                                 packetSize,
+                                                 numPackets,
+                                                 pacingSsRatio,
+                                                 pacingCaRatio,
+                                                 ssThresh,
+                                                 paceInitialWindow,
+                                                 delAckMaxCount,
+                                                 tid,
+                                                 description),
+                    TestCase::QUICK);
     }
 };
 
@@ -0,0 +1,142 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/log.h"
+#include "ns3/tcp-prague.h"
+#include "ns3/tcp-socket-state.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpPragueTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Testing the RTT-scaled congestion avoidance increment on TcpPrague
+ */
+class TcpPragueIncrementTest : public TestCase
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param cWnd Congestion window.
+     * \param segmentSize Segment size.
+     * \param segmentsAcked Segments ACKed.
+     * \param rtt The RTT of the flow.
+     * \param expectedCwnd Expected congestion window after the increase.
+     * \param name Test description.
+     */
+    TcpPragueIncrementTest(uint32_t cWnd,
+                           uint32_t segmentSize,
+                           uint32_t segmentsAcked,
+                           Time rtt,
+                           uint32_t expectedCwnd,
+                           const std::string& name);
+
+  private:
+    void DoRun() override;
+
+    uint32_t m_cWnd;          //!< Congestion window.
+    uint32_t m_segmentSize;   //!< Segment size.
+    uint32_t m_segmentsAcked; //!< Segments ACKed.
+    Time m_rtt;               //!< The RTT of the flow.
+    uint32_t m_expectedCwnd;  //!< Expected congestion window.
+};
+
+TcpPragueIncrementTest::TcpPragueIncrementTest(uint32_t cWnd,
+                                               uint32_t segmentSize,
+                                               uint32_t segmentsAcked,
+                                               Time rtt,
+                                               uint32_t expectedCwnd,
+                                               const std::string& name)
+    : TestCase(name),
+      m_cWnd(cWnd),
+      m_segmentSize(segmentSize),
+      m_segmentsAcked(segmentsAcked),
+      m_rtt(rtt),
+      m_expectedCwnd(expectedCwnd)
+{
+}
+
+void
+TcpPragueIncrementTest::DoRun()
+{
+    Ptr<TcpSocketState> state = CreateObject<TcpSocketState>();
+    state->m_cWnd = m_cWnd;
+    state->m_ssThresh = m_segmentSize;
+    state->m_segmentSize = m_segmentSize;
+    state->m_lastRtt = m_rtt;
+
+    Ptr<TcpPrague> cong = CreateObject<TcpPrague>();
+    cong->Init(state);
+    NS_TEST_ASSERT_MSG_EQ(state->m_ectCodePoint,
+                          TcpSocketState::Ect1,
+                          "TCP Prague should use ECT(1)");
+
+    // acks are delivered one by one to exercise the fractional increase
+    for (uint32_t i = 0; i < m_segmentsAcked; i++)
+    {
+        cong->IncreaseWindow(state, 1);
+    }
+
+    NS_TEST_ASSERT_MSG_EQ(state->m_cWnd.Get(), m_expectedCwnd, "Unexpected congestion window");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP Prague TestSuite
+ */
+class TcpPragueTestSuite : public TestSuite
+{
+  public:
+    TcpPragueTestSuite()
+        : TestSuite("tcp-prague-test", UNIT)
+    {
+        AddTestCase(new TcpPragueIncrementTest(10 * 1000,
+                                               1000,
+                                               10,
+                                               MilliSeconds(25),
+                                               11 * 1000,
+                                               "One segment per RTT at the target RTT"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpPragueIncrementTest(10 * 1000,
+                                               1000,
+                                               30,
+                                               MilliSeconds(100),
+                                               12 * 1000,
+                                               "No scaling above the target RTT"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpPragueIncrementTest(10 * 1000,
+                                               1000,
+                                               39,
+                                               MicroSeconds(12500),
+                                               10 * 1000,
+                                               "No increase before four RTTs at half the target"),
+                    TestCase::QUICK);
+        AddTestCase(new TcpPragueIncrementTest(10 * 1000,
+                                               1000,
+                                               40,
+                                               MicroSeconds(12500),
+                                               11 * 1000,
+                                               "One segment every four RTTs at half the target"),
+                    TestCase::QUICK);
+    }
+};
+
+static TcpPragueTestSuite g_tcpPragueTest; //!< static var for test initialization
@@ -43,6 +43,11 @@ class TcpRxBufferTestCase : public TestCase
      * \brief Test the SACK list update.
      */
     void TestUpdateSACKList();
+
+    /**
+     * \brief Test the reassembly of blocks no longer reported in the SACK list.
+     */
+    void TestReassembly();
 };
 
 TcpRxBufferTestCase::TcpRxBufferTestCase()
@@ -54,6 +59,7 @@ void
 TcpRxBufferTestCase::DoRun()
 {
     TestUpdateSACKList();
+    TestReassembly();
 }
 
 void
@@ -290,6 +296,62 @@ TcpRxBufferTestCase::TestUpdateSACKList()
     NS_TEST_ASSERT_MSG_EQ(sackList.size(), 0, "SACK list should contain no element");
 }
 
+void
+TcpRxBufferTestCase::TestReassembly()
+{
+    TcpRxBuffer rxBuf;
+    TcpOptionSack::SackList sackList;
+    TcpOptionSack::SackList::iterator it;
+    Ptr<Packet> p = Create<Packet>(100);
+    TcpHeader h;
+
+    rxBuf.SetNextRxSequence(SequenceNumber32(1));
+    rxBuf.SetMaxBufferSize(2000);
+
+    // Five isolated blocks: the oldest one does not fit into the SACK list
+    for (uint32_t seq = 201; seq <= 1001; seq += 200)
+    {
+        h.SetSequenceNumber(SequenceNumber32(seq));
+        rxBuf.Add(p, h);
+    }
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four element");
+    NS_TEST_ASSERT_MSG_EQ(sackList.back().first,
+                          SequenceNumber32(401),
+                          "SACK block different than expected");
+
+    // Fill the gap between the forgotten block and the next one: the whole
+    // contiguous block is reported on top
+    h.SetSequenceNumber(SequenceNumber32(301));
+    rxBuf.Add(p, h);
+
+    sackList = rxBuf.GetSackList();
+    NS_TEST_ASSERT_MSG_EQ(sackList.size(), 4, "SACK list should contain four element");
+    it = sackList.begin();
+    NS_TEST_ASSERT_MSG_EQ(it->first, SequenceNumber32(201), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(it->second, SequenceNumber32(501), "SACK block different than expected");
+    ++it;
+    NS_TEST_ASSERT_MSG_EQ(it->first, SequenceNumber32(1001), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(it->second, SequenceNumber32(1101), "SACK block different than expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 600, "Buffer size differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 0, "Available data differs from expected");
+
+    // In order segment covering all the buffered blocks
+    h.SetSequenceNumber(SequenceNumber32(1));
+    rxBuf.Add(Create<Packet>(1200), h);
+
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.NextRxSequence(),
+                          SequenceNumber32(1201),
+                          "Sequence number differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.GetSackListSize(), 0, "SACK list should contain no element");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 1200, "Buffer size differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Available(), 1200, "Available data differs from expected");
+
+    Ptr<Packet> extracted = rxBuf.Extract(2000);
+    NS_TEST_ASSERT_MSG_EQ(extracted->GetSize(), 1200, "Extracted data differs from expected");
+    NS_TEST_ASSERT_MSG_EQ(rxBuf.Size(), 0, "Buffer size differs from expected");
+}
+
 void
 TcpRxBufferTestCase::DoTeardown()
 {
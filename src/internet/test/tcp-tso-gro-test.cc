@@ -0,0 +1,545 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ */
+
+#include "tcp-error-model.h"
+#include "tcp-general-test.h"
+
+#include "ns3/ipv4-header.h"
+#include "ns3/log.h"
+#include "ns3/node.h"
+#include "ns3/tcp-header.h"
+#include "ns3/uinteger.h"
+
+#include <set>
+
+using namespace ns3;
+
+NS_LOG_COMPONENT_DEFINE("TcpTsoGroTestSuite");
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Error model which records the largest payload seen, and drops only
+ * the sequence numbers declared (see TcpSeqErrorModel::AddSeqToKill)
+ */
+class TcpPayloadSizeErrorModel : public TcpSeqErrorModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Get the largest payload seen on the wire
+     * \return the largest payload size
+     */
+    uint32_t GetMaxPayloadSize() const
+    {
+        return m_maxPayloadSize;
+    }
+
+  protected:
+    bool ShouldDrop(const Ipv4Header& ipHeader,
+                    const TcpHeader& tcpHeader,
+                    uint32_t packetSize) override
+    {
+        m_maxPayloadSize = std::max(m_maxPayloadSize, packetSize);
+        return TcpSeqErrorModel::ShouldDrop(ipHeader, tcpHeader, packetSize);
+    }
+
+  private:
+    void DoReset() override
+    {
+        m_maxPayloadSize = 0;
+        m_seqToKill.clear();
+    }
+
+    uint32_t m_maxPayloadSize{0}; //!< Largest payload seen
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TcpPayloadSizeErrorModel);
+
+TypeId
+TcpPayloadSizeErrorModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpPayloadSizeErrorModel")
+                            .SetParent<TcpSeqErrorModel>()
+                            .AddConstructor<TcpPayloadSizeErrorModel>();
+    return tid;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the transfer of data with TSO and/or GRO enabled
+ *
+ * The sender writes much more data than the initial window, so that TSO
+ * can hand down super-segments; the link has no serialization delay, so that
+ * the segments of a window reach the receiver at the same time and GRO can
+ * coalesce them.
+ *
+ * The checks are performed in FinalChecks: all the data must be delivered,
+ * no segment larger than the MSS must be seen on the wire, and super-segments
+ * (coalesced segments) must have been sent (received) when TSO (GRO) is
+ * enabled.
+ */
+class TcpTsoGroTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param tso Enable TSO on the sender.
+     * \param gro Enable GRO on the receiver.
+     * \param desc Test description.
+     */
+    TcpTsoGroTest(bool tso, bool gro, const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    Ptr<TcpSocketMsgBase> CreateSenderSocket(Ptr<Node> node) override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  protected:
+    bool m_tso;                                 //!< TSO enabled on the sender
+    bool m_gro;                                 //!< GRO enabled on the receiver
+    uint32_t m_bytesReceived{0};                //!< Payload received by the receiver
+    uint32_t m_superSegmentsSent{0};            //!< Segments larger than MSS sent
+    uint32_t m_superSegmentsReceived{0};        //!< Segments larger than MSS received
+    Ptr<TcpPayloadSizeErrorModel> m_errorModel; //!< Records the wire payload sizes
+};
+
+TcpTsoGroTest::TcpTsoGroTest(bool tso, bool gro, const std::string& desc)
+    : TcpGeneralTest(desc),
+      m_tso(tso),
+      m_gro(gro)
+{
+}
+
+void
+TcpTsoGroTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(200);
+    SetAppPktInterval(MicroSeconds(10));
+}
+
+void
+TcpTsoGroTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpTsoGroTest::CreateSenderSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateSenderSocket(node);
+    if (m_tso)
+    {
+        socket->SetAttribute("TsoMaxSize", UintegerValue(65535));
+    }
+    return socket;
+}
+
+Ptr<TcpSocketMsgBase>
+TcpTsoGroTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    if (m_gro)
+    {
+        socket->SetAttribute("GroTimeout", TimeValue(MicroSeconds(50)));
+    }
+    return socket;
+}
+
+Ptr<ErrorModel>
+TcpTsoGroTest::CreateReceiverErrorModel()
+{
+    m_errorModel = CreateObject<TcpPayloadSizeErrorModel>();
+    return m_errorModel;
+}
+
+void
+TcpTsoGroTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == SENDER && p->GetSize() > GetSegSize(SENDER))
+    {
+        ++m_superSegmentsSent;
+    }
+}
+
+void
+TcpTsoGroTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER)
+    {
+        m_bytesReceived += p->GetSize();
+        if (p->GetSize() > GetSegSize(RECEIVER))
+        {
+            ++m_superSegmentsReceived;
+        }
+    }
+}
+
+void
+TcpTsoGroTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_bytesReceived,
+                          GetPktCount() * GetPktSize(),
+                          "Not all the data has been received");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_errorModel->GetMaxPayloadSize(),
+                                GetSegSize(SENDER),
+                                "A segment larger than the MSS has been sent on the wire");
+    NS_TEST_ASSERT_MSG_EQ((m_superSegmentsSent > 0), m_tso, "Unexpected super-segments sent");
+    NS_TEST_ASSERT_MSG_EQ((m_superSegmentsReceived > 0),
+                          m_gro,
+                          "Unexpected coalesced segments received");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check the SACK-based loss recovery of a sender using TSO
+ *
+ * Two segments inside the same super-segment are dropped. The sender must
+ * recover them with fast retransmissions (no RTO), retransmitting only
+ * MSS-sized segments, and all the data must be acknowledged.
+ */
+class TcpTsoSackTest : public TcpTsoGroTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param desc Test description.
+     */
+    TcpTsoSackTest(const std::string& desc);
+
+  protected:
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void CongStateTrace(const TcpSocketState::TcpCongState_t oldValue,
+                        const TcpSocketState::TcpCongState_t newValue) override;
+    void AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    SequenceNumber32 m_highTx{0};  //!< Highest sequence number sent
+    SequenceNumber32 m_highAck{0}; //!< Highest acknowledgment received by the sender
+    uint32_t m_retransmissions{0}; //!< Segments retransmitted
+    bool m_recovery{false};        //!< The sender entered fast recovery
+    uint32_t m_rtoExpired{0};      //!< Number of RTO expirations
+};
+
+TcpTsoSackTest::TcpTsoSackTest(const std::string& desc)
+    : TcpTsoGroTest(true, false, desc)
+{
+}
+
+Ptr<ErrorModel>
+TcpTsoSackTest::CreateReceiverErrorModel()
+{
+    TcpTsoGroTest::CreateReceiverErrorModel();
+    // The initial window of ten segments (as large as the application
+    // packets; the sockets do not exist yet) is sent as one super-segment
+    m_errorModel->AddSeqToKill(SequenceNumber32(1 + 3 * GetPktSize()));
+    m_errorModel->AddSeqToKill(SequenceNumber32(1 + 5 * GetPktSize()));
+    return m_errorModel;
+}
+
+void
+TcpTsoSackTest::Tx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    TcpTsoGroTest::Tx(p, h, who);
+    if (who != SENDER || p->GetSize() == 0)
+    {
+        return;
+    }
+    if (h.GetSequenceNumber() < m_highTx)
+    {
+        ++m_retransmissions;
+        NS_TEST_ASSERT_MSG_LT_OR_EQ(p->GetSize(),
+                                    GetSegSize(SENDER),
+                                    "Retransmissions must not be aggregated");
+    }
+    else
+    {
+        m_highTx = h.GetSequenceNumber() + p->GetSize();
+    }
+}
+
+void
+TcpTsoSackTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    TcpTsoGroTest::Rx(p, h, who);
+    if (who == SENDER && (h.GetFlags() & TcpHeader::ACK))
+    {
+        m_highAck = std::max(m_highAck, h.GetAckNumber());
+    }
+}
+
+void
+TcpTsoSackTest::CongStateTrace(const TcpSocketState::TcpCongState_t oldValue,
+                               const TcpSocketState::TcpCongState_t newValue)
+{
+    if (newValue == TcpSocketState::CA_RECOVERY)
+    {
+        m_recovery = true;
+    }
+}
+
+void
+TcpTsoSackTest::AfterRTOExpired(const Ptr<const TcpSocketState> tcb, SocketWho who)
+{
+    if (who == SENDER)
+    {
+        ++m_rtoExpired;
+    }
+}
+
+void
+TcpTsoSackTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_GT_OR_EQ(m_highAck,
+                                SequenceNumber32(1 + GetPktCount() * GetPktSize()),
+                                "Not all the data has been acknowledged");
+    NS_TEST_ASSERT_MSG_LT_OR_EQ(m_errorModel->GetMaxPayloadSize(),
+                                GetSegSize(SENDER),
+                                "A segment larger than the MSS has been sent on the wire");
+    NS_TEST_ASSERT_MSG_GT(m_superSegmentsSent, 0, "No super-segment sent");
+    NS_TEST_ASSERT_MSG_EQ(m_recovery, true, "The losses have not been fast retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(m_retransmissions, 2, "Only the lost segments must be retransmitted");
+    NS_TEST_ASSERT_MSG_EQ(m_rtoExpired, 0, "The losses must be recovered without RTO");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Error model which sets the CE codepoint on the declared segments
+ */
+class TcpCeMarkErrorModel : public ErrorModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief Mark the segment starting at seq, if it is ECN-capable
+     * \param seq the sequence number
+     */
+    void AddSeqToMark(const SequenceNumber32& seq)
+    {
+        m_seqToMark.insert(seq);
+    }
+
+    /**
+     * \brief Get the number of segments marked
+     * \return the number of segments marked
+     */
+    uint32_t GetMarked() const
+    {
+        return m_marked;
+    }
+
+  private:
+    bool DoCorrupt(Ptr<Packet> p) override
+    {
+        Ipv4Header ipHeader;
+        TcpHeader tcpHeader;
+        p->RemoveHeader(ipHeader);
+        p->PeekHeader(tcpHeader);
+        if (ipHeader.GetEcn() != Ipv4Header::ECN_NotECT &&
+            m_seqToMark.erase(tcpHeader.GetSequenceNumber()) > 0)
+        {
+            ipHeader.SetEcn(Ipv4Header::ECN_CE);
+            ++m_marked;
+        }
+        p->AddHeader(ipHeader);
+        return false;
+    }
+
+    void DoReset() override
+    {
+        m_seqToMark.clear();
+        m_marked = 0;
+    }
+
+    std::set<SequenceNumber32> m_seqToMark; //!< Sequence numbers to mark
+    uint32_t m_marked{0};                   //!< Segments marked
+};
+
+NS_OBJECT_ENSURE_REGISTERED(TcpCeMarkErrorModel);
+
+TypeId
+TcpCeMarkErrorModel::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::TcpCeMarkErrorModel")
+                            .SetParent<ErrorModel>()
+                            .AddConstructor<TcpCeMarkErrorModel>();
+    return tid;
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief Check that GRO reports the CE marks for the right segments
+ *
+ * ECN is enabled on both sides, and GRO on the receiver. A segment in the
+ * middle of a window is marked CE: it must not be coalesced with the
+ * segments held before it, and the ACKs for those segments must not echo
+ * the mark, while the ACK for the marked segment must.
+ */
+class TcpGroEcnTest : public TcpGeneralTest
+{
+  public:
+    /**
+     * \brief Constructor.
+     * \param desc Test description.
+     */
+    TcpGroEcnTest(const std::string& desc);
+
+  protected:
+    void ConfigureEnvironment() override;
+    void ConfigureProperties() override;
+    Ptr<TcpSocketMsgBase> CreateReceiverSocket(Ptr<Node> node) override;
+    Ptr<ErrorModel> CreateReceiverErrorModel() override;
+    void Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who) override;
+    void FinalChecks() override;
+
+  private:
+    SequenceNumber32 m_markedSeq{0};       //!< Sequence number of the marked segment
+    uint32_t m_coalescedOverMark{0};       //!< Coalesced segments spanning the mark
+    uint32_t m_superSegmentsReceived{0};   //!< Coalesced segments received
+    uint32_t m_echoedAcks{0};              //!< ACKs covering the marked segment with ECE
+    uint32_t m_earlyEchoedAcks{0};         //!< ACKs preceding the marked segment with ECE
+    Ptr<TcpCeMarkErrorModel> m_errorModel; //!< Sets the CE codepoint
+};
+
+TcpGroEcnTest::TcpGroEcnTest(const std::string& desc)
+    : TcpGeneralTest(desc)
+{
+}
+
+void
+TcpGroEcnTest::ConfigureEnvironment()
+{
+    TcpGeneralTest::ConfigureEnvironment();
+    SetAppPktCount(200);
+    SetAppPktInterval(MicroSeconds(10));
+}
+
+void
+TcpGroEcnTest::ConfigureProperties()
+{
+    TcpGeneralTest::ConfigureProperties();
+    SetInitialCwnd(SENDER, 10);
+    SetUseEcn(SENDER, TcpSocketState::On);
+    SetUseEcn(RECEIVER, TcpSocketState::On);
+}
+
+Ptr<TcpSocketMsgBase>
+TcpGroEcnTest::CreateReceiverSocket(Ptr<Node> node)
+{
+    Ptr<TcpSocketMsgBase> socket = TcpGeneralTest::CreateReceiverSocket(node);
+    socket->SetAttribute("GroTimeout", TimeValue(MicroSeconds(50)));
+    return socket;
+}
+
+Ptr<ErrorModel>
+TcpGroEcnTest::CreateReceiverErrorModel()
+{
+    m_errorModel = CreateObject<TcpCeMarkErrorModel>();
+    // The sockets do not exist yet: segments are as large as the application packets
+    m_markedSeq = SequenceNumber32(1 + 5 * GetPktSize());
+    m_errorModel->AddSeqToMark(m_markedSeq);
+    return m_errorModel;
+}
+
+void
+TcpGroEcnTest::Rx(const Ptr<const Packet> p, const TcpHeader& h, SocketWho who)
+{
+    if (who == RECEIVER && p->GetSize() > GetSegSize(RECEIVER))
+    {
+        ++m_superSegmentsReceived;
+        if (h.GetSequenceNumber() < m_markedSeq &&
+            h.GetSequenceNumber() + p->GetSize() > m_markedSeq)
+        {
+            ++m_coalescedOverMark;
+        }
+    }
+    else if (who == SENDER && !(h.GetFlags() & TcpHeader::SYN) && (h.GetFlags() & TcpHeader::ECE))
+    {
+        if (h.GetAckNumber() <= m_markedSeq)
+        {
+            ++m_earlyEchoedAcks;
+        }
+        else
+        {
+            ++m_echoedAcks;
+        }
+    }
+}
+
+void
+TcpGroEcnTest::FinalChecks()
+{
+    NS_TEST_ASSERT_MSG_EQ(m_errorModel->GetMarked(), 1, "The segment has not been marked");
+    NS_TEST_ASSERT_MSG_GT(m_superSegmentsReceived, 0, "No coalesced segment received");
+    NS_TEST_ASSERT_MSG_EQ(m_coalescedOverMark,
+                          0,
+                          "The marked segment has been coalesced with the previous ones");
+    NS_TEST_ASSERT_MSG_EQ(m_earlyEchoedAcks,
+                          0,
+                          "The mark has been echoed for segments preceding the marked one");
+    NS_TEST_ASSERT_MSG_GT(m_echoedAcks, 0, "The mark has not been echoed");
+}
+
+/**
+ * \ingroup internet-test
+ * \ingroup tests
+ *
+ * \brief TCP segmentation and receive offload TestSuite
+ */
+class TcpTsoGroTestSuite : public TestSuite
+{
+  public:
+    TcpTsoGroTestSuite()
+        : TestSuite("tcp-tso-gro-test", UNIT)
+    {
+        AddTestCase(new TcpTsoGroTest(true, false, "TSO on the sender"), TestCase::QUICK);
+        AddTestCase(new TcpTsoGroTest(false, true, "GRO on the receiver"), TestCase::QUICK);
+        AddTestCase(new TcpTsoGroTest(true, true, "TSO and GRO"), TestCase::QUICK);
+        AddTestCase(new TcpTsoSackTest("SACK recovery with TSO on the sender"), TestCase::QUICK);
+        AddTestCase(new TcpGroEcnTest("CE marks with GRO on the receiver"), TestCase::QUICK);
+    }
+};
+
+static TcpTsoGroTestSuite g_tcpTsoGroTestSuite; //!< Static variable for test initialization
@@ -54,6 +54,9 @@ class TcpTxBufferTestCase : public TestCase
     /** \brief Test the logic of merging items in GetTransmittedSegment()
      * which is triggered by CopyFromSequence()*/
     void TestMergeItemsWhenGetTransmittedSegment();
+    /** \brief Test that the cached lost mark and NextSeg hint follow the
+     * changes of the sent list (cumulative ACK, RTO, merges) */
+    void TestCachedHints();
     /**
      * \brief Callback to provide a value of receiver window
      * \returns the receiver window size
@@ -101,6 +104,14 @@ TcpTxBufferTestCase::DoRun()
                         &TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment,
                         this);
 
+    /*
+     * Cases for the cached lost mark and NextSeg hint:
+     * -> SACK blocks received after a cumulative ACK
+     * -> losses marked again after SetSentListLost and ResetSentList
+     * -> NextSeg after a retransmission merged two items
+     */
+    Simulator::Schedule(Seconds(0.0), &TcpTxBufferTestCase::TestCachedHints, this);
+
     Simulator::Run();
     Simulator::Destroy();
 }
@@ -421,6 +432,138 @@ TcpTxBufferTestCase::TestMergeItemsWhenGetTransmittedSegment()
     txBuf.CopyFromSequence(2000, SequenceNumber32(1));
 }
 
+void
+TcpTxBufferTestCase::TestCachedHints()
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+    SequenceNumber32 ret;
+    SequenceNumber32 retHigh;
+
+    txBuf->Add(Create<Packet>(10000));
+    for (uint8_t i = 0; i < 10; ++i)
+    {
+        txBuf->CopyFromSequence(1000, SequenceNumber32((i * 1000) + 1));
+    }
+
+    // 1 and 1001 are lost; retransmit them, moving the hints past them
+    Ptr<TcpOptionSack> sack = CreateObject<TcpOptionSack>();
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(2001), SequenceNumber32(5001)));
+    txBuf->Update(sack->GetSackList());
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 2000, "Lost bytes are wrong");
+    for (uint32_t seq = 1; seq < 2001; seq += 1000)
+    {
+        NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                              true,
+                              "NextSeg should have something to send");
+        NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(seq), "NextSeg returned a wrong segment");
+        txBuf->CopyFromSequence(1000, ret);
+    }
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 2000, "Retransmitted bytes are wrong");
+
+    // Cumulative ACK past the hints, then a new SACK block: 5001 is lost
+    txBuf->DiscardUpTo(SequenceNumber32(5001));
+    sack = CreateObject<TcpOptionSack>();
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(6001), SequenceNumber32(9001)));
+    txBuf->Update(sack->GetSackList());
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 3000, "Sacked bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 1000, "Lost bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(5001)), true, "5001 should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(9001)), false, "9001 is not lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(5001), "NextSeg returned a wrong segment");
+    txBuf->CopyFromSequence(1000, ret);
+
+    // RTO keeping the SACK information: the retransmitted 5001 is sent again
+    // first, even if the hint had moved past it
+    txBuf->SetSentListLost();
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 2000, "Lost bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 0, "Retransmitted bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(5001), "NextSeg returned a wrong segment");
+    txBuf->CopyFromSequence(1000, ret);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(9001), "NextSeg returned a wrong segment");
+
+    // RTO discarding the SACK information: everything is sent again, and the
+    // losses below the old lost mark have to be detected again
+    txBuf->ResetSentList();
+    NS_TEST_ASSERT_MSG_EQ(txBuf->BytesInFlight(), 0, "Nothing should be in flight");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetSacked(), 0, "Sacked bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 0, "Lost bytes are wrong");
+    for (uint8_t i = 0; i < 5; ++i)
+    {
+        txBuf->CopyFromSequence(1000, SequenceNumber32((i * 1000) + 5001));
+    }
+    sack = CreateObject<TcpOptionSack>();
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(6001), SequenceNumber32(9001)));
+    txBuf->Update(sack->GetSackList());
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 1000, "Lost bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->IsLost(SequenceNumber32(5001)), true, "5001 should be lost");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(5001), "NextSeg returned a wrong segment");
+
+    txBuf->DiscardUpTo(SequenceNumber32(10001));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Size is different than expected");
+
+    // Small segments, later retransmitted merged in full-sized segments
+    txBuf = CreateObject<TcpTxBuffer>();
+    txBuf->SetRWndCallback(MakeCallback(&TcpTxBufferTestCase::GetRWnd, this));
+    txBuf->SetHeadSequence(SequenceNumber32(1));
+    txBuf->SetSegmentSize(1000);
+    txBuf->SetDupAckThresh(3);
+    txBuf->Add(Create<Packet>(6000));
+    for (uint8_t i = 0; i < 12; ++i)
+    {
+        txBuf->CopyFromSequence(500, SequenceNumber32((i * 500) + 1));
+    }
+    sack = CreateObject<TcpOptionSack>();
+    sack->AddSackBlock(TcpOptionSack::SackBlock(SequenceNumber32(3001), SequenceNumber32(6001)));
+    txBuf->Update(sack->GetSackList());
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetLost(), 3000, "Lost bytes are wrong");
+
+    // Retransmit only the first half: the hint moves to 501
+    txBuf->CopyFromSequence(500, SequenceNumber32(1));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(501), "NextSeg returned a wrong segment");
+
+    // A full-sized retransmission from 1 merges the items at 1 and 501
+    txBuf->CopyFromSequence(1000, SequenceNumber32(1));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->GetRetransmitsCount(), 1000, "Retransmitted bytes are wrong");
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(1001), "NextSeg returned a wrong segment");
+    txBuf->CopyFromSequence(1000, ret);
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(2001), "NextSeg returned a wrong segment");
+
+    // The merged item has to be found again once its flag is cleared
+    txBuf->DeleteRetransmittedFlagFromHead();
+    NS_TEST_ASSERT_MSG_EQ(txBuf->NextSeg(&ret, &retHigh, true),
+                          true,
+                          "NextSeg should have something to send");
+    NS_TEST_ASSERT_MSG_EQ(ret, SequenceNumber32(1), "NextSeg returned a wrong segment");
+
+    txBuf->DiscardUpTo(SequenceNumber32(6001));
+    NS_TEST_ASSERT_MSG_EQ(txBuf->Size(), 0, "Size is different than expected");
+}
+
 void
 TcpTxBufferTestCase::TestTransmittedBlock()
 {
@@ -101,7 +101,7 @@ LteInterference::StartRx(Ptr<const SpectrumValue> rxPsd)
         // receiving multiple simultaneous signals, make sure they are synchronized
         NS_ASSERT(m_lastChangeTime == Now());
         // make sure they use orthogonal resource blocks
-        NS_ASSERT(Sum((*rxPsd) * (*m_rxSignal)) == 0.0);
+        NS_ASSERT(SumOfProduct(*rxPsd, *m_rxSignal) == 0.0);
         (*m_rxSignal) += (*rxPsd);
     }
 }
@@ -198,23 +198,27 @@ LteInterference::ConditionallyEvaluateChunk()
         NS_LOG_LOGIC(this << " signal = " << *m_rxSignal << " allSignals = " << *m_allSignals
                           << " noise = " << *m_noise);
 
-        SpectrumValue interf = (*m_allSignals) - (*m_rxSignal) + (*m_noise);
+        // reuse the storage of the previous chunks
+        m_interference = *m_allSignals;
+        m_interference -= *m_rxSignal;
+        m_interference += *m_noise;
 
-        SpectrumValue sinr = (*m_rxSignal) / interf;
+        m_sinr = *m_rxSignal;
+        m_sinr /= m_interference;
         Time duration = Now() - m_lastChangeTime;
         for (std::list<Ptr<LteChunkProcessor>>::const_iterator it =
                  m_sinrChunkProcessorList.begin();
              it != m_sinrChunkProcessorList.end();
              ++it)
         {
-            (*it)->EvaluateChunk(sinr, duration);
+            (*it)->EvaluateChunk(m_sinr, duration);
         }
         for (std::list<Ptr<LteChunkProcessor>>::const_iterator it =
                  m_interfChunkProcessorList.begin();
              it != m_interfChunkProcessorList.end();
              ++it)
         {
-            (*it)->EvaluateChunk(interf, duration);
+            (*it)->EvaluateChunk(m_interference, duration);
         }
         for (std::list<Ptr<LteChunkProcessor>>::const_iterator it =
                  m_rsPowerChunkProcessorList.begin();
@@ -143,6 +143,9 @@ class LteInterference : public Object
 
     Ptr<const SpectrumValue> m_noise{nullptr}; ///< the noise value
 
+    SpectrumValue m_interference; ///< the interference plus noise of the last chunk
+    SpectrumValue m_sinr;         ///< the SINR of the last chunk
+
     Time m_lastChangeTime{Seconds(0)}; /**< the time of the last change in
                                         * m_TotalPower
                                         */
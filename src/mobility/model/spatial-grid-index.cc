@@ -0,0 +1,269 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "spatial-grid-index.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+#include <cmath>
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("SpatialGridIndex");
+
+NS_OBJECT_ENSURE_REGISTERED(SpatialGridIndex);
+
+TypeId
+SpatialGridIndex::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::SpatialGridIndex")
+            .SetParent<Object>()
+            .SetGroupName("Mobility")
+            .AddConstructor<SpatialGridIndex>()
+            .AddAttribute("CellSize",
+                          "The size of the side of the square cells of the grid, in meters.",
+                          DoubleValue(200.0),
+                          MakeDoubleAccessor(&SpatialGridIndex::m_cellSize),
+                          MakeDoubleChecker<double>(std::numeric_limits<double>::min()));
+    return tid;
+}
+
+SpatialGridIndex::SpatialGridIndex()
+    : m_maxSpeed(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+SpatialGridIndex::~SpatialGridIndex()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+SpatialGridIndex::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    Object::DoDispose();
+}
+
+uint64_t
+SpatialGridIndex::GetCell(const Vector& position) const
+{
+    auto x = static_cast<int32_t>(std::floor(position.x / m_cellSize));
+    auto y = static_cast<int32_t>(std::floor(position.y / m_cellSize));
+    return (static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) | static_cast<uint32_t>(y);
+}
+
+void
+SpatialGridIndex::Add(uint32_t id, Ptr<MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << id << mobility);
+    NS_ASSERT_MSG(m_entries.find(id) == m_entries.end() &&
+                      std::find(m_unlocated.begin(), m_unlocated.end(), id) == m_unlocated.end(),
+                  "Object " << id << " is already in the index");
+    if (!mobility)
+    {
+        m_unlocated.push_back(id);
+        return;
+    }
+    Vector position = mobility->GetPosition();
+    uint64_t cell = GetCell(position);
+    m_entries[id] = {mobility, cell};
+    m_cells[cell].push_back(id);
+    mobility->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeCallback(&SpatialGridIndex::CourseChanged, this, id));
+    Update(id);
+}
+
+void
+SpatialGridIndex::RemoveFromCell(uint32_t id, uint64_t cell)
+{
+    auto cellIt = m_cells.find(cell);
+    NS_ASSERT(cellIt != m_cells.end());
+    auto it = std::find(cellIt->second.begin(), cellIt->second.end(), id);
+    NS_ASSERT(it != cellIt->second.end());
+    *it = cellIt->second.back();
+    cellIt->second.pop_back();
+    if (cellIt->second.empty())
+    {
+        m_cells.erase(cellIt);
+    }
+}
+
+void
+SpatialGridIndex::Remove(uint32_t id)
+{
+    NS_LOG_FUNCTION(this << id);
+    auto it = m_entries.find(id);
+    if (it == m_entries.end())
+    {
+        auto unlocatedIt = std::find(m_unlocated.begin(), m_unlocated.end(), id);
+        if (unlocatedIt != m_unlocated.end())
+        {
+            m_unlocated.erase(unlocatedIt);
+        }
+        return;
+    }
+    it->second.mobility->TraceDisconnectWithoutContext(
+        "CourseChange",
+        MakeCallback(&SpatialGridIndex::CourseChanged, this, id));
+    RemoveFromCell(id, it->second.cell);
+    m_moving.erase(id);
+    m_entries.erase(it);
+}
+
+void
+SpatialGridIndex::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& entry : m_entries)
+    {
+        entry.second.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&SpatialGridIndex::CourseChanged, this, entry.first));
+    }
+    m_entries.clear();
+    m_cells.clear();
+    m_unlocated.clear();
+    m_moving.clear();
+    m_maxSpeed = 0;
+}
+
+std::size_t
+SpatialGridIndex::GetN() const
+{
+    return m_entries.size() + m_unlocated.size();
+}
+
+void
+SpatialGridIndex::Update(uint32_t id)
+{
+    auto it = m_entries.find(id);
+    NS_ASSERT(it != m_entries.end());
+    Entry& entry = it->second;
+    uint64_t cell = GetCell(entry.mobility->GetPosition());
+    if (cell != entry.cell)
+    {
+        RemoveFromCell(id, entry.cell);
+        m_cells[cell].push_back(id);
+        entry.cell = cell;
+    }
+    double speed = entry.mobility->GetVelocity().GetLength();
+    if (speed > 0)
+    {
+        if (m_moving.empty())
+        {
+            // the objects had no displacement to account for until now
+            m_lastRefresh = Simulator::Now();
+        }
+        m_moving.insert(id);
+        m_maxSpeed = std::max(m_maxSpeed, speed);
+    }
+    else
+    {
+        m_moving.erase(id);
+    }
+}
+
+void
+SpatialGridIndex::CourseChanged(uint32_t id, Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << id << mobility);
+    Update(id);
+}
+
+void
+SpatialGridIndex::Refresh()
+{
+    NS_LOG_FUNCTION(this << m_moving.size());
+    // getting the position may notify a course change, which updates m_moving
+    std::vector<uint32_t> moving(m_moving.begin(), m_moving.end());
+    m_maxSpeed = 0;
+    for (auto id : moving)
+    {
+        Update(id);
+    }
+    m_lastRefresh = Simulator::Now();
+}
+
+void
+SpatialGridIndex::GetNeighbors(const Vector& position,
+                               double distance,
+                               std::vector<uint32_t>& ids)
+{
+    NS_LOG_FUNCTION(this << position << distance);
+    ids.assign(m_unlocated.begin(), m_unlocated.end());
+    if (std::isinf(distance))
+    {
+        for (const auto& entry : m_entries)
+        {
+            ids.push_back(entry.first);
+        }
+        return;
+    }
+
+    if (!m_moving.empty() &&
+        m_maxSpeed * (Simulator::Now() - m_lastRefresh).GetSeconds() > m_cellSize)
+    {
+        Refresh();
+    }
+    // the objects which move may be this far from the position they are indexed at
+    double range = distance;
+    if (!m_moving.empty())
+    {
+        range += m_maxSpeed * (Simulator::Now() - m_lastRefresh).GetSeconds();
+    }
+
+    double minX = std::floor((position.x - range) / m_cellSize);
+    double maxX = std::floor((position.x + range) / m_cellSize);
+    double minY = std::floor((position.y - range) / m_cellSize);
+    double maxY = std::floor((position.y + range) / m_cellSize);
+    if ((maxX - minX + 1) * (maxY - minY + 1) > m_cells.size())
+    {
+        // fewer cells are occupied than covered by the range
+        for (const auto& cell : m_cells)
+        {
+            auto x = static_cast<int32_t>(static_cast<uint32_t>(cell.first >> 32));
+            auto y = static_cast<int32_t>(static_cast<uint32_t>(cell.first));
+            if (x >= minX && x <= maxX && y >= minY && y <= maxY)
+            {
+                ids.insert(ids.end(), cell.second.begin(), cell.second.end());
+            }
+        }
+        return;
+    }
+    for (auto x = static_cast<int32_t>(minX); x <= static_cast<int32_t>(maxX); x++)
+    {
+        for (auto y = static_cast<int32_t>(minY); y <= static_cast<int32_t>(maxY); y++)
+        {
+            auto it = m_cells.find((static_cast<uint64_t>(static_cast<uint32_t>(x)) << 32) |
+                                   static_cast<uint32_t>(y));
+            if (it != m_cells.end())
+            {
+                ids.insert(ids.end(), it->second.begin(), it->second.end());
+            }
+        }
+    }
+}
+
+} // namespace ns3
@@ -0,0 +1,147 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef SPATIAL_GRID_INDEX_H
+#define SPATIAL_GRID_INDEX_H
+
+#include "mobility-model.h"
+
+#include "ns3/nstime.h"
+#include "ns3/object.h"
+
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup mobility
+ *
+ * \brief Index the positions of a set of objects in a uniform grid, to find
+ * the objects close to a given position without going through all of them.
+ *
+ * Each object is identified by an integer chosen by the user of the index
+ * (e.g., its position in a container) and located by its MobilityModel. The
+ * grid divides the horizontal plane into square cells of CellSize meters;
+ * the z coordinate is not indexed.
+ *
+ * The cell of an object is updated when its mobility model notifies a course
+ * change. Between two course changes, an object is assumed to move at the
+ * velocity returned by MobilityModel::GetVelocity: the objects which move are
+ * found within the distance they may have covered since they were last
+ * indexed, and are indexed again once this distance exceeds the cell size.
+ *
+ * The objects without a mobility model have no position: they are part of
+ * all the results.
+ */
+class SpatialGridIndex : public Object
+{
+  public:
+    /**
+     * Register this type with the TypeId system.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    SpatialGridIndex();
+    ~SpatialGridIndex() override;
+
+    /**
+     * Add an object to the index.
+     *
+     * \param id the identifier of the object, which must not be in the index
+     * \param mobility the mobility model of the object, or nullptr
+     */
+    void Add(uint32_t id, Ptr<MobilityModel> mobility);
+    /**
+     * Remove an object from the index, if present.
+     *
+     * \param id the identifier of the object
+     */
+    void Remove(uint32_t id);
+    /**
+     * Remove all the objects from the index.
+     */
+    void Clear();
+    /**
+     * \return the number of objects in the index
+     */
+    std::size_t GetN() const;
+
+    /**
+     * Get the objects which may be within a distance of a position. The result
+     * includes all the objects within this distance, and may include objects
+     * located farther.
+     *
+     * \param position the position
+     * \param distance the distance, in meters, possibly infinite
+     * \param [out] ids the identifiers of the objects, in no particular order
+     */
+    void GetNeighbors(const Vector& position, double distance, std::vector<uint32_t>& ids);
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// An object of the index
+    struct Entry
+    {
+        Ptr<MobilityModel> mobility; //!< Mobility model of the object
+        uint64_t cell;               //!< Cell of the object
+    };
+
+    /**
+     * \param position a position
+     * \return the key of the cell of the position
+     */
+    uint64_t GetCell(const Vector& position) const;
+    /**
+     * Move an object to the cell of its current position, and record
+     * whether it moves.
+     *
+     * \param id the identifier of the object
+     */
+    void Update(uint32_t id);
+    /**
+     * Remove an object from a cell.
+     *
+     * \param id the identifier of the object
+     * \param cell the cell of the object
+     */
+    void RemoveFromCell(uint32_t id, uint64_t cell);
+    /**
+     * Callback invoked on the course changes of the objects.
+     *
+     * \param id the identifier of the object
+     * \param mobility the mobility model of the object
+     */
+    void CourseChanged(uint32_t id, Ptr<const MobilityModel> mobility);
+    /**
+     * Update the cells of the objects which move.
+     */
+    void Refresh();
+
+    double m_cellSize;                                           //!< Size of the cells (m)
+    std::unordered_map<uint32_t, Entry> m_entries;               //!< Objects with a position
+    std::unordered_map<uint64_t, std::vector<uint32_t>> m_cells; //!< Objects in each cell
+    std::vector<uint32_t> m_unlocated;                           //!< Objects without a position
+    std::unordered_set<uint32_t> m_moving;                       //!< Objects which move
+    double m_maxSpeed;                                           //!< Highest moving speed (m/s)
+    Time m_lastRefresh;                                          //!< Last update of moving objects
+};
+
+} // namespace ns3
+
+#endif /* SPATIAL_GRID_INDEX_H */
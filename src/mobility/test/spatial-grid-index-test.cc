@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/spatial-grid-index.h"
+#include "ns3/test.h"
+
+#include <algorithm>
+#include <limits>
+
+using namespace ns3;
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Check that the spatial grid index finds all the objects within a
+ * distance of a position, for objects which stay still, move, or jump.
+ */
+class SpatialGridIndexTestCase : public TestCase
+{
+  public:
+    SpatialGridIndexTestCase();
+
+  private:
+    void DoRun() override;
+    void DoTeardown() override;
+
+    /**
+     * Check the objects found around a position.
+     *
+     * \param position the position
+     * \param distance the distance
+     */
+    void CheckNeighbors(Vector position, double distance);
+
+    Ptr<SpatialGridIndex> m_index;              //!< the index
+    std::vector<Ptr<MobilityModel>> m_mobility; //!< the mobility models of the objects
+    uint32_t m_checks;                          //!< number of checks
+    uint32_t m_found;                           //!< number of objects found
+};
+
+SpatialGridIndexTestCase::SpatialGridIndexTestCase()
+    : TestCase("Check the objects found by the spatial grid index"),
+      m_checks(0),
+      m_found(0)
+{
+}
+
+void
+SpatialGridIndexTestCase::DoTeardown()
+{
+    m_index = nullptr;
+    m_mobility.clear();
+}
+
+void
+SpatialGridIndexTestCase::CheckNeighbors(Vector position, double distance)
+{
+    std::vector<uint32_t> ids;
+    m_index->GetNeighbors(position, distance, ids);
+    std::sort(ids.begin(), ids.end());
+    NS_TEST_ASSERT_MSG_EQ((std::adjacent_find(ids.begin(), ids.end()) == ids.end()),
+                          true,
+                          "An object was found twice");
+    for (uint32_t id = 0; id < m_mobility.size(); id++)
+    {
+        if (m_mobility[id] &&
+            CalculateDistance(m_mobility[id]->GetPosition(), position) <= distance)
+        {
+            NS_TEST_EXPECT_MSG_EQ(std::binary_search(ids.begin(), ids.end(), id),
+                                  true,
+                                  "Object " << id << " at " << m_mobility[id]->GetPosition()
+                                            << " not found within " << distance << " m of "
+                                            << position << " at " << Simulator::Now());
+        }
+    }
+    m_checks++;
+    m_found += ids.size();
+}
+
+void
+SpatialGridIndexTestCase::DoRun()
+{
+    m_index = CreateObject<SpatialGridIndex>();
+    m_index->SetAttribute("CellSize", DoubleValue(100));
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+    const uint32_t nStatic = 400;
+    const uint32_t nMoving = 100;
+    for (uint32_t id = 0; id < nStatic; id++)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(rng->GetValue(-1000, 1000), rng->GetValue(-1000, 1000), 0));
+        m_mobility.push_back(mobility);
+        m_index->Add(id, mobility);
+    }
+    for (uint32_t id = nStatic; id < nStatic + nMoving; id++)
+    {
+        Ptr<ConstantVelocityMobilityModel> mobility =
+            CreateObject<ConstantVelocityMobilityModel>();
+        mobility->SetPosition(Vector(rng->GetValue(-1000, 1000), rng->GetValue(-1000, 1000), 0));
+        mobility->SetVelocity(Vector(rng->GetValue(-30, 30), rng->GetValue(-30, 30), 0));
+        m_mobility.push_back(mobility);
+        m_index->Add(id, mobility);
+    }
+    // an object without position
+    m_mobility.push_back(nullptr);
+    m_index->Add(nStatic + nMoving, nullptr);
+    NS_TEST_ASSERT_MSG_EQ(m_index->GetN(), nStatic + nMoving + 1, "Unexpected number of objects");
+
+    // objects which stop, and a static object which jumps to the other side
+    for (uint32_t id = nStatic; id < nStatic + 10; id++)
+    {
+        double stop = rng->GetValue(0, 20);
+        Simulator::Schedule(Seconds(stop),
+                            &ConstantVelocityMobilityModel::SetVelocity,
+                            DynamicCast<ConstantVelocityMobilityModel>(m_mobility[id]),
+                            Vector(0, 0, 0));
+    }
+    Vector jump = m_mobility[0]->GetPosition();
+    jump.x = -jump.x;
+    jump.y = -jump.y;
+    Simulator::Schedule(Seconds(10), &MobilityModel::SetPosition, m_mobility[0], jump);
+
+    for (uint32_t i = 0; i < 200; i++)
+    {
+        double x = rng->GetValue(-1000, 1000);
+        double y = rng->GetValue(-1000, 1000);
+        Simulator::Schedule(MilliSeconds(i * 100),
+                            &SpatialGridIndexTestCase::CheckNeighbors,
+                            this,
+                            Vector(x, y, 0),
+                            rng->GetValue(0, 300));
+    }
+    Simulator::Schedule(Seconds(10), &SpatialGridIndexTestCase::CheckNeighbors, this, jump, 0);
+    Simulator::Run();
+
+    NS_TEST_ASSERT_MSG_EQ(m_checks, 201, "Unexpected number of checks");
+    // the index returns a small fraction of the objects
+    NS_TEST_EXPECT_MSG_LT(m_found / m_checks, (nStatic + nMoving) / 4, "Too many objects found");
+
+    // an infinite distance returns all the objects
+    std::vector<uint32_t> ids;
+    m_index->GetNeighbors(Vector(0, 0, 0), std::numeric_limits<double>::infinity(), ids);
+    NS_TEST_EXPECT_MSG_EQ(ids.size(), m_index->GetN(), "All the objects should be found");
+
+    // removed objects are not found, nor updated
+    for (uint32_t id = 0; id < nStatic + nMoving + 1; id += 2)
+    {
+        m_index->Remove(id);
+        m_mobility[id] = nullptr;
+    }
+    NS_TEST_EXPECT_MSG_EQ(m_index->GetN(), (nStatic + nMoving) / 2, "Unexpected number of objects");
+    m_index->GetNeighbors(Vector(0, 0, 0), 2000, ids);
+    for (auto id : ids)
+    {
+        NS_TEST_EXPECT_MSG_EQ(id % 2, 1, "Object " << id << " was removed");
+    }
+    CheckNeighbors(Vector(0, 0, 0), 500);
+
+    m_index->Clear();
+    m_index->GetNeighbors(Vector(0, 0, 0), 2000, ids);
+    NS_TEST_EXPECT_MSG_EQ(ids.size(), 0, "The index should be empty");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup mobility-test
+ * \ingroup tests
+ *
+ * \brief Spatial Grid Index Test Suite
+ */
+class SpatialGridIndexTestSuite : public TestSuite
+{
+  public:
+    SpatialGridIndexTestSuite();
+};
+
+SpatialGridIndexTestSuite::SpatialGridIndexTestSuite()
+    : TestSuite("spatial-grid-index", UNIT)
+{
+    AddTestCase(new SpatialGridIndexTestCase, TestCase::QUICK);
+}
+
+static SpatialGridIndexTestSuite g_spatialGridIndexTestSuite; //!< the test suite
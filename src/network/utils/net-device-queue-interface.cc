@@ -202,8 +202,8 @@ NetDeviceQueueInterface::NetDeviceQueueInterface()
 {
     NS_LOG_FUNCTION(this);
 
-    // the default select queue callback returns 0
-    m_selectQueueCallback = [](Ptr<QueueItem> item) { return 0; };
+    // no select queue callback by default, so that the traffic control layer
+    // selects the transmission queue based on the flow hash
 }
 
 NetDeviceQueueInterface::~NetDeviceQueueInterface()
@@ -280,7 +280,7 @@ NetDeviceQueueInterface::SetSelectQueueCallback(SelectQueueCallback cb)
     m_selectQueueCallback = cb;
 }
 
-NetDeviceQueueInterface::SelectQueueCallback
+const NetDeviceQueueInterface::SelectQueueCallback&
 NetDeviceQueueInterface::GetSelectQueueCallback() const
 {
     return m_selectQueueCallback;
@@ -287,6 +287,11 @@ class NetDeviceQueueInterface : public Object
      *
      * This method is called to set the select queue callback, i.e., the
      * method used to select a device transmission queue for a given packet.
+     * The callback must only depend on (and possibly tag) the given packet,
+     * so that the transmission queues, their child queue discs and their
+     * stop/wake state are handled independently of each other. If no
+     * callback is set, the traffic control layer selects the transmission
+     * queue based on the hash of the flow the packet belongs to.
      */
     void SetSelectQueueCallback(SelectQueueCallback cb);
 
@@ -297,7 +302,7 @@ class NetDeviceQueueInterface : public Object
      * Called by the traffic control layer to get the select queue callback set
      * by a multi-queue device.
      */
-    SelectQueueCallback GetSelectQueueCallback() const;
+    const SelectQueueCallback& GetSelectQueueCallback() const;
 
   protected:
     /**
@@ -26,13 +26,18 @@
 #include "nix-vector-routing.h"
 
 #include "ns3/abort.h"
+#include "ns3/boolean.h"
 #include "ns3/ipv4-list-routing.h"
 #include "ns3/log.h"
 #include "ns3/loopback-net-device.h"
 #include "ns3/names.h"
+#include "ns3/uinteger.h"
 
+#include <algorithm>
 #include <iomanip>
+#include <limits>
 #include <queue>
+#include <thread>
 
 namespace ns3
 {
@@ -56,6 +61,21 @@ template <typename T>
 typename NixVectorRouting<T>::NetDeviceToIpInterfaceMap
     NixVectorRouting<T>::g_netdeviceToIpInterfaceMap;
 
+template <typename T>
+std::vector<typename NixVectorRouting<T>::NixAdjacency> NixVectorRouting<T>::g_nixAdjacency;
+
+template <typename T>
+std::vector<typename NixVectorRouting<T>::NixParents_t> NixVectorRouting<T>::g_nixParents;
+
+template <typename T>
+std::vector<std::unordered_map<uint32_t, Ptr<NixVector>>> NixVectorRouting<T>::g_nixSharedCache;
+
+template <typename T>
+bool NixVectorRouting<T>::g_isSharedTableStale = false;
+
+/// Marker for a node without a parent in a BFS tree (i.e., unreachable)
+static constexpr uint32_t NIX_NO_PARENT = std::numeric_limits<uint32_t>::max();
+
 template <typename T>
 TypeId
 NixVectorRouting<T>::GetTypeId()
@@ -72,13 +92,32 @@ NixVectorRouting<T>::GetTypeId()
     static TypeId tid = TypeId(("ns3::" + name + "NixVectorRouting"))
                             .SetParent<T>()
                             .SetGroupName("NixVectorRouting")
-                            .template AddConstructor<NixVectorRouting<T>>();
+                            .template AddConstructor<NixVectorRouting<T>>()
+                            .AddAttribute("UseSharedTable",
+                                          "Take the nix-vectors from a table shared by all the "
+                                          "nodes, where the BFS trees of all the sources are "
+                                          "computed at once and updated incrementally upon "
+                                          "topology changes, instead of running a BFS for each "
+                                          "node and destination pair.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &NixVectorRouting<T>::m_useSharedTable),
+                                          MakeBooleanChecker())
+                            .AddAttribute("SharedTableThreads",
+                                          "Number of threads used to compute the BFS trees of "
+                                          "the shared table (0 means hardware concurrency).",
+                                          UintegerValue(0),
+                                          MakeUintegerAccessor(
+                                              &NixVectorRouting<T>::m_sharedTableThreads),
+                                          MakeUintegerChecker<uint32_t>());
     return tid;
 }
 
 template <typename T>
 NixVectorRouting<T>::NixVectorRouting()
-    : m_totalNeighbors(0)
+    : m_useSharedTable(false),
+      m_sharedTableThreads(0),
+      m_totalNeighbors(0)
 {
     NS_LOG_FUNCTION_NOARGS();
 }
@@ -134,6 +173,12 @@ NixVectorRouting<T>::DoDispose()
     m_node = nullptr;
     m_ip = nullptr;
 
+    // The shared table refers to node IDs that are no longer valid
+    g_nixAdjacency.clear();
+    g_nixParents.clear();
+    g_nixSharedCache.clear();
+    g_isSharedTableStale = false;
+
     T::DoDispose();
 }
 
@@ -170,6 +215,12 @@ NixVectorRouting<T>::FlushGlobalNixRoutingCache() const
     // IP address to node mapping is potentially invalid so clear it.
     // Will be repopulated in lazy evaluation when mapping is needed.
     g_ipAddressToNodeMap.clear();
+
+    // The shared table is updated lazily, only for the affected sources.
+    if (!g_nixParents.empty())
+    {
+        g_isSharedTableStale = true;
+    }
 }
 
 template <typename T>
@@ -215,6 +266,18 @@ NixVectorRouting<T>::GetNixVector(Ptr<Node> source, IpAddress dest, Ptr<NetDevic
         NS_LOG_DEBUG("Do not process packets to self");
         return nullptr;
     }
+    else if (m_useSharedTable && !oif)
+    {
+        Ptr<NixVector> sharedNixVector =
+            GetNixVectorInSharedTable(source->GetId(), destNode->GetId());
+        if (!sharedNixVector)
+        {
+            NS_LOG_ERROR("No routing path exists");
+            return nullptr;
+        }
+        // The shared copy must be kept clean
+        return sharedNixVector->Copy();
+    }
     else
     {
         // otherwise proceed as normal
@@ -751,21 +814,33 @@ NixVectorRouting<T>::RouteOutput(Ptr<Packet> p,
             return rtentry;
         }
     }
-    // Check the Nix cache
-    bool foundInCache = false;
-    nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
-
-    // not in cache
-    if (!foundInCache)
+    if (m_useSharedTable && !oif)
     {
-        NS_LOG_LOGIC("Nix-vector not in cache, build: ");
-        // Build the nix-vector, given this node and the
-        // dest IP address
-        nixVectorInCache = GetNixVector(m_node, destAddress, oif);
-        if (nixVectorInCache)
+        // The shared table already acts as a cache, no per-node copy is kept
+        Ptr<Node> destNode = GetNodeByIp(destAddress);
+        if (destNode && destNode != m_node)
+        {
+            nixVectorInCache = GetNixVectorInSharedTable(m_node->GetId(), destNode->GetId());
+        }
+    }
+    else
+    {
+        // Check the Nix cache
+        bool foundInCache = false;
+        nixVectorInCache = GetNixVectorInCache(destAddress, foundInCache);
+
+        // not in cache
+        if (!foundInCache)
         {
-            // cache it
-            m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
+            NS_LOG_LOGIC("Nix-vector not in cache, build: ");
+            // Build the nix-vector, given this node and the
+            // dest IP address
+            nixVectorInCache = GetNixVector(m_node, destAddress, oif);
+            if (nixVectorInCache)
+            {
+                // cache it
+                m_nixCache.insert(typename NixMap_t::value_type(destAddress, nixVectorInCache));
+            }
         }
     }
 
@@ -1292,6 +1367,290 @@ NixVectorRouting<T>::BFS(uint32_t numberOfNodes,
     return false;
 }
 
+template <typename T>
+void
+NixVectorRouting<T>::BuildNixAdjacency(std::vector<NixAdjacency>& adjacency) const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    adjacency.assign(NodeList::GetNNodes(), NixAdjacency());
+
+    for (NodeList::Iterator it = NodeList::Begin(); it != NodeList::End(); ++it)
+    {
+        Ptr<Node> node = *it;
+        Ptr<IpL3Protocol> ip = node->GetObject<IpL3Protocol>();
+        NixAdjacency& nodeAdjacency = adjacency.at(node->GetId());
+
+        for (uint32_t i = 0; i < node->GetNDevices(); i++)
+        {
+            Ptr<NetDevice> localNetDevice = node->GetDevice(i);
+            Ptr<Channel> channel = localNetDevice->GetChannel();
+            if (!channel)
+            {
+                continue;
+            }
+
+            NetDeviceContainer netDeviceContainer;
+            GetAdjacentNetDevices(localNetDevice, channel, netDeviceContainer);
+
+            // Nix indexes are assigned as in BuildNixVector
+            if (!localNetDevice->IsBridge())
+            {
+                for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin();
+                     iter != netDeviceContainer.End();
+                     iter++)
+                {
+                    nodeAdjacency.neighbors.push_back((*iter)->GetNode()->GetId());
+                }
+            }
+
+            // Forwarding is allowed under the same conditions as in BFS
+            if (ip)
+            {
+                uint32_t interfaceIndex = (ip)->GetInterfaceForDevice(localNetDevice);
+                if (!(ip->IsUp(interfaceIndex)))
+                {
+                    continue;
+                }
+            }
+            if (!(localNetDevice->IsLinkUp()))
+            {
+                continue;
+            }
+            for (NetDeviceContainer::Iterator iter = netDeviceContainer.Begin();
+                 iter != netDeviceContainer.End();
+                 iter++)
+            {
+                Ptr<IpInterface> remoteIpInterface = GetInterfaceByNetDevice(*iter);
+                if (!remoteIpInterface || !(remoteIpInterface->IsUp()))
+                {
+                    continue;
+                }
+                nodeAdjacency.reachable.push_back((*iter)->GetNode()->GetId());
+            }
+        }
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::ComputeBfsTrees(const std::vector<NixAdjacency>& adjacency,
+                                     const std::vector<uint32_t>& sources,
+                                     std::vector<NixParents_t>& parents) const
+{
+    NS_LOG_FUNCTION(this << sources.size());
+
+    if (sources.empty())
+    {
+        return;
+    }
+
+    auto bfsWorker = [&adjacency, &sources, &parents](std::size_t first, std::size_t step) {
+        std::queue<uint32_t> greyNodeList;
+        for (std::size_t i = first; i < sources.size(); i += step)
+        {
+            uint32_t source = sources[i];
+            NixParents_t& parentVector = parents[source];
+            parentVector.assign(adjacency.size(), NIX_NO_PARENT);
+            parentVector[source] = source;
+            greyNodeList.push(source);
+            while (!greyNodeList.empty())
+            {
+                uint32_t currNode = greyNodeList.front();
+                greyNodeList.pop();
+                for (uint32_t remoteNode : adjacency[currNode].reachable)
+                {
+                    if (parentVector[remoteNode] == NIX_NO_PARENT)
+                    {
+                        parentVector[remoteNode] = currNode;
+                        greyNodeList.push(remoteNode);
+                    }
+                }
+            }
+        }
+    };
+
+    std::size_t nThreads = m_sharedTableThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::min(nThreads, sources.size());
+
+    NS_LOG_LOGIC("Computing " << sources.size() << " BFS trees with " << nThreads << " threads");
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < nThreads; t++)
+    {
+        workers.emplace_back(bfsWorker, t, nThreads);
+    }
+    bfsWorker(0, nThreads);
+    for (auto& worker : workers)
+    {
+        worker.join();
+    }
+}
+
+template <typename T>
+void
+NixVectorRouting<T>::UpdateSharedNixTable() const
+{
+    NS_LOG_FUNCTION_NOARGS();
+
+    std::vector<NixAdjacency> adjacency;
+    BuildNixAdjacency(adjacency);
+    uint32_t nNodes = adjacency.size();
+
+    std::vector<uint32_t> sources;
+
+    if (g_nixParents.size() != nNodes)
+    {
+        // First build (or the node list has changed): compute all the trees
+        for (uint32_t s = 0; s < nNodes; s++)
+        {
+            sources.push_back(s);
+        }
+        g_nixParents.assign(nNodes, NixParents_t());
+        g_nixSharedCache.assign(nNodes, std::unordered_map<uint32_t, Ptr<NixVector>>());
+    }
+    else
+    {
+        // Nodes whose neighbors (and hence nix indexes) or forwarding links changed
+        std::vector<uint32_t> changed;
+        for (uint32_t n = 0; n < nNodes; n++)
+        {
+            if (adjacency[n].neighbors != g_nixAdjacency[n].neighbors ||
+                adjacency[n].reachable != g_nixAdjacency[n].reachable)
+            {
+                changed.push_back(n);
+            }
+        }
+
+        // Hop count from the source to a node in a BFS tree
+        auto depth = [](const NixParents_t& parentVector, uint32_t node) {
+            if (parentVector[node] == NIX_NO_PARENT)
+            {
+                return std::numeric_limits<uint32_t>::max();
+            }
+            uint32_t hops = 0;
+            while (parentVector[node] != node)
+            {
+                node = parentVector[node];
+                hops++;
+            }
+            return hops;
+        };
+
+        for (uint32_t s = 0; s < nNodes && !changed.empty(); s++)
+        {
+            const NixParents_t& parentVector = g_nixParents[s];
+            bool affected = false;
+            for (uint32_t c : changed)
+            {
+                // A changed node that forwards packets in this tree: its nix
+                // index encoding or one of its tree links may be gone.
+                for (uint32_t n : g_nixAdjacency[c].reachable)
+                {
+                    if (n != s && parentVector[n] == c)
+                    {
+                        affected = true;
+                        break;
+                    }
+                }
+                // A link of a changed node that provides a shorter path.
+                uint32_t depthC = depth(parentVector, c);
+                for (uint32_t n : adjacency[c].reachable)
+                {
+                    if (affected || depthC == std::numeric_limits<uint32_t>::max())
+                    {
+                        break;
+                    }
+                    affected = depthC + 1 < depth(parentVector, n);
+                }
+                if (affected)
+                {
+                    break;
+                }
+            }
+            if (affected)
+            {
+                sources.push_back(s);
+            }
+        }
+
+        NS_LOG_LOGIC(changed.size() << " nodes changed, " << sources.size() << " of " << nNodes
+                                    << " BFS trees to be recomputed");
+
+        // Nix-vectors of unaffected sources are still valid in the new epoch
+        for (uint32_t s = 0; s < nNodes; s++)
+        {
+            for (auto& entry : g_nixSharedCache[s])
+            {
+                if (entry.second)
+                {
+                    entry.second->SetEpoch(g_epoch);
+                }
+            }
+        }
+    }
+
+    ComputeBfsTrees(adjacency, sources, g_nixParents);
+    for (uint32_t s : sources)
+    {
+        g_nixSharedCache[s].clear();
+    }
+    g_nixAdjacency.swap(adjacency);
+    g_isSharedTableStale = false;
+}
+
+template <typename T>
+Ptr<NixVector>
+NixVectorRouting<T>::GetNixVectorInSharedTable(uint32_t source, uint32_t dest) const
+{
+    NS_LOG_FUNCTION(this << source << dest);
+
+    CheckCacheStateAndFlush();
+
+    if (g_nixParents.empty() || g_isSharedTableStale)
+    {
+        UpdateSharedNixTable();
+    }
+
+    auto& sourceCache = g_nixSharedCache.at(source);
+    auto iter = sourceCache.find(dest);
+    if (iter != sourceCache.end())
+    {
+        NS_LOG_LOGIC("Found Nix-vector in shared table.");
+        return iter->second;
+    }
+
+    Ptr<NixVector> nixVector;
+    const NixParents_t& parentVector = g_nixParents.at(source);
+    if (parentVector.at(dest) != NIX_NO_PARENT)
+    {
+        nixVector = Create<NixVector>();
+        nixVector->SetEpoch(g_epoch);
+
+        // Walk the tree from dest back to the source, as BuildNixVector does
+        uint32_t curr = dest;
+        while (curr != source)
+        {
+            uint32_t parent = parentVector[curr];
+            const std::vector<uint32_t>& neighbors = g_nixAdjacency[parent].neighbors;
+            // BuildNixVector keeps the last matching neighbor
+            auto rit = std::find(neighbors.rbegin(), neighbors.rend(), curr);
+            uint32_t destId =
+                (rit == neighbors.rend()) ? 0 : std::distance(rit, neighbors.rend()) - 1;
+            nixVector->AddNeighborIndex(destId, nixVector->BitCount(neighbors.size()));
+            curr = parent;
+        }
+    }
+
+    // Unreachable destinations are cached too, as null nix-vectors
+    sourceCache[dest] = nixVector;
+    return nixVector;
+}
+
 template <typename T>
 void
 NixVectorRouting<T>::PrintRoutingPath(Ptr<Node> source,
@@ -44,6 +44,7 @@
 
 #include <map>
 #include <unordered_map>
+#include <vector>
 
 // NOLINTBEGIN(modernize-use-override)
 
@@ -119,7 +120,8 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     /**
      * @brief Called when run-time link topology change occurs
      * which iterates through the node list and flushes any
-     * nix vector caches
+     * nix vector caches.  If the shared nix-vector table is in use,
+     * it is marked for an incremental update.
      *
      * \internal
      * \c const is used here due to need to potentially flush the cache
@@ -166,7 +168,9 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
     /**
      * Takes in the source node and dest IP and calls GetNodeByIp,
      * BFS, accounting for any output interface specified, and finally
-     * BuildNixVector to return the built nix-vector
+     * BuildNixVector to return the built nix-vector.
+     * If the shared table is enabled and no output interface is
+     * specified, the nix-vector is taken from the shared table instead.
      *
      * \param source Source node
      * \param dest Destination node address
@@ -272,6 +276,60 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
              std::vector<Ptr<Node>>& parentVector,
              Ptr<NetDevice> oif) const;
 
+    /**
+     * Adjacency of a node, as seen by the shared nix-vector table.
+     */
+    struct NixAdjacency
+    {
+        /// Neighbor node IDs, in nix-index order
+        std::vector<uint32_t> neighbors;
+        /// Neighbor node IDs the node can forward to, in BFS visiting order
+        std::vector<uint32_t> reachable;
+    };
+
+    /// Parent node IDs of a BFS tree, indexed by node ID
+    typedef std::vector<uint32_t> NixParents_t;
+
+    /**
+     * Builds the adjacency of all the nodes in the NodeList, using the
+     * same rules as BFS and BuildNixVector.
+     * \param [out] adjacency the adjacency, indexed by node ID
+     */
+    void BuildNixAdjacency(std::vector<NixAdjacency>& adjacency) const;
+
+    /**
+     * \brief Runs a BFS from every source in the list, in parallel.
+     *
+     * Only plain node IDs are used by the worker threads, so no ns-3
+     * object is touched outside the main thread.
+     *
+     * \param [in] adjacency the adjacency of all the nodes
+     * \param [in] sources the source node IDs to compute the BFS tree for
+     * \param [in,out] parents the BFS trees, indexed by source node ID
+     */
+    void ComputeBfsTrees(const std::vector<NixAdjacency>& adjacency,
+                         const std::vector<uint32_t>& sources,
+                         std::vector<NixParents_t>& parents) const;
+
+    /**
+     * \brief Builds or incrementally updates the shared nix-vector table.
+     *
+     * The first call computes the BFS trees of all the sources.  Subsequent
+     * calls (after a topology change) only recompute the trees of the sources
+     * whose shortest paths or nix-vector encodings may have been affected.
+     */
+    void UpdateSharedNixTable() const;
+
+    /**
+     * Gets the nix-vector from source to dest from the shared table,
+     * building it from the BFS tree of the source if needed.
+     * \param source Source node ID
+     * \param dest Destination node ID
+     * \returns The shared NixVector (not to be modified), or null if
+     *          there is no path.
+     */
+    Ptr<NixVector> GetNixVectorInSharedTable(uint32_t source, uint32_t dest) const;
+
     /**
      * \sa Ipv4RoutingProtocol::DoInitialize
      * \sa Ipv6RoutingProtocol::DoInitialize
@@ -492,6 +550,24 @@ class NixVectorRouting : public std::enable_if_t<std::is_same_v<Ipv4RoutingProto
      */
     static uint32_t g_epoch;
 
+    /** Use the shared, precomputed nix-vector table */
+    bool m_useSharedTable;
+
+    /** Number of threads used to compute the shared table (0 means hardware concurrency) */
+    uint32_t m_sharedTableThreads;
+
+    /** Adjacency used to build the shared table, indexed by node ID */
+    static std::vector<NixAdjacency> g_nixAdjacency;
+
+    /** BFS tree of each source, indexed by source node ID */
+    static std::vector<NixParents_t> g_nixParents;
+
+    /** Shared nix-vectors, indexed by source node ID and then by destination node ID */
+    static std::vector<std::unordered_map<uint32_t, Ptr<NixVector>>> g_nixSharedCache;
+
+    /** Flag to mark when the shared table needs to be updated */
+    static bool g_isSharedTableStale;
+
     /** Cache stores nix-vectors based on destination ip */
     mutable NixMap_t m_nixCache;
 
@@ -18,6 +18,8 @@
  * Author: Ameya Deshpande <ameyanrd@outlook.com>
  */
 
+#include "ns3/boolean.h"
+#include "ns3/config.h"
 #include "ns3/icmpv4-l4-protocol.h"
 #include "ns3/icmpv6-l4-protocol.h"
 #include "ns3/internet-stack-helper.h"
@@ -33,6 +35,7 @@
 #include "ns3/test.h"
 #include "ns3/udp-l4-protocol.h"
 #include "ns3/udp-socket-factory.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -61,11 +64,15 @@ using namespace ns3;
  * (Set down the interface of nC on nB-nC channel.)
  * - Test that routing is not possible from nSrc to nDst.
  *
+ * The same tests are run with the shared nix-vector table, which must
+ * give the same paths as the on-demand BFS.
+ *
  * \brief IPv4 Nix-Vector Routing Test
  */
 class NixVectorRoutingTest : public TestCase
 {
     Ptr<Packet> m_receivedPacket; //!< Received packet
+    bool m_useSharedTable;        //!< Use the shared nix-vector table
 
     /**
      * \brief Send data immediately after being called.
@@ -99,7 +106,12 @@ class NixVectorRoutingTest : public TestCase
 
   public:
     void DoRun() override;
-    NixVectorRoutingTest();
+
+    /**
+     * Constructor
+     * \param useSharedTable use the shared nix-vector table
+     */
+    NixVectorRoutingTest(bool useSharedTable);
 
     /**
      * \brief Receive data.
@@ -110,8 +122,10 @@ class NixVectorRoutingTest : public TestCase
     std::vector<uint32_t> m_receivedPacketSizes; //!< Received packet sizes
 };
 
-NixVectorRoutingTest::NixVectorRoutingTest()
-    : TestCase("three router, two path test")
+NixVectorRoutingTest::NixVectorRoutingTest(bool useSharedTable)
+    : TestCase(std::string("three router, two path test") +
+               (useSharedTable ? " (shared table)" : "")),
+      m_useSharedTable(useSharedTable)
 {
 }
 
@@ -167,6 +181,11 @@ NixVectorRoutingTest::SendData(Time delay, Ptr<Socket> socket, Ipv6Address to)
 void
 NixVectorRoutingTest::DoRun()
 {
+    Config::SetDefault("ns3::Ipv4NixVectorRouting::UseSharedTable", BooleanValue(m_useSharedTable));
+    Config::SetDefault("ns3::Ipv6NixVectorRouting::UseSharedTable", BooleanValue(m_useSharedTable));
+    Config::SetDefault("ns3::Ipv4NixVectorRouting::SharedTableThreads", UintegerValue(2));
+    Config::SetDefault("ns3::Ipv6NixVectorRouting::SharedTableThreads", UintegerValue(2));
+
     // Create topology
     NodeContainer nSrcnA;
     NodeContainer nAnB;
@@ -392,6 +411,8 @@ NixVectorRoutingTest::DoRun()
     NS_TEST_EXPECT_MSG_EQ(stringStream2v6.str(), emptyCaches, "The caches should have been empty.");
 
     Simulator::Destroy();
+
+    Config::Reset();
 }
 
 /**
@@ -406,7 +427,8 @@ class NixVectorRoutingTestSuite : public TestSuite
     NixVectorRoutingTestSuite()
         : TestSuite("nix-vector-routing", UNIT)
     {
-        AddTestCase(new NixVectorRoutingTest(), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(false), TestCase::QUICK);
+        AddTestCase(new NixVectorRoutingTest(true), TestCase::QUICK);
     }
 };
 
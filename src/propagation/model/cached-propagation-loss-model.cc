@@ -0,0 +1,257 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "cached-propagation-loss-model.h"
+
+#include "ns3/double.h"
+#include "ns3/log.h"
+#include "ns3/mobility-model.h"
+#include "ns3/pointer.h"
+#include "ns3/uinteger.h"
+
+#include <limits>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("CachedPropagationLossModel");
+
+NS_OBJECT_ENSURE_REGISTERED(CachedPropagationLossModel);
+
+TypeId
+CachedPropagationLossModel::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::CachedPropagationLossModel")
+            .SetParent<PropagationLossModel>()
+            .SetGroupName("Propagation")
+            .AddConstructor<CachedPropagationLossModel>()
+            .AddAttribute("LossModel",
+                          "The propagation loss model whose loss is cached.",
+                          PointerValue(),
+                          MakePointerAccessor(&CachedPropagationLossModel::SetLossModel,
+                                              &CachedPropagationLossModel::GetLossModel),
+                          MakePointerChecker<PropagationLossModel>())
+            .AddAttribute("PositionTolerance",
+                          "The distance (in meters) the nodes may move before their loss is "
+                          "computed again.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&CachedPropagationLossModel::m_positionTolerance),
+                          MakeDoubleChecker<double>(0.0))
+            .AddAttribute("MaxEntries",
+                          "The maximum number of pairs of nodes in the cache, or 0 for no limit.",
+                          UintegerValue(100000),
+                          MakeUintegerAccessor(&CachedPropagationLossModel::SetMaxEntries,
+                                               &CachedPropagationLossModel::GetMaxEntries),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+CachedPropagationLossModel::CachedPropagationLossModel()
+    : m_hits(0),
+      m_misses(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+CachedPropagationLossModel::~CachedPropagationLossModel()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+CachedPropagationLossModel::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Clear();
+    m_lossModel = nullptr;
+    PropagationLossModel::DoDispose();
+}
+
+void
+CachedPropagationLossModel::SetLossModel(Ptr<PropagationLossModel> model)
+{
+    NS_LOG_FUNCTION(this << model);
+    m_lossModel = model;
+    m_cache.Cleanup();
+}
+
+Ptr<PropagationLossModel>
+CachedPropagationLossModel::GetLossModel() const
+{
+    return m_lossModel;
+}
+
+void
+CachedPropagationLossModel::SetMaxEntries(uint32_t maxEntries)
+{
+    NS_LOG_FUNCTION(this << maxEntries);
+    m_maxEntries = maxEntries;
+    m_cache.SetMaxSize(maxEntries);
+}
+
+uint32_t
+CachedPropagationLossModel::GetMaxEntries() const
+{
+    return m_maxEntries;
+}
+
+uint64_t
+CachedPropagationLossModel::GetHits() const
+{
+    return m_hits;
+}
+
+uint64_t
+CachedPropagationLossModel::GetMisses() const
+{
+    return m_misses;
+}
+
+double
+CachedPropagationLossModel::GetHitRate() const
+{
+    uint64_t total = m_hits + m_misses;
+    return total > 0 ? static_cast<double>(m_hits) / total : 0;
+}
+
+std::size_t
+CachedPropagationLossModel::GetNEntries() const
+{
+    return m_cache.GetSize();
+}
+
+void
+CachedPropagationLossModel::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    for (auto& node : m_nodes)
+    {
+        node.second.mobility->TraceDisconnectWithoutContext(
+            "CourseChange",
+            MakeCallback(&CachedPropagationLossModel::CourseChanged, this));
+    }
+    m_nodes.clear();
+    m_cache.Cleanup();
+    m_hits = 0;
+    m_misses = 0;
+}
+
+uint32_t
+CachedPropagationLossModel::GetCourseChanges(Ptr<MobilityModel> mobility) const
+{
+    auto it = m_nodes.find(PeekPointer(mobility));
+    if (it != m_nodes.end())
+    {
+        return it->second.courseChanges;
+    }
+    mobility->TraceConnectWithoutContext(
+        "CourseChange",
+        MakeCallback(&CachedPropagationLossModel::CourseChanged,
+                     const_cast<CachedPropagationLossModel*>(this)));
+    m_nodes[PeekPointer(mobility)] = {mobility, 0};
+    return 0;
+}
+
+void
+CachedPropagationLossModel::CourseChanged(Ptr<const MobilityModel> mobility)
+{
+    NS_LOG_FUNCTION(this << mobility);
+    auto it = m_nodes.find(PeekPointer(mobility));
+    if (it != m_nodes.end())
+    {
+        it->second.courseChanges++;
+    }
+}
+
+double
+CachedPropagationLossModel::DoCalcRxPower(double txPowerDbm,
+                                          Ptr<MobilityModel> a,
+                                          Ptr<MobilityModel> b) const
+{
+    NS_ASSERT_MSG(m_lossModel, "No propagation loss model to cache");
+    uint32_t courseChangesA = GetCourseChanges(a);
+    uint32_t courseChangesB = GetCourseChanges(b);
+    Vector positionA = a->GetPosition();
+    Vector positionB = b->GetPosition();
+
+    Ptr<CachedLoss> entry = m_cache.GetPathData(a, b, 0);
+    if (entry)
+    {
+        // the pair may have been cached in the other direction
+        bool reversed = (entry->a != PeekPointer(a));
+        const Vector& cachedA = reversed ? entry->positionB : entry->positionA;
+        const Vector& cachedB = reversed ? entry->positionA : entry->positionB;
+        uint32_t cachedChangesA = reversed ? entry->courseChangesB : entry->courseChangesA;
+        uint32_t cachedChangesB = reversed ? entry->courseChangesA : entry->courseChangesB;
+        if (cachedChangesA == courseChangesA && cachedChangesB == courseChangesB &&
+            CalculateDistance(cachedA, positionA) <= m_positionTolerance &&
+            CalculateDistance(cachedB, positionB) <= m_positionTolerance)
+        {
+            m_hits++;
+            NS_LOG_LOGIC("cached gain " << entry->gainDb << " dB");
+            return txPowerDbm + entry->gainDb;
+        }
+    }
+    else
+    {
+        entry = Create<CachedLoss>();
+        m_cache.AddPathData(entry, a, b, 0);
+    }
+
+    m_misses++;
+    double rxPowerDbm = m_lossModel->CalcRxPower(txPowerDbm, a, b);
+    entry->a = PeekPointer(a);
+    entry->positionA = positionA;
+    entry->positionB = positionB;
+    entry->courseChangesA = courseChangesA;
+    entry->courseChangesB = courseChangesB;
+    entry->gainDb = rxPowerDbm - txPowerDbm;
+    NS_LOG_LOGIC("computed gain " << entry->gainDb << " dB");
+    return rxPowerDbm;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    if (!m_lossModel)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    // the loss may have been computed with both nodes up to the tolerance away
+    return m_lossModel->GetMaxRange(txPowerDbm, rxPowerDbm) + 2 * m_positionTolerance;
+}
+
+double
+CachedPropagationLossModel::DoGetMaxGain() const
+{
+    if (!m_lossModel)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_lossModel->GetMaxGain();
+}
+
+int64_t
+CachedPropagationLossModel::DoAssignStreams(int64_t stream)
+{
+    if (!m_lossModel)
+    {
+        return 0;
+    }
+    return m_lossModel->AssignStreams(stream);
+}
+
+} // namespace ns3
@@ -0,0 +1,166 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef CACHED_PROPAGATION_LOSS_MODEL_H
+#define CACHED_PROPAGATION_LOSS_MODEL_H
+
+#include "propagation-cache.h"
+#include "propagation-loss-model.h"
+
+#include "ns3/simple-ref-count.h"
+#include "ns3/vector.h"
+
+#include <unordered_map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup propagation
+ *
+ * \brief Cache the loss computed by another propagation loss model for each
+ * pair of nodes
+ *
+ * The loss computed by the model set with the LossModel attribute (possibly a
+ * chain of models) is kept for each pair of mobility models, and reused as
+ * long as:
+ *  - neither mobility model notified a course change since then, and
+ *  - neither node moved by more than PositionTolerance meters since then.
+ *
+ * With the default tolerance of zero, the loss is only reused for nodes that
+ * have not moved, hence it is the same as computed by the model. A positive
+ * tolerance lets moving nodes reuse the loss computed at a nearby position.
+ *
+ * The cached models must be reciprocal (the loss from a to b is the loss from
+ * b to a), their loss must not depend on the transmission power, and they must
+ * return the same loss for the same positions: models with fast fading, such
+ * as NakagamiPropagationLossModel, should be chained after this model with
+ * SetNext instead. The loss of the models updating their state over time,
+ * e.g., the channel condition of ThreeGppPropagationLossModel, is only updated
+ * when a node moves.
+ *
+ * The cache holds at most MaxEntries pairs of nodes, evicting the least
+ * recently used ones.
+ */
+class CachedPropagationLossModel : public PropagationLossModel
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    CachedPropagationLossModel();
+    ~CachedPropagationLossModel() override;
+
+    // Delete copy constructor and assignment operator to avoid misuse
+    CachedPropagationLossModel(const CachedPropagationLossModel&) = delete;
+    CachedPropagationLossModel& operator=(const CachedPropagationLossModel&) = delete;
+
+    /**
+     * \param model the propagation loss model whose loss is cached
+     */
+    void SetLossModel(Ptr<PropagationLossModel> model);
+    /**
+     * \return the propagation loss model whose loss is cached
+     */
+    Ptr<PropagationLossModel> GetLossModel() const;
+
+    /**
+     * \return the number of losses found in the cache
+     */
+    uint64_t GetHits() const;
+    /**
+     * \return the number of losses computed by the cached model
+     */
+    uint64_t GetMisses() const;
+    /**
+     * \return the fraction of the losses found in the cache
+     */
+    double GetHitRate() const;
+    /**
+     * \return the number of pairs of nodes in the cache
+     */
+    std::size_t GetNEntries() const;
+    /**
+     * Remove all the pairs of nodes from the cache, and reset the statistics.
+     */
+    void Clear();
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    /// The loss cached for a pair of nodes
+    struct CachedLoss : public SimpleRefCount<CachedLoss>
+    {
+        const MobilityModel* a;  //!< The mobility model of the first node
+        Vector positionA;        //!< The position of the first node
+        Vector positionB;        //!< The position of the second node
+        uint32_t courseChangesA; //!< The course changes of the first node
+        uint32_t courseChangesB; //!< The course changes of the second node
+        double gainDb;           //!< The gain (negative loss), in dB
+    };
+
+    /// The nodes whose loss is cached
+    struct TrackedNode
+    {
+        Ptr<MobilityModel> mobility; //!< The mobility model of the node
+        uint32_t courseChanges;      //!< The number of course changes of the node
+    };
+
+    double DoCalcRxPower(double txPowerDbm,
+                         Ptr<MobilityModel> a,
+                         Ptr<MobilityModel> b) const override;
+    double DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const override;
+    double DoGetMaxGain() const override;
+    int64_t DoAssignStreams(int64_t stream) override;
+
+    /**
+     * Get the number of course changes of a node, and start tracking them if
+     * the node was not known yet.
+     *
+     * \param mobility the mobility model of the node
+     * \return the number of course changes of the node
+     */
+    uint32_t GetCourseChanges(Ptr<MobilityModel> mobility) const;
+    /**
+     * Callback invoked on the course changes of the nodes.
+     *
+     * \param mobility the mobility model of the node
+     */
+    void CourseChanged(Ptr<const MobilityModel> mobility);
+    /**
+     * \param maxEntries the maximum number of pairs of nodes in the cache
+     */
+    void SetMaxEntries(uint32_t maxEntries);
+    /**
+     * \return the maximum number of pairs of nodes in the cache
+     */
+    uint32_t GetMaxEntries() const;
+
+    Ptr<PropagationLossModel> m_lossModel;        //!< The cached model
+    double m_positionTolerance;                   //!< Position tolerance (m)
+    uint32_t m_maxEntries;                        //!< Maximum number of pairs of nodes
+    mutable PropagationCache<CachedLoss> m_cache; //!< Losses of the pairs of nodes
+    mutable std::unordered_map<const MobilityModel*, TrackedNode>
+        m_nodes;                //!< Nodes whose course changes are tracked
+    mutable uint64_t m_hits;    //!< Number of losses found in the cache
+    mutable uint64_t m_misses;  //!< Number of losses computed
+};
+
+} // namespace ns3
+
+#endif /* CACHED_PROPAGATION_LOSS_MODEL_H */
@@ -22,7 +22,10 @@
 
 #include "ns3/mobility-model.h"
 
-#include <map>
+#include <functional>
+#include <list>
+#include <type_traits>
+#include <unordered_map>
 
 namespace ns3
 {
@@ -31,12 +34,17 @@ namespace ns3
  * \brief Constructs a cache of objects, where each object is responsible for a single propagation
  * path loss calculations. Propagation path a-->b and b-->a is the same thing. Propagation path is
  * identified by a couple of MobilityModels and a spectrum model UID
+ *
+ * The paths are looked up in a hash table. The cache may be bounded: once
+ * it holds the maximum number of paths, adding a path evicts the least
+ * recently used one.
  */
 template <class T>
 class PropagationCache
 {
   public:
-    PropagationCache(){};
+    PropagationCache()
+        : m_maxSize(0){};
     ~PropagationCache(){};
 
     /**
@@ -54,7 +62,9 @@ class PropagationCache
         {
             return nullptr;
         }
-        return it->second;
+        // the path becomes the most recently used one
+        m_lru.splice(m_lru.begin(), m_lru, it->second.lruPos);
+        return it->second.data;
     };
 
     /**
@@ -71,19 +81,47 @@ class PropagationCache
     {
         PropagationPathIdentifier key = PropagationPathIdentifier(a, b, modelUid);
         NS_ASSERT(m_pathCache.find(key) == m_pathCache.end());
-        m_pathCache.insert(std::make_pair(key, data));
+        if (m_maxSize > 0 && m_pathCache.size() >= m_maxSize)
+        {
+            Evict();
+        }
+        m_lru.push_front(key);
+        m_pathCache.insert(std::make_pair(key, PathData{data, m_lru.begin()}));
     };
 
+    /**
+     * Set the maximum number of paths in the cache, evicting the least
+     * recently used paths in excess
+     * \param maxSize the maximum number of paths, or zero for no limit
+     */
+    void SetMaxSize(std::size_t maxSize)
+    {
+        m_maxSize = maxSize;
+        while (m_maxSize > 0 && m_pathCache.size() > m_maxSize)
+        {
+            Evict();
+        }
+    }
+
+    /**
+     * \return the number of paths in the cache
+     */
+    std::size_t GetSize() const
+    {
+        return m_pathCache.size();
+    }
+
     /**
      * Clean the cache
      */
     void Cleanup()
     {
-        for (auto i : m_pathCache)
+        for (auto& i : m_pathCache)
         {
-            i.second->Dispose();
+            Dispose(i.second.data);
         }
         m_pathCache.clear();
+        m_lru.clear();
     }
 
   private:
@@ -107,45 +145,80 @@ class PropagationCache
         uint32_t m_spectrumModelUid;            //!< model UID
 
         /**
-         * Less-than operator.
+         * Equality operator.
          *
-         * The goal of this operator is just to provide a stable comparison
-         * to be used in containers requiring a order (of any kind).
-         *
-         * If the models are different, the comparison is based on their Uid.
-         * Otherwise, the comparison is based on the pointers of the Mobility models.
+         * Links are supposed to be symmetrical: the paths a-->b and b-->a
+         * of the same model are equal.
          *
          * \param other Right value of the operator.
-         * \returns True if the Left value is less than the Right value.
+         * \returns True if the paths are equal.
          */
-        bool operator<(const PropagationPathIdentifier& other) const
+        bool operator==(const PropagationPathIdentifier& other) const
         {
-            if (m_spectrumModelUid != other.m_spectrumModelUid)
-            {
-                return m_spectrumModelUid < other.m_spectrumModelUid;
-            }
-            /// Links are supposed to be symmetrical!
-            if (std::min(m_dstMobility, m_srcMobility) !=
-                std::min(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::min(m_dstMobility, m_srcMobility) <
-                       std::min(other.m_dstMobility, other.m_srcMobility);
-            }
-            if (std::max(m_dstMobility, m_srcMobility) !=
-                std::max(other.m_dstMobility, other.m_srcMobility))
-            {
-                return std::max(m_dstMobility, m_srcMobility) <
+            return m_spectrumModelUid == other.m_spectrumModelUid &&
+                   std::min(m_dstMobility, m_srcMobility) ==
+                       std::min(other.m_dstMobility, other.m_srcMobility) &&
+                   std::max(m_dstMobility, m_srcMobility) ==
                        std::max(other.m_dstMobility, other.m_srcMobility);
-            }
-            return false;
         }
     };
 
-    /// Typedef: PropagationPathIdentifier, Ptr<T>
-    typedef std::map<PropagationPathIdentifier, Ptr<T>> PathCache;
+    /// Hash function of the paths, independent of their direction
+    struct PropagationPathIdentifierHash
+    {
+        /**
+         * \param path the path
+         * \return the hash of the path
+         */
+        std::size_t operator()(const PropagationPathIdentifier& path) const
+        {
+            const MobilityModel* a = PeekPointer(path.m_srcMobility);
+            const MobilityModel* b = PeekPointer(path.m_dstMobility);
+            std::size_t hash = std::hash<const MobilityModel*>()(std::min(a, b));
+            hash ^= std::hash<const MobilityModel*>()(std::max(a, b)) + 0x9e3779b97f4a7c15ULL +
+                    (hash << 6) + (hash >> 2);
+            return hash ^ path.m_spectrumModelUid;
+        }
+    };
+
+    /// The data of a path, with its position in the list of the paths by use
+    struct PathData
+    {
+        Ptr<T> data;                                                    //!< The data
+        typename std::list<PropagationPathIdentifier>::iterator lruPos; //!< Position by use
+    };
+
+    /// Typedef: PropagationPathIdentifier, PathData
+    typedef std::unordered_map<PropagationPathIdentifier, PathData, PropagationPathIdentifierHash>
+        PathCache;
+
+    /**
+     * Remove the least recently used path from the cache
+     */
+    void Evict()
+    {
+        typename PathCache::iterator it = m_pathCache.find(m_lru.back());
+        Dispose(it->second.data);
+        m_pathCache.erase(it);
+        m_lru.pop_back();
+    }
+
+    /**
+     * Dispose of the data of a path, if it is an Object
+     * \param data the data
+     */
+    static void Dispose(Ptr<T> data)
+    {
+        if constexpr (std::is_base_of_v<Object, T>)
+        {
+            data->Dispose();
+        }
+    }
 
   private:
-    PathCache m_pathCache; //!< Path cache
+    PathCache m_pathCache;                      //!< Path cache
+    std::list<PropagationPathIdentifier> m_lru; //!< Paths, from the most recently used
+    std::size_t m_maxSize;                      //!< Maximum number of paths (0 for no limit)
 };
 } // namespace ns3
 
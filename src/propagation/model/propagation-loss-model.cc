@@ -31,6 +31,7 @@
 #include "ns3/string.h"
 
 #include <cmath>
+#include <limits>
 
 namespace ns3
 {
@@ -83,6 +84,47 @@ PropagationLossModel::CalcRxPower(double txPowerDbm,
     return self;
 }
 
+double
+PropagationLossModel::GetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    double range = std::numeric_limits<double>::infinity();
+    // the models chained to this one may increase the power it returns
+    double nextGain = m_next ? m_next->GetMaxGain() : 0;
+    if (!std::isinf(nextGain))
+    {
+        range = DoGetMaxRange(txPowerDbm, rxPowerDbm - nextGain);
+    }
+    double gain = DoGetMaxGain();
+    if (m_next && !std::isinf(gain))
+    {
+        range = std::min(range, m_next->GetMaxRange(txPowerDbm + gain, rxPowerDbm));
+    }
+    return range;
+}
+
+double
+PropagationLossModel::GetMaxGain() const
+{
+    double gain = DoGetMaxGain();
+    if (m_next)
+    {
+        gain += m_next->GetMaxGain();
+    }
+    return gain;
+}
+
+double
+PropagationLossModel::DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
+double
+PropagationLossModel::DoGetMaxGain() const
+{
+    return std::numeric_limits<double>::infinity();
+}
+
 int64_t
 PropagationLossModel::AssignStreams(int64_t stream)
 {
@@ -282,6 +324,24 @@ FriisPropagationLossModel::DoCalcRxPower(double txPowerDbm,
     return txPowerDbm - std::max(lossDb, m_minLoss);
 }
 
+double
+FriisPropagationLossModel::DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    if (txPowerDbm - m_minLoss < rxPowerDbm)
+    {
+        return 0;
+    }
+    // distance at which the loss is txPowerDbm - rxPowerDbm
+    return m_lambda / (4 * M_PI * std::sqrt(m_systemLoss)) *
+           std::pow(10.0, (txPowerDbm - rxPowerDbm) / 20);
+}
+
+double
+FriisPropagationLossModel::DoGetMaxGain() const
+{
+    return -m_minLoss;
+}
+
 int64_t
 FriisPropagationLossModel::DoAssignStreams(int64_t stream)
 {
@@ -555,6 +615,27 @@ LogDistancePropagationLossModel::DoCalcRxPower(double txPowerDbm,
     return txPowerDbm + rxc;
 }
 
+double
+LogDistancePropagationLossModel::DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    if (txPowerDbm - m_referenceLoss < rxPowerDbm)
+    {
+        return 0;
+    }
+    if (m_exponent <= 0)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return m_referenceDistance *
+           std::pow(10.0, (txPowerDbm - rxPowerDbm - m_referenceLoss) / (10 * m_exponent));
+}
+
+double
+LogDistancePropagationLossModel::DoGetMaxGain() const
+{
+    return m_exponent < 0 ? std::numeric_limits<double>::infinity() : -m_referenceLoss;
+}
+
 int64_t
 LogDistancePropagationLossModel::DoAssignStreams(int64_t stream)
 {
@@ -949,6 +1030,22 @@ RangePropagationLossModel::DoCalcRxPower(double txPowerDbm,
     }
 }
 
+double
+RangePropagationLossModel::DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const
+{
+    if (rxPowerDbm <= -1000)
+    {
+        return std::numeric_limits<double>::infinity();
+    }
+    return txPowerDbm < rxPowerDbm ? 0 : m_range;
+}
+
+double
+RangePropagationLossModel::DoGetMaxGain() const
+{
+    return 0;
+}
+
 int64_t
 RangePropagationLossModel::DoAssignStreams(int64_t stream)
 {
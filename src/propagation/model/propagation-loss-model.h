@@ -102,6 +102,27 @@ class PropagationLossModel : public Object
      */
     double CalcRxPower(double txPowerDbm, Ptr<MobilityModel> a, Ptr<MobilityModel> b) const;
 
+    /**
+     * Returns a distance beyond which the Rx Power, taking into account all
+     * the PropagationLossModel(s) chained to the current one, is lower than
+     * a given power. Channels use it to skip the receivers which are too far
+     * to receive a transmission.
+     *
+     * \param txPowerDbm the transmission power (in dBm)
+     * \param rxPowerDbm the reception power (in dBm)
+     * \returns the distance (in meters), or infinity if the models cannot
+     *          bound it
+     */
+    double GetMaxRange(double txPowerDbm, double rxPowerDbm) const;
+
+    /**
+     * Returns the maximum gain that this model and all the models chained to
+     * it may apply to the transmission power, at any distance.
+     *
+     * \returns the maximum gain (in dB), or infinity if it is not bounded
+     */
+    double GetMaxGain() const;
+
     /**
      * If this loss model uses objects of type RandomVariableStream,
      * set the stream numbers to the integers starting with the offset
@@ -140,6 +161,25 @@ class PropagationLossModel : public Object
                                  Ptr<MobilityModel> a,
                                  Ptr<MobilityModel> b) const = 0;
 
+    /**
+     * Subclasses whose loss increases with the distance should override
+     * this method. The default implementation returns infinity.
+     *
+     * \param txPowerDbm the transmission power (in dBm)
+     * \param rxPowerDbm the reception power (in dBm)
+     * \returns the distance (in meters) beyond which this model alone returns
+     *          an Rx Power lower than rxPowerDbm
+     */
+    virtual double DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const;
+
+    /**
+     * Subclasses with a minimum loss should override this method. The
+     * default implementation returns infinity.
+     *
+     * \returns the maximum gain (in dB) of this model alone
+     */
+    virtual double DoGetMaxGain() const;
+
     Ptr<PropagationLossModel> m_next; //!< Next propagation loss model in the list
 };
 
@@ -304,6 +344,8 @@ class FriisPropagationLossModel : public PropagationLossModel
     double DoCalcRxPower(double txPowerDbm,
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
+    double DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const override;
+    double DoGetMaxGain() const override;
     int64_t DoAssignStreams(int64_t stream) override;
 
     /**
@@ -493,6 +535,8 @@ class LogDistancePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
 
+    double DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const override;
+    double DoGetMaxGain() const override;
     int64_t DoAssignStreams(int64_t stream) override;
 
     /**
@@ -778,6 +822,8 @@ class RangePropagationLossModel : public PropagationLossModel
                          Ptr<MobilityModel> a,
                          Ptr<MobilityModel> b) const override;
 
+    double DoGetMaxRange(double txPowerDbm, double rxPowerDbm) const override;
+    double DoGetMaxGain() const override;
     int64_t DoAssignStreams(int64_t stream) override;
 
     double m_range; //!< Maximum Transmission Range (meters)
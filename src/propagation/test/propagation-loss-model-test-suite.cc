@@ -17,13 +17,16 @@
  */
 
 #include "ns3/abort.h"
+#include "ns3/cached-propagation-loss-model.h"
 #include "ns3/config.h"
 #include "ns3/constant-position-mobility-model.h"
+#include "ns3/constant-velocity-mobility-model.h"
 #include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
 #include "ns3/test.h"
+#include "ns3/uinteger.h"
 
 using namespace ns3;
 
@@ -490,6 +493,241 @@ RangePropagationLossModelTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Test the maximum range returned by the propagation loss models
+ */
+class MaxRangePropagationLossModelTestCase : public TestCase
+{
+  public:
+    MaxRangePropagationLossModelTestCase();
+    ~MaxRangePropagationLossModelTestCase() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Check that the power received from a transmitter is not lower than
+     * rxPowerDbm just before the maximum range, and lower just beyond.
+     *
+     * \param loss the propagation loss model
+     * \param txPowerDbm the transmission power (dBm)
+     * \param rxPowerDbm the reception power (dBm)
+     * \param expected the expected maximum range (m)
+     */
+    void CheckMaxRange(Ptr<PropagationLossModel> loss,
+                       double txPowerDbm,
+                       double rxPowerDbm,
+                       double expected);
+};
+
+MaxRangePropagationLossModelTestCase::MaxRangePropagationLossModelTestCase()
+    : TestCase("Test the maximum range of the propagation loss models")
+{
+}
+
+MaxRangePropagationLossModelTestCase::~MaxRangePropagationLossModelTestCase()
+{
+}
+
+void
+MaxRangePropagationLossModelTestCase::CheckMaxRange(Ptr<PropagationLossModel> loss,
+                                                    double txPowerDbm,
+                                                    double rxPowerDbm,
+                                                    double expected)
+{
+    double range = loss->GetMaxRange(txPowerDbm, rxPowerDbm);
+    NS_TEST_ASSERT_MSG_EQ_TOL(range, expected, expected * 1e-6, "Unexpected maximum range");
+
+    Ptr<MobilityModel> a = CreateObject<ConstantPositionMobilityModel>();
+    a->SetPosition(Vector(0, 0, 0));
+    Ptr<MobilityModel> b = CreateObject<ConstantPositionMobilityModel>();
+    b->SetPosition(Vector(range * 0.999, 0, 0));
+    NS_TEST_EXPECT_MSG_GT_OR_EQ(loss->CalcRxPower(txPowerDbm, a, b),
+                                rxPowerDbm,
+                                "Rx power too low within the maximum range");
+    b->SetPosition(Vector(range * 1.001, 0, 0));
+    NS_TEST_EXPECT_MSG_LT(loss->CalcRxPower(txPowerDbm, a, b),
+                          rxPowerDbm,
+                          "Rx power too high beyond the maximum range");
+}
+
+void
+MaxRangePropagationLossModelTestCase::DoRun()
+{
+    // Friis at 5.15 GHz: 20 log10 (4 pi d / lambda) = 100 dB at 463.237 m
+    Ptr<FriisPropagationLossModel> friis = CreateObject<FriisPropagationLossModel>();
+    friis->SetFrequency(5.15e9);
+    CheckMaxRange(friis, 16.0206, -83.9794, 463.237);
+
+    // log distance: 46.6777 dB at 1 m, then 30 dB per decade
+    Ptr<LogDistancePropagationLossModel> logDistance =
+        CreateObject<LogDistancePropagationLossModel>();
+    logDistance->SetReference(1, 46.6777);
+    logDistance->SetPathLossExponent(3);
+    CheckMaxRange(logDistance, 16.0206, -120.6571, 1000);
+    NS_TEST_EXPECT_MSG_EQ_TOL(logDistance->GetMaxGain(),
+                              -46.6777,
+                              1e-6,
+                              "Unexpected maximum gain");
+
+    Ptr<RangePropagationLossModel> range = CreateObject<RangePropagationLossModel>();
+    range->SetAttribute("MaxRange", DoubleValue(250));
+    CheckMaxRange(range, 16.0206, -90, 250);
+    NS_TEST_EXPECT_MSG_EQ(range->GetMaxRange(-95, -90), 0, "No receiver should be in range");
+
+    // the range of a chain is bounded by each model
+    logDistance->SetNext(range);
+    CheckMaxRange(logDistance, 16.0206, -120.6571, 250);
+    CheckMaxRange(logDistance, 16.0206, -50.6571, 4.64159);
+
+    // the gain of fading is not bounded
+    range->SetNext(CreateObject<NakagamiPropagationLossModel>());
+    NS_TEST_EXPECT_MSG_EQ(std::isinf(logDistance->GetMaxRange(16.0206, -120.6571)),
+                          true,
+                          "The maximum range should not be bounded");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup propagation-tests
+ *
+ * \brief Test the losses returned by the CachedPropagationLossModel
+ */
+class CachedPropagationLossModelTestCase : public TestCase
+{
+  public:
+    CachedPropagationLossModelTestCase();
+    ~CachedPropagationLossModelTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+CachedPropagationLossModelTestCase::CachedPropagationLossModelTestCase()
+    : TestCase("Test the losses cached by the CachedPropagationLossModel")
+{
+}
+
+CachedPropagationLossModelTestCase::~CachedPropagationLossModelTestCase()
+{
+}
+
+void
+CachedPropagationLossModelTestCase::DoRun()
+{
+    Ptr<LogDistancePropagationLossModel> logDistance =
+        CreateObject<LogDistancePropagationLossModel>();
+    logDistance->SetReference(1, 46.6777);
+    logDistance->SetPathLossExponent(3);
+    Ptr<CachedPropagationLossModel> cached = CreateObject<CachedPropagationLossModel>();
+    cached->SetLossModel(logDistance);
+
+    std::vector<Ptr<MobilityModel>> nodes;
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        Ptr<MobilityModel> mobility = CreateObject<ConstantPositionMobilityModel>();
+        mobility->SetPosition(Vector(100 * i, 0, 0));
+        nodes.push_back(mobility);
+    }
+
+    // the losses are the same as computed by the model, in both directions
+    for (uint32_t round = 0; round < 2; round++)
+    {
+        for (uint32_t i = 0; i < nodes.size(); i++)
+        {
+            for (uint32_t j = 0; j < nodes.size(); j++)
+            {
+                if (i != j)
+                {
+                    // the test macros evaluate their arguments more than once
+                    double rxPowerDbm = cached->CalcRxPower(16.0206, nodes[i], nodes[j]);
+                    NS_TEST_EXPECT_MSG_EQ_TOL(rxPowerDbm,
+                                              logDistance->CalcRxPower(16.0206, nodes[i], nodes[j]),
+                                              1e-9,
+                                              "Unexpected cached loss");
+                }
+            }
+        }
+    }
+    NS_TEST_EXPECT_MSG_EQ(cached->GetNEntries(), 6, "One entry per pair of nodes expected");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), 6, "One loss computed per pair of nodes");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetHits(), 18, "The other losses should be cached");
+
+    // the gain does not depend on the transmission power
+    double rxPowerDbm = cached->CalcRxPower(0, nodes[0], nodes[1]);
+    NS_TEST_EXPECT_MSG_EQ_TOL(rxPowerDbm,
+                              logDistance->CalcRxPower(0, nodes[0], nodes[1]),
+                              1e-9,
+                              "Unexpected cached loss");
+
+    // a node which moves is computed again
+    nodes[1]->SetPosition(Vector(150, 0, 0));
+    rxPowerDbm = cached->CalcRxPower(16.0206, nodes[0], nodes[1]);
+    NS_TEST_EXPECT_MSG_EQ_TOL(rxPowerDbm,
+                              logDistance->CalcRxPower(16.0206, nodes[0], nodes[1]),
+                              1e-9,
+                              "The loss should be computed again");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), 7, "The loss should be computed again");
+
+    // within the tolerance, the loss computed at the previous position is used
+    cached->SetAttribute("PositionTolerance", DoubleValue(10));
+    double staticRxPowerDbm = cached->CalcRxPower(16.0206, nodes[0], nodes[2]);
+    Ptr<ConstantVelocityMobilityModel> moving = CreateObject<ConstantVelocityMobilityModel>();
+    moving->SetPosition(Vector(0, 100, 0));
+    moving->SetVelocity(Vector(0, 0, 0));
+    double first = cached->CalcRxPower(16.0206, moving, nodes[0]);
+    NS_TEST_EXPECT_MSG_GT(cached->GetMaxRange(16.0206, -120.6571),
+                          logDistance->GetMaxRange(16.0206, -120.6571),
+                          "The tolerance should extend the maximum range");
+    uint64_t misses = cached->GetMisses();
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    // a course change invalidates the loss, even within the tolerance
+    moving->SetVelocity(Vector(5, 0, 0));
+    cached->CalcRxPower(16.0206, moving, nodes[0]);
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), misses + 1, "A course change should invalidate");
+    Simulator::Stop(Seconds(1));
+    Simulator::Run();
+    rxPowerDbm = cached->CalcRxPower(16.0206, nodes[0], moving);
+    NS_TEST_EXPECT_MSG_EQ_TOL(rxPowerDbm,
+                              first,
+                              1e-9,
+                              "The node is within the tolerance");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), misses + 1, "The node is within the tolerance");
+    Simulator::Stop(Seconds(2));
+    Simulator::Run();
+    rxPowerDbm = cached->CalcRxPower(16.0206, nodes[0], moving);
+    NS_TEST_EXPECT_MSG_LT(rxPowerDbm,
+                          first,
+                          "The node is beyond the tolerance");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), misses + 2, "The node is beyond the tolerance");
+    rxPowerDbm = cached->CalcRxPower(16.0206, nodes[0], nodes[2]);
+    NS_TEST_EXPECT_MSG_EQ(rxPowerDbm,
+                          staticRxPowerDbm,
+                          "Static nodes should stay cached");
+
+    // the least recently used pairs are evicted
+    cached->SetAttribute("MaxEntries", UintegerValue(2));
+    NS_TEST_EXPECT_MSG_EQ(cached->GetNEntries(), 2, "The cache should be bounded");
+    misses = cached->GetMisses();
+    cached->CalcRxPower(16.0206, nodes[2], nodes[0]);
+    cached->CalcRxPower(16.0206, moving, nodes[0]);
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), misses, "The recent pairs should stay cached");
+    cached->CalcRxPower(16.0206, nodes[2], nodes[3]);
+    cached->CalcRxPower(16.0206, nodes[0], nodes[2]);
+    NS_TEST_EXPECT_MSG_EQ(cached->GetMisses(), misses + 2, "The oldest pair should be evicted");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetNEntries(), 2, "The cache should be bounded");
+
+    cached->Clear();
+    NS_TEST_EXPECT_MSG_EQ(cached->GetNEntries(), 0, "The cache should be empty");
+    NS_TEST_EXPECT_MSG_EQ(cached->GetHitRate(), 0, "The statistics should be reset");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup propagation-tests
  *
@@ -501,6 +739,8 @@ RangePropagationLossModelTestCase::DoRun()
  *   - LogDistancePropagationLossModel
  *   - MatrixPropagationLossModel
  *   - RangePropagationLossModel
+ *   - the maximum range of the models
+ *   - CachedPropagationLossModel
  */
 class PropagationLossModelsTestSuite : public TestSuite
 {
@@ -516,6 +756,8 @@ PropagationLossModelsTestSuite::PropagationLossModelsTestSuite()
     AddTestCase(new LogDistancePropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new MatrixPropagationLossModelTestCase, TestCase::QUICK);
     AddTestCase(new RangePropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new MaxRangePropagationLossModelTestCase, TestCase::QUICK);
+    AddTestCase(new CachedPropagationLossModelTestCase, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
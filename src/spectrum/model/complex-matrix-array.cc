@@ -0,0 +1,93 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "complex-matrix-array.h"
+
+namespace ns3
+{
+
+ComplexMatrixArray::ComplexMatrixArray()
+    : m_numRows(0),
+      m_numCols(0),
+      m_numPages(0)
+{
+}
+
+ComplexMatrixArray::ComplexMatrixArray(std::size_t numRows,
+                                       std::size_t numCols,
+                                       std::size_t numPages)
+    : m_numRows(numRows),
+      m_numCols(numCols),
+      m_numPages(numPages),
+      m_values(numRows * numCols * numPages)
+{
+}
+
+PhasedArrayModel::ComplexVector
+ComplexMatrixArray::ComputeBilinearForms(const PhasedArrayModel::ComplexVector& left,
+                                         const PhasedArrayModel::ComplexVector& right) const
+{
+    NS_ASSERT_MSG(left.size() == m_numRows, "The left vector must have an element per row");
+    NS_ASSERT_MSG(right.size() == m_numCols, "The right vector must have an element per column");
+
+    PhasedArrayModel::ComplexVector result(m_numPages);
+    for (std::size_t page = 0; page < m_numPages; page++)
+    {
+        // the columns of a matrix are contiguous: compute the product of the
+        // left vector with each column, then with the right vector
+        const std::complex<double>* column = GetPagePtr(page);
+        std::complex<double> sum(0, 0);
+        for (std::size_t col = 0; col < m_numCols; col++)
+        {
+            sum += right[col] * DotProduct(left.data(), column, m_numRows);
+            column += m_numRows;
+        }
+        result[page] = sum;
+    }
+    return result;
+}
+
+std::complex<double>
+ComplexMatrixArray::DotProduct(const std::complex<double>* x,
+                               const std::complex<double>* y,
+                               std::size_t n)
+{
+    // std::complex<double> is laid out as an array of its real and imaginary
+    // parts. Four independent partial sums are accumulated, so that the
+    // additions of consecutive elements do not wait for each other.
+    const double* a = reinterpret_cast<const double*>(x);
+    const double* b = reinterpret_cast<const double*>(y);
+    double real[4] = {0, 0, 0, 0};
+    double imag[4] = {0, 0, 0, 0};
+    std::size_t i = 0;
+    for (; i + 8 <= 2 * n; i += 8)
+    {
+        for (std::size_t j = 0; j < 4; j++)
+        {
+            const double* aj = a + i + 2 * j;
+            const double* bj = b + i + 2 * j;
+            real[j] += aj[0] * bj[0] - aj[1] * bj[1];
+            imag[j] += aj[0] * bj[1] + aj[1] * bj[0];
+        }
+    }
+    for (; i < 2 * n; i += 2)
+    {
+        real[0] += a[i] * b[i] - a[i + 1] * b[i + 1];
+        imag[0] += a[i] * b[i + 1] + a[i + 1] * b[i];
+    }
+    return {(real[0] + real[1]) + (real[2] + real[3]), (imag[0] + imag[1]) + (imag[2] + imag[3])};
+}
+
+} // namespace ns3
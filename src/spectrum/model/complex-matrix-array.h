@@ -0,0 +1,204 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+#ifndef COMPLEX_MATRIX_ARRAY_H
+#define COMPLEX_MATRIX_ARRAY_H
+
+#include "ns3/assert.h"
+#include "ns3/phased-array-model.h"
+
+#include <complex>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup spectrum
+ *
+ * \brief An array of complex matrices of the same size, stored in a single
+ * contiguous block of memory.
+ *
+ * The array is a 3D tensor of numRows x numCols x numPages elements: each
+ * page is a numRows x numCols matrix, stored in column-major order, and the
+ * pages are stored one after the other. The element (row, col, page) is
+ * hence located at index row + numRows * (col + numCols * page).
+ *
+ * The channel matrices of the MatrixBasedChannelModel are arrays with a
+ * page per cluster, in which the rows are the elements of the receiving
+ * antenna array and the columns the elements of the transmitting one: the
+ * coefficients of a cluster are contiguous, and so are those of a column.
+ */
+class ComplexMatrixArray
+{
+  public:
+    /**
+     * Create an empty array.
+     */
+    ComplexMatrixArray();
+
+    /**
+     * Create an array of matrices whose elements are zero.
+     *
+     * \param numRows the number of rows of the matrices
+     * \param numCols the number of columns of the matrices
+     * \param numPages the number of matrices
+     */
+    ComplexMatrixArray(std::size_t numRows, std::size_t numCols, std::size_t numPages);
+
+    /**
+     * \return the number of rows of the matrices
+     */
+    std::size_t GetNumRows() const;
+    /**
+     * \return the number of columns of the matrices
+     */
+    std::size_t GetNumCols() const;
+    /**
+     * \return the number of matrices
+     */
+    std::size_t GetNumPages() const;
+    /**
+     * \return the total number of elements of the array
+     */
+    std::size_t GetSize() const;
+
+    /**
+     * Access an element of the array.
+     *
+     * \param row the row of the element
+     * \param col the column of the element
+     * \param page the matrix of the element
+     * \return a reference to the element
+     */
+    std::complex<double>& operator()(std::size_t row, std::size_t col, std::size_t page);
+    /**
+     * Access an element of the array.
+     *
+     * \param row the row of the element
+     * \param col the column of the element
+     * \param page the matrix of the element
+     * \return a const reference to the element
+     */
+    const std::complex<double>& operator()(std::size_t row,
+                                           std::size_t col,
+                                           std::size_t page) const;
+
+    /**
+     * \param page the matrix
+     * \return a pointer to the first element of the matrix
+     */
+    std::complex<double>* GetPagePtr(std::size_t page);
+    /**
+     * \param page the matrix
+     * \return a const pointer to the first element of the matrix
+     */
+    const std::complex<double>* GetPagePtr(std::size_t page) const;
+
+    /**
+     * Compute, for each matrix H of the array, the product l^T H r of the
+     * matrix with a vector on each side (the vectors are not conjugated).
+     *
+     * \param left the vector l, with an element per row
+     * \param right the vector r, with an element per column
+     * \return the products, with an element per matrix
+     */
+    PhasedArrayModel::ComplexVector ComputeBilinearForms(
+        const PhasedArrayModel::ComplexVector& left,
+        const PhasedArrayModel::ComplexVector& right) const;
+
+    /**
+     * Compute the sum of the products of the elements of two arrays of
+     * complex numbers (the elements are not conjugated). The real and
+     * imaginary parts are computed without the checks for infinite and NaN
+     * values of std::complex multiplications, so that the loop can be
+     * vectorized.
+     *
+     * \param x the first array
+     * \param y the second array
+     * \param n the number of elements of the arrays
+     * \return the sum of x[i] * y[i]
+     */
+    static std::complex<double> DotProduct(const std::complex<double>* x,
+                                           const std::complex<double>* y,
+                                           std::size_t n);
+
+  private:
+    std::size_t m_numRows;                      //!< Number of rows of the matrices
+    std::size_t m_numCols;                      //!< Number of columns of the matrices
+    std::size_t m_numPages;                     //!< Number of matrices
+    std::vector<std::complex<double>> m_values; //!< The elements of the matrices
+};
+
+/********************************************************************
+ *  Implementation of the inline functions declared above.
+ ********************************************************************/
+
+inline std::size_t
+ComplexMatrixArray::GetNumRows() const
+{
+    return m_numRows;
+}
+
+inline std::size_t
+ComplexMatrixArray::GetNumCols() const
+{
+    return m_numCols;
+}
+
+inline std::size_t
+ComplexMatrixArray::GetNumPages() const
+{
+    return m_numPages;
+}
+
+inline std::size_t
+ComplexMatrixArray::GetSize() const
+{
+    return m_values.size();
+}
+
+inline std::complex<double>&
+ComplexMatrixArray::operator()(std::size_t row, std::size_t col, std::size_t page)
+{
+    NS_ASSERT_MSG(row < m_numRows && col < m_numCols && page < m_numPages,
+                  "Index (" << row << ", " << col << ", " << page << ") out of bounds");
+    return m_values[row + m_numRows * (col + m_numCols * page)];
+}
+
+inline const std::complex<double>&
+ComplexMatrixArray::operator()(std::size_t row, std::size_t col, std::size_t page) const
+{
+    NS_ASSERT_MSG(row < m_numRows && col < m_numCols && page < m_numPages,
+                  "Index (" << row << ", " << col << ", " << page << ") out of bounds");
+    return m_values[row + m_numRows * (col + m_numCols * page)];
+}
+
+inline std::complex<double>*
+ComplexMatrixArray::GetPagePtr(std::size_t page)
+{
+    NS_ASSERT_MSG(page < m_numPages, "Page " << page << " out of bounds");
+    return m_values.data() + m_numRows * m_numCols * page;
+}
+
+inline const std::complex<double>*
+ComplexMatrixArray::GetPagePtr(std::size_t page) const
+{
+    NS_ASSERT_MSG(page < m_numPages, "Page " << page << " out of bounds");
+    return m_values.data() + m_numRows * m_numCols * page;
+}
+
+} // namespace ns3
+
+#endif /* COMPLEX_MATRIX_ARRAY_H */
@@ -126,6 +126,11 @@ MultiModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
         if (phyIt != rxInfoIterator->second.m_rxPhys.end())
         {
             rxInfoIterator->second.m_rxPhys.erase(phyIt);
+            if (rxInfoIterator->second.m_spatialIndex)
+            {
+                // the receivers are indexed by position in the container
+                rxInfoIterator->second.m_spatialIndex->Clear();
+            }
             --m_numDevices;
             break; // there should be at most one entry
         }
@@ -266,7 +271,8 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
     NS_LOG_LOGIC("converter map first element: "
                  << txInfoIteratorerator->second.m_spectrumConverterMap.begin()->first);
 
-    for (RxSpectrumModelInfoMap_t::const_iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
+    std::vector<uint32_t> inRange;
+    for (RxSpectrumModelInfoMap_t::iterator rxInfoIterator = m_rxSpectrumModelInfoMap.begin();
          rxInfoIterator != m_rxSpectrumModelInfoMap.end();
          ++rxInfoIterator)
     {
@@ -293,10 +299,15 @@ MultiModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
             convertedTxPowerSpectrum = rxConverterIterator->second.Convert(txParams->psd);
         }
 
-        for (auto rxPhyIterator = rxInfoIterator->second.m_rxPhys.begin();
-             rxPhyIterator != rxInfoIterator->second.m_rxPhys.end();
-             ++rxPhyIterator)
+        const auto& rxPhys = rxInfoIterator->second.m_rxPhys;
+        bool culled = FindRxPhysInRange(rxInfoIterator->second.m_spatialIndex,
+                                        rxPhys,
+                                        txMobility,
+                                        inRange);
+        std::size_t nRx = culled ? inRange.size() : rxPhys.size();
+        for (std::size_t k = 0; k < nRx; ++k)
         {
+            auto rxPhyIterator = rxPhys.cbegin() + (culled ? inRange[k] : k);
             NS_ASSERT_MSG((*rxPhyIterator)->GetRxSpectrumModel()->GetUid() == rxSpectrumModelUid,
                           "SpectrumModel change was not notified to MultiModelSpectrumChannel "
                           "(i.e., AddRx should be called again after model is changed)");
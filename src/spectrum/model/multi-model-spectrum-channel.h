@@ -79,6 +79,7 @@ class RxSpectrumModelInfo
 
     Ptr<const SpectrumModel> m_rxSpectrumModel; //!< Rx Spectrum model.
     std::vector<Ptr<SpectrumPhy>> m_rxPhys;     //!< Container of the Rx Spectrum phy objects.
+    Ptr<SpatialGridIndex> m_spatialIndex;       //!< Index of the Rx phy objects by position.
 };
 
 /**
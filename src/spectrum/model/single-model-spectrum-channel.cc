@@ -55,6 +55,7 @@ SingleModelSpectrumChannel::DoDispose()
 {
     NS_LOG_FUNCTION(this);
     m_phyList.clear();
+    m_spatialIndex = nullptr;
     m_spectrumModel = nullptr;
     SpectrumChannel::DoDispose();
 }
@@ -78,6 +79,11 @@ SingleModelSpectrumChannel::RemoveRx(Ptr<SpectrumPhy> phy)
     if (it != std::end(m_phyList))
     {
         m_phyList.erase(it);
+        if (m_spatialIndex)
+        {
+            // the receivers are indexed by position in the list
+            m_spatialIndex->Clear();
+        }
     }
 }
 
@@ -115,10 +121,12 @@ SingleModelSpectrumChannel::StartTx(Ptr<SpectrumSignalParameters> txParams)
 
     Ptr<MobilityModel> senderMobility = txParams->txPhy->GetMobility();
 
-    for (PhyList::const_iterator rxPhyIterator = m_phyList.begin();
-         rxPhyIterator != m_phyList.end();
-         ++rxPhyIterator)
+    std::vector<uint32_t> inRange;
+    bool culled = FindRxPhysInRange(m_spatialIndex, m_phyList, senderMobility, inRange);
+    std::size_t nRx = culled ? inRange.size() : m_phyList.size();
+    for (std::size_t k = 0; k < nRx; ++k)
     {
+        auto rxPhyIterator = m_phyList.cbegin() + (culled ? inRange[k] : k);
         Ptr<NetDevice> rxNetDevice = (*rxPhyIterator)->GetDevice();
         Ptr<NetDevice> txNetDevice = txParams->txPhy->GetDevice();
 
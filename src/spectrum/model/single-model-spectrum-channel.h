@@ -74,6 +74,11 @@ class SingleModelSpectrumChannel : public SpectrumChannel
      */
     PhyList m_phyList;
 
+    /**
+     * Index of the SpectrumPhy instances by position, if enabled.
+     */
+    Ptr<SpatialGridIndex> m_spatialIndex;
+
     /**
      * SpectrumModel that this channel instance is supporting.
      */
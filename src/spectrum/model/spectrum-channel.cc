@@ -20,10 +20,14 @@
 
 #include "spectrum-channel.h"
 
+#include <ns3/boolean.h>
 #include <ns3/double.h>
 #include <ns3/log.h>
 #include <ns3/pointer.h>
 
+#include <algorithm>
+#include <cmath>
+
 namespace ns3
 {
 
@@ -71,6 +75,25 @@ SpectrumChannel::GetTypeId()
                           MakeDoubleAccessor(&SpectrumChannel::m_maxLossDb),
                           MakeDoubleChecker<double>())
 
+            .AddAttribute("EnableSpatialIndex",
+                          "If true, the receivers are indexed by position, and the "
+                          "transmissions are only passed to the receivers located "
+                          "within the maximum range of the PropagationLossModel "
+                          "for a loss of MaxLossDb plus MaxAntennaGain. This reduces "
+                          "the computational load when MaxLossDb is set and the "
+                          "PropagationLossModel can bound its range.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&SpectrumChannel::m_spatialIndexEnabled),
+                          MakeBooleanChecker())
+
+            .AddAttribute("MaxAntennaGain",
+                          "The maximum sum of the TX and RX antenna gains in dB, "
+                          "used to find the receivers within range when the spatial "
+                          "index is enabled.",
+                          DoubleValue(0.0),
+                          MakeDoubleAccessor(&SpectrumChannel::m_maxAntennaGainDb),
+                          MakeDoubleChecker<double>())
+
             .AddAttribute("PropagationLossModel",
                           "A pointer to the propagation loss model attached to this channel.",
                           PointerValue(nullptr),
@@ -113,6 +136,40 @@ SpectrumChannel::GetTypeId()
     return tid;
 }
 
+bool
+SpectrumChannel::FindRxPhysInRange(Ptr<SpatialGridIndex>& index,
+                                   const std::vector<Ptr<SpectrumPhy>>& rxPhys,
+                                   Ptr<const MobilityModel> txMobility,
+                                   std::vector<uint32_t>& ids) const
+{
+    NS_LOG_FUNCTION(this << txMobility);
+    if (!m_spatialIndexEnabled || !m_propagationLoss || !txMobility)
+    {
+        return false;
+    }
+    // the propagation gain is computed for a power of 0 dBm
+    double range = m_propagationLoss->GetMaxRange(0, -m_maxLossDb - m_maxAntennaGainDb);
+    if (std::isinf(range))
+    {
+        return false;
+    }
+    if (!index)
+    {
+        index = CreateObject<SpatialGridIndex>();
+    }
+    // the mobility model of a receiver may not be known when it is added to the channel
+    for (auto id = static_cast<uint32_t>(index->GetN()); id < rxPhys.size(); id++)
+    {
+        index->Add(id, rxPhys[id]->GetMobility());
+    }
+    index->GetNeighbors(txMobility->GetPosition(), range, ids);
+    NS_LOG_LOGIC("range=" << range << "m, " << ids.size() << " receivers out of "
+                          << rxPhys.size());
+    // keep the order of the receivers, as without the index
+    std::sort(ids.begin(), ids.end());
+    return true;
+}
+
 void
 SpectrumChannel::AddPropagationLossModel(Ptr<PropagationLossModel> loss)
 {
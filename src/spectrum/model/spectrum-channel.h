@@ -28,6 +28,7 @@
 #include <ns3/phased-array-spectrum-propagation-loss-model.h>
 #include <ns3/propagation-delay-model.h>
 #include <ns3/propagation-loss-model.h>
+#include <ns3/spatial-grid-index.h>
 #include <ns3/spectrum-phy.h>
 #include <ns3/spectrum-propagation-loss-model.h>
 #include <ns3/spectrum-signal-parameters.h>
@@ -188,6 +189,25 @@ class SpectrumChannel : public Channel
     typedef void (*SignalParametersTracedCallback)(Ptr<SpectrumSignalParameters> params);
 
   protected:
+    /**
+     * Find the receivers which may be within range of a transmitter, i.e.,
+     * for which the loss of the propagation loss model may not exceed
+     * MaxLossDb plus MaxAntennaGain, if the spatial index is enabled.
+     *
+     * \param index the spatial index of the receivers, which is created if
+     *        needed and completed with the receivers not indexed yet
+     * \param rxPhys the receivers
+     * \param txMobility the mobility model of the transmitter
+     * \param [out] ids the positions in rxPhys of the receivers which may be
+     *        within range, sorted
+     * \return false if all the receivers are to be considered, in which case
+     *         ids is not set
+     */
+    bool FindRxPhysInRange(Ptr<SpatialGridIndex>& index,
+                           const std::vector<Ptr<SpectrumPhy>>& rxPhys,
+                           Ptr<const MobilityModel> txMobility,
+                           std::vector<uint32_t>& ids) const;
+
     /**
      * The `PathLoss` trace source. Exporting the pointers to the Tx and Rx
      * SpectrumPhy and a pathloss value, in dB.
@@ -219,6 +239,17 @@ class SpectrumChannel : public Channel
      */
     double m_maxLossDb;
 
+    /**
+     * Whether to index the receivers by position.
+     */
+    bool m_spatialIndexEnabled;
+
+    /**
+     * Maximum sum of the TX and RX antenna gains [dB] considered to find the
+     * receivers in range with the spatial index.
+     */
+    double m_maxAntennaGainDb;
+
     /**
      * Single-frequency propagation loss model to be used with this channel.
      */
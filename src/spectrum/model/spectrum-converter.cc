@@ -40,7 +40,10 @@ SpectrumConverter::SpectrumConverter(Ptr<const SpectrumModel> fromSpectrumModel,
     m_fromSpectrumModel = fromSpectrumModel;
     m_toSpectrumModel = toSpectrumModel;
 
+    m_columnRowsBegin.assign(fromSpectrumModel->GetNumBands(), 0);
+    m_columnRowsEnd.assign(fromSpectrumModel->GetNumBands(), 0);
     size_t rowPtr = 0;
+    size_t rowInd = 0;
     for (Bands::const_iterator toit = toSpectrumModel->Begin(); toit != toSpectrumModel->End();
          ++toit)
     {
@@ -59,10 +62,16 @@ SpectrumConverter::SpectrumConverter(Ptr<const SpectrumModel> fromSpectrumModel,
                 m_conversionMatrix.push_back(c);
                 m_conversionColInd.push_back(colInd);
                 rowPtr++;
+                if (m_columnRowsBegin[colInd] == m_columnRowsEnd[colInd])
+                {
+                    m_columnRowsBegin[colInd] = rowInd;
+                }
+                m_columnRowsEnd[colInd] = rowInd + 1;
             }
             colInd++;
         }
         m_conversionRowPtr.push_back(rowPtr);
+        rowInd++;
     }
 }
 
@@ -83,22 +92,36 @@ SpectrumConverter::Convert(Ptr<const SpectrumValue> fvvf) const
 
     Ptr<SpectrumValue> tvvf = Create<SpectrumValue>(m_toSpectrumModel);
 
-    Values::iterator tvit = tvvf->ValuesBegin();
-    size_t i = 0; // Index of conversion coefficient
+    // only the rows with a non-zero coefficient in an occupied column can be non-zero
+    size_t rowBegin = m_conversionRowPtr.size();
+    size_t rowEnd = 0;
+    for (size_t col = fvvf->m_occupiedBegin; col < fvvf->m_occupiedEnd; col++)
+    {
+        if (m_columnRowsBegin[col] < m_columnRowsEnd[col])
+        {
+            rowBegin = std::min(rowBegin, m_columnRowsBegin[col]);
+            rowEnd = std::max(rowEnd, m_columnRowsEnd[col]);
+        }
+    }
+    if (rowBegin >= rowEnd)
+    {
+        return tvvf;
+    }
 
-    for (std::vector<size_t>::const_iterator convIt = m_conversionRowPtr.begin();
-         convIt != m_conversionRowPtr.end();
-         ++convIt)
+    // Index of conversion coefficient
+    size_t i = (rowBegin > 0) ? m_conversionRowPtr[rowBegin - 1] : 0;
+    for (size_t row = rowBegin; row < rowEnd; row++)
     {
         double sum = 0;
-        while (i < *convIt)
+        while (i < m_conversionRowPtr[row])
         {
-            sum += (*fvvf)[m_conversionColInd.at(i)] * m_conversionMatrix.at(i);
+            sum += fvvf->m_values[m_conversionColInd[i]] * m_conversionMatrix[i];
             i++;
         }
-        *tvit = sum;
-        ++tvit;
+        tvvf->m_values[row] = sum;
     }
+    tvvf->m_occupiedBegin = rowBegin;
+    tvvf->m_occupiedEnd = rowEnd;
 
     return tvvf;
 }
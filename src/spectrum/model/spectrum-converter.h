@@ -81,6 +81,9 @@ class SpectrumConverter : public SimpleRefCount<SpectrumConverter>
     std::vector<size_t> m_conversionRowPtr; //!< offset of rows in m_conversionMatrix
     std::vector<size_t>
         m_conversionColInd; //!< column of each non-zero element in m_conversionMatrix
+    std::vector<size_t> m_columnRowsBegin; //!< first row with a non-zero element in each column
+    std::vector<size_t> m_columnRowsEnd;   //!< row following the last one with a non-zero
+                                           //!< element in each column
 
     Ptr<const SpectrumModel> m_fromSpectrumModel; //!<  the SpectrumModel this SpectrumConverter
                                                   //!<  instance can convert from
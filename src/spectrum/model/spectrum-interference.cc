@@ -127,10 +127,15 @@ SpectrumInterference::ConditionallyEvaluateChunk()
     NS_LOG_LOGIC("if condition: " << condition);
     if (condition)
     {
-        SpectrumValue sinr = (*m_rxSignal) / ((*m_allSignals) - (*m_rxSignal) + (*m_noise));
+        // rx / (all - rx + noise), reusing the storage of the previous chunks
+        m_interference = *m_allSignals;
+        m_interference -= *m_rxSignal;
+        m_interference += *m_noise;
+        m_sinr = *m_rxSignal;
+        m_sinr /= m_interference;
         Time duration = Now() - m_lastChangeTime;
         NS_LOG_LOGIC("calling m_errorModel->EvaluateChunk (sinr, duration)");
-        m_errorModel->EvaluateChunk(sinr, duration);
+        m_errorModel->EvaluateChunk(m_sinr, duration);
     }
 }
 
@@ -135,6 +135,9 @@ class SpectrumInterference : public Object
 
     Ptr<const SpectrumValue> m_noise; //!< Noise spectral power density
 
+    SpectrumValue m_interference; //!< Interference plus noise of the last chunk
+    SpectrumValue m_sinr;         //!< SINR of the last chunk
+
     Time m_lastChangeTime; //!< the time of the last change in m_TotalPower
 
     Ptr<SpectrumErrorModel> m_errorModel; //!< Error model
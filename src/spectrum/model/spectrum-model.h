@@ -133,6 +133,13 @@ class SpectrumModel : public SimpleRefCount<SpectrumModel>
      */
     Bands::const_iterator End() const;
 
+    /**
+     * Get the widths of the bands, i.e., fh - fl, in the order of the bands.
+     *
+     * @return a reference to the vector of the widths of the bands
+     */
+    const std::vector<double>& GetBandWidths() const;
+
     /**
      * Check if another SpectrumModels has bands orthogonal to our bands.
      *
@@ -142,7 +149,13 @@ class SpectrumModel : public SimpleRefCount<SpectrumModel>
     bool IsOrthogonal(const SpectrumModel& other) const;
 
   private:
+    /**
+     * Compute the widths of the bands
+     */
+    void SetBandWidths();
+
     Bands m_bands;            //!< Actual definition of frequency bands within this SpectrumModel
+    std::vector<double> m_bandWidths; //!< Widths of the bands
     SpectrumModelUid_t m_uid; //!< unique id for a given set of frequencies
     static SpectrumModelUid_t m_uidCount; //!< counter to assign m_uids
 };
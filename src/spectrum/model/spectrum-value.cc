@@ -23,24 +23,359 @@
 #include <ns3/math.h>
 #include <ns3/spectrum-value.h>
 
+#include <algorithm>
+
+#if defined(__x86_64__) && (defined(__GNUC__) || defined(__clang__))
+#define SPECTRUM_VALUE_AVX2
+#include <immintrin.h>
+#endif
+
 namespace ns3
 {
 
 NS_LOG_COMPONENT_DEFINE("SpectrumValue");
 
+namespace
+{
+
+/// Element-wise operations of the kernels
+enum class Operation
+{
+    ADD,
+    SUBTRACT,
+    MULTIPLY,
+    DIVIDE
+};
+
+/// Whether the SIMD kernels may be used
+bool g_simdEnabled = true;
+
+/**
+ * \return true if the CPU supports the AVX2 instructions
+ */
+bool
+CpuSupportsAvx2()
+{
+#ifdef SPECTRUM_VALUE_AVX2
+    static const bool avx2 = (__builtin_cpu_init(), __builtin_cpu_supports("avx2"));
+    return avx2;
+#else
+    return false;
+#endif
+}
+
+/**
+ * \return true if the AVX2 kernels are to be used
+ */
+inline bool
+UseAvx2()
+{
+    return g_simdEnabled && CpuSupportsAvx2();
+}
+
+/**
+ * Apply an operation to one element
+ *
+ * \tparam OP the operation
+ * \param x the element, updated with the result
+ * \param y the second operand
+ */
+template <Operation OP>
+inline void
+ApplyOne(double& x, double y)
+{
+    if constexpr (OP == Operation::ADD)
+    {
+        x += y;
+    }
+    else if constexpr (OP == Operation::SUBTRACT)
+    {
+        x -= y;
+    }
+    else if constexpr (OP == Operation::MULTIPLY)
+    {
+        x *= y;
+    }
+    else
+    {
+        x /= y;
+    }
+}
+
+#ifdef SPECTRUM_VALUE_AVX2
+/**
+ * Apply an operation to four elements
+ *
+ * \tparam OP the operation
+ * \param x the elements
+ * \param y the second operands
+ * \return the results
+ */
+template <Operation OP>
+__attribute__((target("avx2"))) inline __m256d
+ApplyAvx2(__m256d x, __m256d y)
+{
+    if constexpr (OP == Operation::ADD)
+    {
+        return _mm256_add_pd(x, y);
+    }
+    else if constexpr (OP == Operation::SUBTRACT)
+    {
+        return _mm256_sub_pd(x, y);
+    }
+    else if constexpr (OP == Operation::MULTIPLY)
+    {
+        return _mm256_mul_pd(x, y);
+    }
+    else
+    {
+        return _mm256_div_pd(x, y);
+    }
+}
+
+/**
+ * x[i] = x[i] OP y[i], with AVX2
+ *
+ * \tparam OP the operation
+ * \param x the first operands, updated with the results
+ * \param y the second operands
+ * \param n the number of elements
+ */
+template <Operation OP>
+__attribute__((target("avx2"))) void
+ApplyVectorAvx2(double* x, const double* y, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(x + i,
+                         ApplyAvx2<OP>(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i)));
+    }
+    for (; i < n; i++)
+    {
+        ApplyOne<OP>(x[i], y[i]);
+    }
+}
+
+/**
+ * x[i] = x[i] OP s, with AVX2
+ *
+ * \tparam OP the operation
+ * \param x the first operands, updated with the results
+ * \param s the second operand
+ * \param n the number of elements
+ */
+template <Operation OP>
+__attribute__((target("avx2"))) void
+ApplyScalarAvx2(double* x, double s, std::size_t n)
+{
+    __m256d vs = _mm256_set1_pd(s);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        _mm256_storeu_pd(x + i, ApplyAvx2<OP>(_mm256_loadu_pd(x + i), vs));
+    }
+    for (; i < n; i++)
+    {
+        ApplyOne<OP>(x[i], s);
+    }
+}
+
+/**
+ * x[i] += y[i] * z[i], with AVX2. The product and the sum are rounded
+ * separately, as with the scalar implementation.
+ *
+ * \param x the accumulators
+ * \param y the first factors
+ * \param z the second factors
+ * \param n the number of elements
+ */
+__attribute__((target("avx2"))) void
+MultiplyAddAvx2(double* x, const double* y, const double* z, std::size_t n)
+{
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d product = _mm256_mul_pd(_mm256_loadu_pd(y + i), _mm256_loadu_pd(z + i));
+        _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i), product));
+    }
+    for (; i < n; i++)
+    {
+        double product = y[i] * z[i];
+        x[i] += product;
+    }
+}
+
+/**
+ * x[i] += y[i] * s, with AVX2
+ *
+ * \param x the accumulators
+ * \param y the first factors
+ * \param s the second factor
+ * \param n the number of elements
+ */
+__attribute__((target("avx2"))) void
+MultiplyAddAvx2(double* x, const double* y, double s, std::size_t n)
+{
+    __m256d vs = _mm256_set1_pd(s);
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d product = _mm256_mul_pd(_mm256_loadu_pd(y + i), vs);
+        _mm256_storeu_pd(x + i, _mm256_add_pd(_mm256_loadu_pd(x + i), product));
+    }
+    for (; i < n; i++)
+    {
+        double product = y[i] * s;
+        x[i] += product;
+    }
+}
+
+/**
+ * Sum of x[i] * y[i] (* w[i] if w is not null), with AVX2. The sum is
+ * accumulated in four lanes, added together at the end.
+ *
+ * \param x the first factors
+ * \param y the second factors
+ * \param w the third factors, or nullptr
+ * \param n the number of elements
+ * \return the sum of the products
+ */
+__attribute__((target("avx2"))) double
+DotAvx2(const double* x, const double* y, const double* w, std::size_t n)
+{
+    __m256d sum = _mm256_setzero_pd();
+    std::size_t i = 0;
+    for (; i + 4 <= n; i += 4)
+    {
+        __m256d product = _mm256_mul_pd(_mm256_loadu_pd(x + i), _mm256_loadu_pd(y + i));
+        if (w)
+        {
+            product = _mm256_mul_pd(product, _mm256_loadu_pd(w + i));
+        }
+        sum = _mm256_add_pd(sum, product);
+    }
+    alignas(32) double lanes[4];
+    _mm256_store_pd(lanes, sum);
+    double result = (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+    for (; i < n; i++)
+    {
+        result += w ? x[i] * y[i] * w[i] : x[i] * y[i];
+    }
+    return result;
+}
+#endif
+
+/**
+ * x[i] = x[i] OP y[i]
+ *
+ * \tparam OP the operation
+ * \param x the first operands, updated with the results
+ * \param y the second operands
+ * \param n the number of elements
+ */
+template <Operation OP>
+void
+ApplyVector(double* x, const double* y, std::size_t n)
+{
+#ifdef SPECTRUM_VALUE_AVX2
+    if (UseAvx2())
+    {
+        ApplyVectorAvx2<OP>(x, y, n);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < n; i++)
+    {
+        ApplyOne<OP>(x[i], y[i]);
+    }
+}
+
+/**
+ * x[i] = x[i] OP s
+ *
+ * \tparam OP the operation
+ * \param x the first operands, updated with the results
+ * \param s the second operand
+ * \param n the number of elements
+ */
+template <Operation OP>
+void
+ApplyScalar(double* x, double s, std::size_t n)
+{
+#ifdef SPECTRUM_VALUE_AVX2
+    if (UseAvx2())
+    {
+        ApplyScalarAvx2<OP>(x, s, n);
+        return;
+    }
+#endif
+    for (std::size_t i = 0; i < n; i++)
+    {
+        ApplyOne<OP>(x[i], s);
+    }
+}
+
+/**
+ * Sum of x[i] * y[i] (* w[i] if w is not null)
+ *
+ * \param x the first factors
+ * \param y the second factors
+ * \param w the third factors, or nullptr
+ * \param n the number of elements
+ * \return the sum of the products
+ */
+double
+Dot(const double* x, const double* y, const double* w, std::size_t n)
+{
+#ifdef SPECTRUM_VALUE_AVX2
+    if (UseAvx2())
+    {
+        return DotAvx2(x, y, w, n);
+    }
+#endif
+    double result = 0;
+    for (std::size_t i = 0; i < n; i++)
+    {
+        result += w ? x[i] * y[i] * w[i] : x[i] * y[i];
+    }
+    return result;
+}
+
+} // namespace
+
+void
+SpectrumValue::EnableSimd(bool enable)
+{
+    NS_LOG_FUNCTION(enable);
+    g_simdEnabled = enable;
+}
+
+bool
+SpectrumValue::IsSimdEnabled()
+{
+    return UseAvx2();
+}
+
 SpectrumValue::SpectrumValue()
+    : m_occupiedBegin(0),
+      m_occupiedEnd(0)
 {
 }
 
 SpectrumValue::SpectrumValue(Ptr<const SpectrumModel> sof)
     : m_spectrumModel(sof),
-      m_values(sof->GetNumBands())
+      m_values(sof->GetNumBands()),
+      m_occupiedBegin(0),
+      m_occupiedEnd(0)
 {
 }
 
 double&
 SpectrumValue::operator[](size_t index)
 {
+    // the value may be written
+    SetAllOccupied();
     return m_values.at(index);
 }
 
@@ -77,15 +412,72 @@ SpectrumValue::ConstValuesEnd() const
 Values::iterator
 SpectrumValue::ValuesBegin()
 {
+    // the values may be written
+    SetAllOccupied();
     return m_values.begin();
 }
 
 Values::iterator
 SpectrumValue::ValuesEnd()
 {
+    SetAllOccupied();
     return m_values.end();
 }
 
+std::size_t
+SpectrumValue::GetOccupiedBandsBegin() const
+{
+    return m_occupiedBegin;
+}
+
+std::size_t
+SpectrumValue::GetOccupiedBandsEnd() const
+{
+    return m_occupiedEnd;
+}
+
+void
+SpectrumValue::ShrinkOccupiedBands()
+{
+    while (m_occupiedBegin < m_occupiedEnd && m_values[m_occupiedBegin] == 0)
+    {
+        m_occupiedBegin++;
+    }
+    while (m_occupiedEnd > m_occupiedBegin && m_values[m_occupiedEnd - 1] == 0)
+    {
+        m_occupiedEnd--;
+    }
+    if (m_occupiedBegin == m_occupiedEnd)
+    {
+        m_occupiedBegin = 0;
+        m_occupiedEnd = 0;
+    }
+}
+
+void
+SpectrumValue::SetAllOccupied()
+{
+    m_occupiedBegin = 0;
+    m_occupiedEnd = m_values.size();
+}
+
+void
+SpectrumValue::AddOccupiedBands(std::size_t begin, std::size_t end)
+{
+    if (begin >= end)
+    {
+        return;
+    }
+    if (m_occupiedBegin == m_occupiedEnd)
+    {
+        m_occupiedBegin = begin;
+        m_occupiedEnd = end;
+        return;
+    }
+    m_occupiedBegin = std::min(m_occupiedBegin, begin);
+    m_occupiedEnd = std::max(m_occupiedEnd, end);
+}
+
 Bands::const_iterator
 SpectrumValue::ConstBandsBegin() const
 {
@@ -101,47 +493,37 @@ SpectrumValue::ConstBandsEnd() const
 void
 SpectrumValue::Add(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 += *it2;
-        ++it1;
-        ++it2;
-    }
+    // adding zero leaves the other bands unchanged
+    std::size_t begin = x.m_occupiedBegin;
+    ApplyVector<Operation::ADD>(m_values.data() + begin,
+                                x.m_values.data() + begin,
+                                x.m_occupiedEnd - begin);
+    AddOccupiedBands(begin, x.m_occupiedEnd);
 }
 
 void
 SpectrumValue::Add(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
+    if (s == 0)
     {
-        *it1 += s;
-        ++it1;
+        return;
     }
+    SetAllOccupied();
+    ApplyScalar<Operation::ADD>(m_values.data(), s, m_values.size());
 }
 
 void
 SpectrumValue::Subtract(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 -= *it2;
-        ++it1;
-        ++it2;
-    }
+    std::size_t begin = x.m_occupiedBegin;
+    ApplyVector<Operation::SUBTRACT>(m_values.data() + begin,
+                                     x.m_values.data() + begin,
+                                     x.m_occupiedEnd - begin);
+    AddOccupiedBands(begin, x.m_occupiedEnd);
 }
 
 void
@@ -153,77 +535,69 @@ SpectrumValue::Subtract(double s)
 void
 SpectrumValue::Multiply(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
+    // the product is zero out of the bands occupied by both
+    std::size_t begin = std::max(m_occupiedBegin, x.m_occupiedBegin);
+    std::size_t end = std::min(m_occupiedEnd, x.m_occupiedEnd);
+    if (begin >= end)
     {
-        *it1 *= *it2;
-        ++it1;
-        ++it2;
+        std::fill(m_values.begin() + m_occupiedBegin, m_values.begin() + m_occupiedEnd, 0);
+        begin = 0;
+        end = 0;
     }
+    else
+    {
+        std::fill(m_values.begin() + m_occupiedBegin, m_values.begin() + begin, 0);
+        std::fill(m_values.begin() + end, m_values.begin() + m_occupiedEnd, 0);
+        ApplyVector<Operation::MULTIPLY>(m_values.data() + begin,
+                                         x.m_values.data() + begin,
+                                         end - begin);
+    }
+    m_occupiedBegin = begin;
+    m_occupiedEnd = end;
 }
 
 void
 SpectrumValue::Multiply(double s)
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 *= s;
-        ++it1;
-    }
+    ApplyScalar<Operation::MULTIPLY>(m_values.data() + m_occupiedBegin,
+                                     s,
+                                     m_occupiedEnd - m_occupiedBegin);
 }
 
 void
 SpectrumValue::Divide(const SpectrumValue& x)
 {
-    Values::iterator it1 = m_values.begin();
-    Values::const_iterator it2 = x.m_values.begin();
-
     NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
     NS_ASSERT(m_values.size() == x.m_values.size());
-
-    while (it1 != m_values.end())
-    {
-        *it1 /= *it2;
-        ++it1;
-        ++it2;
-    }
+    // zero divided by zero is not zero
+    SetAllOccupied();
+    ApplyVector<Operation::DIVIDE>(m_values.data(), x.m_values.data(), m_values.size());
 }
 
 void
 SpectrumValue::Divide(double s)
 {
     NS_LOG_FUNCTION(this << s);
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
-    {
-        *it1 /= s;
-        ++it1;
-    }
+    ApplyScalar<Operation::DIVIDE>(m_values.data() + m_occupiedBegin,
+                                   s,
+                                   m_occupiedEnd - m_occupiedBegin);
 }
 
 void
 SpectrumValue::ChangeSign()
 {
-    Values::iterator it1 = m_values.begin();
-
-    while (it1 != m_values.end())
+    for (std::size_t i = m_occupiedBegin; i < m_occupiedEnd; i++)
     {
-        *it1 = -(*it1);
-        ++it1;
+        m_values[i] = -m_values[i];
     }
 }
 
 void
 SpectrumValue::ShiftLeft(int n)
 {
+    SetAllOccupied();
     int i = 0;
     while (i < (int)m_values.size() - n)
     {
@@ -240,6 +614,7 @@ SpectrumValue::ShiftLeft(int n)
 void
 SpectrumValue::ShiftRight(int n)
 {
+    SetAllOccupied();
     int i = m_values.size() - 1;
     while (i - n >= 0)
     {
@@ -257,6 +632,8 @@ void
 SpectrumValue::Pow(double exp)
 {
     NS_LOG_FUNCTION(this << exp);
+    // the function of zero is not zero
+    SetAllOccupied();
     Values::iterator it1 = m_values.begin();
 
     while (it1 != m_values.end())
@@ -270,6 +647,8 @@ void
 SpectrumValue::Exp(double base)
 {
     NS_LOG_FUNCTION(this << base);
+    // the function of zero is not zero
+    SetAllOccupied();
     Values::iterator it1 = m_values.begin();
 
     while (it1 != m_values.end())
@@ -283,6 +662,8 @@ void
 SpectrumValue::Log10()
 {
     NS_LOG_FUNCTION(this);
+    // the function of zero is not zero
+    SetAllOccupied();
     Values::iterator it1 = m_values.begin();
 
     while (it1 != m_values.end())
@@ -296,6 +677,8 @@ void
 SpectrumValue::Log2()
 {
     NS_LOG_FUNCTION(this);
+    // the function of zero is not zero
+    SetAllOccupied();
     Values::iterator it1 = m_values.begin();
 
     while (it1 != m_values.end())
@@ -309,6 +692,8 @@ void
 SpectrumValue::Log()
 {
     NS_LOG_FUNCTION(this);
+    // the function of zero is not zero
+    SetAllOccupied();
     Values::iterator it1 = m_values.begin();
 
     while (it1 != m_values.end())
@@ -322,11 +707,9 @@ double
 Norm(const SpectrumValue& x)
 {
     double s = 0;
-    Values::const_iterator it1 = x.ConstValuesBegin();
-    while (it1 != x.ConstValuesEnd())
+    for (std::size_t i = x.m_occupiedBegin; i < x.m_occupiedEnd; i++)
     {
-        s += (*it1) * (*it1);
-        ++it1;
+        s += x.m_values[i] * x.m_values[i];
     }
     return std::sqrt(s);
 }
@@ -335,11 +718,9 @@ double
 Sum(const SpectrumValue& x)
 {
     double s = 0;
-    Values::const_iterator it1 = x.ConstValuesBegin();
-    while (it1 != x.ConstValuesEnd())
+    for (std::size_t i = x.m_occupiedBegin; i < x.m_occupiedEnd; i++)
     {
-        s += (*it1);
-        ++it1;
+        s += x.m_values[i];
     }
     return s;
 }
@@ -360,20 +741,42 @@ Prod(const SpectrumValue& x)
 double
 Integral(const SpectrumValue& arg)
 {
+    NS_ASSERT(arg.m_values.size() == arg.m_spectrumModel->GetNumBands());
     double i = 0;
-    Values::const_iterator vit = arg.ConstValuesBegin();
-    Bands::const_iterator bit = arg.ConstBandsBegin();
-    while (vit != arg.ConstValuesEnd())
+    Bands::const_iterator bit = arg.ConstBandsBegin() + arg.m_occupiedBegin;
+    for (std::size_t k = arg.m_occupiedBegin; k < arg.m_occupiedEnd; k++)
     {
-        NS_ASSERT(bit != arg.ConstBandsEnd());
-        i += (*vit) * (bit->fh - bit->fl);
-        ++vit;
+        i += arg.m_values[k] * (bit->fh - bit->fl);
         ++bit;
     }
-    NS_ASSERT(bit == arg.ConstBandsEnd());
     return i;
 }
 
+double
+SumOfProduct(const SpectrumValue& x, const SpectrumValue& y)
+{
+    NS_ASSERT(x.m_spectrumModel == y.m_spectrumModel);
+    NS_ASSERT(x.m_values.size() == y.m_values.size());
+    std::size_t begin = std::max(x.m_occupiedBegin, y.m_occupiedBegin);
+    std::size_t end = std::max(begin, std::min(x.m_occupiedEnd, y.m_occupiedEnd));
+    return Dot(x.m_values.data() + begin, y.m_values.data() + begin, nullptr, end - begin);
+}
+
+double
+IntegralOfProduct(const SpectrumValue& x, const SpectrumValue& y)
+{
+    NS_ASSERT(x.m_spectrumModel == y.m_spectrumModel);
+    NS_ASSERT(x.m_values.size() == y.m_values.size());
+    const std::vector<double>& widths = x.m_spectrumModel->GetBandWidths();
+    NS_ASSERT(widths.size() == x.m_values.size());
+    std::size_t begin = std::max(x.m_occupiedBegin, y.m_occupiedBegin);
+    std::size_t end = std::max(begin, std::min(x.m_occupiedEnd, y.m_occupiedEnd));
+    return Dot(x.m_values.data() + begin,
+               y.m_values.data() + begin,
+               widths.data() + begin,
+               end - begin);
+}
+
 Ptr<SpectrumValue>
 SpectrumValue::Copy() const
 {
@@ -613,12 +1016,68 @@ SpectrumValue::operator/=(double rhs)
 SpectrumValue&
 SpectrumValue::operator=(double rhs)
 {
-    Values::iterator it1 = m_values.begin();
+    std::fill(m_values.begin(), m_values.end(), rhs);
+    if (rhs == 0)
+    {
+        m_occupiedBegin = 0;
+        m_occupiedEnd = 0;
+    }
+    else
+    {
+        SetAllOccupied();
+    }
+    return *this;
+}
 
-    while (it1 != m_values.end())
+SpectrumValue&
+SpectrumValue::MultiplyAdd(const SpectrumValue& x, const SpectrumValue& y)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel && m_spectrumModel == y.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size() && m_values.size() == y.m_values.size());
+    // the product is zero out of the bands occupied by both factors
+    std::size_t begin = std::max(x.m_occupiedBegin, y.m_occupiedBegin);
+    std::size_t end = std::max(begin, std::min(x.m_occupiedEnd, y.m_occupiedEnd));
+    AddOccupiedBands(begin, end);
+    const double* a = x.m_values.data() + begin;
+    const double* b = y.m_values.data() + begin;
+    double* out = m_values.data() + begin;
+    std::size_t n = end - begin;
+#ifdef SPECTRUM_VALUE_AVX2
+    if (UseAvx2())
     {
-        *it1 = rhs;
-        ++it1;
+        MultiplyAddAvx2(out, a, b, n);
+        return *this;
+    }
+#endif
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double product = a[i] * b[i];
+        out[i] += product;
+    }
+    return *this;
+}
+
+SpectrumValue&
+SpectrumValue::MultiplyAdd(const SpectrumValue& x, double s)
+{
+    NS_ASSERT(m_spectrumModel == x.m_spectrumModel);
+    NS_ASSERT(m_values.size() == x.m_values.size());
+    std::size_t begin = x.m_occupiedBegin;
+    AddOccupiedBands(begin, x.m_occupiedEnd);
+    const double* a = x.m_values.data() + begin;
+    double* out = m_values.data() + begin;
+    std::size_t n = x.m_occupiedEnd - begin;
+#ifdef SPECTRUM_VALUE_AVX2
+    if (UseAvx2())
+    {
+        MultiplyAddAvx2(out, a, s, n);
+        return *this;
+    }
+#endif
+    for (std::size_t i = 0; i < n; i++)
+    {
+        double product = a[i] * s;
+        out[i] += product;
     }
     return *this;
 }
@@ -56,9 +56,20 @@ typedef std::vector<double> Values;
  * The intended use of this class is to represent frequency-dependent
  * things, such as power spectral densities, frequency-dependent
  * propagation losses, spectral masks, etc.
+ *
+ * A SpectrumValue records the range of its occupied bands, out of which
+ * its values are zero, so that the operations on narrowband signals
+ * defined over a wideband SpectrumModel only process the occupied bands.
+ * The range is widened to all the bands when the values are accessed
+ * through a non-const method (operator[], ValuesBegin, ValuesEnd), hence
+ * reading the values of a non-const SpectrumValue should be done through
+ * a const reference to keep it narrow.
  */
 class SpectrumValue : public SimpleRefCount<SpectrumValue>
 {
+    /// SpectrumConverter only computes the occupied bands of the values it converts
+    friend class SpectrumConverter;
+
   public:
     /**
      * @brief SpectrumValue constructor
@@ -153,6 +164,28 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     Values::iterator ValuesEnd();
 
+    /**
+     * Get the beginning of the range of the occupied bands. The values of
+     * the bands out of [GetOccupiedBandsBegin (), GetOccupiedBandsEnd ())
+     * are zero; the values of the occupied bands may be zero too.
+     *
+     * @return the index of the first occupied band
+     */
+    std::size_t GetOccupiedBandsBegin() const;
+
+    /**
+     * Get the end of the range of the occupied bands
+     *
+     * @return the index following the last occupied band
+     */
+    std::size_t GetOccupiedBandsEnd() const;
+
+    /**
+     * Restrict the range of the occupied bands to the first and the last
+     * bands whose value is not zero
+     */
+    void ShrinkOccupiedBands();
+
     /**
      * \brief Get the number of values stored in the array
      * \return the values array size
@@ -410,6 +443,43 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     SpectrumValue& operator=(double rhs);
 
+    /**
+     * Add the product of two SpectrumValues to *this, component by
+     * component, i.e., *this += x * y without a temporary SpectrumValue
+     *
+     * @param x the first factor
+     * @param y the second factor
+     *
+     * @return a reference to *this
+     */
+    SpectrumValue& MultiplyAdd(const SpectrumValue& x, const SpectrumValue& y);
+
+    /**
+     * Add the product of a SpectrumValue and a scalar to *this, component
+     * by component, i.e., *this += x * s without a temporary SpectrumValue
+     *
+     * @param x the first factor
+     * @param s the scalar factor
+     *
+     * @return a reference to *this
+     */
+    SpectrumValue& MultiplyAdd(const SpectrumValue& x, double s);
+
+    /**
+     * Enable or disable the SIMD (AVX2) implementation of the arithmetic
+     * operations, which is used by default when the CPU supports it. The
+     * results are the same, except for the rounding of the sums computed by
+     * SumOfProduct and IntegralOfProduct.
+     *
+     * @param enable whether the SIMD implementation may be used
+     */
+    static void EnableSimd(bool enable);
+
+    /**
+     * @return whether the SIMD implementation of the arithmetic operations is used
+     */
+    static bool IsSimdEnabled();
+
     /**
      *
      * @param x the operand
@@ -491,6 +561,26 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      */
     friend double Integral(const SpectrumValue& arg);
 
+    /**
+     *
+     * @param x the first factor
+     * @param y the second factor
+     *
+     * @return the sum of all the values in x * y, computed without a
+     * temporary SpectrumValue
+     */
+    friend double SumOfProduct(const SpectrumValue& x, const SpectrumValue& y);
+
+    /**
+     *
+     * @param x the first factor
+     * @param y the second factor
+     *
+     * @return the value of the integral \f$\int_F x(f) y(f) df  \f$, computed
+     * without a temporary SpectrumValue
+     */
+    friend double IntegralOfProduct(const SpectrumValue& x, const SpectrumValue& y);
+
     /**
      *
      * @return a Ptr to a copy of this instance
@@ -548,6 +638,16 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      * \param s flat value
      */
     void Divide(double s);
+    /**
+     * Mark all the bands as occupied
+     */
+    void SetAllOccupied();
+    /**
+     * Extend the range of the occupied bands to include a range of bands
+     * \param begin the index of the first band
+     * \param end the index following the last band
+     */
+    void AddOccupiedBands(std::size_t begin, std::size_t end);
     /**
      * Change the values sign
      */
@@ -598,6 +698,9 @@ class SpectrumValue : public SimpleRefCount<SpectrumValue>
      *
      */
     Values m_values;
+
+    std::size_t m_occupiedBegin; //!< Index of the first occupied band
+    std::size_t m_occupiedEnd;   //!< Index following the last occupied band
 };
 
 std::ostream& operator<<(std::ostream& os, const SpectrumValue& pvf);
@@ -611,6 +714,8 @@ SpectrumValue Log10(const SpectrumValue& arg);
 SpectrumValue Log2(const SpectrumValue& arg);
 SpectrumValue Log(const SpectrumValue& arg);
 double Integral(const SpectrumValue& arg);
+double SumOfProduct(const SpectrumValue& x, const SpectrumValue& y);
+double IntegralOfProduct(const SpectrumValue& x, const SpectrumValue& y);
 
 } // namespace ns3
 
@@ -30,10 +30,12 @@
 #include "ns3/phased-array-model.h"
 #include "ns3/pointer.h"
 #include "ns3/string.h"
+#include "ns3/uinteger.h"
 #include <ns3/simulator.h>
 
 #include <algorithm>
 #include <random>
+#include <thread>
 
 namespace ns3
 {
@@ -245,6 +247,8 @@ static const double sqrtC_office_NLOS[6][6] = {
 };
 
 ThreeGppChannelModel::ThreeGppChannelModel()
+    : m_precomputeChannels(false),
+      m_precomputeThreads(0)
 {
     NS_LOG_FUNCTION(this);
     m_uniformRv = CreateObject<UniformRandomVariable>();
@@ -269,6 +273,8 @@ ThreeGppChannelModel::DoDispose()
     {
         m_channelConditionModel->Dispose();
     }
+    m_refreshEvent.Cancel();
+    m_links.clear();
     m_channelMatrixMap.clear();
     m_channelParamsMap.clear();
     m_channelConditionModel = nullptr;
@@ -306,6 +312,20 @@ ThreeGppChannelModel::GetTypeId()
                           TimeValue(MilliSeconds(0)),
                           MakeTimeAccessor(&ThreeGppChannelModel::m_updatePeriod),
                           MakeTimeChecker())
+            .AddAttribute("PrecomputeChannels",
+                          "Generate the channels of all the known links as soon as their update "
+                          "period expires, instead of when they are next requested, computing "
+                          "the channel coefficients with a pool of threads. This has no effect "
+                          "if the update period is zero.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&ThreeGppChannelModel::m_precomputeChannels),
+                          MakeBooleanChecker())
+            .AddAttribute("PrecomputeThreads",
+                          "Number of threads used to compute the channel coefficients of the "
+                          "precomputed channels (0 means hardware concurrency).",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&ThreeGppChannelModel::m_precomputeThreads),
+                          MakeUintegerChecker<uint32_t>())
             // attributes for the blockage model
             .AddAttribute("Blockage",
                           "Enable blockage model A (sec 7.6.4.1)",
@@ -1187,9 +1207,127 @@ ThreeGppChannelModel::GetChannel(Ptr<const MobilityModel> aMob,
         m_channelMatrixMap[channelMatrixKey] = channelMatrix;
     }
 
+    if (m_precomputeChannels && !m_updatePeriod.IsZero())
+    {
+        // keep the objects of the link, to generate its channel again when
+        // its update period expires
+        if (m_links.find(channelMatrixKey) == m_links.end())
+        {
+            m_links[channelMatrixKey] = {aMob, bMob, aAntenna, bAntenna, channelParamsKey};
+        }
+        ScheduleRefresh();
+    }
+
     return channelMatrix;
 }
 
+void
+ThreeGppChannelModel::ScheduleRefresh()
+{
+    NS_LOG_FUNCTION(this);
+
+    if (m_refreshEvent.IsRunning() || m_links.empty())
+    {
+        return;
+    }
+    Time refreshTime = Time::Max();
+    for (const auto& link : m_links)
+    {
+        Ptr<const ThreeGppChannelParams> channelParams =
+            m_channelParamsMap.at(link.second.m_channelParamsKey);
+        refreshTime = std::min(refreshTime, channelParams->m_generatedTime + m_updatePeriod);
+    }
+    NS_LOG_LOGIC("Next generation of the channels at " << refreshTime.As(Time::S));
+    m_refreshEvent = Simulator::Schedule(std::max(refreshTime - Simulator::Now(), Time(0)),
+                                         &ThreeGppChannelModel::RefreshChannels,
+                                         this);
+}
+
+void
+ThreeGppChannelModel::RefreshChannels()
+{
+    NS_LOG_FUNCTION(this);
+
+    // Generate the expired channel params and the terms of the channel
+    // matrices on the simulation thread, since the random variables, the
+    // mobility models and the antenna arrays are not thread safe. The links
+    // are visited in the order of their keys, so that the random values
+    // drawn for each link do not depend on the number of threads.
+    std::unordered_map<uint64_t, Ptr<const ParamsTable>> tables;
+    std::vector<uint64_t> keys;
+    std::vector<ChannelMatrixTerms> terms;
+    for (const auto& link : m_links)
+    {
+        const ChannelLink& l = link.second;
+        auto paramsIt = m_channelParamsMap.find(l.m_channelParamsKey);
+        NS_ASSERT_MSG(paramsIt != m_channelParamsMap.end(), "The link has no channel params");
+        auto tableIt = tables.find(l.m_channelParamsKey);
+        if (tableIt == tables.end())
+        {
+            if (Simulator::Now() - paramsIt->second->m_generatedTime < m_updatePeriod)
+            {
+                continue;
+            }
+            Ptr<const ChannelCondition> condition =
+                m_channelConditionModel->GetChannelCondition(l.m_aMob, l.m_bMob);
+            double x = l.m_aMob->GetPosition().x - l.m_bMob->GetPosition().x;
+            double y = l.m_aMob->GetPosition().y - l.m_bMob->GetPosition().y;
+            double distance2D = sqrt(x * x + y * y);
+            double hUt = std::min(l.m_aMob->GetPosition().z, l.m_bMob->GetPosition().z);
+            double hBs = std::max(l.m_aMob->GetPosition().z, l.m_bMob->GetPosition().z);
+            Ptr<const ParamsTable> table3gpp = GetThreeGppTable(condition, hBs, hUt, distance2D);
+            paramsIt->second = GenerateChannelParameters(condition, table3gpp, l.m_aMob, l.m_bMob);
+            tableIt = tables.emplace(l.m_channelParamsKey, table3gpp).first;
+        }
+        keys.push_back(link.first);
+        terms.push_back(GetChannelMatrixTerms(paramsIt->second,
+                                              tableIt->second,
+                                              l.m_aMob,
+                                              l.m_bMob,
+                                              l.m_aAntenna,
+                                              l.m_bAntenna));
+    }
+
+    // compute the channel coefficients, which only depend on the terms
+    auto worker = [&terms](std::size_t first, std::size_t step) {
+        for (std::size_t i = first; i < terms.size(); i += step)
+        {
+            ComputeChannelCoefficients(terms[i]);
+        }
+    };
+
+    std::size_t nThreads = m_precomputeThreads;
+    if (nThreads == 0)
+    {
+        nThreads = std::max(1U, std::thread::hardware_concurrency());
+    }
+    nThreads = std::max<std::size_t>(1, std::min(nThreads, terms.size()));
+
+    NS_LOG_LOGIC("Computing " << terms.size() << " channel matrices with " << nThreads
+                              << " threads");
+
+    std::vector<std::thread> workers;
+    for (std::size_t t = 1; t < nThreads; t++)
+    {
+        workers.emplace_back(worker, t, nThreads);
+    }
+    worker(0, nThreads);
+    for (auto& w : workers)
+    {
+        w.join();
+    }
+
+    for (std::size_t i = 0; i < keys.size(); i++)
+    {
+        const ChannelLink& l = m_links[keys[i]];
+        Ptr<ChannelMatrix> channelMatrix = terms[i].m_channelMatrix;
+        channelMatrix->m_antennaPair = std::make_pair(l.m_aAntenna->GetId(), l.m_bAntenna->GetId());
+        m_channelMatrixMap[keys[i]] = channelMatrix;
+    }
+
+    ScheduleRefresh();
+}
+
 Ptr<const MatrixBasedChannelModel::ChannelParams>
 ThreeGppChannelModel::GetParams(Ptr<const MobilityModel> aMob, Ptr<const MobilityModel> bMob) const
 {
@@ -1837,59 +1975,68 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
 {
     NS_LOG_FUNCTION(this);
 
+    ChannelMatrixTerms terms =
+        GetChannelMatrixTerms(channelParams, table3gpp, sMob, uMob, sAntenna, uAntenna);
+    ComputeChannelCoefficients(terms);
+    const Complex3DVector& hUsn = terms.m_channelMatrix->m_channel;
+
+    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
+    for (uint64_t uIndex = 0; uIndex < hUsn.GetNumRows(); uIndex++)
+    {
+        for (uint64_t sIndex = 0; sIndex < hUsn.GetNumCols(); sIndex++)
+        {
+            for (std::size_t nIndex = 0; nIndex < hUsn.GetNumPages(); nIndex++)
+            {
+                NS_LOG_DEBUG(" " << hUsn(uIndex, sIndex, nIndex) << ",");
+            }
+        }
+    }
+    NS_LOG_INFO("size of coefficient matrix =[" << hUsn.GetNumRows() << "][" << hUsn.GetNumCols()
+                                                << "][" << hUsn.GetNumPages() << "]");
+    return terms.m_channelMatrix;
+}
+
+ThreeGppChannelModel::ChannelMatrixTerms
+ThreeGppChannelModel::GetChannelMatrixTerms(Ptr<const ThreeGppChannelParams> channelParams,
+                                            Ptr<const ParamsTable> table3gpp,
+                                            Ptr<const MobilityModel> sMob,
+                                            Ptr<const MobilityModel> uMob,
+                                            Ptr<const PhasedArrayModel> sAntenna,
+                                            Ptr<const PhasedArrayModel> uAntenna) const
+{
+    NS_LOG_FUNCTION(this);
+
     NS_ASSERT_MSG(m_frequency > 0.0, "Set the operating frequency first!");
 
+    ChannelMatrixTerms terms;
+    terms.m_channelParams = channelParams;
+    terms.m_raysPerCluster = table3gpp->m_raysPerCluster;
+
     // create a channel matrix instance
     Ptr<ChannelMatrix> channelMatrix = Create<ChannelMatrix>();
     channelMatrix->m_generatedTime = Simulator::Now();
     // save in which order is generated this matrix
     channelMatrix->m_nodeIds =
         std::make_pair(sMob->GetObject<Node>()->GetId(), uMob->GetObject<Node>()->GetId());
+    terms.m_channelMatrix = channelMatrix;
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::Double2DVector rayAodRadian;
-    MatrixBasedChannelModel::Double2DVector rayAoaRadian;
-    MatrixBasedChannelModel::Double2DVector rayZodRadian;
-    MatrixBasedChannelModel::Double2DVector rayZoaRadian;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenit od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-    if (isSameDirection)
-    {
-        rayAodRadian = channelParams->m_rayAodRadian;
-        rayAoaRadian = channelParams->m_rayAoaRadian;
-        rayZodRadian = channelParams->m_rayZodRadian;
-        rayZoaRadian = channelParams->m_rayZoaRadian;
-    }
-    else
-    {
-        rayAodRadian = channelParams->m_rayAoaRadian;
-        rayAoaRadian = channelParams->m_rayAodRadian;
-        rayZodRadian = channelParams->m_rayZoaRadian;
-        rayZoaRadian = channelParams->m_rayZodRadian;
-    }
-
-    // Step 11: Generate channel coefficients for each cluster n and each receiver
-    //  and transmitter element pair u,s.
-    Complex3DVector hUsn; // channel coffecient hUsn[u][s][n];
-    // where u and s are receive and transmit antenna element, n is cluster index.
-    // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
-    // the total cluster will be numReducedCLuster + 4.
-    uint64_t uSize = uAntenna->GetNumberOfElements();
-    uint64_t sSize = sAntenna->GetNumberOfElements();
-
-    hUsn.resize(uSize);
-    for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
-    {
-        hUsn[uIndex].resize(sSize);
-        for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
-        {
-            hUsn[uIndex][sIndex].resize(channelParams->m_reducedClusterNumber);
-        }
-    }
+    const Double2DVector& rayAodRadian =
+        isSameDirection ? channelParams->m_rayAodRadian : channelParams->m_rayAoaRadian;
+    const Double2DVector& rayAoaRadian =
+        isSameDirection ? channelParams->m_rayAoaRadian : channelParams->m_rayAodRadian;
+    const Double2DVector& rayZodRadian =
+        isSameDirection ? channelParams->m_rayZodRadian : channelParams->m_rayZoaRadian;
+    const Double2DVector& rayZoaRadian =
+        isSameDirection ? channelParams->m_rayZoaRadian : channelParams->m_rayZodRadian;
+
+    uint8_t numCluster = channelParams->m_reducedClusterNumber;
+    uint8_t raysPerCluster = table3gpp->m_raysPerCluster;
 
     NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPhase.size());
     NS_ASSERT(channelParams->m_reducedClusterNumber <= channelParams->m_clusterPower.size());
@@ -1907,83 +2054,205 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
     NS_ASSERT(table3gpp->m_raysPerCluster <= rayAoaRadian[0].size());
     NS_ASSERT(table3gpp->m_raysPerCluster <= rayAodRadian[0].size());
 
-    double x = sMob->GetPosition().x - uMob->GetPosition().x;
-    double y = sMob->GetPosition().y - uMob->GetPosition().y;
-    double distance2D = sqrt(x * x + y * y);
-    // NOTE we assume hUT = min (height(a), height(b)) and
-    // hBS = max (height (a), height (b))
-    double hUt = std::min(sMob->GetPosition().z, uMob->GetPosition().z);
-    double hBs = std::max(sMob->GetPosition().z, uMob->GetPosition().z);
-    // compute the 3D distance using eq. 7.4-1
-    double distance3D = std::sqrt(distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
+    for (uint64_t uIndex = 0; uIndex < uAntenna->GetNumberOfElements(); uIndex++)
+    {
+        terms.m_uLoc.push_back(uAntenna->GetElementLocation(uIndex));
+    }
+    for (uint64_t sIndex = 0; sIndex < sAntenna->GetNumberOfElements(); sIndex++)
+    {
+        terms.m_sLoc.push_back(sAntenna->GetElementLocation(sIndex));
+    }
+
+    // The field patterns and the polarization of a ray (7.5-22) do not depend on
+    // the antenna elements, and the phase differences of a ray depend on either
+    // the receive or the transmit element: compute them once, rather than for
+    // each pair of elements. The terms of ray m of cluster n are stored at index
+    // n * raysPerCluster + m.
+    std::size_t numRays = numCluster * raysPerCluster;
+    terms.m_rayPolarization.resize(numRays);
+    terms.m_rxRayDirection.resize(numRays);
+    terms.m_txRayDirection.resize(numRays);
+    for (uint8_t nIndex = 0; nIndex < numCluster; nIndex++)
+    {
+        bool isStrongest =
+            (nIndex == channelParams->m_cluster1st || nIndex == channelParams->m_cluster2nd);
+        for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
+        {
+            std::size_t rIndex = nIndex * raysPerCluster + mIndex;
+            const DoubleVector& initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
+            NS_ASSERT(4 <= initialPhase.size());
+            double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
+
+            double rxFieldPatternPhi;
+            double rxFieldPatternTheta;
+            double txFieldPatternPhi;
+            double txFieldPatternTheta;
+            if (!isStrongest)
+            {
+                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
+                // polarization slant angle configured in the array (7.5-22)
+                std::tie(rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern(
+                    Angles(channelParams->m_rayAoaRadian[nIndex][mIndex],
+                           channelParams->m_rayZoaRadian[nIndex][mIndex]));
+                std::tie(txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern(
+                    Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
+                           channelParams->m_rayZodRadian[nIndex][mIndex]));
+            }
+            else //(7.5-28)
+            {
+                std::tie(rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern(
+                    Angles(rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
+                std::tie(txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern(
+                    Angles(rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
+            }
+            terms.m_rayPolarization[rIndex] =
+                std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
+                    rxFieldPatternTheta * txFieldPatternTheta +
+                std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
+                    std::sqrt(1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
+                std::complex<double>(cos(initialPhase[2]), sin(initialPhase[2])) *
+                    std::sqrt(1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
+                std::complex<double>(cos(initialPhase[3]), sin(initialPhase[3])) *
+                    rxFieldPatternPhi * txFieldPatternPhi;
+
+            // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
+            terms.m_rxRayDirection[rIndex] =
+                Vector(sin(rayZoaRadian[nIndex][mIndex]) * cos(rayAoaRadian[nIndex][mIndex]),
+                       sin(rayZoaRadian[nIndex][mIndex]) * sin(rayAoaRadian[nIndex][mIndex]),
+                       cos(rayZoaRadian[nIndex][mIndex]));
+            terms.m_txRayDirection[rIndex] =
+                Vector(sin(rayZodRadian[nIndex][mIndex]) * cos(rayAodRadian[nIndex][mIndex]),
+                       sin(rayZodRadian[nIndex][mIndex]) * sin(rayAodRadian[nIndex][mIndex]),
+                       cos(rayZodRadian[nIndex][mIndex]));
+        }
+    }
 
-    Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
-    Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
+    if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+    {
+        double x = sMob->GetPosition().x - uMob->GetPosition().x;
+        double y = sMob->GetPosition().y - uMob->GetPosition().y;
+        double distance2D = sqrt(x * x + y * y);
+        // NOTE we assume hUT = min (height(a), height(b)) and
+        // hBS = max (height (a), height (b))
+        double hUt = std::min(sMob->GetPosition().z, uMob->GetPosition().z);
+        double hBs = std::max(sMob->GetPosition().z, uMob->GetPosition().z);
+        // compute the 3D distance using eq. 7.4-1
+        double distance3D = std::sqrt(distance2D * distance2D + (hBs - hUt) * (hBs - hUt));
+
+        Angles sAngle(uMob->GetPosition(), sMob->GetPosition());
+        Angles uAngle(sMob->GetPosition(), uMob->GetPosition());
+
+        double rxFieldPatternPhi;
+        double rxFieldPatternTheta;
+        double txFieldPatternPhi;
+        double txFieldPatternTheta;
+        std::tie(rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern(
+            Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
+        std::tie(txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern(
+            Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
+
+        double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
+
+        terms.m_losRay =
+            (rxFieldPatternTheta * txFieldPatternTheta - rxFieldPatternPhi * txFieldPatternPhi) *
+            std::complex<double>(cos(-2 * M_PI * distance3D / lambda),
+                                 sin(-2 * M_PI * distance3D / lambda));
+        terms.m_losRxDirection = Vector(sin(uAngle.GetInclination()) * cos(uAngle.GetAzimuth()),
+                                        sin(uAngle.GetInclination()) * sin(uAngle.GetAzimuth()),
+                                        cos(uAngle.GetInclination()));
+        terms.m_losTxDirection = Vector(sin(sAngle.GetInclination()) * cos(sAngle.GetAzimuth()),
+                                        sin(sAngle.GetInclination()) * sin(sAngle.GetAzimuth()),
+                                        cos(sAngle.GetInclination()));
+    }
+
+    return terms;
+}
+
+void
+ThreeGppChannelModel::ComputeChannelCoefficients(ChannelMatrixTerms& terms)
+{
+    const ThreeGppChannelParams& channelParams = *terms.m_channelParams;
+
+    // Step 11: Generate channel coefficients for each cluster n and each receiver
+    //  and transmitter element pair u,s.
+    // where u and s are receive and transmit antenna element, n is cluster index.
+    // NOTE Since each of the strongest 2 clusters are divided into 3 sub-clusters,
+    // the total cluster will be numReducedCLuster + 4, or numReducedCLuster + 2 if
+    // there is only one cluster. The sub-clusters are stored after the clusters.
+    uint64_t uSize = terms.m_uLoc.size();
+    uint64_t sSize = terms.m_sLoc.size();
+    uint8_t numCluster = channelParams.m_reducedClusterNumber;
+    uint8_t numSubCluster = (channelParams.m_cluster1st == channelParams.m_cluster2nd) ? 2 : 4;
+    uint8_t raysPerCluster = terms.m_raysPerCluster;
+    std::size_t numRays = numCluster * raysPerCluster;
+    bool los = (channelParams.m_losCondition == ChannelCondition::LOS);
+
+    // channel coffecient hUsn(u,s,n)
+    Complex3DVector hUsn(uSize, sSize, numCluster + numSubCluster);
+
+    // NOTE Doppler is computed in the CalcBeamformingGain function and is
+    // simplified to only account for the center angle of each cluster.
+    std::vector<std::complex<double>> rxRayPhase(uSize * numRays);
+    std::vector<std::complex<double>> rxLosPhase(los ? uSize : 0);
+    for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
+    {
+        const Vector& uLoc = terms.m_uLoc[uIndex];
+        for (std::size_t rIndex = 0; rIndex < numRays; rIndex++)
+        {
+            const Vector& d = terms.m_rxRayDirection[rIndex];
+            double rxPhaseDiff = 2 * M_PI * (d.x * uLoc.x + d.y * uLoc.y + d.z * uLoc.z);
+            rxRayPhase[uIndex * numRays + rIndex] = {cos(rxPhaseDiff), sin(rxPhaseDiff)};
+        }
+        if (los)
+        {
+            const Vector& d = terms.m_losRxDirection;
+            double rxPhaseDiff = 2 * M_PI * (d.x * uLoc.x + d.y * uLoc.y + d.z * uLoc.z);
+            rxLosPhase[uIndex] = {cos(rxPhaseDiff), sin(rxPhaseDiff)};
+        }
+    }
+    std::vector<std::complex<double>> txRayPhase(sSize * numRays);
+    std::vector<std::complex<double>> txLosPhase(los ? sSize : 0);
+    for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
+    {
+        const Vector& sLoc = terms.m_sLoc[sIndex];
+        for (std::size_t rIndex = 0; rIndex < numRays; rIndex++)
+        {
+            const Vector& d = terms.m_txRayDirection[rIndex];
+            double txPhaseDiff = 2 * M_PI * (d.x * sLoc.x + d.y * sLoc.y + d.z * sLoc.z);
+            txRayPhase[sIndex * numRays + rIndex] = {cos(txPhaseDiff), sin(txPhaseDiff)};
+        }
+        if (los)
+        {
+            const Vector& d = terms.m_losTxDirection;
+            double txPhaseDiff = 2 * M_PI * (d.x * sLoc.x + d.y * sLoc.y + d.z * sLoc.z);
+            txLosPhase[sIndex] = {cos(txPhaseDiff), sin(txPhaseDiff)};
+        }
+    }
 
     // The following for loops computes the channel coefficients
     for (uint64_t uIndex = 0; uIndex < uSize; uIndex++)
     {
-        Vector uLoc = uAntenna->GetElementLocation(uIndex);
+        const std::complex<double>* rxPhase = &rxRayPhase[uIndex * numRays];
 
         for (uint64_t sIndex = 0; sIndex < sSize; sIndex++)
         {
-            Vector sLoc = sAntenna->GetElementLocation(sIndex);
+            const std::complex<double>* txPhase = &txRayPhase[sIndex * numRays];
+            uint8_t subClusterIndex = numCluster;
 
-            for (uint8_t nIndex = 0; nIndex < channelParams->m_reducedClusterNumber; nIndex++)
+            for (uint8_t nIndex = 0; nIndex < numCluster; nIndex++)
             {
-                // Compute the N-2 weakest cluster, assuming 0 slant angle and a
-                // polarization slant angle configured in the array (7.5-22)
-                if (nIndex != channelParams->m_cluster1st && nIndex != channelParams->m_cluster2nd)
+                double rayAmplitude = sqrt(channelParams.m_clusterPower[nIndex] / raysPerCluster);
+                std::size_t firstRay = nIndex * raysPerCluster;
+                if (nIndex != channelParams.m_cluster1st && nIndex != channelParams.m_cluster2nd)
                 {
                     std::complex<double> rays(0, 0);
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                    for (std::size_t rIndex = firstRay; rIndex < firstRay + raysPerCluster;
+                         rIndex++)
                     {
-                        DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                        double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-                        // lambda_0 is accounted in the antenna spacing uLoc and sLoc.
-                        double rxPhaseDiff = 2 * M_PI *
-                                             (sin(rayZoaRadian[nIndex][mIndex]) *
-                                                  cos(rayAoaRadian[nIndex][mIndex]) * uLoc.x +
-                                              sin(rayZoaRadian[nIndex][mIndex]) *
-                                                  sin(rayAoaRadian[nIndex][mIndex]) * uLoc.y +
-                                              cos(rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-
-                        double txPhaseDiff = 2 * M_PI *
-                                             (sin(rayZodRadian[nIndex][mIndex]) *
-                                                  cos(rayAodRadian[nIndex][mIndex]) * sLoc.x +
-                                              sin(rayZodRadian[nIndex][mIndex]) *
-                                                  sin(rayAodRadian[nIndex][mIndex]) * sLoc.y +
-                                              cos(rayZodRadian[nIndex][mIndex]) * sLoc.z);
-                        // NOTE Doppler is computed in the CalcBeamformingGain function and is
-                        // simplified to only account for the center angle of each cluster.
-
-                        double rxFieldPatternPhi;
-                        double rxFieldPatternTheta;
-                        double txFieldPatternPhi;
-                        double txFieldPatternTheta;
-                        std::tie(rxFieldPatternPhi, rxFieldPatternTheta) =
-                            uAntenna->GetElementFieldPattern(
-                                Angles(channelParams->m_rayAoaRadian[nIndex][mIndex],
-                                       channelParams->m_rayZoaRadian[nIndex][mIndex]));
-                        std::tie(txFieldPatternPhi, txFieldPatternTheta) =
-                            sAntenna->GetElementFieldPattern(
-                                Angles(channelParams->m_rayAodRadian[nIndex][mIndex],
-                                       channelParams->m_rayZodRadian[nIndex][mIndex]));
-                        NS_ASSERT(4 <= initialPhase.size());
-                        rays += (std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
-                                     rxFieldPatternTheta * txFieldPatternTheta +
-                                 std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
-                                     std::sqrt(1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                                 std::complex<double>(cos(initialPhase[2]), sin(initialPhase[2])) *
-                                     std::sqrt(1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                                 std::complex<double>(cos(initialPhase[3]), sin(initialPhase[3])) *
-                                     rxFieldPatternPhi * txFieldPatternPhi) *
-                                std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                                std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                        rays += terms.m_rayPolarization[rIndex] * rxPhase[rIndex] * txPhase[rIndex];
                     }
-                    rays *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn[uIndex][sIndex][nIndex] = rays;
+                    rays *= rayAmplitude;
+                    hUsn(uIndex, sIndex, nIndex) = rays;
                 }
                 else //(7.5-28)
                 {
@@ -1991,50 +2260,13 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                     std::complex<double> raysSub2(0, 0);
                     std::complex<double> raysSub3(0, 0);
 
-                    for (uint8_t mIndex = 0; mIndex < table3gpp->m_raysPerCluster; mIndex++)
+                    for (uint8_t mIndex = 0; mIndex < raysPerCluster; mIndex++)
                     {
-                        double k = channelParams->m_crossPolarizationPowerRatios[nIndex][mIndex];
-
                         // ZML:Just remind me that the angle offsets for the 3 subclusters were not
                         // generated correctly.
-                        DoubleVector initialPhase = channelParams->m_clusterPhase[nIndex][mIndex];
-                        NS_ASSERT(4 <= initialPhase.size());
-
-                        double rxPhaseDiff = 2 * M_PI *
-                                             (sin(rayZoaRadian[nIndex][mIndex]) *
-                                                  cos(rayAoaRadian[nIndex][mIndex]) * uLoc.x +
-                                              sin(rayZoaRadian[nIndex][mIndex]) *
-                                                  sin(rayAoaRadian[nIndex][mIndex]) * uLoc.y +
-                                              cos(rayZoaRadian[nIndex][mIndex]) * uLoc.z);
-                        double txPhaseDiff = 2 * M_PI *
-                                             (sin(rayZodRadian[nIndex][mIndex]) *
-                                                  cos(rayAodRadian[nIndex][mIndex]) * sLoc.x +
-                                              sin(rayZodRadian[nIndex][mIndex]) *
-                                                  sin(rayAodRadian[nIndex][mIndex]) * sLoc.y +
-                                              cos(rayZodRadian[nIndex][mIndex]) * sLoc.z);
-
-                        double rxFieldPatternPhi;
-                        double rxFieldPatternTheta;
-                        double txFieldPatternPhi;
-                        double txFieldPatternTheta;
-                        std::tie(rxFieldPatternPhi, rxFieldPatternTheta) =
-                            uAntenna->GetElementFieldPattern(
-                                Angles(rayAoaRadian[nIndex][mIndex], rayZoaRadian[nIndex][mIndex]));
-                        std::tie(txFieldPatternPhi, txFieldPatternTheta) =
-                            sAntenna->GetElementFieldPattern(
-                                Angles(rayAodRadian[nIndex][mIndex], rayZodRadian[nIndex][mIndex]));
-
+                        std::size_t rIndex = firstRay + mIndex;
                         std::complex<double> raySub =
-                            (std::complex<double>(cos(initialPhase[0]), sin(initialPhase[0])) *
-                                 rxFieldPatternTheta * txFieldPatternTheta +
-                             std::complex<double>(cos(initialPhase[1]), sin(initialPhase[1])) *
-                                 sqrt(1 / k) * rxFieldPatternTheta * txFieldPatternPhi +
-                             std::complex<double>(cos(initialPhase[2]), sin(initialPhase[2])) *
-                                 sqrt(1 / k) * rxFieldPatternPhi * txFieldPatternTheta +
-                             std::complex<double>(cos(initialPhase[3]), sin(initialPhase[3])) *
-                                 rxFieldPatternPhi * txFieldPatternPhi) *
-                            std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                            std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                            terms.m_rayPolarization[rIndex] * rxPhase[rIndex] * txPhase[rIndex];
 
                         switch (mIndex)
                         {
@@ -2057,81 +2289,36 @@ ThreeGppChannelModel::GetNewChannel(Ptr<const ThreeGppChannelParams> channelPara
                             break;
                         }
                     }
-                    raysSub1 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub2 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    raysSub3 *=
-                        sqrt(channelParams->m_clusterPower[nIndex] / table3gpp->m_raysPerCluster);
-                    hUsn[uIndex][sIndex][nIndex] = raysSub1;
-                    hUsn[uIndex][sIndex].push_back(raysSub2);
-                    hUsn[uIndex][sIndex].push_back(raysSub3);
+                    raysSub1 *= rayAmplitude;
+                    raysSub2 *= rayAmplitude;
+                    raysSub3 *= rayAmplitude;
+                    hUsn(uIndex, sIndex, nIndex) = raysSub1;
+                    hUsn(uIndex, sIndex, subClusterIndex++) = raysSub2;
+                    hUsn(uIndex, sIndex, subClusterIndex++) = raysSub3;
                 }
             }
+            NS_ASSERT(subClusterIndex == hUsn.GetNumPages());
 
-            if (channelParams->m_losCondition == ChannelCondition::LOS) //(7.5-29) && (7.5-30)
+            if (los) //(7.5-29) && (7.5-30)
             {
-                std::complex<double> ray(0, 0);
-                double rxPhaseDiff =
-                    2 * M_PI *
-                    (sin(uAngle.GetInclination()) * cos(uAngle.GetAzimuth()) * uLoc.x +
-                     sin(uAngle.GetInclination()) * sin(uAngle.GetAzimuth()) * uLoc.y +
-                     cos(uAngle.GetInclination()) * uLoc.z);
-                double txPhaseDiff =
-                    2 * M_PI *
-                    (sin(sAngle.GetInclination()) * cos(sAngle.GetAzimuth()) * sLoc.x +
-                     sin(sAngle.GetInclination()) * sin(sAngle.GetAzimuth()) * sLoc.y +
-                     cos(sAngle.GetInclination()) * sLoc.z);
-
-                double rxFieldPatternPhi;
-                double rxFieldPatternTheta;
-                double txFieldPatternPhi;
-                double txFieldPatternTheta;
-                std::tie(rxFieldPatternPhi, rxFieldPatternTheta) = uAntenna->GetElementFieldPattern(
-                    Angles(uAngle.GetAzimuth(), uAngle.GetInclination()));
-                std::tie(txFieldPatternPhi, txFieldPatternTheta) = sAntenna->GetElementFieldPattern(
-                    Angles(sAngle.GetAzimuth(), sAngle.GetInclination()));
-
-                double lambda = 3e8 / m_frequency; // the wavelength of the carrier frequency
-
-                ray = (rxFieldPatternTheta * txFieldPatternTheta -
-                       rxFieldPatternPhi * txFieldPatternPhi) *
-                      std::complex<double>(cos(-2 * M_PI * distance3D / lambda),
-                                           sin(-2 * M_PI * distance3D / lambda)) *
-                      std::complex<double>(cos(rxPhaseDiff), sin(rxPhaseDiff)) *
-                      std::complex<double>(cos(txPhaseDiff), sin(txPhaseDiff));
+                std::complex<double> ray = terms.m_losRay * rxLosPhase[uIndex] * txLosPhase[sIndex];
 
-                double kLinear = pow(10, channelParams->m_K_factor / 10);
+                double kLinear = pow(10, channelParams.m_K_factor / 10);
                 // the LOS path should be attenuated if blockage is enabled.
-                hUsn[uIndex][sIndex][0] =
-                    sqrt(1 / (kLinear + 1)) * hUsn[uIndex][sIndex][0] +
+                hUsn(uIndex, sIndex, 0) =
+                    sqrt(1 / (kLinear + 1)) * hUsn(uIndex, sIndex, 0) +
                     sqrt(kLinear / (1 + kLinear)) * ray /
-                        pow(10, channelParams->m_attenuation_dB[0] / 10); //(7.5-30) for tau = tau1
-                double tempSize = hUsn[uIndex][sIndex].size();
-                for (uint8_t nIndex = 1; nIndex < tempSize; nIndex++)
+                        pow(10, channelParams.m_attenuation_dB[0] / 10); //(7.5-30) for tau = tau1
+                for (std::size_t nIndex = 1; nIndex < hUsn.GetNumPages(); nIndex++)
                 {
-                    hUsn[uIndex][sIndex][nIndex] *=
+                    hUsn(uIndex, sIndex, nIndex) *=
                         sqrt(1 / (kLinear + 1)); //(7.5-30) for tau = tau2...taunN
                 }
             }
         }
     }
 
-    NS_LOG_DEBUG("Husn (sAntenna, uAntenna):" << sAntenna->GetId() << ", " << uAntenna->GetId());
-    for (auto& i : hUsn)
-    {
-        for (auto& j : i)
-        {
-            for (auto& k : j)
-            {
-                NS_LOG_DEBUG(" " << k << ",");
-            }
-        }
-    }
-    NS_LOG_INFO("size of coefficient matrix =[" << hUsn.size() << "][" << hUsn[0].size() << "]["
-                                                << hUsn[0][0].size() << "]");
-    channelMatrix->m_channel = hUsn;
-    return channelMatrix;
+    terms.m_channelMatrix->m_channel = std::move(hUsn);
 }
 
 std::pair<double, double>
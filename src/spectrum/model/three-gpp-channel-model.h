@@ -25,12 +25,14 @@
 #include "ns3/angles.h"
 #include <ns3/boolean.h>
 #include <ns3/channel-condition-model.h>
+#include <ns3/event-id.h>
 #include <ns3/matrix-based-channel-model.h>
 #include <ns3/nstime.h>
 #include <ns3/object.h>
 #include <ns3/random-variable-stream.h>
 
 #include <complex.h>
+#include <map>
 #include <unordered_map>
 
 namespace ns3
@@ -45,6 +47,16 @@ class MobilityModel;
  * The class implements the channel matrix generation procedure
  * described in 3GPP TR 38.901.
  *
+ * The channels are generated when they are first requested, and generated
+ * again when they are requested after their update period. If the
+ * PrecomputeChannels attribute is enabled, the channels of all the known
+ * links are instead generated again as soon as their update period expires,
+ * and the channel coefficients are computed by a pool of threads. The random
+ * parameters are drawn on the simulation thread, in the order of the keys of
+ * the links, so that the channels do not depend on the number of threads.
+ * Since the channels are then generated periodically, the simulation has to
+ * be stopped with Simulator::Stop.
+ *
  * \see GetChannel
  */
 class ThreeGppChannelModel : public MatrixBasedChannelModel
@@ -333,6 +345,82 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
     bool ChannelMatrixNeedsUpdate(Ptr<const ThreeGppChannelParams> channelParams,
                                   Ptr<const ChannelMatrix> channelMatrix);
 
+    /**
+     * The terms of the channel coefficients of a pair of antenna arrays that
+     * depend on the mobility models and on the antenna arrays. They are
+     * computed on the simulation thread, since these objects are not thread
+     * safe, whereas the channel coefficients can be computed on any thread.
+     */
+    struct ChannelMatrixTerms
+    {
+        Ptr<ChannelMatrix> m_channelMatrix;               //!< the channel matrix to compute
+        Ptr<const ThreeGppChannelParams> m_channelParams; //!< the channel parameters
+        uint8_t m_raysPerCluster;                         //!< the number of rays per cluster
+        std::vector<Vector> m_uLoc; //!< the locations of the elements of the u array
+        std::vector<Vector> m_sLoc; //!< the locations of the elements of the s array
+        std::vector<std::complex<double>>
+            m_rayPolarization;                //!< the polarization term (7.5-22) of each ray
+        std::vector<Vector> m_rxRayDirection; //!< the arrival unit vector of each ray
+        std::vector<Vector> m_txRayDirection; //!< the departure unit vector of each ray
+        std::complex<double> m_losRay;        //!< the LOS ray (7.5-29) without element phases
+        Vector m_losRxDirection;              //!< the arrival unit vector of the LOS ray
+        Vector m_losTxDirection;              //!< the departure unit vector of the LOS ray
+    };
+
+    /**
+     * Compute the terms of the channel matrix between two nodes s and u that
+     * depend on their mobility models and antenna arrays (see GetNewChannel).
+     *
+     * \param channelParams the channel parameters of the pair of nodes
+     * \param table3gpp the 3gpp parameters table
+     * \param sMob the mobility model of node s
+     * \param uMob the mobility model of node u
+     * \param sAntenna the antenna array of node s
+     * \param uAntenna the antenna array of node u
+     * \return the terms of the channel matrix, with an empty channel matrix
+     */
+    ChannelMatrixTerms GetChannelMatrixTerms(Ptr<const ThreeGppChannelParams> channelParams,
+                                             Ptr<const ParamsTable> table3gpp,
+                                             Ptr<const MobilityModel> sMob,
+                                             Ptr<const MobilityModel> uMob,
+                                             Ptr<const PhasedArrayModel> sAntenna,
+                                             Ptr<const PhasedArrayModel> uAntenna) const;
+
+    /**
+     * Compute the channel coefficients (step 11 of 3GPP TR 38.901) of a
+     * channel matrix from its terms. This function does not access any
+     * shared object, hence it can be called on any thread.
+     *
+     * \param terms the terms of the channel matrix, whose coefficients are set
+     */
+    static void ComputeChannelCoefficients(ChannelMatrixTerms& terms);
+
+    /**
+     * The objects of a link whose channel is generated again when its update
+     * period expires, if the channels are precomputed.
+     */
+    struct ChannelLink
+    {
+        Ptr<const MobilityModel> m_aMob;        //!< the mobility model of the a device
+        Ptr<const MobilityModel> m_bMob;        //!< the mobility model of the b device
+        Ptr<const PhasedArrayModel> m_aAntenna; //!< the antenna of the a device
+        Ptr<const PhasedArrayModel> m_bAntenna; //!< the antenna of the b device
+        uint64_t m_channelParamsKey;            //!< the key of the channel params
+    };
+
+    /**
+     * Schedule the generation of the channels of the known links when the
+     * first of their update periods expires, if none is scheduled.
+     */
+    void ScheduleRefresh();
+
+    /**
+     * Generate again the channel params whose update period expires now and
+     * the channel matrices of the links that use them, computing the channel
+     * coefficients with the pool of threads.
+     */
+    void RefreshChannels();
+
     std::unordered_map<uint64_t, Ptr<ChannelMatrix>>
         m_channelMatrixMap; //!< map containing the channel realizations per pair of
                             //!< PhasedAntennaArray instances, the key of this map is reciprocal
@@ -342,6 +430,11 @@ class ThreeGppChannelModel : public MatrixBasedChannelModel
                             //!< key of this map is reciprocal and uniquely identifies a pair of
                             //!< nodes
     Time m_updatePeriod;    //!< the channel update period
+    std::map<uint64_t, ChannelLink>
+        m_links; //!< the known links, per channel matrix key, if the channels are precomputed
+    bool m_precomputeChannels;    //!< generate the channels when their update period expires
+    uint32_t m_precomputeThreads; //!< number of threads computing the channel coefficients
+    EventId m_refreshEvent;       //!< the next generation of the expired channels
     double m_frequency;     //!< the operating frequency
     std::string m_scenario; //!< the 3GPP scenario
     Ptr<ChannelConditionModel> m_channelConditionModel; //!< the channel condition model
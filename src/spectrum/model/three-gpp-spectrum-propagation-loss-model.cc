@@ -123,40 +123,22 @@ ThreeGppSpectrumPropagationLossModel::CalcLongTerm(
     uint16_t sAntenna = static_cast<uint16_t>(sW.size());
     uint16_t uAntenna = static_cast<uint16_t>(uW.size());
 
-    NS_ASSERT(uAntenna == params->m_channel.size());
-    NS_ASSERT(sAntenna == params->m_channel.at(0).size());
+    NS_ASSERT(uAntenna == params->m_channel.GetNumRows());
+    NS_ASSERT(sAntenna == params->m_channel.GetNumCols());
 
     NS_LOG_DEBUG("CalcLongTerm with sAntenna " << sAntenna << " uAntenna " << uAntenna);
     // store the long term part to reduce computation load
     // only the small scale fading needs to be updated if the large scale parameters and antenna
     // weights remain unchanged.
-    PhasedArrayModel::ComplexVector longTerm;
-    uint8_t numCluster = static_cast<uint8_t>(params->m_channel[0][0].size());
-
-    NS_ASSERT(uAntenna == params->m_channel.size());
-    NS_ASSERT(sAntenna == params->m_channel.at(0).size());
-
-    for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
-    {
-        std::complex<double> txSum(0, 0);
-        for (uint16_t sIndex = 0; sIndex < sAntenna; sIndex++)
-        {
-            std::complex<double> rxSum(0, 0);
-            for (uint16_t uIndex = 0; uIndex < uAntenna; uIndex++)
-            {
-                rxSum = rxSum + uW[uIndex] * params->m_channel[uIndex][sIndex][cIndex];
-            }
-            txSum = txSum + sW[sIndex] * rxSum;
-        }
-        longTerm.push_back(txSum);
-    }
-    return longTerm;
+    // The long term component of each cluster is uW^T H sW, where H is the page of the
+    // channel matrix of the cluster
+    return params->m_channel.ComputeBilinearForms(uW, sW);
 }
 
 Ptr<SpectrumValue>
 ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     Ptr<SpectrumValue> txPsd,
-    PhasedArrayModel::ComplexVector longTerm,
+    const PhasedArrayModel::ComplexVector& longTerm,
     Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
     Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
     const ns3::Vector& sSpeed,
@@ -166,15 +148,14 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
 
     Ptr<SpectrumValue> tempPsd = Copy<SpectrumValue>(txPsd);
 
-    // channel[rx][tx][cluster]
-    uint8_t numCluster = static_cast<uint8_t>(channelMatrix->m_channel[0][0].size());
+    // channel(rx, tx, cluster)
+    uint8_t numCluster = static_cast<uint8_t>(channelMatrix->m_channel.GetNumPages());
 
     // compute the doppler term
     // NOTE the update of Doppler is simplified by only taking the center angle of
     // each cluster in to consideration.
     double slotTime = Simulator::Now().GetSeconds();
     double factor = 2 * M_PI * slotTime * GetFrequency() / 3e8;
-    PhasedArrayModel::ComplexVector doppler;
 
     // The following asserts might seem paranoic, but it is important to
     // make sure that all the structures that are passed to this function
@@ -187,35 +168,32 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX].size());
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX].size());
     NS_ASSERT(numCluster <= channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX].size());
+    NS_ASSERT(numCluster <= channelParams->m_delay.size());
     NS_ASSERT(numCluster <= longTerm.size());
 
     // check if channelParams structure is generated in direction s-to-u or u-to-s
     bool isSameDirection = (channelParams->m_nodeIds == channelMatrix->m_nodeIds);
 
-    MatrixBasedChannelModel::DoubleVector zoa;
-    MatrixBasedChannelModel::DoubleVector zod;
-    MatrixBasedChannelModel::DoubleVector aoa;
-    MatrixBasedChannelModel::DoubleVector aod;
-
     // if channel params is generated in the same direction in which we
     // generate the channel matrix, angles and zenit od departure and arrival are ok,
     // just set them to corresponding variable that will be used for the generation
     // of channel matrix, otherwise we need to flip angles and zenits of departure and arrival
-    if (isSameDirection)
-    {
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-    else
-    {
-        zod = channelParams->m_angle[MatrixBasedChannelModel::ZOA_INDEX];
-        zoa = channelParams->m_angle[MatrixBasedChannelModel::ZOD_INDEX];
-        aod = channelParams->m_angle[MatrixBasedChannelModel::AOA_INDEX];
-        aoa = channelParams->m_angle[MatrixBasedChannelModel::AOD_INDEX];
-    }
-
+    const auto& angle = channelParams->m_angle;
+    const MatrixBasedChannelModel::DoubleVector& zoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOA_INDEX
+                              : MatrixBasedChannelModel::ZOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& zod =
+        angle[isSameDirection ? MatrixBasedChannelModel::ZOD_INDEX
+                              : MatrixBasedChannelModel::ZOA_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aoa =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOA_INDEX
+                              : MatrixBasedChannelModel::AOD_INDEX];
+    const MatrixBasedChannelModel::DoubleVector& aod =
+        angle[isSameDirection ? MatrixBasedChannelModel::AOD_INDEX
+                              : MatrixBasedChannelModel::AOA_INDEX];
+
+    // the long term component of each cluster multiplied by its doppler term
+    PhasedArrayModel::ComplexVector clusterGain(numCluster);
     for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
     {
         // Compute alpha and D as described in 3GPP TR 37.885 v15.3.0, Sec. 6.2.3
@@ -241,32 +219,64 @@ ThreeGppSpectrumPropagationLossModel::CalcBeamformingGain(
                        sin(zod[cIndex] * M_PI / 180) * sin(aod[cIndex] * M_PI / 180) * sSpeed.y +
                        cos(zod[cIndex] * M_PI / 180) * sSpeed.z) +
                       2 * alpha * D);
-        doppler.emplace_back(cos(tempDoppler), sin(tempDoppler));
+        clusterGain[cIndex] =
+            longTerm[cIndex] * std::complex<double>(cos(tempDoppler), sin(tempDoppler));
     }
 
-    NS_ASSERT(numCluster <= doppler.size());
-
     // apply the doppler term and the propagation delay to the long term component
-    // to obtain the beamforming gain
-    auto vit = tempPsd->ValuesBegin();      // psd iterator
-    auto sbit = tempPsd->ConstBandsBegin(); // band iterator
-    while (vit != tempPsd->ValuesEnd())
+    // to obtain the beamforming gain of the occupied bands. The delay term of a
+    // cluster is exp(-j 2 pi f tau) at the center frequency f of a band: if the
+    // bands are evenly spaced, it is obtained from the term of the previous band
+    // with a multiplication by exp(-j 2 pi df tau), and only computed with a sine
+    // and a cosine every DELAY_TERM_REFRESH bands to bound the rounding errors.
+    const std::size_t DELAY_TERM_REFRESH = 16;
+    const SpectrumValue& txValues = *txPsd;
+    std::size_t begin = txValues.GetOccupiedBandsBegin();
+    std::size_t end = txValues.GetOccupiedBandsEnd();
+    auto bands = txValues.ConstBandsBegin();
+    bool evenlySpaced = (end - begin > 1);
+    double bandSpacing = evenlySpaced ? bands[begin + 1].fc - bands[begin].fc : 0;
+    for (std::size_t i = begin + 1; evenlySpaced && i < end; i++)
+    {
+        evenlySpaced = std::abs(bands[i].fc - bands[i - 1].fc - bandSpacing) <= 1e-9 * bandSpacing;
+    }
+
+    PhasedArrayModel::ComplexVector delayTerm(numCluster);
+    PhasedArrayModel::ComplexVector delayStep(numCluster);
+    for (uint8_t cIndex = 0; evenlySpaced && cIndex < numCluster; cIndex++)
+    {
+        double delay = -2 * M_PI * bandSpacing * (channelParams->m_delay[cIndex]);
+        delayStep[cIndex] = std::complex<double>(cos(delay), sin(delay));
+    }
+
+    for (std::size_t i = begin; i < end; i++)
     {
-        if ((*vit) != 0.00)
+        double value = txValues[i];
+        if (evenlySpaced && (i - begin) % DELAY_TERM_REFRESH != 0)
         {
-            std::complex<double> subsbandGain(0.0, 0.0);
-            double fsb = (*sbit).fc; // center frequency of the sub-band
+            for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
+            {
+                delayTerm[cIndex] *= delayStep[cIndex];
+            }
+        }
+        else if (evenlySpaced || value != 0.00)
+        {
+            double fsb = bands[i].fc; // center frequency of the sub-band
             for (uint8_t cIndex = 0; cIndex < numCluster; cIndex++)
             {
                 double delay = -2 * M_PI * fsb * (channelParams->m_delay[cIndex]);
-                subsbandGain = subsbandGain + longTerm[cIndex] * doppler[cIndex] *
-                                                  std::complex<double>(cos(delay), sin(delay));
+                delayTerm[cIndex] = std::complex<double>(cos(delay), sin(delay));
             }
-            *vit = (*vit) * (norm(subsbandGain));
         }
-        vit++;
-        sbit++;
+        if (value != 0.00)
+        {
+            std::complex<double> subsbandGain =
+                ComplexMatrixArray::DotProduct(clusterGain.data(), delayTerm.data(), numCluster);
+            (*tempPsd)[i] = value * (norm(subsbandGain));
+        }
     }
+    // writing the values marked all the bands as occupied
+    tempPsd->ShrinkOccupiedBands();
     return tempPsd;
 }
 
@@ -355,8 +365,6 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
     NS_ASSERT_MSG(a->GetDistanceFrom(b) > 0.0,
                   "The position of a and b devices cannot be the same");
 
-    Ptr<SpectrumValue> rxPsd = Copy<SpectrumValue>(params->psd);
-
     // retrieve the antenna of device a
     NS_ASSERT_MSG(aPhasedArrayModel, "Antenna not found for node " << aId);
     NS_LOG_DEBUG("a node " << a->GetObject<Node>() << " antenna " << aPhasedArrayModel);
@@ -375,12 +383,12 @@ ThreeGppSpectrumPropagationLossModel::DoCalcRxPowerSpectralDensity(
         GetLongTerm(channelMatrix, aPhasedArrayModel, bPhasedArrayModel);
 
     // apply the beamforming gain
-    rxPsd = CalcBeamformingGain(rxPsd,
-                                longTerm,
-                                channelMatrix,
-                                channelParams,
-                                a->GetVelocity(),
-                                b->GetVelocity());
+    Ptr<SpectrumValue> rxPsd = CalcBeamformingGain(params->psd,
+                                                   longTerm,
+                                                   channelMatrix,
+                                                   channelParams,
+                                                   a->GetVelocity(),
+                                                   b->GetVelocity());
 
     return rxPsd;
 }
@@ -185,7 +185,7 @@ class ThreeGppSpectrumPropagationLossModel : public PhasedArraySpectrumPropagati
      */
     Ptr<SpectrumValue> CalcBeamformingGain(
         Ptr<SpectrumValue> txPsd,
-        PhasedArrayModel::ComplexVector longTerm,
+        const PhasedArrayModel::ComplexVector& longTerm,
         Ptr<const MatrixBasedChannelModel::ChannelMatrix> channelMatrix,
         Ptr<const MatrixBasedChannelModel::ChannelParams> channelParams,
         const Vector& sSpeed,
@@ -94,6 +94,222 @@ SpectrumValueTestCase::DoRun()
     NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(m_a, m_b, TOLERANCE, "");
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the fused SpectrumValue operations, and check that the SIMD
+ * and the scalar implementations of the operations return the same values.
+ */
+class SpectrumValueFusedTestCase : public TestCase
+{
+  public:
+    SpectrumValueFusedTestCase();
+    ~SpectrumValueFusedTestCase() override;
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Compute the results of the operations on two SpectrumValues
+     * \param x first SpectrumValue
+     * \param y second SpectrumValue
+     * \return the results of the operations
+     */
+    std::vector<SpectrumValue> Compute(const SpectrumValue& x, const SpectrumValue& y);
+};
+
+SpectrumValueFusedTestCase::SpectrumValueFusedTestCase()
+    : TestCase("Fused and SIMD SpectrumValue operations")
+{
+}
+
+SpectrumValueFusedTestCase::~SpectrumValueFusedTestCase()
+{
+}
+
+std::vector<SpectrumValue>
+SpectrumValueFusedTestCase::Compute(const SpectrumValue& x, const SpectrumValue& y)
+{
+    std::vector<SpectrumValue> results{x + y, x - y, x * y, x / y, x + 2.5, x * 2.5, x / 2.5};
+    SpectrumValue z = x;
+    z.MultiplyAdd(x, y);
+    results.push_back(z);
+    z.MultiplyAdd(y, -1.5);
+    results.push_back(z);
+    return results;
+}
+
+void
+SpectrumValueFusedTestCase::DoRun()
+{
+    // an odd number of bands, to cover the elements after the SIMD blocks
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < 37; i++)
+    {
+        freqs.push_back(2.4e9 + i * (312.5e3 + i * 1e3));
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+    SpectrumValue x(model);
+    SpectrumValue y(model);
+    for (uint32_t i = 0; i < freqs.size(); i++)
+    {
+        x[i] = std::sin(i + 1.0) * 1e-12;
+        y[i] = std::cos(i * 0.7) + 1.5;
+    }
+
+    SpectrumValue z = x;
+    z.MultiplyAdd(x, y);
+    SpectrumValue expected = x + x * y;
+    NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(z, expected, 0, "x += x * y");
+    z = y;
+    z.MultiplyAdd(x, 3.0);
+    expected = y + x * 3.0;
+    NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(z, expected, 0, "y += x * 3");
+
+    NS_TEST_ASSERT_MSG_EQ_TOL(SumOfProduct(x, y),
+                              Sum(x * y),
+                              std::abs(Sum(x * y)) * TOLERANCE,
+                              "Unexpected sum of the product");
+    NS_TEST_ASSERT_MSG_EQ_TOL(IntegralOfProduct(x, y),
+                              Integral(x * y),
+                              std::abs(Integral(x * y)) * TOLERANCE,
+                              "Unexpected integral of the product");
+
+    bool simd = SpectrumValue::IsSimdEnabled();
+    SpectrumValue::EnableSimd(false);
+    NS_TEST_ASSERT_MSG_EQ(SpectrumValue::IsSimdEnabled(), false, "SIMD should be disabled");
+    std::vector<SpectrumValue> scalar = Compute(x, y);
+    double scalarIntegral = IntegralOfProduct(x, y);
+    SpectrumValue::EnableSimd(true);
+    NS_TEST_ASSERT_MSG_EQ(SpectrumValue::IsSimdEnabled(), simd, "SIMD should be restored");
+    std::vector<SpectrumValue> vectorized = Compute(x, y);
+    for (std::size_t op = 0; op < scalar.size(); op++)
+    {
+        NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(vectorized[op],
+                                                 scalar[op],
+                                                 0,
+                                                 "Operation " + std::to_string(op) +
+                                                     " differs with SIMD");
+    }
+    NS_TEST_ASSERT_MSG_EQ_TOL(IntegralOfProduct(x, y),
+                              scalarIntegral,
+                              std::abs(scalarIntegral) * TOLERANCE,
+                              "The integral of the product differs with SIMD");
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * \brief Test the operations on narrowband SpectrumValues defined over a
+ * wideband SpectrumModel, which only process the occupied bands.
+ */
+class SpectrumValueOccupiedBandsTestCase : public TestCase
+{
+  public:
+    SpectrumValueOccupiedBandsTestCase();
+    ~SpectrumValueOccupiedBandsTestCase() override;
+
+  private:
+    void DoRun() override;
+};
+
+SpectrumValueOccupiedBandsTestCase::SpectrumValueOccupiedBandsTestCase()
+    : TestCase("Operations on the occupied bands of narrowband SpectrumValues")
+{
+}
+
+SpectrumValueOccupiedBandsTestCase::~SpectrumValueOccupiedBandsTestCase()
+{
+}
+
+void
+SpectrumValueOccupiedBandsTestCase::DoRun()
+{
+    // a 160 MHz model and two 20 MHz models, in its first and last 20 MHz
+    std::vector<double> wideFreqs;
+    for (uint32_t i = 0; i < 512; i++)
+    {
+        wideFreqs.push_back(5.0e9 + (i + 0.5) * 312.5e3);
+    }
+    Ptr<SpectrumModel> wide = Create<SpectrumModel>(wideFreqs);
+    std::vector<Ptr<SpectrumModel>> narrow;
+    for (double start : {5.0e9, 5.14e9})
+    {
+        std::vector<double> freqs;
+        for (uint32_t i = 0; i < 64; i++)
+        {
+            freqs.push_back(start + (i + 0.5) * 312.5e3);
+        }
+        narrow.push_back(Create<SpectrumModel>(freqs));
+    }
+
+    SpectrumValue all(wide);
+    NS_TEST_ASSERT_MSG_EQ(all.GetOccupiedBandsEnd(), 0, "A new value should not be occupied");
+    std::vector<Ptr<SpectrumValue>> converted;
+    for (uint32_t n = 0; n < narrow.size(); n++)
+    {
+        Ptr<SpectrumValue> psd = Create<SpectrumValue>(narrow[n]);
+        (*psd) = 1e-12 * (n + 1);
+        SpectrumConverter converter(narrow[n], wide);
+        Ptr<SpectrumValue> widePsd = converter.Convert(psd);
+        NS_TEST_ASSERT_MSG_EQ(widePsd->GetOccupiedBandsEnd() - widePsd->GetOccupiedBandsBegin(),
+                              64,
+                              "The converted PSD should only occupy 20 MHz");
+        const SpectrumValue& constPsd = *widePsd;
+        for (uint32_t i = 0; i < wideFreqs.size(); i++)
+        {
+            bool occupied = (i >= widePsd->GetOccupiedBandsBegin() &&
+                             i < widePsd->GetOccupiedBandsEnd());
+            NS_TEST_EXPECT_MSG_EQ_TOL(constPsd[i],
+                                      (occupied ? 1e-12 * (n + 1) : 0),
+                                      1e-18,
+                                      "Unexpected converted value of band " << i);
+        }
+        NS_TEST_EXPECT_MSG_EQ_TOL(Integral(*widePsd),
+                                  Integral(*psd),
+                                  Integral(*psd) * TOLERANCE,
+                                  "The conversion should keep the power");
+        all += *widePsd;
+        converted.push_back(widePsd);
+    }
+    NS_TEST_EXPECT_MSG_EQ(all.GetOccupiedBandsBegin(), 0, "Unexpected first occupied band");
+    NS_TEST_EXPECT_MSG_EQ(all.GetOccupiedBandsEnd(), 512, "Unexpected last occupied band");
+    NS_TEST_EXPECT_MSG_EQ_TOL(Sum(all),
+                              64 * 3e-12,
+                              1e-20,
+                              "Unexpected sum of the signals");
+
+    // the product is restricted to the bands occupied by both values
+    SpectrumValue product = all;
+    product *= *converted[1];
+    NS_TEST_EXPECT_MSG_EQ(product.GetOccupiedBandsBegin(),
+                          converted[1]->GetOccupiedBandsBegin(),
+                          "Unexpected first occupied band of the product");
+    const SpectrumValue& constProduct = product;
+    NS_TEST_EXPECT_MSG_EQ(constProduct[0], 0, "The product should be zero out of the signal");
+    NS_TEST_EXPECT_MSG_EQ_TOL(SumOfProduct(all, *converted[1]),
+                              Sum(product),
+                              Sum(product) * TOLERANCE,
+                              "Unexpected sum of the product");
+    SpectrumValue expected(wide);
+    expected.MultiplyAdd(all, *converted[1]);
+    NS_TEST_ASSERT_MSG_SPECTRUM_VALUE_EQ_TOL(product, expected, 0, "Unexpected fused product");
+
+    // removing a signal keeps the range, which may be shrunk
+    all -= *converted[0];
+    all.ShrinkOccupiedBands();
+    NS_TEST_EXPECT_MSG_EQ(all.GetOccupiedBandsBegin(),
+                          converted[1]->GetOccupiedBandsBegin(),
+                          "The first signal should be removed");
+
+    // a non-const access may modify any band
+    product[0] = 1;
+    NS_TEST_EXPECT_MSG_EQ(product.GetOccupiedBandsBegin(), 0, "All the bands may be occupied");
+    NS_TEST_EXPECT_MSG_EQ(product.GetOccupiedBandsEnd(), 512, "All the bands may be occupied");
+    product = 0;
+    NS_TEST_EXPECT_MSG_EQ(product.GetOccupiedBandsEnd(), 0, "No band should be occupied");
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -269,6 +485,9 @@ SpectrumValueTestSuite::SpectrumValueTestSuite()
     v1rs3[4] = v1[1];
     tv1rs3 = v1 >> 3;
     AddTestCase(new SpectrumValueTestCase(tv1rs3, v1rs3, "tv1rs3 = v1 >> 3"), TestCase::QUICK);
+
+    AddTestCase(new SpectrumValueFusedTestCase, TestCase::QUICK);
+    AddTestCase(new SpectrumValueOccupiedBandsTestCase, TestCase::QUICK);
 }
 
 /**
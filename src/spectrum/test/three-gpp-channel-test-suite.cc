@@ -107,7 +107,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm(Ptr<ThreeGppChannelModel> ch
         channelModel->GetChannel(txMob, rxMob, txAntenna, rxAntenna);
 
     double channelNorm = 0;
-    uint8_t numTotClusters = channelMatrix->m_channel.at(0).at(0).size();
+    uint8_t numTotClusters = channelMatrix->m_channel.GetNumPages();
     for (uint8_t cIndex = 0; cIndex < numTotClusters; cIndex++)
     {
         double clusterNorm = 0;
@@ -116,8 +116,7 @@ ThreeGppChannelMatrixComputationTest::DoComputeNorm(Ptr<ThreeGppChannelModel> ch
             for (uint32_t uIndex = 0; uIndex < rxAntennaElements; uIndex++)
             {
                 clusterNorm +=
-                    std::pow(std::abs(channelMatrix->m_channel.at(uIndex).at(sIndex).at(cIndex)),
-                             2);
+                    std::pow(std::abs(channelMatrix->m_channel(uIndex, sIndex, cIndex)), 2);
             }
         }
         channelNorm += clusterNorm;
@@ -190,11 +189,11 @@ ThreeGppChannelMatrixComputationTest::DoRun()
 
     // check the channel matrix dimensions
     NS_TEST_ASSERT_MSG_EQ(
-        channelMatrix->m_channel.at(0).size(),
+        channelMatrix->m_channel.GetNumCols(),
         txAntennaElements[0] * txAntennaElements[1],
         "The second dimension of H should be equal to the number of tx antenna elements");
     NS_TEST_ASSERT_MSG_EQ(
-        channelMatrix->m_channel.size(),
+        channelMatrix->m_channel.GetNumRows(),
         rxAntennaElements[0] * rxAntennaElements[1],
         "The first dimension of H should be equal to the number of rx antenna elements");
 
@@ -684,6 +683,248 @@ ThreeGppSpectrumPropagationLossModelTest::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the ComplexMatrixArray class used to store the channel matrices.
+ * 1) check the layout of the elements
+ * 2) check the products of the matrices with a vector on each side, and the
+ * dot products, against direct computations
+ */
+class ComplexMatrixArrayTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ComplexMatrixArrayTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+};
+
+ComplexMatrixArrayTest::ComplexMatrixArrayTest()
+    : TestCase("Check the layout and the products of the ComplexMatrixArray class")
+{
+}
+
+void
+ComplexMatrixArrayTest::DoRun()
+{
+    // the numbers of rows are not all multiples of the unrolling of the dot product
+    for (std::size_t numRows : {1, 4, 7, 16})
+    {
+        const std::size_t numCols = 3;
+        const std::size_t numPages = 5;
+        ComplexMatrixArray array(numRows, numCols, numPages);
+        NS_TEST_ASSERT_MSG_EQ(array.GetSize(),
+                              numRows * numCols * numPages,
+                              "Unexpected number of elements");
+
+        PhasedArrayModel::ComplexVector left(numRows);
+        PhasedArrayModel::ComplexVector right(numCols);
+        for (std::size_t row = 0; row < numRows; row++)
+        {
+            left[row] = std::complex<double>(std::cos(row * 0.7), std::sin(row * 1.3));
+        }
+        for (std::size_t col = 0; col < numCols; col++)
+        {
+            right[col] = std::complex<double>(0.5 - col, std::cos(col * 0.4));
+        }
+        for (std::size_t page = 0; page < numPages; page++)
+        {
+            for (std::size_t col = 0; col < numCols; col++)
+            {
+                for (std::size_t row = 0; row < numRows; row++)
+                {
+                    array(row, col, page) =
+                        std::complex<double>(std::sin(row + 2.0 * col + 5.0 * page), 0.1 * row);
+                }
+            }
+        }
+
+        // the columns of a page are stored one after the other
+        for (std::size_t page = 0; page < numPages; page++)
+        {
+            const std::complex<double>* element = array.GetPagePtr(page);
+            for (std::size_t col = 0; col < numCols; col++)
+            {
+                for (std::size_t row = 0; row < numRows; row++)
+                {
+                    NS_TEST_ASSERT_MSG_EQ((*element == array(row, col, page)),
+                                          true,
+                                          "Unexpected layout of element (" << row << ", " << col
+                                                                           << ", " << page << ")");
+                    element++;
+                }
+            }
+        }
+
+        PhasedArrayModel::ComplexVector forms = array.ComputeBilinearForms(left, right);
+        NS_TEST_ASSERT_MSG_EQ(forms.size(), numPages, "Unexpected number of products");
+        for (std::size_t page = 0; page < numPages; page++)
+        {
+            std::complex<double> expected(0, 0);
+            for (std::size_t row = 0; row < numRows; row++)
+            {
+                for (std::size_t col = 0; col < numCols; col++)
+                {
+                    expected += left[row] * array(row, col, page) * right[col];
+                }
+            }
+            double error = std::abs(forms[page] - expected);
+            NS_TEST_EXPECT_MSG_LT(error,
+                                  1e-12 * (1 + std::abs(expected)),
+                                  "Unexpected product for page " << page << " with " << numRows
+                                                                 << " rows");
+
+            std::complex<double> dot =
+                ComplexMatrixArray::DotProduct(left.data(), array.GetPagePtr(page), numRows);
+            std::complex<double> expectedDot(0, 0);
+            for (std::size_t row = 0; row < numRows; row++)
+            {
+                expectedDot += left[row] * array(row, 0, page);
+            }
+            error = std::abs(dot - expectedDot);
+            NS_TEST_EXPECT_MSG_LT(error,
+                                  1e-12 * (1 + std::abs(expectedDot)),
+                                  "Unexpected dot product with " << numRows << " elements");
+        }
+    }
+}
+
+/**
+ * \ingroup spectrum-tests
+ *
+ * Test case for the precomputation of the channels of the ThreeGppChannelModel
+ * class. It checks that the channels of all the links are generated again when
+ * their update period expires, before they are requested, and that the
+ * channels do not depend on the number of threads computing them.
+ */
+class ThreeGppPrecomputedChannelTest : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     */
+    ThreeGppPrecomputedChannelTest();
+
+  private:
+    /**
+     * Build the test scenario
+     */
+    void DoRun() override;
+
+    /**
+     * Simulate a node linked to three other nodes, with the channels
+     * precomputed by the given number of threads.
+     *
+     * \param threads the number of threads computing the channel coefficients
+     * \return the channel matrices of the links requested after two update periods
+     */
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> GetChannels(uint32_t threads);
+};
+
+ThreeGppPrecomputedChannelTest::ThreeGppPrecomputedChannelTest()
+    : TestCase("Check the precomputation of the channels of the ThreeGppChannelModel class")
+{
+}
+
+std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>>
+ThreeGppPrecomputedChannelTest::GetChannels(uint32_t threads)
+{
+    const Time updatePeriod = MilliSeconds(10);
+
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28.0e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<AlwaysLosChannelConditionModel>()));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(updatePeriod));
+    channelModel->SetAttribute("PrecomputeChannels", BooleanValue(true));
+    channelModel->SetAttribute("PrecomputeThreads", UintegerValue(threads));
+    channelModel->AssignStreams(1);
+
+    NodeContainer nodes;
+    nodes.Create(4);
+    std::vector<Ptr<MobilityModel>> mobility;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i < nodes.GetN(); i++)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(i == 0 ? Vector(0.0, 0.0, 10.0) : Vector(50.0 * i, 10.0 * i, 1.5));
+        nodes.Get(i)->AggregateObject(mob);
+        mobility.push_back(mob);
+        antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>(
+            "NumColumns",
+            UintegerValue(2),
+            "NumRows",
+            UintegerValue(2),
+            "AntennaElement",
+            PointerValue(CreateObject<IsotropicAntennaModel>())));
+    }
+
+    // request the channels of all the links at the beginning of the simulation
+    for (uint32_t i = 1; i < nodes.GetN(); i++)
+    {
+        channelModel->GetChannel(mobility[0], mobility[i], antennas[0], antennas[i]);
+    }
+
+    // request them again in the middle of the third update period: they must
+    // have been generated at its beginning
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> channels;
+    Simulator::Schedule(2.5 * updatePeriod, [&]() {
+        for (uint32_t i = 1; i < nodes.GetN(); i++)
+        {
+            Ptr<const ThreeGppChannelModel::ChannelMatrix> channel =
+                channelModel->GetChannel(mobility[0], mobility[i], antennas[0], antennas[i]);
+            Time generatedTime = channel->m_generatedTime;
+            NS_TEST_EXPECT_MSG_EQ(generatedTime,
+                                  2 * updatePeriod,
+                                  "The channel was not generated when its update period expired");
+            channels.push_back(channel);
+        }
+    });
+
+    // the channels are generated periodically, the simulation has to be stopped
+    Simulator::Stop(3.5 * updatePeriod);
+    Simulator::Run();
+    Simulator::Destroy();
+    return channels;
+}
+
+void
+ThreeGppPrecomputedChannelTest::DoRun()
+{
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> reference = GetChannels(1);
+    NS_TEST_ASSERT_MSG_EQ(reference.size(), 3, "Unexpected number of channels");
+
+    std::vector<Ptr<const ThreeGppChannelModel::ChannelMatrix>> channels = GetChannels(3);
+    NS_TEST_ASSERT_MSG_EQ(channels.size(), 3, "Unexpected number of channels");
+    for (std::size_t i = 0; i < channels.size(); i++)
+    {
+        const ThreeGppChannelModel::Complex3DVector& expected = reference[i]->m_channel;
+        const ThreeGppChannelModel::Complex3DVector& actual = channels[i]->m_channel;
+        NS_TEST_ASSERT_MSG_EQ(actual.GetSize(), expected.GetSize(), "The channels differ in size");
+        for (std::size_t page = 0; page < actual.GetNumPages(); page++)
+        {
+            for (std::size_t col = 0; col < actual.GetNumCols(); col++)
+            {
+                for (std::size_t row = 0; row < actual.GetNumRows(); row++)
+                {
+                    bool equal = (actual(row, col, page) == expected(row, col, page));
+                    NS_TEST_EXPECT_MSG_EQ(equal,
+                                          true,
+                                          "The channel depends on the number of threads");
+                }
+            }
+        }
+    }
+}
+
 /**
  * \ingroup spectrum-tests
  *
@@ -704,6 +945,8 @@ ThreeGppChannelTestSuite::ThreeGppChannelTestSuite()
     AddTestCase(new ThreeGppChannelMatrixComputationTest, TestCase::QUICK);
     AddTestCase(new ThreeGppChannelMatrixUpdateTest, TestCase::QUICK);
     AddTestCase(new ThreeGppSpectrumPropagationLossModelTest, TestCase::QUICK);
+    AddTestCase(new ComplexMatrixArrayTest, TestCase::QUICK);
+    AddTestCase(new ThreeGppPrecomputedChannelTest, TestCase::QUICK);
 }
 
 /// Static variable for test initialization
@@ -0,0 +1,308 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * DualPI2, the Dual-Queue Coupled AQM of RFC 9332
+ */
+
+#include "dual-pi2-queue-disc.h"
+
+#include "ns3/double.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("DualPi2QueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(DualPi2QueueDisc);
+
+TypeId
+DualPi2QueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::DualPi2QueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<DualPi2QueueDisc>()
+            .AddAttribute("MaxSize",
+                          "The maximum number of packets accepted by this queue disc",
+                          QueueSizeValue(QueueSize("10000p")),
+                          MakeQueueSizeAccessor(&QueueDisc::SetMaxSize, &QueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("Target",
+                          "Target queuing delay of the Classic queue",
+                          TimeValue(MilliSeconds(15)),
+                          MakeTimeAccessor(&DualPi2QueueDisc::m_target),
+                          MakeTimeChecker())
+            .AddAttribute("Tupdate",
+                          "Time period to update the base probability",
+                          TimeValue(MilliSeconds(16)),
+                          MakeTimeAccessor(&DualPi2QueueDisc::m_tUpdate),
+                          MakeTimeChecker())
+            .AddAttribute("Alpha",
+                          "Integral gain of the PI controller, in Hz",
+                          DoubleValue(0.16),
+                          MakeDoubleAccessor(&DualPi2QueueDisc::m_alpha),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("Beta",
+                          "Proportional gain of the PI controller, in Hz",
+                          DoubleValue(3.2),
+                          MakeDoubleAccessor(&DualPi2QueueDisc::m_beta),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("K",
+                          "Coupling factor between the L4S and the Classic probabilities",
+                          DoubleValue(2),
+                          MakeDoubleAccessor(&DualPi2QueueDisc::m_k),
+                          MakeDoubleChecker<double>(0))
+            .AddAttribute("StepThreshold",
+                          "Sojourn time above which L4S packets are marked",
+                          TimeValue(MilliSeconds(1)),
+                          MakeTimeAccessor(&DualPi2QueueDisc::m_stepThreshold),
+                          MakeTimeChecker())
+            .AddAttribute("Tshift",
+                          "Time shift of the L4S queue in the time-shifted FIFO scheduler",
+                          TimeValue(MilliSeconds(30)),
+                          MakeTimeAccessor(&DualPi2QueueDisc::m_tShift),
+                          MakeTimeChecker())
+            .AddAttribute("MaxClassicProbability",
+                          "Classic probability above which the L4S packets are dropped "
+                          "instead of marked (overload)",
+                          DoubleValue(0.25),
+                          MakeDoubleAccessor(&DualPi2QueueDisc::m_maxClassicP),
+                          MakeDoubleChecker<double>(0, 1));
+    return tid;
+}
+
+DualPi2QueueDisc::DualPi2QueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
+      m_baseProb(0)
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = CreateObject<UniformRandomVariable>();
+}
+
+DualPi2QueueDisc::~DualPi2QueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+DualPi2QueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_uv = nullptr;
+    m_updateEvent.Cancel();
+    QueueDisc::DoDispose();
+}
+
+double
+DualPi2QueueDisc::GetBaseProbability() const
+{
+    return m_baseProb;
+}
+
+double
+DualPi2QueueDisc::GetClassicProbability() const
+{
+    return m_baseProb * m_baseProb;
+}
+
+double
+DualPi2QueueDisc::GetCoupledProbability() const
+{
+    return std::min(m_k * m_baseProb, 1.0);
+}
+
+int64_t
+DualPi2QueueDisc::AssignStreams(int64_t stream)
+{
+    NS_LOG_FUNCTION(this << stream);
+    m_uv->SetStream(stream);
+    return 1;
+}
+
+bool
+DualPi2QueueDisc::IsL4s(Ptr<QueueDiscItem> item) const
+{
+    uint8_t tosByte = 0;
+    // ECT(1) or CE
+    return item->GetUint8Value(QueueItem::IP_DSFIELD, tosByte) && (tosByte & 0x1);
+}
+
+Time
+DualPi2QueueDisc::GetHeadSojournTime(std::size_t index) const
+{
+    Ptr<const QueueDiscItem> item = GetInternalQueue(index)->Peek();
+    if (!item)
+    {
+        return Seconds(0);
+    }
+    return Simulator::Now() - item->GetTimeStamp();
+}
+
+std::size_t
+DualPi2QueueDisc::SelectQueue() const
+{
+    if (GetInternalQueue(CLASSIC_QUEUE)->IsEmpty())
+    {
+        return L4S_QUEUE;
+    }
+    if (GetInternalQueue(L4S_QUEUE)->IsEmpty())
+    {
+        return CLASSIC_QUEUE;
+    }
+    // serve the L4S queue unless its head packet, shifted by Tshift, is younger
+    // than the head packet of the Classic queue
+    return GetHeadSojournTime(L4S_QUEUE) + m_tShift >= GetHeadSojournTime(CLASSIC_QUEUE)
+               ? L4S_QUEUE
+               : CLASSIC_QUEUE;
+}
+
+bool
+DualPi2QueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    if (GetCurrentSize() + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Queue full -- dropping pkt");
+        DropBeforeEnqueue(item, FORCED_DROP);
+        return false;
+    }
+
+    std::size_t index = IsL4s(item) ? L4S_QUEUE : CLASSIC_QUEUE;
+    NS_LOG_LOGIC("Enqueueing into the " << (index == L4S_QUEUE ? "L4S" : "Classic") << " queue");
+
+    // If Queue::Enqueue fails, QueueDisc::DropBeforeEnqueue is called by the
+    // internal queue because QueueDisc::AddInternalQueue sets the trace callback
+    return GetInternalQueue(index)->Enqueue(item);
+}
+
+Ptr<QueueDiscItem>
+DualPi2QueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    while (!GetInternalQueue(L4S_QUEUE)->IsEmpty() || !GetInternalQueue(CLASSIC_QUEUE)->IsEmpty())
+    {
+        std::size_t index = SelectQueue();
+        Ptr<QueueDiscItem> item = GetInternalQueue(index)->Dequeue();
+        NS_ASSERT_MSG(item, "Dequeue null, but internal queue not empty");
+
+        double pC = GetClassicProbability();
+
+        if (index == L4S_QUEUE)
+        {
+            if (pC > m_maxClassicP && m_uv->GetValue() < pC)
+            {
+                // overload: L4S packets are dropped as the Classic packets
+                DropAfterDequeue(item, UNFORCED_L4S_DROP);
+                continue;
+            }
+            if (Simulator::Now() - item->GetTimeStamp() > m_stepThreshold)
+            {
+                Mark(item, STEP_MARK);
+            }
+            else if (m_uv->GetValue() < GetCoupledProbability())
+            {
+                Mark(item, UNFORCED_L4S_MARK);
+            }
+            return item;
+        }
+
+        if (m_uv->GetValue() < pC && !Mark(item, UNFORCED_CLASSIC_MARK))
+        {
+            DropAfterDequeue(item, UNFORCED_CLASSIC_DROP);
+            continue;
+        }
+        return item;
+    }
+
+    NS_LOG_LOGIC("Queue empty");
+    return nullptr;
+}
+
+void
+DualPi2QueueDisc::CalculateP()
+{
+    NS_LOG_FUNCTION(this);
+
+    // the queuing delay is the largest sojourn time of the head packets
+    Time qDelay = std::max(GetHeadSojournTime(L4S_QUEUE), GetHeadSojournTime(CLASSIC_QUEUE));
+
+    m_baseProb += m_alpha * (qDelay - m_target).GetSeconds() +
+                  m_beta * (qDelay - m_prevQDelay).GetSeconds();
+    m_baseProb = std::clamp(m_baseProb, 0.0, 1.0);
+    m_prevQDelay = qDelay;
+
+    NS_LOG_DEBUG("Queue delay " << qDelay.As(Time::MS) << " base probability " << m_baseProb);
+
+    m_updateEvent = Simulator::Schedule(m_tUpdate, &DualPi2QueueDisc::CalculateP, this);
+}
+
+bool
+DualPi2QueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("DualPi2QueueDisc cannot have classes");
+        return false;
+    }
+
+    if (GetNPacketFilters() > 0)
+    {
+        NS_LOG_ERROR("DualPi2QueueDisc cannot have packet filters");
+        return false;
+    }
+
+    if (GetNInternalQueues() == 0)
+    {
+        // the L4S and the Classic queues share the limit of the queue disc
+        ObjectFactory factory;
+        factory.SetTypeId("ns3::DropTailQueue<QueueDiscItem>");
+        factory.Set("MaxSize", QueueSizeValue(GetMaxSize()));
+        AddInternalQueue(factory.Create<InternalQueue>());
+        AddInternalQueue(factory.Create<InternalQueue>());
+    }
+
+    if (GetNInternalQueues() != 2)
+    {
+        NS_LOG_ERROR("DualPi2QueueDisc needs 2 internal queues");
+        return false;
+    }
+
+    if (m_tUpdate.IsZero())
+    {
+        NS_LOG_ERROR("The update period of the base probability must be positive");
+        return false;
+    }
+
+    return true;
+}
+
+void
+DualPi2QueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+    m_baseProb = 0;
+    m_prevQDelay = Seconds(0);
+    m_updateEvent = Simulator::Schedule(m_tUpdate, &DualPi2QueueDisc::CalculateP, this);
+}
+
+} // namespace ns3
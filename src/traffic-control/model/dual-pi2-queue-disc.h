@@ -0,0 +1,163 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * DualPI2, the Dual-Queue Coupled AQM of RFC 9332
+ */
+
+#ifndef DUAL_PI2_QUEUE_DISC_H
+#define DUAL_PI2_QUEUE_DISC_H
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/queue-disc.h"
+#include "ns3/random-variable-stream.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Implements the DualPI2 Dual-Queue Coupled AQM (RFC 9332)
+ *
+ * Packets whose ECN field is ECT(1) or CE are enqueued into the L4S queue
+ * (internal queue 0), all the other packets into the Classic queue (internal
+ * queue 1). A PI controller periodically updates a base probability p'
+ * based on the largest sojourn time of the packets at the head of the two
+ * queues. Classic packets are dropped, or marked if ECN-capable, with
+ * probability p_C = p'^2, while L4S packets are marked with probability
+ * p_CL = K * p', or whenever their sojourn time exceeds a step threshold.
+ * The queues are served by a time-shifted FIFO scheduler.
+ */
+class DualPi2QueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    /**
+     * \brief DualPi2QueueDisc Constructor
+     */
+    DualPi2QueueDisc();
+
+    /**
+     * \brief DualPi2QueueDisc Destructor
+     */
+    ~DualPi2QueueDisc() override;
+
+    /**
+     * \brief Get the base probability computed by the PI controller
+     * \return the base probability p'
+     */
+    double GetBaseProbability() const;
+    /**
+     * \brief Get the probability of dropping or marking a Classic packet
+     * \return p_C
+     */
+    double GetClassicProbability() const;
+    /**
+     * \brief Get the coupled probability of marking an L4S packet
+     * \return p_CL
+     */
+    double GetCoupledProbability() const;
+    /**
+     * Assign a fixed random variable stream number to the random variables
+     * used by this model.  Return the number of streams (possibly zero) that
+     * have been assigned.
+     *
+     * \param stream first stream index to use
+     * \return the number of stream indices assigned by this model
+     */
+    int64_t AssignStreams(int64_t stream);
+
+    /// Index of the internal queue storing the L4S packets
+    static constexpr std::size_t L4S_QUEUE = 0;
+    /// Index of the internal queue storing the Classic packets
+    static constexpr std::size_t CLASSIC_QUEUE = 1;
+
+    // Reasons for dropping packets
+    static constexpr const char* UNFORCED_CLASSIC_DROP =
+        "Unforced drop in classic queue"; //!< Early probability drops of Classic packets
+    static constexpr const char* UNFORCED_L4S_DROP =
+        "Unforced drop in L4S queue"; //!< Drops of L4S packets in overload
+    static constexpr const char* FORCED_DROP = "Forced drop"; //!< Drops due to queue limit
+    // Reasons for marking packets
+    static constexpr const char* UNFORCED_CLASSIC_MARK =
+        "Unforced mark in classic queue"; //!< Early probability marks of Classic packets
+    static constexpr const char* UNFORCED_L4S_MARK =
+        "Unforced mark in L4S queue"; //!< Coupled probability marks of L4S packets
+    static constexpr const char* STEP_MARK =
+        "Step marking threshold exceeded mark"; //!< Marks of L4S packets above the threshold
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief Check whether a packet belongs to the L4S queue
+     * \param item the packet
+     * \return true if the ECN field of the packet is ECT(1) or CE
+     */
+    bool IsL4s(Ptr<QueueDiscItem> item) const;
+
+    /**
+     * \brief Get the sojourn time of the packet at the head of an internal queue
+     * \param index the index of the internal queue
+     * \return the sojourn time (zero if the queue is empty)
+     */
+    Time GetHeadSojournTime(std::size_t index) const;
+
+    /**
+     * \brief Select the internal queue to serve according to the time-shifted
+     *        FIFO scheduler
+     * \return the index of the internal queue to serve
+     */
+    std::size_t SelectQueue() const;
+
+    /**
+     * \brief Periodically update the base probability
+     */
+    void CalculateP();
+
+    // ** Variables supplied by user
+    Time m_target;        //!< Target queuing delay of the Classic queue
+    Time m_tUpdate;       //!< Period of the update of the base probability
+    double m_alpha;       //!< Integral gain of the PI controller, in Hz
+    double m_beta;        //!< Proportional gain of the PI controller, in Hz
+    double m_k;           //!< Coupling factor
+    Time m_stepThreshold; //!< Sojourn time above which L4S packets are marked
+    Time m_tShift;        //!< Time shift of the L4S queue in the scheduler
+    double m_maxClassicP; //!< Classic probability above which L4S packets are dropped
+
+    // ** Variables maintained by DualPI2
+    double m_baseProb;               //!< The base probability p'
+    Time m_prevQDelay;               //!< The queuing delay at the previous update
+    EventId m_updateEvent;           //!< Event updating the base probability
+    Ptr<UniformRandomVariable> m_uv; //!< Rng stream
+};
+
+} // namespace ns3
+
+#endif /* DUAL_PI2_QUEUE_DISC_H */
@@ -0,0 +1,84 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "edt-tag.h"
+
+namespace ns3
+{
+
+NS_OBJECT_ENSURE_REGISTERED(EdtTag);
+
+EdtTag::EdtTag()
+{
+}
+
+EdtTag::EdtTag(Time departure)
+    : m_departure(departure)
+{
+}
+
+void
+EdtTag::SetDepartureTime(Time departure)
+{
+    m_departure = departure;
+}
+
+Time
+EdtTag::GetDepartureTime() const
+{
+    return m_departure;
+}
+
+TypeId
+EdtTag::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::EdtTag")
+                            .SetParent<Tag>()
+                            .SetGroupName("TrafficControl")
+                            .AddConstructor<EdtTag>();
+    return tid;
+}
+
+TypeId
+EdtTag::GetInstanceTypeId() const
+{
+    return GetTypeId();
+}
+
+uint32_t
+EdtTag::GetSerializedSize() const
+{
+    return sizeof(int64_t);
+}
+
+void
+EdtTag::Serialize(TagBuffer i) const
+{
+    i.WriteU64(static_cast<uint64_t>(m_departure.GetTimeStep()));
+}
+
+void
+EdtTag::Deserialize(TagBuffer i)
+{
+    m_departure = TimeStep(i.ReadU64());
+}
+
+void
+EdtTag::Print(std::ostream& os) const
+{
+    os << "EDT = " << m_departure.As(Time::S);
+}
+
+} // namespace ns3
@@ -0,0 +1,86 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef EDT_TAG_H
+#define EDT_TAG_H
+
+#include "ns3/nstime.h"
+#include "ns3/tag.h"
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Packet tag carrying the Earliest Departure Time (EDT) of a packet
+ *
+ * A transport protocol pacing its packets may tag them with the time before
+ * which they should not leave the host, instead of holding them back with a
+ * timer (this is the equivalent of the skb->tstamp field set by the Linux
+ * TCP stack when the fq qdisc is in use). Queue discs honoring the tag, such
+ * as FqQueueDisc, do not dequeue a packet before its departure time.
+ */
+class EdtTag : public Tag
+{
+  public:
+    EdtTag();
+
+    /**
+     * \brief Constructor
+     * \param departure the earliest departure time
+     */
+    EdtTag(Time departure);
+
+    /**
+     * \brief Set the earliest departure time
+     * \param departure the earliest departure time
+     */
+    void SetDepartureTime(Time departure);
+
+    /**
+     * \brief Get the earliest departure time
+     * \return the earliest departure time
+     */
+    Time GetDepartureTime() const;
+
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+
+    // inherited function, no need to doc.
+    TypeId GetInstanceTypeId() const override;
+
+    // inherited function, no need to doc.
+    uint32_t GetSerializedSize() const override;
+
+    // inherited function, no need to doc.
+    void Serialize(TagBuffer i) const override;
+
+    // inherited function, no need to doc.
+    void Deserialize(TagBuffer i) override;
+
+    // inherited function, no need to doc.
+    void Print(std::ostream& os) const override;
+
+  private:
+    Time m_departure; //!< the earliest departure time carried by the tag
+};
+
+} // namespace ns3
+
+#endif /* EDT_TAG_H */
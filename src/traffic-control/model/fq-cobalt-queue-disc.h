@@ -28,12 +28,11 @@
 #ifndef FQ_COBALT_QUEUE_DISC
 #define FQ_COBALT_QUEUE_DISC
 
+#include "fq-flow-table.h"
+
 #include "ns3/object-factory.h"
 #include "ns3/queue-disc.h"
 
-#include <list>
-#include <map>
-
 namespace ns3
 {
 
@@ -85,12 +84,13 @@ class FqCobaltFlow : public QueueDiscClass
      */
     void IncreaseDeficit(int32_t deficit);
     /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
+     * \brief Set the flow table that holds the status of this flow
+     * \param table the flow table of the queue disc
+     * \param flow the index of this flow in the flow table
      */
-    void SetStatus(FlowStatus status);
+    void SetFlowTable(const FqFlowTable* table, uint32_t flow);
     /**
-     * \brief Get the status of this flow
+     * \brief Get the status of this flow, i.e., the list of the flow table it is in
      * \return the status of this flow
      */
     FlowStatus GetStatus() const;
@@ -106,9 +106,10 @@ class FqCobaltFlow : public QueueDiscClass
     uint32_t GetIndex() const;
 
   private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
+    int32_t m_deficit;          //!< the deficit for this flow
+    const FqFlowTable* m_table; //!< the flow table that holds the status of this flow
+    uint32_t m_flow;            //!< the index of this flow in the flow table
+    uint32_t m_index;           //!< the index for this flow
 };
 
 /**
@@ -165,15 +166,6 @@ class FqCobaltQueueDisc : public QueueDisc
      */
     uint32_t FqCobaltDrop();
 
-    /**
-     * Compute the index of the queue for the flow having the given flowHash,
-     * according to the set associative hash approach.
-     *
-     * \param flowHash the hash of the flow 5-tuple
-     * \return the index of the queue for the given flow
-     */
-    uint32_t SetAssociativeHash(uint32_t flowHash);
-
     std::string m_interval;   //!< CoDel interval attribute
     std::string m_target;     //!< CoDel target attribute
     uint32_t m_quantum;       //!< Deficit assigned to flows at each round
@@ -190,11 +182,7 @@ class FqCobaltQueueDisc : public QueueDisc
     double m_Pdrop;       //!< Drop Probability
     Time m_blueThreshold; //!< Threshold to enable blue enhancement
 
-    std::list<Ptr<FqCobaltFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqCobaltFlow>> m_oldFlows; //!< The list of old flows
-
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqFlowTable m_flowTable; //!< Flow table, with the lists of new and old flows
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
@@ -22,12 +22,11 @@
 #ifndef FQ_CODEL_QUEUE_DISC
 #define FQ_CODEL_QUEUE_DISC
 
+#include "fq-flow-table.h"
+
 #include "ns3/object-factory.h"
 #include "ns3/queue-disc.h"
 
-#include <list>
-#include <map>
-
 namespace ns3
 {
 
@@ -79,12 +78,13 @@ class FqCoDelFlow : public QueueDiscClass
      */
     void IncreaseDeficit(int32_t deficit);
     /**
-     * \brief Set the status for this flow
-     * \param status the status for this flow
+     * \brief Set the flow table that holds the status of this flow
+     * \param table the flow table of the queue disc
+     * \param flow the index of this flow in the flow table
      */
-    void SetStatus(FlowStatus status);
+    void SetFlowTable(const FqFlowTable* table, uint32_t flow);
     /**
-     * \brief Get the status of this flow
+     * \brief Get the status of this flow, i.e., the list of the flow table it is in
      * \return the status of this flow
      */
     FlowStatus GetStatus() const;
@@ -100,9 +100,10 @@ class FqCoDelFlow : public QueueDiscClass
     uint32_t GetIndex() const;
 
   private:
-    int32_t m_deficit;   //!< the deficit for this flow
-    FlowStatus m_status; //!< the status of this flow
-    uint32_t m_index;    //!< the index for this flow
+    int32_t m_deficit;          //!< the deficit for this flow
+    const FqFlowTable* m_table; //!< the flow table that holds the status of this flow
+    uint32_t m_flow;            //!< the index of this flow in the flow table
+    uint32_t m_index;           //!< the index for this flow
 };
 
 /**
@@ -160,14 +161,6 @@ class FqCoDelQueueDisc : public QueueDisc
     uint32_t FqCoDelDrop();
 
     bool m_useEcn; //!< True if ECN is used (packets are marked instead of being dropped)
-    /**
-     * Compute the index of the queue for the flow having the given flowHash,
-     * according to the set associative hash approach.
-     *
-     * \param flowHash the hash of the flow 5-tuple
-     * \return the index of the queue for the given flow
-     */
-    uint32_t SetAssociativeHash(uint32_t flowHash);
 
     std::string m_interval;          //!< CoDel interval attribute
     std::string m_target;            //!< CoDel target attribute
@@ -180,11 +173,7 @@ class FqCoDelQueueDisc : public QueueDisc
     bool m_enableSetAssociativeHash; //!< whether to enable set associative hash
     bool m_useL4s; //!< True if L4S is used (ECT1 packets are marked at CE threshold)
 
-    std::list<Ptr<FqCoDelFlow>> m_newFlows; //!< The list of new flows
-    std::list<Ptr<FqCoDelFlow>> m_oldFlows; //!< The list of old flows
-
-    std::map<uint32_t, uint32_t> m_flowsIndices; //!< Map with the index of class for each flow
-    std::map<uint32_t, uint32_t> m_tags;         //!< Tags used by set associative hash
+    FqFlowTable m_flowTable; //!< Flow table, with the lists of new and old flows
 
     ObjectFactory m_flowFactory;      //!< Factory to create a new flow
     ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
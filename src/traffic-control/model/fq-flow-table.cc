@@ -0,0 +1,150 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "fq-flow-table.h"
+
+#include "ns3/assert.h"
+#include "ns3/log.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqFlowTable");
+
+FqFlowTable::FqFlowTable()
+{
+    NS_LOG_FUNCTION(this);
+    SetNBuckets(0);
+}
+
+void
+FqFlowTable::SetNBuckets(uint32_t n)
+{
+    NS_LOG_FUNCTION(this << n);
+    m_bucketFlows.assign(n, NO_FLOW);
+    m_tags.assign(n, 0);
+    m_next.clear();
+    m_lists.clear();
+    for (uint8_t list = NONE; list <= OLD_FLOWS; list++)
+    {
+        m_head[list] = NO_FLOW;
+        m_tail[list] = NO_FLOW;
+    }
+}
+
+uint32_t
+FqFlowTable::GetNBuckets() const
+{
+    return m_bucketFlows.size();
+}
+
+void
+FqFlowTable::AddFlow(uint32_t bucket, uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << bucket << flow);
+    NS_ASSERT(bucket < m_bucketFlows.size() && m_bucketFlows[bucket] == NO_FLOW);
+
+    m_bucketFlows[bucket] = flow;
+    if (flow >= m_next.size())
+    {
+        m_next.resize(flow + 1, NO_FLOW);
+        m_lists.resize(flow + 1, NONE);
+    }
+}
+
+uint32_t
+FqFlowTable::SetAssociativeHash(uint32_t flowHash, uint32_t setWays)
+{
+    NS_LOG_FUNCTION(this << flowHash << setWays);
+
+    uint32_t h = (flowHash % m_bucketFlows.size());
+    uint32_t innerHash = h % setWays;
+    uint32_t outerHash = h - innerHash;
+
+    for (uint32_t i = outerHash; i < outerHash + setWays; i++)
+    {
+        uint32_t flow = m_bucketFlows[i];
+
+        if (flow == NO_FLOW || m_tags[i] == flowHash || m_lists[flow] == NONE)
+        {
+            // this queue has not been created yet or is associated with this flow
+            // or is inactive, hence we can use it
+            m_tags[i] = flowHash;
+            return i;
+        }
+    }
+
+    // all the queues of the set are used. Use the first queue of the set
+    m_tags[outerHash] = flowHash;
+    return outerHash;
+}
+
+void
+FqFlowTable::PushBack(FlowList list, uint32_t flow)
+{
+    NS_LOG_FUNCTION(this << +list << flow);
+    NS_ASSERT(list != NONE && list != THROTTLED &&
+              (m_lists[flow] == NONE || m_lists[flow] == THROTTLED));
+
+    m_next[flow] = NO_FLOW;
+    m_lists[flow] = list;
+    if (m_tail[list] == NO_FLOW)
+    {
+        m_head[list] = flow;
+    }
+    else
+    {
+        m_next[m_tail[list]] = flow;
+    }
+    m_tail[list] = flow;
+}
+
+void
+FqFlowTable::PopFront(FlowList list)
+{
+    NS_LOG_FUNCTION(this << +list);
+    NS_ASSERT(list != NONE && list != THROTTLED && m_head[list] != NO_FLOW);
+
+    uint32_t flow = m_head[list];
+    m_head[list] = m_next[flow];
+    if (m_head[list] == NO_FLOW)
+    {
+        m_tail[list] = NO_FLOW;
+    }
+    m_next[flow] = NO_FLOW;
+    m_lists[flow] = NONE;
+}
+
+void
+FqFlowTable::ThrottleFront(FlowList list)
+{
+    NS_LOG_FUNCTION(this << +list);
+
+    uint32_t flow = m_head[list];
+    PopFront(list);
+    m_lists[flow] = THROTTLED;
+}
+
+void
+FqFlowTable::MoveFront(FlowList from, FlowList to)
+{
+    NS_LOG_FUNCTION(this << +from << +to);
+
+    uint32_t flow = m_head[from];
+    PopFront(from);
+    PushBack(to, flow);
+}
+
+} // namespace ns3
@@ -0,0 +1,181 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef FQ_FLOW_TABLE_H
+#define FQ_FLOW_TABLE_H
+
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Flow table of the flow queueing queue discs (FqCoDel, FqPie, FqCobalt, Fq)
+ *
+ * The table maps each of the hash buckets into which packets are classified
+ * to the flow queue serving it, identified by the index of the queue disc
+ * class of the flow, and keeps the lists of new and old flows scheduled by
+ * the deficit round robin. Buckets, tags and list links are stored in flat
+ * arrays indexed by bucket or flow: the lists are intrusive, hence
+ * activating, rotating or deactivating a flow neither allocates memory nor
+ * dereferences the flow objects.
+ */
+class FqFlowTable
+{
+  public:
+    /// Index denoting the absence of a flow
+    static constexpr uint32_t NO_FLOW = std::numeric_limits<uint32_t>::max();
+
+    /// The scheduling lists a flow can belong to
+    enum FlowList : uint8_t
+    {
+        NONE = 0,  //!< the flow is inactive
+        NEW_FLOWS, //!< the list of new flows
+        OLD_FLOWS, //!< the list of old flows
+        THROTTLED  //!< the flow is active, but out of the lists until a given time
+    };
+
+    FqFlowTable();
+
+    /**
+     * \brief Set the number of hash buckets, removing all the flows
+     * \param n the number of buckets
+     */
+    void SetNBuckets(uint32_t n);
+
+    /**
+     * \brief Get the number of hash buckets
+     * \return the number of buckets
+     */
+    uint32_t GetNBuckets() const;
+
+    /**
+     * \brief Get the flow serving a bucket
+     * \param bucket the bucket
+     * \return the index of the flow, or NO_FLOW if no flow has been created yet
+     */
+    uint32_t GetFlow(uint32_t bucket) const;
+
+    /**
+     * \brief Record the flow created to serve a bucket
+     * \param bucket the bucket
+     * \param flow the index of the (inactive) flow
+     */
+    void AddFlow(uint32_t bucket, uint32_t flow);
+
+    /**
+     * Compute the bucket of the flow having the given flowHash, according to
+     * the set associative hash approach: a flow uses the first bucket of its
+     * set that has no flow yet, is tagged with the flow hash or is inactive,
+     * or the first bucket of the set if none is available.
+     *
+     * \param flowHash the hash of the flow 5-tuple
+     * \param setWays the size of a set of buckets
+     * \return the bucket for the given flow
+     */
+    uint32_t SetAssociativeHash(uint32_t flowHash, uint32_t setWays);
+
+    /**
+     * \brief Check whether a list is empty
+     * \param list the list
+     * \return true if the list is empty
+     */
+    bool IsEmpty(FlowList list) const;
+
+    /**
+     * \brief Get the first flow of a list
+     * \param list the (non-empty) list
+     * \return the index of the first flow
+     */
+    uint32_t Front(FlowList list) const;
+
+    /**
+     * \brief Append an inactive or throttled flow to a list
+     * \param list the list
+     * \param flow the index of the flow
+     */
+    void PushBack(FlowList list, uint32_t flow);
+
+    /**
+     * \brief Remove the first flow of a list, which becomes inactive
+     * \param list the (non-empty) list
+     */
+    void PopFront(FlowList list);
+
+    /**
+     * \brief Remove the first flow of a list, which becomes throttled
+     *
+     * A throttled flow keeps its bucket, as an active one, until it is
+     * appended to a list again.
+     *
+     * \param list the (non-empty) list
+     */
+    void ThrottleFront(FlowList list);
+
+    /**
+     * \brief Move the first flow of a list to the end of a list (possibly the same)
+     * \param from the (non-empty) list
+     * \param to the destination list
+     */
+    void MoveFront(FlowList from, FlowList to);
+
+    /**
+     * \brief Get the list a flow belongs to
+     * \param flow the index of the flow
+     * \return the list of the flow, NONE if the flow is inactive or THROTTLED
+     * if it is throttled
+     */
+    FlowList GetList(uint32_t flow) const;
+
+  private:
+    std::vector<uint32_t> m_bucketFlows; //!< Index of the flow of each bucket
+    std::vector<uint32_t> m_tags;        //!< Flow hash of each bucket (set associative hash)
+    std::vector<uint32_t> m_next;        //!< Next flow in the list of each flow
+    std::vector<FlowList> m_lists;       //!< List of each flow
+    uint32_t m_head[THROTTLED];          //!< First flow of each list
+    uint32_t m_tail[THROTTLED];          //!< Last flow of each list
+};
+
+inline uint32_t
+FqFlowTable::GetFlow(uint32_t bucket) const
+{
+    return m_bucketFlows[bucket];
+}
+
+inline bool
+FqFlowTable::IsEmpty(FlowList list) const
+{
+    return m_head[list] == NO_FLOW;
+}
+
+inline uint32_t
+FqFlowTable::Front(FlowList list) const
+{
+    return m_head[list];
+}
+
+inline FqFlowTable::FlowList
+FqFlowTable::GetList(uint32_t flow) const
+{
+    return m_lists[flow];
+}
+
+} // namespace ns3
+
+#endif /* FQ_FLOW_TABLE_H */
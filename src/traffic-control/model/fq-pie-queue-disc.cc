@@ -52,7 +52,8 @@ FqPieFlow::GetTypeId()
 
 FqPieFlow::FqPieFlow()
     : m_deficit(0),
-      m_status(INACTIVE),
+      m_table(nullptr),
+      m_flow(0),
       m_index(0)
 {
     NS_LOG_FUNCTION(this);
@@ -85,17 +86,30 @@ FqPieFlow::IncreaseDeficit(int32_t deficit)
 }
 
 void
-FqPieFlow::SetStatus(FlowStatus status)
+FqPieFlow::SetFlowTable(const FqFlowTable* table, uint32_t flow)
 {
-    NS_LOG_FUNCTION(this);
-    m_status = status;
+    NS_LOG_FUNCTION(this << table << flow);
+    m_table = table;
+    m_flow = flow;
 }
 
 FqPieFlow::FlowStatus
 FqPieFlow::GetStatus() const
 {
     NS_LOG_FUNCTION(this);
-    return m_status;
+    if (!m_table)
+    {
+        return INACTIVE;
+    }
+    switch (m_table->GetList(m_flow))
+    {
+    case FqFlowTable::NEW_FLOWS:
+        return NEW_FLOW;
+    case FqFlowTable::OLD_FLOWS:
+        return OLD_FLOW;
+    default:
+        return INACTIVE;
+    }
 }
 
 void
@@ -255,36 +269,6 @@ FqPieQueueDisc::GetQuantum() const
     return m_quantum;
 }
 
-uint32_t
-FqPieQueueDisc::SetAssociativeHash(uint32_t flowHash)
-{
-    NS_LOG_FUNCTION(this << flowHash);
-
-    uint32_t h = (flowHash % m_flows);
-    uint32_t innerHash = h % m_setWays;
-    uint32_t outerHash = h - innerHash;
-
-    for (uint32_t i = outerHash; i < outerHash + m_setWays; i++)
-    {
-        auto it = m_flowsIndices.find(i);
-
-        if (it == m_flowsIndices.end() ||
-            (m_tags.find(i) != m_tags.end() && m_tags[i] == flowHash) ||
-            StaticCast<FqPieFlow>(GetQueueDiscClass(it->second))->GetStatus() ==
-                FqPieFlow::INACTIVE)
-        {
-            // this queue has not been created yet or is associated with this flow
-            // or is inactive, hence we can use it
-            m_tags[i] = flowHash;
-            return i;
-        }
-    }
-
-    // all the queues of the set are used. Use the first queue of the set
-    m_tags[outerHash] = flowHash;
-    return outerHash;
-}
-
 bool
 FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 {
@@ -315,7 +299,7 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
 
     if (m_enableSetAssociativeHash)
     {
-        h = SetAssociativeHash(flowHash);
+        h = m_flowTable.SetAssociativeHash(flowHash, m_setWays);
     }
     else
     {
@@ -323,7 +307,8 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
     }
 
     Ptr<FqPieFlow> flow;
-    if (m_flowsIndices.find(h) == m_flowsIndices.end())
+    uint32_t index = m_flowTable.GetFlow(h);
+    if (index == FqFlowTable::NO_FLOW)
     {
         NS_LOG_DEBUG("Creating a new flow queue with index " << h);
         flow = m_flowFactory.Create<FqPieFlow>();
@@ -341,23 +326,24 @@ FqPieQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
         flow->SetIndex(h);
         AddQueueDiscClass(flow);
 
-        m_flowsIndices[h] = GetNQueueDiscClasses() - 1;
+        index = GetNQueueDiscClasses() - 1;
+        m_flowTable.AddFlow(h, index);
+        flow->SetFlowTable(&m_flowTable, index);
     }
     else
     {
-        flow = StaticCast<FqPieFlow>(GetQueueDiscClass(m_flowsIndices[h]));
+        flow = StaticCast<FqPieFlow>(GetQueueDiscClass(index));
     }
 
-    if (flow->GetStatus() == FqPieFlow::INACTIVE)
+    if (m_flowTable.GetList(index) == FqFlowTable::NONE)
     {
-        flow->SetStatus(FqPieFlow::NEW_FLOW);
         flow->SetDeficit(m_quantum);
-        m_newFlows.push_back(flow);
+        m_flowTable.PushBack(FqFlowTable::NEW_FLOWS, index);
     }
 
     flow->GetQueueDisc()->Enqueue(item);
 
-    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << m_flowsIndices[h]);
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << index);
 
     if (GetCurrentSize() > GetMaxSize())
     {
@@ -380,17 +366,16 @@ FqPieQueueDisc::DoDequeue()
     {
         bool found = false;
 
-        while (!found && !m_newFlows.empty())
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
         {
-            flow = m_newFlows.front();
+            flow = StaticCast<FqPieFlow>(
+                GetQueueDiscClass(m_flowTable.Front(FqFlowTable::NEW_FLOWS)));
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for new flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_flowTable.MoveFront(FqFlowTable::NEW_FLOWS, FqFlowTable::OLD_FLOWS);
             }
             else
             {
@@ -399,16 +384,16 @@ FqPieQueueDisc::DoDequeue()
             }
         }
 
-        while (!found && !m_oldFlows.empty())
+        while (!found && !m_flowTable.IsEmpty(FqFlowTable::OLD_FLOWS))
         {
-            flow = m_oldFlows.front();
+            flow = StaticCast<FqPieFlow>(
+                GetQueueDiscClass(m_flowTable.Front(FqFlowTable::OLD_FLOWS)));
 
             if (flow->GetDeficit() <= 0)
             {
                 NS_LOG_DEBUG("Increase deficit for old flow index " << flow->GetIndex());
                 flow->IncreaseDeficit(m_quantum);
-                m_oldFlows.push_back(flow);
-                m_oldFlows.pop_front();
+                m_flowTable.MoveFront(FqFlowTable::OLD_FLOWS, FqFlowTable::OLD_FLOWS);
             }
             else
             {
@@ -428,16 +413,13 @@ FqPieQueueDisc::DoDequeue()
         if (!item)
         {
             NS_LOG_DEBUG("Could not get a packet from the selected flow queue");
-            if (!m_newFlows.empty())
+            if (!m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
             {
-                flow->SetStatus(FqPieFlow::OLD_FLOW);
-                m_oldFlows.push_back(flow);
-                m_newFlows.pop_front();
+                m_flowTable.MoveFront(FqFlowTable::NEW_FLOWS, FqFlowTable::OLD_FLOWS);
             }
             else
             {
-                flow->SetStatus(FqPieFlow::INACTIVE);
-                m_oldFlows.pop_front();
+                m_flowTable.PopFront(FqFlowTable::OLD_FLOWS);
             }
         }
         else
@@ -511,6 +493,8 @@ FqPieQueueDisc::InitializeParams()
 {
     NS_LOG_FUNCTION(this);
 
+    m_flowTable.SetNBuckets(m_flows);
+
     m_flowFactory.SetTypeId("ns3::FqPieFlow");
 
     m_queueDiscFactory.SetTypeId("ns3::PieQueueDisc");
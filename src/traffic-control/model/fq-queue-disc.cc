@@ -0,0 +1,439 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ, the Fair Queue packet scheduler
+ *
+ * This implementation is based on the linux kernel code (sch_fq.c)
+ * by Eric Dumazet.
+ */
+
+#include "fq-queue-disc.h"
+
+#include "edt-tag.h"
+
+#include "ns3/log.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("FqQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(FqFlow);
+
+TypeId
+FqFlow::GetTypeId()
+{
+    static TypeId tid = TypeId("ns3::FqFlow")
+                            .SetParent<QueueDiscClass>()
+                            .SetGroupName("TrafficControl")
+                            .AddConstructor<FqFlow>();
+    return tid;
+}
+
+FqFlow::FqFlow()
+    : m_deficit(0),
+      m_index(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FqFlow::~FqFlow()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqFlow::SetDeficit(uint32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit = deficit;
+}
+
+int32_t
+FqFlow::GetDeficit() const
+{
+    NS_LOG_FUNCTION(this);
+    return m_deficit;
+}
+
+void
+FqFlow::IncreaseDeficit(int32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit += deficit;
+}
+
+void
+FqFlow::SetIndex(uint32_t index)
+{
+    NS_LOG_FUNCTION(this);
+    m_index = index;
+}
+
+uint32_t
+FqFlow::GetIndex() const
+{
+    return m_index;
+}
+
+NS_OBJECT_ENSURE_REGISTERED(FqQueueDisc);
+
+TypeId
+FqQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::FqQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<FqQueueDisc>()
+            .AddAttribute("MaxSize",
+                          "The maximum number of packets accepted by this queue disc",
+                          QueueSizeValue(QueueSize("10000p")),
+                          MakeQueueSizeAccessor(&QueueDisc::SetMaxSize, &QueueDisc::GetMaxSize),
+                          MakeQueueSizeChecker())
+            .AddAttribute("FlowLimit",
+                          "The maximum number of packets queued by a single flow",
+                          UintegerValue(100),
+                          MakeUintegerAccessor(&FqQueueDisc::m_flowLimit),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Flows",
+                          "The number of queues into which the incoming packets are "
+                          "classified. It should be several times the number of flows "
+                          "queued at the same time, which then rarely share a queue",
+                          UintegerValue(8192),
+                          MakeUintegerAccessor(&FqQueueDisc::m_flows),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("SetWays",
+                          "The size of a set of queues (used by set associative hash)",
+                          UintegerValue(8),
+                          MakeUintegerAccessor(&FqQueueDisc::m_setWays),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Perturbation",
+                          "The salt used as an additional input to the hash function used to "
+                          "classify packets",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&FqQueueDisc::m_perturbation),
+                          MakeUintegerChecker<uint32_t>())
+            .AddAttribute("Horizon",
+                          "Packets whose earliest departure time is farther than this "
+                          "value in the future are dropped",
+                          TimeValue(Seconds(10)),
+                          MakeTimeAccessor(&FqQueueDisc::m_horizon),
+                          MakeTimeChecker());
+    return tid;
+}
+
+FqQueueDisc::FqQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::MULTIPLE_QUEUES, QueueSizeUnit::PACKETS),
+      m_quantum(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+FqQueueDisc::~FqQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+FqQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Remove(m_watchdog);
+    m_flowTable.SetNBuckets(0);
+    m_throttled.clear();
+    QueueDisc::DoDispose();
+}
+
+void
+FqQueueDisc::SetQuantum(uint32_t quantum)
+{
+    NS_LOG_FUNCTION(this << quantum);
+    m_quantum = quantum;
+}
+
+uint32_t
+FqQueueDisc::GetQuantum() const
+{
+    return m_quantum;
+}
+
+uint32_t
+FqQueueDisc::GetNThrottledFlows() const
+{
+    return m_throttled.size();
+}
+
+Time
+FqQueueDisc::GetDepartureTime(Ptr<const QueueDiscItem> item)
+{
+    EdtTag tag;
+    if (item->GetPacket()->PeekPacketTag(tag))
+    {
+        return tag.GetDepartureTime();
+    }
+    return Time(0);
+}
+
+bool
+FqQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    uint32_t flowHash;
+
+    if (GetNPacketFilters() == 0)
+    {
+        flowHash = item->Hash(m_perturbation);
+    }
+    else
+    {
+        int32_t ret = Classify(item);
+
+        if (ret != PacketFilter::PF_NO_MATCH)
+        {
+            flowHash = static_cast<uint32_t>(ret);
+        }
+        else
+        {
+            NS_LOG_ERROR("No filter has been able to classify this packet, drop it.");
+            DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+            return false;
+        }
+    }
+
+    if (GetCurrentSize() + item > GetMaxSize())
+    {
+        NS_LOG_LOGIC("Queue disc limit exceeded -- dropping packet");
+        DropBeforeEnqueue(item, OVERLIMIT_DROP);
+        return false;
+    }
+
+    if (GetDepartureTime(item) > Simulator::Now() + m_horizon)
+    {
+        NS_LOG_LOGIC("Departure time beyond the horizon -- dropping packet");
+        DropBeforeEnqueue(item, HORIZON_DROP);
+        return false;
+    }
+
+    uint32_t h = m_flowTable.SetAssociativeHash(flowHash, m_setWays);
+
+    Ptr<FqFlow> flow;
+    uint32_t index = m_flowTable.GetFlow(h);
+    if (index == FqFlowTable::NO_FLOW)
+    {
+        NS_LOG_DEBUG("Creating a new flow queue with index " << h);
+        flow = m_flowFactory.Create<FqFlow>();
+        Ptr<QueueDisc> qd = m_queueDiscFactory.Create<QueueDisc>();
+        qd->Initialize();
+        flow->SetQueueDisc(qd);
+        flow->SetIndex(h);
+        AddQueueDiscClass(flow);
+
+        index = GetNQueueDiscClasses() - 1;
+        m_flowTable.AddFlow(h, index);
+    }
+    else
+    {
+        flow = StaticCast<FqFlow>(GetQueueDiscClass(index));
+    }
+
+    // the child queue disc calls DropBeforeEnqueue if the flow limit is exceeded
+    if (!flow->GetQueueDisc()->Enqueue(item))
+    {
+        return false;
+    }
+
+    if (m_flowTable.GetList(index) == FqFlowTable::NONE)
+    {
+        flow->SetDeficit(m_quantum);
+        m_flowTable.PushBack(FqFlowTable::NEW_FLOWS, index);
+    }
+
+    NS_LOG_DEBUG("Packet enqueued into flow " << h << "; flow index " << index);
+
+    return true;
+}
+
+void
+FqQueueDisc::UnthrottleFlows()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+    auto it = m_throttled.begin();
+    while (it != m_throttled.end() && it->first <= now)
+    {
+        NS_LOG_DEBUG("Flow index " << it->second << " is no longer throttled");
+        m_flowTable.PushBack(FqFlowTable::OLD_FLOWS, it->second);
+        it = m_throttled.erase(it);
+    }
+}
+
+Ptr<QueueDiscItem>
+FqQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    UnthrottleFlows();
+
+    Time now = Simulator::Now();
+    Ptr<FqFlow> flow;
+    Ptr<QueueDiscItem> item;
+
+    do
+    {
+        FqFlowTable::FlowList head;
+
+        if (!m_flowTable.IsEmpty(FqFlowTable::NEW_FLOWS))
+        {
+            head = FqFlowTable::NEW_FLOWS;
+        }
+        else if (!m_flowTable.IsEmpty(FqFlowTable::OLD_FLOWS))
+        {
+            head = FqFlowTable::OLD_FLOWS;
+        }
+        else
+        {
+            NS_LOG_DEBUG("No flow found to dequeue a packet");
+            if (!m_throttled.empty())
+            {
+                Time next = m_throttled.begin()->first;
+                if (m_watchdog.IsExpired() || TimeStep(m_watchdog.GetTs()) > next)
+                {
+                    Simulator::Remove(m_watchdog);
+                    m_watchdog = Simulator::Schedule(next - now, &QueueDisc::Run, this);
+                    NS_LOG_LOGIC("Waking event scheduled at " << next.As(Time::S));
+                }
+            }
+            return nullptr;
+        }
+
+        uint32_t index = m_flowTable.Front(head);
+        flow = StaticCast<FqFlow>(GetQueueDiscClass(index));
+
+        if (flow->GetDeficit() <= 0)
+        {
+            NS_LOG_DEBUG("Increase deficit for flow index " << flow->GetIndex());
+            flow->IncreaseDeficit(m_quantum);
+            m_flowTable.MoveFront(head, FqFlowTable::OLD_FLOWS);
+            continue;
+        }
+
+        Ptr<const QueueDiscItem> next = flow->GetQueueDisc()->Peek();
+
+        if (!next)
+        {
+            NS_LOG_DEBUG("The selected flow queue " << flow->GetIndex() << " is empty");
+            // force a pass through old flows to prevent starvation
+            if (head == FqFlowTable::NEW_FLOWS && !m_flowTable.IsEmpty(FqFlowTable::OLD_FLOWS))
+            {
+                m_flowTable.MoveFront(head, FqFlowTable::OLD_FLOWS);
+            }
+            else
+            {
+                m_flowTable.PopFront(head);
+            }
+            continue;
+        }
+
+        Time departure = GetDepartureTime(next);
+        if (departure > now)
+        {
+            NS_LOG_DEBUG("Throttle flow " << flow->GetIndex() << " until "
+                                          << departure.As(Time::S));
+            m_throttled.emplace(departure, index);
+            m_flowTable.ThrottleFront(head);
+            continue;
+        }
+
+        item = flow->GetQueueDisc()->Dequeue();
+    } while (!item);
+
+    NS_LOG_DEBUG("Dequeued packet " << item->GetPacket());
+    flow->IncreaseDeficit(item->GetSize() * -1);
+
+    // The departure time is meaningless past this queue disc (e.g., in the
+    // queue disc of another host)
+    EdtTag tag;
+    item->GetPacket()->RemovePacketTag(tag);
+
+    return item;
+}
+
+bool
+FqQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNQueueDiscClasses() > 0)
+    {
+        NS_LOG_ERROR("FqQueueDisc cannot have classes");
+        return false;
+    }
+
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("FqQueueDisc cannot have internal queues");
+        return false;
+    }
+
+    // we are at initialization time. If the user has not set a quantum value,
+    // set the quantum to the MTU of the device (if any)
+    if (!m_quantum)
+    {
+        Ptr<NetDeviceQueueInterface> ndqi = GetNetDeviceQueueInterface();
+        Ptr<NetDevice> dev;
+        // if the NetDeviceQueueInterface object is aggregated to a
+        // NetDevice, get the MTU of such NetDevice
+        if (ndqi && (dev = ndqi->GetObject<NetDevice>()))
+        {
+            m_quantum = dev->GetMtu();
+            NS_LOG_DEBUG("Setting the quantum to the MTU of the device: " << m_quantum);
+        }
+
+        if (!m_quantum)
+        {
+            NS_LOG_ERROR("The quantum parameter cannot be null");
+            return false;
+        }
+    }
+
+    if (m_flows % m_setWays != 0)
+    {
+        NS_LOG_ERROR("The number of queues must be an integer multiple of the size "
+                     "of the set of queues used by set associative hash");
+        return false;
+    }
+
+    return true;
+}
+
+void
+FqQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+
+    m_flowTable.SetNBuckets(m_flows);
+
+    m_flowFactory.SetTypeId("ns3::FqFlow");
+
+    m_queueDiscFactory.SetTypeId("ns3::FifoQueueDisc");
+    m_queueDiscFactory.Set("MaxSize",
+                           QueueSizeValue(QueueSize(QueueSizeUnit::PACKETS, m_flowLimit)));
+}
+
+} // namespace ns3
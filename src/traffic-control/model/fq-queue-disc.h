@@ -0,0 +1,189 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * FQ, the Fair Queue packet scheduler
+ *
+ * This implementation is based on the linux kernel code (sch_fq.c)
+ * by Eric Dumazet.
+ */
+
+#ifndef FQ_QUEUE_DISC_H
+#define FQ_QUEUE_DISC_H
+
+#include "fq-flow-table.h"
+
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/object-factory.h"
+#include "ns3/queue-disc.h"
+
+#include <map>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A flow queue used by the Fq queue disc
+ */
+class FqFlow : public QueueDiscClass
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FqFlow constructor
+     */
+    FqFlow();
+
+    ~FqFlow() override;
+
+    /**
+     * \brief Set the deficit for this flow
+     * \param deficit the deficit for this flow
+     */
+    void SetDeficit(uint32_t deficit);
+    /**
+     * \brief Get the deficit for this flow
+     * \return the deficit for this flow
+     */
+    int32_t GetDeficit() const;
+    /**
+     * \brief Increase the deficit for this flow
+     * \param deficit the amount by which the deficit is to be increased
+     */
+    void IncreaseDeficit(int32_t deficit);
+    /**
+     * \brief Set the index for this flow
+     * \param index the index for this flow
+     */
+    void SetIndex(uint32_t index);
+    /**
+     * \brief Get the index of this flow
+     * \return the index of this flow
+     */
+    uint32_t GetIndex() const;
+
+  private:
+    int32_t m_deficit; //!< the deficit for this flow
+    uint32_t m_index;  //!< the index for this flow
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A Fair Queue packet scheduler honoring the earliest departure time of packets
+ *
+ * Packets are classified into flows, which are served in a deficit round
+ * robin fashion. Packets carrying an EdtTag are not dequeued before their
+ * earliest departure time: a flow whose head packet is not yet due is
+ * removed from the round robin and stored in a set of throttled flows ordered
+ * by departure time, until the first of them is due. Hence, pacing many flows
+ * through this queue disc costs O(log n) per packet, n being the number of
+ * throttled flows, and requires a single timer for the whole queue disc.
+ * The EdtTag is removed from the packets leaving the queue disc.
+ *
+ * Flows are mapped to queues with a set associative hash, so that two flows
+ * share a queue (and one throttles the other) only when all the queues of
+ * their set are busy.
+ */
+class FqQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief FqQueueDisc constructor
+     */
+    FqQueueDisc();
+
+    ~FqQueueDisc() override;
+
+    /**
+     * \brief Set the quantum value.
+     *
+     * \param quantum The number of bytes each queue gets to dequeue on each round of the scheduling
+     * algorithm
+     */
+    void SetQuantum(uint32_t quantum);
+
+    /**
+     * \brief Get the quantum value.
+     *
+     * \returns The number of bytes each queue gets to dequeue on each round of the scheduling
+     * algorithm
+     */
+    uint32_t GetQuantum() const;
+
+    /**
+     * \brief Get the number of flows currently throttled
+     *
+     * \returns the number of flows waiting for the departure time of their head packet
+     */
+    uint32_t GetNThrottledFlows() const;
+
+    // Reasons for dropping packets
+    static constexpr const char* UNCLASSIFIED_DROP =
+        "Unclassified drop"; //!< No packet filter able to classify packet
+    static constexpr const char* OVERLIMIT_DROP = "Overlimit drop"; //!< Overlimit dropped packets
+    static constexpr const char* HORIZON_DROP =
+        "Beyond horizon drop"; //!< Departure time too far in the future
+
+  protected:
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief Get the earliest departure time of the given item
+     * \param item the item
+     * \return the departure time carried by the EdtTag of the item, if any, or zero
+     */
+    static Time GetDepartureTime(Ptr<const QueueDiscItem> item);
+
+    /**
+     * \brief Move the throttled flows whose departure time has come to the old flows list
+     */
+    void UnthrottleFlows();
+
+    uint32_t m_quantum;      //!< Deficit assigned to flows at each round
+    uint32_t m_flows;        //!< Number of flow queues
+    uint32_t m_setWays;      //!< size of a set of queues (used by set associative hash)
+    uint32_t m_flowLimit;    //!< Max number of packets queued by a single flow
+    uint32_t m_perturbation; //!< hash perturbation value
+    Time m_horizon;          //!< Max distance in the future of the departure time of a packet
+
+    FqFlowTable m_flowTable;                   //!< Flow table, with the lists of new and old flows
+    std::multimap<Time, uint32_t> m_throttled; //!< Indices of the throttled flows, by departure time
+
+    EventId m_watchdog; //!< Event waking up the queue disc when the first throttled flow is due
+
+    ObjectFactory m_flowFactory;      //!< Factory to create a new flow
+    ObjectFactory m_queueDiscFactory; //!< Factory to create a new queue
+};
+
+} // namespace ns3
+
+#endif /* FQ_QUEUE_DISC_H */
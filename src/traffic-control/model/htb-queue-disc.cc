@@ -0,0 +1,601 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * HTB, the Hierarchical Token Bucket packet scheduler
+ *
+ * This implementation is based on the linux kernel code (sch_htb.c)
+ * by Martin Devera.
+ */
+
+#include "htb-queue-disc.h"
+
+#include "ns3/log.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/uinteger.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("HtbQueueDisc");
+
+NS_OBJECT_ENSURE_REGISTERED(HtbClass);
+
+TypeId
+HtbClass::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HtbClass")
+            .SetParent<QueueDiscClass>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<HtbClass>()
+            .AddAttribute("Parent",
+                          "The parent class. If null, this is a root class, which cannot borrow",
+                          PointerValue(),
+                          MakePointerAccessor(&HtbClass::m_parent),
+                          MakePointerChecker<HtbClass>())
+            .AddAttribute("Rate",
+                          "The rate guaranteed to this class",
+                          DataRateValue(DataRate("1Mbps")),
+                          MakeDataRateAccessor(&HtbClass::m_rate),
+                          MakeDataRateChecker())
+            .AddAttribute("Ceil",
+                          "The maximum rate this class can send at by borrowing from its "
+                          "ancestors. If null, it is set to the rate of the class",
+                          DataRateValue(DataRate("0bps")),
+                          MakeDataRateAccessor(&HtbClass::m_ceil),
+                          MakeDataRateChecker())
+            .AddAttribute("Burst",
+                          "The size of the bucket of tokens, in bytes",
+                          UintegerValue(1600),
+                          MakeUintegerAccessor(&HtbClass::m_burst),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Cburst",
+                          "The size of the bucket of ceil tokens, in bytes",
+                          UintegerValue(1600),
+                          MakeUintegerAccessor(&HtbClass::m_cburst),
+                          MakeUintegerChecker<uint32_t>(1))
+            .AddAttribute("Quantum",
+                          "The number of bytes a leaf class can send per DRR round. If null, "
+                          "it is set to a tenth of the bytes sent per second at the rate of "
+                          "the class, between 1000 and 200000 bytes",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&HtbClass::m_quantum),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+HtbClass::HtbClass()
+    : m_deficit(0),
+      m_active(false),
+      m_mode(CAN_SEND),
+      m_level(0),
+      m_nActive(0),
+      m_index(0),
+      m_waiting(false)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HtbClass::~HtbClass()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HtbClass::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    m_parent = nullptr;
+    m_children.clear();
+    QueueDiscClass::DoDispose();
+}
+
+void
+HtbClass::SetParent(Ptr<HtbClass> parent)
+{
+    NS_LOG_FUNCTION(this << parent);
+    m_parent = parent;
+}
+
+Ptr<HtbClass>
+HtbClass::GetParent() const
+{
+    return m_parent;
+}
+
+DataRate
+HtbClass::GetRate() const
+{
+    return m_rate;
+}
+
+DataRate
+HtbClass::GetCeil() const
+{
+    return m_ceil.GetBitRate() > 0 ? m_ceil : m_rate;
+}
+
+uint32_t
+HtbClass::GetQuantum() const
+{
+    if (m_quantum > 0)
+    {
+        return m_quantum;
+    }
+    return std::clamp<uint64_t>(m_rate.GetBitRate() / 80, 1000, 200000);
+}
+
+int32_t
+HtbClass::GetDeficit() const
+{
+    return m_deficit;
+}
+
+void
+HtbClass::IncreaseDeficit(int32_t deficit)
+{
+    NS_LOG_FUNCTION(this << deficit);
+    m_deficit += deficit;
+}
+
+bool
+HtbClass::IsActive() const
+{
+    return m_active;
+}
+
+void
+HtbClass::SetActive(bool active)
+{
+    NS_LOG_FUNCTION(this << active);
+    m_active = active;
+}
+
+void
+HtbClass::ResetTokens()
+{
+    NS_LOG_FUNCTION(this);
+    m_tokens = m_rate.CalculateBytesTxTime(m_burst);
+    m_ctokens = GetCeil().CalculateBytesTxTime(m_cburst);
+    m_checkPoint = Simulator::Now();
+    m_deficit = 0;
+}
+
+void
+HtbClass::UpdateTokens(Time now)
+{
+    Time delta = now - m_checkPoint;
+    if (delta.IsStrictlyPositive())
+    {
+        m_tokens = std::min(m_tokens + delta, m_rate.CalculateBytesTxTime(m_burst));
+        m_ctokens = std::min(m_ctokens + delta, GetCeil().CalculateBytesTxTime(m_cburst));
+        m_checkPoint = now;
+    }
+}
+
+HtbClass::ClassMode
+HtbClass::GetMode() const
+{
+    if (m_ctokens.IsStrictlyNegative())
+    {
+        return CANT_SEND;
+    }
+    if (m_tokens.IsStrictlyNegative())
+    {
+        return MAY_BORROW;
+    }
+    return CAN_SEND;
+}
+
+Time
+HtbClass::GetModeChangeDelay() const
+{
+    if (m_ctokens.IsStrictlyNegative())
+    {
+        return Time(0) - m_ctokens;
+    }
+    if (m_tokens.IsStrictlyNegative())
+    {
+        return Time(0) - m_tokens;
+    }
+    return Time(0);
+}
+
+void
+HtbClass::Charge(uint32_t bytes, bool tokens)
+{
+    NS_LOG_FUNCTION(this << bytes << tokens);
+    if (tokens)
+    {
+        m_tokens -= m_rate.CalculateBytesTxTime(bytes);
+    }
+    m_ctokens -= GetCeil().CalculateBytesTxTime(bytes);
+}
+
+NS_OBJECT_ENSURE_REGISTERED(HtbQueueDisc);
+
+TypeId
+HtbQueueDisc::GetTypeId()
+{
+    static TypeId tid =
+        TypeId("ns3::HtbQueueDisc")
+            .SetParent<QueueDisc>()
+            .SetGroupName("TrafficControl")
+            .AddConstructor<HtbQueueDisc>()
+            .AddAttribute("DefaultClass",
+                          "The index of the leaf class of the packets that are not "
+                          "classified by any packet filter",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&HtbQueueDisc::m_defaultClass),
+                          MakeUintegerChecker<uint32_t>());
+    return tid;
+}
+
+HtbQueueDisc::HtbQueueDisc()
+    : QueueDisc(QueueDiscSizePolicy::NO_LIMITS),
+      m_nActive(0)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+HtbQueueDisc::~HtbQueueDisc()
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+HtbQueueDisc::DoDispose()
+{
+    NS_LOG_FUNCTION(this);
+    Simulator::Remove(m_watchdog);
+    for (auto& level : m_levels)
+    {
+        level.clear();
+    }
+    m_waitQueue.clear();
+    m_classes.clear();
+    QueueDisc::DoDispose();
+}
+
+std::size_t
+HtbQueueDisc::GetNActiveClasses() const
+{
+    return m_nActive;
+}
+
+bool
+HtbQueueDisc::DoEnqueue(Ptr<QueueDiscItem> item)
+{
+    NS_LOG_FUNCTION(this << item);
+
+    uint32_t index = m_defaultClass;
+    int32_t ret = Classify(item);
+
+    if (ret != PacketFilter::PF_NO_MATCH)
+    {
+        NS_LOG_DEBUG("Packet filters returned " << ret);
+        index = ret;
+    }
+
+    if (index >= GetNQueueDiscClasses())
+    {
+        NS_LOG_DEBUG("No class found for the packet");
+        DropBeforeEnqueue(item, UNCLASSIFIED_DROP);
+        return false;
+    }
+
+    Ptr<HtbClass> leaf = StaticCast<HtbClass>(GetQueueDiscClass(index));
+    bool retval = leaf->GetQueueDisc()->Enqueue(item);
+
+    // If Queue::Enqueue fails, QueueDisc::Drop is called by the child queue disc
+    // because QueueDisc::AddQueueDiscClass sets the drop callback
+
+    if (!leaf->IsActive() && leaf->GetQueueDisc()->GetNPackets() > 0)
+    {
+        NS_LOG_DEBUG("Class " << index << " becomes active");
+        SetActive(leaf, true);
+    }
+
+    return retval;
+}
+
+uint32_t
+HtbQueueDisc::GetSendLevel(Ptr<HtbClass> leaf) const
+{
+    uint32_t level = 0;
+    for (Ptr<HtbClass> cl = leaf; cl; cl = cl->GetParent(), level++)
+    {
+        if (cl->m_mode == HtbClass::CAN_SEND)
+        {
+            return level;
+        }
+        if (cl->m_mode == HtbClass::CANT_SEND)
+        {
+            break;
+        }
+    }
+    // a root class cannot borrow
+    return MAX_DEPTH;
+}
+
+void
+HtbQueueDisc::SetLevel(Ptr<HtbClass> leaf, uint32_t level)
+{
+    NS_LOG_FUNCTION(this << leaf << level);
+
+    if (leaf->m_level == level)
+    {
+        return;
+    }
+    if (leaf->m_level < MAX_DEPTH)
+    {
+        m_levels[leaf->m_level].erase(leaf->m_index);
+    }
+    leaf->m_level = level;
+    if (level < MAX_DEPTH)
+    {
+        m_levels[level].emplace(leaf->m_index, leaf);
+    }
+}
+
+void
+HtbQueueDisc::UpdateLevels(Ptr<HtbClass> cl)
+{
+    NS_LOG_FUNCTION(this << cl);
+
+    if (cl->m_nActive == 0)
+    {
+        return;
+    }
+    if (cl->IsActive())
+    {
+        SetLevel(cl, GetSendLevel(cl));
+    }
+    for (const auto& child : cl->m_children)
+    {
+        UpdateLevels(child);
+    }
+}
+
+void
+HtbQueueDisc::UpdateMode(Ptr<HtbClass> cl, Time now)
+{
+    NS_LOG_FUNCTION(this << cl << now);
+
+    cl->UpdateTokens(now);
+    HtbClass::ClassMode mode = cl->GetMode();
+
+    if (cl->m_waiting)
+    {
+        m_waitQueue.erase(cl->m_waitPos);
+        cl->m_waiting = false;
+    }
+    if (mode != HtbClass::CAN_SEND)
+    {
+        cl->m_waitPos = m_waitQueue.emplace(now + cl->GetModeChangeDelay(), cl);
+        cl->m_waiting = true;
+    }
+
+    if (mode != cl->m_mode)
+    {
+        NS_LOG_LOGIC("Class " << cl << " changes mode from " << cl->m_mode << " to " << mode);
+        cl->m_mode = mode;
+        UpdateLevels(cl);
+    }
+}
+
+void
+HtbQueueDisc::SetActive(Ptr<HtbClass> leaf, bool active)
+{
+    NS_LOG_FUNCTION(this << leaf << active);
+
+    leaf->SetActive(active);
+    for (Ptr<HtbClass> cl = leaf; cl; cl = cl->GetParent())
+    {
+        cl->m_nActive += (active ? 1 : -1);
+    }
+    if (active)
+    {
+        m_nActive++;
+        SetLevel(leaf, GetSendLevel(leaf));
+    }
+    else
+    {
+        m_nActive--;
+        SetLevel(leaf, MAX_DEPTH);
+    }
+}
+
+Ptr<QueueDiscItem>
+HtbQueueDisc::DoDequeue()
+{
+    NS_LOG_FUNCTION(this);
+
+    Time now = Simulator::Now();
+
+    // the classes whose mode changes by now leave the wait queue
+    while (!m_waitQueue.empty() && m_waitQueue.begin()->first <= now)
+    {
+        UpdateMode(m_waitQueue.begin()->second, now);
+    }
+
+    // serve the lowest level at which an active leaf class can send
+    for (uint32_t level = 0; level < MAX_DEPTH; level++)
+    {
+        std::map<uint32_t, Ptr<HtbClass>>& leaves = m_levels[level];
+
+        while (!leaves.empty())
+        {
+            // deficit round robin among the leaf classes that can send at this level,
+            // starting from the next leaf class to serve at this level
+            auto it = leaves.lower_bound(m_nextLeaf[level]);
+            if (it == leaves.end())
+            {
+                it = leaves.begin();
+            }
+            Ptr<HtbClass> leaf = it->second;
+            if (leaf->GetDeficit() <= 0)
+            {
+                leaf->IncreaseDeficit(leaf->GetQuantum());
+                m_nextLeaf[level] = leaf->m_index + 1;
+                continue;
+            }
+            m_nextLeaf[level] = leaf->m_index;
+
+            Ptr<QueueDiscItem> item = leaf->GetQueueDisc()->Dequeue();
+
+            if (leaf->GetQueueDisc()->GetNPackets() == 0)
+            {
+                NS_LOG_DEBUG("Class becomes inactive");
+                SetActive(leaf, false);
+            }
+
+            if (!item)
+            {
+                // the child queue disc dropped all of its packets
+                continue;
+            }
+
+            // charge the tokens of the classes from the lender upwards and the
+            // ceil tokens of all the classes, whose mode may change
+            uint32_t depth = 0;
+            for (Ptr<HtbClass> cl = leaf; cl; cl = cl->GetParent(), depth++)
+            {
+                cl->UpdateTokens(now);
+                cl->Charge(item->GetSize(), depth >= level);
+                UpdateMode(cl, now);
+            }
+            leaf->IncreaseDeficit(-static_cast<int32_t>(item->GetSize()));
+
+            NS_LOG_LOGIC("Dequeued " << item << " at level " << level);
+            return item;
+        }
+    }
+
+    if (m_nActive > 0)
+    {
+        // every active leaf class is blocked by a class in the wait queue
+        NS_ASSERT(!m_waitQueue.empty());
+        Time next = m_waitQueue.begin()->first;
+        NS_LOG_LOGIC("No class can send");
+        if (m_watchdog.IsExpired() || TimeStep(m_watchdog.GetTs()) > next)
+        {
+            Simulator::Remove(m_watchdog);
+            m_watchdog = Simulator::Schedule(next - now, &QueueDisc::Run, this);
+            NS_LOG_LOGIC("Waking event scheduled in " << (next - now).As(Time::S));
+        }
+        return nullptr;
+    }
+
+    NS_LOG_LOGIC("Queue empty");
+    return nullptr;
+}
+
+bool
+HtbQueueDisc::CheckConfig()
+{
+    NS_LOG_FUNCTION(this);
+    if (GetNInternalQueues() > 0)
+    {
+        NS_LOG_ERROR("HtbQueueDisc cannot have internal queues");
+        return false;
+    }
+
+    if (GetNQueueDiscClasses() == 0)
+    {
+        NS_LOG_ERROR("HtbQueueDisc needs at least a leaf class");
+        return false;
+    }
+
+    m_classes.clear();
+    for (std::size_t i = 0; i < GetNQueueDiscClasses(); i++)
+    {
+        Ptr<HtbClass> leaf = DynamicCast<HtbClass>(GetQueueDiscClass(i));
+        if (!leaf)
+        {
+            NS_LOG_ERROR("The classes of HtbQueueDisc must be HtbClass objects");
+            return false;
+        }
+        m_classes.push_back(leaf);
+    }
+
+    for (std::size_t i = 0; i < GetNQueueDiscClasses(); i++)
+    {
+        uint32_t depth = 0;
+        for (Ptr<HtbClass> cl = m_classes[i]; cl; cl = cl->GetParent(), depth++)
+        {
+            if (depth == MAX_DEPTH)
+            {
+                NS_LOG_ERROR("The class tree of HtbQueueDisc has more than " << MAX_DEPTH
+                                                                             << " levels");
+                return false;
+            }
+            if (cl->GetRate().GetBitRate() == 0 || cl->GetCeil() < cl->GetRate())
+            {
+                NS_LOG_ERROR("HtbQueueDisc classes need a positive rate not exceeding the ceil");
+                return false;
+            }
+
+            auto it = std::find(m_classes.begin(), m_classes.end(), cl);
+            if (depth > 0 && it < m_classes.begin() + GetNQueueDiscClasses())
+            {
+                NS_LOG_ERROR("A leaf class of HtbQueueDisc cannot be the parent of a class");
+                return false;
+            }
+            if (it == m_classes.end())
+            {
+                m_classes.push_back(cl);
+            }
+        }
+    }
+
+    if (m_defaultClass >= GetNQueueDiscClasses())
+    {
+        NS_LOG_WARN("The default class does not exist: unclassified packets will be dropped");
+    }
+
+    return true;
+}
+
+void
+HtbQueueDisc::InitializeParams()
+{
+    NS_LOG_FUNCTION(this);
+    m_nextLeaf.fill(0);
+    for (std::size_t i = 0; i < m_classes.size(); i++)
+    {
+        const Ptr<HtbClass>& cl = m_classes[i];
+        // the leaf classes come first
+        cl->m_index = i;
+        cl->ResetTokens();
+        cl->m_mode = HtbClass::CAN_SEND;
+        cl->m_level = MAX_DEPTH;
+        // a class may have been used by another queue disc before
+        cl->m_nActive = 0;
+        cl->m_waiting = false;
+        cl->m_children.clear();
+    }
+    for (const auto& cl : m_classes)
+    {
+        if (cl->GetParent())
+        {
+            cl->GetParent()->m_children.push_back(cl);
+        }
+    }
+}
+
+} // namespace ns3
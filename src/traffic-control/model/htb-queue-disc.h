@@ -0,0 +1,293 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ *
+ * HTB, the Hierarchical Token Bucket packet scheduler
+ *
+ * This implementation is based on the linux kernel code (sch_htb.c)
+ * by Martin Devera.
+ */
+
+#ifndef HTB_QUEUE_DISC_H
+#define HTB_QUEUE_DISC_H
+
+#include "ns3/data-rate.h"
+#include "ns3/event-id.h"
+#include "ns3/nstime.h"
+#include "ns3/queue-disc.h"
+
+#include <array>
+#include <map>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A class of the Htb queue disc
+ *
+ * Each class has a guaranteed rate and a ceil rate, each one enforced by a
+ * token bucket. Tokens are measured in time units, as in Linux: a class
+ * accumulates tokens as time passes (up to the time needed to transmit a
+ * burst at the rate of the bucket) and is charged the transmission time of
+ * each packet it sends. A class can send at its rate as long as it has
+ * tokens, can borrow the unused rate of its parent class as long as it has
+ * ceil tokens, and cannot send otherwise.
+ *
+ * The leaf classes are the classes attached to the Htb queue disc: each of
+ * them has a child queue disc storing its packets. The inner classes are
+ * created by the user and only set as the Parent of other classes.
+ */
+class HtbClass : public QueueDiscClass
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief HtbClass constructor
+     */
+    HtbClass();
+
+    ~HtbClass() override;
+
+    /**
+     * \enum ClassMode
+     * \brief The sending mode of a class, determined by its tokens
+     */
+    enum ClassMode
+    {
+        CAN_SEND,   //!< the class has tokens
+        MAY_BORROW, //!< the class has no tokens, but it has ceil tokens
+        CANT_SEND   //!< the class has no ceil tokens
+    };
+
+    /**
+     * \brief Set the parent of this class
+     * \param parent the parent class (null for a root class)
+     */
+    void SetParent(Ptr<HtbClass> parent);
+    /**
+     * \brief Get the parent of this class
+     * \return the parent class (null for a root class)
+     */
+    Ptr<HtbClass> GetParent() const;
+    /**
+     * \brief Get the guaranteed rate of this class
+     * \return the rate
+     */
+    DataRate GetRate() const;
+    /**
+     * \brief Get the ceil rate of this class
+     * \return the ceil rate (the rate if no ceil rate has been set)
+     */
+    DataRate GetCeil() const;
+    /**
+     * \brief Get the number of bytes this class can send per DRR round
+     * \return the quantum
+     */
+    uint32_t GetQuantum() const;
+    /**
+     * \brief Get the deficit of this class
+     * \return the deficit
+     */
+    int32_t GetDeficit() const;
+    /**
+     * \brief Increase the deficit of this class
+     * \param deficit the amount by which the deficit is to be increased
+     */
+    void IncreaseDeficit(int32_t deficit);
+    /**
+     * \brief Check whether this class has packets queued
+     * \return true if this class is in the list of active classes
+     */
+    bool IsActive() const;
+    /**
+     * \brief Set whether this class has packets queued
+     * \param active true if this class is in the list of active classes
+     */
+    void SetActive(bool active);
+
+    /**
+     * \brief Fill the token buckets
+     */
+    void ResetTokens();
+    /**
+     * \brief Add the tokens accumulated since the last update
+     * \param now the current time
+     */
+    void UpdateTokens(Time now);
+    /**
+     * \brief Get the mode of this class, given the tokens at the last update
+     * \return the mode of this class
+     */
+    ClassMode GetMode() const;
+    /**
+     * \brief Get the time until the mode of this class changes, i.e., until
+     *        the bucket that prevents it from sending is no longer empty
+     * \return the time until the mode of this class changes
+     */
+    Time GetModeChangeDelay() const;
+    /**
+     * \brief Charge this class for the transmission of a packet
+     * \param bytes the size of the packet
+     * \param tokens whether tokens are charged, besides ceil tokens (false
+     *        if this class is borrowing from one of its ancestors)
+     */
+    void Charge(uint32_t bytes, bool tokens);
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
+  private:
+    /// The queue disc keeps the scheduling state of the classes
+    friend class HtbQueueDisc;
+
+    Ptr<HtbClass> m_parent; //!< the parent class
+    DataRate m_rate;        //!< the guaranteed rate
+    DataRate m_ceil;        //!< the ceil rate
+    uint32_t m_burst;       //!< the size of the bucket of tokens, in bytes
+    uint32_t m_cburst;      //!< the size of the bucket of ceil tokens, in bytes
+    uint32_t m_quantum;     //!< the quantum (zero to compute it from the rate)
+    int32_t m_deficit;      //!< the deficit of this class
+    bool m_active;          //!< whether this class is in the list of active classes
+    Time m_tokens;          //!< the tokens, as transmission time at the rate
+    Time m_ctokens;         //!< the ceil tokens, as transmission time at the ceil rate
+    Time m_checkPoint;      //!< the time of the last update of the tokens
+
+    ClassMode m_mode;   //!< the mode at the last update of the tokens
+    uint32_t m_level;   //!< the level at which this active leaf class can send
+    uint32_t m_nActive; //!< the number of active leaf classes in the subtree of this class
+    std::vector<Ptr<HtbClass>> m_children; //!< the child classes
+    uint32_t m_index;                      //!< the index of this leaf class in its queue disc
+    bool m_waiting;                        //!< whether this class is in the wait queue
+    std::multimap<Time, Ptr<HtbClass>>::iterator m_waitPos; //!< the position in the wait queue
+};
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief A HTB packet queue disc
+ *
+ * Packets are classified into the leaf classes by the packet filters or,
+ * if no filter matches, enqueued into the default class. The leaf classes
+ * that can send without borrowing are served first; otherwise, the leaf
+ * classes borrowing from the closest ancestor are served. Leaf classes
+ * at the same level are served according to a deficit round robin.
+ *
+ * As in Linux, the active leaf classes are kept in a list per level, ordered
+ * by their index, together with the index of the next leaf class to serve at
+ * that level, so that the round robin resumes where it stopped when the leaf
+ * classes change level. The classes that cannot send are kept in a wait queue
+ * ordered by the time their mode changes. The lists are only updated when the
+ * mode of a class changes, i.e., when a class is charged or leaves the wait
+ * queue, rather than by examining every active class at each dequeue. A single
+ * event wakes the queue disc up at the head of the wait queue.
+ */
+class HtbQueueDisc : public QueueDisc
+{
+  public:
+    /**
+     * \brief Get the type ID.
+     * \return the object TypeId
+     */
+    static TypeId GetTypeId();
+    /**
+     * \brief HtbQueueDisc constructor
+     */
+    HtbQueueDisc();
+
+    ~HtbQueueDisc() override;
+
+    // Reasons for dropping packets
+    static constexpr const char* UNCLASSIFIED_DROP =
+        "Unclassified drop"; //!< No class found for the packet
+
+    /// The maximum depth of the class tree
+    static constexpr uint32_t MAX_DEPTH = 8;
+
+    /**
+     * \brief Get the number of leaf classes having packets queued
+     * \return the number of active leaf classes
+     */
+    std::size_t GetNActiveClasses() const;
+
+  protected:
+    /**
+     * \brief Dispose of the object
+     */
+    void DoDispose() override;
+
+  private:
+    bool DoEnqueue(Ptr<QueueDiscItem> item) override;
+    Ptr<QueueDiscItem> DoDequeue() override;
+    bool CheckConfig() override;
+    void InitializeParams() override;
+
+    /**
+     * \brief Get the level at which a leaf class can send a packet, i.e., the
+     *        number of ancestors to climb to find a class with tokens, given
+     *        the modes of the classes at their last update
+     * \param leaf the leaf class
+     * \return the level, or MAX_DEPTH if the leaf class cannot send
+     */
+    uint32_t GetSendLevel(Ptr<HtbClass> leaf) const;
+    /**
+     * \brief Move a leaf class to the list of the given level
+     * \param leaf the leaf class
+     * \param level the level, or MAX_DEPTH to remove the leaf class from the lists
+     */
+    void SetLevel(Ptr<HtbClass> leaf, uint32_t level);
+    /**
+     * \brief Move the active leaf classes in the subtree of a class to the
+     *        lists of the levels at which they can send
+     * \param cl the class
+     */
+    void UpdateLevels(Ptr<HtbClass> cl);
+    /**
+     * \brief Update the tokens and the mode of a class, its position in the
+     *        wait queue and, if its mode changed, the levels of the active leaf
+     *        classes in its subtree
+     * \param cl the class
+     * \param now the current time
+     */
+    void UpdateMode(Ptr<HtbClass> cl, Time now);
+    /**
+     * \brief Add a leaf class to or remove it from the active classes
+     * \param leaf the leaf class
+     * \param active whether the leaf class has packets queued
+     */
+    void SetActive(Ptr<HtbClass> leaf, bool active);
+
+    uint32_t m_defaultClass; //!< Index of the class of the unclassified packets
+
+    std::vector<Ptr<HtbClass>> m_classes; //!< All the classes (leaf and inner)
+    std::array<std::map<uint32_t, Ptr<HtbClass>>, MAX_DEPTH>
+        m_levels; //!< The active leaf classes by index, by the level at which they can send
+    std::array<uint32_t, MAX_DEPTH> m_nextLeaf; //!< Index of the next leaf class to serve per level
+    std::multimap<Time, Ptr<HtbClass>>
+        m_waitQueue;     //!< The classes that cannot send, by the time their mode changes
+    std::size_t m_nActive; //!< The number of leaf classes having packets queued
+    EventId m_watchdog;    //!< The event waking the queue disc up
+};
+
+} // namespace ns3
+
+#endif /* HTB_QUEUE_DISC_H */
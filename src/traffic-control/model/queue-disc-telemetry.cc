@@ -0,0 +1,146 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "queue-disc-telemetry.h"
+
+#include "ns3/abort.h"
+#include "ns3/assert.h"
+#include "ns3/log.h"
+#include "ns3/simulator.h"
+
+#include <algorithm>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("QueueDiscTelemetry");
+
+QueueDiscTelemetry::QueueDiscTelemetry()
+    : m_nTotal(0),
+      m_reasons(1)
+{
+    NS_LOG_FUNCTION(this);
+}
+
+void
+QueueDiscTelemetry::SetSize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_records.assign(size, Record());
+    m_records.shrink_to_fit();
+    m_nTotal = 0;
+}
+
+uint32_t
+QueueDiscTelemetry::GetSize() const
+{
+    return m_records.size();
+}
+
+bool
+QueueDiscTelemetry::IsEnabled() const
+{
+    return !m_records.empty();
+}
+
+void
+QueueDiscTelemetry::Add(Time sojourn, uint32_t size, uint32_t flowHash, const char* reason)
+{
+    NS_ASSERT(IsEnabled());
+
+    uint16_t index = NO_DROP;
+    if (reason)
+    {
+        // drop reasons are few, a linear search is cheaper than a map lookup
+        auto it = std::find(m_reasons.begin() + 1, m_reasons.end(), reason);
+        if (it == m_reasons.end())
+        {
+            NS_ABORT_MSG_IF(m_reasons.size() > UINT16_MAX, "Too many drop reasons");
+            m_reasons.emplace_back(reason);
+            it = m_reasons.end() - 1;
+        }
+        index = it - m_reasons.begin();
+    }
+
+    Record& record = m_records[m_nTotal % m_records.size()];
+    record.time = Simulator::Now();
+    record.sojourn = sojourn;
+    record.size = size;
+    record.flowHash = flowHash;
+    record.reason = index;
+    m_nTotal++;
+}
+
+uint32_t
+QueueDiscTelemetry::GetNRecords() const
+{
+    return std::min<uint64_t>(m_nTotal, m_records.size());
+}
+
+uint64_t
+QueueDiscTelemetry::GetNTotalRecords() const
+{
+    return m_nTotal;
+}
+
+const QueueDiscTelemetry::Record&
+QueueDiscTelemetry::GetRecord(uint32_t i) const
+{
+    NS_ASSERT(i < GetNRecords());
+    return m_records[(m_nTotal - GetNRecords() + i) % m_records.size()];
+}
+
+const std::string&
+QueueDiscTelemetry::GetReason(uint16_t reason) const
+{
+    NS_ASSERT(reason < m_reasons.size());
+    return m_reasons[reason];
+}
+
+void
+QueueDiscTelemetry::Clear()
+{
+    NS_LOG_FUNCTION(this);
+    m_nTotal = 0;
+}
+
+void
+QueueDiscTelemetry::Write(std::ostream& os) const
+{
+    NS_LOG_FUNCTION(this);
+
+    uint16_t nReasons = m_reasons.size();
+    os.write(reinterpret_cast<const char*>(&nReasons), sizeof(nReasons));
+    for (const auto& reason : m_reasons)
+    {
+        os.write(reason.c_str(), reason.size() + 1);
+    }
+
+    uint32_t nRecords = GetNRecords();
+    os.write(reinterpret_cast<const char*>(&nRecords), sizeof(nRecords));
+    for (uint32_t i = 0; i < nRecords; i++)
+    {
+        const Record& record = GetRecord(i);
+        int64_t time = record.time.GetNanoSeconds();
+        int64_t sojourn = record.sojourn.GetNanoSeconds();
+        os.write(reinterpret_cast<const char*>(&time), sizeof(time));
+        os.write(reinterpret_cast<const char*>(&sojourn), sizeof(sojourn));
+        os.write(reinterpret_cast<const char*>(&record.size), sizeof(record.size));
+        os.write(reinterpret_cast<const char*>(&record.flowHash), sizeof(record.flowHash));
+        os.write(reinterpret_cast<const char*>(&record.reason), sizeof(record.reason));
+    }
+}
+
+} // namespace ns3
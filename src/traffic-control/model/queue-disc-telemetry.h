@@ -0,0 +1,140 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef QUEUE_DISC_TELEMETRY_H
+#define QUEUE_DISC_TELEMETRY_H
+
+#include "ns3/nstime.h"
+
+#include <cstdint>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup traffic-control
+ *
+ * \brief Fixed-size ring of per-packet records of a queue disc
+ *
+ * A record is stored for every packet dequeued or dropped by the queue disc.
+ * The ring is allocated once, when its size is set, and the oldest records
+ * are overwritten when it is full, hence recording a packet costs a few
+ * stores and no callback invocation. The records can be read at any time,
+ * e.g., periodically or at the end of the simulation, and written to a
+ * binary stream.
+ */
+class QueueDiscTelemetry
+{
+  public:
+    /// A record of the ring
+    struct Record
+    {
+        Time time;         //!< the time the packet was dequeued or dropped
+        Time sojourn;      //!< the time the packet spent in the queue disc
+        uint32_t size;     //!< the size of the packet
+        uint32_t flowHash; //!< the hash of the flow of the packet
+        uint16_t reason;   //!< the index of the drop reason (NO_DROP if dequeued)
+    };
+
+    /// Reason index of the records of dequeued packets
+    static constexpr uint16_t NO_DROP = 0;
+
+    QueueDiscTelemetry();
+
+    /**
+     * \brief Set the number of records of the ring, removing all the records
+     * \param size the number of records (zero disables the telemetry)
+     */
+    void SetSize(uint32_t size);
+
+    /**
+     * \brief Get the number of records of the ring
+     * \return the number of records of the ring
+     */
+    uint32_t GetSize() const;
+
+    /**
+     * \brief Check whether records are stored
+     * \return true if the ring has a non-null size
+     */
+    bool IsEnabled() const;
+
+    /**
+     * \brief Store a record, overwriting the oldest one if the ring is full
+     * \param sojourn the time the packet spent in the queue disc
+     * \param size the size of the packet
+     * \param flowHash the hash of the flow of the packet
+     * \param reason the reason why the packet was dropped (nullptr if dequeued)
+     */
+    void Add(Time sojourn, uint32_t size, uint32_t flowHash, const char* reason);
+
+    /**
+     * \brief Get the number of records currently stored
+     * \return the number of records stored
+     */
+    uint32_t GetNRecords() const;
+
+    /**
+     * \brief Get the number of records stored since the ring was cleared,
+     *        including those overwritten
+     * \return the total number of records
+     */
+    uint64_t GetNTotalRecords() const;
+
+    /**
+     * \brief Get a stored record
+     * \param i the index of the record, zero being the oldest one
+     * \return the record
+     */
+    const Record& GetRecord(uint32_t i) const;
+
+    /**
+     * \brief Get the drop reason of a record
+     * \param reason the reason index of the record
+     * \return the drop reason (an empty string for NO_DROP)
+     */
+    const std::string& GetReason(uint16_t reason) const;
+
+    /**
+     * \brief Remove all the records
+     */
+    void Clear();
+
+    /**
+     * \brief Write the stored records to a binary stream
+     *
+     * The stream contains the number of drop reasons (uint16_t) followed by
+     * the null-terminated reasons, then the number of records (uint32_t)
+     * followed by the records, from the oldest one. Each record consists of
+     * the time and the sojourn time in nanoseconds (int64_t), the size and
+     * the flow hash (uint32_t) and the reason index (uint16_t). Values are
+     * in host byte order.
+     *
+     * \param os the output stream
+     */
+    void Write(std::ostream& os) const;
+
+  private:
+    std::vector<Record> m_records;      //!< The ring of records
+    uint64_t m_nTotal;                  //!< Number of records stored since the last clear
+    std::vector<std::string> m_reasons; //!< The drop reasons (index 0 is NO_DROP)
+};
+
+} // namespace ns3
+
+#endif /* QUEUE_DISC_TELEMETRY_H */
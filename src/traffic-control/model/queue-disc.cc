@@ -261,6 +261,13 @@ QueueDisc::GetTypeId()
                           UintegerValue(DEFAULT_QUOTA),
                           MakeUintegerAccessor(&QueueDisc::SetQuota, &QueueDisc::GetQuota),
                           MakeUintegerChecker<uint32_t>())
+            .AddAttribute("TelemetrySize",
+                          "The number of per-packet records kept in the telemetry ring "
+                          "(zero disables the telemetry)",
+                          UintegerValue(0),
+                          MakeUintegerAccessor(&QueueDisc::SetTelemetrySize,
+                                               &QueueDisc::GetTelemetrySize),
+                          MakeUintegerChecker<uint32_t>())
             .AddAttribute("InternalQueueList",
                           "The list of internal queues.",
                           ObjectVectorValue(),
@@ -574,6 +581,25 @@ QueueDisc::GetQuota() const
     return m_quota;
 }
 
+void
+QueueDisc::SetTelemetrySize(uint32_t size)
+{
+    NS_LOG_FUNCTION(this << size);
+    m_telemetry.SetSize(size);
+}
+
+uint32_t
+QueueDisc::GetTelemetrySize() const
+{
+    return m_telemetry.GetSize();
+}
+
+QueueDiscTelemetry&
+QueueDisc::GetTelemetry()
+{
+    return m_telemetry;
+}
+
 void
 QueueDisc::AddInternalQueue(Ptr<InternalQueue> queue)
 {
@@ -758,6 +784,12 @@ QueueDisc::DropBeforeEnqueue(Ptr<const QueueDiscItem> item, const char* reason)
     NS_LOG_DEBUG("Total packets/bytes dropped before enqueue: "
                  << m_stats.nTotalDroppedPacketsBeforeEnqueue << " / "
                  << m_stats.nTotalDroppedBytesBeforeEnqueue);
+
+    if (m_telemetry.IsEnabled())
+    {
+        m_telemetry.Add(Time(0), item->GetSize(), item->Hash(), reason);
+    }
+
     NS_LOG_LOGIC("m_traceDropBeforeEnqueue (p)");
     m_traceDrop(item);
     m_traceDropBeforeEnqueue(item, reason);
@@ -809,6 +841,15 @@ QueueDisc::DropAfterDequeue(Ptr<const QueueDiscItem> item, const char* reason)
     NS_LOG_DEBUG("Total packets/bytes dropped after dequeue: "
                  << m_stats.nTotalDroppedPacketsAfterDequeue << " / "
                  << m_stats.nTotalDroppedBytesAfterDequeue);
+
+    if (m_telemetry.IsEnabled())
+    {
+        m_telemetry.Add(Simulator::Now() - item->GetTimeStamp(),
+                        item->GetSize(),
+                        item->Hash(),
+                        reason);
+    }
+
     NS_LOG_LOGIC("m_traceDropAfterDequeue (p)");
     m_traceDrop(item);
     m_traceDropAfterDequeue(item, reason);
@@ -900,6 +941,10 @@ QueueDisc::Dequeue()
     // packet. Thus, first check whether a peeked packet exists. Otherwise, call
     // the private DoDequeue method.
     Ptr<QueueDiscItem> item = m_requeued;
+    // a packet is recorded by the telemetry when it actually leaves the queue disc:
+    // not when it is dequeued because of a peek request, nor when it is dequeued
+    // again after a failed transmission
+    bool record = false;
 
     if (item)
     {
@@ -912,11 +957,21 @@ QueueDisc::Dequeue()
             // to update statistics about dequeued packets and fire the dequeue trace.
             m_peeked = false;
             PacketDequeued(item);
+            record = true;
         }
     }
     else
     {
         item = DoDequeue();
+        record = !m_peeked;
+    }
+
+    if (item && record && m_telemetry.IsEnabled())
+    {
+        m_telemetry.Add(Simulator::Now() - item->GetTimeStamp(),
+                        item->GetSize(),
+                        item->Hash(),
+                        nullptr);
     }
 
     NS_ASSERT(m_nPackets == m_stats.nTotalEnqueuedPackets - m_stats.nTotalDequeuedPackets);
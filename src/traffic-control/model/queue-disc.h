@@ -21,6 +21,7 @@
 #define QUEUE_DISC_H
 
 #include "packet-filter.h"
+#include "queue-disc-telemetry.h"
 
 #include "ns3/object.h"
 #include "ns3/queue-fwd.h"
@@ -391,6 +392,25 @@ class QueueDisc : public Object
      */
     virtual uint32_t GetQuota() const;
 
+    /**
+     * \brief Set the number of records of the telemetry ring
+     * \param size the number of records (zero disables the telemetry)
+     */
+    void SetTelemetrySize(uint32_t size);
+
+    /**
+     * \brief Get the number of records of the telemetry ring
+     * \return the number of records of the telemetry ring
+     */
+    uint32_t GetTelemetrySize() const;
+
+    /**
+     * \brief Get the telemetry ring, holding a record for each packet dequeued
+     *        or dropped by this queue disc
+     * \return the telemetry ring
+     */
+    QueueDiscTelemetry& GetTelemetry();
+
     /**
      * Pass a packet to store to the queue discipline. This function only updates
      * the statistics and calls the (private) DoEnqueue function, which must be
@@ -708,6 +728,7 @@ class QueueDisc : public Object
     std::string m_childQueueDiscMarkMsg; //!< Reason why a packet was marked by a child queue disc
     QueueDiscSizePolicy m_sizePolicy;    //!< The queue disc size policy
     bool m_prohibitChangeMode;           //!< True if changing mode is prohibited
+    QueueDiscTelemetry m_telemetry;      //!< Per-packet records of dequeues and drops
 
     /// Traced callback: fired when a packet is enqueued
     TracedCallback<Ptr<const QueueDiscItem>> m_traceEnqueue;
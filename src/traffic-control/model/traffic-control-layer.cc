@@ -376,13 +376,22 @@ TrafficControlLayer::Send(Ptr<NetDevice> device, Ptr<QueueDiscItem> item)
     std::size_t txq = 0;
     if (devQueueIface && devQueueIface->GetNTxQueues() > 1)
     {
-        txq = devQueueIface->GetSelectQueueCallback()(item);
-        // otherwise, Linux determines the queue index by using a hash function
-        // and associates such index to the socket which the packet belongs to,
-        // so that subsequent packets of the same socket will be mapped to the
-        // same tx queue (__netdev_pick_tx function in net/core/dev.c). It is
-        // pointless to implement this in ns-3 because currently the multi-queue
-        // devices provide a select queue callback
+        const NetDeviceQueueInterface::SelectQueueCallback& selectQueue =
+            devQueueIface->GetSelectQueueCallback();
+        if (selectQueue)
+        {
+            txq = selectQueue(item);
+        }
+        else
+        {
+            // otherwise, Linux determines the queue index by using a hash function
+            // (skb_tx_hash) and associates such index to the socket which the packet
+            // belongs to, so that subsequent packets of the same socket will be
+            // mapped to the same tx queue (__netdev_pick_tx function in
+            // net/core/dev.c). Hashing the flow of the packet maps all the packets
+            // of a flow to the same tx queue as well, without keeping any state.
+            txq = item->Hash() % devQueueIface->GetNTxQueues();
+        }
     }
 
     NS_ASSERT(!devQueueIface || txq < devQueueIface->GetNTxQueues());
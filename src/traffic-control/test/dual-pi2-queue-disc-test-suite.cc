@@ -0,0 +1,303 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/dual-pi2-queue-disc.h"
+#include "ns3/packet.h"
+#include "ns3/queue.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief DualPi2 Queue Disc Test Item
+ */
+class DualPi2QueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param addr the address
+     * \param ecn the ECN codepoint of the packet
+     */
+    DualPi2QueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint8_t ecn);
+    void AddHeader() override;
+    bool Mark() override;
+    bool GetUint8Value(Uint8Values field, uint8_t& value) const override;
+
+  private:
+    uint8_t m_ecn; //!< the ECN codepoint of the packet
+};
+
+DualPi2QueueDiscTestItem::DualPi2QueueDiscTestItem(Ptr<Packet> p,
+                                                   const Address& addr,
+                                                   uint8_t ecn)
+    : QueueDiscItem(p, addr, 0),
+      m_ecn(ecn)
+{
+}
+
+void
+DualPi2QueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+DualPi2QueueDiscTestItem::Mark()
+{
+    if (m_ecn == 0)
+    {
+        return false;
+    }
+    m_ecn = 3;
+    return true;
+}
+
+bool
+DualPi2QueueDiscTestItem::GetUint8Value(Uint8Values field, uint8_t& value) const
+{
+    if (field != IP_DSFIELD)
+    {
+        return false;
+    }
+    value = m_ecn;
+    return true;
+}
+
+/// ECN codepoints of the test items
+enum TestEcnCodepoint : uint8_t
+{
+    NOT_ECT = 0,
+    ECT1 = 1,
+    ECT0 = 2,
+};
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the classification and the scheduling of the DualPi2 queue disc
+ */
+class DualPi2QueueDiscSchedulingTestCase : public TestCase
+{
+  public:
+    DualPi2QueueDiscSchedulingTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+DualPi2QueueDiscSchedulingTestCase::DualPi2QueueDiscSchedulingTestCase()
+    : TestCase("Check the classification and the scheduling of the DualPi2 queue disc")
+{
+}
+
+void
+DualPi2QueueDiscSchedulingTestCase::DoRun()
+{
+    Ptr<DualPi2QueueDisc> queue = CreateObject<DualPi2QueueDisc>();
+    queue->Initialize();
+
+    Address dest;
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, NOT_ECT));
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT0));
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT1));
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, 3));
+
+    NS_TEST_EXPECT_MSG_EQ(queue->GetInternalQueue(DualPi2QueueDisc::L4S_QUEUE)->GetNPackets(),
+                          2,
+                          "ECT(1) and CE packets should be in the L4S queue");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetInternalQueue(DualPi2QueueDisc::CLASSIC_QUEUE)->GetNPackets(),
+                          2,
+                          "Not-ECT and ECT(0) packets should be in the Classic queue");
+
+    // packets of the same age: the L4S queue is served first
+    uint8_t tos = 0;
+    Ptr<QueueDiscItem> item = queue->Dequeue();
+    item->GetUint8Value(QueueItem::IP_DSFIELD, tos);
+    NS_TEST_EXPECT_MSG_EQ(int(tos & 0x1), 1, "The L4S queue should be served first");
+    queue->Dequeue();
+    queue->Dequeue();
+    queue->Dequeue();
+
+    // a Classic packet older than an L4S packet by more than Tshift is served first
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, NOT_ECT));
+    Simulator::Schedule(MilliSeconds(40), [&]() {
+        queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT1));
+        item = queue->Dequeue();
+    });
+    Simulator::Stop(MilliSeconds(40));
+    Simulator::Run();
+
+    item->GetUint8Value(QueueItem::IP_DSFIELD, tos);
+    NS_TEST_EXPECT_MSG_EQ(int(tos), NOT_ECT, "The Classic queue should be served first");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the marking of the L4S packets of the DualPi2 queue disc
+ *
+ * A Classic packet held in the queue disc raises the base probability, from
+ * which the Classic and the coupled probabilities are derived. L4S packets
+ * whose sojourn time exceeds the step threshold are always marked.
+ */
+class DualPi2QueueDiscMarkingTestCase : public TestCase
+{
+  public:
+    DualPi2QueueDiscMarkingTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+DualPi2QueueDiscMarkingTestCase::DualPi2QueueDiscMarkingTestCase()
+    : TestCase("Check the marking of the L4S packets of the DualPi2 queue disc")
+{
+}
+
+void
+DualPi2QueueDiscMarkingTestCase::DoRun()
+{
+    Ptr<DualPi2QueueDisc> queue = CreateObject<DualPi2QueueDisc>();
+    queue->AssignStreams(1);
+    queue->Initialize();
+
+    Address dest;
+    // step marking, before the first update of the base probability
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT1));
+    queue->Dequeue();
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT1));
+    Simulator::Schedule(MilliSeconds(2), [&]() { queue->Dequeue(); });
+
+    // a Classic packet held for 100ms
+    Simulator::Schedule(MilliSeconds(3), [&]() {
+        queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, NOT_ECT));
+    });
+    Simulator::Stop(MilliSeconds(103));
+    Simulator::Run();
+
+    QueueDisc::Stats st = queue->GetStats();
+    NS_TEST_EXPECT_MSG_EQ(st.GetNMarkedPackets(DualPi2QueueDisc::STEP_MARK),
+                          1,
+                          "Only the packet above the step threshold should be marked");
+
+    double p = queue->GetBaseProbability();
+    NS_TEST_EXPECT_MSG_GT(p, 0, "The base probability should have been increased");
+    NS_TEST_EXPECT_MSG_EQ_TOL(queue->GetClassicProbability(),
+                              p * p,
+                              1e-9,
+                              "The Classic probability should be the square of the base one");
+    NS_TEST_EXPECT_MSG_EQ_TOL(queue->GetCoupledProbability(),
+                              std::min(2 * p, 1.0),
+                              1e-9,
+                              "The coupled probability should be K times the base one");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the drops and marks of the DualPi2 queue disc in overload
+ *
+ * A Classic packet held for long saturates the base probability: every
+ * Classic packet is then marked if ECN-capable or dropped otherwise, and
+ * every L4S packet is dropped.
+ */
+class DualPi2QueueDiscOverloadTestCase : public TestCase
+{
+  public:
+    DualPi2QueueDiscOverloadTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+DualPi2QueueDiscOverloadTestCase::DualPi2QueueDiscOverloadTestCase()
+    : TestCase("Check the drops and marks of the DualPi2 queue disc in overload")
+{
+}
+
+void
+DualPi2QueueDiscOverloadTestCase::DoRun()
+{
+    Ptr<DualPi2QueueDisc> queue = CreateObject<DualPi2QueueDisc>();
+    queue->AssignStreams(1);
+    queue->Initialize();
+
+    Address dest;
+    queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, NOT_ECT));
+
+    Simulator::Schedule(Seconds(0.5), [&]() {
+        NS_TEST_EXPECT_MSG_EQ(queue->GetBaseProbability(),
+                              1,
+                              "The base probability should be saturated");
+        for (uint32_t i = 0; i < 10; i++)
+        {
+            queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT0));
+            queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, NOT_ECT));
+            queue->Enqueue(Create<DualPi2QueueDiscTestItem>(Create<Packet>(1000), dest, ECT1));
+        }
+        while (queue->Dequeue())
+        {
+        }
+    });
+    Simulator::Stop(Seconds(0.5));
+    Simulator::Run();
+
+    QueueDisc::Stats st = queue->GetStats();
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 0, "The queue disc should be empty");
+    NS_TEST_EXPECT_MSG_EQ(st.GetNMarkedPackets(DualPi2QueueDisc::UNFORCED_CLASSIC_MARK),
+                          10,
+                          "The ECN-capable Classic packets should be marked");
+    NS_TEST_EXPECT_MSG_EQ(st.GetNDroppedPackets(DualPi2QueueDisc::UNFORCED_CLASSIC_DROP),
+                          11,
+                          "The Not-ECT Classic packets should be dropped");
+    NS_TEST_EXPECT_MSG_EQ(st.GetNDroppedPackets(DualPi2QueueDisc::UNFORCED_L4S_DROP),
+                          10,
+                          "The L4S packets should be dropped in overload");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief DualPi2 queue disc test suite
+ */
+class DualPi2QueueDiscTestSuite : public TestSuite
+{
+  public:
+    DualPi2QueueDiscTestSuite()
+        : TestSuite("dual-pi2-queue-disc", UNIT)
+    {
+        AddTestCase(new DualPi2QueueDiscSchedulingTestCase(), TestCase::QUICK);
+        AddTestCase(new DualPi2QueueDiscMarkingTestCase(), TestCase::QUICK);
+        AddTestCase(new DualPi2QueueDiscOverloadTestCase(), TestCase::QUICK);
+    }
+};
+
+static DualPi2QueueDiscTestSuite g_dualPi2QueueDiscTestSuite; ///< the test suite
@@ -0,0 +1,353 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/edt-tag.h"
+#include "ns3/fq-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/packet.h"
+#include "ns3/simulator.h"
+#include "ns3/string.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <utility>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Fq Queue Disc Test Item
+ */
+class FqQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param addr the address
+     * \param hash the hash of the flow the packet belongs to
+     */
+    FqQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t hash);
+    ~FqQueueDiscTestItem() override;
+
+    // Delete default constructor, copy constructor and assignment operator to avoid misuse
+    FqQueueDiscTestItem() = delete;
+    FqQueueDiscTestItem(const FqQueueDiscTestItem&) = delete;
+    FqQueueDiscTestItem& operator=(const FqQueueDiscTestItem&) = delete;
+
+    void AddHeader() override;
+    bool Mark() override;
+    uint32_t Hash(uint32_t perturbation) const override;
+
+  private:
+    uint32_t m_hash; //!< the hash of the flow
+};
+
+FqQueueDiscTestItem::FqQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t hash)
+    : QueueDiscItem(p, addr, 0),
+      m_hash(hash)
+{
+}
+
+FqQueueDiscTestItem::~FqQueueDiscTestItem()
+{
+}
+
+void
+FqQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+FqQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+uint32_t
+FqQueueDiscTestItem::Hash(uint32_t perturbation) const
+{
+    return m_hash;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check that packets leave the Fq queue disc at their earliest departure time
+ *
+ * A paced flow enqueues a burst of packets tagged with increasing departure
+ * times, while an unpaced flow enqueues a burst of untagged packets. The
+ * unpaced packets must be transmitted immediately, while the paced flow is
+ * throttled; then, the queue disc must wake up by itself to transmit each
+ * paced packet at its departure time, without the EdtTag.
+ */
+class FqQueueDiscEdtTestCase : public TestCase
+{
+  public:
+    FqQueueDiscEdtTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Enqueue a packet
+     * \param queue the queue disc
+     * \param hash the hash of the flow
+     * \param departure the earliest departure time (none if zero)
+     */
+    void Enqueue(Ptr<FqQueueDisc> queue, uint32_t hash, Time departure);
+
+    /**
+     * Record the transmission of a packet
+     * \param item the transmitted item
+     */
+    void Send(Ptr<QueueDiscItem> item);
+
+    std::vector<std::pair<Time, uint32_t>> m_sent; //!< Times and flows of the transmissions
+};
+
+FqQueueDiscEdtTestCase::FqQueueDiscEdtTestCase()
+    : TestCase("Check that the Fq queue disc honors the earliest departure time of packets")
+{
+}
+
+void
+FqQueueDiscEdtTestCase::Enqueue(Ptr<FqQueueDisc> queue, uint32_t hash, Time departure)
+{
+    Ptr<Packet> p = Create<Packet>(1000);
+    if (!departure.IsZero())
+    {
+        p->AddPacketTag(EdtTag(departure));
+    }
+    Address dest;
+    queue->Enqueue(Create<FqQueueDiscTestItem>(p, dest, hash));
+}
+
+void
+FqQueueDiscEdtTestCase::Send(Ptr<QueueDiscItem> item)
+{
+    m_sent.emplace_back(Simulator::Now(), item->Hash(0));
+    EdtTag tag;
+    NS_TEST_EXPECT_MSG_EQ(item->GetPacket()->PeekPacketTag(tag),
+                          false,
+                          "The departure time should be removed from the dequeued packets");
+}
+
+void
+FqQueueDiscEdtTestCase::DoRun()
+{
+    Ptr<FqQueueDisc> queue = CreateObject<FqQueueDisc>();
+    queue->SetQuantum(1500);
+    queue->SetSendCallback([this](Ptr<QueueDiscItem> item) { Send(item); });
+    queue->Initialize();
+
+    for (uint32_t i = 1; i <= 3; ++i)
+    {
+        Enqueue(queue, 1, MilliSeconds(i));
+    }
+    Enqueue(queue, 2, Time(0));
+    Enqueue(queue, 2, Time(0));
+    queue->Run();
+
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 3, "The paced packets should still be queued");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNThrottledFlows(), 1, "The paced flow should be throttled");
+
+    Simulator::Run();
+
+    std::vector<std::pair<Time, uint32_t>> expected{{Seconds(0), 2},
+                                                    {Seconds(0), 2},
+                                                    {MilliSeconds(1), 1},
+                                                    {MilliSeconds(2), 1},
+                                                    {MilliSeconds(3), 1}};
+    NS_TEST_ASSERT_MSG_EQ(m_sent.size(), expected.size(), "Unexpected number of transmissions");
+    for (std::size_t i = 0; i < expected.size(); ++i)
+    {
+        NS_TEST_EXPECT_MSG_EQ(m_sent[i].first, expected[i].first, "Unexpected transmission time");
+        NS_TEST_EXPECT_MSG_EQ(m_sent[i].second, expected[i].second, "Unexpected flow");
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNThrottledFlows(), 0, "No flow should be throttled");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the drops performed by the Fq queue disc
+ *
+ * Packets are dropped when their departure time is beyond the horizon and
+ * when the flow limit or the queue disc limit are exceeded.
+ */
+class FqQueueDiscDropTestCase : public TestCase
+{
+  public:
+    FqQueueDiscDropTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+FqQueueDiscDropTestCase::FqQueueDiscDropTestCase()
+    : TestCase("Check the drops performed by the Fq queue disc")
+{
+}
+
+void
+FqQueueDiscDropTestCase::DoRun()
+{
+    Ptr<FqQueueDisc> queue = CreateObjectWithAttributes<FqQueueDisc>("MaxSize",
+                                                                     StringValue("5p"),
+                                                                     "FlowLimit",
+                                                                     UintegerValue(3),
+                                                                     "Horizon",
+                                                                     TimeValue(Seconds(1)));
+    queue->SetQuantum(1500);
+    queue->Initialize();
+
+    Address dest;
+    Ptr<Packet> p = Create<Packet>(1000);
+    p->AddPacketTag(EdtTag(Seconds(2)));
+    queue->Enqueue(Create<FqQueueDiscTestItem>(p, dest, 1));
+    NS_TEST_EXPECT_MSG_EQ(queue->GetStats().GetNDroppedPackets(FqQueueDisc::HORIZON_DROP),
+                          1,
+                          "The packet beyond the horizon should have been dropped");
+
+    for (uint32_t i = 0; i < 4; ++i)
+    {
+        queue->Enqueue(Create<FqQueueDiscTestItem>(Create<Packet>(1000), dest, 1));
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 3, "The flow limit should have been enforced");
+
+    for (uint32_t i = 0; i < 3; ++i)
+    {
+        queue->Enqueue(Create<FqQueueDiscTestItem>(Create<Packet>(1000), dest, 2));
+    }
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 5, "The queue disc limit should be enforced");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetStats().GetNDroppedPackets(FqQueueDisc::OVERLIMIT_DROP),
+                          1,
+                          "A packet should have been dropped for the queue disc limit");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetStats().nTotalDroppedPackets,
+                          3,
+                          "Unexpected number of dropped packets");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check that a throttled flow does not hold back the other flows of its set
+ *
+ * With 8 queues in a single set, flows whose hashes are equal modulo the
+ * number of queues are mapped to distinct queues, hence an unpaced flow is
+ * not throttled together with a paced one, as long as the set has a free
+ * queue. When all the queues of the set are busy, a new flow shares the
+ * first queue of the set.
+ */
+class FqQueueDiscSetAssociativeTestCase : public TestCase
+{
+  public:
+    FqQueueDiscSetAssociativeTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Record the transmission of a packet
+     * \param item the transmitted item
+     */
+    void Send(Ptr<QueueDiscItem> item);
+
+    std::vector<std::pair<Time, uint32_t>> m_sent; //!< Times and flows of the transmissions
+};
+
+FqQueueDiscSetAssociativeTestCase::FqQueueDiscSetAssociativeTestCase()
+    : TestCase("Check that a throttled flow does not hold back the other flows of its set")
+{
+}
+
+void
+FqQueueDiscSetAssociativeTestCase::Send(Ptr<QueueDiscItem> item)
+{
+    m_sent.emplace_back(Simulator::Now(), item->Hash(0));
+}
+
+void
+FqQueueDiscSetAssociativeTestCase::DoRun()
+{
+    Ptr<FqQueueDisc> queue = CreateObjectWithAttributes<FqQueueDisc>("Flows",
+                                                                     UintegerValue(8),
+                                                                     "SetWays",
+                                                                     UintegerValue(8));
+    queue->SetQuantum(1500);
+    queue->SetSendCallback([this](Ptr<QueueDiscItem> item) { Send(item); });
+    queue->Initialize();
+
+    Address dest;
+    Ptr<Packet> p = Create<Packet>(1000);
+    p->AddPacketTag(EdtTag(MilliSeconds(1)));
+    queue->Enqueue(Create<FqQueueDiscTestItem>(p, dest, 1));
+    queue->Enqueue(Create<FqQueueDiscTestItem>(Create<Packet>(1000), dest, 9));
+    queue->Run();
+
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNQueueDiscClasses(), 2, "The flows should use two queues");
+    NS_TEST_ASSERT_MSG_EQ(m_sent.size(), 1, "The unpaced flow should not be throttled");
+    NS_TEST_EXPECT_MSG_EQ(m_sent[0].second, 9, "Unexpected flow");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNThrottledFlows(), 1, "The paced flow should be throttled");
+
+    // Fill the set: the 9th flow shares a queue
+    for (uint32_t i = 2; i <= 8; i++)
+    {
+        p = Create<Packet>(1000);
+        p->AddPacketTag(EdtTag(MilliSeconds(1)));
+        queue->Enqueue(Create<FqQueueDiscTestItem>(p, dest, 1 + i * 8));
+    }
+    queue->Enqueue(Create<FqQueueDiscTestItem>(Create<Packet>(1000), dest, 2));
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNQueueDiscClasses(), 8, "All the queues should be used");
+
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(m_sent.size(), 10, "All the packets should have been transmitted");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 0, "The queue disc should be empty");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Fq queue disc test suite
+ */
+class FqQueueDiscTestSuite : public TestSuite
+{
+  public:
+    FqQueueDiscTestSuite()
+        : TestSuite("fq-queue-disc", UNIT)
+    {
+        AddTestCase(new FqQueueDiscEdtTestCase(), TestCase::QUICK);
+        AddTestCase(new FqQueueDiscDropTestCase(), TestCase::QUICK);
+        AddTestCase(new FqQueueDiscSetAssociativeTestCase(), TestCase::QUICK);
+    }
+};
+
+static FqQueueDiscTestSuite g_fqQueueDiscTestSuite; ///< the test suite
@@ -0,0 +1,332 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "ns3/fifo-queue-disc.h"
+#include "ns3/htb-queue-disc.h"
+#include "ns3/log.h"
+#include "ns3/packet-filter.h"
+#include "ns3/packet.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/test.h"
+#include "ns3/uinteger.h"
+
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Item
+ */
+class HtbQueueDiscTestItem : public QueueDiscItem
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param p the packet
+     * \param addr the address
+     * \param cls the index of the class of the packet
+     */
+    HtbQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t cls);
+    void AddHeader() override;
+    bool Mark() override;
+    /**
+     * \return the index of the class of the packet
+     */
+    uint32_t GetClass() const;
+
+  private:
+    uint32_t m_cls; //!< the index of the class of the packet
+};
+
+HtbQueueDiscTestItem::HtbQueueDiscTestItem(Ptr<Packet> p, const Address& addr, uint32_t cls)
+    : QueueDiscItem(p, addr, 0),
+      m_cls(cls)
+{
+}
+
+void
+HtbQueueDiscTestItem::AddHeader()
+{
+}
+
+bool
+HtbQueueDiscTestItem::Mark()
+{
+    return false;
+}
+
+uint32_t
+HtbQueueDiscTestItem::GetClass() const
+{
+    return m_cls;
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb Queue Disc Test Packet Filter, returning the class of the test items
+ */
+class HtbQueueDiscTestFilter : public PacketFilter
+{
+  private:
+    bool CheckProtocol(Ptr<QueueDiscItem> item) const override;
+    int32_t DoClassify(Ptr<QueueDiscItem> item) const override;
+};
+
+bool
+HtbQueueDiscTestFilter::CheckProtocol(Ptr<QueueDiscItem> item) const
+{
+    return bool(DynamicCast<HtbQueueDiscTestItem>(item));
+}
+
+int32_t
+HtbQueueDiscTestFilter::DoClassify(Ptr<QueueDiscItem> item) const
+{
+    return StaticCast<HtbQueueDiscTestItem>(item)->GetClass();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the rates at which the Htb queue disc serves its classes
+ *
+ * Backlogged leaf classes are shaped for half a second and the number of
+ * packets transmitted by each of them is compared with the expected rate.
+ */
+class HtbQueueDiscRateTestCase : public TestCase
+{
+  public:
+    HtbQueueDiscRateTestCase();
+
+  private:
+    void DoRun() override;
+
+    /**
+     * Create a queue disc with the given leaf classes, fill them and run it
+     * \param parent the parent of the leaf classes
+     * \param leaves the rate and the ceil rate of each leaf class
+     * \return the number of packets transmitted by each leaf class
+     */
+    std::vector<uint32_t> RunQueueDisc(Ptr<HtbClass> parent,
+                                       const std::vector<std::pair<DataRate, DataRate>>& leaves);
+};
+
+HtbQueueDiscRateTestCase::HtbQueueDiscRateTestCase()
+    : TestCase("Check the rates of the classes of the Htb queue disc")
+{
+}
+
+std::vector<uint32_t>
+HtbQueueDiscRateTestCase::RunQueueDisc(Ptr<HtbClass> parent,
+                                       const std::vector<std::pair<DataRate, DataRate>>& leaves)
+{
+    Ptr<HtbQueueDisc> queue = CreateObject<HtbQueueDisc>();
+    for (const auto& [rate, ceil] : leaves)
+    {
+        Ptr<HtbClass> c = CreateObjectWithAttributes<HtbClass>("Parent",
+                                                               PointerValue(parent),
+                                                               "Rate",
+                                                               DataRateValue(rate),
+                                                               "Ceil",
+                                                               DataRateValue(ceil));
+        Ptr<QueueDisc> qd = CreateObject<FifoQueueDisc>();
+        qd->Initialize();
+        c->SetQueueDisc(qd);
+        queue->AddQueueDiscClass(c);
+    }
+    queue->AddPacketFilter(CreateObject<HtbQueueDiscTestFilter>());
+
+    std::vector<uint32_t> sent(leaves.size(), 0);
+    queue->SetSendCallback([&sent](Ptr<QueueDiscItem> item) {
+        if (Simulator::Now() < Seconds(0.5))
+        {
+            sent[StaticCast<HtbQueueDiscTestItem>(item)->GetClass()]++;
+        }
+    });
+    queue->Initialize();
+
+    Address dest;
+    for (uint32_t i = 0; i < 500; i++)
+    {
+        for (uint32_t cls = 0; cls < leaves.size(); cls++)
+        {
+            queue->Enqueue(Create<HtbQueueDiscTestItem>(Create<Packet>(1000), dest, cls));
+        }
+    }
+    queue->Run();
+    Simulator::Stop(Seconds(0.5));
+    Simulator::Run();
+    Simulator::Destroy();
+    return sent;
+}
+
+void
+HtbQueueDiscRateTestCase::DoRun()
+{
+    Ptr<HtbClass> root = CreateObjectWithAttributes<HtbClass>("Rate", DataRateValue(8e6));
+
+    // leaf classes sending at their rates (1000-byte packets every millisecond at 8Mbps)
+    std::vector<uint32_t> sent =
+        RunQueueDisc(root, {{DataRate(6e6), DataRate(8e6)}, {DataRate(2e6), DataRate(8e6)}});
+    NS_TEST_EXPECT_MSG_EQ_TOL(sent[0], 375, 3, "Unexpected number of packets of the first class");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sent[1], 125, 3, "Unexpected number of packets of the second class");
+
+    // a leaf class borrowing from its parent up to its ceil rate
+    sent = RunQueueDisc(root, {{DataRate(1e6), DataRate(4e6)}});
+    NS_TEST_EXPECT_MSG_EQ_TOL(sent[0], 250, 3, "The class should be limited by its ceil rate");
+
+    // two leaf classes sharing the rate borrowed from their parent
+    sent = RunQueueDisc(root, {{DataRate(1e6), DataRate(8e6)}, {DataRate(1e6), DataRate(8e6)}});
+    NS_TEST_EXPECT_MSG_EQ_TOL(sent[0], 250, 3, "The borrowed rate should be shared fairly");
+    NS_TEST_EXPECT_MSG_EQ_TOL(sent[1], 250, 3, "The borrowed rate should be shared fairly");
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check that the Htb queue disc uses a single wake-up event
+ *
+ * Many leaf classes are shaped: the number of events executed must not
+ * exceed the number of transmitted packets.
+ */
+class HtbQueueDiscWakeUpTestCase : public TestCase
+{
+  public:
+    HtbQueueDiscWakeUpTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+HtbQueueDiscWakeUpTestCase::HtbQueueDiscWakeUpTestCase()
+    : TestCase("Check that the Htb queue disc uses a single wake-up event")
+{
+}
+
+void
+HtbQueueDiscWakeUpTestCase::DoRun()
+{
+    Ptr<HtbClass> root = CreateObjectWithAttributes<HtbClass>("Rate", DataRateValue(8e6));
+    Ptr<HtbQueueDisc> queue = CreateObject<HtbQueueDisc>();
+    for (uint32_t i = 0; i < 50; i++)
+    {
+        Ptr<HtbClass> c = CreateObjectWithAttributes<HtbClass>("Parent",
+                                                               PointerValue(root),
+                                                               "Rate",
+                                                               DataRateValue(16e4),
+                                                               "Ceil",
+                                                               DataRateValue(8e6),
+                                                               "Burst",
+                                                               UintegerValue(500));
+        Ptr<QueueDisc> qd = CreateObject<FifoQueueDisc>();
+        qd->Initialize();
+        c->SetQueueDisc(qd);
+        queue->AddQueueDiscClass(c);
+    }
+    queue->AddPacketFilter(CreateObject<HtbQueueDiscTestFilter>());
+
+    uint32_t sent = 0;
+    queue->SetSendCallback([&sent](Ptr<QueueDiscItem> item) { sent++; });
+    queue->Initialize();
+
+    Address dest;
+    for (uint32_t i = 0; i < 20; i++)
+    {
+        for (uint32_t cls = 0; cls < 50; cls++)
+        {
+            queue->Enqueue(Create<HtbQueueDiscTestItem>(Create<Packet>(1000), dest, cls));
+        }
+    }
+    queue->Run();
+    Simulator::Run();
+
+    NS_TEST_EXPECT_MSG_EQ(sent, 1000, "All the packets should have been transmitted");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNActiveClasses(), 0, "No class should be active");
+    NS_TEST_EXPECT_MSG_LT_OR_EQ(Simulator::GetEventCount(),
+                                sent,
+                                "The number of wake-up events should not exceed the packets");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check that the Htb queue disc drops the packets with no class
+ */
+class HtbQueueDiscUnclassifiedTestCase : public TestCase
+{
+  public:
+    HtbQueueDiscUnclassifiedTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+HtbQueueDiscUnclassifiedTestCase::HtbQueueDiscUnclassifiedTestCase()
+    : TestCase("Check that the Htb queue disc drops the packets with no class")
+{
+}
+
+void
+HtbQueueDiscUnclassifiedTestCase::DoRun()
+{
+    Ptr<HtbQueueDisc> queue =
+        CreateObjectWithAttributes<HtbQueueDisc>("DefaultClass", UintegerValue(1));
+    Ptr<HtbClass> c = CreateObject<HtbClass>();
+    Ptr<QueueDisc> qd = CreateObject<FifoQueueDisc>();
+    qd->Initialize();
+    c->SetQueueDisc(qd);
+    queue->AddQueueDiscClass(c);
+    queue->Initialize();
+
+    Address dest;
+    queue->Enqueue(Create<HtbQueueDiscTestItem>(Create<Packet>(1000), dest, 0));
+    NS_TEST_EXPECT_MSG_EQ(queue->GetNPackets(), 0, "The packet should have been dropped");
+    NS_TEST_EXPECT_MSG_EQ(queue->GetStats().GetNDroppedPackets(HtbQueueDisc::UNCLASSIFIED_DROP),
+                          1,
+                          "The packet should have been dropped as unclassified");
+
+    Simulator::Destroy();
+}
+
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Htb queue disc test suite
+ */
+class HtbQueueDiscTestSuite : public TestSuite
+{
+  public:
+    HtbQueueDiscTestSuite()
+        : TestSuite("htb-queue-disc", UNIT)
+    {
+        AddTestCase(new HtbQueueDiscRateTestCase(), TestCase::QUICK);
+        AddTestCase(new HtbQueueDiscWakeUpTestCase(), TestCase::QUICK);
+        AddTestCase(new HtbQueueDiscUnclassifiedTestCase(), TestCase::QUICK);
+    }
+};
+
+static HtbQueueDiscTestSuite g_htbQueueDiscTestSuite; ///< the test suite
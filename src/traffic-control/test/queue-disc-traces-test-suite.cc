@@ -26,6 +26,7 @@
 #include "ns3/test.h"
 
 #include <map>
+#include <sstream>
 
 using namespace ns3;
 
@@ -589,6 +590,79 @@ QueueDiscTracesTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Check the records of the queue disc telemetry ring
+ *
+ * Packets are dropped before enqueue, dropped after dequeue and dequeued by
+ * a queue disc whose telemetry ring is smaller than the number of records:
+ * the most recent records must be kept, from the oldest one, and written
+ * to a binary stream.
+ */
+class QueueDiscTelemetryTestCase : public TestCase
+{
+  public:
+    QueueDiscTelemetryTestCase();
+    void DoRun() override;
+};
+
+QueueDiscTelemetryTestCase::QueueDiscTelemetryTestCase()
+    : TestCase("Check the records of the queue disc telemetry ring")
+{
+}
+
+void
+QueueDiscTelemetryTestCase::DoRun()
+{
+    Address dest;
+    Ptr<QueueDisc> qd = CreateObject<TestChildQueueDisc>();
+    qd->SetTelemetrySize(4);
+    qd->Initialize();
+
+    // the last two packets are dropped before enqueue
+    for (uint32_t i = 1; i <= 6; i++)
+    {
+        qd->Enqueue(Create<qdTestItem>(Create<Packet>(100 * i), dest));
+    }
+
+    // the first two packets are dropped after dequeue and the third one is dequeued
+    Simulator::Schedule(MilliSeconds(1), [qd]() { qd->Dequeue(); });
+    Simulator::Run();
+
+    QueueDiscTelemetry& telemetry = qd->GetTelemetry();
+    NS_TEST_ASSERT_MSG_EQ(telemetry.GetNTotalRecords(), 5, "Unexpected number of records");
+    NS_TEST_ASSERT_MSG_EQ(telemetry.GetNRecords(), 4, "The ring should be full");
+
+    std::vector<uint32_t> sizes{600, 100, 200, 300};
+    std::vector<std::string> reasons{TestChildQueueDisc::BEFORE_ENQUEUE,
+                                     TestChildQueueDisc::AFTER_DEQUEUE,
+                                     TestChildQueueDisc::AFTER_DEQUEUE,
+                                     ""};
+    for (uint32_t i = 0; i < 4; i++)
+    {
+        const QueueDiscTelemetry::Record& record = telemetry.GetRecord(i);
+        NS_TEST_EXPECT_MSG_EQ(record.size, sizes[i], "Unexpected size of record " << i);
+        NS_TEST_EXPECT_MSG_EQ(telemetry.GetReason(record.reason),
+                              reasons[i],
+                              "Unexpected reason of record " << i);
+        NS_TEST_EXPECT_MSG_EQ(record.sojourn,
+                              (i == 0 ? Time(0) : MilliSeconds(1)),
+                              "Unexpected sojourn time of record " << i);
+    }
+
+    std::ostringstream os;
+    telemetry.Write(os);
+    // reasons: count, "", "Before enqueue", "After dequeue"; records: count, 4 x 26 bytes
+    NS_TEST_EXPECT_MSG_EQ(os.str().size(), 2 + 1 + 15 + 14 + 4 + 4 * 26, "Unexpected size");
+
+    telemetry.Clear();
+    NS_TEST_EXPECT_MSG_EQ(telemetry.GetNRecords(), 0, "The ring should be empty");
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  * \ingroup tests
@@ -602,5 +676,6 @@ static class QueueDiscTracesTestSuite : public TestSuite
         : TestSuite("queue-disc-traces", UNIT)
     {
         AddTestCase(new QueueDiscTracesTestCase(), TestCase::QUICK);
+        AddTestCase(new QueueDiscTelemetryTestCase(), TestCase::QUICK);
     }
 } g_queueDiscTracesTestSuite; ///< the test suite
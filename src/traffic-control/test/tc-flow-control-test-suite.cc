@@ -27,7 +27,9 @@
 #include "ns3/node-container.h"
 #include "ns3/pointer.h"
 #include "ns3/queue.h"
+#include "ns3/simple-channel.h"
 #include "ns3/simple-net-device-helper.h"
+#include "ns3/simple-net-device.h"
 #include "ns3/simulator.h"
 #include "ns3/string.h"
 #include "ns3/test.h"
@@ -53,8 +55,9 @@ class QueueDiscTestItem : public QueueDiscItem
      * Constructor
      *
      * \param p the packet stored in this item
+     * \param hash the hash of the flow the packet belongs to
      */
-    QueueDiscTestItem(Ptr<Packet> p);
+    QueueDiscTestItem(Ptr<Packet> p, uint32_t hash = 0);
     ~QueueDiscTestItem() override;
 
     // Delete default constructor, copy constructor and assignment operator to avoid misuse
@@ -64,10 +67,15 @@ class QueueDiscTestItem : public QueueDiscItem
 
     void AddHeader() override;
     bool Mark() override;
+    uint32_t Hash(uint32_t perturbation) const override;
+
+  private:
+    uint32_t m_hash; //!< the hash of the flow the packet belongs to
 };
 
-QueueDiscTestItem::QueueDiscTestItem(Ptr<Packet> p)
-    : QueueDiscItem(p, Mac48Address(), 0)
+QueueDiscTestItem::QueueDiscTestItem(Ptr<Packet> p, uint32_t hash)
+    : QueueDiscItem(p, Mac48Address(), 0),
+      m_hash(hash)
 {
 }
 
@@ -86,6 +94,12 @@ QueueDiscTestItem::Mark()
     return false;
 }
 
+uint32_t
+QueueDiscTestItem::Hash(uint32_t perturbation) const
+{
+    return m_hash;
+}
+
 /**
  * \ingroup traffic-control-test
  * \ingroup tests
@@ -495,6 +509,89 @@ TcFlowControlTestCase::DoRun()
     Simulator::Destroy();
 }
 
+/**
+ * \ingroup traffic-control-test
+ * \ingroup tests
+ *
+ * \brief Traffic Control Transmission Queue Selection Test Case
+ *
+ * When a multi-queue device provides no select queue callback, the traffic
+ * control layer selects the transmission queue by hashing the flow of the
+ * packet: the packets of a flow must all be enqueued in the same child queue
+ * disc of mq, and different flows must be spread over all the child queue discs.
+ */
+class TcFlowHashTxQueueTestCase : public TestCase
+{
+  public:
+    TcFlowHashTxQueueTestCase();
+
+  private:
+    void DoRun() override;
+};
+
+TcFlowHashTxQueueTestCase::TcFlowHashTxQueueTestCase()
+    : TestCase("Test the selection of the transmission queue based on the flow hash")
+{
+}
+
+void
+TcFlowHashTxQueueTestCase::DoRun()
+{
+    const uint32_t nTxQueues = 4;
+    const uint32_t nFlows = 8;
+    const uint32_t nPacketsPerFlow = 3;
+
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    node->AggregateObject(tc);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    Ptr<SimpleNetDevice> txDev = CreateObject<SimpleNetDevice>();
+    txDev->SetAddress(Mac48Address::Allocate());
+    txDev->SetChannel(channel);
+    node->AddDevice(txDev);
+
+    // a multi-queue device without a select queue callback
+    Ptr<NetDeviceQueueInterface> ndqi =
+        CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues", UintegerValue(nTxQueues));
+    txDev->AggregateObject(ndqi);
+
+    TrafficControlHelper tch;
+    uint16_t handle = tch.SetRootQueueDisc("ns3::MqQueueDisc");
+    TrafficControlHelper::ClassIdList cls =
+        tch.AddQueueDiscClasses(handle, nTxQueues, "ns3::QueueDiscClass");
+    tch.AddChildQueueDiscs(handle, cls, "ns3::FifoQueueDisc");
+    QueueDiscContainer qdiscs = tch.Install(txDev);
+    Ptr<QueueDisc> mq = qdiscs.Get(0);
+    // the traffic control layer sets up the queue discs of the devices when initialized
+    node->Initialize();
+
+    // the packets of each flow are sent one after the other; a flow with
+    // hash h must be assigned to the child queue disc h % nTxQueues
+    for (uint32_t flow = 0; flow < nFlows; flow++)
+    {
+        for (uint32_t i = 0; i < nPacketsPerFlow; i++)
+        {
+            tc->Send(txDev, Create<QueueDiscTestItem>(Create<Packet>(1000), flow));
+        }
+        uint32_t txq = flow % nTxQueues;
+        NS_TEST_EXPECT_MSG_EQ(
+            mq->GetQueueDiscClass(txq)->GetQueueDisc()->GetStats().nTotalReceivedPackets,
+            (flow / nTxQueues + 1) * nPacketsPerFlow,
+            "All the packets of flow " << flow << " must be sent through queue " << txq);
+    }
+
+    for (uint32_t txq = 0; txq < nTxQueues; txq++)
+    {
+        NS_TEST_EXPECT_MSG_EQ(
+            mq->GetQueueDiscClass(txq)->GetQueueDisc()->GetStats().nTotalReceivedPackets,
+            nFlows / nTxQueues * nPacketsPerFlow,
+            "The flows must be spread evenly over the transmission queues");
+    }
+
+    Simulator::Destroy();
+}
+
 /**
  * \ingroup traffic-control-test
  * \ingroup tests
@@ -520,5 +617,6 @@ static class TcFlowControlTestSuite : public TestSuite
         // TODO: Right now, this test only works for 5000B and 10 packets (it's hard coded). Should
         // also be made parametric.
         AddTestCase(new TcFlowControlTestCase(QueueSizeUnit::BYTES, 5000, 10), TestCase::QUICK);
+        AddTestCase(new TcFlowHashTxQueueTestCase(), TestCase::QUICK);
     }
 } g_tcFlowControlTestSuite; ///< the test suite
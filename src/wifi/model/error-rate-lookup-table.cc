@@ -0,0 +1,172 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#include "error-rate-lookup-table.h"
+
+#include "ns3/abort.h"
+#include "ns3/log.h"
+
+#include <algorithm>
+#include <cmath>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <sstream>
+
+namespace ns3
+{
+
+NS_LOG_COMPONENT_DEFINE("ErrorRateLookupTable");
+
+const double ErrorRateLookupTable::MIN_SNR_DB = -10;
+const double ErrorRateLookupTable::MAX_SNR_DB = 60;
+
+ErrorRateLookupTable::ErrorRateLookupTable(double resolution, const std::string& filename)
+    : m_resolution(resolution),
+      m_filename(filename),
+      m_loaded(false)
+{
+    NS_LOG_FUNCTION(this << resolution << filename);
+    NS_ABORT_MSG_IF(resolution <= 0 || resolution > MAX_SNR_DB - MIN_SNR_DB,
+                    "Invalid resolution of the lookup tables: " << resolution << " dB");
+    m_size = static_cast<std::size_t>((MAX_SNR_DB - MIN_SNR_DB) / resolution) + 1;
+}
+
+bool
+ErrorRateLookupTable::Contains(uint64_t key) const
+{
+    return m_tables.find(key) != m_tables.end();
+}
+
+void
+ErrorRateLookupTable::Generate(uint64_t key,
+                               const std::string& name,
+                               BitSuccessRateFunction bitSuccessRate)
+{
+    NS_LOG_FUNCTION(this << key << name);
+    NS_ASSERT(!Contains(key));
+    if (!m_loaded && !m_filename.empty())
+    {
+        Load();
+    }
+    m_loaded = true;
+
+    auto namedIt = m_named.find(name);
+    if (namedIt != m_named.end())
+    {
+        NS_LOG_DEBUG("Table " << name << " loaded from " << m_filename);
+        m_tables.emplace(key, namedIt->second);
+        return;
+    }
+
+    NS_LOG_DEBUG("Generate table " << name << " with " << m_size << " points");
+    Table table(m_size);
+    for (std::size_t i = 0; i < m_size; i++)
+    {
+        double snr = std::pow(10.0, (MIN_SNR_DB + i * m_resolution) / 10.0);
+        // the bit error probability is zero when the BER underflows
+        double pe = 1 - bitSuccessRate(snr);
+        table[i] = std::log(std::max(pe, std::numeric_limits<double>::min()));
+    }
+    m_tables.emplace(key, table);
+    m_named.emplace(name, table);
+    if (!m_filename.empty())
+    {
+        Save();
+    }
+}
+
+std::optional<double>
+ErrorRateLookupTable::GetChunkSuccessRate(uint64_t key, double snr, uint64_t nbits) const
+{
+    auto it = m_tables.find(key);
+    NS_ASSERT(it != m_tables.end());
+    double x = (10 * std::log10(snr) - MIN_SNR_DB) / m_resolution;
+    if (!(x >= 0 && x <= m_size - 1))
+    {
+        return std::nullopt;
+    }
+    std::size_t i = std::min(static_cast<std::size_t>(x), m_size - 2);
+    const Table& table = it->second;
+    double logPe = table[i] + (x - i) * (table[i + 1] - table[i]);
+    return std::pow(1 - std::exp(logPe), nbits);
+}
+
+void
+ErrorRateLookupTable::Load()
+{
+    NS_LOG_FUNCTION(this);
+    std::ifstream file(m_filename);
+    if (!file.is_open())
+    {
+        NS_LOG_DEBUG("No lookup tables in " << m_filename);
+        return;
+    }
+    std::string line;
+    while (std::getline(file, line))
+    {
+        if (line.empty() || line[0] == '#')
+        {
+            continue;
+        }
+        std::istringstream iss(line);
+        std::string name;
+        double resolution;
+        double minSnr;
+        std::size_t size;
+        iss >> name >> resolution >> minSnr >> size;
+        if (!iss || resolution != m_resolution || minSnr != MIN_SNR_DB || size != m_size)
+        {
+            NS_LOG_DEBUG("Skip table " << name << " of " << m_filename);
+            continue;
+        }
+        Table table(size);
+        for (auto& value : table)
+        {
+            iss >> value;
+        }
+        if (!iss)
+        {
+            NS_LOG_WARN("Malformed table " << name << " in " << m_filename);
+            continue;
+        }
+        m_named[name] = table;
+    }
+}
+
+void
+ErrorRateLookupTable::Save() const
+{
+    NS_LOG_FUNCTION(this);
+    std::ofstream file(m_filename);
+    if (!file.is_open())
+    {
+        NS_FATAL_ERROR("Can't open file " << m_filename << " to save the lookup tables");
+    }
+    file << "# name resolution (dB) minimum SNR (dB) size log(bit error probability)..."
+         << std::endl;
+    file << std::setprecision(std::numeric_limits<double>::max_digits10);
+    for (const auto& [name, table] : m_named)
+    {
+        file << name << " " << m_resolution << " " << MIN_SNR_DB << " " << table.size();
+        for (auto value : table)
+        {
+            file << " " << value;
+        }
+        file << std::endl;
+    }
+}
+
+} // namespace ns3
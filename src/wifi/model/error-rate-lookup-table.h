@@ -0,0 +1,116 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+#ifndef ERROR_RATE_LOOKUP_TABLE_H
+#define ERROR_RATE_LOOKUP_TABLE_H
+
+#include <functional>
+#include <map>
+#include <optional>
+#include <string>
+#include <vector>
+
+namespace ns3
+{
+
+/**
+ * \ingroup wifi
+ * \brief Precomputed chunk success rates of an error rate model
+ *
+ * The error rate models whose chunk success rate is (1 - p)^nbits, where p
+ * is the probability that a bit is in error after decoding (which only
+ * depends on the SNR for a given mode), can replace the evaluation of p by
+ * a lookup in a table of p sampled on a grid of SNR values (in dB). The
+ * logarithm of p is interpolated linearly between the points of the grid,
+ * and the chunk length is accounted for exactly.
+ *
+ * Each table is identified by a key chosen by the error rate model, and
+ * generated the first time it is needed. The tables can be saved to a file,
+ * in which they are identified by a name, so that they are loaded rather
+ * than generated again by the next simulations using the same resolution.
+ */
+class ErrorRateLookupTable
+{
+  public:
+    /**
+     * Callback computing the probability that a bit is successfully received
+     * at a given SNR (linear scale), i.e. the chunk success rate of one bit.
+     */
+    using BitSuccessRateFunction = std::function<double(double)>;
+
+    /**
+     * Constructor
+     *
+     * \param resolution the step of the grid of SNR values (dB)
+     * \param filename the file from which the tables are loaded and to which
+     *                 they are saved, if not empty
+     */
+    ErrorRateLookupTable(double resolution, const std::string& filename);
+
+    /**
+     * \param key the key of a table
+     * \return whether the table has been generated
+     */
+    bool Contains(uint64_t key) const;
+
+    /**
+     * Generate a table, or load it from the file if it is found there. When a
+     * table is generated, all the tables are saved to the file.
+     *
+     * \param key the key of the table
+     * \param name the name of the table in the file
+     * \param bitSuccessRate the bit success rate as a function of the SNR
+     */
+    void Generate(uint64_t key, const std::string& name, BitSuccessRateFunction bitSuccessRate);
+
+    /**
+     * Look up the chunk success rate in a table.
+     *
+     * \param key the key of the table, which must have been generated
+     * \param snr the SNR of the chunk (linear scale)
+     * \param nbits the number of bits in the chunk
+     * \return the chunk success rate, or nothing if the SNR is out of the
+     *         range of the table
+     */
+    std::optional<double> GetChunkSuccessRate(uint64_t key, double snr, uint64_t nbits) const;
+
+    static const double MIN_SNR_DB; //!< the lowest SNR of the tables (dB)
+    static const double MAX_SNR_DB; //!< the highest SNR of the tables (dB)
+
+  private:
+    /**
+     * Load the tables of the file with the same grid of SNR values.
+     */
+    void Load();
+
+    /**
+     * Save the generated tables, and those loaded from the file, to the file.
+     */
+    void Save() const;
+
+    /// The logarithm of the bit error probability at each point of the grid
+    using Table = std::vector<double>;
+
+    double m_resolution;                  //!< the step of the grid of SNR values (dB)
+    std::size_t m_size;                   //!< the number of points of the grid
+    std::string m_filename;               //!< the file of the tables
+    bool m_loaded;                        //!< whether the file has been loaded
+    std::map<uint64_t, Table> m_tables;   //!< the tables indexed by key
+    std::map<std::string, Table> m_named; //!< the tables indexed by name
+};
+
+} // namespace ns3
+
+#endif /* ERROR_RATE_LOOKUP_TABLE_H */
@@ -38,6 +38,9 @@ namespace ns3
 
 NS_LOG_COMPONENT_DEFINE("InterferenceHelper");
 
+/// The minimum number of NiChanges of a band above which it is pruned during a reception
+static const std::size_t NI_CHANGES_MIN_PRUNE_SIZE = 32;
+
 NS_OBJECT_ENSURE_REGISTERED(InterferenceHelper);
 
 /****************************************************************
@@ -242,12 +245,7 @@ void
 InterferenceHelper::RemoveBands()
 {
     NS_LOG_FUNCTION(this);
-    for (auto it : m_niChangesPerBand)
-    {
-        it.second.clear();
-    }
     m_niChangesPerBand.clear();
-    m_firstPowerPerBand.clear();
 }
 
 void
@@ -255,12 +253,11 @@ InterferenceHelper::AddBand(WifiSpectrumBand band)
 {
     NS_LOG_FUNCTION(this << band.first << band.second);
     NS_ASSERT(m_niChangesPerBand.find(band) == m_niChangesPerBand.end());
-    NiChanges niChanges;
-    auto result = m_niChangesPerBand.insert({band, niChanges});
+    auto result = m_niChangesPerBand.insert(
+        {band, BandNiChanges{NiChanges(), 0.0, NI_CHANGES_MIN_PRUNE_SIZE}});
     NS_ASSERT(result.second);
     // Always have a zero power noise event in the list
     AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), result.first);
-    m_firstPowerPerBand.insert({band, 0.0});
 }
 
 void
@@ -295,7 +292,7 @@ InterferenceHelper::GetEnergyDuration(double energyW, WifiSpectrumBand band)
     NS_ASSERT(niIt != m_niChangesPerBand.end());
     auto i = GetPreviousPosition(now, niIt);
     Time end = i->first;
-    for (; i != niIt->second.end(); ++i)
+    for (; i != niIt->second.niChanges.end(); ++i)
     {
         double noiseInterferenceW = i->second.GetPower();
         end = i->first;
@@ -316,6 +313,7 @@ InterferenceHelper::AppendEvent(Ptr<Event> event, bool isStartOfdmaRxing)
         WifiSpectrumBand band = it.first;
         auto niIt = m_niChangesPerBand.find(band);
         NS_ASSERT(niIt != m_niChangesPerBand.end());
+        NiChanges& niChanges = niIt->second.niChanges;
         double previousPowerStart = 0;
         double previousPowerEnd = 0;
         auto previousPowerPosition = GetPreviousPosition(event->GetStartTime(), niIt);
@@ -323,20 +321,31 @@ InterferenceHelper::AppendEvent(Ptr<Event> event, bool isStartOfdmaRxing)
         previousPowerEnd = GetPreviousPosition(event->GetEndTime(), niIt)->second.GetPower();
         if (!m_rxing)
         {
-            m_firstPowerPerBand.find(band)->second = previousPowerStart;
+            niIt->second.firstPower = previousPowerStart;
             // Always leave the first zero power noise event in the list
-            niIt->second.erase(++(niIt->second.begin()), ++previousPowerPosition);
+            niChanges.erase(niChanges.begin() + 1, ++previousPowerPosition);
         }
-        else if (isStartOfdmaRxing)
+        else
         {
-            // When the first UL-OFDMA payload is received, we need to set m_firstPowerPerBand
-            // so that it takes into account interferences that arrived between the start of the
-            // UL MU transmission and the start of UL-OFDMA payload.
-            m_firstPowerPerBand.find(band)->second = previousPowerStart;
+            if (isStartOfdmaRxing)
+            {
+                // When the first UL-OFDMA payload is received, we need to set the first power
+                // so that it takes into account interferences that arrived between the start of
+                // the UL MU transmission and the start of UL-OFDMA payload.
+                niIt->second.firstPower = previousPowerStart;
+            }
+            if (niChanges.size() >= niIt->second.pruneSize)
+            {
+                PruneNiChanges(niIt);
+            }
         }
         auto first =
             AddNiChangeEvent(event->GetStartTime(), NiChange(previousPowerStart, event), niIt);
+        // the NiChange at the end of the event is added after the one at its start, which
+        // is hence not moved, but whose iterator is invalidated
+        std::size_t firstIndex = first - niChanges.begin();
         auto last = AddNiChangeEvent(event->GetEndTime(), NiChange(previousPowerEnd, event), niIt);
+        first = niChanges.begin() + firstIndex;
         for (auto i = first; i != last; ++i)
         {
             i->second.AddPower(it.second);
@@ -344,6 +353,33 @@ InterferenceHelper::AppendEvent(Ptr<Event> event, bool isStartOfdmaRxing)
     }
 }
 
+void
+InterferenceHelper::PruneNiChanges(NiChangesPerBand::iterator niIt)
+{
+    NS_LOG_FUNCTION(this << niIt->first.first << niIt->first.second);
+    NiChanges& niChanges = niIt->second.niChanges;
+    // The events that have not ended have a NiChange at their end time, which is not
+    // earlier than now: find the oldest start time of these events
+    Time now = Simulator::Now();
+    Time oldestStart = now;
+    for (auto it = GetNextPosition(now - TimeStep(1), niIt); it != niChanges.end(); ++it)
+    {
+        Ptr<Event> event = it->second.GetEvent();
+        if (event && event->GetStartTime() < oldestStart)
+        {
+            oldestStart = event->GetStartTime();
+        }
+    }
+    // Keep the zero power noise event and the two NiChanges before the oldest start time,
+    // which give the power before it and before the last NiChange preceding it
+    auto first = GetNextPosition(oldestStart - TimeStep(1), niIt);
+    if (first - niChanges.begin() > 3)
+    {
+        niChanges.erase(niChanges.begin() + 1, first - 2);
+    }
+    niIt->second.pruneSize = std::max(NI_CHANGES_MIN_PRUNE_SIZE, 2 * niChanges.size());
+}
+
 void
 InterferenceHelper::UpdateEvent(Ptr<Event> event, const RxPowerWattPerChannelBand& rxPower)
 {
@@ -398,34 +434,44 @@ InterferenceHelper::CalculateSnr(double signal,
 
 double
 InterferenceHelper::CalculateNoiseInterferenceW(Ptr<Event> event,
-                                                NiChangesPerBand* nis,
+                                                NiChanges* nis,
                                                 WifiSpectrumBand band) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second);
-    auto firstPower_it = m_firstPowerPerBand.find(band);
-    NS_ASSERT(firstPower_it != m_firstPowerPerBand.end());
-    double noiseInterferenceW = firstPower_it->second;
     auto niIt = m_niChangesPerBand.find(band);
     NS_ASSERT(niIt != m_niChangesPerBand.end());
-    auto it = niIt->second.find(event->GetStartTime());
-    for (; it != niIt->second.end() && it->first < Simulator::Now(); ++it)
+    const NiChanges& niChanges = niIt->second.niChanges;
+    double noiseInterferenceW = niIt->second.firstPower;
+    double powerW = event->GetRxPowerW(band);
+    Time now = Simulator::Now();
+    // the first NiChange at the start time of the event
+    auto start = std::lower_bound(niChanges.cbegin(),
+                                  niChanges.cend(),
+                                  event->GetStartTime(),
+                                  [](const std::pair<Time, NiChange>& niChange, Time moment) {
+                                      return niChange.first < moment;
+                                  });
+    NS_ASSERT(start != niChanges.cend() && start->first == event->GetStartTime());
+    auto it = start;
+    for (; it != niChanges.cend() && it->first < now; ++it)
     {
-        noiseInterferenceW = it->second.GetPower() - event->GetRxPowerW(band);
+        noiseInterferenceW = it->second.GetPower() - powerW;
     }
-    it = niIt->second.find(event->GetStartTime());
-    NS_ASSERT(it != niIt->second.end());
-    for (; it != niIt->second.end() && it->second.GetEvent() != event; ++it)
+    it = start;
+    for (; it != niChanges.cend() && it->second.GetEvent() != event; ++it)
     {
         ;
     }
-    NiChanges ni;
-    ni.emplace(event->GetStartTime(), NiChange(0, event));
-    while (++it != niIt->second.end() && it->second.GetEvent() != event)
+    auto end = it;
+    while (++end != niChanges.cend() && end->second.GetEvent() != event)
     {
-        ni.insert(*it);
+        ;
     }
-    ni.emplace(event->GetEndTime(), NiChange(0, event));
-    nis->insert({band, ni});
+    nis->clear();
+    nis->reserve(end - it + 1);
+    nis->emplace_back(event->GetStartTime(), NiChange(0, event));
+    nis->insert(nis->end(), it + 1, end);
+    nis->emplace_back(event->GetEndTime(), NiChange(0, event));
     NS_ASSERT_MSG(noiseInterferenceW >= 0,
                   "CalculateNoiseInterferenceW returns negative value " << noiseInterferenceW);
     return noiseInterferenceW;
@@ -477,7 +523,7 @@ InterferenceHelper::CalculatePayloadChunkSuccessRate(double snir,
 double
 InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
                                         uint16_t channelWidth,
-                                        NiChangesPerBand* nis,
+                                        const NiChanges& nis,
                                         WifiSpectrumBand band,
                                         uint16_t staId,
                                         std::pair<Time, Time> window) const
@@ -485,8 +531,7 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << staId << window.first
                          << window.second);
     double psr = 1.0; /* Packet Success Rate */
-    const auto& niIt = nis->find(band)->second;
-    auto j = niIt.cbegin();
+    auto j = nis.cbegin();
     Time previous = j->first;
     WifiMode payloadMode = event->GetTxVector().GetMode(staId);
     Time phyPayloadStart = j->first;
@@ -499,9 +544,9 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
     }
     Time windowStart = phyPayloadStart + window.first;
     Time windowEnd = phyPayloadStart + window.second;
-    double noiseInterferenceW = m_firstPowerPerBand.find(band)->second;
+    double noiseInterferenceW = m_niChangesPerBand.find(band)->second.firstPower;
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.cend())
+    while (++j != nis.cend())
     {
         Time current = j->first;
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
@@ -547,15 +592,14 @@ InterferenceHelper::CalculatePayloadPer(Ptr<const Event> event,
 double
 InterferenceHelper::CalculatePhyHeaderSectionPsr(
     Ptr<const Event> event,
-    NiChangesPerBand* nis,
+    const NiChanges& nis,
     uint16_t channelWidth,
     WifiSpectrumBand band,
     PhyEntity::PhyHeaderSections phyHeaderSections) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second);
     double psr = 1.0; /* Packet Success Rate */
-    auto niIt = nis->find(band)->second;
-    auto j = niIt.begin();
+    auto j = nis.cbegin();
 
     NS_ASSERT(!phyHeaderSections.empty());
     Time stopLastSection = Seconds(0);
@@ -565,9 +609,9 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
     }
 
     Time previous = j->first;
-    double noiseInterferenceW = m_firstPowerPerBand.find(band)->second;
+    double noiseInterferenceW = m_niChangesPerBand.find(band)->second.firstPower;
     double powerW = event->GetRxPowerW(band);
-    while (++j != niIt.end())
+    while (++j != nis.cend())
     {
         Time current = j->first;
         NS_LOG_DEBUG("previous= " << previous << ", current=" << current);
@@ -609,18 +653,17 @@ InterferenceHelper::CalculatePhyHeaderSectionPsr(
 
 double
 InterferenceHelper::CalculatePhyHeaderPer(Ptr<const Event> event,
-                                          NiChangesPerBand* nis,
+                                          const NiChanges& nis,
                                           uint16_t channelWidth,
                                           WifiSpectrumBand band,
                                           WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << header);
-    auto niIt = nis->find(band)->second;
     auto phyEntity = WifiPhy::GetStaticPhyEntity(event->GetTxVector().GetModulationClass());
 
     PhyEntity::PhyHeaderSections sections;
     for (const auto& section :
-         phyEntity->GetPhyHeaderSections(event->GetTxVector(), niIt.begin()->first))
+         phyEntity->GetPhyHeaderSections(event->GetTxVector(), nis.front().first))
     {
         if (section.first == header)
         {
@@ -645,7 +688,7 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
 {
     NS_LOG_FUNCTION(this << channelWidth << band.first << band.second << staId
                          << relativeMpduStartStop.first << relativeMpduStartStop.second);
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band);
     double snr = CalculateSnr(event->GetRxPowerW(band),
                               noiseInterferenceW,
@@ -655,7 +698,7 @@ InterferenceHelper::CalculatePayloadSnrPer(Ptr<Event> event,
     /* calculate the SNIR at the start of the MPDU (located through windowing) and accumulate
      * all SNIR changes in the SNIR vector.
      */
-    double per = CalculatePayloadPer(event, channelWidth, &ni, band, staId, relativeMpduStartStop);
+    double per = CalculatePayloadPer(event, channelWidth, ni, band, staId, relativeMpduStartStop);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -666,7 +709,7 @@ InterferenceHelper::CalculateSnr(Ptr<Event> event,
                                  uint8_t nss,
                                  WifiSpectrumBand band) const
 {
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, nss);
     return snr;
@@ -679,14 +722,14 @@ InterferenceHelper::CalculatePhyHeaderSnrPer(Ptr<Event> event,
                                              WifiPpduField header) const
 {
     NS_LOG_FUNCTION(this << band.first << band.second << header);
-    NiChangesPerBand ni;
+    NiChanges ni;
     double noiseInterferenceW = CalculateNoiseInterferenceW(event, &ni, band);
     double snr = CalculateSnr(event->GetRxPowerW(band), noiseInterferenceW, channelWidth, 1);
 
     /* calculate the SNIR at the start of the PHY header and accumulate
      * all SNIR changes in the SNIR vector.
      */
-    double per = CalculatePhyHeaderPer(event, &ni, channelWidth, band, header);
+    double per = CalculatePhyHeaderPer(event, ni, channelWidth, band, header);
 
     return PhyEntity::SnrPer(snr, per);
 }
@@ -696,10 +739,11 @@ InterferenceHelper::EraseEvents()
 {
     for (auto niIt = m_niChangesPerBand.begin(); niIt != m_niChangesPerBand.end(); ++niIt)
     {
-        niIt->second.clear();
+        niIt->second.niChanges.clear();
         // Always have a zero power noise event in the list
         AddNiChangeEvent(Time(0), NiChange(0.0, nullptr), niIt);
-        m_firstPowerPerBand.at(niIt->first) = 0.0;
+        niIt->second.firstPower = 0.0;
+        niIt->second.pruneSize = NI_CHANGES_MIN_PRUNE_SIZE;
     }
     m_rxing = false;
 }
@@ -707,7 +751,12 @@ InterferenceHelper::EraseEvents()
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::GetNextPosition(Time moment, NiChangesPerBand::iterator niIt)
 {
-    return niIt->second.upper_bound(moment);
+    return std::upper_bound(niIt->second.niChanges.begin(),
+                            niIt->second.niChanges.end(),
+                            moment,
+                            [](Time moment, const std::pair<Time, NiChange>& niChange) {
+                                return moment < niChange.first;
+                            });
 }
 
 InterferenceHelper::NiChanges::iterator
@@ -723,7 +772,8 @@ InterferenceHelper::GetPreviousPosition(Time moment, NiChangesPerBand::iterator
 InterferenceHelper::NiChanges::iterator
 InterferenceHelper::AddNiChangeEvent(Time moment, NiChange change, NiChangesPerBand::iterator niIt)
 {
-    return niIt->second.insert(GetNextPosition(moment, niIt), std::make_pair(moment, change));
+    return niIt->second.niChanges.insert(GetNextPosition(moment, niIt),
+                                         std::make_pair(moment, change));
 }
 
 void
@@ -738,13 +788,13 @@ InterferenceHelper::NotifyRxEnd(Time endTime)
 {
     NS_LOG_FUNCTION(this << endTime);
     m_rxing = false;
-    // Update m_firstPowerPerBand for frame capture
+    // Update the first power of each band for frame capture
     for (auto niIt = m_niChangesPerBand.begin(); niIt != m_niChangesPerBand.end(); ++niIt)
     {
-        NS_ASSERT(niIt->second.size() > 1);
+        NS_ASSERT(niIt->second.niChanges.size() > 1);
         auto it = GetPreviousPosition(endTime, niIt);
         it--;
-        m_firstPowerPerBand.find(niIt->first)->second = it->second.GetPower();
+        niIt->second.firstPower = it->second.GetPower();
     }
 }
 
@@ -25,6 +25,9 @@
 
 #include "ns3/object.h"
 
+#include <map>
+#include <vector>
+
 namespace ns3
 {
 
@@ -385,14 +388,27 @@ class InterferenceHelper : public Object
     };
 
     /**
-     * typedef for a multimap of NiChange
+     * Vector of NiChanges sorted by time, the NiChanges at the same time being sorted
+     * in the order they were added. The power of a NiChange is the total noise and
+     * interference power from its time until the time of the next NiChange, i.e. the
+     * running sum of the powers of the signals started and not ended before its time.
      */
-    typedef std::multimap<Time, NiChange> NiChanges;
+    typedef std::vector<std::pair<Time, NiChange>> NiChanges;
+
+    /**
+     * The NiChanges of a band, with the state used to process them
+     */
+    struct BandNiChanges
+    {
+        NiChanges niChanges;   //!< the NiChanges of the band
+        double firstPower;     //!< the power (W) before the start of the reception
+        std::size_t pruneSize; //!< the number of NiChanges above which the band is pruned
+    };
 
     /**
      * Map of NiChanges per band
      */
-    typedef std::map<WifiSpectrumBand, NiChanges> NiChangesPerBand;
+    typedef std::map<WifiSpectrumBand, BandNiChanges> NiChangesPerBand;
 
     /**
      * Append the given Event.
@@ -403,17 +419,27 @@ class InterferenceHelper : public Object
      */
     void AppendEvent(Ptr<Event> event, bool isStartOfdmaRxing);
 
+    /**
+     * Remove the NiChanges of a band that can no longer be used, while a
+     * reception is in progress: the events that have ended can no longer be
+     * processed, hence only the NiChanges from the start of the oldest event
+     * that has not ended, and the two NiChanges before it, are kept.
+     *
+     * \param niIt iterator of the band to prune
+     */
+    void PruneNiChanges(NiChangesPerBand::iterator niIt);
+
     /**
      * Calculate noise and interference power in W.
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event, which are set by this function
      * \param band the band
      *
      * \return noise and interference power
      */
     double CalculateNoiseInterferenceW(Ptr<Event> event,
-                                       NiChangesPerBand* nis,
+                                       NiChanges* nis,
                                        WifiSpectrumBand band) const;
     /**
      * Calculate the error rate of the given PHY payload only in the provided time
@@ -422,7 +448,7 @@ class InterferenceHelper : public Object
      *
      * \param event the event
      * \param channelWidth the channel width used to transmit the PSDU (in MHz)
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param band identify the band used by the PSDU
      * \param staId the station ID of the PSDU (only used for MU)
      * \param window time window (pair of start and end times) of PHY payload to focus on
@@ -431,7 +457,7 @@ class InterferenceHelper : public Object
      */
     double CalculatePayloadPer(Ptr<const Event> event,
                                uint16_t channelWidth,
-                               NiChangesPerBand* nis,
+                               const NiChanges& nis,
                                WifiSpectrumBand band,
                                uint16_t staId,
                                std::pair<Time, Time> window) const;
@@ -440,7 +466,7 @@ class InterferenceHelper : public Object
      * can be divided into multiple chunks (e.g. due to interference from other transmissions).
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param header the PHY header to consider
@@ -448,7 +474,7 @@ class InterferenceHelper : public Object
      * \return the error rate of the HT PHY header
      */
     double CalculatePhyHeaderPer(Ptr<const Event> event,
-                                 NiChangesPerBand* nis,
+                                 const NiChanges& nis,
                                  uint16_t channelWidth,
                                  WifiSpectrumBand band,
                                  WifiPpduField header) const;
@@ -456,7 +482,7 @@ class InterferenceHelper : public Object
      * Calculate the success rate of the PHY header sections for the provided event.
      *
      * \param event the event
-     * \param nis the NiChanges
+     * \param nis the NiChanges of the band during the event
      * \param channelWidth the channel width (in MHz) for header measurement
      * \param band the band
      * \param phyHeaderSections the map of PHY header sections (\see PhyEntity::PhyHeaderSections)
@@ -464,7 +490,7 @@ class InterferenceHelper : public Object
      * \return the success rate of the PHY header sections
      */
     double CalculatePhyHeaderSectionPsr(Ptr<const Event> event,
-                                        NiChangesPerBand* nis,
+                                        const NiChanges& nis,
                                         uint16_t channelWidth,
                                         WifiSpectrumBand band,
                                         PhyEntity::PhyHeaderSections phyHeaderSections) const;
@@ -472,9 +498,8 @@ class InterferenceHelper : public Object
     double m_noiseFigure;                 //!< noise figure (linear)
     Ptr<ErrorRateModel> m_errorRateModel; //!< error rate model
     uint8_t m_numRxAntennas; //!< the number of RX antennas in the corresponding receiver
-    NiChangesPerBand m_niChangesPerBand;                    //!< NI Changes for each band
-    std::map<WifiSpectrumBand, double> m_firstPowerPerBand; //!< first power of each band in watts
-    bool m_rxing; //!< flag whether it is in receiving state
+    NiChangesPerBand m_niChangesPerBand; //!< NI Changes and first power of each band
+    bool m_rxing;                        //!< flag whether it is in receiving state
 
     /**
      * Returns an iterator to the first NiChange that is later than moment
@@ -23,7 +23,10 @@
 
 #include "wifi-tx-vector.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/string.h"
 
 #include <bitset>
 #include <cmath>
@@ -41,7 +44,29 @@ NistErrorRateModel::GetTypeId()
     static TypeId tid = TypeId("ns3::NistErrorRateModel")
                             .SetParent<ErrorRateModel>()
                             .SetGroupName("Wifi")
-                            .AddConstructor<NistErrorRateModel>();
+                            .AddConstructor<NistErrorRateModel>()
+                            .AddAttribute("UseLookupTable",
+                                          "Whether to look up the chunk success rates of the OFDM "
+                                          "modes in tables generated the first time each mode is "
+                                          "used, instead of computing them.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &NistErrorRateModel::m_useLookupTable),
+                                          MakeBooleanChecker())
+                            .AddAttribute("LookupTableResolution",
+                                          "The step (dB) of the SNR values of the lookup tables.",
+                                          DoubleValue(0.05),
+                                          MakeDoubleAccessor(
+                                              &NistErrorRateModel::m_lookupTableResolution),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("LookupTableFile",
+                                          "The file from which the lookup tables are loaded and "
+                                          "to which they are saved when generated (no file if "
+                                          "empty).",
+                                          StringValue(""),
+                                          MakeStringAccessor(
+                                              &NistErrorRateModel::m_lookupTableFile),
+                                          MakeStringChecker());
     return tid;
 }
 
@@ -212,6 +237,33 @@ NistErrorRateModel::DoGetChunkSuccessRate(WifiMode mode,
                                           uint16_t staId) const
 {
     NS_LOG_FUNCTION(this << mode << snr << nbits << +numRxAntennas << field << staId);
+    if (m_useLookupTable && mode.GetModulationClass() >= WIFI_MOD_CLASS_ERP_OFDM)
+    {
+        if (!m_lookupTable)
+        {
+            m_lookupTable =
+                std::make_unique<ErrorRateLookupTable>(m_lookupTableResolution, m_lookupTableFile);
+        }
+        // the bit error probability only depends on the mode
+        uint64_t key = mode.GetUid();
+        if (!m_lookupTable->Contains(key))
+        {
+            m_lookupTable->Generate(key, mode.GetUniqueName(), [this, mode](double snr) {
+                return CalculateOfdmChunkSuccessRate(mode, snr, 1);
+            });
+        }
+        if (auto csr = m_lookupTable->GetChunkSuccessRate(key, snr, nbits))
+        {
+            return *csr;
+        }
+    }
+    return CalculateOfdmChunkSuccessRate(mode, snr, nbits);
+}
+
+double
+NistErrorRateModel::CalculateOfdmChunkSuccessRate(WifiMode mode, double snr, uint64_t nbits) const
+{
+    NS_LOG_FUNCTION(this << mode << snr << nbits);
     if (mode.GetModulationClass() >= WIFI_MOD_CLASS_ERP_OFDM)
     {
         if (mode.GetConstellationSize() == 2)
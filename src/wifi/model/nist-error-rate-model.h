@@ -21,9 +21,12 @@
 #ifndef NIST_ERROR_RATE_MODEL_H
 #define NIST_ERROR_RATE_MODEL_H
 
+#include "error-rate-lookup-table.h"
 #include "error-rate-model.h"
 #include "wifi-mode.h"
 
+#include <memory>
+
 namespace ns3
 {
 
@@ -34,6 +37,10 @@ namespace ns3
  * the model description and validation can be found in
  * http://www.nsnam.org/~pei/80211ofdm.pdf.  For DSSS modulations (802.11b),
  * the model uses the DsssErrorRateModel.
+ *
+ * If the UseLookupTable attribute is set, the chunk success rates of the
+ * OFDM modes are looked up in tables of the bit error probability (see
+ * ErrorRateLookupTable), generated the first time a mode is used.
  */
 class NistErrorRateModel : public ErrorRateModel
 {
@@ -54,6 +61,16 @@ class NistErrorRateModel : public ErrorRateModel
                                  uint8_t numRxAntennas,
                                  WifiPpduField field,
                                  uint16_t staId) const override;
+    /**
+     * Return the chunk success rate of an OFDM mode computed by the model.
+     *
+     * \param mode the Wi-Fi mode applicable to the chunk
+     * \param snr the SNR of the chunk (linear scale)
+     * \param nbits the number of bits in the chunk
+     *
+     * \return probability of successfully receiving the chunk
+     */
+    double CalculateOfdmChunkSuccessRate(WifiMode mode, double snr, uint64_t nbits) const;
     /**
      * Return the bValue such that coding rate = bValue / (bValue + 1).
      *
@@ -129,6 +146,12 @@ class NistErrorRateModel : public ErrorRateModel
                         double snr,
                         uint64_t nbits,
                         uint8_t bValue) const;
+
+    bool m_useLookupTable;          //!< whether to look up the chunk success rates
+    double m_lookupTableResolution; //!< the resolution of the lookup tables (dB)
+    std::string m_lookupTableFile;  //!< the file where the lookup tables are persisted
+    /// the lookup tables, created the first time they are used
+    mutable std::unique_ptr<ErrorRateLookupTable> m_lookupTable;
 };
 
 } // namespace ns3
@@ -957,8 +957,8 @@ PhyEntity::EndPreambleDetectionPeriod(Ptr<Event> event)
         auto it = m_wifiPhy->m_currentPreambleEvents.find(
             std::make_pair(event->GetPpdu()->GetUid(), event->GetPpdu()->GetPreamble()));
         m_wifiPhy->m_currentPreambleEvents.erase(it);
-        // This is needed to cleanup the m_firstPowerPerBand so that the first power corresponds to
-        // the power at the start of the PPDU
+        // This is needed to cleanup the first power of each band so that it corresponds to the
+        // power at the start of the PPDU
         m_wifiPhy->m_interference->NotifyRxEnd(maxEvent->GetStartTime());
         // Make sure InterferenceHelper keeps recording events
         m_wifiPhy->m_interference->NotifyRxStart();
@@ -998,7 +998,7 @@ PhyEntity::EndPreambleDetectionPeriod(Ptr<Event> event)
                 if (m_wifiPhy->m_currentEvent->GetPpdu()->GetUid() > it->first.first)
                 {
                     reason = PREAMBLE_DETECTION_PACKET_SWITCH;
-                    // This is needed to cleanup the m_firstPowerPerBand so that the first power
+                    // This is needed to cleanup the first power of each band so that it
                     // corresponds to the power at the start of the PPDU
                     m_wifiPhy->m_interference->NotifyRxEnd(
                         m_wifiPhy->m_currentEvent->GetStartTime());
@@ -24,7 +24,10 @@
 #include "wifi-tx-vector.h"
 #include "wifi-utils.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
+#include "ns3/string.h"
 
 #include <cmath>
 
@@ -41,7 +44,30 @@ YansErrorRateModel::GetTypeId()
     static TypeId tid = TypeId("ns3::YansErrorRateModel")
                             .SetParent<ErrorRateModel>()
                             .SetGroupName("Wifi")
-                            .AddConstructor<YansErrorRateModel>();
+                            .AddConstructor<YansErrorRateModel>()
+                            .AddAttribute("UseLookupTable",
+                                          "Whether to look up the chunk success rates of the OFDM "
+                                          "modes in tables generated the first time each mode is "
+                                          "used with a given channel width and PHY rate, instead "
+                                          "of computing them.",
+                                          BooleanValue(false),
+                                          MakeBooleanAccessor(
+                                              &YansErrorRateModel::m_useLookupTable),
+                                          MakeBooleanChecker())
+                            .AddAttribute("LookupTableResolution",
+                                          "The step (dB) of the SNR values of the lookup tables.",
+                                          DoubleValue(0.05),
+                                          MakeDoubleAccessor(
+                                              &YansErrorRateModel::m_lookupTableResolution),
+                                          MakeDoubleChecker<double>(0))
+                            .AddAttribute("LookupTableFile",
+                                          "The file from which the lookup tables are loaded and "
+                                          "to which they are saved when generated (no file if "
+                                          "empty).",
+                                          StringValue(""),
+                                          MakeStringAccessor(
+                                              &YansErrorRateModel::m_lookupTableFile),
+                                          MakeStringChecker());
     return tid;
 }
 
@@ -204,19 +230,59 @@ YansErrorRateModel::DoGetChunkSuccessRate(WifiMode mode,
                                           uint16_t staId) const
 {
     NS_LOG_FUNCTION(this << mode << txVector << snr << nbits << +numRxAntennas << field << staId);
-    if (mode.GetModulationClass() >= WIFI_MOD_CLASS_ERP_OFDM)
+    if (m_useLookupTable && mode.GetModulationClass() >= WIFI_MOD_CLASS_ERP_OFDM)
     {
-        uint64_t phyRate;
-        if ((txVector.IsMu() && (staId == SU_STA_ID)) || (mode != txVector.GetMode()))
+        if (!m_lookupTable)
+        {
+            m_lookupTable =
+                std::make_unique<ErrorRateLookupTable>(m_lookupTableResolution, m_lookupTableFile);
+        }
+        // the bit error probability depends on the mode, the signal spread and the PHY rate;
+        // the UID of the mode, the channel width (MHz) and the PHY rate (bps) fit in 16, 10
+        // and 38 bits, respectively
+        uint64_t channelWidth = txVector.GetChannelWidth();
+        uint64_t phyRate = GetPhyRate(mode, txVector, staId);
+        uint64_t key =
+            (static_cast<uint64_t>(mode.GetUid()) << 48) | (channelWidth << 38) | phyRate;
+        if (!m_lookupTable->Contains(key))
         {
-            phyRate = mode.GetPhyRate(txVector.GetChannelWidth() >= 40
-                                          ? 20
-                                          : txVector.GetChannelWidth()); // This is the PHY header
+            std::string name = mode.GetUniqueName() + "-" + std::to_string(channelWidth) + "MHz-" +
+                               std::to_string(phyRate) + "bps";
+            m_lookupTable->Generate(key, name, [this, mode, txVector, staId](double snr) {
+                return CalculateOfdmChunkSuccessRate(mode, txVector, snr, 1, staId);
+            });
         }
-        else
+        if (auto csr = m_lookupTable->GetChunkSuccessRate(key, snr, nbits))
         {
-            phyRate = mode.GetPhyRate(txVector, staId);
+            return *csr;
         }
+    }
+    return CalculateOfdmChunkSuccessRate(mode, txVector, snr, nbits, staId);
+}
+
+uint64_t
+YansErrorRateModel::GetPhyRate(WifiMode mode, const WifiTxVector& txVector, uint16_t staId) const
+{
+    if ((txVector.IsMu() && (staId == SU_STA_ID)) || (mode != txVector.GetMode()))
+    {
+        return mode.GetPhyRate(txVector.GetChannelWidth() >= 40
+                                   ? 20
+                                   : txVector.GetChannelWidth()); // This is the PHY header
+    }
+    return mode.GetPhyRate(txVector, staId);
+}
+
+double
+YansErrorRateModel::CalculateOfdmChunkSuccessRate(WifiMode mode,
+                                                  const WifiTxVector& txVector,
+                                                  double snr,
+                                                  uint64_t nbits,
+                                                  uint16_t staId) const
+{
+    NS_LOG_FUNCTION(this << mode << txVector << snr << nbits << staId);
+    if (mode.GetModulationClass() >= WIFI_MOD_CLASS_ERP_OFDM)
+    {
+        uint64_t phyRate = GetPhyRate(mode, txVector, staId);
         if (mode.GetConstellationSize() == 2)
         {
             if (mode.GetCodeRate() == WIFI_CODE_RATE_1_2)
@@ -21,8 +21,11 @@
 #ifndef YANS_ERROR_RATE_MODEL_H
 #define YANS_ERROR_RATE_MODEL_H
 
+#include "error-rate-lookup-table.h"
 #include "error-rate-model.h"
 
+#include <memory>
+
 namespace ns3
 {
 
@@ -50,6 +53,11 @@ namespace ns3
  *      57(2):440-449, February 2009.
  *    - More detailed description and validation can be found in
  *      http://www.nsnam.org/~pei/80211b.pdf
+ *
+ * If the UseLookupTable attribute is set, the chunk success rates of the
+ * OFDM modes are looked up in tables of the bit error probability (see
+ * ErrorRateLookupTable), generated the first time a mode is used with a
+ * given channel width and PHY rate.
  */
 class YansErrorRateModel : public ErrorRateModel
 {
@@ -70,6 +78,32 @@ class YansErrorRateModel : public ErrorRateModel
                                  uint8_t numRxAntennas,
                                  WifiPpduField field,
                                  uint16_t staId) const override;
+    /**
+     * Return the chunk success rate of an OFDM mode computed by the model.
+     *
+     * \param mode the Wi-Fi mode applicable to the chunk
+     * \param txVector TXVECTOR of the overall transmission
+     * \param snr the SNR of the chunk (linear scale)
+     * \param nbits the number of bits in the chunk
+     * \param staId the station ID for MU
+     *
+     * \return probability of successfully receiving the chunk
+     */
+    double CalculateOfdmChunkSuccessRate(WifiMode mode,
+                                         const WifiTxVector& txVector,
+                                         double snr,
+                                         uint64_t nbits,
+                                         uint16_t staId) const;
+    /**
+     * Return the PHY rate used to compute the BER of a chunk.
+     *
+     * \param mode the Wi-Fi mode applicable to the chunk
+     * \param txVector TXVECTOR of the overall transmission
+     * \param staId the station ID for MU
+     *
+     * \return the PHY rate of the PHY header or of the payload (bps)
+     */
+    uint64_t GetPhyRate(WifiMode mode, const WifiTxVector& txVector, uint16_t staId) const;
     /**
      * Return BER of BPSK with the given parameters.
      *
@@ -166,6 +200,12 @@ class YansErrorRateModel : public ErrorRateModel
                         uint32_t dfree,
                         uint32_t adFree,
                         uint32_t adFreePlusOne) const;
+
+    bool m_useLookupTable;          //!< whether to look up the chunk success rates
+    double m_lookupTableResolution; //!< the resolution of the lookup tables (dB)
+    std::string m_lookupTableFile;  //!< the file where the lookup tables are persisted
+    /// the lookup tables, created the first time they are used
+    mutable std::unique_ptr<ErrorRateLookupTable> m_lookupTable;
 };
 
 } // namespace ns3
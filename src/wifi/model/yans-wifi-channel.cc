@@ -25,6 +25,8 @@
 #include "wifi-utils.h"
 #include "yans-wifi-phy.h"
 
+#include "ns3/boolean.h"
+#include "ns3/double.h"
 #include "ns3/log.h"
 #include "ns3/mobility-model.h"
 #include "ns3/node.h"
@@ -32,8 +34,11 @@
 #include "ns3/propagation-delay-model.h"
 #include "ns3/propagation-loss-model.h"
 #include "ns3/simulator.h"
+#include "ns3/spatial-grid-index.h"
 #include "ns3/wifi-net-device.h"
 
+#include <algorithm>
+
 namespace ns3
 {
 
@@ -58,7 +63,23 @@ YansWifiChannel::GetTypeId()
                           "A pointer to the propagation delay model attached to this channel.",
                           PointerValue(),
                           MakePointerAccessor(&YansWifiChannel::m_delay),
-                          MakePointerChecker<PropagationDelayModel>());
+                          MakePointerChecker<PropagationDelayModel>())
+            .AddAttribute("EnableSpatialIndex",
+                          "If true, the PHYs are indexed by position, and a PPDU is only "
+                          "delivered to the PHYs within the maximum range of the propagation "
+                          "loss model for the RxPowerFloor.",
+                          BooleanValue(false),
+                          MakeBooleanAccessor(&YansWifiChannel::SetSpatialIndexEnabled,
+                                              &YansWifiChannel::IsSpatialIndexEnabled),
+                          MakeBooleanChecker())
+            .AddAttribute("RxPowerFloor",
+                          "When the spatial index is enabled, the PPDUs are not delivered to the "
+                          "PHYs for which the received power (before the RX gain) is lower than "
+                          "this value, in dBm. It should not exceed the lowest RxSensitivity "
+                          "minus RxGain of the PHYs, since weaker signals are discarded anyway.",
+                          DoubleValue(-101.0),
+                          MakeDoubleAccessor(&YansWifiChannel::m_rxPowerFloorDbm),
+                          MakeDoubleChecker<double>());
     return tid;
 }
 
@@ -87,48 +108,103 @@ YansWifiChannel::SetPropagationDelayModel(const Ptr<PropagationDelayModel> delay
     m_delay = delay;
 }
 
+void
+YansWifiChannel::SetSpatialIndexEnabled(bool enable)
+{
+    NS_LOG_FUNCTION(this << enable);
+    if (enable && !m_spatialIndex)
+    {
+        m_spatialIndex = CreateObject<SpatialGridIndex>();
+    }
+    else if (!enable)
+    {
+        m_spatialIndex = nullptr;
+    }
+}
+
+bool
+YansWifiChannel::IsSpatialIndexEnabled() const
+{
+    return m_spatialIndex != nullptr;
+}
+
 void
 YansWifiChannel::Send(Ptr<YansWifiPhy> sender, Ptr<const WifiPpdu> ppdu, double txPowerDbm) const
 {
     NS_LOG_FUNCTION(this << sender << ppdu << txPowerDbm);
     Ptr<MobilityModel> senderMobility = sender->GetMobility();
     NS_ASSERT(senderMobility);
-    for (PhyList::const_iterator i = m_phyList.begin(); i != m_phyList.end(); i++)
+    if (!m_spatialIndex)
     {
-        if (sender != (*i))
+        for (PhyList::const_iterator i = m_phyList.begin(); i != m_phyList.end(); i++)
         {
-            // For now don't account for inter channel interference nor channel bonding
-            if ((*i)->GetChannelNumber() != sender->GetChannelNumber())
-            {
-                continue;
-            }
-
-            Ptr<MobilityModel> receiverMobility = (*i)->GetMobility()->GetObject<MobilityModel>();
-            Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
-            double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
-            NS_LOG_DEBUG("propagation: txPower="
-                         << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
-                         << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
-                         << "m, delay=" << delay);
-            Ptr<NetDevice> dstNetDevice = (*i)->GetDevice();
-            uint32_t dstNode;
-            if (!dstNetDevice)
-            {
-                dstNode = 0xffffffff;
-            }
-            else
-            {
-                dstNode = dstNetDevice->GetNode()->GetId();
-            }
-
-            Simulator::ScheduleWithContext(dstNode,
-                                           delay,
-                                           &YansWifiChannel::Receive,
-                                           (*i),
-                                           ppdu,
-                                           rxPowerDbm);
+            SendTo(sender, senderMobility, *i, ppdu, txPowerDbm);
         }
+        return;
     }
+
+    // the mobility model of a PHY may not be known when it is added to the channel
+    for (auto id = static_cast<uint32_t>(m_spatialIndex->GetN()); id < m_phyList.size(); id++)
+    {
+        m_spatialIndex->Add(id, m_phyList[id]->GetMobility());
+    }
+    double range = m_loss->GetMaxRange(txPowerDbm, m_rxPowerFloorDbm);
+    std::vector<uint32_t> ids;
+    m_spatialIndex->GetNeighbors(senderMobility->GetPosition(), range, ids);
+    NS_LOG_DEBUG("range=" << range << "m, " << ids.size() << " PHYs out of " << m_phyList.size());
+    // deliver in the order the PHYs were added, as without the index
+    std::sort(ids.begin(), ids.end());
+    for (auto id : ids)
+    {
+        SendTo(sender, senderMobility, m_phyList[id], ppdu, txPowerDbm);
+    }
+}
+
+void
+YansWifiChannel::SendTo(Ptr<YansWifiPhy> sender,
+                        Ptr<MobilityModel> senderMobility,
+                        Ptr<YansWifiPhy> receiver,
+                        Ptr<const WifiPpdu> ppdu,
+                        double txPowerDbm) const
+{
+    if (sender == receiver)
+    {
+        return;
+    }
+    // For now don't account for inter channel interference nor channel bonding
+    if (receiver->GetChannelNumber() != sender->GetChannelNumber())
+    {
+        return;
+    }
+
+    Ptr<MobilityModel> receiverMobility = receiver->GetMobility()->GetObject<MobilityModel>();
+    Time delay = m_delay->GetDelay(senderMobility, receiverMobility);
+    double rxPowerDbm = m_loss->CalcRxPower(txPowerDbm, senderMobility, receiverMobility);
+    NS_LOG_DEBUG("propagation: txPower="
+                 << txPowerDbm << "dbm, rxPower=" << rxPowerDbm << "dbm, "
+                 << "distance=" << senderMobility->GetDistanceFrom(receiverMobility)
+                 << "m, delay=" << delay);
+    if (m_spatialIndex && rxPowerDbm < m_rxPowerFloorDbm)
+    {
+        return;
+    }
+    Ptr<NetDevice> dstNetDevice = receiver->GetDevice();
+    uint32_t dstNode;
+    if (!dstNetDevice)
+    {
+        dstNode = 0xffffffff;
+    }
+    else
+    {
+        dstNode = dstNetDevice->GetNode()->GetId();
+    }
+
+    Simulator::ScheduleWithContext(dstNode,
+                                   delay,
+                                   &YansWifiChannel::Receive,
+                                   receiver,
+                                   ppdu,
+                                   rxPowerDbm);
 }
 
 void
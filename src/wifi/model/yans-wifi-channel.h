@@ -26,9 +26,11 @@
 namespace ns3
 {
 
+class MobilityModel;
 class NetDevice;
 class PropagationLossModel;
 class PropagationDelayModel;
+class SpatialGridIndex;
 class YansWifiPhy;
 class Packet;
 class Time;
@@ -42,6 +44,10 @@ class WifiPpdu;
  * class and supports an ns3::PropagationLossModel and an
  * ns3::PropagationDelayModel.  By default, no propagation models are set;
  * it is the caller's responsibility to set them before using the channel.
+ *
+ * When the EnableSpatialIndex attribute is true, the PHYs are indexed by
+ * position, and a PPDU is only delivered to the PHYs located within the
+ * maximum range of the propagation loss model for the RxPowerFloor.
  */
 class YansWifiChannel : public Channel
 {
@@ -103,6 +109,30 @@ class YansWifiChannel : public Channel
      */
     typedef std::vector<Ptr<YansWifiPhy>> PhyList;
 
+    /**
+     * \param enable whether to index the PHYs by position
+     */
+    void SetSpatialIndexEnabled(bool enable);
+    /**
+     * \return whether the PHYs are indexed by position
+     */
+    bool IsSpatialIndexEnabled() const;
+
+    /**
+     * Deliver a PPDU to a PHY after the propagation delay.
+     *
+     * \param sender the PHY object from which the packet is originating
+     * \param senderMobility the mobility model of the sender
+     * \param receiver the PHY to deliver the PPDU to
+     * \param ppdu the PPDU to send
+     * \param txPowerDbm the TX power associated to the packet, in dBm
+     */
+    void SendTo(Ptr<YansWifiPhy> sender,
+                Ptr<MobilityModel> senderMobility,
+                Ptr<YansWifiPhy> receiver,
+                Ptr<const WifiPpdu> ppdu,
+                double txPowerDbm) const;
+
     /**
      * This method is scheduled by Send for each associated YansWifiPhy.
      * The method then calls the corresponding YansWifiPhy that the first
@@ -117,6 +147,9 @@ class YansWifiChannel : public Channel
     PhyList m_phyList;                  //!< List of YansWifiPhys connected to this YansWifiChannel
     Ptr<PropagationLossModel> m_loss;   //!< Propagation loss model
     Ptr<PropagationDelayModel> m_delay; //!< Propagation delay model
+
+    Ptr<SpatialGridIndex> m_spatialIndex; //!< Index of the PHYs by position, if enabled
+    double m_rxPowerFloorDbm;             //!< RX power below which PPDUs are not delivered
 };
 
 } // namespace ns3
@@ -19,17 +19,21 @@
  *          Sébastien Deronne (sebastien.deronne@gmail.com)
  */
 
+#include "ns3/boolean.h"
 #include "ns3/dsss-error-rate-model.h"
 #include "ns3/he-phy.h" //includes HT and VHT
 #include "ns3/interference-helper.h"
 #include "ns3/log.h"
 #include "ns3/nist-error-rate-model.h"
+#include "ns3/string.h"
 #include "ns3/table-based-error-rate-model.h"
 #include "ns3/test.h"
 #include "ns3/wifi-phy.h"
 #include "ns3/wifi-utils.h"
 #include "ns3/yans-error-rate-model.h"
 
+#include <cstdio>
+
 using namespace ns3;
 
 NS_LOG_COMPONENT_DEFINE("WifiErrorRateModelsTest");
@@ -1033,6 +1037,101 @@ TableBasedErrorRateTestCase::DoRun()
     }
 }
 
+/**
+ * \ingroup wifi-test
+ * \ingroup tests
+ *
+ * \brief Error Rate Models Lookup Table Test Case
+ *
+ * The chunk success rates looked up in the tables of an error rate model must
+ * be close to those it computes, and those of another model loading the
+ * tables from the file must be identical.
+ */
+class ErrorRateLookupTableTestCase : public TestCase
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param typeId the TypeId of the error rate model
+     */
+    ErrorRateLookupTableTestCase(TypeId typeId);
+
+  private:
+    void DoRun() override;
+
+    TypeId m_typeId; ///< The TypeId of the error rate model
+};
+
+ErrorRateLookupTableTestCase::ErrorRateLookupTableTestCase(TypeId typeId)
+    : TestCase("Lookup tables of " + typeId.GetName()),
+      m_typeId(typeId)
+{
+}
+
+void
+ErrorRateLookupTableTestCase::DoRun()
+{
+    std::string filename = CreateTempDirFilename("error-rate-lookup-tables.txt");
+    std::remove(filename.c_str());
+
+    ObjectFactory factory;
+    factory.SetTypeId(m_typeId);
+    Ptr<ErrorRateModel> model = factory.Create<ErrorRateModel>();
+    factory.Set("UseLookupTable", BooleanValue(true));
+    factory.Set("LookupTableFile", StringValue(filename));
+    Ptr<ErrorRateModel> generated = factory.Create<ErrorRateModel>();
+
+    std::vector<WifiTxVector> txVectors{
+        WifiTxVector(OfdmPhy::GetOfdmRate6Mbps(), 0, WIFI_PREAMBLE_LONG, 800, 1, 1, 0, 20, false),
+        WifiTxVector(HtPhy::GetHtMcs7(), 0, WIFI_PREAMBLE_HT_MF, 800, 1, 1, 0, 20, false),
+        WifiTxVector(VhtPhy::GetVhtMcs8(), 0, WIFI_PREAMBLE_VHT_SU, 800, 1, 1, 0, 80, false),
+        WifiTxVector(HePhy::GetHeMcs11(), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 40, false)};
+
+    // SNR values between and out of the points of the grid
+    for (double snrDb = -12.03; snrDb <= 62; snrDb += 0.37)
+    {
+        double snr = DbToRatio(snrDb);
+        for (const auto& txVector : txVectors)
+        {
+            for (uint64_t nbits : {1, 12000})
+            {
+                double expected = model->GetChunkSuccessRate(txVector.GetMode(),
+                                                             txVector,
+                                                             snr,
+                                                             nbits);
+                double psr = generated->GetChunkSuccessRate(txVector.GetMode(),
+                                                            txVector,
+                                                            snr,
+                                                            nbits);
+                NS_TEST_ASSERT_MSG_EQ_TOL(psr,
+                                          expected,
+                                          1e-4,
+                                          "Unexpected PSR for " << txVector.GetMode() << " at "
+                                                                << snrDb << " dB");
+            }
+        }
+    }
+
+    // the tables are loaded from the file rather than generated again
+    Ptr<ErrorRateModel> loaded = factory.Create<ErrorRateModel>();
+    for (double snrDb = -5.11; snrDb <= 45; snrDb += 1.3)
+    {
+        double snr = DbToRatio(snrDb);
+        for (const auto& txVector : txVectors)
+        {
+            double psr = generated->GetChunkSuccessRate(txVector.GetMode(), txVector, snr, 12000);
+            double loadedPsr =
+                loaded->GetChunkSuccessRate(txVector.GetMode(), txVector, snr, 12000);
+            NS_TEST_ASSERT_MSG_EQ(loadedPsr,
+                                  psr,
+                                  "Unexpected PSR loaded for " << txVector.GetMode() << " at "
+                                                               << snrDb << " dB");
+        }
+    }
+    std::remove(filename.c_str());
+}
+
 /**
  * \ingroup wifi-test
  * \ingroup tests
@@ -1051,6 +1150,10 @@ WifiErrorRateModelsTestSuite::WifiErrorRateModelsTestSuite()
     AddTestCase(new WifiErrorRateModelsTestCaseDsss, TestCase::QUICK);
     AddTestCase(new WifiErrorRateModelsTestCaseNist, TestCase::QUICK);
     AddTestCase(new WifiErrorRateModelsTestCaseMimo, TestCase::QUICK);
+    AddTestCase(new ErrorRateLookupTableTestCase(NistErrorRateModel::GetTypeId()),
+                TestCase::QUICK);
+    AddTestCase(new ErrorRateLookupTableTestCase(YansErrorRateModel::GetTypeId()),
+                TestCase::QUICK);
     AddTestCase(new TableBasedErrorRateTestCase("DefaultTableBasedHtMcs0-1458bytes",
                                                 HtPhy::GetHtMcs0(),
                                                 1458),
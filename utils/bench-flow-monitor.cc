@@ -0,0 +1,148 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the FlowMonitor bookkeeping: the
+// classification of the packets and the processing of the probe reports,
+// for 'packets' packets spread over 'flows' flows, with 'window' packets
+// in flight crossing 'hops' routers.
+// Sample usage:  ./ns3 run 'bench-flow-monitor --flows=100000 --sampling=10'
+
+#include "ns3/boolean.h"
+#include "ns3/command-line.h"
+#include "ns3/flow-monitor-helper.h"
+#include "ns3/internet-stack-helper.h"
+#include "ns3/ipv4-flow-classifier.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/udp-header.h"
+#include "ns3/udp-l4-protocol.h"
+#include "ns3/uinteger.h"
+
+#include <deque>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/// Size of the packets reported to the FlowMonitor
+static const uint32_t PACKET_SIZE = 1000;
+
+/// A packet in flight
+struct InFlight
+{
+    FlowId flowId;         //!< Flow of the packet
+    FlowPacketId packetId; //!< Identifier of the packet in its flow
+};
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t flows = 10000;
+    uint32_t packets = 1000000;
+    uint32_t window = 1000;
+    uint32_t hops = 2;
+    uint32_t sampling = 1;
+    bool reserve = true;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the FlowMonitor classification and packet tracking");
+    cmd.AddValue("flows", "number of flows", flows);
+    cmd.AddValue("packets", "number of packets", packets);
+    cmd.AddValue("window", "number of packets in flight", window);
+    cmd.AddValue("hops", "number of times each packet is forwarded", hops);
+    cmd.AddValue("sampling", "track one packet out of this number per flow", sampling);
+    cmd.AddValue("reserve", "size the flow tables for the flows up front", reserve);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-flow-monitor with flows=" << flows << " packets=" << packets
+              << " window=" << window << " hops=" << hops << " sampling=" << sampling
+              << std::endl;
+
+    Ptr<Node> node = CreateObject<Node>();
+    InternetStackHelper internet;
+    internet.Install(node);
+
+    FlowMonitorHelper flowmon;
+    flowmon.SetMonitorAttribute("ExpectedFlows", UintegerValue(reserve ? flows : 0));
+    flowmon.SetMonitorAttribute("PacketSamplingInterval", UintegerValue(sampling));
+    flowmon.SetMonitorAttribute("MeasureOverhead", BooleanValue(true));
+    Ptr<FlowMonitor> monitor = flowmon.Install(node);
+    Ptr<Ipv4FlowClassifier> classifier = DynamicCast<Ipv4FlowClassifier>(flowmon.GetClassifier());
+    Ptr<FlowProbe> probe = monitor->GetAllProbes().front();
+    monitor->StartRightNow();
+
+    // One IP header and L4 payload per flow
+    std::vector<Ipv4Header> headers(flows);
+    std::vector<Ptr<Packet>> payloads(flows);
+    for (uint32_t i = 0; i < flows; i++)
+    {
+        headers[i].SetSource(Ipv4Address(0x0a000000 + i));
+        headers[i].SetDestination(Ipv4Address("192.168.0.1"));
+        headers[i].SetProtocol(UdpL4Protocol::PROT_NUMBER);
+        UdpHeader udp;
+        udp.SetSourcePort(49152 + i % 16384);
+        udp.SetDestinationPort(9);
+        payloads[i] = Create<Packet>(PACKET_SIZE);
+        payloads[i]->AddHeader(udp);
+    }
+
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+    std::vector<uint32_t> order(packets);
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        order[i] = rng->GetInteger(0, flows - 1);
+    }
+
+    std::deque<InFlight> inFlight;
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < packets; i++)
+    {
+        InFlight packet;
+        classifier->Classify(headers[order[i]],
+                             payloads[order[i]],
+                             &packet.flowId,
+                             &packet.packetId);
+        monitor->ReportFirstTx(probe, packet.flowId, packet.packetId, PACKET_SIZE);
+        inFlight.push_back(packet);
+        if (inFlight.size() > window)
+        {
+            const InFlight& oldest = inFlight.front();
+            for (uint32_t hop = 0; hop < hops; hop++)
+            {
+                monitor->ReportForwarding(probe, oldest.flowId, oldest.packetId, PACKET_SIZE);
+            }
+            monitor->ReportLastRx(probe, oldest.flowId, oldest.packetId, PACKET_SIZE);
+            inFlight.pop_front();
+        }
+    }
+    monitor->CheckForLostPackets();
+    uint64_t elapsed = time.End();
+
+    FlowMonitor::OverheadStats overhead = monitor->GetOverheadStats();
+    std::cout << elapsed << " ms elapsed\tClassification and reports" << std::endl;
+    std::cout << overhead.processingTime * 1000 << " ms elapsed\tFlowMonitor processing of "
+              << overhead.reports << " reports" << std::endl;
+    std::cout << overhead.flows << " flows, " << overhead.maxTrackedPackets
+              << " packets tracked at most" << std::endl;
+
+    Simulator::Destroy();
+    return 0;
+}
@@ -0,0 +1,283 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the InterferenceHelper of the Wi-Fi
+// PHY in a dense deployment, where a receiver hears the transmissions of many
+// overlapping BSSs while it receives HE SU PPDUs. Each BSS transmits PPDUs
+// of random duration separated by random gaps, received on all the bands of
+// the interference helper (the 20 MHz channel and its RUs). For each PPDU it
+// receives, the receiver computes the SNR at the end of the preamble
+// detection, the PER of the PHY headers and the PER of each MPDU of the
+// A-MPDU, as done by the PHY entities.
+// Sample usage:  ./ns3 run 'bench-interference-helper --bss=50 --duration=10'
+
+#include "ns3/command-line.h"
+#include "ns3/he-phy.h"
+#include "ns3/interference-helper.h"
+#include "ns3/nist-error-rate-model.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/wifi-phy.h"
+#include "ns3/wifi-ppdu.h"
+#include "ns3/wifi-psdu.h"
+#include "ns3/wifi-utils.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Drive an InterferenceHelper with the signals of overlapping BSSs and the
+ * receptions of a receiver.
+ */
+class DenseInterference
+{
+  public:
+    /**
+     * Constructor
+     *
+     * \param nBss the number of overlapping BSSs
+     * \param nMpdus the number of MPDUs of the received A-MPDUs
+     */
+    DenseInterference(uint32_t nBss, uint32_t nMpdus);
+
+    /**
+     * Run the simulation.
+     *
+     * \param duration the simulated time
+     */
+    void Run(Time duration);
+
+    uint64_t m_signals;    //!< the number of signals added to the interference helper
+    uint64_t m_receptions; //!< the number of receptions
+    double m_check;        //!< the sum of the PERs, to keep the results alive
+
+  private:
+    /**
+     * Get the received power of a signal on each band.
+     *
+     * \param powerDbm the received power on the 20 MHz channel (dBm)
+     * \return the received power per band
+     */
+    RxPowerWattPerChannelBand GetRxPower(double powerDbm) const;
+
+    /**
+     * Start a transmission of a BSS.
+     */
+    void Transmit();
+
+    /**
+     * Start a reception.
+     */
+    void StartReceive();
+
+    /**
+     * Compute the SNR at the end of the preamble detection.
+     *
+     * \param event the event of the reception
+     */
+    void EndPreambleDetection(Ptr<Event> event);
+
+    /**
+     * Compute the PER of the PHY headers.
+     *
+     * \param event the event of the reception
+     */
+    void EndPhyHeaders(Ptr<Event> event);
+
+    /**
+     * Compute the PER of an MPDU.
+     *
+     * \param event the event of the reception
+     * \param mpdu the index of the MPDU
+     */
+    void EndMpdu(Ptr<Event> event, uint32_t mpdu);
+
+    Ptr<InterferenceHelper> m_interference; //!< the interference helper
+    std::vector<WifiSpectrumBand> m_bands;  //!< the bands of the interference helper
+    WifiTxVector m_txVector;                //!< the TXVECTOR of the PPDUs
+    Ptr<WifiPpdu> m_ppdu;                   //!< the PPDU of the signals
+    Ptr<UniformRandomVariable> m_random;    //!< the durations, gaps and powers
+    uint32_t m_nMpdus;                      //!< the number of MPDUs of the A-MPDUs
+    Time m_mpduDuration;                    //!< the duration of an MPDU
+};
+
+DenseInterference::DenseInterference(uint32_t nBss, uint32_t nMpdus)
+    : m_signals(0),
+      m_receptions(0),
+      m_check(0),
+      m_nMpdus(nMpdus),
+      m_mpduDuration(MicroSeconds(200))
+{
+    m_interference = CreateObject<InterferenceHelper>();
+    m_interference->SetNoiseFigure(DbToRatio(7));
+    m_interference->SetErrorRateModel(CreateObject<NistErrorRateModel>());
+
+    // the 20 MHz channel and its 26, 52, 106 and 242-tone RUs
+    m_bands.emplace_back(0, 255);
+    for (uint32_t ruSize : {26, 52, 106, 242})
+    {
+        for (uint32_t start = 6; start + ruSize <= 250; start += ruSize)
+        {
+            m_bands.emplace_back(start, start + ruSize - 1);
+        }
+    }
+    for (const auto& band : m_bands)
+    {
+        m_interference->AddBand(band);
+    }
+
+    m_txVector = WifiTxVector(HePhy::GetHeMcs5(), 0, WIFI_PREAMBLE_HE_SU, 800, 1, 1, 0, 20, true);
+    WifiMacHeader hdr;
+    hdr.SetType(WIFI_MAC_QOSDATA);
+    m_ppdu = Create<WifiPpdu>(Create<WifiPsdu>(Create<Packet>(1000), hdr), m_txVector, 5180);
+
+    m_random = CreateObject<UniformRandomVariable>();
+    m_random->SetStream(1);
+    for (uint32_t i = 0; i < nBss; i++)
+    {
+        Simulator::Schedule(MicroSeconds(m_random->GetInteger(0, 3000)),
+                            &DenseInterference::Transmit,
+                            this);
+    }
+    Simulator::Schedule(MicroSeconds(100), &DenseInterference::StartReceive, this);
+}
+
+RxPowerWattPerChannelBand
+DenseInterference::GetRxPower(double powerDbm) const
+{
+    RxPowerWattPerChannelBand rxPower;
+    for (const auto& band : m_bands)
+    {
+        // the power is proportional to the width of the band
+        rxPower[band] = DbmToW(powerDbm) * (band.second - band.first + 1) / 256;
+    }
+    return rxPower;
+}
+
+void
+DenseInterference::Transmit()
+{
+    Time duration = MicroSeconds(m_random->GetInteger(200, 3000));
+    RxPowerWattPerChannelBand rxPower = GetRxPower(m_random->GetValue(-95, -75));
+    m_interference->Add(m_ppdu, m_txVector, duration, rxPower);
+    m_signals++;
+    Simulator::Schedule(duration + MicroSeconds(m_random->GetInteger(50, 2000)),
+                        &DenseInterference::Transmit,
+                        this);
+}
+
+void
+DenseInterference::StartReceive()
+{
+    Time duration = WifiPhy::CalculatePhyPreambleAndHeaderDuration(m_txVector) +
+                    m_nMpdus * m_mpduDuration;
+    RxPowerWattPerChannelBand rxPower = GetRxPower(-55);
+    Ptr<Event> event = m_interference->Add(m_ppdu, m_txVector, duration, rxPower);
+    m_signals++;
+    m_receptions++;
+    m_interference->NotifyRxStart();
+    Simulator::Schedule(MicroSeconds(4), &DenseInterference::EndPreambleDetection, this, event);
+    Simulator::Schedule(WifiPhy::CalculatePhyPreambleAndHeaderDuration(m_txVector),
+                        &DenseInterference::EndPhyHeaders,
+                        this,
+                        event);
+    for (uint32_t mpdu = 0; mpdu < m_nMpdus; mpdu++)
+    {
+        Simulator::Schedule(WifiPhy::CalculatePhyPreambleAndHeaderDuration(m_txVector) +
+                                (mpdu + 1) * m_mpduDuration,
+                            &DenseInterference::EndMpdu,
+                            this,
+                            event,
+                            mpdu);
+    }
+    Simulator::Schedule(duration + MicroSeconds(m_random->GetInteger(20, 200)),
+                        &DenseInterference::StartReceive,
+                        this);
+}
+
+void
+DenseInterference::EndPreambleDetection(Ptr<Event> event)
+{
+    m_check += m_interference->CalculateSnr(event, 20, 1, m_bands[0]);
+}
+
+void
+DenseInterference::EndPhyHeaders(Ptr<Event> event)
+{
+    for (WifiPpduField field : {WIFI_PPDU_FIELD_NON_HT_HEADER, WIFI_PPDU_FIELD_SIG_A})
+    {
+        m_check += m_interference->CalculatePhyHeaderSnrPer(event, 20, m_bands[0], field).per;
+    }
+}
+
+void
+DenseInterference::EndMpdu(Ptr<Event> event, uint32_t mpdu)
+{
+    std::pair<Time, Time> window = {mpdu * m_mpduDuration, (mpdu + 1) * m_mpduDuration};
+    m_check +=
+        m_interference->CalculatePayloadSnrPer(event, 20, m_bands[0], SU_STA_ID, window).per;
+    if (mpdu + 1 == m_nMpdus)
+    {
+        m_interference->NotifyRxEnd(Simulator::Now());
+    }
+}
+
+void
+DenseInterference::Run(Time duration)
+{
+    Simulator::Stop(duration);
+    Simulator::Run();
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t nBss = 50;
+    uint32_t nMpdus = 16;
+    double duration = 10;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the InterferenceHelper of the Wi-Fi PHY in a dense deployment");
+    cmd.AddValue("bss", "number of overlapping BSSs", nBss);
+    cmd.AddValue("mpdus", "number of MPDUs of the received A-MPDUs", nMpdus);
+    cmd.AddValue("duration", "simulated time (s)", duration);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-interference-helper with " << nBss << " BSSs" << std::endl;
+
+    DenseInterference bench(nBss, nMpdus);
+    SystemWallClockMs time;
+    time.Start();
+    bench.Run(Seconds(duration));
+    uint64_t elapsed = time.End();
+
+    std::cout << "  " << bench.m_signals << " signals, " << bench.m_receptions << " receptions"
+              << std::endl;
+    std::cout << "  " << 1e3 * elapsed / bench.m_signals << " us per signal" << std::endl;
+    std::cout << "  " << elapsed << " ms in total" << std::endl;
+
+    // keep the results alive
+    if (std::isnan(bench.m_check))
+    {
+        std::cout << "  unexpected result" << std::endl;
+    }
+    return 0;
+}
@@ -0,0 +1,221 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the traffic control layer on a
+// multi-queue device: packets of many flows are offered at 'load' times the
+// line rate to a 100 Gbps device having 'txqueues' transmission queues, each
+// one served by a FqCoDel queue disc attached to an mq root queue disc. The
+// transmission queue of each packet is selected by hashing its flow. The same
+// traffic is then sent through a single-queue device with a single FqCoDel
+// queue disc.
+//
+// The transmission queues share the device queue, as the rings of a NIC share
+// the wire: they are all stopped when the device queue is full and woken when
+// it has room again (optionally, as limited by BQL). Since the traffic exceeds
+// the line rate, packets build up in the queue discs, which are then run by
+// the flow control of the device rather than by the arrival of packets.
+// Sample usage:  ./ns3 run 'bench-mq-queue-disc --txqueues=16 --flows=10000'
+
+#include "ns3/command-line.h"
+#include "ns3/data-rate.h"
+#include "ns3/drop-tail-queue.h"
+#include "ns3/dynamic-queue-limits.h"
+#include "ns3/ipv4-header.h"
+#include "ns3/ipv4-queue-disc-item.h"
+#include "ns3/mac48-address.h"
+#include "ns3/net-device-queue-interface.h"
+#include "ns3/node.h"
+#include "ns3/packet.h"
+#include "ns3/simple-channel.h"
+#include "ns3/simple-net-device.h"
+#include "ns3/simulator.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/traffic-control-helper.h"
+#include "ns3/traffic-control-layer.h"
+#include "ns3/udp-header.h"
+#include "ns3/uinteger.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+/// Rate of the device
+static const DataRate DEVICE_RATE("100Gbps");
+
+/**
+ * Send the next packet to the traffic control layer and schedule the following one
+ * \param tc the traffic control layer
+ * \param dev the device
+ * \param interval the interval between two packets
+ * \param flows number of flows
+ * \param size the size of the packets
+ * \param packets number of packets still to send
+ */
+static void
+SendPacket(Ptr<TrafficControlLayer> tc,
+           Ptr<NetDevice> dev,
+           Time interval,
+           uint32_t flows,
+           uint32_t size,
+           uint32_t packets)
+{
+    Ipv4Header ipHeader;
+    ipHeader.SetSource(Ipv4Address(0x0a000000 + packets % flows));
+    ipHeader.SetDestination(Ipv4Address("192.168.0.1"));
+    ipHeader.SetProtocol(17);
+    ipHeader.SetPayloadSize(size - ipHeader.GetSerializedSize());
+
+    UdpHeader udpHeader;
+    udpHeader.SetSourcePort(49152);
+    udpHeader.SetDestinationPort(9);
+
+    Ptr<Packet> p = Create<Packet>(size - ipHeader.GetSerializedSize() -
+                                   udpHeader.GetSerializedSize());
+    p->AddHeader(udpHeader);
+    tc->Send(dev,
+             Create<Ipv4QueueDiscItem>(p, Mac48Address::GetBroadcast(), 0x0800, ipHeader));
+
+    if (--packets > 0)
+    {
+        Simulator::Schedule(interval,
+                            &SendPacket,
+                            tc,
+                            dev,
+                            interval,
+                            flows,
+                            size,
+                            packets);
+    }
+}
+
+/**
+ * Run the simulation once
+ * \param txQueues number of device transmission queues
+ * \param flows number of flows
+ * \param size the size of the packets
+ * \param packets number of packets to send
+ * \param load the offered load, relative to the line rate
+ * \param bql whether BQL is enabled on the transmission queues
+ * \param [out] sent the number of packets sent to the device
+ * \param [out] dropped the number of packets dropped by the queue discs
+ * \return the wall-clock time of the simulation, in milliseconds
+ */
+static uint64_t
+RunOnce(uint32_t txQueues,
+        uint32_t flows,
+        uint32_t size,
+        uint32_t packets,
+        double load,
+        bool bql,
+        uint64_t& sent,
+        uint64_t& dropped)
+{
+    Ptr<Node> node = CreateObject<Node>();
+    Ptr<Node> peer = CreateObject<Node>();
+    Ptr<TrafficControlLayer> tc = CreateObject<TrafficControlLayer>();
+    node->AggregateObject(tc);
+
+    Ptr<SimpleChannel> channel = CreateObject<SimpleChannel>();
+    Ptr<SimpleNetDevice> dev = CreateObject<SimpleNetDevice>();
+    dev->SetAttribute("DataRate", DataRateValue(DEVICE_RATE));
+    Ptr<Queue<Packet>> devQueue = CreateObject<DropTailQueue<Packet>>();
+    devQueue->SetMaxSize(QueueSize("100p"));
+    dev->SetQueue(devQueue);
+    dev->SetAddress(Mac48Address::Allocate());
+    dev->SetChannel(channel);
+    node->AddDevice(dev);
+    Ptr<SimpleNetDevice> peerDev = CreateObject<SimpleNetDevice>();
+    peerDev->SetAddress(Mac48Address::Allocate());
+    peerDev->SetChannel(channel);
+    peer->AddDevice(peerDev);
+
+    Ptr<NetDeviceQueueInterface> ndqi =
+        CreateObjectWithAttributes<NetDeviceQueueInterface>("NTxQueues", UintegerValue(txQueues));
+    dev->AggregateObject(ndqi);
+    for (uint32_t i = 0; i < txQueues; i++)
+    {
+        ndqi->GetTxQueue(i)->ConnectQueueTraces(devQueue);
+        if (bql)
+        {
+            ndqi->GetTxQueue(i)->SetQueueLimits(CreateObject<DynamicQueueLimits>());
+        }
+    }
+
+    TrafficControlHelper tch;
+    if (txQueues > 1)
+    {
+        uint16_t handle = tch.SetRootQueueDisc("ns3::MqQueueDisc");
+        TrafficControlHelper::ClassIdList cls =
+            tch.AddQueueDiscClasses(handle, txQueues, "ns3::QueueDiscClass");
+        tch.AddChildQueueDiscs(handle, cls, "ns3::FqCoDelQueueDisc");
+    }
+    else
+    {
+        tch.SetRootQueueDisc("ns3::FqCoDelQueueDisc");
+    }
+    QueueDiscContainer qdiscs = tch.Install(dev);
+
+    Time interval = DEVICE_RATE.CalculateBytesTxTime(size) / load;
+    Simulator::Schedule(MicroSeconds(1), &SendPacket, tc, dev, interval, flows, size, packets);
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    uint64_t elapsed = time.End();
+
+    sent = devQueue->GetTotalReceivedPackets();
+    // the drops of the child queue discs are accounted by mq as well
+    dropped = qdiscs.Get(0)->GetStats().nTotalDroppedPackets;
+
+    Simulator::Destroy();
+    return elapsed;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t txQueues = 16;
+    uint32_t flows = 10000;
+    uint32_t size = 1500;
+    uint32_t packets = 1000000;
+    double load = 1.2;
+    bool bql = false;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the mq queue disc on a 100 Gbps multi-queue device");
+    cmd.AddValue("txqueues", "number of device transmission queues", txQueues);
+    cmd.AddValue("flows", "number of flows", flows);
+    cmd.AddValue("size", "size of the packets, in bytes", size);
+    cmd.AddValue("packets", "number of packets to send", packets);
+    cmd.AddValue("load", "offered load, relative to the line rate", load);
+    cmd.AddValue("bql", "enable BQL on the transmission queues", bql);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-mq-queue-disc with txqueues=" << txQueues << " flows=" << flows
+              << " size=" << size << " packets=" << packets << " load=" << load
+              << " bql=" << bql << std::endl;
+
+    for (uint32_t n : {txQueues, 1U})
+    {
+        uint64_t sent;
+        uint64_t dropped;
+        uint64_t elapsed = RunOnce(n, flows, size, packets, load, bql, sent, dropped);
+        std::cout << elapsed << " ms elapsed\t" << sent << " packets sent\t" << dropped
+                  << " packets dropped\t" << n << (n > 1 ? " tx queues (mq)" : " tx queue")
+                  << std::endl;
+    }
+
+    return 0;
+}
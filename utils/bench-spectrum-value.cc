@@ -0,0 +1,186 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the SpectrumValue arithmetic of the
+// interference models, for the spectrum of a 100 RB LTE carrier and of a
+// 996-tone (80 MHz) Wi-Fi RU, with the temporary values created by the
+// operators, with the in-place and fused operations, and with the in-place
+// operations without SIMD. It also benchmarks the summation of the
+// interference of 20 MHz signals converted to a 320 MHz spectrum model, which
+// only processes the bands occupied by the signals.
+// Sample usage:  ./ns3 run 'bench-spectrum-value --iterations=1000000'
+
+#include "ns3/command-line.h"
+#include "ns3/spectrum-converter.h"
+#include "ns3/spectrum-value.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <cmath>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Benchmark the computation of the SINR of a chunk and of the power of a
+ * signal, as done by the interference models, for a spectrum model.
+ *
+ * \param name the name of the spectrum model
+ * \param nBands the number of bands
+ * \param bandWidth the width of the bands (Hz)
+ * \param iterations the number of chunks
+ */
+static void
+BenchSpectrum(const std::string& name, uint32_t nBands, double bandWidth, uint32_t iterations)
+{
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < nBands; i++)
+    {
+        freqs.push_back(2e9 + i * bandWidth);
+    }
+    Ptr<SpectrumModel> model = Create<SpectrumModel>(freqs);
+    SpectrumValue rx(model);
+    SpectrumValue interferer(model);
+    SpectrumValue noise(model);
+    for (uint32_t i = 0; i < nBands; i++)
+    {
+        rx[i] = 1e-15 * (1.5 + std::sin(i * 0.1));
+        interferer[i] = 1e-16 * (1.5 + std::cos(i * 0.3));
+        noise[i] = 4e-21;
+    }
+    SpectrumValue all = rx + interferer;
+    const double gain = 0.5;
+
+    std::cout << name << " (" << nBands << " bands):" << std::endl;
+    double check = 0;
+
+    // temporary values created by the operators
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t it = 0; it < iterations; it++)
+    {
+        SpectrumValue sinr = rx / (all - rx + noise);
+        SpectrumValue received = all + interferer * gain;
+        check += Integral(sinr * received);
+    }
+    uint64_t elapsed = time.End();
+    std::cout << "  " << 1e6 * elapsed / iterations << " ns per chunk\toperators" << std::endl;
+
+    // in-place and fused operations, reusing the storage of the results
+    SpectrumValue interference(model);
+    SpectrumValue sinr(model);
+    SpectrumValue received(model);
+    for (bool simd : {true, false})
+    {
+        SpectrumValue::EnableSimd(simd);
+        time.Start();
+        for (uint32_t it = 0; it < iterations; it++)
+        {
+            interference = all;
+            interference -= rx;
+            interference += noise;
+            sinr = rx;
+            sinr /= interference;
+            received = all;
+            received.MultiplyAdd(interferer, gain);
+            check += IntegralOfProduct(sinr, received);
+        }
+        elapsed = time.End();
+        std::cout << "  " << 1e6 * elapsed / iterations << " ns per chunk\tin-place and fused"
+                  << (SpectrumValue::IsSimdEnabled() ? ", SIMD" : ", scalar") << std::endl;
+    }
+    SpectrumValue::EnableSimd(true);
+
+    // keep the results alive
+    if (std::isnan(check))
+    {
+        std::cout << "  unexpected result" << std::endl;
+    }
+}
+
+/**
+ * Benchmark the conversion of 20 MHz signals to a 320 MHz spectrum model and
+ * the summation of their interference, with the signals occupying their
+ * 20 MHz or, for comparison, all the bands.
+ *
+ * \param iterations the number of signals
+ */
+static void
+BenchNarrowband(uint32_t iterations)
+{
+    const double bandWidth = 78.125e3;
+    std::vector<double> wideFreqs;
+    for (uint32_t i = 0; i < 4096; i++)
+    {
+        wideFreqs.push_back(5.95e9 + i * bandWidth);
+    }
+    Ptr<SpectrumModel> wide = Create<SpectrumModel>(wideFreqs);
+    std::vector<SpectrumConverter> converters;
+    std::vector<Ptr<SpectrumValue>> psds;
+    for (uint32_t channel = 0; channel < 16; channel++)
+    {
+        std::vector<double> freqs;
+        for (uint32_t i = 0; i < 256; i++)
+        {
+            freqs.push_back(wideFreqs[channel * 256] + i * bandWidth);
+        }
+        Ptr<SpectrumModel> narrow = Create<SpectrumModel>(freqs);
+        converters.emplace_back(narrow, wide);
+        psds.push_back(Create<SpectrumValue>(narrow));
+        *psds.back() = 1e-15;
+    }
+
+    std::cout << "20 MHz signals on a 320 MHz model (4096 bands):" << std::endl;
+    for (bool occupied : {true, false})
+    {
+        SpectrumValue all(wide);
+        SystemWallClockMs time;
+        time.Start();
+        for (uint32_t it = 0; it < iterations; it++)
+        {
+            Ptr<SpectrumValue> rxPsd = converters[it % 16].Convert(psds[it % 16]);
+            if (!occupied)
+            {
+                // writing a value marks all the bands as occupied
+                (*rxPsd)[0] = 0;
+            }
+            *rxPsd *= 0.5;
+            all += *rxPsd;
+            all -= *rxPsd;
+        }
+        uint64_t elapsed = time.End();
+        std::cout << "  " << 1e6 * elapsed / iterations << " ns per signal\t"
+                  << (occupied ? "occupied bands" : "all the bands") << std::endl;
+    }
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t iterations = 100000;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the SpectrumValue operations of the interference models");
+    cmd.AddValue("iterations", "number of chunks per spectrum model", iterations);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-spectrum-value with iterations=" << iterations << std::endl;
+
+    BenchSpectrum("LTE 100 RB", 100, 180e3, iterations);
+    BenchSpectrum("Wi-Fi 996-tone RU", 996, 78.125e3, iterations);
+    BenchNarrowband(iterations / 10);
+    return 0;
+}
@@ -0,0 +1,171 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to measure what the TCP segmentation and receive
+// offload emulation saves, running long-lived flows over a single link with
+// TSO and GRO disabled and enabled. TSO super-segments are split again in
+// TcpL4Protocol before IP, so the events of the queue discs, devices and
+// channels are not reduced: only the socket-level work (segment building,
+// ACK processing, timers) is.
+// Sample usage:  ./ns3 run 'bench-tcp-offload --flows=10 --stop=2'
+
+#include "ns3/applications-module.h"
+#include "ns3/core-module.h"
+#include "ns3/internet-module.h"
+#include "ns3/network-module.h"
+#include "ns3/point-to-point-module.h"
+#include "ns3/system-wall-clock-ms.h"
+
+#include <iostream>
+
+using namespace ns3;
+
+/// Number of segments received by the sockets, i.e., after GRO
+static uint64_t g_socketRx = 0;
+
+/**
+ * Count a segment received by a socket
+ * \param packet the packet
+ * \param header the TCP header
+ * \param socket the socket
+ */
+static void
+SocketRx(Ptr<const Packet> packet, const TcpHeader& header, Ptr<const TcpSocketBase> socket)
+{
+    ++g_socketRx;
+}
+
+/**
+ * Connect the Rx trace of the sockets of the receiver
+ */
+static void
+ConnectSocketRx()
+{
+    Config::ConnectWithoutContext("/NodeList/1/$ns3::TcpL4Protocol/SocketList/*/Rx",
+                                  MakeCallback(&SocketRx));
+}
+
+/**
+ * Run the simulation once
+ * \param tso whether TSO is enabled
+ * \param gro whether GRO is enabled
+ * \param flows number of concurrent flows
+ * \param rate the rate of the link
+ * \param stop the simulated time
+ * \param [out] events the number of events executed
+ * \param [out] bytes the number of bytes received
+ * \return the wall-clock time of the simulation, in milliseconds
+ */
+static uint64_t
+RunOnce(bool tso,
+        bool gro,
+        uint32_t flows,
+        const std::string& rate,
+        Time stop,
+        uint64_t& events,
+        uint64_t& bytes)
+{
+    Config::SetDefault("ns3::TcpSocket::SegmentSize", UintegerValue(1448));
+    Config::SetDefault("ns3::TcpSocketBase::TsoMaxSize", UintegerValue(tso ? 65535 : 0));
+    Config::SetDefault("ns3::TcpSocketBase::GroTimeout",
+                       TimeValue(gro ? MicroSeconds(20) : Seconds(0)));
+
+    NodeContainer nodes;
+    nodes.Create(2);
+
+    PointToPointHelper p2p;
+    p2p.SetDeviceAttribute("DataRate", StringValue(rate));
+    p2p.SetChannelAttribute("Delay", StringValue("10ms"));
+    NetDeviceContainer devices = p2p.Install(nodes);
+
+    InternetStackHelper stack;
+    stack.Install(nodes);
+
+    Ipv4AddressHelper address;
+    address.SetBase("10.1.1.0", "255.255.255.0");
+    Ipv4InterfaceContainer interfaces = address.Assign(devices);
+
+    ApplicationContainer sinks;
+    ApplicationContainer sources;
+    for (uint32_t i = 0; i < flows; ++i)
+    {
+        uint16_t port = 10000 + i;
+        PacketSinkHelper sink("ns3::TcpSocketFactory",
+                              InetSocketAddress(Ipv4Address::GetAny(), port));
+        sinks.Add(sink.Install(nodes.Get(1)));
+
+        BulkSendHelper source("ns3::TcpSocketFactory",
+                              InetSocketAddress(interfaces.GetAddress(1), port));
+        source.SetAttribute("MaxBytes", UintegerValue(0));
+        sources.Add(source.Install(nodes.Get(0)));
+    }
+    sinks.Start(Seconds(0));
+    sources.Start(Seconds(0));
+    sources.Stop(stop);
+
+    // The sockets of the receiver are created by the handshakes
+    g_socketRx = 0;
+    Simulator::Schedule(MilliSeconds(100), &ConnectSocketRx);
+    Simulator::Stop(stop);
+
+    SystemWallClockMs time;
+    time.Start();
+    Simulator::Run();
+    uint64_t elapsed = time.End();
+
+    events = Simulator::GetEventCount();
+    bytes = 0;
+    for (uint32_t i = 0; i < sinks.GetN(); ++i)
+    {
+        bytes += DynamicCast<PacketSink>(sinks.Get(i))->GetTotalRx();
+    }
+
+    Simulator::Destroy();
+    return elapsed;
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t flows = 10;
+    std::string rate = "10Gbps";
+    double stop = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Measure the events saved by the TCP segmentation and receive offload emulation");
+    cmd.AddValue("flows", "number of concurrent flows", flows);
+    cmd.AddValue("rate", "rate of the link", rate);
+    cmd.AddValue("stop", "simulated time, in seconds", stop);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-tcp-offload with flows=" << flows << " rate=" << rate
+              << " stop=" << stop << "s" << std::endl;
+
+    for (bool tso : {false, true})
+    {
+        for (bool gro : {false, true})
+        {
+            uint64_t events;
+            uint64_t bytes;
+            uint64_t elapsed = RunOnce(tso, gro, flows, rate, Seconds(stop), events, bytes);
+            std::cout << elapsed << " ms elapsed\t" << events << " events\t" << g_socketRx
+                      << " segments processed by the receivers\t" << bytes
+                      << " bytes received\tTSO " << (tso ? "on" : "off") << ", GRO "
+                      << (gro ? "on" : "off") << std::endl;
+        }
+    }
+
+    return 0;
+}
@@ -0,0 +1,213 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the TcpTxBuffer scoreboard, driving
+// it with synthetic SACK patterns over a window of 'n' segments in flight.
+// Sample usage:  ./ns3 run 'bench-tcp-tx-buffer --n=50000 --loss=0.01'
+
+#include "ns3/command-line.h"
+#include "ns3/packet.h"
+#include "ns3/random-variable-stream.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/tcp-tx-buffer.h"
+
+#include <algorithm>
+#include <iostream>
+#include <limits>
+#include <stdlib.h> // for exit ()
+#include <vector>
+
+using namespace ns3;
+
+/// Segment size used by the benchmark
+static const uint32_t SEGMENT_SIZE = 1448;
+
+/// Maximum number of SACK blocks carried by an ACK (RFC 2018)
+static const uint32_t MAX_SACK_BLOCKS = 3;
+
+/**
+ * Receiver window callback: the benchmark never limits the sender
+ * \return the receiver window
+ */
+static uint32_t
+GetRWnd()
+{
+    return std::numeric_limits<uint32_t>::max();
+}
+
+/**
+ * Create a buffer and transmit for the first time n segments
+ * \param n number of segments
+ * \return the buffer with n segments in flight
+ */
+static Ptr<TcpTxBuffer>
+FillBuffer(uint32_t n)
+{
+    Ptr<TcpTxBuffer> txBuf = CreateObject<TcpTxBuffer>(1);
+    txBuf->SetMaxBufferSize(std::numeric_limits<uint32_t>::max());
+    txBuf->SetSegmentSize(SEGMENT_SIZE);
+    txBuf->SetDupAckThresh(3);
+    txBuf->SetRWndCallback(MakeCallback(&GetRWnd));
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        txBuf->Add(Create<Packet>(SEGMENT_SIZE));
+        txBuf->CopyFromSequence(SEGMENT_SIZE, txBuf->HeadSequence() + i * SEGMENT_SIZE);
+    }
+    return txBuf;
+}
+
+/**
+ * Deliver the whole window, dropping segments with the given probability.
+ *
+ * Every segment received above the first hole generates an ACK with up to
+ * MAX_SACK_BLOCKS blocks, the most recent first, as a real receiver would do.
+ * After each ACK the sender, like TcpSocketBase does, asks for the next
+ * segment to transmit and checks whether the highest sent segment is lost.
+ *
+ * \param txBuf the buffer
+ * \param n number of segments in flight
+ * \param loss the loss probability
+ * \param rng the random stream deciding the losses
+ */
+static void
+DeliverWindow(Ptr<TcpTxBuffer> txBuf, uint32_t n, double loss, Ptr<UniformRandomVariable> rng)
+{
+    SequenceNumber32 head = txBuf->HeadSequence();
+    std::vector<TcpOptionSack::SackBlock> blocks; // received blocks above the first hole
+    bool hole = false;
+
+    for (uint32_t i = 0; i < n; ++i)
+    {
+        SequenceNumber32 start = head + i * SEGMENT_SIZE;
+        if (rng->GetValue() < loss)
+        {
+            hole = true;
+            continue;
+        }
+
+        if (!hole)
+        {
+            txBuf->DiscardUpTo(start + SEGMENT_SIZE);
+            continue;
+        }
+
+        if (!blocks.empty() && blocks.back().second == start)
+        {
+            blocks.back().second = start + SEGMENT_SIZE;
+        }
+        else
+        {
+            blocks.emplace_back(start, start + SEGMENT_SIZE);
+        }
+
+        TcpOptionSack::SackList list;
+        for (auto it = blocks.rbegin(); it != blocks.rend() && list.size() < MAX_SACK_BLOCKS;
+             ++it)
+        {
+            list.push_back(*it);
+        }
+        txBuf->Update(list);
+
+        SequenceNumber32 next;
+        SequenceNumber32 nextHigh;
+        txBuf->NextSeg(&next, &nextHigh, true);
+        txBuf->IsLost(start - SEGMENT_SIZE);
+    }
+}
+
+/**
+ * Retransmit every segment considered lost, then acknowledge everything
+ * \param txBuf the buffer
+ */
+static void
+RecoverWindow(Ptr<TcpTxBuffer> txBuf)
+{
+    SequenceNumber32 tail = txBuf->HeadSequence() + txBuf->Size();
+    SequenceNumber32 next;
+    SequenceNumber32 nextHigh;
+
+    while (txBuf->NextSeg(&next, &nextHigh, false) && next < tail)
+    {
+        txBuf->CopyFromSequence(SEGMENT_SIZE, next);
+        txBuf->BytesInFlight();
+    }
+    txBuf->DiscardUpTo(tail);
+}
+
+/**
+ * Run the benchmark once
+ * \param n number of segments in flight
+ * \param loss the loss probability
+ * \param [out] deliverMs time spent processing the SACKs
+ * \param [out] recoverMs time spent retransmitting the lost segments
+ */
+static void
+RunBenchOneIteration(uint32_t n, double loss, uint64_t& deliverMs, uint64_t& recoverMs)
+{
+    Ptr<UniformRandomVariable> rng = CreateObject<UniformRandomVariable>();
+    rng->SetStream(1);
+    Ptr<TcpTxBuffer> txBuf = FillBuffer(n);
+
+    SystemWallClockMs time;
+    time.Start();
+    DeliverWindow(txBuf, n, loss, rng);
+    deliverMs = time.End();
+
+    time.Start();
+    RecoverWindow(txBuf);
+    recoverMs = time.End();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t n = 0;
+    double loss = 0.01;
+    uint32_t minIterations = 1;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the TcpTxBuffer scoreboard with synthetic SACK patterns");
+    cmd.AddValue("n", "number of segments in flight", n);
+    cmd.AddValue("loss", "probability to drop each segment", loss);
+    cmd.AddValue("min-iterations",
+                 "number of subiterations to minimize iteration time over",
+                 minIterations);
+    cmd.Parse(argc, argv);
+
+    if (n == 0)
+    {
+        std::cerr << "Error-- number of segments must be specified "
+                  << "by command-line argument --n=(number of segments)" << std::endl;
+        exit(1);
+    }
+    std::cout << "Running bench-tcp-tx-buffer with n=" << n << " loss=" << loss << std::endl;
+
+    uint64_t minDeliver = std::numeric_limits<uint64_t>::max();
+    uint64_t minRecover = std::numeric_limits<uint64_t>::max();
+    for (uint32_t i = 0; i < minIterations; i++)
+    {
+        uint64_t deliverMs;
+        uint64_t recoverMs;
+        RunBenchOneIteration(n, loss, deliverMs, recoverMs);
+        minDeliver = std::min(minDeliver, deliverMs);
+        minRecover = std::min(minRecover, recoverMs);
+    }
+
+    std::cout << minDeliver << " ms elapsed\tSACK processing" << std::endl;
+    std::cout << minRecover << " ms elapsed\tLoss recovery" << std::endl;
+
+    return 0;
+}
@@ -0,0 +1,253 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License version 2 as
+ * published by the Free Software Foundation;
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License
+ * along with this program; if not, write to the Free Software
+ * Foundation, Inc., 59 Temple Place, Suite 330, Boston, MA  02111-1307  USA
+ */
+
+// This program can be used to benchmark the 3GPP channel model and the
+// computation of the beamforming gain, for two nodes equipped with uniform
+// planar arrays and a PSD of 64 resource blocks at 28 GHz. It measures the
+// generation of the channel matrices, the computation of the received PSD
+// with fixed beams (the long term component is cached) and with beams
+// changing at each signal (the long term component is computed again).
+// Finally, it measures the generation of the channel matrices of several
+// links precomputed when their update period expires, with a pool of threads.
+// Sample usage:  ./ns3 run 'bench-three-gpp-channel --rows=8 --columns=8 --threads=4'
+
+#include "ns3/boolean.h"
+#include "ns3/channel-condition-model.h"
+#include "ns3/command-line.h"
+#include "ns3/constant-position-mobility-model.h"
+#include "ns3/double.h"
+#include "ns3/node-container.h"
+#include "ns3/pointer.h"
+#include "ns3/simulator.h"
+#include "ns3/spectrum-signal-parameters.h"
+#include "ns3/string.h"
+#include "ns3/system-wall-clock-ms.h"
+#include "ns3/three-gpp-channel-model.h"
+#include "ns3/three-gpp-spectrum-propagation-loss-model.h"
+#include "ns3/uinteger.h"
+#include "ns3/uniform-planar-array.h"
+
+#include <cmath>
+#include <iostream>
+#include <vector>
+
+using namespace ns3;
+
+/**
+ * Compute the DFT beamforming vector of an antenna array towards a position.
+ *
+ * \param mobility the mobility model of the node of the array
+ * \param antenna the antenna array
+ * \param target the position of the other node
+ * \return the beamforming vector
+ */
+static PhasedArrayModel::ComplexVector
+GetBeam(Ptr<MobilityModel> mobility, Ptr<PhasedArrayModel> antenna, Vector target)
+{
+    Angles angles(target, mobility->GetPosition());
+    return antenna->GetBeamformingVector(angles);
+}
+
+/**
+ * Benchmark the generation of the channel matrices of the links between a
+ * node and several other nodes, precomputed when their update period expires.
+ *
+ * \param rows the number of rows of the antenna arrays
+ * \param columns the number of columns of the antenna arrays
+ * \param links the number of links
+ * \param periods the number of update periods
+ * \param threads the number of threads computing the channel coefficients
+ */
+static void
+BenchPrecompute(uint32_t rows, uint32_t columns, uint32_t links, uint32_t periods, uint32_t threads)
+{
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<NeverLosChannelConditionModel>()));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(1)));
+    channelModel->SetAttribute("PrecomputeChannels", BooleanValue(true));
+    channelModel->SetAttribute("PrecomputeThreads", UintegerValue(threads));
+    channelModel->AssignStreams(1);
+
+    NodeContainer nodes;
+    nodes.Create(links + 1);
+    std::vector<Ptr<MobilityModel>> mobility;
+    std::vector<Ptr<PhasedArrayModel>> antennas;
+    for (uint32_t i = 0; i <= links; i++)
+    {
+        Ptr<MobilityModel> mob = CreateObject<ConstantPositionMobilityModel>();
+        mob->SetPosition(i == 0 ? Vector(0, 0, 10) : Vector(60, 20.0 * i, 1.5));
+        nodes.Get(i)->AggregateObject(mob);
+        mobility.push_back(mob);
+        antennas.push_back(CreateObjectWithAttributes<UniformPlanarArray>("NumRows",
+                                                                          UintegerValue(rows),
+                                                                          "NumColumns",
+                                                                          UintegerValue(columns)));
+    }
+
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 1; i <= links; i++)
+    {
+        channelModel->GetChannel(mobility[0], mobility[i], antennas[0], antennas[i]);
+    }
+    // the channels are generated again at the end of each update period
+    Simulator::Stop(MilliSeconds(periods - 1) + MicroSeconds(500));
+    Simulator::Run();
+    uint64_t elapsed = time.End();
+    std::cout << "  " << 1.0 * elapsed / (links * periods) << " ms per channel matrix\t"
+              << links << " precomputed links, " << threads << " threads" << std::endl;
+    Simulator::Destroy();
+}
+
+int
+main(int argc, char* argv[])
+{
+    uint32_t rows = 8;
+    uint32_t columns = 8;
+    uint32_t nRbs = 64;
+    uint32_t channels = 20;
+    uint32_t iterations = 2000;
+    uint32_t links = 8;
+    uint32_t threads = 0;
+
+    CommandLine cmd(__FILE__);
+    cmd.Usage("Benchmark the 3GPP channel model and the beamforming gain computation");
+    cmd.AddValue("rows", "number of rows of the antenna arrays", rows);
+    cmd.AddValue("columns", "number of columns of the antenna arrays", columns);
+    cmd.AddValue("rbs", "number of resource blocks of the PSD", nRbs);
+    cmd.AddValue("channels", "number of channel matrices to generate", channels);
+    cmd.AddValue("iterations", "number of received PSDs to compute", iterations);
+    cmd.AddValue("links", "number of links whose channels are precomputed", links);
+    cmd.AddValue("threads",
+                 "number of threads precomputing the channels (0 means hardware concurrency)",
+                 threads);
+    cmd.Parse(argc, argv);
+
+    std::cout << "Running bench-three-gpp-channel with " << rows << "x" << columns
+              << " arrays and " << nRbs << " RBs" << std::endl;
+
+    Ptr<ThreeGppChannelModel> channelModel = CreateObject<ThreeGppChannelModel>();
+    channelModel->SetAttribute("Frequency", DoubleValue(28e9));
+    channelModel->SetAttribute("Scenario", StringValue("UMi-StreetCanyon"));
+    channelModel->SetAttribute("ChannelConditionModel",
+                               PointerValue(CreateObject<NeverLosChannelConditionModel>()));
+    channelModel->SetAttribute("UpdatePeriod", TimeValue(MilliSeconds(1)));
+    channelModel->AssignStreams(1);
+    Ptr<ThreeGppSpectrumPropagationLossModel> lossModel =
+        CreateObject<ThreeGppSpectrumPropagationLossModel>();
+    lossModel->SetChannelModel(channelModel);
+
+    NodeContainer nodes;
+    nodes.Create(2);
+    Ptr<MobilityModel> txMobility = CreateObject<ConstantPositionMobilityModel>();
+    txMobility->SetPosition(Vector(0, 0, 10));
+    nodes.Get(0)->AggregateObject(txMobility);
+    Ptr<MobilityModel> rxMobility = CreateObject<ConstantPositionMobilityModel>();
+    rxMobility->SetPosition(Vector(60, 20, 1.5));
+    nodes.Get(1)->AggregateObject(rxMobility);
+
+    Ptr<PhasedArrayModel> txAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(rows),
+        "NumColumns",
+        UintegerValue(columns));
+    Ptr<PhasedArrayModel> rxAntenna = CreateObjectWithAttributes<UniformPlanarArray>(
+        "NumRows",
+        UintegerValue(rows),
+        "NumColumns",
+        UintegerValue(columns));
+    txAntenna->SetBeamformingVector(GetBeam(txMobility, txAntenna, rxMobility->GetPosition()));
+    rxAntenna->SetBeamformingVector(GetBeam(rxMobility, rxAntenna, txMobility->GetPosition()));
+
+    // 64 RBs of 12 subcarriers spaced by 120 kHz
+    std::vector<double> freqs;
+    for (uint32_t i = 0; i < nRbs; i++)
+    {
+        freqs.push_back(28e9 + (i - nRbs / 2.0) * 1.44e6);
+    }
+    Ptr<SpectrumSignalParameters> params = Create<SpectrumSignalParameters>();
+    params->psd = Create<SpectrumValue>(Create<SpectrumModel>(freqs));
+    *params->psd = 1e-12;
+
+    // generation of the channel matrices, one per update period
+    SystemWallClockMs time;
+    time.Start();
+    for (uint32_t i = 0; i < channels; i++)
+    {
+        Simulator::Schedule(MilliSeconds(2 * i),
+                            &ThreeGppChannelModel::GetChannel,
+                            channelModel,
+                            txMobility,
+                            rxMobility,
+                            txAntenna,
+                            rxAntenna);
+    }
+    Simulator::Run();
+    uint64_t elapsed = time.End();
+    std::cout << "  " << 1.0 * elapsed / channels << " ms per channel matrix" << std::endl;
+
+    // received PSDs with fixed beams
+    double check = 0;
+    time.Start();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        Ptr<SpectrumValue> rxPsd = lossModel->CalcRxPowerSpectralDensity(params,
+                                                                         txMobility,
+                                                                         rxMobility,
+                                                                         txAntenna,
+                                                                         rxAntenna);
+        check += Sum(*rxPsd);
+    }
+    elapsed = time.End();
+    std::cout << "  " << 1e3 * elapsed / iterations << " us per PSD\tfixed beams" << std::endl;
+
+    // received PSDs with beams changing at each signal
+    PhasedArrayModel::ComplexVector beams[2] = {
+        txAntenna->GetBeamformingVector(),
+        GetBeam(txMobility, txAntenna, Vector(60, -20, 1.5))};
+    time.Start();
+    for (uint32_t i = 0; i < iterations; i++)
+    {
+        txAntenna->SetBeamformingVector(beams[i % 2]);
+        Ptr<SpectrumValue> rxPsd = lossModel->CalcRxPowerSpectralDensity(params,
+                                                                         txMobility,
+                                                                         rxMobility,
+                                                                         txAntenna,
+                                                                         rxAntenna);
+        check += Sum(*rxPsd);
+    }
+    elapsed = time.End();
+    std::cout << "  " << 1e3 * elapsed / iterations << " us per PSD\tchanging beams" << std::endl;
+
+    // keep the results alive
+    if (std::isnan(check))
+    {
+        std::cout << "  unexpected result" << std::endl;
+    }
+
+    Simulator::Destroy();
+
+    // generation of the channel matrices of several links, precomputed when
+    // their update period expires
+    BenchPrecompute(rows, columns, links, channels, 1);
+    if (threads != 1)
+    {
+        BenchPrecompute(rows, columns, links, channels, threads);
+    }
+    return 0;
+}